@@ -132,6 +132,9 @@ struct eth_context {
 	float clk_ratio;
 #endif
 	struct k_sem tx_buf_sem;
+#if defined(CONFIG_NET_L2_ETHERNET_POLL)
+	struct net_eth_poll rx_poll;
+#endif
 	enum eth_mcux_phy_state phy_state;
 	bool enabled;
 	bool link_up;
@@ -830,6 +833,43 @@ error:
 	eth_stats_update_errors_rx(get_iface(context, vlan_tag));
 }
 
+#if defined(CONFIG_NET_L2_ETHERNET_POLL)
+static int eth_rx_poll(struct net_eth_poll *poll, int budget)
+{
+	struct eth_context *context = CONTAINER_OF(poll, struct eth_context,
+						   rx_poll);
+	uint32_t frame_length;
+	int count = 0;
+
+	while (count < budget) {
+		if (ENET_GetRxFrameSize(&context->enet_handle, &frame_length,
+					RING_ID) == kStatus_ENET_RxFrameEmpty) {
+			break;
+		}
+
+		eth_rx(context);
+		count++;
+	}
+
+	return count;
+}
+
+static void eth_rx_irq(struct net_eth_poll *poll, bool enable)
+{
+	struct eth_context *context = CONTAINER_OF(poll, struct eth_context,
+						   rx_poll);
+
+	/* The RX frame event stays pending while it is masked, so a frame
+	 * received during the poll raises the interrupt once it is enabled.
+	 */
+	if (enable) {
+		ENET_EnableInterrupts(context->base, kENET_RxFrameInterrupt);
+	} else {
+		ENET_DisableInterrupts(context->base, kENET_RxFrameInterrupt);
+	}
+}
+#endif /* CONFIG_NET_L2_ETHERNET_POLL */
+
 #if defined(CONFIG_PTP_CLOCK_MCUX) && defined(CONFIG_NET_GPTP)
 static inline void ts_register_tx_event(struct eth_context *context,
 					 enet_frame_info_t *frameinfo)
@@ -874,7 +914,11 @@ static void eth_callback(ENET_Type *base, enet_handle_t *handle,
 
 	switch (event) {
 	case kENET_RxEvent:
+#if defined(CONFIG_NET_L2_ETHERNET_POLL)
+		net_eth_poll_schedule(&context->rx_poll);
+#else
 		eth_rx(context);
+#endif
 		break;
 	case kENET_TxEvent:
 #if defined(CONFIG_PTP_CLOCK_MCUX) && defined(CONFIG_NET_GPTP)
@@ -1004,6 +1048,9 @@ static int eth_init(const struct device *dev)
 	k_work_init(&context->phy_work, eth_mcux_phy_work);
 	k_work_init_delayable(&context->delayed_phy_work,
 			      eth_mcux_delayed_phy_work);
+#if defined(CONFIG_NET_L2_ETHERNET_POLL)
+	net_eth_poll_init(&context->rx_poll, eth_rx_poll, eth_rx_irq, 0);
+#endif
 
 	if (context->generate_mac) {
 		context->generate_mac(context->mac_addr);
@@ -56,6 +56,11 @@ struct eth_context {
 	struct z_thread_stack_element *rx_stack;
 	size_t rx_stack_size;
 	int dev_fd;
+#if defined(CONFIG_NET_L2_ETHERNET_POLL)
+	struct net_eth_poll rx_poll;
+	/* Given when the RX thread may wait for data again */
+	struct k_sem rx_irq_sem;
+#endif
 	bool init_done;
 	bool status;
 	bool promisc_mode;
@@ -370,17 +375,57 @@ static int read_data(struct eth_context *ctx, int fd)
 	return 0;
 }
 
+#if defined(CONFIG_NET_L2_ETHERNET_POLL)
+static int eth_rx_poll(struct net_eth_poll *poll, int budget)
+{
+	struct eth_context *ctx = CONTAINER_OF(poll, struct eth_context,
+					       rx_poll);
+	int count = 0;
+
+	while (count < budget && !eth_wait_data(ctx->dev_fd)) {
+		read_data(ctx, ctx->dev_fd);
+		count++;
+	}
+
+	return count;
+}
+
+/* The RX thread acts as the RX interrupt of the TAP device. While it is
+ * disabled, the thread does not look at the device.
+ */
+static void eth_rx_irq(struct net_eth_poll *poll, bool enable)
+{
+	struct eth_context *ctx = CONTAINER_OF(poll, struct eth_context,
+					       rx_poll);
+
+	if (enable) {
+		k_sem_give(&ctx->rx_irq_sem);
+	}
+}
+#endif /* CONFIG_NET_L2_ETHERNET_POLL */
+
 static void eth_rx(struct eth_context *ctx)
 {
 	LOG_DBG("Starting ZETH RX thread");
 
 	while (1) {
+#if defined(CONFIG_NET_L2_ETHERNET_POLL)
+		if (net_if_is_up(ctx->iface) && !eth_wait_data(ctx->dev_fd)) {
+			/* The semaphore is given when the device has no more
+			 * data pending, or right away if the poll could not
+			 * be scheduled.
+			 */
+			net_eth_poll_schedule(&ctx->rx_poll);
+			k_sem_take(&ctx->rx_irq_sem, K_FOREVER);
+		}
+#else
 		if (net_if_is_up(ctx->iface)) {
 			while (!eth_wait_data(ctx->dev_fd)) {
 				read_data(ctx, ctx->dev_fd);
 				k_yield();
 			}
 		}
+#endif
 
 		if (IS_ENABLED(CONFIG_NET_GPTP)) {
 			k_sleep(K_MSEC(1));
@@ -398,6 +443,11 @@ static void eth_rx(struct eth_context *ctx)
 
 static void create_rx_handler(struct eth_context *ctx)
 {
+#if defined(CONFIG_NET_L2_ETHERNET_POLL)
+	k_sem_init(&ctx->rx_irq_sem, 0, 1);
+	net_eth_poll_init(&ctx->rx_poll, eth_rx_poll, eth_rx_irq, 0);
+#endif
+
 	k_thread_create(ctx->rx_thread,
 			ctx->rx_stack,
 			ctx->rx_stack_size,
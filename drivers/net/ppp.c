@@ -28,7 +28,7 @@ LOG_MODULE_REGISTER(net_ppp, LOG_LEVEL);
 #include <net/net_if.h>
 #include <net/net_core.h>
 #include <sys/ring_buffer.h>
-#include <sys/crc.h>
+#include <sys/byteorder.h>
 #include <drivers/uart.h>
 #include <drivers/console/uart_mux.h>
 #include <random/rand32.h>
@@ -38,6 +38,22 @@ LOG_MODULE_REGISTER(net_ppp, LOG_LEVEL);
 
 #define UART_BUF_LEN CONFIG_NET_PPP_UART_BUF_LEN
 
+#define HDLC_FLAG 0x7e
+#define HDLC_ESC 0x7d
+#define HDLC_ESC_XOR 0x20
+#define HDLC_ADDRESS 0xff
+#define HDLC_CONTROL 0x03
+
+#define PPP_FCS_INIT 0xffff
+#define PPP_FCS_GOOD 0xf0b8
+
+#if defined(CONFIG_NET_PPP_ASYNC_UART)
+/* One buffer is filled while the UART sends the other one */
+#define SEND_BUF_COUNT 2
+#else
+#define SEND_BUF_COUNT 1
+#endif
+
 enum ppp_driver_state {
 	STATE_HDLC_FRAME_START,
 	STATE_HDLC_FRAME_ADDRESS,
@@ -56,14 +72,25 @@ struct ppp_driver_context {
 	/* This net_pkt contains pkt that is being read */
 	struct net_pkt *pkt;
 
-	/* How much free space we have in the net_pkt */
-	size_t available;
+	/* FCS of the data received so far in pkt */
+	uint16_t rx_fcs;
 
 	/* ppp data is read into this buf */
 	uint8_t buf[UART_BUF_LEN];
 
 	/* ppp buf use when sending data */
-	uint8_t send_buf[UART_BUF_LEN];
+	uint8_t *send_buf;
+	uint8_t send_bufs[SEND_BUF_COUNT][UART_BUF_LEN];
+
+#if defined(CONFIG_NET_PPP_ASYNC_UART)
+	/* Given when the UART is done with a send buffer */
+	struct k_sem tx_sem;
+
+	/* The UART receives into one buffer while the other one is
+	 * waiting to be used.
+	 */
+	uint8_t rx_bufs[2][CONFIG_NET_PPP_ASYNC_UART_RX_BUF_LEN];
+#endif
 
 	uint8_t mac_addr[6];
 	struct net_linkaddr ll_addr;
@@ -91,13 +118,64 @@ struct ppp_driver_context {
 
 	uint8_t init_done : 1;
 	uint8_t next_escaped : 1;
+#if defined(CONFIG_NET_PPP_ASYNC_UART)
+	uint8_t rx_buf_idx : 1;
+#endif
 };
 
 static struct ppp_driver_context ppp_driver_context_data;
 
-static int ppp_save_byte(struct ppp_driver_context *ppp, uint8_t byte)
+/* FCS lookup table, RFC 1662 appendix C.2 */
+static const uint16_t ppp_fcs_table[256] = {
+	0x0000, 0x1189, 0x2312, 0x329b, 0x4624, 0x57ad, 0x6536, 0x74bf,
+	0x8c48, 0x9dc1, 0xaf5a, 0xbed3, 0xca6c, 0xdbe5, 0xe97e, 0xf8f7,
+	0x1081, 0x0108, 0x3393, 0x221a, 0x56a5, 0x472c, 0x75b7, 0x643e,
+	0x9cc9, 0x8d40, 0xbfdb, 0xae52, 0xdaed, 0xcb64, 0xf9ff, 0xe876,
+	0x2102, 0x308b, 0x0210, 0x1399, 0x6726, 0x76af, 0x4434, 0x55bd,
+	0xad4a, 0xbcc3, 0x8e58, 0x9fd1, 0xeb6e, 0xfae7, 0xc87c, 0xd9f5,
+	0x3183, 0x200a, 0x1291, 0x0318, 0x77a7, 0x662e, 0x54b5, 0x453c,
+	0xbdcb, 0xac42, 0x9ed9, 0x8f50, 0xfbef, 0xea66, 0xd8fd, 0xc974,
+	0x4204, 0x538d, 0x6116, 0x709f, 0x0420, 0x15a9, 0x2732, 0x36bb,
+	0xce4c, 0xdfc5, 0xed5e, 0xfcd7, 0x8868, 0x99e1, 0xab7a, 0xbaf3,
+	0x5285, 0x430c, 0x7197, 0x601e, 0x14a1, 0x0528, 0x37b3, 0x263a,
+	0xdecd, 0xcf44, 0xfddf, 0xec56, 0x98e9, 0x8960, 0xbbfb, 0xaa72,
+	0x6306, 0x728f, 0x4014, 0x519d, 0x2522, 0x34ab, 0x0630, 0x17b9,
+	0xef4e, 0xfec7, 0xcc5c, 0xddd5, 0xa96a, 0xb8e3, 0x8a78, 0x9bf1,
+	0x7387, 0x620e, 0x5095, 0x411c, 0x35a3, 0x242a, 0x16b1, 0x0738,
+	0xffcf, 0xee46, 0xdcdd, 0xcd54, 0xb9eb, 0xa862, 0x9af9, 0x8b70,
+	0x8408, 0x9581, 0xa71a, 0xb693, 0xc22c, 0xd3a5, 0xe13e, 0xf0b7,
+	0x0840, 0x19c9, 0x2b52, 0x3adb, 0x4e64, 0x5fed, 0x6d76, 0x7cff,
+	0x9489, 0x8500, 0xb79b, 0xa612, 0xd2ad, 0xc324, 0xf1bf, 0xe036,
+	0x18c1, 0x0948, 0x3bd3, 0x2a5a, 0x5ee5, 0x4f6c, 0x7df7, 0x6c7e,
+	0xa50a, 0xb483, 0x8618, 0x9791, 0xe32e, 0xf2a7, 0xc03c, 0xd1b5,
+	0x2942, 0x38cb, 0x0a50, 0x1bd9, 0x6f66, 0x7eef, 0x4c74, 0x5dfd,
+	0xb58b, 0xa402, 0x9699, 0x8710, 0xf3af, 0xe226, 0xd0bd, 0xc134,
+	0x39c3, 0x284a, 0x1ad1, 0x0b58, 0x7fe7, 0x6e6e, 0x5cf5, 0x4d7c,
+	0xc60c, 0xd785, 0xe51e, 0xf497, 0x8028, 0x91a1, 0xa33a, 0xb2b3,
+	0x4a44, 0x5bcd, 0x6956, 0x78df, 0x0c60, 0x1de9, 0x2f72, 0x3efb,
+	0xd68d, 0xc704, 0xf59f, 0xe416, 0x90a9, 0x8120, 0xb3bb, 0xa232,
+	0x5ac5, 0x4b4c, 0x79d7, 0x685e, 0x1ce1, 0x0d68, 0x3ff3, 0x2e7a,
+	0xe70e, 0xf687, 0xc41c, 0xd595, 0xa12a, 0xb0a3, 0x8238, 0x93b1,
+	0x6b46, 0x7acf, 0x4854, 0x59dd, 0x2d62, 0x3ceb, 0x0e70, 0x1ff9,
+	0xf78f, 0xe606, 0xd49d, 0xc514, 0xb1ab, 0xa022, 0x92b9, 0x8330,
+	0x7bc7, 0x6a4e, 0x58d5, 0x495c, 0x3de3, 0x2c6a, 0x1ef1, 0x0f78,
+};
+
+static uint16_t ppp_fcs_update(uint16_t fcs, const uint8_t *data, size_t len)
 {
-	int ret;
+	while (len--) {
+		fcs = (fcs >> 8) ^ ppp_fcs_table[(fcs ^ *data++) & 0xff];
+	}
+
+	return fcs;
+}
+
+/* Append received data to the network buffers of the packet being read */
+static int ppp_save_bytes(struct ppp_driver_context *ppp,
+			  const uint8_t *data, size_t len)
+{
+	struct net_buf *buf;
+	size_t count;
 
 	if (!ppp->pkt) {
 		ppp->pkt = net_pkt_rx_alloc_with_buffer(
@@ -108,43 +186,31 @@ static int ppp_save_byte(struct ppp_driver_context *ppp, uint8_t byte)
 			LOG_ERR("[%p] cannot allocate pkt", ppp);
 			return -ENOMEM;
 		}
-
-		net_pkt_cursor_init(ppp->pkt);
-
-		ppp->available = net_pkt_available_buffer(ppp->pkt);
 	}
 
-	/* Extra debugging can be enabled separately if really
-	 * needed. Normally it would just print too much data.
-	 */
-	if (0) {
-		LOG_DBG("Saving byte %02x", byte);
+	if (IS_ENABLED(CONFIG_NET_PPP_VERIFY_FCS)) {
+		ppp->rx_fcs = ppp_fcs_update(ppp->rx_fcs, data, len);
 	}
 
-	/* This is not very intuitive but we must allocate new buffer
-	 * before we write a byte to last available cursor position.
-	 */
-	if (ppp->available == 1) {
-		ret = net_pkt_alloc_buffer(ppp->pkt,
-					   CONFIG_NET_BUF_DATA_SIZE,
-					   AF_UNSPEC, K_NO_WAIT);
-		if (ret < 0) {
-			LOG_ERR("[%p] cannot allocate new data buffer", ppp);
-			goto out_of_mem;
-		}
+	buf = net_buf_frag_last(ppp->pkt->buffer);
 
-		ppp->available = net_pkt_available_buffer(ppp->pkt);
-	}
+	while (len > 0) {
+		if (net_buf_tailroom(buf) == 0) {
+			buf = net_pkt_get_frag(ppp->pkt, K_NO_WAIT);
+			if (!buf) {
+				LOG_ERR("[%p] cannot allocate new data buffer",
+					ppp);
+				goto out_of_mem;
+			}
 
-	if (ppp->available) {
-		ret = net_pkt_write_u8(ppp->pkt, byte);
-		if (ret < 0) {
-			LOG_ERR("[%p] Cannot write to pkt %p (%d)",
-				ppp, ppp->pkt, ret);
-			goto out_of_mem;
+			net_pkt_frag_add(ppp->pkt, buf);
 		}
 
-		ppp->available--;
+		count = MIN(len, net_buf_tailroom(buf));
+		net_buf_add_mem(buf, data, count);
+
+		data += count;
+		len -= count;
 	}
 
 	return 0;
@@ -199,6 +265,19 @@ static int ppp_send_flush(struct ppp_driver_context *ppp, int off)
 	}
 	uint8_t *buf = ppp->send_buf;
 
+#if defined(CONFIG_NET_PPP_ASYNC_UART)
+	/* The UART sends this buffer while the next one is being filled,
+	 * so only wait until it is done with the previous one.
+	 */
+	(void)k_sem_take(&ppp->tx_sem, K_FOREVER);
+
+	if (uart_tx(ppp->dev, buf, off, SYS_FOREVER_MS) < 0) {
+		LOG_ERR("[%p] cannot send %d bytes", ppp, off);
+		k_sem_give(&ppp->tx_sem);
+	}
+
+	ppp->send_buf = ppp->send_bufs[buf == ppp->send_bufs[0] ? 1 : 0];
+#else
 	/* If we're using gsm_mux, We don't want to use poll_out because sending
 	 * one byte at a time causes each byte to get wrapped in muxing headers.
 	 * But we can safely call uart_fifo_fill outside of ISR context when
@@ -211,6 +290,7 @@ static int ppp_send_flush(struct ppp_driver_context *ppp, int off)
 			uart_poll_out(ppp->dev, *buf++);
 		}
 	}
+#endif
 
 	return 0;
 }
@@ -223,9 +303,61 @@ static int ppp_send_bytes(struct ppp_driver_context *ppp,
 	for (i = 0; i < len; i++) {
 		ppp->send_buf[off++] = data[i];
 
-		if (off >= sizeof(ppp->send_buf)) {
+		if (off >= UART_BUF_LEN) {
+			off = ppp_send_flush(ppp, off);
+		}
+	}
+
+	return off;
+}
+
+static inline bool ppp_needs_escape(uint8_t byte)
+{
+	/* The Async-Control-Character-Map is not negotiated so all the
+	 * control characters are escaped, RFC 1662 ch. 7.1
+	 */
+	return byte < 0x20 || byte == HDLC_FLAG || byte == HDLC_ESC;
+}
+
+/* Escape a block of data into the send buffer. The FCS, if given, is
+ * updated over the unescaped data.
+ */
+static int ppp_send_escaped(struct ppp_driver_context *ppp,
+			    const uint8_t *data, size_t len, int off,
+			    uint16_t *fcs)
+{
+	size_t count, i;
+
+	if (fcs) {
+		*fcs = ppp_fcs_update(*fcs, data, len);
+	}
+
+	while (len > 0) {
+		/* Keep room for an escaped byte */
+		if (off > UART_BUF_LEN - 2) {
 			off = ppp_send_flush(ppp, off);
 		}
+
+		/* The bytes that need no escaping are copied in one go */
+		count = MIN(len, UART_BUF_LEN - off);
+		i = 0;
+
+		while (i < count && !ppp_needs_escape(data[i])) {
+			i++;
+		}
+
+		if (i > 0) {
+			memcpy(&ppp->send_buf[off], data, i);
+			off += i;
+		} else {
+			/* RFC 1662, ch. 4.2 */
+			ppp->send_buf[off++] = HDLC_ESC;
+			ppp->send_buf[off++] = data[0] ^ HDLC_ESC_XOR;
+			i = 1;
+		}
+
+		data += i;
+		len -= i;
 	}
 
 	return off;
@@ -265,173 +397,207 @@ static void ppp_handle_client(struct ppp_driver_context *ppp, uint8_t byte)
 }
 #endif
 
-static int ppp_input_byte(struct ppp_driver_context *ppp, uint8_t byte)
+/* Can the peer leave out the Address and Control fields */
+static bool ppp_rx_acfc(struct ppp_driver_context *ppp)
 {
-	int ret = -EAGAIN;
+	struct ppp_context *ctx = net_if_l2_data(ppp->iface);
 
-	switch (ppp->state) {
-	case STATE_HDLC_FRAME_START:
-		/* Synchronizing the flow with HDLC flag field */
-		if (byte == 0x7e) {
-			/* Note that we do not save the sync flag */
-			LOG_DBG("Sync byte (0x%02x) start", byte);
-			ppp_change_state(ppp, STATE_HDLC_FRAME_ADDRESS);
-#if defined(CONFIG_PPP_CLIENT_CLIENTSERVER)
-		} else {
-			ppp_handle_client(ppp, byte);
+	return ctx->lcp.my_options.acfc;
+}
+
+static void ppp_drop_frame(struct ppp_driver_context *ppp)
+{
+	if (ppp->pkt) {
+		net_pkt_unref(ppp->pkt);
+		ppp->pkt = NULL;
+	}
+}
+
+static void ppp_process_msg(struct ppp_driver_context *ppp)
+{
+	struct net_pkt *pkt = ppp->pkt;
+	struct net_buf *buf = pkt->buffer;
+
+	ppp->pkt = NULL;
+
+	if (LOG_LEVEL >= LOG_LEVEL_DBG) {
+		net_pkt_hexdump(pkt, "recv ppp");
+	}
+
+	/* The FCS was computed while the frame was received */
+	if (IS_ENABLED(CONFIG_NET_PPP_VERIFY_FCS) &&
+	    ppp->rx_fcs != PPP_FCS_GOOD) {
+		LOG_DBG("Invalid FCS (0x%x)", ppp->rx_fcs);
+#if defined(CONFIG_NET_STATISTICS_PPP)
+		ppp->stats.chkerr++;
 #endif
-		}
+		goto drop;
+	}
 
-		break;
+	/* Remove the Address (0xff) and Control (0x03) fields, unless the
+	 * peer compressed them away, as the PPP L2 layer does not need
+	 * those bytes. RFC 1661 ch. 6.6
+	 */
+	if (buf->data[0] == HDLC_ADDRESS) {
+		if (buf->len < 2 || buf->data[1] != HDLC_CONTROL) {
+			goto drop;
+		}
 
-	case STATE_HDLC_FRAME_ADDRESS:
-		if (byte != 0xff) {
-			/* Check if we need to sync again */
-			if (byte == 0x7e) {
-				/* Just skip to the start of the pkt byte */
-				return -EAGAIN;
-			}
+		net_buf_pull(buf, 2);
+	} else if (!ppp_rx_acfc(ppp)) {
+		goto drop;
+	}
 
-			LOG_DBG("Invalid (0x%02x) byte, expecting Address",
-				byte);
+	/* Skip FCS bytes (2) */
+	(void)net_pkt_update_length(pkt, net_pkt_get_len(pkt) - 2);
 
-			/* If address is != 0xff, then ignore this
-			 * frame. RFC 1662 ch 3.1
-			 */
-			ppp_change_state(ppp, STATE_HDLC_FRAME_START);
-		} else {
-			LOG_DBG("Address byte (0x%02x) start", byte);
+	/* Make sure we now start reading from PPP header in
+	 * PPP L2 recv()
+	 */
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
 
-			ppp_change_state(ppp, STATE_HDLC_FRAME_DATA);
+	if (net_recv_data(ppp->iface, pkt) < 0) {
+		net_pkt_unref(pkt);
+	}
 
-			/* Save the address field so that we can calculate
-			 * the FCS. The address field will not be passed
-			 * to upper stack.
-			 */
-			ret = ppp_save_byte(ppp, byte);
-			if (ret < 0) {
-				ppp_change_state(ppp, STATE_HDLC_FRAME_START);
-			}
+	return;
 
-			ret = -EAGAIN;
-		}
+drop:
+#if defined(CONFIG_NET_STATISTICS_PPP)
+	ppp->stats.drop++;
+	ppp->stats.pkts.rx++;
+#endif
+	net_pkt_unref(pkt);
+}
 
-		break;
+/* Decode a block of received data. The data between the flags and escape
+ * characters is copied to the network buffers in one go, and the frames
+ * completed in the block are passed to the network stack.
+ */
+static void ppp_input(struct ppp_driver_context *ppp,
+		      const uint8_t *data, size_t len)
+{
+	const uint8_t *end = data + len;
+	const uint8_t *run;
+	uint8_t byte;
 
-	case STATE_HDLC_FRAME_DATA:
-		/* If the next frame starts, then send this one
-		 * up in the network stack.
-		 */
-		if (byte == 0x7e) {
-			LOG_DBG("End of pkt (0x%02x)", byte);
-			ppp_change_state(ppp, STATE_HDLC_FRAME_ADDRESS);
-			ret = 0;
-		} else {
-			if (byte == 0x7d) {
-				/* RFC 1662, ch. 4.2 */
-				ppp->next_escaped = true;
-				break;
+	while (data < end) {
+		switch (ppp->state) {
+		case STATE_HDLC_FRAME_START:
+			/* Synchronizing the flow with HDLC flag field */
+#if defined(CONFIG_PPP_CLIENT_CLIENTSERVER)
+			while (data < end && *data != HDLC_FLAG) {
+				ppp_handle_client(ppp, *data++);
+			}
+#else
+			run = memchr(data, HDLC_FLAG, end - data);
+			data = run ? run : end;
+#endif
+			if (data < end) {
+				/* Note that we do not save the sync flag */
+				LOG_DBG("Sync byte (0x%02x) start", *data);
+				ppp_change_state(ppp, STATE_HDLC_FRAME_ADDRESS);
+				data++;
 			}
 
-			if (ppp->next_escaped) {
-				/* RFC 1662, ch. 4.2 */
-				byte ^= 0x20;
-				ppp->next_escaped = false;
+			break;
+
+		case STATE_HDLC_FRAME_ADDRESS:
+			if (*data == HDLC_FLAG) {
+				/* Just skip to the start of the pkt byte */
+				data++;
+				break;
 			}
 
-			ret = ppp_save_byte(ppp, byte);
-			if (ret < 0) {
+			/* If address is != 0xff, then ignore this frame unless
+			 * the Address and Control fields can be compressed.
+			 * RFC 1662 ch 3.1, RFC 1661 ch 6.6
+			 */
+			if (*data != HDLC_ADDRESS && !ppp_rx_acfc(ppp)) {
+				LOG_DBG("Invalid (0x%02x) byte, expecting "
+					"Address", *data);
 				ppp_change_state(ppp, STATE_HDLC_FRAME_START);
+				break;
 			}
 
-			ret = -EAGAIN;
-		}
-
-		break;
-
-	default:
-		LOG_DBG("[%p] Invalid state %d", ppp, ppp->state);
-		break;
-	}
-
-	return ret;
-}
+			/* The Address and Control fields are saved so that
+			 * the FCS covers them, they are removed once the
+			 * frame is complete.
+			 */
+			ppp->rx_fcs = PPP_FCS_INIT;
+			ppp->next_escaped = false;
+			ppp_change_state(ppp, STATE_HDLC_FRAME_DATA);
+			break;
 
-static bool ppp_check_fcs(struct ppp_driver_context *ppp)
-{
-	struct net_buf *buf;
-	uint16_t crc;
+		case STATE_HDLC_FRAME_DATA:
+			if (ppp->next_escaped) {
+				ppp->next_escaped = false;
 
-	buf = ppp->pkt->buffer;
-	if (!buf) {
-		return false;
-	}
+				/* An escaped flag aborts the frame */
+				if (*data == HDLC_FLAG) {
+					LOG_DBG("Frame aborted");
+					ppp_drop_frame(ppp);
+					ppp_change_state(ppp,
+						STATE_HDLC_FRAME_ADDRESS);
+					data++;
+					break;
+				}
 
-	crc = crc16_ccitt(0xffff, buf->data, buf->len);
+				/* RFC 1662, ch. 4.2 */
+				byte = *data++ ^ HDLC_ESC_XOR;
 
-	buf = buf->frags;
+				if (ppp_save_bytes(ppp, &byte, 1) < 0) {
+					ppp_change_state(ppp,
+						STATE_HDLC_FRAME_START);
+				}
 
-	while (buf) {
-		crc = crc16_ccitt(crc, buf->data, buf->len);
-		buf = buf->frags;
-	}
+				break;
+			}
 
-	if (crc != 0xf0b8) {
-		LOG_DBG("Invalid FCS (0x%x)", crc);
-#if defined(CONFIG_NET_STATISTICS_PPP)
-		ppp->stats.chkerr++;
-#endif
-		return false;
-	}
+			run = data;
 
-	return true;
-}
+			while (data < end && *data != HDLC_FLAG &&
+			       *data != HDLC_ESC) {
+				data++;
+			}
 
-static void ppp_process_msg(struct ppp_driver_context *ppp)
-{
-	if (LOG_LEVEL >= LOG_LEVEL_DBG) {
-		net_pkt_hexdump(ppp->pkt, "recv ppp");
-	}
+			if (data > run &&
+			    ppp_save_bytes(ppp, run, data - run) < 0) {
+				ppp_change_state(ppp, STATE_HDLC_FRAME_START);
+				break;
+			}
 
-	if (IS_ENABLED(CONFIG_NET_PPP_VERIFY_FCS) && !ppp_check_fcs(ppp)) {
-#if defined(CONFIG_NET_STATISTICS_PPP)
-		ppp->stats.drop++;
-		ppp->stats.pkts.rx++;
-#endif
-		net_pkt_unref(ppp->pkt);
-	} else {
-		/* Remove the Address (0xff), Control (0x03) and
-		 * FCS fields (16-bit) as the PPP L2 layer does not need
-		 * those bytes.
-		 */
-		uint16_t addr_and_ctrl = net_buf_pull_be16(ppp->pkt->buffer);
+			if (data == end) {
+				break;
+			}
 
-		/* Currently we do not support compressed Address and Control
-		 * fields so they must always be present.
-		 */
-		if (addr_and_ctrl != (0xff << 8 | 0x03)) {
-#if defined(CONFIG_NET_STATISTICS_PPP)
-			ppp->stats.drop++;
-			ppp->stats.pkts.rx++;
-#endif
-			net_pkt_unref(ppp->pkt);
-		} else {
-			/* Skip FCS bytes (2) */
-			net_buf_frag_last(ppp->pkt->buffer)->len -= 2;
+			if (*data++ == HDLC_ESC) {
+				ppp->next_escaped = true;
+				break;
+			}
 
-			/* Make sure we now start reading from PPP header in
-			 * PPP L2 recv()
+			/* If the next frame starts, then send this one
+			 * up in the network stack.
 			 */
-			net_pkt_cursor_init(ppp->pkt);
-			net_pkt_set_overwrite(ppp->pkt, true);
+			LOG_DBG("End of pkt (0x%02x)", HDLC_FLAG);
+			ppp_change_state(ppp, STATE_HDLC_FRAME_ADDRESS);
 
-			if (net_recv_data(ppp->iface, ppp->pkt) < 0) {
-				net_pkt_unref(ppp->pkt);
+			/* Ignore empty or too short frames */
+			if (ppp->pkt && net_pkt_get_len(ppp->pkt) > 3) {
+				ppp_process_msg(ppp);
+			} else {
+				ppp_drop_frame(ppp);
 			}
+
+			break;
+
+		default:
+			LOG_DBG("[%p] Invalid state %d", ppp, ppp->state);
+			ppp_change_state(ppp, STATE_HDLC_FRAME_START);
+			break;
 		}
 	}
-
-	ppp->pkt = NULL;
 }
 
 #if defined(CONFIG_NET_TEST)
@@ -439,32 +605,10 @@ static uint8_t *ppp_recv_cb(uint8_t *buf, size_t *off)
 {
 	struct ppp_driver_context *ppp =
 		CONTAINER_OF(buf, struct ppp_driver_context, buf);
-	size_t i, len = *off;
-
-	for (i = 0; i < *off; i++) {
-		if (0) {
-			/* Extra debugging can be enabled separately if really
-			 * needed. Normally it would just print too much data.
-			 */
-			LOG_DBG("[%zd] %02x", i, buf[i]);
-		}
 
-		if (ppp_input_byte(ppp, buf[i]) == 0) {
-			/* Ignore empty or too short frames */
-			if (ppp->pkt && net_pkt_get_len(ppp->pkt) > 3) {
-				ppp_process_msg(ppp);
-				break;
-			}
-		}
-	}
+	ppp_input(ppp, buf, *off);
 
-	if (i == *off) {
-		*off = 0;
-	} else {
-		*off = len - i - 1;
-
-		memmove(&buf[0], &buf[i + 1], *off);
-	}
+	*off = 0;
 
 	return buf;
 }
@@ -503,59 +647,18 @@ void ppp_driver_feed_data(uint8_t *data, int data_len)
 }
 #endif
 
-static bool calc_fcs(struct net_pkt *pkt, uint16_t *fcs, uint16_t protocol)
-{
-	struct net_buf *buf;
-	uint16_t crc;
-	uint16_t c;
-
-	buf = pkt->buffer;
-	if (!buf) {
-		return false;
-	}
-
-	/* HDLC Address and Control fields */
-	c = sys_cpu_to_be16(0xff << 8 | 0x03);
-
-	crc = crc16_ccitt(0xffff, (const uint8_t *)&c, sizeof(c));
-
-	if (protocol > 0) {
-		crc = crc16_ccitt(crc, (const uint8_t *)&protocol,
-				  sizeof(protocol));
-	}
-
-	while (buf) {
-		crc = crc16_ccitt(crc, buf->data, buf->len);
-		buf = buf->frags;
-	}
-
-	crc ^= 0xffff;
-	*fcs = crc;
-
-	return true;
-}
-
-static uint16_t ppp_escape_byte(uint8_t byte, int *offset)
-{
-	if (byte == 0x7e || byte == 0x7d || byte < 0x20) {
-		*offset = 0;
-		return (0x7d << 8) | (byte ^ 0x20);
-	}
-
-	*offset = 1;
-	return byte;
-}
-
 static int ppp_send(const struct device *dev, struct net_pkt *pkt)
 {
 	struct ppp_driver_context *ppp = dev->data;
 	struct net_buf *buf = pkt->buffer;
+	struct ppp_context *ctx;
+	uint16_t fcs = PPP_FCS_INIT;
 	uint16_t protocol = 0;
 	int send_off = 0;
-	uint32_t sync_addr_ctrl;
-	uint16_t fcs, escaped;
+	uint8_t hdr[4];
+	int hdr_len = 0;
 	uint8_t byte;
-	int i, offset;
+	bool acfc;
 
 #if defined(CONFIG_NET_TEST)
 	return 0;
@@ -573,19 +676,19 @@ static int ppp_send(const struct device *dev, struct net_pkt *pkt)
 	 */
 	if (!net_pkt_is_ppp(pkt)) {
 		if (net_pkt_family(pkt) == AF_INET) {
-			protocol = htons(PPP_IP);
+			protocol = PPP_IP;
 		} else if (net_pkt_family(pkt) == AF_INET6) {
-			protocol = htons(PPP_IPV6);
+			protocol = PPP_IPV6;
 		} else if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) &&
 			   net_pkt_family(pkt) == AF_PACKET) {
 			char type = (NET_IPV6_HDR(pkt)->vtc & 0xf0);
 
 			switch (type) {
 			case 0x60:
-				protocol = htons(PPP_IPV6);
+				protocol = PPP_IPV6;
 				break;
 			case 0x40:
-				protocol = htons(PPP_IP);
+				protocol = PPP_IP;
 				break;
 			default:
 				return -EPROTONOSUPPORT;
@@ -595,60 +698,53 @@ static int ppp_send(const struct device *dev, struct net_pkt *pkt)
 		}
 	}
 
-	if (!calc_fcs(pkt, &fcs, protocol)) {
-		return -ENOMEM;
-	}
+	ctx = net_if_l2_data(ppp->iface);
 
-	/* Sync, Address & Control fields */
-	sync_addr_ctrl = sys_cpu_to_be32(0x7e << 24 | 0xff << 16 |
-					 0x7d << 8 | 0x23);
-	send_off = ppp_send_bytes(ppp, (const uint8_t *)&sync_addr_ctrl,
-				  sizeof(sync_addr_ctrl), send_off);
+	/* LCP packets are always sent with the Address and Control fields,
+	 * RFC 1661 ch. 6.6
+	 */
+	acfc = ctx->lcp.peer_options.acfc &&
+	       !(net_pkt_is_ppp(pkt) && buf->len >= sizeof(uint16_t) &&
+		 sys_get_be16(buf->data) == PPP_LCP);
 
-	if (protocol > 0) {
-		escaped = htons(ppp_escape_byte(protocol, &offset));
-		send_off = ppp_send_bytes(ppp, (uint8_t *)&escaped + offset,
-					  offset ? 1 : 2,
-					  send_off);
+	if (!acfc) {
+		hdr[hdr_len++] = HDLC_ADDRESS;
+		hdr[hdr_len++] = HDLC_CONTROL;
+	}
 
-		escaped = htons(ppp_escape_byte(protocol >> 8, &offset));
-		send_off = ppp_send_bytes(ppp, (uint8_t *)&escaped + offset,
-					  offset ? 1 : 2,
-					  send_off);
+	/* Only the protocols below 0x100 can be compressed to one byte,
+	 * RFC 1661 ch. 6.5
+	 */
+	if (protocol > 0 && (protocol > 0xff || !ctx->lcp.peer_options.pfc)) {
+		hdr[hdr_len++] = protocol >> 8;
+		hdr[hdr_len++] = protocol;
+	} else if (protocol > 0) {
+		hdr[hdr_len++] = protocol;
 	}
 
-	/* Note that we do not print the first four bytes and FCS bytes at the
-	 * end so that we do not need to allocate separate net_buf just for
-	 * that purpose.
+	/* Sync, Address, Control and Protocol fields */
+	byte = HDLC_FLAG;
+	send_off = ppp_send_bytes(ppp, &byte, 1, send_off);
+	send_off = ppp_send_escaped(ppp, hdr, hdr_len, send_off, &fcs);
+
+	/* Note that we do not print the header and FCS bytes so that we do
+	 * not need to allocate separate net_buf just for that purpose.
 	 */
 	if (LOG_LEVEL >= LOG_LEVEL_DBG) {
 		net_pkt_hexdump(pkt, "send ppp");
 	}
 
-	while (buf) {
-		for (i = 0; i < buf->len; i++) {
-			/* Escape illegal bytes */
-			escaped = htons(ppp_escape_byte(buf->data[i], &offset));
-			send_off = ppp_send_bytes(ppp,
-						  (uint8_t *)&escaped + offset,
-						  offset ? 1 : 2,
-						  send_off);
-		}
-
-		buf = buf->frags;
+	/* The data is escaped and the FCS computed in the same pass */
+	for (; buf; buf = buf->frags) {
+		send_off = ppp_send_escaped(ppp, buf->data, buf->len,
+					    send_off, &fcs);
 	}
 
-	escaped = htons(ppp_escape_byte(fcs, &offset));
-	send_off = ppp_send_bytes(ppp, (uint8_t *)&escaped + offset,
-				  offset ? 1 : 2,
-				  send_off);
+	/* The FCS is sent least significant byte first */
+	sys_put_le16(fcs ^ 0xffff, hdr);
+	send_off = ppp_send_escaped(ppp, hdr, sizeof(fcs), send_off, NULL);
 
-	escaped = htons(ppp_escape_byte(fcs >> 8, &offset));
-	send_off = ppp_send_bytes(ppp, (uint8_t *)&escaped + offset,
-				  offset ? 1 : 2,
-				  send_off);
-
-	byte = 0x7e;
+	byte = HDLC_FLAG;
 	send_off = ppp_send_bytes(ppp, &byte, 1, send_off);
 
 	(void)ppp_send_flush(ppp, send_off);
@@ -660,7 +756,7 @@ static int ppp_send(const struct device *dev, struct net_pkt *pkt)
 static int ppp_consume_ringbuf(struct ppp_driver_context *ppp)
 {
 	uint8_t *data;
-	size_t len, tmp;
+	size_t len;
 	int ret;
 
 	len = ring_buf_get_claim(&ppp->rx_ringbuf, &data,
@@ -675,16 +771,7 @@ static int ppp_consume_ringbuf(struct ppp_driver_context *ppp)
 		LOG_HEXDUMP_DBG(data, len, ppp->dev->name);
 	}
 
-	tmp = len;
-
-	do {
-		if (ppp_input_byte(ppp, *data++) == 0) {
-			/* Ignore empty or too short frames */
-			if (ppp->pkt && net_pkt_get_len(ppp->pkt) > 3) {
-				ppp_process_msg(ppp);
-			}
-		}
-	} while (--tmp);
+	ppp_input(ppp, data, len);
 
 	ret = ring_buf_get_finish(&ppp->rx_ringbuf, len);
 	if (ret < 0) {
@@ -722,6 +809,11 @@ static int ppp_driver_init(const struct device *dev)
 	k_thread_name_set(&ppp->cb_workq.thread, "ppp_workq");
 #endif
 
+#if defined(CONFIG_NET_PPP_ASYNC_UART)
+	k_sem_init(&ppp->tx_sem, 1, 1);
+#endif
+
+	ppp->send_buf = ppp->send_bufs[0];
 	ppp->pkt = NULL;
 	ppp_change_state(ppp, STATE_HDLC_FRAME_START);
 #if defined(CONFIG_PPP_CLIENT_CLIENTSERVER)
@@ -798,7 +890,59 @@ static struct net_stats_ppp *ppp_get_stats(const struct device *dev)
 }
 #endif
 
-#if !defined(CONFIG_NET_TEST)
+#if defined(CONFIG_NET_PPP_ASYNC_UART) && !defined(CONFIG_NET_TEST)
+static void ppp_uart_async_cb(const struct device *uart,
+			      struct uart_event *evt, void *user_data)
+{
+	struct ppp_driver_context *context = user_data;
+	int ret;
+
+	switch (evt->type) {
+	case UART_TX_DONE:
+	case UART_TX_ABORTED:
+		k_sem_give(&context->tx_sem);
+		break;
+
+	case UART_RX_RDY:
+		ret = ring_buf_put(&context->rx_ringbuf,
+				   evt->data.rx.buf + evt->data.rx.offset,
+				   evt->data.rx.len);
+		if (ret < evt->data.rx.len) {
+			LOG_ERR("Rx buffer doesn't have enough space. "
+				"Bytes pending: %zu, written: %d",
+				evt->data.rx.len, ret);
+		}
+
+		k_work_submit_to_queue(&context->cb_workq, &context->cb_work);
+		break;
+
+	case UART_RX_BUF_REQUEST:
+		context->rx_buf_idx ^= 1;
+
+		(void)uart_rx_buf_rsp(uart,
+				      context->rx_bufs[context->rx_buf_idx],
+				      sizeof(context->rx_bufs[0]));
+		break;
+
+	case UART_RX_DISABLED:
+		/* The reception stops after an error or when the buffers
+		 * ran out, start it again unless PPP was stopped.
+		 */
+		if (atomic_get(&context->modem_init_done)) {
+			context->rx_buf_idx = 0;
+
+			(void)uart_rx_enable(uart, context->rx_bufs[0],
+					     sizeof(context->rx_bufs[0]),
+					     CONFIG_NET_PPP_ASYNC_UART_RX_TIMEOUT);
+		}
+
+		break;
+
+	default:
+		break;
+	}
+}
+#elif !defined(CONFIG_NET_TEST)
 static void ppp_uart_flush(const struct device *dev)
 {
 	uint8_t c;
@@ -844,6 +988,9 @@ static int ppp_start(const struct device *dev)
 #if !defined(CONFIG_NET_TEST)
 	if (atomic_cas(&context->modem_init_done, false, true)) {
 		const char *dev_name = NULL;
+#if defined(CONFIG_NET_PPP_ASYNC_UART)
+		int ret;
+#endif
 
 		/* Now try to figure out what device to open. If GSM muxing
 		 * is enabled, then use it. If not, then check if modem
@@ -879,12 +1026,28 @@ static int ppp_start(const struct device *dev)
 			return -ENODEV;
 		}
 
+#if defined(CONFIG_NET_PPP_ASYNC_UART)
+		uart_callback_set(context->dev, ppp_uart_async_cb, context);
+
+		context->rx_buf_idx = 0;
+
+		ret = uart_rx_enable(context->dev, context->rx_bufs[0],
+				     sizeof(context->rx_bufs[0]),
+				     CONFIG_NET_PPP_ASYNC_UART_RX_TIMEOUT);
+		if (ret < 0) {
+			LOG_ERR("Cannot enable %s reception (%d)", dev_name,
+				ret);
+			context->modem_init_done = false;
+			return ret;
+		}
+#else
 		uart_irq_rx_disable(context->dev);
 		uart_irq_tx_disable(context->dev);
 		ppp_uart_flush(context->dev);
 		uart_irq_callback_user_data_set(context->dev, ppp_uart_isr,
 						context);
 		uart_irq_rx_enable(context->dev);
+#endif
 	}
 #endif /* !CONFIG_NET_TEST */
 
@@ -899,6 +1062,14 @@ static int ppp_stop(const struct device *dev)
 
 	net_ppp_carrier_off(context->iface);
 	context->modem_init_done = false;
+
+#if defined(CONFIG_NET_PPP_ASYNC_UART) && !defined(CONFIG_NET_TEST)
+	/* The reception is enabled again when PPP is started */
+	if (context->dev) {
+		(void)uart_rx_disable(context->dev);
+	}
+#endif
+
 	return 0;
 }
 
@@ -1245,6 +1245,35 @@ static inline struct net_buf *net_buf_alloc(struct net_buf_pool *pool,
 	return net_buf_alloc_fixed(pool, timeout);
 }
 
+/**
+ * @brief Allocate a chain of fixed buffers from a pool.
+ *
+ * Allocate as many buffers as needed to hold @a len bytes of data and link
+ * them together as fragments. The pool is accessed once for all the
+ * buffers which have never been used, and a single deadline applies to the
+ * whole chain. Either the complete chain is allocated or none of it.
+ *
+ * @param pool Which pool to allocate the buffers from. It must use fixed
+ *        size data.
+ * @param len Amount of data the chain must be able to fit.
+ * @param timeout Affects the action taken should the pool be empty.
+ *        If K_NO_WAIT, then return immediately. If K_FOREVER, then
+ *        wait as long as necessary. Otherwise, wait until the specified
+ *        timeout.
+ *
+ * @return First buffer of the chain or NULL if out of buffers.
+ */
+#if defined(CONFIG_NET_BUF_LOG)
+struct net_buf *net_buf_alloc_chain_debug(struct net_buf_pool *pool,
+					  size_t len, k_timeout_t timeout,
+					  const char *func, int line);
+#define net_buf_alloc_chain(_pool, _len, _timeout) \
+	net_buf_alloc_chain_debug(_pool, _len, _timeout, __func__, __LINE__)
+#else
+struct net_buf *net_buf_alloc_chain(struct net_buf_pool *pool, size_t len,
+				    k_timeout_t timeout);
+#endif
+
 /**
  * @brief Allocate a new variable length buffer from a pool.
  *
@@ -1399,7 +1428,10 @@ void net_buf_put(struct k_fifo *fifo, struct net_buf *buf);
 /**
  * @brief Decrements the reference count of a buffer.
  *
- * The buffer is put back into the pool if the reference count reaches zero.
+ * The buffer is put back into the pool if the reference count reaches zero,
+ * and so are its fragments. Consecutive fragments returned to the same pool
+ * are put back in a single operation, unless the pool has a destroy
+ * callback.
  *
  * @param buf A valid pointer on a buffer
  */
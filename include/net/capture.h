@@ -14,6 +14,7 @@
 #define ZEPHYR_INCLUDE_NET_CAPTURE_H_
 
 #include <zephyr.h>
+#include <string.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -195,6 +196,14 @@ static inline int net_capture_send(const struct device *dev,
 
 /** @cond INTERNAL_HIDDEN */
 
+#if defined(CONFIG_NET_CAPTURE)
+void net_capture_tunnel_pkt(struct net_if *iface, struct net_pkt *pkt);
+#endif
+
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+void net_capture_local_pkt(struct net_if *iface, struct net_pkt *pkt);
+#endif
+
 /**
  * @brief Check if the network packet needs to be captured or not.
  *        This is called for every network packet being sent.
@@ -202,15 +211,20 @@ static inline int net_capture_send(const struct device *dev,
  * @param iface Network interface the packet is being sent
  * @param pkt The network packet that is sent
  */
-#if defined(CONFIG_NET_CAPTURE)
-void net_capture_pkt(struct net_if *iface, struct net_pkt *pkt);
-#else
 static inline void net_capture_pkt(struct net_if *iface, struct net_pkt *pkt)
 {
+	/* The local capture goes first as the tunnel marks the packets it
+	 * has captured.
+	 */
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+	net_capture_local_pkt(iface, pkt);
+#endif
+#if defined(CONFIG_NET_CAPTURE)
+	net_capture_tunnel_pkt(iface, pkt);
+#endif
 	ARG_UNUSED(iface);
 	ARG_UNUSED(pkt);
 }
-#endif
 
 struct net_capture_info {
 	const struct device *capture_dev;
@@ -252,6 +266,178 @@ static inline void net_capture_foreach(net_capture_cb_t cb, void *user_data)
 
 /** @endcond */
 
+/** Local packet capture statistics */
+struct net_capture_local_stats {
+	/** Packets written to the capture buffer */
+	uint32_t captured;
+
+	/** Packets rejected by the filter */
+	uint32_t filtered;
+
+	/** Captured packets truncated to the snap length */
+	uint32_t truncated;
+
+	/** Captured packets overwritten by newer ones */
+	uint32_t overwritten;
+
+	/** Packets missed while the capture buffer was being read */
+	uint32_t dropped;
+};
+
+/**
+ * @typedef net_capture_local_cb_t
+ * @brief Callback receiving the pcapng data of a local capture
+ *
+ * @param data Next chunk of pcapng data
+ * @param len Length of the chunk
+ * @param user_data A valid pointer to user data or NULL
+ *
+ * @return 0 to continue, <0 to stop reading
+ */
+typedef int (*net_capture_local_cb_t)(const void *data, size_t len,
+				      void *user_data);
+
+/**
+ * @brief Start capturing network packets locally.
+ *
+ * @details The captured packets are stored as pcapng records in a RAM ring
+ * buffer, the oldest ones being overwritten when it is full. No network
+ * interface is needed to capture.
+ *
+ * The filter uses a subset of the pcap filter syntax: the ip, ip6, arp,
+ * tcp, udp, icmp and icmp6 protocols, [src|dst] host ADDR, [src|dst] port
+ * PORT, less LEN and greater LEN, combined with and, or, not and
+ * parentheses. It is applied to the headers of the packet before anything
+ * is copied to the buffer.
+ *
+ * @param iface Network interface to capture, NULL for all of them.
+ * @param filter Filter expression, NULL or empty to capture all packets.
+ * @param snaplen Number of bytes captured per packet, 0 for the
+ *        CONFIG_NET_CAPTURE_LOCAL_SNAPLEN default.
+ *
+ * @return 0 if ok, -EINVAL if the filter is invalid, -ENOMEM if it is too
+ *         long, -EALREADY if the capture is already started.
+ */
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+int net_capture_local_start(struct net_if *iface, const char *filter,
+			    uint16_t snaplen);
+#else
+static inline int net_capture_local_start(struct net_if *iface,
+					  const char *filter,
+					  uint16_t snaplen)
+{
+	ARG_UNUSED(iface);
+	ARG_UNUSED(filter);
+	ARG_UNUSED(snaplen);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Stop capturing network packets locally.
+ *
+ * @details The captured packets are kept in the buffer.
+ *
+ * @return 0 if ok, -EALREADY if the capture is not started.
+ */
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+int net_capture_local_stop(void);
+#else
+static inline int net_capture_local_stop(void)
+{
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Is the local packet capture started.
+ *
+ * @return True if started, False otherwise.
+ */
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+bool net_capture_local_is_started(void);
+#else
+static inline bool net_capture_local_is_started(void)
+{
+	return false;
+}
+#endif
+
+/**
+ * @brief Discard the captured packets and reset the statistics.
+ */
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+void net_capture_local_clear(void);
+#else
+static inline void net_capture_local_clear(void)
+{
+}
+#endif
+
+/**
+ * @brief Get the local packet capture statistics.
+ *
+ * @param stats Statistics of the capture. This is filled by the function.
+ */
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+void net_capture_local_get_stats(struct net_capture_local_stats *stats);
+#else
+static inline void net_capture_local_get_stats(
+					struct net_capture_local_stats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+}
+#endif
+
+/**
+ * @brief Read the captured packets as a pcapng file.
+ *
+ * @details The section header, one interface description per network
+ * interface and the captured packets are passed to the callback in order.
+ * The interface id of a packet is its network interface index minus one.
+ * Packets captured while reading are dropped.
+ *
+ * @param cb Callback receiving the pcapng data
+ * @param user_data User supplied data
+ *
+ * @return 0 if ok, the error returned by the callback otherwise.
+ */
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+int net_capture_local_read(net_capture_local_cb_t cb, void *user_data);
+#else
+static inline int net_capture_local_read(net_capture_local_cb_t cb,
+					 void *user_data)
+{
+	ARG_UNUSED(cb);
+	ARG_UNUSED(user_data);
+
+	return -ENOTSUP;
+}
+#endif
+
+/**
+ * @brief Save the captured packets to a pcapng file.
+ *
+ * @details The file is written using the file system API and replaced if
+ * it exists.
+ *
+ * @param path Path of the file
+ *
+ * @return 0 if ok, -ENOTSUP if there is no file system support, <0 if
+ *         the file cannot be written.
+ */
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+int net_capture_local_save(const char *path);
+#else
+static inline int net_capture_local_save(const char *path)
+{
+	ARG_UNUSED(path);
+
+	return -ENOTSUP;
+}
+#endif
+
 /**
  * @}
  */
@@ -73,6 +73,9 @@ enum coap_method {
 	COAP_METHOD_POST = 2,
 	COAP_METHOD_PUT = 3,
 	COAP_METHOD_DELETE = 4,
+	COAP_METHOD_FETCH = 5,
+	COAP_METHOD_PATCH = 6,
+	COAP_METHOD_IPATCH = 7,
 };
 
 #define COAP_REQUEST_MASK 0x07
@@ -219,8 +222,26 @@ struct coap_observer {
 	struct sockaddr addr;
 	uint8_t token[8];
 	uint8_t tkl;
+#if defined(CONFIG_COAP_OBSERVE_COALESCE)
+	uint32_t last_notify; /* Time of the last notification, in ms */
+	bool deferred; /* A notification is waiting for the interval */
+#endif
+};
+
+#if defined(CONFIG_COAP_OPTION_INDEX)
+/**
+ * @brief Location of an option value inside of a CoAP packet.
+ */
+struct coap_option_ref {
+	uint16_t code; /* Option number */
+	uint16_t offset; /* Offset of the option value in the packet */
+	uint16_t len; /* Length of the option value */
 };
 
+/* The option index of a packet with more options can not be used */
+#define COAP_OPTION_INDEX_INVALID UINT8_MAX
+#endif
+
 /**
  * @brief Representation of a CoAP Packet.
  */
@@ -234,6 +255,11 @@ struct coap_packet {
 #if defined(CONFIG_COAP_KEEP_USER_DATA)
 	void *user_data; /* Application specific user data */
 #endif
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	/* Options in the order they appear in the packet */
+	struct coap_option_ref opt_index[CONFIG_COAP_OPTION_INDEX_SIZE];
+	uint8_t opt_count; /* Number of indexed options */
+#endif
 };
 
 struct coap_option {
@@ -259,6 +285,23 @@ typedef int (*coap_reply_t)(const struct coap_packet *response,
 #define COAP_DEFAULT_MAX_RETRANSMIT 4
 #define COAP_DEFAULT_ACK_RANDOM_FACTOR 1.5
 
+#if defined(CONFIG_COAP_COCOA)
+/**
+ * @brief Retransmission timeout estimator for one remote endpoint.
+ *
+ * Implements the CoCoA strong and weak RTT estimators
+ * (draft-ietf-core-cocoa), all times are in milliseconds.
+ */
+struct coap_rto_estimator {
+	uint32_t rto; /* Overall retransmission timeout */
+	uint32_t strong_srtt; /* From exchanges without retransmission */
+	uint32_t strong_rttvar;
+	uint32_t weak_srtt; /* From exchanges with one or two retransmissions */
+	uint32_t weak_rttvar;
+	uint32_t updated; /* Time of the last update of the timeout */
+};
+#endif
+
 /**
  * @brief Represents a request awaiting for an acknowledgment (ACK).
  */
@@ -270,6 +313,12 @@ struct coap_pending {
 	uint8_t *data;
 	uint16_t len;
 	uint8_t retries;
+#if defined(CONFIG_COAP_COCOA)
+	struct coap_rto_estimator *rto; /* Estimator of the endpoint, or NULL */
+	uint32_t t_first; /* Time of the first transmission */
+	uint8_t retransmissions; /* Number of retransmissions so far */
+	uint8_t backoff; /* Backoff factor, in halves */
+#endif
 };
 
 /**
@@ -514,6 +563,83 @@ int coap_handle_request(struct coap_packet *cpkt,
 			uint8_t opt_num,
 			struct sockaddr *addr, socklen_t addr_len);
 
+/**
+ * @brief Node of a resource dispatch trie, one per path segment.
+ */
+struct coap_resource_trie_node {
+	const char *segment; /* Path segment, NULL for the root */
+	uint16_t len; /* Length of the path segment */
+	int16_t first_child; /* Index of the first child node, or -1 */
+	int16_t next_sibling; /* Index of the next sibling node, or -1 */
+	int16_t resource; /* Index of the resource at this path, or -1 */
+};
+
+/**
+ * @brief Resource dispatch trie.
+ *
+ * Looks up the resource of a request by walking the path segments once,
+ * instead of comparing the request with the path of every resource.
+ */
+struct coap_resource_trie {
+	struct coap_resource *resources;
+	struct coap_resource_trie_node *nodes;
+	uint16_t node_count;
+	uint16_t max_nodes;
+};
+
+/**
+ * @brief Build a resource dispatch trie
+ *
+ * Resources must not be added to or removed from the array while the trie
+ * is in use. When several resources match a request, the first one in the
+ * array is used, as with coap_handle_request().
+ *
+ * @param trie Trie to initialize
+ * @param resources Array of known resources, terminated by a resource
+ *        without path
+ * @param nodes Storage for the trie nodes
+ * @param max_nodes Number of nodes in the storage. One node is needed for
+ *        the root and one for each distinct path prefix.
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_resource_trie_init(struct coap_resource_trie *trie,
+			    struct coap_resource *resources,
+			    struct coap_resource_trie_node *nodes,
+			    uint16_t max_nodes);
+
+/**
+ * @brief Find the resource matching the URI path of a request
+ *
+ * @param trie Resource dispatch trie
+ * @param options Parsed options from coap_packet_parse()
+ * @param opt_num Number of options
+ *
+ * @return Matching resource, or NULL if there is none.
+ */
+struct coap_resource *coap_resource_trie_find(
+	const struct coap_resource_trie *trie,
+	const struct coap_option *options, uint8_t opt_num);
+
+/**
+ * @brief When a request is received, call the appropriate methods of
+ * the matching resource found with a dispatch trie.
+ *
+ * @param cpkt Packet received
+ * @param trie Resource dispatch trie
+ * @param options Parsed options from coap_packet_parse()
+ * @param opt_num Number of options
+ * @param addr Peer address
+ * @param addr_len Peer address length
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_handle_request_trie(struct coap_packet *cpkt,
+			     const struct coap_resource_trie *trie,
+			     struct coap_option *options,
+			     uint8_t opt_num,
+			     struct sockaddr *addr, socklen_t addr_len);
+
 /**
  * Represents the size of each block that will be transferred using
  * block-wise transfers [RFC7959]:
@@ -825,6 +951,42 @@ struct coap_pending *coap_pending_next_to_expire(
  */
 bool coap_pending_cycle(struct coap_pending *pending);
 
+#if defined(CONFIG_COAP_COCOA)
+/**
+ * @brief Initialize a retransmission timeout estimator.
+ *
+ * @param est Estimator to initialize, one per remote endpoint
+ */
+void coap_rto_estimator_init(struct coap_rto_estimator *est);
+
+/**
+ * @brief Use the retransmission timeout estimator of the remote endpoint
+ * for a pending request.
+ *
+ * The initial timeout and the backoff between retransmissions are then
+ * derived from the estimator instead of CONFIG_COAP_INIT_ACK_TIMEOUT_MS.
+ * Must be called after coap_pending_init() and before the first call to
+ * coap_pending_cycle().
+ *
+ * @param pending Pending representation
+ * @param est Estimator of the remote endpoint
+ */
+void coap_pending_set_rto_estimator(struct coap_pending *pending,
+				    struct coap_rto_estimator *est);
+
+/**
+ * @brief Update the estimator of a pending request with the round-trip
+ * time of the exchange.
+ *
+ * Should be called when the ACK of the pending request is received, before
+ * the pending request is cleared. Exchanges that needed more than two
+ * retransmissions are not used.
+ *
+ * @param pending Pending representation that was acknowledged
+ */
+void coap_rto_estimator_update(const struct coap_pending *pending);
+#endif
+
 /**
  * @brief Cancels the pending retransmission, so it again becomes
  * available.
@@ -862,12 +1024,34 @@ void coap_replies_clear(struct coap_reply *replies, size_t len);
  * @brief Indicates that this resource was updated and that the @a
  * notify callback should be called for every registered observer.
  *
+ * With CONFIG_COAP_OBSERVE_COALESCE, observers that were notified less
+ * than CONFIG_COAP_OBSERVE_MIN_INTERVAL_MS ago are not called, their
+ * notification is deferred until coap_resource_notify_deferred().
+ *
  * @param resource Resource that was updated
  *
  * @return 0 in case of success or negative in case of error.
  */
 int coap_resource_notify(struct coap_resource *resource);
 
+#if defined(CONFIG_COAP_OBSERVE_COALESCE)
+/**
+ * @brief Send the deferred notifications of a resource that are due.
+ *
+ * Updates of the resource while a notification was deferred are coalesced,
+ * the @a notify callback is called once and sends the latest state.
+ *
+ * The server calls this after coap_resource_notify() and again after the
+ * returned time, for example from a delayable work item.
+ *
+ * @param resource Resource with deferred notifications
+ *
+ * @return Time in milliseconds until the next deferred notification is
+ *         due, or SYS_FOREVER_MS if there is none.
+ */
+int32_t coap_resource_notify_deferred(struct coap_resource *resource);
+#endif
+
 /**
  * @brief Returns if this request is enabling observing a resource.
  *
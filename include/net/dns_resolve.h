@@ -240,6 +240,23 @@ struct dns_resolve_context {
 		 * cannot be used to find correct pending query.
 		 */
 		uint16_t query_hash;
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+		/** If set, this query does not send anything itself but is
+		 * completed together with the leader query that is already
+		 * resolving the same name and type.
+		 */
+		struct dns_pending_query *leader;
+
+		/** DNS id of the request sent by a cancelled leader query
+		 * that this query took over. The response to that request
+		 * completes this query.
+		 */
+		uint16_t adopted_id;
+
+		/** Is adopted_id valid */
+		bool has_adopted_id;
+#endif
 	} queries[CONFIG_DNS_NUM_CONCUR_QUERIES];
 
 	/** Is this context in use */
@@ -389,6 +406,42 @@ int dns_resolve_name(struct dns_resolve_context *ctx,
  */
 struct dns_resolve_context *dns_resolve_get_default(void);
 
+/**
+ * @typedef dns_resolve_cache_cb_t
+ * @brief Callback used when iterating over the DNS cache entries.
+ *
+ * @param query Name that was resolved.
+ * @param type Query type of the entry.
+ * @param info Cached addresses, NULL for a negative entry.
+ * @param count Number of cached addresses, 0 for a negative entry.
+ * @param ttl Remaining lifetime of the entry in seconds.
+ * @param user_data User data given to dns_resolve_cache_foreach().
+ */
+typedef void (*dns_resolve_cache_cb_t)(const char *query,
+				       enum dns_query_type type,
+				       const struct dns_addrinfo *info,
+				       size_t count,
+				       uint32_t ttl,
+				       void *user_data);
+
+/**
+ * @brief Go through all the valid DNS cache entries.
+ *
+ * @details The callback is called with the cache locked, so it must not
+ * call any DNS resolver functions.
+ *
+ * @param cb Callback to call for each entry.
+ * @param user_data User data passed to the callback.
+ *
+ * @return Number of entries found.
+ */
+int dns_resolve_cache_foreach(dns_resolve_cache_cb_t cb, void *user_data);
+
+/**
+ * @brief Remove all the entries from the DNS cache.
+ */
+void dns_resolve_cache_flush(void);
+
 /**
  * @brief Get IP address info from DNS.
  *
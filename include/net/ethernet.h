@@ -587,6 +587,86 @@ struct ethernet_context {
  */
 void ethernet_init(struct net_if *iface);
 
+struct net_eth_poll;
+
+/**
+ * @brief Callback used to receive pending frames from the device.
+ *
+ * @param poll Poll context of the device.
+ * @param budget Maximum number of frames to receive in this call.
+ *
+ * @return Number of frames received. A value smaller than @a budget
+ * tells that the device has no more pending frames.
+ */
+typedef int (*net_eth_poll_cb_t)(struct net_eth_poll *poll, int budget);
+
+/**
+ * @brief Callback used to enable or disable the RX interrupt of the device.
+ *
+ * @param poll Poll context of the device.
+ * @param enable True to enable the RX interrupt, false to disable it.
+ */
+typedef void (*net_eth_poll_irq_cb_t)(struct net_eth_poll *poll,
+				      bool enable);
+
+/**
+ * @brief Ethernet RX polling context.
+ *
+ * Drivers embed this in their context and call net_eth_poll_schedule()
+ * from their RX interrupt instead of receiving the frames there. The
+ * RX interrupt is kept disabled while the device is polled and it is
+ * enabled again once the device has no more frames pending.
+ */
+struct net_eth_poll {
+	/** Work item run in the Ethernet poll work queue */
+	struct k_work work;
+
+	/** Receive pending frames */
+	net_eth_poll_cb_t poll;
+
+	/** Enable or disable RX interrupt */
+	net_eth_poll_irq_cb_t irq;
+
+	/** Maximum number of frames received per poll */
+	int budget;
+
+	/** Poll state flags */
+	atomic_t flags;
+
+	/** Number of polls run */
+	uint32_t polls;
+
+	/** Number of polls that used their whole budget */
+	uint32_t exhausted;
+};
+
+#if defined(CONFIG_NET_L2_ETHERNET_POLL)
+/**
+ * @brief Initialize Ethernet RX polling context.
+ *
+ * @param poll Poll context to initialize.
+ * @param poll_cb Callback that receives pending frames.
+ * @param irq_cb Callback that enables or disables RX interrupt.
+ * @param budget Maximum number of frames received per poll, or 0 to use
+ * CONFIG_NET_L2_ETHERNET_POLL_BUDGET.
+ */
+void net_eth_poll_init(struct net_eth_poll *poll, net_eth_poll_cb_t poll_cb,
+		       net_eth_poll_irq_cb_t irq_cb, int budget);
+
+/**
+ * @brief Tell that the device has received frames.
+ *
+ * Disables RX interrupt of the device and schedules it to be polled.
+ * This can be called from an ISR.
+ *
+ * @param poll Poll context of the device.
+ *
+ * @return True if the poll was scheduled, false if the device was already
+ * being polled.
+ */
+bool net_eth_poll_schedule(struct net_eth_poll *poll);
+#endif /* CONFIG_NET_L2_ETHERNET_POLL */
+
 /** @cond INTERNAL_HIDDEN */
 
 #define ETHERNET_L2_CTX_TYPE	struct ethernet_context
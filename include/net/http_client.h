@@ -23,6 +23,7 @@
 #include <kernel.h>
 #include <net/net_ip.h>
 #include <net/http_parser.h>
+#include <net/tls_credentials.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -93,6 +94,42 @@ typedef void (*http_response_cb_t)(struct http_response *rsp,
 				   enum http_final_call final_data,
 				   void *user_data);
 
+/**
+ * @typedef http_payload_chunk_cb_t
+ * @brief Callback used to stream the payload to the server with chunked
+ * transfer coding.
+ *
+ * @param req HTTP request information
+ * @param data Set by the callback to the next chunk of the payload. The data
+ *        is sent as is and must stay valid until the callback is called
+ *        again.
+ * @param user_data User specified data specified in http_client_req()
+ *
+ * @return >0 length of the chunk,
+ *         0 if the whole payload was provided,
+ *         <0 if http_client_req() should return the error code to the
+ *            caller.
+ */
+typedef int (*http_payload_chunk_cb_t)(struct http_request *req,
+				       const uint8_t **data,
+				       void *user_data);
+
+/**
+ * @typedef http_body_cb_t
+ * @brief Callback used to hand out the body of the response as it is parsed.
+ *
+ * @param rsp HTTP response information
+ * @param data Part of the body, pointing into the receive buffer. The data is
+ *        only valid during the callback.
+ * @param len Length of the data
+ * @param user_data User specified data specified in http_client_req()
+ *
+ * @return 0 to continue receiving the response, any other value to abort it.
+ */
+typedef int (*http_body_cb_t)(struct http_response *rsp,
+			      const uint8_t *data, size_t len,
+			      void *user_data);
+
 /**
  * HTTP response from the server.
  */
@@ -154,6 +191,11 @@ struct http_response {
 	uint8_t cl_present : 1;
 	uint8_t body_found : 1;
 	uint8_t message_complete : 1;
+
+	/** The connection can be used for another request once the response
+	 * is complete.
+	 */
+	uint8_t keep_alive : 1;
 };
 
 /** HTTP client internal data that the application should not touch
@@ -181,6 +223,12 @@ struct http_client_internal_data {
 
 	/** Request timeout */
 	k_timeout_t timeout;
+
+	/** Some of the request was written to the socket */
+	bool request_sent;
+
+	/** Some of the response was received */
+	bool response_received;
 };
 
 /**
@@ -270,6 +318,20 @@ struct http_request {
 	 * headers will be placed into this field.
 	 */
 	const char **optional_headers;
+
+	/** User supplied callback function to call to get the payload, which
+	 * is then sent with chunked transfer coding. This allows to stream a
+	 * payload of unknown length without copying it. If set, payload and
+	 * payload_cb are not used.
+	 */
+	http_payload_chunk_cb_t payload_chunk_cb;
+
+	/** User supplied callback function to call with each part of the
+	 * response body, as soon as it is parsed. This can be NULL, in which
+	 * case the response callback is called with the data in the receive
+	 * buffer instead.
+	 */
+	http_body_cb_t body_cb;
 };
 
 /**
@@ -290,6 +352,91 @@ struct http_request {
 int http_client_req(int sock, struct http_request *req,
 		    int32_t timeout, void *user_data);
 
+/**
+ * @brief Do several HTTP requests on the same connection, without waiting
+ * for a response before sending the next request (HTTP pipelining). The
+ * responses are received in the order of the requests and the callbacks of
+ * each request are called for its response.
+ *
+ * The server must support persistent connections. The requests should not
+ * have large payloads, as they are all sent before the responses are read.
+ *
+ * @param sock Socket id of the connection.
+ * @param reqs Array of HTTP requests. The receive buffer of each request
+ *        must be large enough to hold the data of the following response
+ *        that was received along with the previous one.
+ * @param count Number of requests.
+ * @param timeout Max timeout to wait for each response, in milliseconds.
+ * @param user_data User specified data that is passed to the callbacks.
+ *
+ * @return <0 if error, >=0 number of complete responses received.
+ */
+int http_client_req_pipeline(int sock, struct http_request **reqs,
+			     size_t count, int32_t timeout, void *user_data);
+
+#if defined(CONFIG_HTTP_CLIENT_POOL)
+/**
+ * @typedef http_client_connect_cb_t
+ * @brief Callback used by the connection pool to open a new connection.
+ *
+ * @param host Hostname of the server
+ * @param port Port of the server, may be NULL
+ * @param user_data User specified data specified in http_client_pool_req()
+ *
+ * @return Socket id of the connected socket, <0 on error.
+ */
+typedef int (*http_client_connect_cb_t)(const char *host, const char *port,
+					void *user_data);
+
+/**
+ * Transport of the pooled connections. A connection is only reused by
+ * a request to the same host and port with the same transport.
+ */
+struct http_client_pool_transport {
+	/** Callback opening a new connection to the server. */
+	http_client_connect_cb_t connect_cb;
+
+	/** Secure tags of the TLS credentials the connection uses. */
+	const sec_tag_t *sec_tags;
+
+	/** Number of secure tags. */
+	size_t sec_tag_count;
+
+	/** The connection uses TLS. */
+	bool tls;
+};
+
+/**
+ * @brief Do a HTTP request on a pooled connection. A connection to the
+ * same host and port with the same transport kept open by a previous
+ * request is used if there is one, otherwise a new connection is opened
+ * with the connect callback of the transport. The connection is kept open
+ * after the response if the server allows it.
+ *
+ * If a kept connection was closed by the server in the meantime, the
+ * request is sent again on a new connection, but only if none of it was
+ * written yet, or if the method is idempotent, no headers or payload come
+ * from a callback and no response was received. The request callbacks are
+ * never called twice.
+ *
+ * @param req HTTP request information, the host and port fields select
+ *        the connection.
+ * @param transport Transport of the connection, for example TLS.
+ * @param timeout Max timeout to wait for the data, in milliseconds.
+ * @param user_data User specified data that is passed to the callbacks.
+ *
+ * @return <0 if error, >=0 amount of data sent to the server
+ */
+int http_client_pool_req(struct http_request *req,
+			 const struct http_client_pool_transport *transport,
+			 int32_t timeout, void *user_data);
+
+/**
+ * @brief Close all the idle connections of the pool.
+ */
+void http_client_pool_close_idle(void);
+#endif /* CONFIG_HTTP_CLIENT_POOL */
+
 #ifdef __cplusplus
 }
 #endif
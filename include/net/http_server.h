@@ -0,0 +1,213 @@
+/** @file
+ * @brief HTTP server API
+ *
+ * An API for applications to serve resources over HTTP/1.1
+ */
+
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_
+#define ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_
+
+/**
+ * @brief HTTP server API
+ * @defgroup http_server HTTP server API
+ * @ingroup networking
+ * @{
+ */
+
+#include <kernel.h>
+#include <net/net_ip.h>
+#include <net/http_parser.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if !defined(HTTP_CRLF)
+#define HTTP_CRLF "\r\n"
+#endif
+
+/** Type of a resource served by the HTTP server */
+enum http_resource_type {
+	/** Constant data, typically stored in flash */
+	HTTP_RESOURCE_TYPE_STATIC,
+
+	/** Content produced by the application for each request */
+	HTTP_RESOURCE_TYPE_DYNAMIC,
+
+	/** Websocket endpoint */
+	HTTP_RESOURCE_TYPE_WEBSOCKET,
+};
+
+/** Status of the request data passed to a dynamic resource */
+enum http_server_data_status {
+	/** More data of the request body follows */
+	HTTP_SERVER_DATA_MORE = 0,
+
+	/** The whole request was received, the response should be sent */
+	HTTP_SERVER_DATA_FINAL = 1,
+};
+
+/** Client connection of the HTTP server, internal to the server */
+struct http_server_client;
+
+/** HTTP request received by the server */
+struct http_server_request {
+	/** Request method */
+	enum http_method method;
+
+	/** Path of the requested resource */
+	const char *path;
+
+	/** Query string following the path, or NULL if there is none */
+	const char *query;
+};
+
+/**
+ * @typedef http_resource_dynamic_cb_t
+ * @brief Callback used to handle a request for a dynamic resource.
+ *
+ * The callback is called for each part of the request body as it is
+ * received, and once more with HTTP_SERVER_DATA_FINAL when the request is
+ * complete. It shall then send the response with http_server_respond().
+ *
+ * @param client Client connection, used to send the response
+ * @param req Request information
+ * @param status Whether more data follows
+ * @param data Part of the request body, valid only during the callback
+ * @param len Length of the data
+ * @param user_data User data of the resource
+ *
+ * @return 0 if ok, <0 if the server should respond with an error.
+ */
+typedef int (*http_resource_dynamic_cb_t)(struct http_server_client *client,
+					  const struct http_server_request *req,
+					  enum http_server_data_status status,
+					  const uint8_t *data, size_t len,
+					  void *user_data);
+
+/**
+ * @typedef http_resource_websocket_cb_t
+ * @brief Callback called after a Websocket upgrade was accepted.
+ *
+ * The connection is handed over to the application, which typically passes
+ * it to websocket_register() and closes the returned Websocket when done.
+ * The socket is in blocking mode. The callback runs in a server thread and
+ * should return quickly.
+ *
+ * @param sock Socket id of the connection to the client
+ * @param req Upgrade request information
+ * @param data Data received after the upgrade request, already Websocket
+ *        data, to be passed to websocket_register()
+ * @param len Length of the data
+ * @param user_data User data of the resource
+ *
+ * @return 0 if ok, <0 if the server should close the connection.
+ */
+typedef int (*http_resource_websocket_cb_t)(int sock,
+					    const struct http_server_request *req,
+					    const uint8_t *data, size_t len,
+					    void *user_data);
+
+/** Resource served by the HTTP server */
+struct http_resource {
+	/** Path of the resource, for example "/index.html" */
+	const char *path;
+
+	/** Type of the resource */
+	enum http_resource_type type;
+
+	union {
+		/** Static resource data */
+		struct {
+			/** Content of the resource, sent without copying */
+			const uint8_t *data;
+
+			/** Length of the content */
+			size_t len;
+
+			/** Value of the Content-Type header, can be NULL */
+			const char *content_type;
+
+			/** Value of the Content-Encoding header, for example
+			 * "gzip" for compressed content. The resource is only
+			 * sent to clients accepting that encoding. Can be NULL.
+			 */
+			const char *content_encoding;
+		} static_data;
+
+		/** Dynamic resource handler */
+		http_resource_dynamic_cb_t dynamic_cb;
+
+		/** Websocket resource handler */
+		http_resource_websocket_cb_t websocket_cb;
+	};
+
+	/** User data passed to the handlers */
+	void *user_data;
+};
+
+/** HTTP server configuration */
+struct http_server_config {
+	/** TCP port to listen on */
+	uint16_t port;
+
+	/** Resources served, looked up by their exact path */
+	const struct http_resource *resources;
+
+	/** Number of resources */
+	size_t num_resources;
+};
+
+/**
+ * @brief Start the HTTP server. The server listens on all the enabled IP
+ * families and serves the clients from CONFIG_HTTP_SERVER_NUM_THREADS
+ * threads.
+ *
+ * @param config Server configuration. It must stay valid until the server
+ *        is stopped.
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int http_server_start(const struct http_server_config *config);
+
+/**
+ * @brief Stop the HTTP server and close all the client connections.
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int http_server_stop(void);
+
+/**
+ * @brief Send the response to a request for a dynamic resource. Shall be
+ * called from the resource callback, at most once per request.
+ *
+ * @param client Client connection passed to the callback
+ * @param status HTTP status code
+ * @param content_type Value of the Content-Type header, can be NULL
+ * @param body Response body, sent without copying. A client reading slowly
+ *        gets it after the callback returned, so it must stay valid and
+ *        unchanged until the client has read it or disconnected.
+ * @param len Length of the body
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int http_server_respond(struct http_server_client *client, uint16_t status,
+			const char *content_type, const uint8_t *body,
+			size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_ */
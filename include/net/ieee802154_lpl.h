@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief IEEE 802.15.4 low-power listening public header
+ *
+ * Available when CONFIG_NET_L2_IEEE802154_RADIO_LPL is selected as the
+ * radio protocol. The duty cycling is transparent to the upper layers,
+ * this API only reports how long the radio was on.
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_IEEE802154_LPL_H_
+#define ZEPHYR_INCLUDE_NET_IEEE802154_LPL_H_
+
+#include <net/ieee802154.h>
+#include <net/net_if.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief IEEE 802.15.4 low-power listening
+ * @defgroup ieee802154_lpl IEEE 802.15.4 low-power listening
+ * @ingroup networking
+ * @{
+ */
+
+/** Radio activity of the duty cycling */
+struct ieee802154_lpl_stats {
+	/** Time the radio was on sending frames, in microseconds */
+	uint64_t tx_on_time;
+
+	/** Time the radio was on checking the channel and receiving
+	 * frames, in microseconds
+	 */
+	uint64_t rx_on_time;
+
+	/** Frames delivered: acknowledged, or repeated during a whole check
+	 *  interval for the broadcast ones
+	 */
+	uint32_t tx_delivered;
+
+	/** Frames that were not acknowledged */
+	uint32_t tx_failed;
+
+	/** Transmissions, each frame being repeated until acknowledged */
+	uint32_t tx_strobes;
+
+	/** Frames sent at the learnt wake-up phase of the receiver */
+	uint32_t tx_phase_locked;
+
+	/** Channel checks */
+	uint32_t rx_checks;
+
+	/** Channel checks which found the channel busy */
+	uint32_t rx_wakeups;
+
+	/** Frames received, without the duplicates */
+	uint32_t rx_frames;
+};
+
+/**
+ * @brief Get the radio activity since boot. The average radio on-time per
+ * delivered frame is tx_on_time / tx_delivered for the sender and
+ * rx_on_time / rx_frames for the receiver, the latter including the idle
+ * channel checks.
+ *
+ * @param iface IEEE 802.15.4 interface
+ * @param stats Filled with the radio activity
+ *
+ * @return 0 if ok, -EINVAL if the interface is not duty cycled.
+ */
+int ieee802154_lpl_get_stats(struct net_if *iface,
+			     struct ieee802154_lpl_stats *stats);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_NET_IEEE802154_LPL_H_ */
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief IEEE 802.15.4 TSCH (Time-Slotted Channel Hopping) public header
+ *
+ * Available when CONFIG_NET_L2_IEEE802154_RADIO_TSCH is selected as the
+ * radio protocol. TSCH runs on a single IEEE 802.15.4 interface.
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_IEEE802154_TSCH_H_
+#define ZEPHYR_INCLUDE_NET_IEEE802154_TSCH_H_
+
+#include <net/ieee802154.h>
+#include <net/net_if.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief IEEE 802.15.4 TSCH
+ * @defgroup ieee802154_tsch IEEE 802.15.4 TSCH
+ * @ingroup networking
+ * @{
+ */
+
+/** Maximum length of the channel hopping sequence */
+#define IEEE802154_TSCH_MAX_HOPPING_LEN 16
+
+/** Options of a cell, as encoded in the Link Options field */
+enum ieee802154_tsch_cell_options {
+	/** Frames are transmitted in the cell */
+	IEEE802154_TSCH_CELL_TX		= BIT(0),
+	/** Frames are received in the cell */
+	IEEE802154_TSCH_CELL_RX		= BIT(1),
+	/** Transmissions are contention based, with a backoff */
+	IEEE802154_TSCH_CELL_SHARED	= BIT(2),
+	/** Frames received in the cell keep the node synchronized */
+	IEEE802154_TSCH_CELL_TIMEKEEPING = BIT(3),
+};
+
+/** Cell of a slotframe */
+struct ieee802154_tsch_cell {
+	/** Extended address of the neighbor the cell is used with, in big
+	 * endian like the link address of the interface. NULL for a cell
+	 * shared with any neighbor, broadcast frames are only sent in those.
+	 */
+	const uint8_t *neighbor;
+
+	/** Timeslot of the cell in the slotframe */
+	uint16_t timeslot;
+
+	/** Channel offset, added to the ASN to pick the channel */
+	uint16_t channel_offset;
+
+	/** Options, see enum ieee802154_tsch_cell_options */
+	uint8_t options;
+};
+
+/**
+ * @brief Add a slotframe to the schedule. When cells of several
+ * slotframes fall in the same timeslot, the slotframe with the lowest
+ * handle has precedence.
+ *
+ * @param iface IEEE 802.15.4 interface
+ * @param handle Slotframe handle
+ * @param size Number of timeslots of the slotframe
+ *
+ * @return 0 if ok, -EEXIST if the handle is used, -ENOMEM if there is no
+ *         room for the slotframe, <0 if other error.
+ */
+int ieee802154_tsch_slotframe_add(struct net_if *iface, uint8_t handle,
+				  uint16_t size);
+
+/**
+ * @brief Remove a slotframe and all its cells from the schedule.
+ *
+ * @param iface IEEE 802.15.4 interface
+ * @param handle Slotframe handle
+ *
+ * @return 0 if ok, -ENOENT if there is no such slotframe.
+ */
+int ieee802154_tsch_slotframe_remove(struct net_if *iface, uint8_t handle);
+
+/**
+ * @brief Add a cell to a slotframe.
+ *
+ * @param iface IEEE 802.15.4 interface
+ * @param handle Slotframe handle
+ * @param cell Cell to add, copied
+ *
+ * @return 0 if ok, -ENOENT if there is no such slotframe, -EEXIST if the
+ *         slotframe has a cell at that timeslot and channel offset,
+ *         -ENOMEM if there is no room for the cell, <0 if other error.
+ */
+int ieee802154_tsch_cell_add(struct net_if *iface, uint8_t handle,
+			     const struct ieee802154_tsch_cell *cell);
+
+/**
+ * @brief Remove a cell from a slotframe. Frames waiting for a cell that
+ * is no longer in the schedule fail with -ENETUNREACH.
+ *
+ * @param iface IEEE 802.15.4 interface
+ * @param handle Slotframe handle
+ * @param timeslot Timeslot of the cell
+ * @param channel_offset Channel offset of the cell
+ *
+ * @return 0 if ok, -ENOENT if there is no such cell.
+ */
+int ieee802154_tsch_cell_remove(struct net_if *iface, uint8_t handle,
+				uint16_t timeslot, uint16_t channel_offset);
+
+/**
+ * @brief Add the minimal schedule of RFC 8180: a slotframe of handle 0
+ * with a single shared cell, at timeslot and channel offset 0, used for
+ * all the traffic and for the enhanced beacons.
+ *
+ * @param iface IEEE 802.15.4 interface
+ * @param size Number of timeslots of the slotframe
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int ieee802154_tsch_minimal_schedule(struct net_if *iface, uint16_t size);
+
+/**
+ * @brief Set the channel hopping sequence. All the nodes of the network
+ * shall use the same sequence, the default one is the 16 channels
+ * sequence of the 2.4 GHz O-QPSK PHY.
+ *
+ * @param iface IEEE 802.15.4 interface
+ * @param channels Channels of the sequence
+ * @param len Number of channels, at most IEEE802154_TSCH_MAX_HOPPING_LEN
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int ieee802154_tsch_set_hopping_sequence(struct net_if *iface,
+					 const uint16_t *channels,
+					 uint8_t len);
+
+/**
+ * @brief Start TSCH on the interface. A coordinator starts the network
+ * right away at ASN 0 and sends the enhanced beacons. Other nodes scan
+ * the channels of the hopping sequence for an enhanced beacon, join the
+ * network and add the advertised slotframes to their schedule.
+ *
+ * Frames can only be sent once the node is synchronized, they are then
+ * queued until a matching transmit cell and the send blocks meanwhile.
+ *
+ * @param iface IEEE 802.15.4 interface, which must be up
+ * @param coordinator Whether the node starts the network
+ *
+ * @return 0 if ok, -EALREADY if already started, <0 if other error.
+ */
+int ieee802154_tsch_start(struct net_if *iface, bool coordinator);
+
+/**
+ * @brief Stop TSCH and turn the radio off. The frames waiting for a cell
+ * fail with -ENETDOWN. The schedule is kept.
+ *
+ * @param iface IEEE 802.15.4 interface
+ *
+ * @return 0 if ok, -EALREADY if not started.
+ */
+int ieee802154_tsch_stop(struct net_if *iface);
+
+/**
+ * @brief Check whether the node is synchronized to the network.
+ *
+ * @param iface IEEE 802.15.4 interface
+ *
+ * @return true if synchronized, false otherwise.
+ */
+bool ieee802154_tsch_is_synchronized(struct net_if *iface);
+
+/**
+ * @brief Get the Absolute Slot Number of the current timeslot.
+ *
+ * @param iface IEEE 802.15.4 interface
+ *
+ * @return ASN, 0 if not synchronized.
+ */
+uint64_t ieee802154_tsch_asn(struct net_if *iface);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_NET_IEEE802154_TSCH_H_ */
@@ -81,6 +81,11 @@ struct lwm2m_ctx {
 	sys_slist_t pending_sends;
 	sys_slist_t observer;
 
+#if defined(CONFIG_COAP_COCOA)
+	/** Retransmission timeout estimator of the server */
+	struct coap_rto_estimator rto;
+#endif
+
 	/** A pointer to currently processed request, for internal LwM2M engine
 	 *  use. The underlying type is ``struct lwm2m_message``, but since it's
 	 *  declared in a private header and not exposed to the application,
@@ -741,6 +746,101 @@ int lwm2m_engine_get_float64(char *pathstr, float64_value_t *buf);
  */
 int lwm2m_engine_get_objlnk(char *pathstr, struct lwm2m_objlnk *buf);
 
+/**
+ * @brief Pre-resolved resource (instance) handle
+ *
+ * A handle is filled in once by lwm2m_engine_res_handle_get() and then used
+ * to set, get and notify the resource without parsing the path string and
+ * searching for the object instance and resource again. The handle is
+ * resolved again automatically if object or resource instances have been
+ * created or deleted in the meantime.
+ *
+ * The members are internal to the LwM2M engine.
+ */
+struct lwm2m_res_handle {
+	struct lwm2m_engine_obj_inst *obj_inst;
+	struct lwm2m_engine_obj_field *obj_field;
+	struct lwm2m_engine_res *res;
+	struct lwm2m_engine_res_inst *res_inst;
+	uint32_t generation;
+	uint16_t obj_id;
+	uint16_t obj_inst_id;
+	uint16_t res_id;
+	uint16_t res_inst_id;
+	uint8_t level;
+};
+
+/**
+ * @brief Resolve a resource (instance) path into a handle
+ *
+ * @param[in] pathstr LwM2M path string "obj/obj-inst/res(/res-inst)"
+ * @param[out] handle Handle to fill in
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_res_handle_get(char *pathstr,
+				struct lwm2m_res_handle *handle);
+
+/**
+ * @brief Set resource (instance) value through a handle
+ *
+ * Works like the lwm2m_engine_set_*() functions. The length must match the
+ * data type of the resource, for example 4 for a U32 resource and 1 for a
+ * boolean resource.
+ *
+ * @param[in] handle Resource handle
+ * @param[in] value Pointer to the new value
+ * @param[in] len Length of the value
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_set_by_handle(struct lwm2m_res_handle *handle,
+			       void *value, uint16_t len);
+
+/**
+ * @brief Get resource (instance) value through a handle
+ *
+ * Works like the lwm2m_engine_get_*() functions.
+ *
+ * @param[in] handle Resource handle
+ * @param[out] buf Buffer to copy data into
+ * @param[in] buflen Length of buffer
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_get_by_handle(struct lwm2m_res_handle *handle,
+			       void *buf, uint16_t buflen);
+
+/**
+ * @brief Notify the observers of a resource through a handle
+ *
+ * Use this when the resource data has been changed directly, without a
+ * call to lwm2m_engine_set_by_handle().
+ *
+ * @param[in] handle Resource handle
+ *
+ * @return Number of notified observers or negative in case of error.
+ */
+int lwm2m_engine_notify_by_handle(struct lwm2m_res_handle *handle);
+
+/**
+ * @brief Send resource values to the LwM2M server (LwM2M 1.1 Send operation)
+ *
+ * All resources in the path list are sent in a single SenML message to the
+ * "/dp" resource of the server. SenML CBOR is used when enabled, SenML JSON
+ * otherwise.
+ *
+ * @param[in] ctx LwM2M context
+ * @param[in] path_list List of resource paths, in the form "3/0/0"
+ * @param[in] path_list_size Number of paths, at most
+ *            CONFIG_LWM2M_COMPOSITE_PATH_LIST_SIZE
+ * @param[in] confirmation_request Send as a confirmable message
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_send(struct lwm2m_ctx *ctx, char const *path_list[],
+		      uint8_t path_list_size, bool confirmation_request);
+
 
 /**
  * @brief Set resource (instance) read callback
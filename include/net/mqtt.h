@@ -84,7 +84,8 @@ enum mqtt_evt_type {
 /** @brief MQTT version protocol level. */
 enum mqtt_version {
 	MQTT_VERSION_3_1_0 = 3, /**< Protocol level for 3.1.0. */
-	MQTT_VERSION_3_1_1 = 4  /**< Protocol level for 3.1.1. */
+	MQTT_VERSION_3_1_1 = 4, /**< Protocol level for 3.1.1. */
+	MQTT_VERSION_5_0 = 5    /**< Protocol level for 5.0. */
 };
 
 /** @brief MQTT Quality of Service types. */
@@ -201,8 +202,41 @@ struct mqtt_connack_param {
 
 	/** The appropriate non-zero Connect return code indicates if the Server
 	 *  is unable to process a connection request for some reason.
+	 *  With MQTT 5.0 this is the CONNACK reason code instead, which is
+	 *  also 0 on success.
 	 */
 	enum mqtt_conn_return_code return_code;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** MQTT 5.0 only. Maximum number of unacknowledged QoS 1 and QoS 2
+	 *  publications the Server accepts, 65535 if not limited.
+	 */
+	uint16_t receive_maximum;
+
+	/** MQTT 5.0 only. Highest topic alias the Server accepts, 0 if topic
+	 *  aliases are not supported.
+	 */
+	uint16_t topic_alias_maximum;
+
+	/** MQTT 5.0 only. Maximum packet size the Server accepts, 0 if not
+	 *  limited.
+	 */
+	uint32_t maximum_packet_size;
+
+	/** MQTT 5.0 only. Client identifier assigned by the Server when the
+	 *  Client connected with an empty one. Points to the receive buffer.
+	 */
+	struct mqtt_utf8 assigned_client_id;
+
+	/** MQTT 5.0 only. Maximum QoS supported by the Server. */
+	uint8_t maximum_qos;
+
+	/** MQTT 5.0 only. 1 if the Server supports retained messages. */
+	uint8_t retain_available : 1;
+
+	/** MQTT 5.0 only. 1 if the Server supports shared subscriptions. */
+	uint8_t shared_subscription_available : 1;
+#endif
 };
 
 /** @brief Parameters for MQTT publish acknowledgment (PUBACK). */
@@ -213,6 +247,13 @@ struct mqtt_puback_param {
 /** @brief Parameters for MQTT publish receive (PUBREC). */
 struct mqtt_pubrec_param {
 	uint16_t message_id;
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** MQTT 5.0 only. Reason code of a received PUBREC, 0 on success.
+	 *  From 0x80 up the message was refused and no PUBREL follows.
+	 */
+	uint8_t reason_code;
+#endif
 };
 
 /** @brief Parameters for MQTT publish release (PUBREL). */
@@ -441,6 +482,77 @@ struct mqtt_transport {
 #endif
 };
 
+#if defined(CONFIG_MQTT_PUBLISH_QUEUE)
+/** @brief First message id assigned to queued messages. The ids from this
+ *  one up are reserved for the publish queue.
+ */
+#define MQTT_PUBLISH_QUEUE_ID_MIN 0x8000U
+
+/** @brief State of a message in the outgoing publish queue. */
+enum mqtt_queue_state {
+	/** Entry is not used. */
+	MQTT_QUEUE_FREE,
+
+	/** Message waits to be sent. */
+	MQTT_QUEUE_PENDING,
+
+	/** Message was sent, waiting for PUBACK (QoS 1) or PUBREC (QoS 2). */
+	MQTT_QUEUE_AWAIT_ACK,
+
+	/** PUBREC received, PUBREL waits to be sent. */
+	MQTT_QUEUE_RELEASE,
+
+	/** PUBREL was sent, waiting for PUBCOMP. */
+	MQTT_QUEUE_AWAIT_COMP,
+};
+
+/** @brief Message in the outgoing publish queue. */
+struct mqtt_queue_entry {
+	/** Publish parameters. Topic and payload are referenced, not copied. */
+	struct mqtt_publish_param param;
+
+	/** State of the message, see @ref mqtt_queue_state. */
+	uint8_t state;
+
+	/** Whether the message is in the batch being written. */
+	bool sending;
+};
+
+/** @brief Outgoing publish queue, messages are sent in order. */
+struct mqtt_publish_queue {
+	/** Queued messages, a ring starting at @a head. */
+	struct mqtt_queue_entry entries[CONFIG_MQTT_PUBLISH_QUEUE_SIZE];
+
+	/** Index of the oldest message. */
+	uint8_t head;
+
+	/** Number of entries from the oldest to the newest message. */
+	uint8_t count;
+
+	/** Number of QoS 1 and QoS 2 messages not acknowledged yet. */
+	uint8_t inflight;
+
+	/** Last message id assigned to a queued message. */
+	uint16_t message_id;
+};
+#endif /* CONFIG_MQTT_PUBLISH_QUEUE */
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/** @brief Outgoing topic alias, the alias is the index in the table plus 1. */
+struct mqtt_topic_alias {
+	/** Copy of the aliased topic. */
+	uint8_t topic[CONFIG_MQTT_TOPIC_ALIAS_TOPIC_LEN];
+
+	/** Length of the topic, 0 if the alias is not used. */
+	uint16_t size;
+
+	/** Whether the alias is reserved by a message not written yet. The
+	 *  broker only knows the alias once it is written.
+	 */
+	bool pending;
+};
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 /** @brief MQTT internal state. */
 struct mqtt_internal {
 	/** Internal. Mutex to protect access to the client instance. */
@@ -459,6 +571,36 @@ struct mqtt_internal {
 
 	/** Internal. Remaining payload length to read. */
 	uint32_t remaining_payload;
+
+#if defined(CONFIG_MQTT_PUBLISH_QUEUE)
+	/** Internal. Outgoing publish queue. */
+	struct mqtt_publish_queue queue;
+#endif
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	/** Internal. Topic aliases used on the connection. */
+	struct mqtt_topic_alias topic_alias[CONFIG_MQTT_TOPIC_ALIAS_MAX];
+
+	/** Internal. Maximum packet size accepted by the server, 0 if not
+	 *  limited.
+	 */
+	uint32_t maximum_packet_size;
+
+	/** Internal. Receive Maximum of the server. */
+	uint16_t receive_maximum;
+
+	/** Internal. Number of QoS 1 and QoS 2 messages not acknowledged. */
+	uint16_t inflight;
+
+	/** Internal. Highest topic alias accepted by the server. */
+	uint16_t topic_alias_maximum;
+
+	/** Internal. Maximum QoS supported by the server. */
+	uint8_t maximum_qos;
+
+	/** Internal. Whether the server supports shared subscriptions. */
+	bool shared_subscription;
+#endif
 };
 
 /**
@@ -578,7 +720,9 @@ int mqtt_client_set_proxy(struct mqtt_client *client,
  * @return 0 or a negative error code (errno.h) indicating reason of failure.
  *
  * @note Default protocol revision used for connection request is 3.1.1. Please
- *       set client.protocol_version = MQTT_VERSION_3_1_0 to use protocol 3.1.0.
+ *       set client.protocol_version = MQTT_VERSION_3_1_0 to use protocol 3.1.0,
+ *       or MQTT_VERSION_5_0 to use protocol 5.0 when
+ *       @kconfig{CONFIG_MQTT_VERSION_5_0} is enabled.
  * @note
  *       Please modify @kconfig{CONFIG_MQTT_KEEPALIVE} time to override default
  *       of 1 minute.
@@ -593,11 +737,63 @@ int mqtt_connect(struct mqtt_client *client);
  * @param[in] param Parameters to be used for the publish message.
  *                  Shall not be NULL.
  *
+ * @note With MQTT 5.0 the topic is replaced by a topic alias when the broker
+ *       allows it, and QoS 1 and QoS 2 messages are refused with -EBUSY
+ *       while the Receive Maximum of the broker is reached.
+ *
  * @return 0 or a negative error code (errno.h) indicating reason of failure.
  */
 int mqtt_publish(struct mqtt_client *client,
 		 const struct mqtt_publish_param *param);
 
+#if defined(CONFIG_MQTT_PUBLISH_QUEUE)
+/**
+ * @brief API to queue a message for publishing.
+ *
+ * The message is only added to the outgoing queue, it is sent by
+ * @ref mqtt_publish_flush. The library assigns the message id and, for QoS
+ * 1 and QoS 2, handles the acknowledgment: PUBREL is sent on PUBREC and
+ * unacknowledged messages are sent again after reconnecting. The
+ * @ref MQTT_EVT_PUBACK and @ref MQTT_EVT_PUBCOMP events are still notified
+ * to the application, which shall not answer PUBREC itself for queued
+ * messages.
+ *
+ * The message ids from @ref MQTT_PUBLISH_QUEUE_ID_MIN up are reserved for
+ * queued messages. @ref mqtt_publish, @ref mqtt_subscribe,
+ * @ref mqtt_unsubscribe and @ref mqtt_publish_qos2_release refuse them with
+ * -EINVAL.
+ *
+ * @note Topic and payload are not copied. They shall stay valid until the
+ *       message is acknowledged, or for QoS 0 until it was sent.
+ *
+ * @param[in] client Client instance for which the procedure is requested.
+ *                   Shall not be NULL.
+ * @param[in] param Parameters to be used for the publish message. The
+ *                  message id and the duplicate flag are ignored.
+ *                  Shall not be NULL.
+ *
+ * @return Message id assigned to the message (0 for QoS 0) or a negative
+ *         error code (errno.h) indicating reason of failure.
+ */
+int mqtt_publish_enqueue(struct mqtt_client *client,
+			 const struct mqtt_publish_param *param);
+
+/**
+ * @brief API to send queued messages.
+ *
+ * Sends as many queued messages as the in-flight window and the transmit
+ * buffer allow, several messages in a single transport write. Shall be
+ * called periodically, for example after @ref mqtt_input.
+ *
+ * @param[in] client Client instance for which the procedure is requested.
+ *                   Shall not be NULL.
+ *
+ * @return Number of packets sent or a negative error code (errno.h)
+ *         indicating reason of failure.
+ */
+int mqtt_publish_flush(struct mqtt_client *client);
+#endif /* CONFIG_MQTT_PUBLISH_QUEUE */
+
 /**
  * @brief API used by client to send acknowledgment on receiving QoS1 publish
  *        message. Should be called on reception of @ref MQTT_EVT_PUBLISH with
@@ -660,6 +856,10 @@ int mqtt_publish_qos2_complete(struct mqtt_client *client,
  *                   is requested. Shall not be NULL.
  * @param[in] param Subscription parameters. Shall not be NULL.
  *
+ * @note With MQTT 5.0, shared subscriptions use a topic filter of the form
+ *       $share/{ShareName}/{filter}. They are refused with -ENOTSUP when the
+ *       broker does not support them.
+ *
  * @return 0 or a negative error code (errno.h) indicating reason of failure.
  */
 int mqtt_subscribe(struct mqtt_client *client,
@@ -252,6 +252,11 @@ __net_socket struct net_context {
 	net_pkt_get_pool_func_t data_pool;
 #endif /* CONFIG_NET_CONTEXT_NET_PKT_POOL */
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	/** Usage of the shared packet pools by this context */
+	struct net_pkt_usage pkt_usage;
+#endif /* CONFIG_NET_PKT_QUOTA */
+
 #if defined(CONFIG_NET_TCP2)
 	/** TCP connection information */
 	void *tcp;
@@ -965,6 +970,35 @@ int net_context_sendto(struct net_context *context,
 		       k_timeout_t timeout,
 		       void *user_data);
 
+/**
+ * @brief Send a chain of network buffers without copying the payload.
+ *
+ * @details This function can be used to send data that the caller has
+ * already placed into network buffers. Only the protocol headers are
+ * allocated, the fragments are linked to the outgoing packet as is.
+ * On success the ownership of the caller's reference to @p frags is
+ * transferred to the network stack. On failure the caller still owns
+ * the fragments and may retry or release them with net_buf_unref().
+ * The fragments must not be modified after a successful call.
+ *
+ * @param context The network context to use.
+ * @param frags Network buffer chain holding the payload.
+ * @param dst_addr Destination address, NULL for connected contexts.
+ * @param addrlen Length of the address.
+ * @param cb Caller-supplied callback function.
+ * @param timeout Currently this value is not used.
+ * @param user_data Caller-supplied user data.
+ *
+ * @return numbers of bytes sent on success, a negative errno otherwise
+ */
+int net_context_send_buf(struct net_context *context,
+			 struct net_buf *frags,
+			 const struct sockaddr *dst_addr,
+			 socklen_t addrlen,
+			 net_context_send_cb_t cb,
+			 k_timeout_t timeout,
+			 void *user_data);
+
 /**
  * @brief Send data in iovec to a peer specified in msghdr struct.
  *
@@ -117,6 +117,23 @@ enum net_verdict {
  */
 int net_recv_data(struct net_if *iface, struct net_pkt *pkt);
 
+/**
+ * @brief Called by network device driver when several network packets have
+ * been received in one go, for example from a DMA descriptor ring. The packets
+ * are queued to the RX traffic class threads with one operation per traffic
+ * class instead of one per packet.
+ *
+ * @param iface Network interface where the packets were received.
+ * @param pkts Array of received network packets.
+ * @param count Number of packets in the array.
+ *
+ * @return Number of packets passed up in the network stack, <0 if error.
+ * Packets that could not be passed up are released by this function unless
+ * an error is returned, in which case the caller still owns all of them.
+ */
+int net_recv_data_batch(struct net_if *iface, struct net_pkt **pkts,
+			size_t count);
+
 /**
  * @brief Send data to network.
  *
@@ -151,6 +168,18 @@ int net_send_data(struct net_pkt *pkt);
 
 /* @endcond */
 
+/**
+ * @brief Usage of the shared RX or TX packet pools by a network interface,
+ * a network context or a traffic class.
+ */
+struct net_pkt_usage {
+	/** Number of packets in use */
+	atomic_t pkts;
+
+	/** Number of data buffers in use */
+	atomic_t bufs;
+};
+
 /**
  * @}
  */
@@ -193,6 +193,13 @@ enum net_if_flag {
 	/** Interface supports IPv6 */
 	NET_IF_IPV6,
 
+	/** Coalesce the TCP segments received on this interface before
+	 * passing them to the TCP layer, see CONFIG_NET_GRO. Set by the
+	 * Ethernet L2 with CONFIG_NET_GRO_ETHERNET, other drivers set it
+	 * with net_if_flag_set() when initializing the interface.
+	 */
+	NET_IF_GRO,
+
 /** @cond INTERNAL_HIDDEN */
 	/* Total number of flags - must be at the end of the enum */
 	NET_IF_NUM_FLAGS
@@ -477,6 +484,14 @@ struct net_if {
 	/** Network interface instance configuration */
 	struct net_if_config config;
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	/** Usage of the RX packet pools by this network interface */
+	struct net_pkt_usage rx_pkt_usage;
+
+	/** Usage of the TX packet pools by this network interface */
+	struct net_pkt_usage tx_pkt_usage;
+#endif /* CONFIG_NET_PKT_QUOTA */
+
 #if defined(CONFIG_NET_POWER_MANAGEMENT)
 	/** Keep track of packets pending in traffic queues. This is
 	 * needed to avoid putting network device driver to sleep if
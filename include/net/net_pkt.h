@@ -90,6 +90,16 @@ struct net_pkt {
 	struct net_if *orig_iface; /* Original network interface */
 #endif
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+	/* Pool usage counters charged for this packet: the interface, the
+	 * context, the traffic class and the pool total.
+	 */
+	struct net_pkt_usage *usage[4];
+
+	/* Number of data buffers charged */
+	uint16_t usage_bufs;
+#endif
+
 #if defined(CONFIG_NET_PKT_TIMESTAMP)
 	/** Timestamp if available. */
 	struct net_ptp_time timestamp;
@@ -116,6 +126,11 @@ struct net_pkt {
 	};
 #endif /* CONFIG_NET_PKT_RXTIME_STATS || CONFIG_NET_PKT_TXTIME_STATS */
 
+#if defined(CONFIG_NET_PKT_LATENCY_STATS)
+	/** Time in cycles when the previous latency stage ended */
+	uint32_t latency_tick;
+#endif
+
 #if defined(CONFIG_NET_PKT_TXTIME)
 	/** Network packet TX time in the future (in nanoseconds) */
 	uint64_t txtime;
@@ -184,6 +199,10 @@ struct net_pkt {
 	uint8_t captured : 1; /* Set to 1 if this packet is already being
 			       * captured
 			       */
+	uint8_t reassembled : 1; /* Set to 1 if this packet was reassembled
+				  * from IP fragments, it has no link layer
+				  * header then.
+				  */
 
 	union {
 		/* IPv6 hop limit or IPv4 ttl for this network packet.
@@ -341,6 +360,17 @@ static inline void net_pkt_set_captured(struct net_pkt *pkt, bool is_captured)
 	pkt->captured = is_captured;
 }
 
+static inline bool net_pkt_is_reassembled(struct net_pkt *pkt)
+{
+	return !!(pkt->reassembled);
+}
+
+static inline void net_pkt_set_reassembled(struct net_pkt *pkt,
+					   bool is_reassembled)
+{
+	pkt->reassembled = is_reassembled;
+}
+
 static inline uint8_t net_pkt_ip_hdr_len(struct net_pkt *pkt)
 {
 	return pkt->ip_hdr_len;
@@ -858,6 +888,33 @@ static inline void net_pkt_set_txtime(struct net_pkt *pkt, uint64_t txtime)
 }
 #endif /* CONFIG_NET_PKT_TXTIME */
 
+#if defined(CONFIG_NET_PKT_LATENCY_STATS)
+static inline uint32_t net_pkt_latency_tick(struct net_pkt *pkt)
+{
+	return pkt->latency_tick;
+}
+
+static inline void net_pkt_set_latency_tick(struct net_pkt *pkt,
+					    uint32_t tick)
+{
+	pkt->latency_tick = tick;
+}
+#else
+static inline uint32_t net_pkt_latency_tick(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static inline void net_pkt_set_latency_tick(struct net_pkt *pkt,
+					    uint32_t tick)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(tick);
+}
+#endif /* CONFIG_NET_PKT_LATENCY_STATS */
+
 #if defined(CONFIG_NET_PKT_TXTIME_STATS_DETAIL) || \
 	defined(CONFIG_NET_PKT_RXTIME_STATS_DETAIL)
 static inline uint32_t *net_pkt_stats_tick(struct net_pkt *pkt)
@@ -1446,6 +1503,28 @@ void net_pkt_get_info(struct k_mem_slab **rx,
 		      struct net_buf_pool **rx_data,
 		      struct net_buf_pool **tx_data);
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+/**
+ * @brief Get the usage of the predefined RX or TX pools.
+ *
+ * @param is_rx True for the RX pools, false for the TX pools.
+ *
+ * @return Number of packets and data buffers in use.
+ */
+const struct net_pkt_usage *net_pkt_usage_get(bool is_rx);
+
+/**
+ * @brief Get the usage of the predefined RX or TX pools by a traffic class.
+ *
+ * @param is_rx True for the RX pools, false for the TX pools.
+ * @param tc Traffic class.
+ *
+ * @return Number of packets and data buffers in use, NULL if the traffic
+ * class does not exist.
+ */
+const struct net_pkt_usage *net_pkt_tc_usage_get(bool is_rx, uint8_t tc);
+#endif /* CONFIG_NET_PKT_QUOTA */
+
 /** @cond INTERNAL_HIDDEN */
 
 #if defined(CONFIG_NET_DEBUG_NET_PKT_ALLOC)
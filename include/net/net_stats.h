@@ -274,6 +274,72 @@ struct net_stats_tc {
 	} recv[NET_TC_RX_STATS_COUNT];
 };
 
+/**
+ * @brief Packet processing stages measured by latency statistics.
+ *
+ * Each stage covers the time from the end of the previous stage of the
+ * same direction. The first RX stage starts when the driver allocates the
+ * packet and the first TX stage starts when the packet is allocated for
+ * sending.
+ */
+enum net_stats_latency_stage {
+	/** Driver fills the packet and gives it to the stack */
+	NET_STATS_LATENCY_RX_DRIVER,
+	/** Packet waits in the RX queue */
+	NET_STATS_LATENCY_RX_QUEUE,
+	/** L2 processing */
+	NET_STATS_LATENCY_RX_L2,
+	/** IP processing until the UDP or TCP connection lookup */
+	NET_STATS_LATENCY_RX_IP,
+	/** Transport processing until the data is queued to the socket */
+	NET_STATS_LATENCY_RX_TRANSPORT,
+	/** Data waits in the socket until the application reads it */
+	NET_STATS_LATENCY_RX_SOCKET,
+	/** Application, socket and transport until the packet is sent to IP */
+	NET_STATS_LATENCY_TX_TRANSPORT,
+	/** IP processing and link address resolution */
+	NET_STATS_LATENCY_TX_IP,
+	/** Packet waits in the TX queue */
+	NET_STATS_LATENCY_TX_QUEUE,
+	/** L2 processing until the driver is called */
+	NET_STATS_LATENCY_TX_L2,
+	/** Driver sends the packet */
+	NET_STATS_LATENCY_TX_DRIVER,
+
+	NET_STATS_LATENCY_STAGE_COUNT
+};
+
+#if defined(CONFIG_NET_PKT_LATENCY_STATS)
+/**
+ * @brief Latency histogram of one packet processing stage
+ *
+ * The first bucket counts latencies below
+ * CONFIG_NET_PKT_LATENCY_STATS_BUCKET_USEC and each following bucket is
+ * twice as wide as the previous one. The last bucket counts all the
+ * latencies that do not fit in the other buckets.
+ */
+struct net_stats_latency {
+	/** Number of packets in each latency bucket */
+	net_stats_t bucket[CONFIG_NET_PKT_LATENCY_STATS_BUCKETS];
+
+	/** Sum of latencies in hardware cycles */
+	uint64_t sum;
+
+	/** Largest latency in hardware cycles */
+	uint32_t max;
+};
+#endif /* CONFIG_NET_PKT_LATENCY_STATS */
+
+/**
+ * @brief Information of a latency event
+ */
+struct net_stats_latency_event {
+	/** Latency of the packet in microseconds */
+	uint32_t usec;
+
+	/** Stage where the latency was seen, see enum net_stats_latency_stage */
+	uint8_t stage;
+};
 
 /**
  * @brief Power management statistics
@@ -366,6 +432,11 @@ struct net_stats {
 	struct net_stats_rx_time rx_time_detail[NET_PKT_DETAIL_STATS_COUNT];
 #endif
 
+#if defined(CONFIG_NET_PKT_LATENCY_STATS)
+	/** Network packet latency of each processing stage */
+	struct net_stats_latency latency[NET_STATS_LATENCY_STAGE_COUNT];
+#endif
+
 #if defined(CONFIG_NET_STATISTICS_POWER_MANAGEMENT)
 	struct net_stats_pm pm;
 #endif
@@ -472,13 +543,26 @@ struct net_stats_ppp {
 	net_stats_t chkerr;
 };
 
-#if defined(CONFIG_NET_STATISTICS_USER_API)
 /* Management part definitions */
 
 #define _NET_STATS_LAYER	NET_MGMT_LAYER_L3
 #define _NET_STATS_CODE		0x101
 #define _NET_STATS_BASE		(NET_MGMT_LAYER(_NET_STATS_LAYER) |	\
 				 NET_MGMT_LAYER_CODE(_NET_STATS_CODE))
+#define _NET_STATS_EVENT	(_NET_STATS_BASE | NET_MGMT_EVENT_BIT)
+
+enum net_event_stats_cmd {
+	NET_EVENT_STATS_CMD_LATENCY = 1,
+};
+
+/** Event emitted when a packet has been in one processing stage for
+ * longer than CONFIG_NET_PKT_LATENCY_STATS_EVENT_USEC. The event info
+ * is struct net_stats_latency_event.
+ */
+#define NET_EVENT_STATS_LATENCY					\
+	(_NET_STATS_EVENT | NET_EVENT_STATS_CMD_LATENCY)
+
+#if defined(CONFIG_NET_STATISTICS_USER_API)
 
 enum net_request_stats_cmd {
 	NET_REQUEST_STATS_CMD_GET_ALL = 1,
@@ -493,7 +577,8 @@ enum net_request_stats_cmd {
 	NET_REQUEST_STATS_CMD_GET_TCP,
 	NET_REQUEST_STATS_CMD_GET_ETHERNET,
 	NET_REQUEST_STATS_CMD_GET_PPP,
-	NET_REQUEST_STATS_CMD_GET_PM
+	NET_REQUEST_STATS_CMD_GET_PM,
+	NET_REQUEST_STATS_CMD_GET_LATENCY,
 };
 
 #define NET_REQUEST_STATS_GET_ALL				\
@@ -572,6 +657,16 @@ NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_ETHERNET);
 NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PPP);
 #endif /* CONFIG_NET_STATISTICS_PPP */
 
+#if defined(CONFIG_NET_PKT_LATENCY_STATS)
+/** Request the latency statistics. The data is an array of
+ * NET_STATS_LATENCY_STAGE_COUNT struct net_stats_latency entries.
+ */
+#define NET_REQUEST_STATS_GET_LATENCY				\
+	(_NET_STATS_BASE | NET_REQUEST_STATS_CMD_GET_LATENCY)
+
+NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_LATENCY);
+#endif /* CONFIG_NET_PKT_LATENCY_STATS */
+
 #endif /* CONFIG_NET_STATISTICS_USER_API */
 
 #if defined(CONFIG_NET_STATISTICS_POWER_MANAGEMENT)
@@ -348,10 +348,22 @@ struct lcp_options {
 
 	/** Which authentication protocol was negotiated (0 means none) */
 	uint16_t auth_proto;
+
+	/** Address and Control fields can be left out of the frames
+	 * sent to the side that requested this option.
+	 */
+	bool acfc;
+
+	/** Protocol field can be compressed to one byte in the frames
+	 * sent to the side that requested this option.
+	 */
+	bool pfc;
 };
 
-#if defined(CONFIG_NET_L2_PPP_OPTION_MRU)
-#define LCP_NUM_MY_OPTIONS	1
+#if defined(CONFIG_NET_L2_PPP_OPTION_MRU) || \
+	defined(CONFIG_NET_L2_PPP_OPTION_COMPRESSION)
+#define LCP_NUM_MY_OPTIONS	(IS_ENABLED(CONFIG_NET_L2_PPP_OPTION_MRU) + \
+				 2 * IS_ENABLED(CONFIG_NET_L2_PPP_OPTION_COMPRESSION))
 #endif
 
 struct ipcp_options {
@@ -404,7 +416,7 @@ struct ppp_context {
 
 		/** Magic-Number value */
 		uint32_t magic;
-#if defined(CONFIG_NET_L2_PPP_OPTION_MRU)
+#if defined(LCP_NUM_MY_OPTIONS)
 		struct ppp_my_option_data my_options_data[LCP_NUM_MY_OPTIONS];
 #endif
 	} lcp;
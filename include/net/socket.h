@@ -138,6 +138,39 @@ struct zsock_pollfd {
  */
 #define TLS_DTLS_HANDSHAKE_TIMEOUT_MIN 8
 #define TLS_DTLS_HANDSHAKE_TIMEOUT_MAX 9
+/** Socket option to enable TLS/DTLS client session caching. It accepts and
+ *  returns an integer, TLS_SESSION_CACHE_DISABLED (default) or
+ *  TLS_SESSION_CACHE_ENABLED. When enabled, the session negotiated with
+ *  a server is stored after the handshake, and the next connection to the
+ *  same server address, with the same hostname and TLS_SEC_TAG_LIST, tries
+ *  to resume it with an abbreviated handshake.
+ */
+#define TLS_SESSION_CACHE 10
+/** Write-only socket option to remove all the sessions from the client
+ *  session cache. The option value is ignored.
+ */
+#define TLS_SESSION_CACHE_PURGE 11
+/** Socket option to control the DTLS Connection ID extension, which lets
+ *  the DTLS connection survive a change of the peer address (e.g. NAT
+ *  rebinding) without a new handshake. It accepts and returns an integer:
+ *    - TLS_DTLS_CID_DISABLED - the extension is not used (default),
+ *    - TLS_DTLS_CID_SUPPORTED - use the Connection ID of the peer, but do
+ *      not ask the peer to use one,
+ *    - TLS_DTLS_CID_ENABLED - also ask the peer to use a Connection ID
+ *      in the records it sends.
+ *  The option must be set before the handshake.
+ */
+#define TLS_DTLS_CID 12
+/** Read-only socket option to check if a Connection ID was negotiated on
+ *  the DTLS connection. It returns an integer, 1 if the records carry
+ *  a Connection ID, 0 otherwise.
+ */
+#define TLS_DTLS_CID_STATUS 13
+/** Read-only socket option to check if the last handshake resumed a session
+ *  from the client session cache. It returns an integer, 1 if the server
+ *  accepted the cached session, 0 if a full handshake was done.
+ */
+#define TLS_SESSION_RESUMED 14
 
 /** @} */
 
@@ -150,6 +183,15 @@ struct zsock_pollfd {
 #define TLS_DTLS_ROLE_CLIENT 0 /**< Client role in a DTLS session. */
 #define TLS_DTLS_ROLE_SERVER 1 /**< Server role in a DTLS session. */
 
+/* Valid values for TLS_SESSION_CACHE option */
+#define TLS_SESSION_CACHE_DISABLED 0 /**< No TLS session caching. */
+#define TLS_SESSION_CACHE_ENABLED 1 /**< TLS session caching enabled. */
+
+/* Valid values for TLS_DTLS_CID option */
+#define TLS_DTLS_CID_DISABLED 0  /**< No DTLS Connection ID. */
+#define TLS_DTLS_CID_SUPPORTED 1 /**< Use the Connection ID of the peer. */
+#define TLS_DTLS_CID_ENABLED 2   /**< Use Connection IDs in both ways. */
+
 struct zsock_addrinfo {
 	struct zsock_addrinfo *ai_next;
 	int ai_flags;
@@ -404,6 +446,53 @@ static inline ssize_t zsock_recv(int sock, void *buf, size_t max_len,
 	return zsock_recvfrom(sock, buf, max_len, flags, NULL, NULL);
 }
 
+struct net_buf;
+
+/**
+ * @brief Receive data as a chain of network buffers without copying
+ *
+ * @details
+ * Returns the next received datagram, or the next received chunk of
+ * a stream, as the network buffers it was received into. The caller
+ * owns the returned buffer chain and must release it with net_buf_unref()
+ * once the data has been consumed. ZSOCK_MSG_PEEK and ZSOCK_MSG_WAITALL
+ * flags are not supported. Only native TCP and UDP sockets support this
+ * function, and it cannot be called from user mode threads.
+ * Available if :kconfig:`CONFIG_NET_SOCKETS_ZEROCOPY` is enabled.
+ *
+ * @param sock Socket to receive from.
+ * @param frags Set to the received buffer chain, or NULL if no data.
+ * @param flags ZSOCK_MSG_DONTWAIT or 0.
+ * @param src_addr Source address of a datagram, may be NULL.
+ * @param addrlen Length of the source address, may be NULL.
+ *
+ * @return Number of bytes in the buffer chain, 0 on end of stream,
+ *         -1 on error with errno set.
+ */
+ssize_t zsock_recv_buf(int sock, struct net_buf **frags, int flags,
+		       struct sockaddr *src_addr, socklen_t *addrlen);
+
+/**
+ * @brief Send a chain of network buffers without copying
+ *
+ * @details
+ * The buffer chain is linked to the outgoing packet as is. On success the
+ * network stack takes over the caller's reference to @p frags, on failure
+ * the caller still owns it. Only native TCP and UDP sockets support this
+ * function, and it cannot be called from user mode threads.
+ * Available if :kconfig:`CONFIG_NET_SOCKETS_ZEROCOPY` is enabled.
+ *
+ * @param sock Socket to send to.
+ * @param frags Buffer chain holding the payload.
+ * @param flags ZSOCK_MSG_DONTWAIT or 0.
+ * @param dest_addr Destination address, NULL for connected sockets.
+ * @param addrlen Length of the destination address.
+ *
+ * @return Number of bytes sent, -1 on error with errno set.
+ */
+ssize_t zsock_send_buf(int sock, struct net_buf *frags, int flags,
+		       const struct sockaddr *dest_addr, socklen_t addrlen);
+
 /**
  * @brief Control blocking/non-blocking mode of a socket
  *
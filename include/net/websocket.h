@@ -126,6 +126,28 @@ struct websocket_request {
 int websocket_connect(int http_sock, struct websocket_request *req,
 		      int32_t timeout, void *user_data);
 
+/**
+ * @brief Use a socket, on which a HTTP server accepted a Websocket upgrade,
+ * as the server end of a Websocket connection. The returned value is a new
+ * socket descriptor that can be used to send / receive data using the BSD
+ * socket API.
+ *
+ * @param http_sock Socket id of the connection to the client. The socket is
+ *        closed when the returned Websocket is closed.
+ * @param tmp_buf User supplied buffer where Websocket protocol headers are
+ *        stored temporarily.
+ * @param tmp_buf_len Length of the temporary buffer.
+ * @param data Websocket data already read from http_sock together with the
+ *        upgrade request. It is received before the data read from the
+ *        socket. Can be NULL if len is 0.
+ * @param len Length of the data, at most tmp_buf_len.
+ * @param user_data User specified data.
+ *
+ * @return Websocket id to be used when sending/receiving Websocket data.
+ */
+int websocket_register(int http_sock, uint8_t *tmp_buf, size_t tmp_buf_len,
+		       const uint8_t *data, size_t len, void *user_data);
+
 /**
  * @brief Send websocket msg to peer.
  *
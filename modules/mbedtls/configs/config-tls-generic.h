@@ -300,6 +300,15 @@
 #define MBEDTLS_SSL_ALPN
 #endif
 
+#if defined(CONFIG_MBEDTLS_SSL_SESSION_TICKETS)
+#define MBEDTLS_SSL_SESSION_TICKETS
+#define MBEDTLS_SSL_TICKET_C
+#endif
+
+#if defined(CONFIG_MBEDTLS_SSL_DTLS_CONNECTION_ID)
+#define MBEDTLS_SSL_DTLS_CONNECTION_ID
+#endif
+
 #if defined(CONFIG_MBEDTLS_CIPHER)
 #define MBEDTLS_CIPHER_C
 #endif
@@ -57,6 +57,10 @@ static struct coap_resource *resource_to_notify;
 
 static struct k_work_delayable retransmit_work;
 
+#if defined(CONFIG_COAP_OBSERVE_COALESCE)
+static struct k_work_delayable deferred_work;
+#endif
+
 #if defined(CONFIG_NET_IPV6)
 static bool join_coap_multicast_group(void)
 {
@@ -969,12 +973,33 @@ static void retransmit_request(struct k_work *work)
 	k_work_reschedule(&retransmit_work, K_MSEC(pending->timeout));
 }
 
+#if defined(CONFIG_COAP_OBSERVE_COALESCE)
+static void notify_deferred(struct k_work *work)
+{
+	int32_t next;
+
+	if (!resource_to_notify) {
+		return;
+	}
+
+	next = coap_resource_notify_deferred(resource_to_notify);
+	if (next != SYS_FOREVER_MS) {
+		k_work_reschedule(&deferred_work, K_MSEC(next));
+	}
+}
+#endif
+
 static void update_counter(struct k_work *work)
 {
 	obs_counter++;
 
 	if (resource_to_notify) {
 		coap_resource_notify(resource_to_notify);
+
+#if defined(CONFIG_COAP_OBSERVE_COALESCE)
+		/* Observers notified too recently get the new value later */
+		notify_deferred(NULL);
+#endif
 	}
 
 	k_work_reschedule(&observer_work, K_SECONDS(5));
@@ -1418,6 +1443,9 @@ void main(void)
 
 	k_work_init_delayable(&retransmit_work, retransmit_request);
 	k_work_init_delayable(&observer_work, update_counter);
+#if defined(CONFIG_COAP_OBSERVE_COALESCE)
+	k_work_init_delayable(&deferred_work, notify_deferred);
+#endif
 
 	while (1) {
 		r = process_client_request();
@@ -217,9 +217,11 @@ static const struct json_obj_descr json_dep_fbk_descr[] = {
 			      json_status_descr),
 };
 
-static bool start_http_client(void)
+static int hawkbit_connect(const char *host, const char *port,
+			   void *user_data)
 {
 	int ret = -1;
+	int sock;
 	struct addrinfo *addr;
 	struct addrinfo hints;
 	int resolve_attempts = 10;
@@ -230,6 +232,8 @@ static bool start_http_client(void)
 	int protocol = IPPROTO_TCP;
 #endif
 
+	ARG_UNUSED(user_data);
+
 	if (IS_ENABLED(CONFIG_NET_IPV6)) {
 		hints.ai_family = AF_INET6;
 	} else if (IS_ENABLED(CONFIG_NET_IPV4)) {
@@ -239,8 +243,7 @@ static bool start_http_client(void)
 	hints.ai_socktype = SOCK_STREAM;
 
 	while (resolve_attempts--) {
-		ret = getaddrinfo(CONFIG_HAWKBIT_SERVER, CONFIG_HAWKBIT_PORT,
-				  &hints, &addr);
+		ret = getaddrinfo(host, port, &hints, &addr);
 		if (ret == 0) {
 			break;
 		}
@@ -250,12 +253,13 @@ static bool start_http_client(void)
 
 	if (ret != 0) {
 		LOG_ERR("Could not resolve dns");
-		return false;
+		return -EHOSTUNREACH;
 	}
 
-	hb_context.sock = socket(addr->ai_family, SOCK_STREAM, protocol);
-	if (hb_context.sock < 0) {
+	sock = socket(addr->ai_family, SOCK_STREAM, protocol);
+	if (sock < 0) {
 		LOG_ERR("Failed to create TCP socket");
+		ret = -errno;
 		goto err;
 	}
 
@@ -264,39 +268,100 @@ static bool start_http_client(void)
 		CA_CERTIFICATE_TAG,
 	};
 
-	if (setsockopt(hb_context.sock, SOL_TLS, TLS_SEC_TAG_LIST, sec_tag_opt,
+	if (setsockopt(sock, SOL_TLS, TLS_SEC_TAG_LIST, sec_tag_opt,
 		       sizeof(sec_tag_opt)) < 0) {
 		LOG_ERR("Failed to set TLS_TAG option");
+		ret = -errno;
 		goto err_sock;
 	}
 
-	if (setsockopt(hb_context.sock, SOL_TLS, TLS_HOSTNAME,
-		       CONFIG_HAWKBIT_SERVER,
-		       sizeof(CONFIG_HAWKBIT_SERVER)) < 0) {
+	if (setsockopt(sock, SOL_TLS, TLS_HOSTNAME, host,
+		       strlen(host) + 1) < 0) {
+		ret = -errno;
 		goto err_sock;
 	}
 #endif
 
-	if (connect(hb_context.sock, addr->ai_addr, addr->ai_addrlen) < 0) {
+	if (connect(sock, addr->ai_addr, addr->ai_addrlen) < 0) {
 		LOG_ERR("Failed to connect to Server");
+		ret = -errno;
 		goto err_sock;
 	}
 
 	freeaddrinfo(addr);
-	return true;
+	return sock;
 
 err_sock:
-	close(hb_context.sock);
+	close(sock);
 err:
 	freeaddrinfo(addr);
-	return false;
+	return ret;
+}
+
+#if defined(CONFIG_HAWKBIT_CONNECTION_POOL)
+#if defined(CONFIG_NET_SOCKETS_SOCKOPT_TLS)
+static const sec_tag_t hawkbit_sec_tags[] = {
+	CA_CERTIFICATE_TAG,
+};
+#endif
+
+static const struct http_client_pool_transport hawkbit_transport = {
+	.connect_cb = hawkbit_connect,
+#if defined(CONFIG_NET_SOCKETS_SOCKOPT_TLS)
+	.sec_tags = hawkbit_sec_tags,
+	.sec_tag_count = ARRAY_SIZE(hawkbit_sec_tags),
+	.tls = true,
+#endif
+};
+#endif
+
+static bool start_http_client(void)
+{
+	if (IS_ENABLED(CONFIG_HAWKBIT_CONNECTION_POOL)) {
+		/* The pool connects on the first request */
+		return true;
+	}
+
+	hb_context.sock = hawkbit_connect(CONFIG_HAWKBIT_SERVER,
+					  CONFIG_HAWKBIT_PORT, NULL);
+
+	return hb_context.sock >= 0;
+}
+
+static int hawkbit_http_req(void *user_data)
+{
+#if defined(CONFIG_HAWKBIT_CONNECTION_POOL)
+	return http_client_pool_req(&hb_context.http_req, &hawkbit_transport,
+				    HAWKBIT_RECV_TIMEOUT, user_data);
+#else
+	return http_client_req(hb_context.sock, &hb_context.http_req,
+			       HAWKBIT_RECV_TIMEOUT, user_data);
+#endif
+}
+
+/* Stop receiving the response of the request in progress. */
+static void abort_request(void)
+{
+	if (close(hb_context.http_req.internal.sock) < 0) {
+		LOG_ERR("Could not close the socket");
+	}
+
+	hb_context.http_req.internal.sock = -1;
+	hb_context.sock = -1;
 }
 
 static void cleanup_connection(void)
 {
+	/* A pooled connection is kept open for the next poll */
+	if (IS_ENABLED(CONFIG_HAWKBIT_CONNECTION_POOL) || hb_context.sock < 0) {
+		return;
+	}
+
 	if (close(hb_context.sock) < 0) {
 		LOG_ERR("Could not close the socket");
 	}
+
+	hb_context.sock = -1;
 }
 
 static int hawkbit_time2sec(const char *s)
@@ -694,7 +759,7 @@ static void response_cb(struct http_response *rsp,
 					LOG_ERR("Failed to realloc memory");
 					hb_context.code_status =
 						HAWKBIT_METADATA_ERROR;
-					cleanup_connection();
+					abort_request();
 					break;
 				}
 
@@ -757,7 +822,7 @@ static void response_cb(struct http_response *rsp,
 					LOG_ERR("Failed to relloc memory");
 					hb_context.code_status =
 						HAWKBIT_METADATA_ERROR;
-					cleanup_connection();
+					abort_request();
 					break;
 				}
 
@@ -866,8 +931,7 @@ static bool send_request(enum http_method method,
 
 	switch (type) {
 	case HAWKBIT_PROBE:
-		ret = http_client_req(hb_context.sock, &hb_context.http_req,
-				      HAWKBIT_RECV_TIMEOUT, "HAWKBIT_PROBE");
+		ret = hawkbit_http_req("HAWKBIT_PROBE");
 		if (ret < 0) {
 			LOG_ERR("Unable to send http request");
 			return false;
@@ -900,9 +964,7 @@ static bool send_request(enum http_method method,
 		hb_context.http_req.payload_len =
 			strlen(hb_context.status_buffer);
 
-		ret = http_client_req(hb_context.sock, &hb_context.http_req,
-				      HAWKBIT_RECV_TIMEOUT,
-				      "HAWKBIT_CONFIG_DEVICE");
+		ret = hawkbit_http_req("HAWKBIT_CONFIG_DEVICE");
 		if (ret < 0) {
 			LOG_ERR("Unable to send http request");
 			return false;
@@ -935,8 +997,7 @@ static bool send_request(enum http_method method,
 		hb_context.http_req.payload_len =
 			strlen(hb_context.status_buffer);
 
-		ret = http_client_req(hb_context.sock, &hb_context.http_req,
-				      HAWKBIT_RECV_TIMEOUT, "HAWKBIT_CLOSE");
+		ret = hawkbit_http_req("HAWKBIT_CLOSE");
 		if (ret < 0) {
 			LOG_ERR("Unable to send http request");
 			return false;
@@ -946,9 +1007,7 @@ static bool send_request(enum http_method method,
 
 	case HAWKBIT_PROBE_DEPLOYMENT_BASE:
 		hb_context.http_req.content_type_value = NULL;
-		ret = http_client_req(hb_context.sock, &hb_context.http_req,
-				      HAWKBIT_RECV_TIMEOUT,
-				      "HAWKBIT_PROBE_DEPLOYMENT_BASE");
+		ret = hawkbit_http_req("HAWKBIT_PROBE_DEPLOYMENT_BASE");
 		if (ret < 0) {
 			LOG_ERR("Unable to send http request");
 			return false;
@@ -985,8 +1044,7 @@ static bool send_request(enum http_method method,
 		hb_context.http_req.payload_len =
 			strlen(hb_context.status_buffer);
 
-		ret = http_client_req(hb_context.sock, &hb_context.http_req,
-				      HAWKBIT_RECV_TIMEOUT, "HAWKBIT_REPORT");
+		ret = hawkbit_http_req("HAWKBIT_REPORT");
 		if (ret < 0) {
 			LOG_ERR("Unable to send http request");
 			return false;
@@ -995,8 +1053,7 @@ static bool send_request(enum http_method method,
 		break;
 
 	case HAWKBIT_DOWNLOAD:
-		ret = http_client_req(hb_context.sock, &hb_context.http_req,
-				      HAWKBIT_RECV_TIMEOUT, "HAWKBIT_DOWNLOAD");
+		ret = hawkbit_http_req("HAWKBIT_DOWNLOAD");
 		if (ret < 0) {
 			LOG_ERR("Unable to send image download request");
 			return false;
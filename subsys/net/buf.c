@@ -368,6 +368,105 @@ struct net_buf *net_buf_alloc_fixed(struct net_buf_pool *pool,
 }
 #endif
 
+#if defined(CONFIG_NET_BUF_LOG)
+struct net_buf *net_buf_alloc_chain_debug(struct net_buf_pool *pool,
+					  size_t len, k_timeout_t timeout,
+					  const char *func, int line)
+#else
+struct net_buf *net_buf_alloc_chain(struct net_buf_pool *pool, size_t len,
+				    k_timeout_t timeout)
+#endif
+{
+	const struct net_buf_pool_fixed *fixed = pool->alloc->alloc_data;
+	uint64_t end = sys_clock_timeout_end_calc(timeout);
+	struct net_buf *head = NULL;
+	struct net_buf *tail = NULL;
+	struct net_buf *buf;
+	uint16_t uninit_count;
+	uint16_t reserved;
+	uint16_t count;
+	uint16_t i;
+	unsigned int key;
+
+	__ASSERT_NO_MSG(pool);
+	__ASSERT_NO_MSG(pool->alloc->cb == &net_buf_fixed_cb);
+
+	NET_BUF_DBG("%s():%d: pool %p len %zu", func, line, pool, len);
+
+	if (ceiling_fraction(len, fixed->data_size) > pool->buf_count) {
+		NET_BUF_ERR("%s():%d: Pool too small for %zu bytes", func,
+			    line, len);
+		return NULL;
+	}
+
+	count = MAX(ceiling_fraction(len, fixed->data_size), 1);
+
+	/* Reserve all the uninitialized buffers needed at once, only the
+	 * remaining ones are taken from the LIFO.
+	 */
+	key = irq_lock();
+	uninit_count = pool->uninit_count;
+	reserved = MIN(count, uninit_count);
+	pool->uninit_count -= reserved;
+	irq_unlock(key);
+
+	for (i = 0U; i < count; i++) {
+		if (i < reserved) {
+			buf = pool_get_uninit(pool, uninit_count - i);
+		} else {
+			if (!K_TIMEOUT_EQ(timeout, K_NO_WAIT) &&
+			    !K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+				int64_t remaining = end - sys_clock_tick_get();
+
+				if (remaining <= 0) {
+					timeout = K_NO_WAIT;
+				} else {
+					timeout = Z_TIMEOUT_TICKS(remaining);
+				}
+			}
+
+			buf = k_lifo_get(&pool->free, timeout);
+			if (!buf) {
+				NET_BUF_ERR("%s():%d: Failed to get free buffer",
+					    func, line);
+				break;
+			}
+		}
+
+		buf->__buf = fixed->data_pool + fixed->data_size * net_buf_id(buf);
+		buf->ref   = 1U;
+		buf->flags = 0U;
+		buf->frags = NULL;
+		buf->size  = fixed->data_size;
+		net_buf_reset(buf);
+
+		if (tail) {
+			tail->frags = buf;
+		} else {
+			head = buf;
+		}
+
+		tail = buf;
+	}
+
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+	atomic_sub(&pool->avail_count, i);
+	__ASSERT_NO_MSG(atomic_get(&pool->avail_count) >= 0);
+#endif
+
+	if (i < count) {
+		if (head) {
+			net_buf_unref(head);
+		}
+
+		return NULL;
+	}
+
+	NET_BUF_DBG("allocated chain %p of %u bufs", head, count);
+
+	return head;
+}
+
 #if defined(CONFIG_NET_BUF_LOG)
 struct net_buf *net_buf_alloc_with_data_debug(struct net_buf_pool *pool,
 					      void *data, size_t size,
@@ -511,12 +610,30 @@ void net_buf_put(struct k_fifo *fifo, struct net_buf *buf)
 	k_fifo_put_list(fifo, buf, tail);
 }
 
+/* Put back a list of buffers, linked through their frags pointer, into
+ * their pool.
+ */
+static void pool_free_list(struct net_buf_pool *pool, struct net_buf *head,
+			   struct net_buf *tail)
+{
+	if (head == tail) {
+		k_lifo_put(&pool->free, head);
+		return;
+	}
+
+	k_queue_append_list(&pool->free._queue, head, tail);
+}
+
 #if defined(CONFIG_NET_BUF_LOG)
 void net_buf_unref_debug(struct net_buf *buf, const char *func, int line)
 #else
 void net_buf_unref(struct net_buf *buf)
 #endif
 {
+	struct net_buf_pool *free_pool = NULL;
+	struct net_buf *free_head = NULL;
+	struct net_buf *free_tail = NULL;
+
 	__ASSERT_NO_MSG(buf);
 
 	while (buf) {
@@ -527,14 +644,14 @@ void net_buf_unref(struct net_buf *buf)
 		if (!buf->ref) {
 			NET_BUF_ERR("%s():%d: buf %p double free", func, line,
 				    buf);
-			return;
+			break;
 		}
 #endif
 		NET_BUF_DBG("buf %p ref %u pool_id %u frags %p", buf, buf->ref,
 			    buf->pool_id, buf->frags);
 
 		if (--buf->ref > 0) {
-			return;
+			break;
 		}
 
 		if (buf->__buf) {
@@ -554,12 +671,28 @@ void net_buf_unref(struct net_buf *buf)
 
 		if (pool->destroy) {
 			pool->destroy(buf);
+		} else if (pool == free_pool) {
+			free_tail->frags = buf;
+			free_tail = buf;
 		} else {
-			net_buf_destroy(buf);
+			/* Fragments of the same pool are gathered and put
+			 * back together.
+			 */
+			if (free_head) {
+				pool_free_list(free_pool, free_head, free_tail);
+			}
+
+			free_pool = pool;
+			free_head = buf;
+			free_tail = buf;
 		}
 
 		buf = frags;
 	}
+
+	if (free_head) {
+		pool_free_list(free_pool, free_head, free_tail);
+	}
 }
 
 struct net_buf *net_buf_ref(struct net_buf *buf)
@@ -46,6 +46,38 @@ static inline uint8_t get_6co_cid(struct net_icmpv6_nd_opt_6co *opt)
 static struct net_6lo_context ctx_6co[CONFIG_NET_MAX_6LO_CONTEXTS];
 #endif
 
+#if CONFIG_NET_6LO_COMPRESS_CACHE_SIZE > 0
+/* Address compression of a flow. The IPHC address bits only depend on
+ * the interface, the addresses and the link layer addresses (and on the
+ * contexts, the cache is flushed when they change).
+ */
+struct net_6lo_addr_cache {
+	struct net_if *iface;
+	struct in6_addr src;
+	struct in6_addr dst;
+	uint8_t lladdr_src[NET_LINK_ADDR_MAX_LENGTH];
+	uint8_t lladdr_dst[NET_LINK_ADDR_MAX_LENGTH];
+	uint8_t lladdr_src_len;
+	uint8_t lladdr_dst_len;
+	/* CID, SAC, SAM, M, DAC and DAM bits of the IPHC header */
+	uint16_t iphc;
+	/* Context identifier extension */
+	uint8_t cid;
+};
+
+static struct net_6lo_addr_cache addr_cache[CONFIG_NET_6LO_COMPRESS_CACHE_SIZE];
+static K_MUTEX_DEFINE(addr_cache_lock);
+
+static void addr_cache_flush(void)
+{
+	k_mutex_lock(&addr_cache_lock, K_FOREVER);
+	(void)memset(addr_cache, 0, sizeof(addr_cache));
+	k_mutex_unlock(&addr_cache_lock);
+}
+#else
+#define addr_cache_flush(...)
+#endif
+
 static const uint8_t udp_nhc_inline_size_table[] = {4, 3, 3, 1};
 
 static const uint8_t tf_inline_size_table[] = {4, 3, 1, 0};
@@ -178,6 +210,9 @@ void net_6lo_set_context(struct net_if *iface,
 	int unused = -1;
 	uint8_t i;
 
+	/* Cached compression decisions may depend on the old contexts */
+	addr_cache_flush();
+
 	/* If the context information already exists, update or remove
 	 * as per data.
 	 */
@@ -710,47 +745,19 @@ static struct net_6lo_context *get_dst_addr_ctx(struct net_pkt *pkt,
 }
 #endif /* CONFIG_NET_6LO_CONTEXT */
 
-/* RFC 6282 LOWPAN IPHC Encoding format (3.1)
- *  Base Format
- *   0                                       1
- *   0   1   2   3   4   5   6   7   8   9   0   1   2   3   4   5
- * +---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+
- * | 0 | 1 | 1 |  TF   |NH | HLIM  |CID|SAC|  SAM  | M |DAC|  DAM  |
- * +---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+
+/* Compress the source and destination addresses, writing their inlined
+ * parts before inline_pos. Sets the address bits of the IPHC header and
+ * the context identifier extension.
  */
-static inline int compress_IPHC_header(struct net_pkt *pkt)
+static uint8_t *compress_addrs(struct net_pkt *pkt, struct net_ipv6_hdr *ipv6,
+			       uint8_t *inline_pos, uint16_t *iphc_ptr,
+			       uint8_t *cid)
 {
 #if defined(CONFIG_NET_6LO_CONTEXT)
 	struct net_6lo_context *src_ctx = NULL;
 	struct net_6lo_context *dst_ctx = NULL;
 #endif
-	uint8_t compressed = 0;
-	uint16_t iphc = (NET_6LO_DISPATCH_IPHC << 8);
-	struct net_ipv6_hdr *ipv6 = NET_IPV6_HDR(pkt);
-	struct net_udp_hdr *udp;
-	uint8_t *inline_pos;
-
-	if (pkt->frags->len < NET_IPV6H_LEN) {
-		NET_ERR("Invalid length %d, min %d",
-			pkt->frags->len, NET_IPV6H_LEN);
-		return -EINVAL;
-	}
-
-	if (ipv6->nexthdr == IPPROTO_UDP &&
-	    pkt->frags->len < NET_IPV6UDPH_LEN) {
-		NET_ERR("Invalid length %d, min %d",
-			pkt->frags->len, NET_IPV6UDPH_LEN);
-		return -EINVAL;
-	}
-
-	inline_pos = pkt->buffer->data + NET_IPV6H_LEN;
-
-	if (ipv6->nexthdr == IPPROTO_UDP) {
-		udp = (struct net_udp_hdr *)inline_pos;
-		inline_pos += NET_UDPH_LEN;
-
-		inline_pos = compress_nh_udp(udp, inline_pos, false);
-	}
+	uint16_t iphc = *iphc_ptr;
 
 	if (net_6lo_ll_prefix_padded_with_zeros(&ipv6->dst)) {
 		inline_pos = compress_da(ipv6, pkt, inline_pos, &iphc);
@@ -799,25 +806,196 @@ da_end:
 #endif
 	inline_pos = set_sa_inline(ipv6, inline_pos, &iphc);
 sa_end:
+#if defined(CONFIG_NET_6LO_CONTEXT)
+	if (src_ctx) {
+		*cid = src_ctx->cid << 4;
+	}
+
+	if (dst_ctx) {
+		*cid |= dst_ctx->cid & 0x0F;
+	}
+#endif
+
+	*iphc_ptr = iphc;
+
+	return inline_pos;
+}
+
+/* Helpers to inline the addresses as encoded in the IPHC header. The
+ * inlined bytes are the last ones of the address, except for the 48 and
+ * 32 bits compressed multicast addresses which also carry the flags and
+ * scope byte.
+ */
+static uint8_t *inline_sa(struct net_ipv6_hdr *ipv6, uint8_t *inline_ptr,
+			  uint16_t iphc)
+{
+	uint8_t size = sa_inline_size_table[(iphc & NET_6LO_IPHC_SA_MASK) >>
+					    NET_6LO_IPHC_SAM_POS];
+
+	inline_ptr -= size;
+	memmove(inline_ptr, &ipv6->src.s6_addr[16U - size], size);
+
+	return inline_ptr;
+}
+
+static uint8_t *inline_da(struct net_ipv6_hdr *ipv6, uint8_t *inline_ptr,
+			  uint16_t iphc)
+{
+	uint8_t size = da_inline_size_table[(iphc & NET_6LO_IPHC_DA_MASK) >>
+					    NET_6LO_IPHC_DAM_POS];
+
+	if ((iphc & NET_6LO_IPHC_M_1) && size > 1U && size < 16U) {
+		size -= 1U;
+
+		inline_ptr -= size;
+		memmove(inline_ptr, &ipv6->dst.s6_addr[16U - size], size);
+
+		inline_ptr -= sizeof(uint8_t);
+		memmove(inline_ptr, &ipv6->dst.s6_addr[1], sizeof(uint8_t));
+
+		return inline_ptr;
+	}
+
+	inline_ptr -= size;
+	memmove(inline_ptr, &ipv6->dst.s6_addr[16U - size], size);
+
+	return inline_ptr;
+}
+
+#if CONFIG_NET_6LO_COMPRESS_CACHE_SIZE > 0
+static inline uint8_t addr_cache_lladdr_len(struct net_linkaddr *lladdr)
+{
+	return lladdr->addr ? MIN(lladdr->len, NET_LINK_ADDR_MAX_LENGTH) : 0U;
+}
+
+static inline bool addr_cache_lladdr_eq(const uint8_t *addr, uint8_t len,
+					struct net_linkaddr *lladdr)
+{
+	return len == addr_cache_lladdr_len(lladdr) &&
+		!memcmp(addr, lladdr->addr, len);
+}
+
+static inline struct net_6lo_addr_cache *
+addr_cache_entry(struct net_ipv6_hdr *ipv6)
+{
+	return &addr_cache[(ipv6->src.s6_addr[15] ^ ipv6->dst.s6_addr[15] ^
+			    ipv6->dst.s6_addr[14]) %
+			   CONFIG_NET_6LO_COMPRESS_CACHE_SIZE];
+}
+
+/* Look up the address compression of the flow of the packet. On a hit
+ * the cached address bits are added to iphc.
+ */
+static bool addr_cache_get(struct net_pkt *pkt, struct net_ipv6_hdr *ipv6,
+			   uint16_t *iphc, uint8_t *cid)
+{
+	struct net_6lo_addr_cache *entry = addr_cache_entry(ipv6);
+	bool hit;
+
+	k_mutex_lock(&addr_cache_lock, K_FOREVER);
+
+	hit = entry->iface == net_pkt_iface(pkt) &&
+		net_ipv6_addr_cmp(&entry->dst, &ipv6->dst) &&
+		net_ipv6_addr_cmp(&entry->src, &ipv6->src) &&
+		addr_cache_lladdr_eq(entry->lladdr_dst, entry->lladdr_dst_len,
+				     net_pkt_lladdr_dst(pkt)) &&
+		addr_cache_lladdr_eq(entry->lladdr_src, entry->lladdr_src_len,
+				     net_pkt_lladdr_src(pkt));
+	if (hit) {
+		*iphc |= entry->iphc;
+		*cid = entry->cid;
+	}
+
+	k_mutex_unlock(&addr_cache_lock);
+
+	return hit;
+}
+
+static void addr_cache_set(struct net_pkt *pkt, struct net_ipv6_hdr *ipv6,
+			   uint16_t iphc, uint8_t cid)
+{
+	struct net_6lo_addr_cache *entry = addr_cache_entry(ipv6);
+	struct net_linkaddr *lladdr_src = net_pkt_lladdr_src(pkt);
+	struct net_linkaddr *lladdr_dst = net_pkt_lladdr_dst(pkt);
+
+	k_mutex_lock(&addr_cache_lock, K_FOREVER);
+
+	entry->iface = net_pkt_iface(pkt);
+	net_ipaddr_copy(&entry->src, &ipv6->src);
+	net_ipaddr_copy(&entry->dst, &ipv6->dst);
+
+	entry->lladdr_src_len = addr_cache_lladdr_len(lladdr_src);
+	memcpy(entry->lladdr_src, lladdr_src->addr, entry->lladdr_src_len);
+
+	entry->lladdr_dst_len = addr_cache_lladdr_len(lladdr_dst);
+	memcpy(entry->lladdr_dst, lladdr_dst->addr, entry->lladdr_dst_len);
+
+	entry->iphc = iphc & (NET_6LO_IPHC_CID_MASK | NET_6LO_IPHC_SA_MASK |
+			      NET_6LO_IPHC_DA_MASK);
+	entry->cid = cid;
+
+	k_mutex_unlock(&addr_cache_lock);
+}
+#else
+#define addr_cache_get(...) false
+#define addr_cache_set(...)
+#endif /* CONFIG_NET_6LO_COMPRESS_CACHE_SIZE > 0 */
+
+/* RFC 6282 LOWPAN IPHC Encoding format (3.1)
+ *  Base Format
+ *   0                                       1
+ *   0   1   2   3   4   5   6   7   8   9   0   1   2   3   4   5
+ * +---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+
+ * | 0 | 1 | 1 |  TF   |NH | HLIM  |CID|SAC|  SAM  | M |DAC|  DAM  |
+ * +---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+
+ */
+static inline int compress_IPHC_header(struct net_pkt *pkt)
+{
+	uint8_t compressed = 0;
+	uint8_t cid = 0U;
+	uint16_t iphc = (NET_6LO_DISPATCH_IPHC << 8);
+	struct net_ipv6_hdr *ipv6 = NET_IPV6_HDR(pkt);
+	struct net_udp_hdr *udp;
+	uint8_t *inline_pos;
+
+	if (pkt->frags->len < NET_IPV6H_LEN) {
+		NET_ERR("Invalid length %d, min %d",
+			pkt->frags->len, NET_IPV6H_LEN);
+		return -EINVAL;
+	}
+
+	if (ipv6->nexthdr == IPPROTO_UDP &&
+	    pkt->frags->len < NET_IPV6UDPH_LEN) {
+		NET_ERR("Invalid length %d, min %d",
+			pkt->frags->len, NET_IPV6UDPH_LEN);
+		return -EINVAL;
+	}
+
+	inline_pos = pkt->buffer->data + NET_IPV6H_LEN;
+
+	if (ipv6->nexthdr == IPPROTO_UDP) {
+		udp = (struct net_udp_hdr *)inline_pos;
+		inline_pos += NET_UDPH_LEN;
+
+		inline_pos = compress_nh_udp(udp, inline_pos, false);
+	}
+
+	if (addr_cache_get(pkt, ipv6, &iphc, &cid)) {
+		inline_pos = inline_da(ipv6, inline_pos, iphc);
+		inline_pos = inline_sa(ipv6, inline_pos, iphc);
+	} else {
+		inline_pos = compress_addrs(pkt, ipv6, inline_pos, &iphc, &cid);
+		addr_cache_set(pkt, ipv6, iphc, cid);
+	}
 
 	inline_pos = compress_hoplimit(ipv6, inline_pos, &iphc);
 	inline_pos = compress_nh(ipv6, inline_pos, &iphc);
 	inline_pos = compress_tfl(ipv6, inline_pos, &iphc);
 
-#if defined(CONFIG_NET_6LO_CONTEXT)
 	if (iphc & NET_6LO_IPHC_CID_1) {
 		inline_pos -= sizeof(uint8_t);
-		*inline_pos = 0;
-
-		if (src_ctx) {
-			*inline_pos = src_ctx->cid << 4;
-		}
-
-		if (dst_ctx) {
-			*inline_pos |= dst_ctx->cid & 0x0F;
-		}
+		*inline_pos = cid;
 	}
-#endif
 
 	inline_pos -= sizeof(iphc);
 	iphc = htons(iphc);
@@ -1308,6 +1486,32 @@ static inline void uncompress_cid(struct net_pkt *pkt, uint8_t cid,
 }
 #endif
 
+/* Headroom of the first fragment that can be used to uncompress the
+ * header. The link layer addresses of the packet may point into the link
+ * layer header in front of the data, they must be kept intact.
+ */
+static size_t uncompress_headroom(struct net_pkt *pkt)
+{
+	struct net_buf *buf = pkt->buffer;
+	uint8_t *start = buf->data - net_buf_headroom(buf);
+	struct net_linkaddr *lladdr[] = {
+		net_pkt_lladdr_src(pkt),
+		net_pkt_lladdr_dst(pkt),
+	};
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(lladdr); i++) {
+		uint8_t *addr = lladdr[i]->addr;
+
+		if (addr && addr + lladdr[i]->len > start &&
+		    addr < buf->data) {
+			start = MIN(addr + lladdr[i]->len, buf->data);
+		}
+	}
+
+	return buf->data - start;
+}
+
 static bool uncompress_IPHC_header(struct net_pkt *pkt)
 {
 	struct net_udp_hdr *udp = NULL;
@@ -1318,6 +1522,7 @@ static bool uncompress_IPHC_header(struct net_pkt *pkt)
 	uint16_t len;
 	uint16_t iphc;
 	int inline_size, compressed_hdr_size;
+	size_t headroom, shift;
 	size_t diff;
 	uint8_t *cursor;
 #if defined(CONFIG_NET_6LO_CONTEXT)
@@ -1353,14 +1558,28 @@ static bool uncompress_IPHC_header(struct net_pkt *pkt)
 		return false;
 	}
 
-	if (net_buf_tailroom(pkt->buffer) >= diff) {
-		NET_DBG("Enough tailroom. Uncompress inplace");
+	headroom = uncompress_headroom(pkt);
+
+	if (headroom + net_buf_tailroom(pkt->buffer) >= diff) {
+		/* Uncompress in front of the payload as far as the headroom
+		 * allows, the payload is only moved for the rest.
+		 */
+		shift = diff - MIN(headroom, diff);
+
+		NET_DBG("Uncompress inplace, payload moved by %zu", shift);
+
 		frag = pkt->buffer;
-		net_buf_add(frag, diff);
+		net_buf_push(frag, diff - shift);
+
+		if (shift) {
+			net_buf_add(frag, shift);
+			memmove(frag->data + diff, frag->data + diff - shift,
+				frag->len - diff);
+		}
+
 		cursor = frag->data + diff;
-		memmove(cursor, frag->data, frag->len - diff);
 	} else {
-		NET_DBG("Not enough tailroom. Get new fragment");
+		NET_DBG("Not enough room. Get new fragment");
 		cursor =  pkt->buffer->data;
 		frag = net_pkt_get_frag(pkt, NET_6LO_RX_PKT_TIMEOUT);
 		if (!frag) {
@@ -566,6 +566,8 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 	if (IS_ENABLED(CONFIG_NET_UDP) && proto == IPPROTO_UDP) {
 		src_port = proto_hdr->udp->src_port;
 		dst_port = proto_hdr->udp->dst_port;
+
+		net_stats_update_latency(pkt, NET_STATS_LATENCY_RX_IP);
 	} else if (IS_ENABLED(CONFIG_NET_TCP) && proto == IPPROTO_TCP) {
 		if (proto_hdr->tcp == NULL) {
 			return NET_DROP;
@@ -573,6 +575,8 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 
 		src_port = proto_hdr->tcp->src_port;
 		dst_port = proto_hdr->tcp->dst_port;
+
+		net_stats_update_latency(pkt, NET_STATS_LATENCY_RX_IP);
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET)) {
 		if (net_pkt_family(pkt) != AF_PACKET ||
 		    (!IS_ENABLED(CONFIG_NET_SOCKETS_PACKET_DGRAM) &&
@@ -0,0 +1,366 @@
+/** @file
+ * @brief TCP receive segment coalescing
+ *
+ * Consecutive in-order TCP segments of the same flow are merged into one
+ * network packet before they are passed to the TCP layer. This way the
+ * per packet cost of the connection lookup, TCP state machine and socket
+ * queueing is paid once per batch of received segments.
+ *
+ * A flow is owned by the RX thread that held its first segment. Only that
+ * thread merges into it and passes it up, so the segments of a flow reach
+ * the TCP layer in the order they were received.
+ */
+
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_gro, CONFIG_NET_GRO_LOG_LEVEL);
+
+#include <kernel.h>
+#include <string.h>
+
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+
+#include "net_private.h"
+#include "connection.h"
+#include "tcp_internal.h"
+#include "gro.h"
+
+struct gro_flow {
+	/** Held packet, NULL if the slot is free */
+	struct net_pkt *pkt;
+
+	/** RX thread that holds the packet */
+	k_tid_t owner;
+
+	/** Headers of the held packet, they point to the first fragment */
+	union net_ip_header ip_hdr;
+	union net_proto_header proto_hdr;
+
+	/** Sequence number expected for the next segment of the flow */
+	uint32_t next_seq;
+
+	/** When the first segment was held (in ms) */
+	uint32_t start_time;
+
+	/** Number of segments merged into the held packet */
+	uint8_t segs;
+};
+
+static struct gro_flow gro_flows[CONFIG_NET_GRO_FLOWS];
+
+/* Protects the slot allocation between the RX threads */
+static K_MUTEX_DEFINE(gro_lock);
+
+static inline struct tcphdr *gro_th(struct gro_flow *flow)
+{
+	return (struct tcphdr *)flow->proto_hdr.tcp;
+}
+
+static bool gro_in_buffer(struct net_pkt *pkt, const void *ptr, size_t len)
+{
+	const uint8_t *start = ptr;
+	struct net_buf *buf;
+
+	for (buf = pkt->buffer; buf; buf = buf->frags) {
+		if (start >= buf->data && start + len <= buf->data + buf->len) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static size_t gro_hdr_len(struct net_pkt *pkt, struct tcphdr *th)
+{
+	return net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt) +
+		th_off(th) * 4U;
+}
+
+/* Only pure data segments without any special handling in the TCP state
+ * machine are coalesced. The headers must be in the packet buffer as we
+ * keep pointers to them while the packet is held.
+ */
+static bool gro_is_mergeable(struct net_pkt *pkt,
+			     union net_ip_header *ip_hdr,
+			     struct tcphdr *th, size_t data_len)
+{
+	if (data_len == 0U || (th_flags(th) & ~PSH) != ACK) {
+		return false;
+	}
+
+	if (net_pkt_ip_opts_len(pkt)) {
+		return false;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		if (!gro_in_buffer(pkt, ip_hdr->ipv4,
+				   sizeof(struct net_ipv4_hdr))) {
+			return false;
+		}
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   net_pkt_family(pkt) == AF_INET6) {
+		if (!gro_in_buffer(pkt, ip_hdr->ipv6,
+				   sizeof(struct net_ipv6_hdr))) {
+			return false;
+		}
+	} else {
+		return false;
+	}
+
+	return gro_in_buffer(pkt, th, th_off(th) * 4U);
+}
+
+static bool gro_flow_match(struct gro_flow *flow, struct net_pkt *pkt,
+			   union net_ip_header *ip_hdr, struct tcphdr *th)
+{
+	struct tcphdr *held = gro_th(flow);
+
+	if (net_pkt_iface(flow->pkt) != net_pkt_iface(pkt) ||
+	    net_pkt_family(flow->pkt) != net_pkt_family(pkt) ||
+	    th_sport(held) != th_sport(th) ||
+	    th_dport(held) != th_dport(th)) {
+		return false;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		return net_ipv4_addr_cmp(&flow->ip_hdr.ipv4->src,
+					 &ip_hdr->ipv4->src) &&
+			net_ipv4_addr_cmp(&flow->ip_hdr.ipv4->dst,
+					  &ip_hdr->ipv4->dst);
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && net_pkt_family(pkt) == AF_INET6) {
+		return net_ipv6_addr_cmp(&flow->ip_hdr.ipv6->src,
+					 &ip_hdr->ipv6->src) &&
+			net_ipv6_addr_cmp(&flow->ip_hdr.ipv6->dst,
+					  &ip_hdr->ipv6->dst);
+	}
+
+	return false;
+}
+
+static bool gro_can_append(struct gro_flow *flow, struct net_pkt *pkt,
+			   struct tcphdr *th, size_t data_len)
+{
+	struct tcphdr *held = gro_th(flow);
+
+	if (th_seq(th) != flow->next_seq || th_ack(th) != th_ack(held)) {
+		return false;
+	}
+
+	if (th_off(th) != th_off(held) ||
+	    memcmp((uint8_t *)th + sizeof(*th), (uint8_t *)held + sizeof(*held),
+		   th_off(th) * 4U - sizeof(*th))) {
+		return false;
+	}
+
+	return net_pkt_get_len(flow->pkt) + data_len <= CONFIG_NET_GRO_MAX_LEN;
+}
+
+/* Move the payload of pkt to the end of the held packet */
+static void gro_append(struct gro_flow *flow, struct net_pkt *pkt,
+		       struct tcphdr *th, size_t hdr_len, size_t data_len)
+{
+	struct tcphdr *held = gro_th(flow);
+	struct net_buf *frags;
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_skip(pkt, hdr_len);
+
+	while (pkt->buffer != pkt->cursor.buf) {
+		pkt->buffer = net_buf_frag_del(NULL, pkt->buffer);
+	}
+
+	frags = pkt->buffer;
+	net_buf_pull(frags, pkt->cursor.pos - frags->data);
+
+	pkt->buffer = NULL;
+	net_pkt_cursor_init(pkt);
+
+	net_pkt_usage_move(flow->pkt, pkt, frags);
+	net_pkt_append_buffer(flow->pkt, frags);
+
+	/* The checksums have been verified already, so only the fields the
+	 * TCP layer looks at are updated.
+	 */
+	UNALIGNED_PUT(UNALIGNED_GET(&th->th_win), &held->th_win);
+	held->th_flags |= th_flags(th) & PSH;
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		flow->ip_hdr.ipv4->len =
+			htons(ntohs(flow->ip_hdr.ipv4->len) + data_len);
+	} else if (IS_ENABLED(CONFIG_NET_IPV6)) {
+		flow->ip_hdr.ipv6->len =
+			htons(ntohs(flow->ip_hdr.ipv6->len) + data_len);
+	}
+
+	flow->next_seq += data_len;
+	flow->segs++;
+}
+
+static void gro_hold(struct gro_flow *flow, struct net_pkt *pkt,
+		     union net_ip_header *ip_hdr,
+		     union net_proto_header *proto_hdr, size_t data_len)
+{
+	flow->pkt = pkt;
+	flow->owner = k_current_get();
+	flow->ip_hdr = *ip_hdr;
+	flow->proto_hdr = *proto_hdr;
+	flow->next_seq = th_seq(gro_th(flow)) + data_len;
+	flow->start_time = k_uptime_get_32();
+	flow->segs = 1U;
+}
+
+static void gro_take(struct gro_flow *flow, struct gro_flow *out)
+{
+	*out = *flow;
+	flow->pkt = NULL;
+}
+
+static void gro_deliver(struct gro_flow *flow)
+{
+	struct net_pkt *pkt = flow->pkt;
+
+	if (!pkt) {
+		return;
+	}
+
+	NET_DBG("Flush pkt %p (%u segments, %zu bytes)", pkt, flow->segs,
+		net_pkt_get_len(pkt));
+
+	if (net_conn_input(pkt, &flow->ip_hdr, IPPROTO_TCP,
+			   &flow->proto_hdr) == NET_DROP) {
+		net_pkt_unref(pkt);
+	}
+}
+
+static inline bool gro_flow_is_own(struct gro_flow *flow)
+{
+	return flow->pkt && flow->owner == k_current_get();
+}
+
+static struct gro_flow *gro_flow_find(struct net_pkt *pkt,
+				      union net_ip_header *ip_hdr,
+				      struct tcphdr *th)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(gro_flows); i++) {
+		if (gro_flow_is_own(&gro_flows[i]) &&
+		    gro_flow_match(&gro_flows[i], pkt, ip_hdr, th)) {
+			return &gro_flows[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Return a free slot, or the slot of this thread that has been held the
+ * longest. The flows of the other RX threads are never taken over.
+ */
+static struct gro_flow *gro_flow_get(void)
+{
+	struct gro_flow *oldest = NULL;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(gro_flows); i++) {
+		if (!gro_flows[i].pkt) {
+			return &gro_flows[i];
+		}
+
+		if (!gro_flow_is_own(&gro_flows[i])) {
+			continue;
+		}
+
+		if (!oldest || (int32_t)(gro_flows[i].start_time -
+					 oldest->start_time) < 0) {
+			oldest = &gro_flows[i];
+		}
+	}
+
+	return oldest;
+}
+
+enum net_verdict net_gro_input(struct net_pkt *pkt,
+			       union net_ip_header *ip_hdr,
+			       union net_proto_header *proto_hdr)
+{
+	struct tcphdr *th = (struct tcphdr *)proto_hdr->tcp;
+	enum net_verdict verdict = NET_CONTINUE;
+	struct gro_flow flushed = { 0 };
+	struct gro_flow *flow;
+	size_t hdr_len, data_len;
+	bool mergeable;
+
+	if (!net_if_flag_is_set(net_pkt_iface(pkt), NET_IF_GRO)) {
+		return NET_CONTINUE;
+	}
+
+	hdr_len = gro_hdr_len(pkt, th);
+	if (net_pkt_get_len(pkt) < hdr_len) {
+		return NET_CONTINUE;
+	}
+
+	data_len = net_pkt_get_len(pkt) - hdr_len;
+	mergeable = gro_is_mergeable(pkt, ip_hdr, th, data_len);
+
+	k_mutex_lock(&gro_lock, K_FOREVER);
+
+	flow = gro_flow_find(pkt, ip_hdr, th);
+	if (flow) {
+		if (mergeable && gro_can_append(flow, pkt, th, data_len)) {
+			gro_append(flow, pkt, th, hdr_len, data_len);
+			net_pkt_unref(pkt);
+			verdict = NET_OK;
+
+			if ((th_flags(gro_th(flow)) & PSH) ||
+			    flow->segs >= CONFIG_NET_GRO_MAX_SEGMENTS) {
+				gro_take(flow, &flushed);
+			}
+		} else {
+			/* Keep the segment order, the held data goes first */
+			gro_take(flow, &flushed);
+		}
+	} else if (mergeable && !(th_flags(th) & PSH)) {
+		flow = gro_flow_get();
+		if (flow) {
+			if (flow->pkt) {
+				gro_take(flow, &flushed);
+			}
+
+			gro_hold(flow, pkt, ip_hdr, proto_hdr, data_len);
+			verdict = NET_OK;
+		}
+	}
+
+	k_mutex_unlock(&gro_lock);
+
+	gro_deliver(&flushed);
+
+	return verdict;
+}
+
+void net_gro_flush(void)
+{
+	struct gro_flow flushed;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(gro_flows); i++) {
+		k_mutex_lock(&gro_lock, K_FOREVER);
+		flushed.pkt = NULL;
+		if (gro_flow_is_own(&gro_flows[i])) {
+			gro_take(&gro_flows[i], &flushed);
+		}
+		k_mutex_unlock(&gro_lock);
+
+		gro_deliver(&flushed);
+	}
+}
@@ -0,0 +1,67 @@
+/** @file
+ * @brief TCP receive segment coalescing
+ *
+ * This is not to be included by the application.
+ */
+
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __GRO_H
+#define __GRO_H
+
+#include <net/net_core.h>
+#include <net/net_ip.h>
+#include <net/net_pkt.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_NET_GRO)
+/**
+ * @brief Try to coalesce a received TCP segment with the previous in-order
+ * segments of the same flow.
+ *
+ * @param pkt Received packet, cursor placed after the TCP header.
+ * @param ip_hdr IP header of the packet.
+ * @param proto_hdr TCP header of the packet.
+ *
+ * @return NET_OK if the packet was held or merged and must not be touched
+ * by the caller anymore, NET_CONTINUE if the caller should pass the packet
+ * to the upper layer as usual.
+ */
+enum net_verdict net_gro_input(struct net_pkt *pkt,
+			       union net_ip_header *ip_hdr,
+			       union net_proto_header *proto_hdr);
+
+/**
+ * @brief Pass the segments held by the calling thread to the upper layer.
+ * This must be called by the RX thread when a batch of received packets
+ * has been processed.
+ */
+void net_gro_flush(void);
+#else
+static inline enum net_verdict net_gro_input(struct net_pkt *pkt,
+					     union net_ip_header *ip_hdr,
+					     union net_proto_header *proto_hdr)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(ip_hdr);
+	ARG_UNUSED(proto_hdr);
+
+	return NET_CONTINUE;
+}
+
+static inline void net_gro_flush(void) { }
+#endif /* CONFIG_NET_GRO */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GRO_H */
@@ -23,6 +23,7 @@ LOG_MODULE_REGISTER(net_ipv4, CONFIG_NET_IPV4_LOG_LEVEL);
 #include "icmpv4.h"
 #include "udp_internal.h"
 #include "tcp_internal.h"
+#include "gro.h"
 #include "ipv4.h"
 
 /* Timeout for various buffer allocations in this file. */
@@ -301,6 +302,16 @@ enum net_verdict net_ipv4_input(struct net_pkt *pkt)
 		goto drop;
 	}
 
+	if (IS_ENABLED(CONFIG_NET_IPV4_FRAGMENT) &&
+	    (sys_get_be16(hdr->offset) & ((NET_IPV4_MF << 13) | 0x1fff))) {
+		verdict = net_ipv4_handle_fragment_hdr(pkt, hdr);
+		if (verdict == NET_DROP) {
+			goto drop;
+		}
+
+		return verdict;
+	}
+
 	net_pkt_acknowledge_data(pkt, &ipv4_access);
 
 	if (opts_len) {
@@ -372,6 +383,13 @@ enum net_verdict net_ipv4_input(struct net_pkt *pkt)
 
 	ip.ipv4 = hdr;
 
+	if (hdr->proto == IPPROTO_TCP) {
+		verdict = net_gro_input(pkt, &ip, &proto_hdr);
+		if (verdict != NET_CONTINUE) {
+			return verdict;
+		}
+	}
+
 	verdict = net_conn_input(pkt, &ip, hdr->proto, &proto_hdr);
 	if (verdict != NET_DROP) {
 		return verdict;
@@ -20,6 +20,8 @@
 #include <net/net_if.h>
 #include <net/net_context.h>
 
+#include "reassembly.h"
+
 #define NET_IPV4_IHL_MASK 0x0F
 
 /* IPv4 Options */
@@ -204,4 +206,47 @@ static inline int net_ipv4_parse_hdr_options(struct net_pkt *pkt,
 }
 #endif
 
+/**
+ * @brief Handle a received IPv4 fragment. The fragment is kept until the
+ * whole datagram is received, the reassembled datagram is then fed back
+ * to the IP stack.
+ *
+ * @param pkt Received fragment, starting with the IPv4 header.
+ * @param hdr IPv4 header of the fragment.
+ *
+ * @return NET_OK if the fragment was taken, NET_DROP otherwise.
+ */
+#if defined(CONFIG_NET_IPV4_FRAGMENT)
+enum net_verdict net_ipv4_handle_fragment_hdr(struct net_pkt *pkt,
+					      struct net_ipv4_hdr *hdr);
+#else
+static inline enum net_verdict net_ipv4_handle_fragment_hdr(
+						struct net_pkt *pkt,
+						struct net_ipv4_hdr *hdr)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(hdr);
+
+	return NET_DROP;
+}
+#endif
+
+/**
+ * @typedef net_ipv4_frag_cb_t
+ * @brief Callback used while iterating over pending IPv4 fragments.
+ *
+ * @param reass IPv4 fragment reassembly struct
+ * @param user_data A valid pointer on some user data or NULL
+ */
+typedef void (*net_ipv4_frag_cb_t)(struct net_reassembly *reass,
+				   void *user_data);
+
+/**
+ * @brief Go through all the currently pending IPv4 fragments.
+ *
+ * @param cb Callback to call for each pending IPv4 fragment.
+ * @param user_data User specified data or NULL.
+ */
+void net_ipv4_frag_foreach(net_ipv4_frag_cb_t cb, void *user_data);
+
 #endif /* __IPV4_H */
@@ -0,0 +1,129 @@
+/** @file
+ * @brief IPv4 Fragment related functions
+ */
+
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_ipv4, CONFIG_NET_IPV4_LOG_LEVEL);
+
+#include <errno.h>
+#include <sys/byteorder.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include "net_private.h"
+#include "ipv4.h"
+#include "reassembly.h"
+
+#define IPV4_FRAGMENT_OFFSET_MASK 0x1fff
+
+static void reassemble_packet(struct net_pkt *pkt)
+{
+	NET_PKT_DATA_ACCESS_CONTIGUOUS_DEFINE(ipv4_access, struct net_ipv4_hdr);
+	struct net_ipv4_hdr *hdr;
+
+	/* The fragments are checked against the length of their own header,
+	 * the header of the first one can be longer.
+	 */
+	if (net_pkt_get_len(pkt) > UINT16_MAX) {
+		NET_DBG("DROP: reassembled packet too long");
+		goto error;
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	hdr = (struct net_ipv4_hdr *)net_pkt_get_data(pkt, &ipv4_access);
+	if (!hdr) {
+		goto error;
+	}
+
+	/* The headers of the first fragment are kept, only the length and
+	 * the fragmentation fields need to be fixed.
+	 */
+	hdr->len = htons(net_pkt_get_len(pkt));
+	hdr->offset[0] = 0U;
+	hdr->offset[1] = 0U;
+	hdr->chksum = 0U;
+	hdr->chksum = net_calc_chksum_ipv4(pkt);
+
+	net_pkt_set_data(pkt, &ipv4_access);
+	net_pkt_cursor_init(pkt);
+
+	NET_DBG("New pkt %p IPv4 len is %d bytes", pkt,
+		net_pkt_get_len(pkt));
+
+	/* As with IPv6, the packet is fed back through the queue and it must
+	 * not be passed to L2 as it has no link layer header anymore.
+	 */
+	net_pkt_set_reassembled(pkt, true);
+
+	if (net_recv_data(net_pkt_iface(pkt), pkt) >= 0) {
+		return;
+	}
+error:
+	net_pkt_unref(pkt);
+}
+
+void net_ipv4_frag_foreach(net_ipv4_frag_cb_t cb, void *user_data)
+{
+	net_reass_foreach(AF_INET, cb, user_data);
+}
+
+enum net_verdict net_ipv4_handle_fragment_hdr(struct net_pkt *pkt,
+					      struct net_ipv4_hdr *hdr)
+{
+	struct net_reass_key key = { 0 };
+	struct net_pkt *datagram;
+	uint16_t hdr_len;
+	uint16_t offset;
+	uint16_t flag;
+	size_t end;
+	bool more;
+	int ret;
+
+	flag = sys_get_be16(hdr->offset);
+	more = flag & (NET_IPV4_MF << 13);
+	hdr_len = (hdr->vhl & NET_IPV4_IHL_MASK) * 4U;
+	offset = (flag & IPV4_FRAGMENT_OFFSET_MASK) * 8U;
+
+	if (net_pkt_get_len(pkt) <= hdr_len) {
+		NET_DBG("DROP: empty fragment");
+		return NET_DROP;
+	}
+
+	/* All fragments but the last one carry a multiple of 8 bytes */
+	if (more && (net_pkt_get_len(pkt) - hdr_len) % 8) {
+		NET_DBG("DROP: fragment length not multiple of 8");
+		return NET_DROP;
+	}
+
+	/* The reassembled packet must fit the IPv4 total length */
+	end = offset + net_pkt_get_len(pkt) - hdr_len;
+	if (hdr_len + end > UINT16_MAX) {
+		NET_DBG("DROP: fragment ends past %u bytes", UINT16_MAX);
+		return NET_DROP;
+	}
+
+	net_ipaddr_copy(&key.src.in, &hdr->src);
+	net_ipaddr_copy(&key.dst.in, &hdr->dst);
+	key.id = sys_get_be16(hdr->id);
+	key.family = AF_INET;
+	key.proto = hdr->proto;
+
+	ret = net_reass_add(&key, pkt, hdr_len, offset, more, &datagram);
+	if (ret < 0) {
+		NET_DBG("Fragment of id 0x%x dropped (%d)", key.id, ret);
+		return NET_DROP;
+	}
+
+	if (datagram) {
+		reassemble_packet(datagram);
+	}
+
+	return NET_OK;
+}
@@ -29,6 +29,7 @@ LOG_MODULE_REGISTER(net_ipv6, CONFIG_NET_IPV6_LOG_LEVEL);
 #include "icmpv6.h"
 #include "udp_internal.h"
 #include "tcp_internal.h"
+#include "gro.h"
 #include "ipv6.h"
 #include "nbr.h"
 #include "6lo.h"
@@ -651,6 +652,13 @@ enum net_verdict net_ipv6_input(struct net_pkt *pkt, bool is_loopback)
 
 	ip.ipv6 = hdr;
 
+	if (nexthdr == IPPROTO_TCP) {
+		verdict = net_gro_input(pkt, &ip, &proto_hdr);
+		if (verdict != NET_CONTINUE) {
+			return verdict;
+		}
+	}
+
 	verdict = net_conn_input(pkt, &ip, nexthdr, &proto_hdr);
 	if (verdict != NET_DROP) {
 		return verdict;
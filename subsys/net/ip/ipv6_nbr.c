@@ -255,6 +255,82 @@ void nbr_print(void)
 #define nbr_print(...)
 #endif
 
+#if defined(CONFIG_NET_IPV6_LOOKUP_HASH)
+/* Neighbors hashed by their IPv6 address. The entries are neighbor pool
+ * indexes plus one, so that zero marks the end of a chain.
+ */
+static uint8_t nbr_hash_head[CONFIG_NET_IPV6_MAX_NEIGHBORS];
+static uint8_t nbr_hash_next[CONFIG_NET_IPV6_MAX_NEIGHBORS];
+
+static inline uint8_t nbr_index(struct net_nbr *nbr)
+{
+	return ((uint8_t *)nbr - (uint8_t *)net_neighbor_pool) /
+		sizeof(net_neighbor_pool[0]);
+}
+
+static inline uint8_t *nbr_hash_bucket(const struct in6_addr *addr)
+{
+	return &nbr_hash_head[net_ipv6_addr_hash(addr) %
+			      CONFIG_NET_IPV6_MAX_NEIGHBORS];
+}
+
+static void nbr_hash_add(struct net_nbr *nbr)
+{
+	uint8_t *head = nbr_hash_bucket(&net_ipv6_nbr_data(nbr)->addr);
+	uint8_t idx = nbr_index(nbr);
+
+	nbr_hash_next[idx] = *head;
+	*head = idx + 1;
+}
+
+static void nbr_hash_del(struct net_nbr *nbr)
+{
+	uint8_t *link = nbr_hash_bucket(&net_ipv6_nbr_data(nbr)->addr);
+	uint8_t idx = nbr_index(nbr);
+
+	while (*link) {
+		if (*link == idx + 1) {
+			*link = nbr_hash_next[idx];
+			nbr_hash_next[idx] = 0U;
+			break;
+		}
+
+		link = &nbr_hash_next[*link - 1];
+	}
+}
+
+static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
+				  struct net_if *iface,
+				  const struct in6_addr *addr)
+{
+	uint8_t entry = *nbr_hash_bucket(addr);
+
+	ARG_UNUSED(table);
+
+	while (entry) {
+		struct net_nbr *nbr = get_nbr(entry - 1);
+
+		entry = nbr_hash_next[entry - 1];
+
+		if (!nbr->ref) {
+			continue;
+		}
+
+		if (iface && nbr->iface != iface) {
+			continue;
+		}
+
+		if (net_ipv6_addr_cmp(&net_ipv6_nbr_data(nbr)->addr, addr)) {
+			return nbr;
+		}
+	}
+
+	return NULL;
+}
+#else
+#define nbr_hash_add(...)
+#define nbr_hash_del(...)
+
 static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 				  struct net_if *iface,
 				  const struct in6_addr *addr)
@@ -279,6 +355,7 @@ static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 
 	return NULL;
 }
+#endif /* CONFIG_NET_IPV6_LOOKUP_HASH */
 
 static inline void nbr_clear_ns_pending(struct net_ipv6_nbr_data *data)
 {
@@ -408,6 +485,7 @@ static void nbr_init(struct net_nbr *nbr, struct net_if *iface,
 	nbr->iface = iface;
 
 	net_ipaddr_copy(&net_ipv6_nbr_data(nbr)->addr, addr);
+	nbr_hash_add(nbr);
 	ipv6_nbr_set_state(nbr, state);
 	net_ipv6_nbr_data(nbr)->is_router = is_router;
 	net_ipv6_nbr_data(nbr)->pending = NULL;
@@ -653,7 +731,7 @@ void net_neighbor_data_remove(struct net_nbr *nbr)
 {
 	NET_DBG("Neighbor %p removed", nbr);
 
-	return;
+	nbr_hash_del(nbr);
 }
 
 void net_neighbor_table_clear(struct net_nbr_table *table)
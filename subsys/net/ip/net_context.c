@@ -255,6 +255,15 @@ int net_context_get(sa_family_t family,
 			continue;
 		}
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+		/* Packets of a previous user of the slot may still be charged
+		 * to it, the counters must not be reset under them.
+		 */
+		if (atomic_get(&contexts[i].pkt_usage.pkts)) {
+			continue;
+		}
+#endif
+
 		memset(&contexts[i], 0, sizeof(contexts[i]));
 	/* FIXME - Figure out a way to get the correct network interface
 	 * as it is not known at this point yet.
@@ -1245,15 +1254,22 @@ static int get_context_sndtimeo(struct net_context *context,
 #endif
 }
 
-/* If buf is not NULL, then use it. Otherwise read the data to be written
- * to net_pkt from msghdr.
+/* If frags is not NULL, then link it to the packet without copying. If buf
+ * is not NULL, then use it. Otherwise read the data to be written to net_pkt
+ * from msghdr.
  */
 static int context_write_data(struct net_pkt *pkt, const void *buf,
-			      int buf_len, const struct msghdr *msghdr)
+			      int buf_len, const struct msghdr *msghdr,
+			      struct net_buf *frags)
 {
 	int ret = 0;
 
-	if (msghdr) {
+	if (frags) {
+		/* The packet gets its own reference so that the caller
+		 * still owns the fragments if the send fails.
+		 */
+		net_pkt_append_buffer(pkt, net_buf_ref(frags));
+	} else if (msghdr) {
 		int i;
 
 		for (i = 0; i < msghdr->msg_iovlen; i++) {
@@ -1275,6 +1291,7 @@ static int context_setup_udp_packet(struct net_context *context,
 				    const void *buf,
 				    size_t len,
 				    const struct msghdr *msg,
+				    struct net_buf *frags,
 				    const struct sockaddr *dst_addr,
 				    socklen_t addrlen)
 {
@@ -1316,7 +1333,7 @@ static int context_setup_udp_packet(struct net_context *context,
 		return ret;
 	}
 
-	ret = context_write_data(pkt, buf, len, msg);
+	ret = context_write_data(pkt, buf, len, msg, frags);
 	if (ret) {
 		return ret;
 	}
@@ -1368,6 +1385,24 @@ static struct net_pkt *context_alloc_pkt(struct net_context *context,
 		return pkt;
 	}
 #endif
+#if defined(CONFIG_NET_PKT_QUOTA)
+	/* The context is set before the data is allocated so that its
+	 * usage of the pools is accounted.
+	 */
+	pkt = net_pkt_alloc_on_iface(net_context_get_iface(context), timeout);
+	if (!pkt) {
+		return NULL;
+	}
+
+	net_pkt_set_family(pkt, net_context_get_family(context));
+	net_pkt_set_context(pkt, context);
+
+	if (net_pkt_alloc_buffer(pkt, len, net_context_get_ip_proto(context),
+				 timeout)) {
+		net_pkt_unref(pkt);
+		return NULL;
+	}
+#else
 	pkt = net_pkt_alloc_with_buffer(net_context_get_iface(context), len,
 					net_context_get_family(context),
 					net_context_get_ip_proto(context),
@@ -1375,6 +1410,7 @@ static struct net_pkt *context_alloc_pkt(struct net_context *context,
 	if (pkt) {
 		net_pkt_set_context(pkt, context);
 	}
+#endif
 
 	return pkt;
 }
@@ -1399,6 +1435,7 @@ static void set_pkt_txtime(struct net_pkt *pkt, const struct msghdr *msghdr)
 static int context_sendto(struct net_context *context,
 			  const void *buf,
 			  size_t len,
+			  struct net_buf *frags,
 			  const struct sockaddr *dst_addr,
 			  socklen_t addrlen,
 			  net_context_send_cb_t cb,
@@ -1614,15 +1651,27 @@ static int context_sendto(struct net_context *context,
 		return -ENETDOWN;
 	}
 
-	pkt = context_alloc_pkt(context, len, PKT_WAIT_TIME);
-	if (!pkt) {
-		return -ENOBUFS;
-	}
+	if (frags) {
+		/* Only the headers need to be allocated, the payload is
+		 * already in the caller supplied fragments.
+		 */
+		len = net_buf_frags_len(frags);
 
-	tmp_len = net_pkt_available_payload_buffer(
+		pkt = context_alloc_pkt(context, 0, PKT_WAIT_TIME);
+		if (!pkt) {
+			return -ENOBUFS;
+		}
+	} else {
+		pkt = context_alloc_pkt(context, len, PKT_WAIT_TIME);
+		if (!pkt) {
+			return -ENOBUFS;
+		}
+
+		tmp_len = net_pkt_available_payload_buffer(
 				pkt, net_context_get_ip_proto(context));
-	if (tmp_len < len) {
-		len = tmp_len;
+		if (tmp_len < len) {
+			len = tmp_len;
+		}
 	}
 
 	context->send_cb = cb;
@@ -1651,7 +1700,7 @@ static int context_sendto(struct net_context *context,
 
 	if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
 	    net_if_is_ip_offloaded(net_context_get_iface(context))) {
-		ret = context_write_data(pkt, buf, len, msghdr);
+		ret = context_write_data(pkt, buf, len, msghdr, frags);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1669,7 +1718,7 @@ static int context_sendto(struct net_context *context,
 	} else if (IS_ENABLED(CONFIG_NET_UDP) &&
 	    net_context_get_ip_proto(context) == IPPROTO_UDP) {
 		ret = context_setup_udp_packet(context, pkt, buf, len, msghdr,
-					       dst_addr, addrlen);
+					       frags, dst_addr, addrlen);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1680,7 +1729,7 @@ static int context_sendto(struct net_context *context,
 	} else if (IS_ENABLED(CONFIG_NET_TCP) &&
 		   net_context_get_ip_proto(context) == IPPROTO_TCP) {
 
-		ret = context_write_data(pkt, buf, len, msghdr);
+		ret = context_write_data(pkt, buf, len, msghdr, frags);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1694,7 +1743,7 @@ static int context_sendto(struct net_context *context,
 		ret = net_tcp_send_data(context, cb, user_data);
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) &&
 		   net_context_get_family(context) == AF_PACKET) {
-		ret = context_write_data(pkt, buf, len, msghdr);
+		ret = context_write_data(pkt, buf, len, msghdr, frags);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1710,7 +1759,7 @@ static int context_sendto(struct net_context *context,
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_CAN) &&
 		   net_context_get_family(context) == AF_CAN &&
 		   net_context_get_ip_proto(context) == CAN_RAW) {
-		ret = context_write_data(pkt, buf, len, msghdr);
+		ret = context_write_data(pkt, buf, len, msghdr, frags);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1770,7 +1819,7 @@ int net_context_send(struct net_context *context,
 		addrlen = 0;
 	}
 
-	ret = context_sendto(context, buf, len, &context->remote,
+	ret = context_sendto(context, buf, len, NULL, &context->remote,
 			     addrlen, cb, timeout, user_data, false);
 unlock:
 	k_mutex_unlock(&context->lock);
@@ -1789,7 +1838,7 @@ int net_context_sendmsg(struct net_context *context,
 
 	k_mutex_lock(&context->lock, K_FOREVER);
 
-	ret = context_sendto(context, msghdr, 0, NULL, 0,
+	ret = context_sendto(context, msghdr, 0, NULL, NULL, 0,
 			     cb, timeout, user_data, true);
 
 	k_mutex_unlock(&context->lock);
@@ -1810,7 +1859,7 @@ int net_context_sendto(struct net_context *context,
 
 	k_mutex_lock(&context->lock, K_FOREVER);
 
-	ret = context_sendto(context, buf, len, dst_addr, addrlen,
+	ret = context_sendto(context, buf, len, NULL, dst_addr, addrlen,
 			     cb, timeout, user_data, true);
 
 	k_mutex_unlock(&context->lock);
@@ -1818,6 +1867,57 @@ int net_context_sendto(struct net_context *context,
 	return ret;
 }
 
+#if defined(CONFIG_NET_CONTEXT_ZEROCOPY)
+int net_context_send_buf(struct net_context *context,
+			 struct net_buf *frags,
+			 const struct sockaddr *dst_addr,
+			 socklen_t addrlen,
+			 net_context_send_cb_t cb,
+			 k_timeout_t timeout,
+			 void *user_data)
+{
+	int ret;
+
+	if (!frags) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&context->lock, K_FOREVER);
+
+	if (!dst_addr) {
+		if (!(context->flags & NET_CONTEXT_REMOTE_ADDR_SET)) {
+			ret = -EDESTADDRREQ;
+			goto unlock;
+		}
+
+		dst_addr = &context->remote;
+
+		if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		    net_context_get_family(context) == AF_INET6) {
+			addrlen = sizeof(struct sockaddr_in6);
+		} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
+			   net_context_get_family(context) == AF_INET) {
+			addrlen = sizeof(struct sockaddr_in);
+		} else {
+			ret = -EOPNOTSUPP;
+			goto unlock;
+		}
+	}
+
+	ret = context_sendto(context, NULL, 0, frags, dst_addr, addrlen,
+			     cb, timeout, user_data, true);
+	if (ret >= 0) {
+		/* The stack now holds the only reference to the data */
+		net_buf_unref(frags);
+	}
+
+unlock:
+	k_mutex_unlock(&context->lock);
+
+	return ret;
+}
+#endif /* CONFIG_NET_CONTEXT_ZEROCOPY */
+
 enum net_verdict net_context_packet_received(struct net_conn *conn,
 					     struct net_pkt *pkt,
 					     union net_ip_header *ip_hdr,
@@ -1842,6 +1942,11 @@ enum net_verdict net_context_packet_received(struct net_conn *conn,
 		goto unlock;
 	}
 
+	/* A flooded context must not take the whole RX pool */
+	if (net_pkt_usage_charge_context(pkt, context) < 0) {
+		goto unlock;
+	}
+
 	if (net_context_get_ip_proto(context) == IPPROTO_TCP) {
 		net_stats_update_tcp_recv(net_pkt_iface(pkt),
 					  net_pkt_remaining_data(pkt));
@@ -1954,6 +2059,10 @@ static enum net_verdict net_context_raw_packet_received(
 		return NET_DROP;
 	}
 
+	if (net_pkt_usage_charge_context(pkt, context) < 0) {
+		return NET_DROP;
+	}
+
 	net_context_set_iface(context, net_pkt_iface(pkt));
 	net_pkt_set_context(pkt, context);
 
@@ -68,12 +68,12 @@ static inline enum net_verdict process_data(struct net_pkt *pkt,
 		return ret;
 	}
 
-#if defined(CONFIG_NET_IPV6_FRAGMENT)
+#if defined(CONFIG_NET_REASSEMBLY)
 	/* If the packet is routed back to us when we have reassembled
-	 * an IPv6 packet, then do not pass it to L2 as the packet does
+	 * an IP packet, then do not pass it to L2 as the packet does
 	 * not have link layer headers in it.
 	 */
-	if (net_pkt_ipv6_fragment_start(pkt)) {
+	if (net_pkt_is_reassembled(pkt)) {
 		locally_routed = true;
 	}
 #endif
@@ -99,6 +99,8 @@ static inline enum net_verdict process_data(struct net_pkt *pkt,
 		}
 	}
 
+	net_stats_update_latency(pkt, NET_STATS_LATENCY_RX_L2);
+
 	/* L2 processed, now we can pass IPPROTO_RAW to packet socket: */
 	ret = net_packet_socket_input(pkt, IPPROTO_RAW);
 	if (ret != NET_CONTINUE) {
@@ -306,6 +308,8 @@ int net_send_data(struct net_pkt *pkt)
 		return -EINVAL;
 	}
 
+	net_stats_update_latency(pkt, NET_STATS_LATENCY_TX_TRANSPORT);
+
 #if defined(CONFIG_NET_STATISTICS)
 	switch (net_pkt_family(pkt)) {
 	case AF_INET:
@@ -367,13 +371,14 @@ static void net_rx(struct net_if *iface, struct net_pkt *pkt)
 void net_process_rx_packet(struct net_pkt *pkt)
 {
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
+	net_stats_update_latency(pkt, NET_STATS_LATENCY_RX_QUEUE);
 
 	net_capture_pkt(net_pkt_iface(pkt), pkt);
 
 	net_rx(net_pkt_iface(pkt), pkt);
 }
 
-static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
+static uint8_t net_queue_rx_tc(struct net_if *iface, struct net_pkt *pkt)
 {
 	uint8_t prio = net_pkt_priority(pkt);
 	uint8_t tc = net_rx_priority2tc(prio);
@@ -388,6 +393,13 @@ static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 	NET_DBG("TC %d with prio %d pkt %p", tc, prio, pkt);
 #endif
 
+	return tc;
+}
+
+static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
+{
+	uint8_t tc = net_queue_rx_tc(iface, pkt);
+
 	if (NET_TC_RX_COUNT == 0) {
 		net_process_rx_packet(pkt);
 	} else {
@@ -395,8 +407,7 @@ static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 	}
 }
 
-/* Called by driver when an IP packet has been received */
-int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
+static int net_recv_prepare(struct net_if *iface, struct net_pkt *pkt)
 {
 	if (!pkt || !iface) {
 		return -EINVAL;
@@ -422,11 +433,83 @@ int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 
 	net_pkt_set_iface(pkt, iface);
 
+	net_stats_update_latency(pkt, NET_STATS_LATENCY_RX_DRIVER);
+
+	return 0;
+}
+
+int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
+{
+	int ret;
+
+	ret = net_recv_prepare(iface, pkt);
+	if (ret < 0) {
+		return ret;
+	}
+
 	net_queue_rx(iface, pkt);
 
 	return 0;
 }
 
+int net_recv_data_batch(struct net_if *iface, struct net_pkt **pkts,
+			size_t count)
+{
+#if NET_TC_RX_COUNT > 0
+	sys_slist_t lists[NET_TC_RX_COUNT];
+#endif
+	int queued = 0;
+	size_t i;
+
+	if (!iface || !pkts) {
+		return -EINVAL;
+	}
+
+	if (!net_if_flag_is_set(iface, NET_IF_UP)) {
+		return -ENETDOWN;
+	}
+
+#if NET_TC_RX_COUNT > 0
+	for (i = 0; i < ARRAY_SIZE(lists); i++) {
+		sys_slist_init(&lists[i]);
+	}
+#endif
+
+	for (i = 0; i < count; i++) {
+		struct net_pkt *pkt = pkts[i];
+		uint8_t tc;
+
+		if (net_recv_prepare(iface, pkt) < 0) {
+			if (pkt) {
+				net_pkt_unref(pkt);
+			}
+
+			continue;
+		}
+
+		tc = net_queue_rx_tc(iface, pkt);
+		queued++;
+
+#if NET_TC_RX_COUNT > 0
+		/* The first word of the packet is reserved for the fifo */
+		sys_slist_append(&lists[tc], (sys_snode_t *)pkt);
+#else
+		ARG_UNUSED(tc);
+		net_process_rx_packet(pkt);
+#endif
+	}
+
+#if NET_TC_RX_COUNT > 0
+	for (i = 0; i < ARRAY_SIZE(lists); i++) {
+		if (!sys_slist_is_empty(&lists[i])) {
+			net_tc_submit_list_to_rx_queue(i, &lists[i]);
+		}
+	}
+#endif
+
+	return queued;
+}
+
 static inline void l3_init(void)
 {
 	net_icmpv4_init();
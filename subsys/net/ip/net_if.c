@@ -77,6 +77,17 @@ static struct {
 	struct net_if_ipv6 ipv6;
 	struct net_if *iface;
 } ipv6_addresses[CONFIG_NET_IF_MAX_IPV6_COUNT];
+
+#if defined(CONFIG_NET_IPV6_LOOKUP_HASH)
+/* Open addressing hash table of the unicast addresses. The entries are
+ * indexes to the unicast address arrays plus one, zero means a free slot.
+ * The table is twice the size of all the addresses so it never gets full.
+ */
+#define IPV6_ADDR_SLOTS (CONFIG_NET_IF_MAX_IPV6_COUNT * NET_IF_MAX_IPV6_ADDR)
+#define IPV6_ADDR_HASH_SIZE (2 * IPV6_ADDR_SLOTS)
+
+static uint16_t ipv6_addr_hash[IPV6_ADDR_HASH_SIZE];
+#endif
 #endif /* CONFIG_NET_IPV6 */
 
 #if defined(CONFIG_NET_NATIVE_IPV4)
@@ -257,8 +268,21 @@ static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
 			}
 		}
 
+		if (IS_ENABLED(CONFIG_NET_PKT_LATENCY_STATS)) {
+			/* Keep the packet over L2 send so that the driver
+			 * time can be recorded.
+			 */
+			net_pkt_ref(pkt);
+		}
+
 		status = net_if_l2(iface)->send(iface, pkt);
 
+		if (IS_ENABLED(CONFIG_NET_PKT_LATENCY_STATS)) {
+			net_stats_update_latency(pkt,
+						 NET_STATS_LATENCY_TX_DRIVER);
+			net_pkt_unref(pkt);
+		}
+
 		if (IS_ENABLED(CONFIG_NET_PKT_TXTIME_STATS)) {
 			uint32_t end_tick = k_cycle_get_32();
 
@@ -321,6 +345,7 @@ void net_process_tx_packet(struct net_pkt *pkt)
 	struct net_if *iface;
 
 	net_pkt_set_tx_stats_tick(pkt, k_cycle_get_32());
+	net_stats_update_latency(pkt, NET_STATS_LATENCY_TX_QUEUE);
 
 	iface = net_pkt_iface(pkt);
 
@@ -336,6 +361,8 @@ void net_if_queue_tx(struct net_if *iface, struct net_pkt *pkt)
 	uint8_t prio = net_pkt_priority(pkt);
 	uint8_t tc = net_tx_priority2tc(prio);
 
+	net_stats_update_latency(pkt, NET_STATS_LATENCY_TX_IP);
+
 	net_stats_update_tc_sent_pkt(iface, tc);
 	net_stats_update_tc_sent_bytes(iface, tc, net_pkt_get_len(pkt));
 	net_stats_update_tc_sent_priority(iface, tc, prio);
@@ -347,6 +374,7 @@ void net_if_queue_tx(struct net_if *iface, struct net_pkt *pkt)
 	if ((IS_ENABLED(CONFIG_NET_TC_SKIP_FOR_HIGH_PRIO) &&
 	     prio == NET_PRIORITY_CA) || NET_TC_TX_COUNT == 0) {
 		net_pkt_set_tx_stats_tick(pkt, k_cycle_get_32());
+		net_stats_update_latency(pkt, NET_STATS_LATENCY_TX_QUEUE);
 
 		net_if_tx(net_pkt_iface(pkt), pkt);
 		return;
@@ -921,6 +949,119 @@ static void iface_router_init(void)
 #endif
 
 #if defined(CONFIG_NET_NATIVE_IPV6)
+#if defined(CONFIG_NET_IPV6_LOOKUP_HASH)
+static struct net_if_addr *ipv6_addr_hash_entry(uint16_t entry,
+						struct net_if **iface)
+{
+	int idx = (entry - 1) / NET_IF_MAX_IPV6_ADDR;
+
+	*iface = ipv6_addresses[idx].iface;
+
+	return &ipv6_addresses[idx].ipv6.unicast[(entry - 1) %
+						 NET_IF_MAX_IPV6_ADDR];
+}
+
+static void ipv6_addr_hash_insert(uint16_t entry)
+{
+	struct net_if_addr *ifaddr;
+	struct net_if *iface;
+	int pos;
+
+	ifaddr = ipv6_addr_hash_entry(entry, &iface);
+	pos = net_ipv6_addr_hash(&ifaddr->address.in6_addr) %
+		IPV6_ADDR_HASH_SIZE;
+
+	while (ipv6_addr_hash[pos]) {
+		pos = (pos + 1) % IPV6_ADDR_HASH_SIZE;
+	}
+
+	ipv6_addr_hash[pos] = entry;
+}
+
+static uint16_t ipv6_addr_hash_id(struct net_if_ipv6 *ipv6,
+				  struct net_if_addr *ifaddr)
+{
+	int idx = CONTAINER_OF(ipv6, __typeof__(ipv6_addresses[0]), ipv6) -
+		ipv6_addresses;
+
+	return idx * NET_IF_MAX_IPV6_ADDR + (ifaddr - ipv6->unicast) + 1;
+}
+
+static void ipv6_addr_hash_add(struct net_if_ipv6 *ipv6,
+			       struct net_if_addr *ifaddr)
+{
+	ipv6_addr_hash_insert(ipv6_addr_hash_id(ipv6, ifaddr));
+}
+
+static void ipv6_addr_hash_del(struct net_if_ipv6 *ipv6,
+			       struct net_if_addr *ifaddr)
+{
+	uint16_t entry = ipv6_addr_hash_id(ipv6, ifaddr);
+	int pos, i;
+
+	pos = net_ipv6_addr_hash(&ifaddr->address.in6_addr) %
+		IPV6_ADDR_HASH_SIZE;
+
+	for (i = 0; i < IPV6_ADDR_HASH_SIZE && ipv6_addr_hash[pos]; i++) {
+		if (ipv6_addr_hash[pos] == entry) {
+			break;
+		}
+
+		pos = (pos + 1) % IPV6_ADDR_HASH_SIZE;
+	}
+
+	if (ipv6_addr_hash[pos] != entry) {
+		return;
+	}
+
+	ipv6_addr_hash[pos] = 0U;
+
+	/* Re-insert the rest of the cluster so that no lookup stops at the
+	 * slot that was just freed.
+	 */
+	pos = (pos + 1) % IPV6_ADDR_HASH_SIZE;
+
+	while (ipv6_addr_hash[pos]) {
+		entry = ipv6_addr_hash[pos];
+		ipv6_addr_hash[pos] = 0U;
+
+		ipv6_addr_hash_insert(entry);
+
+		pos = (pos + 1) % IPV6_ADDR_HASH_SIZE;
+	}
+}
+
+static struct net_if_addr *ipv6_addr_hash_lookup(const struct in6_addr *addr,
+						 struct net_if **ret)
+{
+	struct net_if_addr *ifaddr;
+	struct net_if *iface;
+	int pos;
+
+	pos = net_ipv6_addr_hash(addr) % IPV6_ADDR_HASH_SIZE;
+
+	while (ipv6_addr_hash[pos]) {
+		ifaddr = ipv6_addr_hash_entry(ipv6_addr_hash[pos], &iface);
+
+		if (iface && ifaddr->is_used &&
+		    net_ipv6_addr_cmp(addr, &ifaddr->address.in6_addr)) {
+			if (ret) {
+				*ret = iface;
+			}
+
+			return ifaddr;
+		}
+
+		pos = (pos + 1) % IPV6_ADDR_HASH_SIZE;
+	}
+
+	return NULL;
+}
+#else
+#define ipv6_addr_hash_add(...)
+#define ipv6_addr_hash_del(...)
+#endif /* CONFIG_NET_IPV6_LOOKUP_HASH */
+
 int net_if_config_ipv6_get(struct net_if *iface, struct net_if_ipv6 **ipv6)
 {
 	int ret = 0;
@@ -981,10 +1122,22 @@ int net_if_config_ipv6_put(struct net_if *iface)
 	}
 
 	for (i = 0; i < ARRAY_SIZE(ipv6_addresses); i++) {
+		int j;
+
 		if (ipv6_addresses[i].iface != iface) {
 			continue;
 		}
 
+		/* The hash entries point to this config, drop them before
+		 * the config can be given to another interface.
+		 */
+		for (j = 0; j < NET_IF_MAX_IPV6_ADDR; j++) {
+			if (ipv6_addresses[i].ipv6.unicast[j].is_used) {
+				ipv6_addr_hash_del(&ipv6_addresses[i].ipv6,
+					&ipv6_addresses[i].ipv6.unicast[j]);
+			}
+		}
+
 		iface->config.ip.ipv6 = NULL;
 		ipv6_addresses[i].iface = NULL;
 
@@ -1381,6 +1534,9 @@ struct net_if_addr *net_if_ipv6_addr_lookup(const struct in6_addr *addr,
 
 	k_mutex_lock(&lock, K_FOREVER);
 
+#if defined(CONFIG_NET_IPV6_LOOKUP_HASH)
+	ifaddr = ipv6_addr_hash_lookup(addr, ret);
+#else
 	Z_STRUCT_SECTION_FOREACH(net_if, iface) {
 		struct net_if_ipv6 *ipv6 = iface->config.ip.ipv6;
 		int i;
@@ -1411,6 +1567,7 @@ struct net_if_addr *net_if_ipv6_addr_lookup(const struct in6_addr *addr,
 	}
 
 out:
+#endif /* CONFIG_NET_IPV6_LOOKUP_HASH */
 	k_mutex_unlock(&lock);
 
 	return ifaddr;
@@ -1582,6 +1739,7 @@ static struct net_if_addr *ipv6_addr_find(struct net_if *iface,
 	return NULL;
 }
 
+
 static inline void net_if_addr_init(struct net_if_addr *ifaddr,
 				    struct in6_addr *addr,
 				    enum net_addr_type addr_type,
@@ -1634,6 +1792,7 @@ struct net_if_addr *net_if_ipv6_addr_add(struct net_if *iface,
 
 		net_if_addr_init(&ipv6->unicast[i], addr, addr_type,
 				 vlifetime);
+		ipv6_addr_hash_add(ipv6, &ipv6->unicast[i]);
 
 		NET_DBG("[%d] interface %p address %s type %s added", i,
 			iface, log_strdup(net_sprint_ipv6_addr(addr)),
@@ -1715,6 +1874,7 @@ bool net_if_ipv6_addr_rm(struct net_if *iface, const struct in6_addr *addr)
 			}
 		}
 
+		ipv6_addr_hash_del(ipv6, &ipv6->unicast[i]);
 		ipv6->unicast[i].is_used = false;
 
 		net_ipv6_addr_create_solicited_node(addr, &maddr);
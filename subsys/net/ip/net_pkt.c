@@ -493,6 +493,301 @@ static inline struct net_buf_pool *get_data_pool(struct net_context *context)
 #define get_data_pool(...) NULL
 #endif /* CONFIG_NET_CONTEXT_NET_PKT_POOL */
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+
+/* Owners of the usage counters charged for a packet, the quotas are given
+ * in the same order.
+ */
+enum {
+	USAGE_IFACE,
+	USAGE_CONTEXT,
+	USAGE_TC,
+	USAGE_TOTAL,
+};
+
+static const uint8_t usage_quotas[] = {
+	[USAGE_IFACE] = CONFIG_NET_PKT_QUOTA_IFACE,
+	[USAGE_CONTEXT] = CONFIG_NET_PKT_QUOTA_CONTEXT,
+	[USAGE_TC] = CONFIG_NET_PKT_QUOTA_TC,
+};
+
+BUILD_ASSERT(ARRAY_SIZE(usage_quotas) == USAGE_TOTAL);
+BUILD_ASSERT(ARRAY_SIZE(((struct net_pkt *)0)->usage) == USAGE_TOTAL + 1);
+
+static struct net_pkt_usage rx_usage;
+static struct net_pkt_usage tx_usage;
+static struct net_pkt_usage rx_tc_usage[MAX(NET_TC_RX_COUNT, 1)];
+static struct net_pkt_usage tx_tc_usage[MAX(NET_TC_TX_COUNT, 1)];
+
+static void iface_count_cb(struct net_if *iface, void *user_data)
+{
+	int *count = user_data;
+
+	(*count)++;
+}
+
+/* Without a configured share, the interfaces share the pools evenly. They
+ * are counted each time as some are only brought up later, and this only
+ * runs when the pools run low.
+ */
+static int usage_quota(int owner)
+{
+	int count = 0;
+
+	if (owner != USAGE_IFACE || CONFIG_NET_PKT_QUOTA_IFACE) {
+		return usage_quotas[owner];
+	}
+
+	net_if_foreach(iface_count_cb, &count);
+
+	return 100 / MAX(count, 1);
+}
+
+static bool usage_exceeds(const struct net_pkt_usage *usage, int percent,
+			  int pkts, int max_pkts, int bufs, int max_bufs)
+{
+	return (atomic_get(&usage->pkts) + pkts) * 100 > max_pkts * percent ||
+	       (atomic_get(&usage->bufs) + bufs) * 100 > max_bufs * percent;
+}
+
+/* Find the counters to charge for a packet. Only the predefined pools are
+ * accounted, the pools of a context are not shared.
+ */
+static bool pkt_usage_owners(struct net_pkt *pkt, struct net_buf_pool *pool,
+			     struct net_pkt_usage **owners)
+{
+	struct net_if *iface = net_pkt_iface(pkt);
+	bool is_rx;
+
+	if (pkt->slab == &rx_pkts && pool == &rx_bufs) {
+		is_rx = true;
+	} else if (pkt->slab == &tx_pkts && pool == &tx_bufs) {
+		is_rx = false;
+	} else {
+		return false;
+	}
+
+	/* Once charged, a packet keeps its owners until it is freed */
+	if (pkt->usage[USAGE_TOTAL]) {
+		memcpy(owners, pkt->usage, sizeof(pkt->usage));
+		return true;
+	}
+
+	if (is_rx) {
+		owners[USAGE_IFACE] = iface ? &iface->rx_pkt_usage : NULL;
+		owners[USAGE_TC] = &rx_tc_usage[
+			net_rx_priority2tc(net_pkt_priority(pkt))];
+		owners[USAGE_TOTAL] = &rx_usage;
+	} else {
+		owners[USAGE_IFACE] = iface ? &iface->tx_pkt_usage : NULL;
+		owners[USAGE_TC] = &tx_tc_usage[
+			net_tx_priority2tc(net_pkt_priority(pkt))];
+		owners[USAGE_TOTAL] = &tx_usage;
+	}
+
+	owners[USAGE_CONTEXT] = pkt->context ? &pkt->context->pkt_usage : NULL;
+
+	return true;
+}
+
+static bool pkt_usage_check(struct net_pkt *pkt, struct net_buf_pool *pool,
+			    size_t size)
+{
+	struct net_pkt_usage *owners[ARRAY_SIZE(pkt->usage)];
+	int pkts, bufs;
+	int i;
+
+	if (!pkt_usage_owners(pkt, pool, owners)) {
+		return true;
+	}
+
+	pkts = pkt->usage[USAGE_TOTAL] ? 0 : 1;
+
+#if defined(CONFIG_NET_BUF_FIXED_DATA_SIZE)
+	bufs = ceiling_fraction(size, CONFIG_NET_BUF_DATA_SIZE);
+#else
+	bufs = 1;
+#endif
+
+	/* The quotas only apply when the pools run low */
+	if (!usage_exceeds(owners[USAGE_TOTAL],
+			   100 - CONFIG_NET_PKT_QUOTA_PRESSURE,
+			   pkts, pkt->slab->num_blocks, bufs, pool->buf_count)) {
+		return true;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(usage_quotas); i++) {
+		if (owners[i] &&
+		    usage_exceeds(owners[i], usage_quota(i), pkts,
+				  pkt->slab->num_blocks, bufs,
+				  pool->buf_count)) {
+			NET_DBG("pkt %p over quota %d", pkt, i);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void pkt_usage_charge(struct net_pkt *pkt, struct net_buf_pool *pool,
+			     struct net_buf *buf)
+{
+	struct net_pkt_usage *owners[ARRAY_SIZE(pkt->usage)];
+	bool first = !pkt->usage[USAGE_TOTAL];
+	int bufs = 0;
+	int i;
+
+	if (!pkt_usage_owners(pkt, pool, owners)) {
+		return;
+	}
+
+	for (; buf; buf = buf->frags) {
+		bufs++;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(owners); i++) {
+		if (!owners[i]) {
+			continue;
+		}
+
+		if (first) {
+			atomic_inc(&owners[i]->pkts);
+		}
+
+		atomic_add(&owners[i]->bufs, bufs);
+	}
+
+	memcpy(pkt->usage, owners, sizeof(pkt->usage));
+	pkt->usage_bufs += bufs;
+}
+
+static void pkt_usage_release(struct net_pkt *pkt)
+{
+	int i;
+
+	if (!pkt->usage[USAGE_TOTAL]) {
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(pkt->usage); i++) {
+		if (!pkt->usage[i]) {
+			continue;
+		}
+
+		atomic_dec(&pkt->usage[i]->pkts);
+		atomic_sub(&pkt->usage[i]->bufs, pkt->usage_bufs);
+	}
+}
+
+static bool usage_pools(struct net_pkt *pkt, struct k_mem_slab **slab,
+			struct net_buf_pool **pool)
+{
+	if (pkt->usage[USAGE_TOTAL] == &rx_usage) {
+		*slab = &rx_pkts;
+		*pool = &rx_bufs;
+	} else if (pkt->usage[USAGE_TOTAL] == &tx_usage) {
+		*slab = &tx_pkts;
+		*pool = &tx_bufs;
+	} else {
+		return false;
+	}
+
+	return true;
+}
+
+int net_pkt_usage_charge_context(struct net_pkt *pkt,
+				 struct net_context *context)
+{
+	struct net_pkt_usage *usage = &context->pkt_usage;
+	struct net_buf_pool *pool;
+	struct k_mem_slab *slab;
+
+	/* Received packets get their data before they are demultiplexed */
+	if (pkt->usage[USAGE_CONTEXT] || !usage_pools(pkt, &slab, &pool)) {
+		return 0;
+	}
+
+	if (usage_exceeds(pkt->usage[USAGE_TOTAL],
+			  100 - CONFIG_NET_PKT_QUOTA_PRESSURE,
+			  0, slab->num_blocks, 0, pool->buf_count) &&
+	    usage_exceeds(usage, CONFIG_NET_PKT_QUOTA_CONTEXT, 1,
+			  slab->num_blocks, pkt->usage_bufs,
+			  pool->buf_count)) {
+		NET_DBG("pkt %p over quota of context %p", pkt, context);
+		return -ENOBUFS;
+	}
+
+	atomic_inc(&usage->pkts);
+	atomic_add(&usage->bufs, pkt->usage_bufs);
+	pkt->usage[USAGE_CONTEXT] = usage;
+
+	return 0;
+}
+
+void net_pkt_usage_move(struct net_pkt *dst, struct net_pkt *src,
+			struct net_buf *frags)
+{
+	int bufs = 0;
+	int i;
+
+	if (!src->usage[USAGE_TOTAL]) {
+		return;
+	}
+
+	for (; frags && bufs < src->usage_bufs; frags = frags->frags) {
+		bufs++;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(src->usage); i++) {
+		if (src->usage[i]) {
+			atomic_sub(&src->usage[i]->bufs, bufs);
+		}
+	}
+
+	src->usage_bufs -= bufs;
+
+	/* The buffers come from the predefined pools, so dst is charged
+	 * for them even if it was not allocated from there.
+	 */
+	if (!dst->usage[USAGE_TOTAL]) {
+		memcpy(dst->usage, src->usage, sizeof(dst->usage));
+		dst->usage_bufs = 0U;
+
+		for (i = 0; i < ARRAY_SIZE(dst->usage); i++) {
+			if (dst->usage[i]) {
+				atomic_inc(&dst->usage[i]->pkts);
+			}
+		}
+	}
+
+	for (i = 0; i < ARRAY_SIZE(dst->usage); i++) {
+		if (dst->usage[i]) {
+			atomic_add(&dst->usage[i]->bufs, bufs);
+		}
+	}
+
+	dst->usage_bufs += bufs;
+}
+
+const struct net_pkt_usage *net_pkt_usage_get(bool is_rx)
+{
+	return is_rx ? &rx_usage : &tx_usage;
+}
+
+const struct net_pkt_usage *net_pkt_tc_usage_get(bool is_rx, uint8_t tc)
+{
+	if (is_rx) {
+		return tc < NET_TC_RX_COUNT ? &rx_tc_usage[tc] : NULL;
+	}
+
+	return tc < NET_TC_TX_COUNT ? &tx_tc_usage[tc] : NULL;
+}
+#else
+#define pkt_usage_check(...) true
+#define pkt_usage_charge(...)
+#define pkt_usage_release(...)
+#endif /* CONFIG_NET_PKT_QUOTA */
+
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 void net_pkt_unref_debug(struct net_pkt *pkt, const char *caller, int line)
 {
@@ -582,6 +877,8 @@ done:
 		return;
 	}
 
+	pkt_usage_release(pkt);
+
 	if (pkt->frags) {
 		net_pkt_frag_unref(pkt->frags);
 	}
@@ -857,60 +1154,40 @@ static struct net_buf *pkt_alloc_buffer(struct net_buf_pool *pool,
 					size_t size, k_timeout_t timeout)
 #endif
 {
-	uint64_t end = sys_clock_timeout_end_calc(timeout);
-	struct net_buf *first = NULL;
-	struct net_buf *current = NULL;
+	struct net_buf *first;
+	struct net_buf *current;
 
-	while (size) {
-		struct net_buf *new;
-
-		new = net_buf_alloc_fixed(pool, timeout);
-		if (!new) {
-			goto error;
-		}
+	if (!size) {
+		return NULL;
+	}
 
-		if (!first && !current) {
-			first = new;
-		} else {
-			current->frags = new;
-		}
+	/* All the fragments are taken from the pool in one go, and are given
+	 * back in one go as well when the packet is freed.
+	 */
+	first = net_buf_alloc_chain(pool, size, timeout);
+	if (!first) {
+		return NULL;
+	}
 
-		current = new;
+	for (current = first; current; current = current->frags) {
 		if (current->size > size) {
 			current->size = size;
 		}
 
 		size -= current->size;
 
-		if (!K_TIMEOUT_EQ(timeout, K_NO_WAIT) &&
-		    !K_TIMEOUT_EQ(timeout, K_FOREVER)) {
-			int64_t remaining = end - sys_clock_tick_get();
-
-			if (remaining <= 0) {
-				break;
-			}
-
-			timeout = Z_TIMEOUT_TICKS(remaining);
-		}
-
 #if CONFIG_NET_PKT_LOG_LEVEL >= LOG_LEVEL_DBG
-		NET_FRAG_CHECK_IF_NOT_IN_USE(new, new->ref + 1);
+		NET_FRAG_CHECK_IF_NOT_IN_USE(current, current->ref + 1);
 
-		net_pkt_alloc_add(new, false, caller, line);
+		net_pkt_alloc_add(current, false, caller, line);
 
 		NET_DBG("%s (%s) [%d] frag %p ref %d (%s():%d)",
 			pool2str(pool), get_name(pool), get_frees(pool),
-			new, new->ref, caller, line);
+			current, current->ref, caller, line);
 #endif
 	}
 
 	return first;
-error:
-	if (first) {
-		net_buf_unref(first);
-	}
-
-	return NULL;
 }
 
 #else /* !CONFIG_NET_BUF_FIXED_DATA_SIZE */
@@ -1142,6 +1419,11 @@ int net_pkt_alloc_buffer(struct net_pkt *pkt,
 		pool = pkt->slab == &tx_pkts ? &tx_bufs : &rx_bufs;
 	}
 
+	if (!pkt_usage_check(pkt, pool, alloc_len)) {
+		NET_DBG("Data buffer (%zd) allocation over quota", alloc_len);
+		return -ENOBUFS;
+	}
+
 	if (!K_TIMEOUT_EQ(timeout, K_NO_WAIT) &&
 	    !K_TIMEOUT_EQ(timeout, K_FOREVER)) {
 		int64_t remaining = end - sys_clock_tick_get();
@@ -1169,6 +1451,7 @@ int net_pkt_alloc_buffer(struct net_pkt *pkt,
 		return -ENOMEM;
 	}
 
+	pkt_usage_charge(pkt, pool, buf);
 	net_pkt_append_buffer(pkt, buf);
 
 	return 0;
@@ -1190,7 +1473,8 @@ static struct net_pkt *pkt_alloc(struct k_mem_slab *slab, k_timeout_t timeout)
 	}
 
 	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS) ||
-	    IS_ENABLED(CONFIG_NET_PKT_TXTIME_STATS)) {
+	    IS_ENABLED(CONFIG_NET_PKT_TXTIME_STATS) ||
+	    IS_ENABLED(CONFIG_NET_PKT_LATENCY_STATS)) {
 		create_time = k_cycle_get_32();
 	} else {
 		ARG_UNUSED(create_time);
@@ -1233,6 +1517,10 @@ static struct net_pkt *pkt_alloc(struct k_mem_slab *slab, k_timeout_t timeout)
 		net_pkt_set_create_time(pkt, create_time);
 	}
 
+	if (IS_ENABLED(CONFIG_NET_PKT_LATENCY_STATS)) {
+		net_pkt_set_latency_tick(pkt, create_time);
+	}
+
 	net_pkt_set_vlan_tag(pkt, NET_VLAN_TAG_UNSPEC);
 
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
@@ -1736,9 +2024,11 @@ static void clone_pkt_attributes(struct net_pkt *pkt, struct net_pkt *clone_pkt)
 	net_pkt_set_ip_hdr_len(clone_pkt, net_pkt_ip_hdr_len(pkt));
 	net_pkt_set_vlan_tag(clone_pkt, net_pkt_vlan_tag(pkt));
 	net_pkt_set_timestamp(clone_pkt, net_pkt_timestamp(pkt));
+	net_pkt_set_latency_tick(clone_pkt, net_pkt_latency_tick(pkt));
 	net_pkt_set_priority(clone_pkt, net_pkt_priority(pkt));
 	net_pkt_set_orig_iface(clone_pkt, net_pkt_orig_iface(pkt));
 	net_pkt_set_captured(clone_pkt, net_pkt_is_captured(pkt));
+	net_pkt_set_reassembled(clone_pkt, net_pkt_is_reassembled(pkt));
 
 	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
 		net_pkt_set_ipv4_ttl(clone_pkt, net_pkt_ipv4_ttl(pkt));
@@ -88,8 +88,19 @@ static inline enum net_verdict net_ipv6_input(struct net_pkt *pkt,
 	return NET_CONTINUE;
 }
 #endif
+/* Thread priority of the lowest RX traffic class. This value is used as a
+ * parameter to K_PRIO_COOP() or K_PRIO_PREEMPT(), the higher RX traffic
+ * classes get one step higher priority each.
+ */
+#if defined(CONFIG_NET_TC_THREAD_COOPERATIVE)
+#define NET_TC_RX_BASE_PRIO (CONFIG_NET_TC_NUM_PRIORITIES - 1)
+#else
+#define NET_TC_RX_BASE_PRIO (CONFIG_NET_TC_RX_COUNT - 1)
+#endif
+
 extern bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt);
 extern void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt);
+extern void net_tc_submit_list_to_rx_queue(uint8_t tc, sys_slist_t *list);
 extern enum net_verdict net_promisc_mode_input(struct net_pkt *pkt);
 
 char *net_sprint_addr(sa_family_t af, const void *addr);
@@ -133,6 +144,33 @@ enum net_verdict net_gptp_recv(struct net_if *iface, struct net_pkt *pkt);
 #define net_gptp_recv(iface, pkt) NET_DROP
 #endif /* CONFIG_NET_GPTP */
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+/**
+ * @brief Charge a received packet to the context it is delivered to.
+ *
+ * @param pkt Network packet, charged to its interface already.
+ * @param context Network context the packet is delivered to.
+ *
+ * @return 0 if charged or not accounted, -ENOBUFS if the context is over
+ * its quota and the packet must be dropped.
+ */
+int net_pkt_usage_charge_context(struct net_pkt *pkt,
+				 struct net_context *context);
+
+/**
+ * @brief Move the charge of data buffers detached from a packet.
+ *
+ * @param dst Network packet the buffers are appended to.
+ * @param src Network packet the buffers are detached from.
+ * @param frags Detached buffers.
+ */
+void net_pkt_usage_move(struct net_pkt *dst, struct net_pkt *src,
+			struct net_buf *frags);
+#else
+#define net_pkt_usage_charge_context(pkt, context) 0
+#define net_pkt_usage_move(dst, src, frags)
+#endif /* CONFIG_NET_PKT_QUOTA */
+
 #if defined(CONFIG_NET_IPV6_FRAGMENT)
 int net_ipv6_send_fragmented_pkt(struct net_if *iface, struct net_pkt *pkt,
 				 uint16_t pkt_len);
@@ -203,6 +241,21 @@ static inline uint16_t net_calc_chksum_tcp(struct net_pkt *pkt)
 	return net_calc_chksum(pkt, IPPROTO_TCP);
 }
 
+/* Fold an IPv6 address into a value suitable for hash table indexing */
+static inline uint32_t net_ipv6_addr_hash(const struct in6_addr *addr)
+{
+	uint32_t hash;
+
+	hash = UNALIGNED_GET(&addr->s6_addr32[0]) ^
+		UNALIGNED_GET(&addr->s6_addr32[1]) ^
+		UNALIGNED_GET(&addr->s6_addr32[2]) ^
+		UNALIGNED_GET(&addr->s6_addr32[3]);
+	hash ^= hash >> 16;
+	hash ^= hash >> 8;
+
+	return hash;
+}
+
 static inline char *net_sprint_ll_addr(const uint8_t *ll, uint8_t ll_len)
 {
 	static char buf[sizeof("xx:xx:xx:xx:xx:xx:xx:xx")];
@@ -38,6 +38,7 @@ LOG_MODULE_REGISTER(net_shell, LOG_LEVEL_DBG);
 #endif
 
 #include "ipv6.h"
+#include "ipv4.h"
 
 #if defined(CONFIG_NET_ARP)
 #include "ethernet/arp.h"
@@ -1177,6 +1178,66 @@ static void print_net_pm_stats(const struct shell *shell, struct net_if *iface)
 #endif
 }
 
+static void print_net_latency_stats(const struct shell *shell,
+				    struct net_if *iface)
+{
+#if defined(CONFIG_NET_PKT_LATENCY_STATS)
+	static const char * const stage_str[] = {
+		[NET_STATS_LATENCY_RX_DRIVER] = "RX driver",
+		[NET_STATS_LATENCY_RX_QUEUE] = "RX queue",
+		[NET_STATS_LATENCY_RX_L2] = "RX L2",
+		[NET_STATS_LATENCY_RX_IP] = "RX IP",
+		[NET_STATS_LATENCY_RX_TRANSPORT] = "RX transport",
+		[NET_STATS_LATENCY_RX_SOCKET] = "RX socket",
+		[NET_STATS_LATENCY_TX_TRANSPORT] = "TX transport",
+		[NET_STATS_LATENCY_TX_IP] = "TX IP",
+		[NET_STATS_LATENCY_TX_QUEUE] = "TX queue",
+		[NET_STATS_LATENCY_TX_L2] = "TX L2",
+		[NET_STATS_LATENCY_TX_DRIVER] = "TX driver",
+	};
+	uint64_t limit = CONFIG_NET_PKT_LATENCY_STATS_BUCKET_USEC;
+	int i, j;
+
+	BUILD_ASSERT(ARRAY_SIZE(stage_str) == NET_STATS_LATENCY_STAGE_COUNT);
+
+	PR("Latency histogram (us):\n");
+	PR("%-13s", "Stage");
+
+	for (j = 0; j < CONFIG_NET_PKT_LATENCY_STATS_BUCKETS - 1; j++) {
+		PR(" <%-7llu", limit << j);
+	}
+
+	PR(" >=%-6llu %9s %9s\n", limit << (j - 1), "avg", "max");
+
+	for (i = 0; i < NET_STATS_LATENCY_STAGE_COUNT; i++) {
+		net_stats_t count = 0;
+
+		PR("%-13s", stage_str[i]);
+
+		for (j = 0; j < CONFIG_NET_PKT_LATENCY_STATS_BUCKETS; j++) {
+			net_stats_t val = GET_STAT(iface,
+						   latency[i].bucket[j]);
+
+			count += val;
+			PR(" %-8u", val);
+		}
+
+		if (count == 0) {
+			PR(" %9s %9s\n", "-", "-");
+			continue;
+		}
+
+		PR(" %9u %9u\n",
+		   (uint32_t)k_cyc_to_us_floor64(
+			   GET_STAT(iface, latency[i].sum) / count),
+		   k_cyc_to_us_floor32(GET_STAT(iface, latency[i].max)));
+	}
+#else
+	ARG_UNUSED(shell);
+	ARG_UNUSED(iface);
+#endif
+}
+
 static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 {
 	struct net_shell_user_data *data = user_data;
@@ -1311,6 +1372,7 @@ static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 	}
 #endif /* CONFIG_NET_STATISTICS_PPP && CONFIG_NET_STATISTICS_USER_API */
 
+	print_net_latency_stats(shell, iface);
 	print_net_pm_stats(shell, iface);
 }
 #endif /* CONFIG_NET_STATISTICS */
@@ -1556,49 +1618,30 @@ static void tcp_sent_list_cb(struct tcp *conn, void *user_data)
 #endif /* CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG */
 #endif /* TCP2 */
 
-#if defined(CONFIG_NET_IPV6_FRAGMENT)
-static void ipv6_frag_cb(struct net_ipv6_reassembly *reass,
-			 void *user_data)
+#if defined(CONFIG_NET_IPV6_FRAGMENT) || defined(CONFIG_NET_IPV4_FRAGMENT)
+static void ip_frag_cb(struct net_reassembly *reass, void *user_data)
 {
 	struct net_shell_user_data *data = user_data;
 	const struct shell *shell = data->shell;
 	int *count = data->user_data;
 	char src[ADDR_LEN];
-	int i;
 
 	if (!*count) {
-		PR("\nIPv6 reassembly Id         Remain "
-		   "Src             \tDst\n");
+		PR("\n%s reassembly Id         Remain Frags  Bytes  "
+		   "Src             \tDst\n",
+		   reass->key.family == AF_INET6 ? "IPv6" : "IPv4");
 	}
 
-	snprintk(src, ADDR_LEN, "%s", net_sprint_ipv6_addr(&reass->src));
-
-	PR("%p      0x%08x  %5d %16s\t%16s\n", reass, reass->id,
-	   k_ticks_to_ms_ceil32(k_work_delayable_remaining_get(&reass->timer)),
-	   src, net_sprint_ipv6_addr(&reass->dst));
-
-	for (i = 0; i < NET_IPV6_FRAGMENTS_MAX_PKT; i++) {
-		if (reass->pkt[i]) {
-			struct net_buf *frag = reass->pkt[i]->frags;
-
-			PR("[%d] pkt %p->", i, reass->pkt[i]);
+	snprintk(src, ADDR_LEN, "%s",
+		 net_sprint_addr(reass->key.family, &reass->key.src));
 
-			while (frag) {
-				PR("%p", frag);
-
-				frag = frag->frags;
-				if (frag) {
-					PR("->");
-				}
-			}
-
-			PR("\n");
-		}
-	}
+	PR("%p      0x%08x  %5d %5u  %5u %16s\t%16s\n", reass, reass->key.id,
+	   net_reass_remaining(reass), reass->count, reass->received,
+	   src, net_sprint_addr(reass->key.family, &reass->key.dst));
 
 	(*count)++;
 }
-#endif /* CONFIG_NET_IPV6_FRAGMENT */
+#endif /* CONFIG_NET_IPV6_FRAGMENT || CONFIG_NET_IPV4_FRAGMENT */
 
 #if defined(CONFIG_NET_DEBUG_NET_PKT_ALLOC)
 static void allocs_cb(struct net_pkt *pkt,
@@ -1995,6 +2038,146 @@ static int cmd_net_capture_disable(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+static int cmd_net_capture_local(const struct shell *shell, size_t argc,
+				 char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+	struct net_capture_local_stats stats;
+
+	net_capture_local_get_stats(&stats);
+
+	PR_INFO("Local packet capture %s\n",
+		net_capture_local_is_started() ? "started" : "stopped");
+	PR("Captured    : %u\n", stats.captured);
+	PR("Filtered    : %u\n", stats.filtered);
+	PR("Truncated   : %u\n", stats.truncated);
+	PR("Overwritten : %u\n", stats.overwritten);
+	PR("Dropped     : %u\n", stats.dropped);
+#else
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_LOCAL", "local network packet capture");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_capture_local_start(const struct shell *shell,
+				       size_t argc, char *argv[])
+{
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+	struct net_if *iface = NULL;
+	char filter[128];
+	int ret, arg = 1, if_index, pos = 0;
+
+	if (argv[arg]) {
+		if_index = atoi(argv[arg++]);
+		if (if_index) {
+			iface = net_if_get_by_index(if_index);
+			if (!iface) {
+				PR_WARNING("No such interface in index %d\n",
+					   if_index);
+				return -ENOEXEC;
+			}
+		}
+	}
+
+	filter[0] = '\0';
+
+	for (; arg < argc; arg++) {
+		ret = snprintk(filter + pos, sizeof(filter) - pos, "%s%s",
+			       pos ? " " : "", argv[arg]);
+		if (ret < 0 || ret >= sizeof(filter) - pos) {
+			PR_WARNING("Filter is too long\n");
+			return -ENOEXEC;
+		}
+
+		pos += ret;
+	}
+
+	ret = net_capture_local_start(iface, filter, 0);
+	if (ret < 0) {
+		PR_WARNING("Capture %s failed (%d)\n", "start", ret);
+		return -ENOEXEC;
+	}
+#else
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_LOCAL", "local network packet capture");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_capture_local_stop(const struct shell *shell,
+				      size_t argc, char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+	int ret;
+
+	ret = net_capture_local_stop();
+	if (ret < 0) {
+		PR_WARNING("Capture %s failed (%d)\n", "stop", ret);
+		return -ENOEXEC;
+	}
+#else
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_LOCAL", "local network packet capture");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_capture_local_clear(const struct shell *shell,
+				       size_t argc, char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+	net_capture_local_clear();
+#else
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_LOCAL", "local network packet capture");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_capture_local_save(const struct shell *shell,
+				      size_t argc, char *argv[])
+{
+#if defined(CONFIG_NET_CAPTURE_LOCAL)
+	int ret;
+
+	if (argc < 2) {
+		PR_WARNING("File path is missing\n");
+		return -ENOEXEC;
+	}
+
+	ret = net_capture_local_save(argv[1]);
+	if (ret < 0) {
+		PR_WARNING("Capture %s failed (%d)\n", "save", ret);
+		return -ENOEXEC;
+	}
+#else
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	PR_INFO("Set %s to enable %s support.\n",
+		"CONFIG_NET_CAPTURE_LOCAL", "local network packet capture");
+#endif
+
+	return 0;
+}
+
 static int cmd_net_conn(const struct shell *shell, size_t argc, char *argv[])
 {
 	ARG_UNUSED(argc);
@@ -2069,11 +2252,17 @@ static int cmd_net_conn(const struct shell *shell, size_t argc, char *argv[])
 #if defined(CONFIG_NET_IPV6_FRAGMENT)
 	count = 0;
 
-	net_ipv6_frag_foreach(ipv6_frag_cb, &user_data);
+	net_ipv6_frag_foreach(ip_frag_cb, &user_data);
 
 	/* Do not print anything if no fragments are pending atm */
 #endif
 
+#if defined(CONFIG_NET_IPV4_FRAGMENT)
+	count = 0;
+
+	net_ipv4_frag_foreach(ip_frag_cb, &user_data);
+#endif
+
 #else
 	PR_INFO("Set %s to enable %s support.\n",
 		"CONFIG_NET_OFFLOAD or CONFIG_NET_NATIVE",
@@ -2225,6 +2414,73 @@ static int cmd_net_dns_cancel(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+static void dns_cache_cb(const char *query, enum dns_query_type type,
+			 const struct dns_addrinfo *info, size_t count,
+			 uint32_t ttl, void *user_data)
+{
+	const struct shell *shell = user_data;
+	char addr[NET_IPV6_ADDR_LEN];
+	int i;
+
+	PR("%s %s ttl %u%s\n", query,
+	   type == DNS_QUERY_TYPE_AAAA ? "AAAA" : "A", ttl,
+	   count ? "" : " (negative)");
+
+	for (i = 0; i < count; i++) {
+		if (info[i].ai_family == AF_INET) {
+			net_addr_ntop(AF_INET,
+				      &net_sin(&info[i].ai_addr)->sin_addr,
+				      addr, sizeof(addr));
+		} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+			   info[i].ai_family == AF_INET6) {
+			net_addr_ntop(AF_INET6,
+				      &net_sin6(&info[i].ai_addr)->sin6_addr,
+				      addr, sizeof(addr));
+		} else {
+			continue;
+		}
+
+		PR("\t%s\n", addr);
+	}
+}
+#endif
+
+static int cmd_net_dns_cache(const struct shell *shell, size_t argc,
+			     char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	if (dns_resolve_cache_foreach(dns_cache_cb, (void *)shell) == 0) {
+		PR("DNS cache is empty.\n");
+	}
+#else
+	PR_INFO("Set %s to enable %s support.\n", "CONFIG_DNS_RESOLVER_CACHE",
+		"DNS cache");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_dns_flush(const struct shell *shell, size_t argc,
+			     char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	dns_resolve_cache_flush();
+	PR("DNS cache flushed.\n");
+#else
+	PR_INFO("Set %s to enable %s support.\n", "CONFIG_DNS_RESOLVER_CACHE",
+		"DNS cache");
+#endif
+
+	return 0;
+}
+
 static int cmd_net_dns_query(const struct shell *shell, size_t argc,
 			     char *argv[])
 {
@@ -3647,6 +3903,70 @@ static void context_info(struct net_context *context, void *user_data)
 }
 #endif /* CONFIG_NET_OFFLOAD || CONFIG_NET_NATIVE */
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+static void iface_pkt_usage_cb(struct net_if *iface, void *user_data)
+{
+	struct net_shell_user_data *data = user_data;
+	const struct shell *shell = data->shell;
+
+	PR("Interface %d\t%d/%d\t\t%d/%d\n", net_if_get_by_iface(iface),
+	   (int)atomic_get(&iface->rx_pkt_usage.pkts),
+	   (int)atomic_get(&iface->rx_pkt_usage.bufs),
+	   (int)atomic_get(&iface->tx_pkt_usage.pkts),
+	   (int)atomic_get(&iface->tx_pkt_usage.bufs));
+}
+
+static void context_pkt_usage_cb(struct net_context *context,
+				 void *user_data)
+{
+	struct net_shell_user_data *data = user_data;
+	const struct shell *shell = data->shell;
+
+	if (!net_context_is_used(context) ||
+	    !atomic_get(&context->pkt_usage.pkts)) {
+		return;
+	}
+
+	PR("Context %p\t\t\t%d/%d\n", context,
+	   (int)atomic_get(&context->pkt_usage.pkts),
+	   (int)atomic_get(&context->pkt_usage.bufs));
+}
+
+static void print_pkt_usage(const struct shell *shell)
+{
+	struct net_shell_user_data user_data;
+	const struct net_pkt_usage *rx, *tx;
+	int tc;
+
+	PR("\nPacket pool usage (packets/buffers):\n");
+	PR("Owner\t\tRX\t\tTX\n");
+
+	rx = net_pkt_usage_get(true);
+	tx = net_pkt_usage_get(false);
+
+	PR("Total\t\t%d/%d\t\t%d/%d\n",
+	   (int)atomic_get(&rx->pkts), (int)atomic_get(&rx->bufs),
+	   (int)atomic_get(&tx->pkts), (int)atomic_get(&tx->bufs));
+
+	for (tc = 0; tc < NET_TC_COUNT; tc++) {
+		rx = net_pkt_tc_usage_get(true, tc);
+		tx = net_pkt_tc_usage_get(false, tc);
+
+		PR("TC %d\t\t%d/%d\t\t%d/%d\n", tc,
+		   rx ? (int)atomic_get(&rx->pkts) : 0,
+		   rx ? (int)atomic_get(&rx->bufs) : 0,
+		   tx ? (int)atomic_get(&tx->pkts) : 0,
+		   tx ? (int)atomic_get(&tx->bufs) : 0);
+	}
+
+	user_data.shell = shell;
+	user_data.user_data = NULL;
+
+	net_if_foreach(iface_pkt_usage_cb, &user_data);
+	net_context_foreach(context_pkt_usage_cb, &user_data);
+}
+#endif /* CONFIG_NET_PKT_QUOTA */
+
 static int cmd_net_mem(const struct shell *shell, size_t argc, char *argv[])
 {
 	ARG_UNUSED(argc);
@@ -3704,6 +4024,10 @@ static int cmd_net_mem(const struct shell *shell, size_t argc, char *argv[])
 			PR("No external memory pools found.\n");
 		}
 	}
+
+#if defined(CONFIG_NET_PKT_QUOTA)
+	print_pkt_usage(shell);
+#endif
 #else
 	PR_INFO("Set %s to enable %s support.\n",
 		"CONFIG_NET_OFFLOAD or CONFIG_NET_NATIVE", "memory usage");
@@ -5664,6 +5988,24 @@ SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_arp,
 	SHELL_SUBCMD_SET_END
 );
 
+SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_capture_local,
+	SHELL_CMD(start, NULL, "Start capturing packets into the local "
+		  "capture buffer.\n"
+		  "'net capture local start [<interface index> [<filter>]]'\n"
+		  "Index 0 captures all the interfaces. The filter is a pcap "
+		  "like expression, for example \"udp and port 5353\".",
+		  cmd_net_capture_local_start),
+	SHELL_CMD(stop, NULL, "Stop local packet capture.",
+		  cmd_net_capture_local_stop),
+	SHELL_CMD(clear, NULL, "Discard the locally captured packets.",
+		  cmd_net_capture_local_clear),
+	SHELL_CMD(save, NULL, "Save the locally captured packets to a "
+		  "pcapng file.\n"
+		  "'net capture local save <path>'",
+		  cmd_net_capture_local_save),
+	SHELL_SUBCMD_SET_END
+);
+
 SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_capture,
 	SHELL_CMD(setup, NULL, "Setup network packet capture.\n"
 		  "'net capture setup <remote-ip-addr> <local-addr> <peer-addr>'\n"
@@ -5681,12 +6023,19 @@ SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_capture,
 		  cmd_net_capture_enable),
 	SHELL_CMD(disable, NULL, "Disable network packet capture.",
 		  cmd_net_capture_disable),
+	SHELL_CMD(local, &net_cmd_capture_local,
+		  "Show local network packet capture statistics.",
+		  cmd_net_capture_local),
 	SHELL_SUBCMD_SET_END
 );
 
 SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_dns,
+	SHELL_CMD(cache, NULL, "Show the cached DNS results.",
+		  cmd_net_dns_cache),
 	SHELL_CMD(cancel, NULL, "Cancel all pending requests.",
 		  cmd_net_dns_cancel),
+	SHELL_CMD(flush, NULL, "Remove all the cached DNS results.",
+		  cmd_net_dns_flush),
 	SHELL_CMD(query, NULL,
 		  "'net dns <hostname> [A or AAAA]' queries IPv4 address "
 		  "(default) or IPv6 address for a host name.",
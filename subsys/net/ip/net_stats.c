@@ -232,6 +232,101 @@ void net_print_statistics(void)
 
 #endif /* CONFIG_NET_STATISTICS_PERIODIC_OUTPUT */
 
+#if defined(CONFIG_NET_PKT_LATENCY_STATS)
+/* Width of the first latency bucket in cycles */
+static uint32_t latency_bucket_cycles;
+
+#if defined(CONFIG_NET_PKT_LATENCY_STATS_EVENT)
+static uint32_t latency_event_cycles;
+static uint32_t latency_event_time[NET_STATS_LATENCY_STAGE_COUNT];
+
+static void latency_event(struct net_if *iface,
+			  enum net_stats_latency_stage stage, uint32_t diff)
+{
+	struct net_stats_latency_event info;
+	uint32_t now = k_uptime_get_32();
+
+	if (latency_event_time[stage] &&
+	    (now - latency_event_time[stage]) <
+	    CONFIG_NET_PKT_LATENCY_STATS_EVENT_INTERVAL) {
+		return;
+	}
+
+	/* Zero means that no event has been sent yet */
+	latency_event_time[stage] = now ? now : 1;
+
+	info.usec = k_cyc_to_us_floor32(diff);
+	info.stage = stage;
+
+	net_mgmt_event_notify_with_info(NET_EVENT_STATS_LATENCY, iface,
+					&info, sizeof(info));
+}
+#endif /* CONFIG_NET_PKT_LATENCY_STATS_EVENT */
+
+static int latency_bucket(uint32_t diff)
+{
+	uint32_t count;
+	int bucket;
+
+	if (!latency_bucket_cycles) {
+		latency_bucket_cycles = MAX(k_us_to_cyc_ceil32(
+				CONFIG_NET_PKT_LATENCY_STATS_BUCKET_USEC), 1);
+#if defined(CONFIG_NET_PKT_LATENCY_STATS_EVENT)
+		latency_event_cycles = k_us_to_cyc_ceil32(
+				CONFIG_NET_PKT_LATENCY_STATS_EVENT_USEC);
+#endif
+	}
+
+	/* Bucket n > 0 counts latencies from 2^(n - 1) to 2^n times the
+	 * width of the first bucket.
+	 */
+	count = diff / latency_bucket_cycles;
+	if (!count) {
+		return 0;
+	}
+
+	bucket = 32 - __builtin_clz(count);
+
+	return MIN(bucket, CONFIG_NET_PKT_LATENCY_STATS_BUCKETS - 1);
+}
+
+void net_stats_update_latency(struct net_pkt *pkt,
+			      enum net_stats_latency_stage stage)
+{
+	struct net_if *iface = net_pkt_iface(pkt);
+	uint32_t now = k_cycle_get_32();
+	uint32_t diff = now - net_pkt_latency_tick(pkt);
+	int bucket;
+
+	net_pkt_set_latency_tick(pkt, now);
+
+	if (!iface) {
+		return;
+	}
+
+	bucket = latency_bucket(diff);
+
+	UPDATE_STAT(iface, stats.latency[stage].bucket[bucket]++);
+	UPDATE_STAT(iface, stats.latency[stage].sum += diff);
+
+	if (diff > net_stats.latency[stage].max) {
+		net_stats.latency[stage].max = diff;
+	}
+
+#if defined(CONFIG_NET_STATISTICS_PER_INTERFACE)
+	if (diff > iface->stats.latency[stage].max) {
+		iface->stats.latency[stage].max = diff;
+	}
+#endif
+
+#if defined(CONFIG_NET_PKT_LATENCY_STATS_EVENT)
+	if (diff >= latency_event_cycles) {
+		latency_event(iface, stage, diff);
+	}
+#endif
+}
+#endif /* CONFIG_NET_PKT_LATENCY_STATS */
+
 #if defined(CONFIG_NET_STATISTICS_USER_API)
 
 static int net_stats_get(uint32_t mgmt_request, struct net_if *iface,
@@ -297,6 +392,13 @@ static int net_stats_get(uint32_t mgmt_request, struct net_if *iface,
 		src = GET_STAT_ADDR(iface, tcp);
 		break;
 #endif
+#if defined(CONFIG_NET_PKT_LATENCY_STATS)
+	case NET_REQUEST_STATS_CMD_GET_LATENCY:
+		len_chk = sizeof(struct net_stats_latency) *
+			  NET_STATS_LATENCY_STAGE_COUNT;
+		src = GET_STAT_ADDR(iface, latency);
+		break;
+#endif
 #if defined(CONFIG_NET_STATISTICS_POWER_MANAGEMENT)
 	case NET_REQUEST_STATS_GET_PM:
 		len_chk = sizeof(struct net_stats_pm);
@@ -356,6 +458,11 @@ NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_TCP,
 				  net_stats_get);
 #endif
 
+#if defined(CONFIG_NET_PKT_LATENCY_STATS)
+NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_LATENCY,
+				  net_stats_get);
+#endif
+
 #if defined(CONFIG_NET_STATISTICS_POWER_MANAGEMENT)
 NET_MGMT_REGISTER_REQUEST_HANDLER(NET_REQUEST_STATS_GET_PM,
 				  net_stats_get);
@@ -619,6 +619,17 @@ static inline void net_stats_add_suspend_end_time(struct net_if *iface,
 #define net_stats_add_suspend_end_time(iface, time)
 #endif
 
+#if defined(CONFIG_NET_PKT_LATENCY_STATS) && defined(CONFIG_NET_STATISTICS) \
+	&& defined(CONFIG_NET_NATIVE)
+/* Record the time the packet spent in the given stage and start the
+ * next stage.
+ */
+void net_stats_update_latency(struct net_pkt *pkt,
+			      enum net_stats_latency_stage stage);
+#else
+#define net_stats_update_latency(pkt, stage)
+#endif
+
 #if defined(CONFIG_NET_STATISTICS_PERIODIC_OUTPUT) \
 	&& defined(CONFIG_NET_NATIVE)
 /* A simple periodic statistic printer, used only in net core */
@@ -17,6 +17,7 @@ LOG_MODULE_REGISTER(net_tc, CONFIG_NET_TC_LOG_LEVEL);
 #include "net_private.h"
 #include "net_stats.h"
 #include "net_tc_mapping.h"
+#include "gro.h"
 
 /* Template for thread name. The "xx" is either "TX" denoting transmit thread,
  * or "RX" denoting receive thread. The "q[y]" denotes the traffic class queue
@@ -72,6 +73,24 @@ void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt)
 #endif
 }
 
+/* The packets are linked through their first word, see k_fifo_put_slist() */
+void net_tc_submit_list_to_rx_queue(uint8_t tc, sys_slist_t *list)
+{
+#if NET_TC_RX_COUNT > 0
+	sys_snode_t *node;
+
+	SYS_SLIST_FOR_EACH_NODE(list, node) {
+		net_pkt_set_rx_stats_tick((struct net_pkt *)node,
+					  k_cycle_get_32());
+	}
+
+	k_fifo_put_slist(&rx_classes[tc].fifo, list);
+#else
+	ARG_UNUSED(tc);
+	ARG_UNUSED(list);
+#endif
+}
+
 int net_tx_priority2tc(enum net_priority prio)
 {
 #if NET_TC_TX_COUNT > 0
@@ -113,13 +132,7 @@ int net_rx_priority2tc(enum net_priority prio)
 
 #define PRIO_TX(i, _) (BASE_PRIO_TX - i),
 
-#if IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE)
-#define BASE_PRIO_RX (CONFIG_NET_TC_NUM_PRIORITIES - 1)
-#else
-#define BASE_PRIO_RX (CONFIG_NET_TC_RX_COUNT - 1)
-#endif
-
-#define PRIO_RX(i, _) (BASE_PRIO_RX - i),
+#define PRIO_RX(i, _) (NET_TC_RX_BASE_PRIO - i),
 
 #if NET_TC_TX_COUNT > 0
 /* Convert traffic class to thread priority */
@@ -236,36 +249,112 @@ static void net_tc_rx_stats_priority_setup(struct net_if *iface,
 #endif
 #endif
 
-#if NET_TC_RX_COUNT > 0
-static void tc_rx_handler(struct k_fifo *fifo)
+#if NET_TC_RX_COUNT > 0 || NET_TC_TX_COUNT > 0
+#if defined(CONFIG_NET_TC_BATCH)
+/* Handle up to CONFIG_NET_TC_BATCH_SIZE packets per wakeup. Only the first
+ * packet is waited for, the rest are taken if they are already queued.
+ * Returns the number of handled packets.
+ */
+static int tc_process_batch(struct k_fifo *fifo,
+			    void (*process)(struct net_pkt *pkt))
 {
 	struct net_pkt *pkt;
+	int count = 0;
+
+	pkt = k_fifo_get(fifo, K_FOREVER);
+
+	while (pkt != NULL) {
+		process(pkt);
+
+		if (++count == CONFIG_NET_TC_BATCH_SIZE) {
+			break;
+		}
+
+		pkt = k_fifo_get(fifo, K_NO_WAIT);
+	}
+
+	return count;
+}
+
+static void tc_handler(struct k_fifo *fifo,
+		       void (*process)(struct net_pkt *pkt),
+		       void (*batch_done)(void),
+		       bool moderation)
+{
+	bool moderate = false;
+	int count;
 
 	while (1) {
-		pkt = k_fifo_get(fifo, K_FOREVER);
-		if (pkt == NULL) {
+		count = tc_process_batch(fifo, process);
+		if (count == 0) {
 			continue;
 		}
 
-		net_process_rx_packet(pkt);
+		if (batch_done && k_fifo_is_empty(fifo)) {
+			batch_done();
+		}
+
+		if (!moderation || CONFIG_NET_TC_BATCH_MODERATION_US == 0) {
+			continue;
+		}
+
+		/* Enter moderation when a full batch was seen and leave it
+		 * only when the load has clearly dropped.
+		 */
+		if (count >= CONFIG_NET_TC_BATCH_SIZE) {
+			moderate = true;
+		} else if (count < CONFIG_NET_TC_BATCH_SIZE / 4) {
+			moderate = false;
+		}
+
+		if (moderate) {
+			k_usleep(CONFIG_NET_TC_BATCH_MODERATION_US);
+		}
 	}
 }
-#endif
-
-#if NET_TC_TX_COUNT > 0
-static void tc_tx_handler(struct k_fifo *fifo)
+#else
+static void tc_handler(struct k_fifo *fifo,
+		       void (*process)(struct net_pkt *pkt),
+		       void (*batch_done)(void),
+		       bool moderation)
 {
 	struct net_pkt *pkt;
 
+	ARG_UNUSED(moderation);
+
 	while (1) {
 		pkt = k_fifo_get(fifo, K_FOREVER);
 		if (pkt == NULL) {
 			continue;
 		}
 
-		net_process_tx_packet(pkt);
+		process(pkt);
+
+		if (batch_done && k_fifo_is_empty(fifo)) {
+			batch_done();
+		}
 	}
 }
+#endif /* CONFIG_NET_TC_BATCH */
+#endif
+
+#if NET_TC_RX_COUNT > 0
+static void tc_rx_handler(struct k_fifo *fifo)
+{
+	/* At the end of the receive batch, pass coalesced segments up */
+	tc_handler(fifo, net_process_rx_packet,
+		   IS_ENABLED(CONFIG_NET_GRO) ? net_gro_flush : NULL, true);
+}
+#endif
+
+#if NET_TC_TX_COUNT > 0
+static void tc_tx_handler(struct k_fifo *fifo)
+{
+	/* Delaying the TX queue would only add latency, the sender does not
+	 * get woken up any less often.
+	 */
+	tc_handler(fifo, net_process_tx_packet, NULL, false);
+}
 #endif
 
 /* Create a fifo for each traffic class we are using. All the network
@@ -0,0 +1,493 @@
+/** @file
+ * @brief IP fragment reassembly
+ *
+ * Fragments of IPv6 and IPv4 datagrams are kept in the network buffers
+ * they were received in until the datagram is complete. The received
+ * fragments of a datagram are kept sorted by offset so holes and overlaps
+ * are found while inserting, and the buffers are linked together without
+ * copying the payload once the last hole is filled.
+ *
+ * The memory held by pending datagrams is bounded. When a new fragment
+ * does not fit, the datagrams that have waited for more than half of
+ * their timeout are discarded first, oldest first, then the least
+ * complete ones.
+ */
+
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_reassembly, CONFIG_NET_REASSEMBLY_LOG_LEVEL);
+
+#include <kernel.h>
+#include <string.h>
+#include <errno.h>
+
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+
+#include "net_private.h"
+#include "reassembly.h"
+
+#if defined(CONFIG_NET_IPV6_FRAGMENT)
+#define REASS_IPV6_COUNT CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT
+#define REASS_IPV6_TIMEOUT (CONFIG_NET_IPV6_FRAGMENT_TIMEOUT * MSEC_PER_SEC)
+#else
+#define REASS_IPV6_COUNT 0
+#define REASS_IPV6_TIMEOUT 0
+#endif
+
+#if defined(CONFIG_NET_IPV4_FRAGMENT)
+#define REASS_IPV4_COUNT CONFIG_NET_IPV4_FRAGMENT_MAX_COUNT
+#define REASS_IPV4_TIMEOUT (CONFIG_NET_IPV4_FRAGMENT_TIMEOUT * MSEC_PER_SEC)
+#else
+#define REASS_IPV4_COUNT 0
+#define REASS_IPV4_TIMEOUT 0
+#endif
+
+#define REASS_COUNT (REASS_IPV6_COUNT + REASS_IPV4_COUNT)
+
+struct reass_frag {
+	sys_snode_t node;
+
+	/** Payload of the fragment, NULL for the first fragment as its
+	 * payload stays in the packet of the reassembly.
+	 */
+	struct net_buf *buf;
+
+	/** Offset of the payload in the datagram */
+	uint16_t offset;
+
+	/** Length of the payload */
+	uint16_t len;
+};
+
+static struct net_reassembly reass_ctx[REASS_COUNT];
+static struct reass_frag reass_frags[CONFIG_NET_REASSEMBLY_FRAGMENT_COUNT];
+static sys_slist_t reass_free_frags;
+static uint32_t reass_mem;
+static bool reass_init_done;
+
+static K_MUTEX_DEFINE(reass_lock);
+static struct k_work_delayable reass_timer;
+
+static int reass_max_count(sa_family_t family)
+{
+	return family == AF_INET6 ? REASS_IPV6_COUNT : REASS_IPV4_COUNT;
+}
+
+static int64_t reass_timeout(sa_family_t family)
+{
+	return family == AF_INET6 ? REASS_IPV6_TIMEOUT : REASS_IPV4_TIMEOUT;
+}
+
+static bool reass_key_cmp(const struct net_reass_key *a,
+			  const struct net_reass_key *b)
+{
+	if (a->family != b->family || a->id != b->id || a->proto != b->proto) {
+		return false;
+	}
+
+	if (a->family == AF_INET6) {
+		return net_ipv6_addr_cmp(&a->src.in6, &b->src.in6) &&
+			net_ipv6_addr_cmp(&a->dst.in6, &b->dst.in6);
+	}
+
+	return net_ipv4_addr_cmp(&a->src.in, &b->src.in) &&
+		net_ipv4_addr_cmp(&a->dst.in, &b->dst.in);
+}
+
+static uint32_t reass_buf_size(struct net_buf *buf)
+{
+	uint32_t size = 0U;
+
+	for (; buf; buf = buf->frags) {
+		size += buf->size;
+	}
+
+	return size;
+}
+
+/* Remove the headers from the start of a buffer chain, freeing the
+ * buffers that only contained headers.
+ */
+static struct net_buf *reass_strip(struct net_buf *buf, size_t len)
+{
+	while (buf && len >= buf->len) {
+		len -= buf->len;
+		buf = net_buf_frag_del(NULL, buf);
+	}
+
+	if (buf) {
+		net_buf_pull(buf, len);
+	}
+
+	return buf;
+}
+
+static void reass_free(struct net_reassembly *reass)
+{
+	struct reass_frag *frag;
+	sys_snode_t *node;
+
+	NET_DBG("Discarding reassembly %p id 0x%x (%u/%u bytes)", reass,
+		reass->key.id, reass->received, reass->total);
+
+	while ((node = sys_slist_get(&reass->frags))) {
+		frag = CONTAINER_OF(node, struct reass_frag, node);
+
+		if (frag->buf) {
+			net_buf_unref(frag->buf);
+			frag->buf = NULL;
+		}
+
+		sys_slist_append(&reass_free_frags, &frag->node);
+	}
+
+	if (reass->pkt) {
+		net_pkt_unref(reass->pkt);
+		reass->pkt = NULL;
+	}
+
+	reass_mem -= reass->mem;
+	reass->used = false;
+}
+
+static void reass_timer_update(void)
+{
+	int64_t next = INT64_MAX;
+	int i;
+
+	for (i = 0; i < REASS_COUNT; i++) {
+		if (reass_ctx[i].used && reass_ctx[i].expiry < next) {
+			next = reass_ctx[i].expiry;
+		}
+	}
+
+	if (next == INT64_MAX) {
+		k_work_cancel_delayable(&reass_timer);
+		return;
+	}
+
+	k_work_reschedule(&reass_timer,
+			  K_MSEC(MAX(next - k_uptime_get(), 0)));
+}
+
+static void reass_timeout_handler(struct k_work *work)
+{
+	int64_t now = k_uptime_get();
+	int i;
+
+	ARG_UNUSED(work);
+
+	k_mutex_lock(&reass_lock, K_FOREVER);
+
+	for (i = 0; i < REASS_COUNT; i++) {
+		if (reass_ctx[i].used && reass_ctx[i].expiry <= now) {
+			NET_DBG("Reassembly %p timed out", &reass_ctx[i]);
+			reass_free(&reass_ctx[i]);
+		}
+	}
+
+	reass_timer_update();
+
+	k_mutex_unlock(&reass_lock);
+}
+
+static void reass_init(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(reass_frags); i++) {
+		sys_slist_append(&reass_free_frags, &reass_frags[i].node);
+	}
+
+	k_work_init_delayable(&reass_timer, reass_timeout_handler);
+
+	reass_init_done = true;
+}
+
+static bool reass_is_stale(struct net_reassembly *reass, int64_t now)
+{
+	return now - reass->start >= (reass->expiry - reass->start) / 2;
+}
+
+/* Tell if a should be discarded before b */
+static bool reass_is_worse(struct net_reassembly *a, struct net_reassembly *b,
+			   int64_t now)
+{
+	bool a_stale = reass_is_stale(a, now);
+
+	if (a_stale != reass_is_stale(b, now)) {
+		return a_stale;
+	}
+
+	if (!a_stale && a->received != b->received) {
+		return a->received < b->received;
+	}
+
+	return a->start < b->start;
+}
+
+/* Find the reassembly to discard to make room, never the one the room is
+ * needed for. AF_UNSPEC family matches all reassemblies.
+ */
+static struct net_reassembly *reass_victim(struct net_reassembly *keep,
+					   sa_family_t family)
+{
+	struct net_reassembly *victim = NULL;
+	int64_t now = k_uptime_get();
+	int i;
+
+	for (i = 0; i < REASS_COUNT; i++) {
+		struct net_reassembly *reass = &reass_ctx[i];
+
+		if (!reass->used || reass == keep ||
+		    (family != AF_UNSPEC && reass->key.family != family)) {
+			continue;
+		}
+
+		if (!victim || reass_is_worse(reass, victim, now)) {
+			victim = reass;
+		}
+	}
+
+	return victim;
+}
+
+static struct net_reassembly *reass_find(const struct net_reass_key *key)
+{
+	int i;
+
+	for (i = 0; i < REASS_COUNT; i++) {
+		if (reass_ctx[i].used &&
+		    reass_key_cmp(&reass_ctx[i].key, key)) {
+			return &reass_ctx[i];
+		}
+	}
+
+	return NULL;
+}
+
+static struct net_reassembly *reass_alloc(const struct net_reass_key *key)
+{
+	struct net_reassembly *reass = NULL;
+	int i, count = 0;
+
+	if (reass_max_count(key->family) == 0) {
+		return NULL;
+	}
+
+	for (i = 0; i < REASS_COUNT; i++) {
+		if (!reass_ctx[i].used) {
+			if (!reass) {
+				reass = &reass_ctx[i];
+			}
+		} else if (reass_ctx[i].key.family == key->family) {
+			count++;
+		}
+	}
+
+	/* As many reassemblies as the sum of the per family limits are
+	 * allocated, so there is a free one if the family is below its
+	 * limit.
+	 */
+	if (count >= reass_max_count(key->family)) {
+		reass = reass_victim(NULL, key->family);
+		reass_free(reass);
+	}
+
+	NET_ASSERT(reass);
+
+	memcpy(&reass->key, key, sizeof(reass->key));
+	sys_slist_init(&reass->frags);
+	reass->pkt = NULL;
+	reass->mem = 0U;
+	reass->received = 0U;
+	reass->total = 0U;
+	reass->count = 0U;
+	reass->start = k_uptime_get();
+	reass->expiry = reass->start + reass_timeout(key->family);
+	reass->used = true;
+
+	reass_timer_update();
+
+	return reass;
+}
+
+static struct net_pkt *reass_complete(struct net_reassembly *reass)
+{
+	struct net_pkt *pkt = reass->pkt;
+	struct reass_frag *frag;
+	struct net_buf *last;
+
+	last = net_buf_frag_last(pkt->buffer);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&reass->frags, frag, node) {
+		if (!frag->buf) {
+			continue;
+		}
+
+		last->frags = frag->buf;
+		last = net_buf_frag_last(frag->buf);
+		frag->buf = NULL;
+	}
+
+	NET_DBG("Reassembled pkt %p id 0x%x from %u fragments (%u bytes)",
+		pkt, reass->key.id, reass->count, reass->total);
+
+	reass->pkt = NULL;
+	reass_free(reass);
+	reass_timer_update();
+
+	return pkt;
+}
+
+int net_reass_add(const struct net_reass_key *key, struct net_pkt *pkt,
+		  uint16_t hdr_len, uint16_t offset, bool more,
+		  struct net_pkt **datagram)
+{
+	struct reass_frag *frag, *prev = NULL, *next = NULL;
+	struct net_reassembly *reass;
+	struct net_reassembly *victim;
+	uint32_t len, end, size;
+	int ret = 0;
+
+	*datagram = NULL;
+
+	if (net_pkt_get_len(pkt) <= hdr_len) {
+		return -EINVAL;
+	}
+
+	len = net_pkt_get_len(pkt) - hdr_len;
+	end = offset + len;
+	size = reass_buf_size(pkt->buffer);
+
+	if (end > UINT16_MAX || size > CONFIG_NET_REASSEMBLY_MEM) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&reass_lock, K_FOREVER);
+
+	if (!reass_init_done) {
+		reass_init();
+	}
+
+	reass = reass_find(key);
+	if (!reass) {
+		reass = reass_alloc(key);
+		if (!reass) {
+			ret = -ENOMEM;
+			goto out;
+		}
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&reass->frags, frag, node) {
+		if (frag->offset >= offset) {
+			next = frag;
+			break;
+		}
+
+		prev = frag;
+	}
+
+	if (next && next->offset == offset && next->len == len) {
+		NET_DBG("Fragment at %u of id 0x%x already received",
+			offset, key->id);
+		ret = -EALREADY;
+		goto out;
+	}
+
+	/* Overlapping fragments are not accepted (RFC 5722), and once the
+	 * last fragment is known no data can be past it.
+	 */
+	if ((prev && prev->offset + prev->len > offset) ||
+	    (next && end > next->offset) ||
+	    (reass->total && end > reass->total) ||
+	    (!more && (reass->total || next))) {
+		NET_DBG("Fragment at %u len %u of id 0x%x is inconsistent",
+			offset, len, key->id);
+		ret = -EINVAL;
+		goto discard;
+	}
+
+	while (reass_mem + size > CONFIG_NET_REASSEMBLY_MEM ||
+	       sys_slist_is_empty(&reass_free_frags)) {
+		victim = reass_victim(reass, AF_UNSPEC);
+		if (!victim) {
+			NET_DBG("No room for fragment of id 0x%x", key->id);
+			ret = -ENOMEM;
+			goto discard;
+		}
+
+		reass_free(victim);
+	}
+
+	frag = CONTAINER_OF(sys_slist_get_not_empty(&reass_free_frags),
+			    struct reass_frag, node);
+	frag->offset = offset;
+	frag->len = len;
+
+	if (offset == 0U) {
+		reass->pkt = pkt;
+		frag->buf = NULL;
+	} else {
+		frag->buf = reass_strip(pkt->buffer, hdr_len);
+		pkt->buffer = NULL;
+		net_pkt_unref(pkt);
+	}
+
+	if (prev) {
+		sys_slist_insert(&reass->frags, &prev->node, &frag->node);
+	} else {
+		sys_slist_prepend(&reass->frags, &frag->node);
+	}
+
+	reass->mem += size;
+	reass->received += len;
+	reass->count++;
+	reass_mem += size;
+
+	if (!more) {
+		reass->total = end;
+	}
+
+	NET_DBG("Fragment at %u len %u of id 0x%x, %u/%u bytes received",
+		offset, len, key->id, reass->received, reass->total);
+
+	if (reass->pkt && reass->total && reass->received == reass->total) {
+		*datagram = reass_complete(reass);
+	}
+
+	goto out;
+
+discard:
+	reass_free(reass);
+	reass_timer_update();
+out:
+	k_mutex_unlock(&reass_lock);
+
+	return ret;
+}
+
+void net_reass_foreach(sa_family_t family, net_reass_cb_t cb,
+		       void *user_data)
+{
+	int i;
+
+	k_mutex_lock(&reass_lock, K_FOREVER);
+
+	for (i = 0; i < REASS_COUNT; i++) {
+		if (!reass_ctx[i].used || reass_ctx[i].key.family != family) {
+			continue;
+		}
+
+		cb(&reass_ctx[i], user_data);
+	}
+
+	k_mutex_unlock(&reass_lock);
+}
@@ -0,0 +1,154 @@
+/** @file
+ * @brief IP fragment reassembly
+ *
+ * This is not to be included by the application.
+ */
+
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __REASSEMBLY_H
+#define __REASSEMBLY_H
+
+#include <kernel.h>
+#include <sys/slist.h>
+
+#include <net/net_ip.h>
+#include <net/net_pkt.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Identifies the datagram a fragment belongs to. */
+struct net_reass_key {
+	/** Source address of the datagram */
+	union {
+		struct in6_addr in6;
+		struct in_addr in;
+	} src;
+
+	/** Destination address of the datagram */
+	union {
+		struct in6_addr in6;
+		struct in_addr in;
+	} dst;
+
+	/** Fragment identification */
+	uint32_t id;
+
+	/** AF_INET6 or AF_INET */
+	sa_family_t family;
+
+	/** Upper layer protocol, only used by IPv4 */
+	uint8_t proto;
+};
+
+/** Datagram waiting for its missing fragments. */
+struct net_reassembly {
+	/** Datagram this reassembly is for */
+	struct net_reass_key key;
+
+	/**
+	 * First fragment of the datagram. Its headers are kept and the
+	 * data of the other fragments is appended to it once complete.
+	 */
+	struct net_pkt *pkt;
+
+	/** Received fragments, sorted by offset */
+	sys_slist_t frags;
+
+	/** When the first fragment was received (in ms) */
+	int64_t start;
+
+	/** When the reassembly is abandoned (in ms) */
+	int64_t expiry;
+
+	/** Size of the network buffers held by the fragments */
+	uint32_t mem;
+
+	/** Number of payload bytes received */
+	uint32_t received;
+
+	/** Payload length of the datagram, 0 until the last fragment */
+	uint32_t total;
+
+	/** Number of fragments received */
+	uint8_t count;
+
+	/** Is this reassembly in use */
+	bool used;
+};
+
+/**
+ * @typedef net_reass_cb_t
+ * @brief Callback used while iterating over pending reassemblies.
+ *
+ * @param reass Pending reassembly
+ * @param user_data A valid pointer on some user data or NULL
+ */
+typedef void (*net_reass_cb_t)(struct net_reassembly *reass,
+			       void *user_data);
+
+/**
+ * @brief Add a received fragment to the reassembly of its datagram.
+ *
+ * The payload of the fragment is kept in the network buffers it was
+ * received in: the headers are pulled from the buffers of the fragments
+ * that do not start the datagram and the buffers are linked together once
+ * the datagram is complete. The fragments can be received in any order.
+ *
+ * If the fragment does not fit in the memory budget, the stalest datagram
+ * or, if none has waited for long, the least complete one is discarded to
+ * make room for it.
+ *
+ * @param key Datagram the fragment belongs to.
+ * @param pkt Received fragment, starting with the IP header.
+ * @param hdr_len Length of the headers in front of the fragment payload.
+ * @param offset Offset of the fragment payload in the datagram.
+ * @param more Is this not the last fragment of the datagram.
+ * @param datagram Set to the reassembled datagram when this fragment
+ * completed it, the headers of the first fragment being kept as is.
+ *
+ * @return 0 if the fragment was taken, -EALREADY if it was already
+ * received, -EINVAL if it overlaps other fragments or is inconsistent
+ * with them (the datagram is discarded then), -ENOMEM if there is no
+ * room for it. On error, the caller keeps the ownership of pkt.
+ */
+int net_reass_add(const struct net_reass_key *key, struct net_pkt *pkt,
+		  uint16_t hdr_len, uint16_t offset, bool more,
+		  struct net_pkt **datagram);
+
+/**
+ * @brief Go through the pending reassemblies of an address family.
+ *
+ * @param family AF_INET6 or AF_INET.
+ * @param cb Callback to call for each pending reassembly.
+ * @param user_data User specified data or NULL.
+ */
+void net_reass_foreach(sa_family_t family, net_reass_cb_t cb,
+		       void *user_data);
+
+/**
+ * @brief Get the time left before a reassembly is abandoned.
+ *
+ * @param reass Pending reassembly
+ *
+ * @return Remaining time in ms.
+ */
+static inline int32_t net_reass_remaining(struct net_reassembly *reass)
+{
+	int64_t remaining = reass->expiry - k_uptime_get();
+
+	return remaining > 0 ? (int32_t)remaining : 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __REASSEMBLY_H */
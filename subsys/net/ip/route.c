@@ -16,6 +16,7 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 #include <limits.h>
 #include <zephyr/types.h>
 #include <sys/slist.h>
+#include <sys/dlist.h>
 
 #include <net/net_pkt.h>
 #include <net/net_core.h>
@@ -36,7 +37,42 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 /* We keep track of the routes in a separate list so that we can remove
  * the oldest routes (at tail) if needed.
  */
-static sys_slist_t routes;
+static sys_dlist_t routes = SYS_DLIST_STATIC_INIT(&routes);
+
+#if defined(CONFIG_NET_ROUTE_LPM_TRIE)
+/* Path compressed binary trie of the route prefixes. A node is created
+ * for each route prefix and for each bit position where two prefixes
+ * diverge, so 2 * CONFIG_NET_MAX_ROUTES nodes are always enough.
+ */
+struct route_trie_node {
+	struct route_trie_node *parent;
+	struct route_trie_node *child[2];
+
+	/** Routes with this exact prefix, NULL for branch only nodes */
+	struct net_route_entry *routes;
+
+	struct in6_addr prefix;
+	uint8_t len;
+	bool used;
+};
+
+static struct route_trie_node route_trie_nodes[2 * CONFIG_NET_MAX_ROUTES];
+static struct route_trie_node *route_trie_root;
+#endif
+
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+struct route_cache_entry {
+	struct in6_addr dst;
+	struct net_if *iface;
+
+	/** Lookup result, NULL if there is no route to dst */
+	struct net_route_entry *route;
+
+	bool valid;
+};
+
+static struct route_cache_entry route_cache[CONFIG_NET_ROUTE_CACHE_SIZE];
+#endif
 
 static void net_route_nexthop_remove(struct net_nbr *nbr)
 {
@@ -253,13 +289,288 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 /* Route was accessed, so place it in front of the routes list */
 static inline void update_route_access(struct net_route_entry *route)
 {
-	sys_slist_find_and_remove(&routes, &route->node);
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_remove(&route->node);
+	sys_dlist_prepend(&routes, &route->node);
 }
 
-struct net_route_entry *net_route_lookup(struct net_if *iface,
-					 struct in6_addr *dst)
+#if defined(CONFIG_NET_ROUTE_LPM_TRIE)
+static inline uint8_t route_addr_bit(const struct in6_addr *addr, uint8_t bit)
+{
+	return (addr->s6_addr[bit / 8U] >> (7 - (bit % 8U))) & 1U;
+}
+
+/* Return the first bit in [start, end) where the addresses differ, or end
+ * if they are the same in that range.
+ */
+static uint8_t route_prefix_match(const struct in6_addr *a,
+				  const struct in6_addr *b,
+				  uint8_t start, uint8_t end)
+{
+	uint8_t bit = start;
+
+	while (bit < end) {
+		if ((bit % 8U) == 0U && end - bit >= 8U &&
+		    a->s6_addr[bit / 8U] == b->s6_addr[bit / 8U]) {
+			bit += 8U;
+			continue;
+		}
+
+		if (route_addr_bit(a, bit) != route_addr_bit(b, bit)) {
+			break;
+		}
+
+		bit++;
+	}
+
+	return bit;
+}
+
+static struct route_trie_node *route_trie_node_alloc(struct in6_addr *prefix,
+						     uint8_t len)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(route_trie_nodes); i++) {
+		struct route_trie_node *node = &route_trie_nodes[i];
+
+		if (node->used) {
+			continue;
+		}
+
+		(void)memset(node, 0, sizeof(*node));
+		net_ipaddr_copy(&node->prefix, prefix);
+		node->len = len;
+		node->used = true;
+
+		return node;
+	}
+
+	return NULL;
+}
+
+/* Return the pointer that links the node to the trie */
+static struct route_trie_node **route_trie_link(struct route_trie_node *node)
+{
+	struct route_trie_node *parent = node->parent;
+
+	if (!parent) {
+		return &route_trie_root;
+	}
+
+	return &parent->child[route_addr_bit(&node->prefix, parent->len)];
+}
+
+static struct route_trie_node *route_trie_find(struct in6_addr *addr,
+					       uint8_t len)
+{
+	struct route_trie_node *node = route_trie_root;
+	uint8_t matched = 0U;
+
+	while (node && node->len <= len) {
+		if (route_prefix_match(addr, &node->prefix, matched,
+				       node->len) < node->len) {
+			break;
+		}
+
+		if (node->len == len) {
+			return node;
+		}
+
+		matched = node->len;
+		node = node->child[route_addr_bit(addr, matched)];
+	}
+
+	return NULL;
+}
+
+static int route_trie_insert(struct net_route_entry *route)
+{
+	struct route_trie_node **link = &route_trie_root;
+	struct route_trie_node *parent = NULL;
+	struct route_trie_node *node, *leaf, *branch;
+	uint8_t len = route->prefix_len;
+	uint8_t common;
+
+	while (*link) {
+		node = *link;
+		common = route_prefix_match(&route->addr, &node->prefix,
+					    parent ? parent->len : 0U,
+					    MIN(len, node->len));
+		if (common == node->len) {
+			if (node->len == len) {
+				leaf = node;
+				goto attach;
+			}
+
+			parent = node;
+			link = &node->child[route_addr_bit(&route->addr,
+							   node->len)];
+			continue;
+		}
+
+		leaf = route_trie_node_alloc(&route->addr, len);
+		if (!leaf) {
+			return -ENOMEM;
+		}
+
+		if (common == len) {
+			/* The new prefix covers the existing node */
+			leaf->child[route_addr_bit(&node->prefix, len)] = node;
+			leaf->parent = parent;
+			node->parent = leaf;
+			*link = leaf;
+
+			goto attach;
+		}
+
+		branch = route_trie_node_alloc(&route->addr, common);
+		if (!branch) {
+			leaf->used = false;
+			return -ENOMEM;
+		}
+
+		branch->child[route_addr_bit(&node->prefix, common)] = node;
+		branch->child[route_addr_bit(&route->addr, common)] = leaf;
+		branch->parent = parent;
+		node->parent = branch;
+		leaf->parent = branch;
+		*link = branch;
+
+		goto attach;
+	}
+
+	leaf = route_trie_node_alloc(&route->addr, len);
+	if (!leaf) {
+		return -ENOMEM;
+	}
+
+	leaf->parent = parent;
+	*link = leaf;
+
+attach:
+	route->trie_next = leaf->routes;
+	leaf->routes = route;
+
+	return 0;
+}
+
+static void route_trie_remove(struct net_route_entry *route)
 {
+	struct net_route_entry **prev;
+	struct route_trie_node *node, *parent, *child;
+
+	node = route_trie_find(&route->addr, route->prefix_len);
+	if (!node) {
+		return;
+	}
+
+	for (prev = &node->routes; *prev; prev = &(*prev)->trie_next) {
+		if (*prev == route) {
+			*prev = route->trie_next;
+			break;
+		}
+	}
+
+	route->trie_next = NULL;
+
+	/* Drop the nodes that no longer hold routes or join two branches */
+	while (node && !node->routes && !(node->child[0] && node->child[1])) {
+		parent = node->parent;
+		child = node->child[0] ? node->child[0] : node->child[1];
+
+		*route_trie_link(node) = child;
+		if (child) {
+			child->parent = parent;
+		}
+
+		node->used = false;
+
+		if (child) {
+			break;
+		}
+
+		node = parent;
+	}
+}
+
+static struct net_route_entry *route_trie_lookup(struct net_if *iface,
+						 struct in6_addr *dst)
+{
+	struct route_trie_node *node = route_trie_root;
+	struct net_route_entry *route, *found = NULL;
+	uint8_t matched = 0U;
+
+	while (node) {
+		if (route_prefix_match(dst, &node->prefix, matched,
+				       node->len) < node->len) {
+			break;
+		}
+
+		matched = node->len;
+
+		for (route = node->routes; route; route = route->trie_next) {
+			if (!iface || route->iface == iface) {
+				found = route;
+				break;
+			}
+		}
+
+		if (matched >= 128U) {
+			break;
+		}
+
+		node = node->child[route_addr_bit(dst, matched)];
+	}
+
+	return found;
+}
+#else
+static inline int route_trie_insert(struct net_route_entry *route)
+{
+	ARG_UNUSED(route);
+
+	return 0;
+}
+
+static inline void route_trie_remove(struct net_route_entry *route)
+{
+	ARG_UNUSED(route);
+}
+#endif /* CONFIG_NET_ROUTE_LPM_TRIE */
+
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+static struct route_cache_entry *route_cache_get(struct net_if *iface,
+						 struct in6_addr *dst)
+{
+	uint32_t hash;
+
+	hash = net_ipv6_addr_hash(dst) ^
+		((uint32_t)POINTER_TO_UINT(iface) >> 2);
+
+	return &route_cache[hash % CONFIG_NET_ROUTE_CACHE_SIZE];
+}
+
+/* Any change in the routing table can change the lookup results */
+static void route_cache_flush(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(route_cache); i++) {
+		route_cache[i].valid = false;
+	}
+}
+#else
+static inline void route_cache_flush(void)
+{
+}
+#endif /* CONFIG_NET_ROUTE_CACHE_SIZE > 0 */
+
+static struct net_route_entry *route_lookup(struct net_if *iface,
+					    struct in6_addr *dst)
+{
+#if defined(CONFIG_NET_ROUTE_LPM_TRIE)
+	return route_trie_lookup(iface, dst);
+#else
 	struct net_route_entry *route, *found = NULL;
 	uint8_t longest_match = 0U;
 	int i;
@@ -286,6 +597,32 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 		}
 	}
 
+	return found;
+#endif /* CONFIG_NET_ROUTE_LPM_TRIE */
+}
+
+struct net_route_entry *net_route_lookup(struct net_if *iface,
+					 struct in6_addr *dst)
+{
+	struct net_route_entry *found;
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+	struct route_cache_entry *cached = route_cache_get(iface, dst);
+
+	if (cached->valid && cached->iface == iface &&
+	    net_ipv6_addr_cmp(&cached->dst, dst)) {
+		found = cached->route;
+	} else {
+		found = route_lookup(iface, dst);
+
+		net_ipaddr_copy(&cached->dst, dst);
+		cached->iface = iface;
+		cached->route = found;
+		cached->valid = true;
+	}
+#else
+	found = route_lookup(iface, dst);
+#endif
+
 	if (found) {
 		net_route_info("Found", found, dst);
 
@@ -353,9 +690,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	nbr = nbr_new(iface, addr, prefix_len);
 	if (!nbr) {
 		/* Remove the oldest route and try again */
-		sys_snode_t *last = sys_slist_peek_tail(&routes);
-
-		sys_slist_find_and_remove(&routes, last);
+		sys_dnode_t *last = sys_dlist_peek_tail(&routes);
 
 		route = CONTAINER_OF(last,
 				     struct net_route_entry,
@@ -401,7 +736,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	route = net_route_data(nbr);
 	route->iface = iface;
 
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_prepend(&routes, &route->node);
 
 	tmp = nbr_nexthop_get(iface, nexthop);
 
@@ -412,6 +747,14 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	sys_slist_init(&route->nexthop);
 	sys_slist_prepend(&route->nexthop, &nexthop_route->node);
 
+	if (route_trie_insert(route) < 0) {
+		NET_ERR("No free route trie node!");
+		net_route_del(route);
+		return NULL;
+	}
+
+	route_cache_flush();
+
 	net_route_info("Added", route, addr);
 
 #if defined(CONFIG_NET_MGMT_EVENT_INFO)
@@ -454,13 +797,18 @@ int net_route_del(struct net_route_entry *route)
 	net_mgmt_event_notify(NET_EVENT_IPV6_ROUTE_DEL, route->iface);
 #endif
 
-	sys_slist_find_and_remove(&routes, &route->node);
+	if (sys_dnode_is_linked(&route->node)) {
+		sys_dlist_remove(&route->node);
+	}
 
 	nbr = net_route_get_nbr(route);
 	if (!nbr) {
 		return -ENOENT;
 	}
 
+	route_trie_remove(route);
+	route_cache_flush();
+
 	net_route_info("Deleted", route, &route->addr);
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&route->nexthop, nexthop_route, node) {
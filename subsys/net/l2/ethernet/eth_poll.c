@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_eth_poll, CONFIG_NET_L2_ETHERNET_LOG_LEVEL);
+
+#include <kernel.h>
+#include <init.h>
+#include <net/ethernet.h>
+
+#include "net_private.h"
+
+enum eth_poll_flags {
+	/* Device is scheduled or being polled, RX interrupt is disabled */
+	ETH_POLL_SCHEDULED,
+};
+
+/* Run one step below the lowest RX traffic class thread so that the
+ * frames received in one poll are processed before the device is polled
+ * again.
+ */
+#if defined(CONFIG_NET_TC_THREAD_COOPERATIVE)
+#define THREAD_PRIORITY K_PRIO_COOP(NET_TC_RX_BASE_PRIO + 1)
+#else
+#define THREAD_PRIORITY K_PRIO_PREEMPT(MIN(NET_TC_RX_BASE_PRIO + 1, \
+					   CONFIG_NUM_PREEMPT_PRIORITIES - 1))
+#endif
+
+static K_KERNEL_STACK_DEFINE(eth_poll_stack,
+			     CONFIG_NET_L2_ETHERNET_POLL_STACK_SIZE);
+static struct k_work_q eth_poll_work_q;
+
+static void eth_poll_irq(struct net_eth_poll *poll, bool enable)
+{
+	if (poll->irq) {
+		poll->irq(poll, enable);
+	}
+}
+
+static void eth_poll_handler(struct k_work *work)
+{
+	struct net_eth_poll *poll = CONTAINER_OF(work, struct net_eth_poll,
+						 work);
+	int count;
+
+	count = poll->poll(poll, poll->budget);
+	poll->polls++;
+
+	if (count >= poll->budget) {
+		/* The device may have more frames pending. Keep the RX
+		 * interrupt disabled and let other work run before polling
+		 * the device again.
+		 */
+		poll->exhausted++;
+		k_work_submit_to_queue(&eth_poll_work_q, work);
+		return;
+	}
+
+	/* The RX interrupt is still disabled so it cannot schedule a new
+	 * poll before it is enabled here.
+	 */
+	atomic_clear_bit(&poll->flags, ETH_POLL_SCHEDULED);
+	eth_poll_irq(poll, true);
+}
+
+void net_eth_poll_init(struct net_eth_poll *poll, net_eth_poll_cb_t poll_cb,
+		       net_eth_poll_irq_cb_t irq_cb, int budget)
+{
+	__ASSERT_NO_MSG(poll_cb != NULL);
+
+	k_work_init(&poll->work, eth_poll_handler);
+
+	poll->poll = poll_cb;
+	poll->irq = irq_cb;
+	poll->budget = budget > 0 ? budget : CONFIG_NET_L2_ETHERNET_POLL_BUDGET;
+	poll->polls = 0U;
+	poll->exhausted = 0U;
+
+	atomic_clear(&poll->flags);
+}
+
+bool net_eth_poll_schedule(struct net_eth_poll *poll)
+{
+	int ret;
+
+	if (atomic_test_and_set_bit(&poll->flags, ETH_POLL_SCHEDULED)) {
+		return false;
+	}
+
+	eth_poll_irq(poll, false);
+
+	ret = k_work_submit_to_queue(&eth_poll_work_q, &poll->work);
+	if (ret < 0) {
+		LOG_ERR("Cannot schedule poll %p (%d)", poll, ret);
+
+		atomic_clear_bit(&poll->flags, ETH_POLL_SCHEDULED);
+		eth_poll_irq(poll, true);
+
+		return false;
+	}
+
+	return true;
+}
+
+static int eth_poll_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_work_queue_start(&eth_poll_work_q, eth_poll_stack,
+			   K_KERNEL_STACK_SIZEOF(eth_poll_stack),
+			   THREAD_PRIORITY, NULL);
+
+	k_thread_name_set(&eth_poll_work_q.thread, "eth_poll");
+
+	return 0;
+}
+
+SYS_INIT(eth_poll_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -28,6 +28,7 @@ LOG_MODULE_REGISTER(net_ethernet, CONFIG_NET_L2_ETHERNET_LOG_LEVEL);
 #include "arp.h"
 #include "eth_stats.h"
 #include "net_private.h"
+#include "net_stats.h"
 #include "ipv6.h"
 #include "ipv4_autoconf_internal.h"
 
@@ -670,6 +671,8 @@ static int ethernet_send(struct net_if *iface, struct net_pkt *pkt)
 	net_pkt_cursor_init(pkt);
 
 send:
+	net_stats_update_latency(pkt, NET_STATS_LATENCY_TX_L2);
+
 	ret = net_l2_send(api->send, net_if_get_device(iface), iface, pkt);
 	if (ret != 0) {
 		eth_stats_update_errors_tx(iface);
@@ -1153,6 +1156,10 @@ void ethernet_init(struct net_if *iface)
 		ctx->ethernet_l2_flags |= NET_L2_PROMISC_MODE;
 	}
 
+	if (IS_ENABLED(CONFIG_NET_GRO_ETHERNET)) {
+		net_if_flag_set(iface, NET_IF_GRO);
+	}
+
 #if defined(CONFIG_NET_VLAN)
 	if (!(net_eth_get_hw_capabilities(iface) & ETHERNET_HW_VLAN)) {
 		return;
@@ -26,6 +26,8 @@ LOG_MODULE_REGISTER(net_ieee802154, CONFIG_NET_L2_IEEE802154_LOG_LEVEL);
 #include "ieee802154_security.h"
 #include "ieee802154_utils.h"
 #include "ieee802154_radio_utils.h"
+#include "ieee802154_tsch.h"
+#include "ieee802154_lpl.h"
 
 #define BUF_TIMEOUT K_MSEC(50)
 
@@ -167,13 +169,21 @@ static enum net_verdict ieee802154_recv(struct net_if *iface,
 					struct net_pkt *pkt)
 {
 	struct ieee802154_mpdu mpdu;
+	enum net_verdict verdict;
 	size_t hdr_len;
 
+	verdict = ieee802154_tsch_handle_eb(iface, pkt);
+	if (verdict != NET_CONTINUE) {
+		return verdict;
+	}
+
 	if (!ieee802154_validate_frame(net_pkt_data(pkt),
 				       net_pkt_get_len(pkt), &mpdu)) {
 		return NET_DROP;
 	}
 
+	ieee802154_tsch_handle_frame(iface, pkt, &mpdu);
+
 	if (mpdu.mhr.fs->fc.frame_type == IEEE802154_FRAME_TYPE_ACK) {
 		return NET_DROP;
 	}
@@ -195,6 +205,11 @@ static enum net_verdict ieee802154_recv(struct net_if *iface,
 
 	ieee802154_acknowledge(iface, &mpdu);
 
+	verdict = ieee802154_lpl_handle_frame(iface, &mpdu);
+	if (verdict != NET_CONTINUE) {
+		return verdict;
+	}
+
 	set_pkt_ll_addr(net_pkt_lladdr_src(pkt), mpdu.mhr.fs->fc.pan_id_comp,
 			mpdu.mhr.fs->fc.src_addr_mode, mpdu.mhr.src_addr);
 
@@ -349,4 +364,6 @@ void ieee802154_init(struct net_if *iface)
 	if (!ieee802154_set_tx_power(iface, tx_power)) {
 		ctx->tx_power = tx_power;
 	}
+
+	ieee802154_lpl_init(iface);
 }
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief IEEE 802.15.4 low-power listening private header
+ */
+
+#ifndef __IEEE802154_LPL_H__
+#define __IEEE802154_LPL_H__
+
+#include "ieee802154_frame.h"
+
+#ifdef CONFIG_NET_L2_IEEE802154_RADIO_LPL
+
+/* Start duty cycling the radio of the interface */
+void ieee802154_lpl_init(struct net_if *iface);
+
+/* Lets the radio be turned off once a data frame is received. Returns
+ * NET_DROP for the repetitions of an already received frame,
+ * NET_CONTINUE otherwise.
+ */
+enum net_verdict ieee802154_lpl_handle_frame(struct net_if *iface,
+					     struct ieee802154_mpdu *mpdu);
+
+#else
+
+#define ieee802154_lpl_init(...)
+#define ieee802154_lpl_handle_frame(...) NET_CONTINUE
+
+#endif /* CONFIG_NET_L2_IEEE802154_RADIO_LPL */
+
+#endif /* __IEEE802154_LPL_H__ */
@@ -0,0 +1,480 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Asynchronous low-power listening, in the manner of ContikiMAC
+ *
+ * The radio is off most of the time. Every check interval it is turned on
+ * for a few clear channel assessments, and stays on to receive a frame only
+ * if the channel was found busy. A sender repeats ("strobes") its frame
+ * until the receiver acknowledges it, during a whole check interval at
+ * most, or during the whole interval for broadcast frames. The time of the
+ * acknowledged strobe gives the wake-up phase of the receiver, so that the
+ * next frames to it are only strobed around its next wake-up.
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_ieee802154_lpl, CONFIG_NET_L2_IEEE802154_LOG_LEVEL);
+
+#include <net/net_core.h>
+#include <net/net_if.h>
+#include <net/ieee802154_lpl.h>
+
+#include <sys/util.h>
+#include <sys/byteorder.h>
+
+#include <string.h>
+#include <errno.h>
+
+#include "ieee802154_frame.h"
+#include "ieee802154_utils.h"
+#include "ieee802154_radio_utils.h"
+#include "ieee802154_lpl.h"
+
+#define CHECK_INTERVAL	(CONFIG_NET_L2_IEEE802154_LPL_CHECK_INTERVAL * 1000LL)
+#define CCA_COUNT	CONFIG_NET_L2_IEEE802154_LPL_CCA_COUNT
+#define CCA_SPACING	CONFIG_NET_L2_IEEE802154_LPL_CCA_SPACING
+#define LISTEN_TIME	CONFIG_NET_L2_IEEE802154_LPL_LISTEN_TIME
+#define PHASE_COUNT	CONFIG_NET_L2_IEEE802154_LPL_PHASE_COUNT
+#define PHASE_GUARD	CONFIG_NET_L2_IEEE802154_LPL_PHASE_GUARD
+
+/* Broadcast frames are strobed a bit longer than an interval, so that the
+ * checks of all the neighbors fall in.
+ */
+#define BROADCAST_STROBE_TIME	(CHECK_INTERVAL + CCA_COUNT * CCA_SPACING)
+
+/* Received frames remembered to drop their repetitions */
+#define DUPLICATE_COUNT	4
+
+struct lpl_addr {
+	uint8_t addr[IEEE802154_EXT_ADDR_LENGTH];
+	uint8_t len;
+};
+
+/* Wake-up phase of a neighbor, modulo the check interval */
+struct lpl_phase {
+	struct lpl_addr addr;
+	uint32_t phase;
+	bool used;
+};
+
+struct lpl_duplicate {
+	struct lpl_addr src;
+	uint8_t sequence;
+};
+
+static struct {
+	struct net_if *iface;
+
+#if PHASE_COUNT > 0
+	struct lpl_phase phases[PHASE_COUNT];
+	uint8_t next_phase;
+#endif
+	struct lpl_duplicate duplicates[DUPLICATE_COUNT];
+	uint8_t next_duplicate;
+
+	struct ieee802154_lpl_stats stats;
+	int64_t on_since;
+	bool radio_on;
+} lpl;
+
+/* Protects the radio, held during the checks and the transmissions */
+static K_MUTEX_DEFINE(lpl_lock);
+/* Protects the duplicates, taken in the RX path during the checks */
+static K_MUTEX_DEFINE(lpl_rx_lock);
+static K_SEM_DEFINE(lpl_rx, 0, 1);
+
+static K_KERNEL_STACK_DEFINE(lpl_stack,
+			     CONFIG_NET_L2_IEEE802154_LPL_STACK_SIZE);
+static struct k_thread lpl_thread;
+
+static inline int64_t lpl_now(void)
+{
+	return (int64_t)k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+static void sleep_until(int64_t time)
+{
+	int64_t now = lpl_now();
+
+	if (time > now) {
+		k_sleep(K_USEC(time - now));
+	}
+}
+
+static void radio_on(void)
+{
+	ieee802154_start(lpl.iface);
+
+	if (!lpl.radio_on) {
+		lpl.on_since = lpl_now();
+		lpl.radio_on = true;
+	}
+}
+
+/* Turn the radio off, accounting its on-time in the given counter */
+static void radio_off(uint64_t *on_time)
+{
+	ieee802154_stop(lpl.iface);
+
+	if (lpl.radio_on) {
+		*on_time += lpl_now() - lpl.on_since;
+		lpl.radio_on = false;
+	}
+}
+
+static void frame_addr(struct ieee802154_address_field *field, bool comp,
+		       uint8_t mode, struct lpl_addr *addr)
+{
+	struct ieee802154_address *ll;
+
+	addr->len = 0U;
+
+	if (!field) {
+		return;
+	}
+
+	ll = comp ? &field->comp.addr : &field->plain.addr;
+
+	if (mode == IEEE802154_ADDR_MODE_SHORT) {
+		addr->len = sizeof(ll->short_addr);
+		memcpy(addr->addr, &ll->short_addr, addr->len);
+	} else if (mode == IEEE802154_ADDR_MODE_EXTENDED) {
+		addr->len = IEEE802154_EXT_ADDR_LENGTH;
+		memcpy(addr->addr, ll->ext_addr, addr->len);
+	}
+}
+
+static inline bool addr_equal(struct lpl_addr *a, struct lpl_addr *b)
+{
+	return a->len == b->len && !memcmp(a->addr, b->addr, a->len);
+}
+
+static inline bool addr_is_broadcast(struct lpl_addr *addr)
+{
+	return !addr->len ||
+	       (addr->len == 2U &&
+		sys_get_le16(addr->addr) == IEEE802154_BROADCAST_ADDRESS);
+}
+
+#if PHASE_COUNT > 0
+static struct lpl_phase *phase_get(struct lpl_addr *addr)
+{
+	int i;
+
+	for (i = 0; i < PHASE_COUNT; i++) {
+		if (lpl.phases[i].used &&
+		    addr_equal(&lpl.phases[i].addr, addr)) {
+			return &lpl.phases[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void phase_set(struct lpl_addr *addr, int64_t wakeup)
+{
+	struct lpl_phase *phase = phase_get(addr);
+
+	if (!phase) {
+		/* Replace the oldest learnt phase */
+		phase = &lpl.phases[lpl.next_phase];
+		lpl.next_phase = (lpl.next_phase + 1) % PHASE_COUNT;
+		phase->addr = *addr;
+		phase->used = true;
+	}
+
+	phase->phase = wakeup % CHECK_INTERVAL;
+}
+
+static inline void phase_clear(struct lpl_phase *phase)
+{
+	phase->used = false;
+}
+
+/* Time to start strobing for the next wake-up of the neighbor */
+static int64_t phase_next(struct lpl_phase *phase, int64_t now)
+{
+	int64_t start = now - now % CHECK_INTERVAL + phase->phase -
+			PHASE_GUARD;
+
+	while (start < now) {
+		start += CHECK_INTERVAL;
+	}
+
+	return start;
+}
+#else
+#define phase_get(...) NULL
+#define phase_set(...)
+#define phase_clear(...)
+#define phase_next(...) 0
+#endif /* PHASE_COUNT > 0 */
+
+/* Repeat the frame until it is acknowledged or until the deadline. Returns
+ * the start time of the acknowledged transmission through ack_time.
+ */
+static int strobe(struct net_pkt *pkt, struct net_buf *frag,
+		  bool broadcast, int64_t deadline, int64_t *ack_time)
+{
+	struct ieee802154_context *ctx = net_if_l2_data(lpl.iface);
+	bool delivered = false;
+	bool ack_required;
+	int64_t start;
+	int ret;
+
+	do {
+		ack_required = prepare_for_ack(ctx, pkt, frag);
+		start = lpl_now();
+
+		ret = ieee802154_tx(lpl.iface, IEEE802154_TX_MODE_DIRECT,
+				    pkt, frag);
+		lpl.stats.tx_strobes++;
+
+		if (!ret) {
+			ret = wait_for_ack(lpl.iface, ack_required);
+		}
+
+		if (broadcast) {
+			delivered |= !ret;
+		} else if (!ret) {
+			*ack_time = start;
+			return 0;
+		}
+	} while (lpl_now() < deadline);
+
+	return delivered ? 0 : -EIO;
+}
+
+static inline int lpl_radio_send(struct net_if *iface,
+				 struct net_pkt *pkt,
+				 struct net_buf *frag)
+{
+	struct ieee802154_mpdu mpdu;
+	struct lpl_phase *phase;
+	struct lpl_addr dst;
+	int64_t start, deadline, ack_time;
+	uint64_t on_time = 0U;
+	bool broadcast;
+	int ret;
+
+	NET_DBG("frag %p", frag);
+
+	if (iface != lpl.iface) {
+		return -EINVAL;
+	}
+
+	if (!ieee802154_validate_frame(frag->data, frag->len, &mpdu)) {
+		return -EINVAL;
+	}
+
+	frame_addr(mpdu.mhr.dst_addr, false, mpdu.mhr.fs->fc.dst_addr_mode,
+		   &dst);
+	broadcast = addr_is_broadcast(&dst);
+
+	k_mutex_lock(&lpl_lock, K_FOREVER);
+
+	phase = broadcast ? NULL : phase_get(&dst);
+	if (phase) {
+		start = phase_next(phase, lpl_now());
+
+		/* Let the channel checks run meanwhile */
+		k_mutex_unlock(&lpl_lock);
+		sleep_until(start);
+		k_mutex_lock(&lpl_lock, K_FOREVER);
+
+		radio_on();
+		ret = strobe(pkt, frag, false, start + 2 * PHASE_GUARD,
+			     &ack_time);
+		if (!ret) {
+			lpl.stats.tx_phase_locked++;
+			goto done;
+		}
+
+		/* The neighbor drifted away, learn its phase again */
+		phase = phase_get(&dst);
+		if (phase) {
+			phase_clear(phase);
+		}
+	}
+
+	radio_on();
+	deadline = lpl_now() + (broadcast ? BROADCAST_STROBE_TIME :
+				CHECK_INTERVAL + PHASE_GUARD);
+	ret = strobe(pkt, frag, broadcast, deadline, &ack_time);
+
+done:
+	if (!ret && !broadcast) {
+		phase_set(&dst, ack_time);
+	}
+
+	if (ret) {
+		lpl.stats.tx_failed++;
+	} else {
+		lpl.stats.tx_delivered++;
+	}
+
+	radio_off(&on_time);
+	lpl.stats.tx_on_time += on_time;
+
+	k_mutex_unlock(&lpl_lock);
+
+	NET_DBG("%s frame %s, radio on for %u us", broadcast ? "Broadcast" :
+		"Unicast", ret ? "not delivered" : "delivered",
+		(uint32_t)on_time);
+
+	return ret;
+}
+
+static void lpl_check(void)
+{
+	bool busy = false;
+	int i;
+
+	k_mutex_lock(&lpl_lock, K_FOREVER);
+
+	radio_on();
+
+	for (i = 0; i < CCA_COUNT && !busy; i++) {
+		if (i) {
+			k_busy_wait(CCA_SPACING);
+		}
+
+		busy = ieee802154_cca(lpl.iface) == -EBUSY;
+	}
+
+	lpl.stats.rx_checks++;
+
+	if (busy) {
+		lpl.stats.rx_wakeups++;
+
+		/* Listen until a frame is received */
+		k_sem_reset(&lpl_rx);
+		k_sem_take(&lpl_rx, K_MSEC(LISTEN_TIME));
+	}
+
+	radio_off(&lpl.stats.rx_on_time);
+
+	k_mutex_unlock(&lpl_lock);
+}
+
+static void lpl_run(void *p1, void *p2, void *p3)
+{
+	int64_t next = lpl_now();
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		next += CHECK_INTERVAL;
+		sleep_until(next);
+
+		/* Catch up after a long transmission */
+		if (lpl_now() - next > CHECK_INTERVAL) {
+			next = lpl_now();
+		}
+
+		if (net_if_is_up(lpl.iface)) {
+			lpl_check();
+		}
+	}
+}
+
+enum net_verdict ieee802154_lpl_handle_frame(struct net_if *iface,
+					     struct ieee802154_mpdu *mpdu)
+{
+	struct lpl_duplicate *duplicate;
+	struct lpl_addr src;
+	int i;
+
+	if (iface != lpl.iface) {
+		return NET_CONTINUE;
+	}
+
+	frame_addr(mpdu->mhr.src_addr, mpdu->mhr.fs->fc.pan_id_comp,
+		   mpdu->mhr.fs->fc.src_addr_mode, &src);
+
+	k_mutex_lock(&lpl_rx_lock, K_FOREVER);
+
+	/* Repetitions are told apart by their source and sequence number */
+	for (i = 0; i < DUPLICATE_COUNT && src.len; i++) {
+		duplicate = &lpl.duplicates[i];
+
+		if (duplicate->sequence == mpdu->mhr.fs->sequence &&
+		    addr_equal(&duplicate->src, &src)) {
+			k_mutex_unlock(&lpl_rx_lock);
+			NET_DBG("Dropping repeated frame %u",
+				mpdu->mhr.fs->sequence);
+			return NET_DROP;
+		}
+	}
+
+	duplicate = &lpl.duplicates[lpl.next_duplicate];
+	lpl.next_duplicate = (lpl.next_duplicate + 1) % DUPLICATE_COUNT;
+	duplicate->src = src;
+	duplicate->sequence = mpdu->mhr.fs->sequence;
+
+	lpl.stats.rx_frames++;
+
+	k_mutex_unlock(&lpl_rx_lock);
+
+	/* Frame received, the radio can go back to sleep */
+	k_sem_give(&lpl_rx);
+
+	return NET_CONTINUE;
+}
+
+int ieee802154_lpl_get_stats(struct net_if *iface,
+			     struct ieee802154_lpl_stats *stats)
+{
+	if (!iface || iface != lpl.iface) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&lpl_lock, K_FOREVER);
+	k_mutex_lock(&lpl_rx_lock, K_FOREVER);
+
+	*stats = lpl.stats;
+
+	k_mutex_unlock(&lpl_rx_lock);
+	k_mutex_unlock(&lpl_lock);
+
+	return 0;
+}
+
+void ieee802154_lpl_init(struct net_if *iface)
+{
+	if (lpl.iface) {
+		NET_ERR("Only iface %p is duty cycled", lpl.iface);
+		return;
+	}
+
+	lpl.iface = iface;
+
+	k_thread_create(&lpl_thread, lpl_stack,
+			K_KERNEL_STACK_SIZEOF(lpl_stack),
+			lpl_run, NULL, NULL, NULL,
+			K_PRIO_COOP(CONFIG_NET_L2_IEEE802154_LPL_THREAD_PRIO),
+			0, K_FOREVER);
+	k_thread_name_set(&lpl_thread, "ieee802154_lpl");
+	k_thread_start(&lpl_thread);
+}
+
+static enum net_verdict lpl_radio_handle_ack(struct net_if *iface,
+					     struct net_pkt *pkt)
+{
+	struct ieee802154_context *ctx = net_if_l2_data(iface);
+
+	return handle_ack(ctx, pkt);
+}
+
+/* Declare the public Radio driver function used by the HW drivers */
+FUNC_ALIAS(lpl_radio_send,
+	   ieee802154_radio_send, int);
+
+FUNC_ALIAS(lpl_radio_handle_ack,
+	   ieee802154_radio_handle_ack, enum net_verdict);
@@ -0,0 +1,1405 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Time-Slotted Channel Hopping, see IEEE 802.15.4-2015 section 6.2.6
+ *
+ * Time is divided in timeslots numbered by the Absolute Slot Number (ASN)
+ * since the start of the network. A single thread runs the schedule: it
+ * sleeps until the next timeslot with a cell to use, sets the channel
+ * given by the hopping sequence, then transmits a queued frame or listens
+ * until the end of the timeslot. The radio is turned off in between.
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_ieee802154_tsch, CONFIG_NET_L2_IEEE802154_LOG_LEVEL);
+
+#include <net/net_core.h>
+#include <net/net_if.h>
+#include <net/ieee802154_tsch.h>
+
+#include <sys/util.h>
+#include <sys/slist.h>
+#include <sys/byteorder.h>
+#include <random/rand32.h>
+
+#include <string.h>
+#include <errno.h>
+
+#include "ieee802154_frame.h"
+#include "ieee802154_utils.h"
+#include "ieee802154_radio_utils.h"
+#include "ieee802154_tsch.h"
+
+#define TIMESLOT_LEN	CONFIG_NET_L2_IEEE802154_TSCH_TIMESLOT_LENGTH
+#define TX_OFFSET	CONFIG_NET_L2_IEEE802154_TSCH_TX_OFFSET
+#define GUARD_TIME	CONFIG_NET_L2_IEEE802154_TSCH_GUARD_TIME
+#define MAX_SLOTFRAMES	CONFIG_NET_L2_IEEE802154_TSCH_MAX_SLOTFRAMES
+#define MAX_CELLS	CONFIG_NET_L2_IEEE802154_TSCH_MAX_CELLS
+#define EB_PERIOD	CONFIG_NET_L2_IEEE802154_TSCH_EB_PERIOD
+#define DESYNC_TIMEOUT	CONFIG_NET_L2_IEEE802154_TSCH_DESYNC_TIMEOUT
+
+/* Time spent listening on each channel while scanning, in ms */
+#define SCAN_DWELL	(EB_PERIOD ? EB_PERIOD : 1000)
+
+/* Backoff exponents of the shared cells (macMinBe and macMaxBe) */
+#define MIN_BE		1
+#define MAX_BE		7
+
+/* Information Elements, see section 7.4 */
+#define IE_DESC_LEN			2
+#define IE_HEADER_TERMINATION_1		0x7e
+#define IE_HEADER_TERMINATION_2		0x7f
+#define IE_GROUP_MLME			0x1
+#define IE_GROUP_TERMINATION		0xf
+#define IE_SUB_CHANNEL_HOPPING		0x09
+#define IE_SUB_TSCH_SYNC		0x1a
+#define IE_SUB_TSCH_SLOTFRAME_LINK	0x1b
+#define IE_SUB_TSCH_TIMESLOT		0x1c
+
+#define EB_MAX_LEN	(IEEE802154_MTU - IEEE802154_MFR_LENGTH)
+
+struct tsch_slotframe {
+	uint16_t size;
+	uint8_t handle;
+};
+
+struct tsch_cell {
+	/* Neighbor address, in the byte order of the frames */
+	uint8_t neighbor[IEEE802154_EXT_ADDR_LENGTH];
+	uint16_t timeslot;
+	uint16_t channel_offset;
+	uint8_t slotframe;
+	uint8_t options;
+	bool any;
+	bool used;
+};
+
+/* Frame waiting for a transmit cell */
+struct tsch_tx {
+	sys_snode_t node;
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+	struct k_sem done;
+	int result;
+	uint8_t dst[IEEE802154_EXT_ADDR_LENGTH];
+	uint8_t attempts;
+	bool unicast;
+	bool eb;
+};
+
+static struct {
+	struct net_if *iface;
+
+	/* Sorted by handle */
+	struct tsch_slotframe slotframes[MAX_SLOTFRAMES];
+	uint8_t slotframe_count;
+	struct tsch_cell cells[MAX_CELLS];
+
+	uint16_t hopping[IEEE802154_TSCH_MAX_HOPPING_LEN];
+	uint8_t hopping_len;
+
+	sys_slist_t tx_queue;
+	struct tsch_tx eb_tx;
+	uint8_t eb_asn_offset;
+
+	/* Start of the timeslot of ASN 0, in us of uptime */
+	int64_t epoch;
+	int64_t last_sync;
+	int64_t next_eb;
+	uint8_t time_source[IEEE802154_EXT_ADDR_LENGTH];
+	uint8_t join_metric;
+
+	uint8_t scan_index;
+	uint8_t backoff;
+	uint8_t be;
+
+	bool radio_on;
+	bool running;
+	bool coordinator;
+	bool synchronized;
+} tsch = {
+	.hopping = { 16, 17, 23, 18, 26, 15, 25, 22,
+		     19, 11, 12, 13, 24, 14, 20, 21 },
+	.hopping_len = 16U,
+	.be = MIN_BE,
+};
+
+static K_MUTEX_DEFINE(tsch_lock);
+static K_SEM_DEFINE(tsch_wake, 0, 1);
+
+static K_KERNEL_STACK_DEFINE(tsch_stack,
+			     CONFIG_NET_L2_IEEE802154_TSCH_STACK_SIZE);
+static struct k_thread tsch_thread;
+static bool tsch_thread_created;
+
+static inline int64_t tsch_now(void)
+{
+	return (int64_t)k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+/* Reception time of a frame, the radio timestamp if there is one */
+static int64_t tsch_rx_time(struct net_pkt *pkt)
+{
+#if defined(CONFIG_NET_PKT_TIMESTAMP)
+	struct net_ptp_time *timestamp = net_pkt_timestamp(pkt);
+
+	if (timestamp->second || timestamp->nanosecond) {
+		return (int64_t)timestamp->second * USEC_PER_SEC +
+		       timestamp->nanosecond / NSEC_PER_USEC;
+	}
+#endif
+
+	return tsch_now();
+}
+
+static inline int64_t slot_start(uint64_t asn)
+{
+	return tsch.epoch + (int64_t)asn * TIMESLOT_LEN;
+}
+
+static inline uint64_t current_asn(int64_t now)
+{
+	return now < tsch.epoch ? 0 : (now - tsch.epoch) / TIMESLOT_LEN;
+}
+
+static inline uint16_t cell_channel(uint64_t asn, uint16_t channel_offset)
+{
+	return tsch.hopping[(asn + channel_offset) % tsch.hopping_len];
+}
+
+static void sleep_until(int64_t time)
+{
+	int64_t now = tsch_now();
+
+	if (time > now) {
+		k_sleep(K_USEC(time - now));
+	}
+}
+
+static int tsch_bind(struct net_if *iface)
+{
+	if (!iface || net_if_l2(iface) != &NET_L2_GET_NAME(IEEE802154)) {
+		return -EINVAL;
+	}
+
+	if (tsch.iface && tsch.iface != iface) {
+		NET_ERR("TSCH already runs on iface %p", tsch.iface);
+		return -EINVAL;
+	}
+
+	tsch.iface = iface;
+
+	return 0;
+}
+
+static void radio_set(bool on)
+{
+	if (on == tsch.radio_on) {
+		return;
+	}
+
+	if (on) {
+		ieee802154_start(tsch.iface);
+	} else {
+		ieee802154_stop(tsch.iface);
+	}
+
+	tsch.radio_on = on;
+}
+
+static struct tsch_slotframe *slotframe_get(uint8_t handle)
+{
+	uint8_t i;
+
+	for (i = 0U; i < tsch.slotframe_count; i++) {
+		if (tsch.slotframes[i].handle == handle) {
+			return &tsch.slotframes[i];
+		}
+	}
+
+	return NULL;
+}
+
+static bool cell_matches(struct tsch_cell *cell, struct tsch_tx *tx)
+{
+	if (!(cell->options & IEEE802154_TSCH_CELL_TX)) {
+		return false;
+	}
+
+	if (cell->any) {
+		return true;
+	}
+
+	return tx->unicast &&
+	       !memcmp(cell->neighbor, tx->dst, IEEE802154_EXT_ADDR_LENGTH);
+}
+
+static bool tx_has_cell(struct tsch_tx *tx)
+{
+	int i;
+
+	for (i = 0; i < MAX_CELLS; i++) {
+		if (tsch.cells[i].used && cell_matches(&tsch.cells[i], tx)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* First queued frame to transmit in the cell. A shared cell is skipped
+ * while backing off, which counts down when consume is set.
+ */
+static struct tsch_tx *cell_tx(struct tsch_cell *cell, bool consume)
+{
+	struct tsch_tx *tx;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tsch.tx_queue, tx, node) {
+		if (!cell_matches(cell, tx)) {
+			continue;
+		}
+
+		if ((cell->options & IEEE802154_TSCH_CELL_SHARED) &&
+		    tsch.backoff) {
+			if (consume) {
+				tsch.backoff--;
+			}
+
+			return NULL;
+		}
+
+		return tx;
+	}
+
+	return NULL;
+}
+
+static void tx_complete(struct tsch_tx *tx, int result)
+{
+	if (tx->eb) {
+		net_pkt_unref(tx->pkt);
+		tx->pkt = NULL;
+		return;
+	}
+
+	tx->result = result;
+	k_sem_give(&tx->done);
+}
+
+static void tx_flush(int result)
+{
+	sys_snode_t *node;
+
+	while ((node = sys_slist_get(&tsch.tx_queue))) {
+		tx_complete(CONTAINER_OF(node, struct tsch_tx, node), result);
+	}
+}
+
+static void tx_flush_unreachable(void)
+{
+	struct tsch_tx *tx, *next;
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tsch.tx_queue, tx, next, node) {
+		if (!tx_has_cell(tx)) {
+			sys_slist_find_and_remove(&tsch.tx_queue, &tx->node);
+			tx_complete(tx, -ENETUNREACH);
+		}
+	}
+}
+
+static int slotframe_add(uint8_t handle, uint16_t size)
+{
+	uint8_t i;
+
+	if (!size) {
+		return -EINVAL;
+	}
+
+	if (slotframe_get(handle)) {
+		return -EEXIST;
+	}
+
+	if (tsch.slotframe_count == MAX_SLOTFRAMES) {
+		return -ENOMEM;
+	}
+
+	for (i = tsch.slotframe_count;
+	     i > 0 && tsch.slotframes[i - 1].handle > handle; i--) {
+		tsch.slotframes[i] = tsch.slotframes[i - 1];
+	}
+
+	tsch.slotframes[i].handle = handle;
+	tsch.slotframes[i].size = size;
+	tsch.slotframe_count++;
+
+	return 0;
+}
+
+static int cell_add(uint8_t handle, const uint8_t *neighbor,
+		    uint16_t timeslot, uint16_t channel_offset,
+		    uint8_t options)
+{
+	struct tsch_slotframe *slotframe = slotframe_get(handle);
+	struct tsch_cell *free_cell = NULL;
+	int i;
+
+	if (!slotframe) {
+		return -ENOENT;
+	}
+
+	if (timeslot >= slotframe->size ||
+	    !(options & (IEEE802154_TSCH_CELL_TX | IEEE802154_TSCH_CELL_RX))) {
+		return -EINVAL;
+	}
+
+	for (i = 0; i < MAX_CELLS; i++) {
+		struct tsch_cell *cell = &tsch.cells[i];
+
+		if (!cell->used) {
+			if (!free_cell) {
+				free_cell = cell;
+			}
+
+			continue;
+		}
+
+		if (cell->slotframe == handle && cell->timeslot == timeslot &&
+		    cell->channel_offset == channel_offset) {
+			return -EEXIST;
+		}
+	}
+
+	if (!free_cell) {
+		return -ENOMEM;
+	}
+
+	free_cell->slotframe = handle;
+	free_cell->timeslot = timeslot;
+	free_cell->channel_offset = channel_offset;
+	free_cell->options = options;
+	free_cell->any = !neighbor;
+	free_cell->used = true;
+
+	if (neighbor) {
+		sys_memcpy_swap(free_cell->neighbor, neighbor,
+				IEEE802154_EXT_ADDR_LENGTH);
+	}
+
+	return 0;
+}
+
+/* Cell used in a timeslot: the first one with a frame to transmit, or else
+ * the first one to receive in, in the order of the slotframe handles.
+ */
+static struct tsch_cell *timeslot_cell(uint64_t asn, struct tsch_tx **tx)
+{
+	struct tsch_cell *rx_cell = NULL;
+	uint8_t i;
+	int j;
+
+	*tx = NULL;
+
+	for (i = 0U; i < tsch.slotframe_count; i++) {
+		struct tsch_slotframe *slotframe = &tsch.slotframes[i];
+		uint16_t timeslot = asn % slotframe->size;
+
+		for (j = 0; j < MAX_CELLS; j++) {
+			struct tsch_cell *cell = &tsch.cells[j];
+
+			if (!cell->used || cell->slotframe != slotframe->handle ||
+			    cell->timeslot != timeslot) {
+				continue;
+			}
+
+			*tx = cell_tx(cell, true);
+			if (*tx) {
+				return cell;
+			}
+
+			if (!rx_cell && (cell->options & IEEE802154_TSCH_CELL_RX)) {
+				rx_cell = cell;
+			}
+		}
+	}
+
+	return rx_cell;
+}
+
+/* Next timeslot after asn with a cell to receive in or with a queued frame
+ * to transmit in. Shared cells count while backing off, so that the
+ * backoff gets consumed.
+ */
+static bool next_active_timeslot(uint64_t asn, uint64_t *next)
+{
+	bool found = false;
+	int i;
+
+	for (i = 0; i < MAX_CELLS; i++) {
+		struct tsch_cell *cell = &tsch.cells[i];
+		struct tsch_slotframe *slotframe;
+		uint64_t candidate;
+		uint16_t timeslot;
+
+		if (!cell->used) {
+			continue;
+		}
+
+		if (!(cell->options & IEEE802154_TSCH_CELL_RX)) {
+			bool pending = false;
+			struct tsch_tx *tx;
+
+			SYS_SLIST_FOR_EACH_CONTAINER(&tsch.tx_queue, tx, node) {
+				if (cell_matches(cell, tx)) {
+					pending = true;
+					break;
+				}
+			}
+
+			if (!pending) {
+				continue;
+			}
+		}
+
+		slotframe = slotframe_get(cell->slotframe);
+		timeslot = (asn + 1) % slotframe->size;
+		candidate = asn + 1 +
+			(cell->timeslot + slotframe->size - timeslot) %
+			slotframe->size;
+
+		if (!found || candidate < *next) {
+			*next = candidate;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+static void slotframes_put(uint8_t **p, uint8_t *end)
+{
+	uint8_t *desc = *p;
+	uint8_t *count;
+	uint8_t i;
+	int j;
+
+	*p += IE_DESC_LEN;
+	count = (*p)++;
+	*count = 0U;
+
+	for (i = 0U; i < tsch.slotframe_count && end - *p >= 4; i++) {
+		struct tsch_slotframe *slotframe = &tsch.slotframes[i];
+		uint8_t *links;
+
+		*(*p)++ = slotframe->handle;
+		sys_put_le16(slotframe->size, *p);
+		*p += 2;
+		links = (*p)++;
+		*links = 0U;
+
+		/* Joining nodes only learn the cells shared with any node */
+		for (j = 0; j < MAX_CELLS && end - *p >= 5; j++) {
+			struct tsch_cell *cell = &tsch.cells[j];
+
+			if (!cell->used || !cell->any ||
+			    cell->slotframe != slotframe->handle ||
+			    !(cell->options & IEEE802154_TSCH_CELL_SHARED)) {
+				continue;
+			}
+
+			sys_put_le16(cell->timeslot, *p);
+			sys_put_le16(cell->channel_offset, *p + 2);
+			(*p)[4] = cell->options;
+			*p += 5;
+			(*links)++;
+		}
+
+		(*count)++;
+	}
+
+	/* Nested short IE: length (8 bits), sub-ID (7 bits), type 0 */
+	sys_put_le16((*p - desc - IE_DESC_LEN) |
+		     (IE_SUB_TSCH_SLOTFRAME_LINK << 8), desc);
+}
+
+static struct net_pkt *eb_create(void)
+{
+	struct ieee802154_context *ctx = net_if_l2_data(tsch.iface);
+	struct ieee802154_fcf_seq *fs;
+	struct net_pkt *pkt;
+	uint8_t *start, *p, *mlme;
+
+	pkt = net_pkt_alloc_with_buffer(tsch.iface, EB_MAX_LEN, AF_UNSPEC, 0,
+					K_NO_WAIT);
+	if (!pkt) {
+		return NULL;
+	}
+
+	if (net_buf_tailroom(pkt->buffer) < EB_MAX_LEN) {
+		net_pkt_unref(pkt);
+		return NULL;
+	}
+
+	start = net_pkt_data(pkt);
+	p = start;
+
+	fs = (struct ieee802154_fcf_seq *)p;
+	memset(fs, 0, IEEE802154_FCF_SEQ_LENGTH);
+	fs->fc.frame_type = IEEE802154_FRAME_TYPE_BEACON;
+	fs->fc.ie_list = 1U;
+	fs->fc.dst_addr_mode = IEEE802154_ADDR_MODE_NONE;
+	fs->fc.frame_version = IEEE802154_VERSION_802154;
+	fs->fc.src_addr_mode = IEEE802154_ADDR_MODE_EXTENDED;
+	fs->sequence = ctx->sequence++;
+	p += IEEE802154_FCF_SEQ_LENGTH;
+
+	sys_put_le16(ctx->pan_id, p);
+	p += 2;
+	memcpy(p, ctx->ext_addr, IEEE802154_EXT_ADDR_LENGTH);
+	p += IEEE802154_EXT_ADDR_LENGTH;
+
+	/* Header IE: length (7 bits), element ID (8 bits), type 0 */
+	sys_put_le16(IE_HEADER_TERMINATION_1 << 7, p);
+	p += IE_DESC_LEN;
+
+	mlme = p;
+	p += IE_DESC_LEN;
+
+	/* The ASN is only known at transmission */
+	sys_put_le16(6 | (IE_SUB_TSCH_SYNC << 8), p);
+	p += IE_DESC_LEN;
+	tsch.eb_asn_offset = p - start;
+	p += 5;
+	*p++ = tsch.join_metric;
+
+	/* Default timeslot template */
+	sys_put_le16(1 | (IE_SUB_TSCH_TIMESLOT << 8), p);
+	p += IE_DESC_LEN;
+	*p++ = 0U;
+
+	/* Nested long IE: length (11 bits), sub-ID (4 bits), type 1. The
+	 * hopping sequence is not advertised, only its identifier.
+	 */
+	sys_put_le16(1 | (IE_SUB_CHANNEL_HOPPING << 11) | BIT(15), p);
+	p += IE_DESC_LEN;
+	*p++ = 0U;
+
+	slotframes_put(&p, start + EB_MAX_LEN);
+
+	/* Payload IE: length (11 bits), group ID (4 bits), type 1 */
+	sys_put_le16((p - mlme - IE_DESC_LEN) | (IE_GROUP_MLME << 11) | BIT(15),
+		     mlme);
+
+	net_buf_add(pkt->buffer, p - start);
+
+	return pkt;
+}
+
+static void eb_schedule(int64_t now)
+{
+	struct net_pkt *pkt;
+
+	if (!EB_PERIOD || now < tsch.next_eb || tsch.eb_tx.pkt) {
+		return;
+	}
+
+	tsch.next_eb = now + EB_PERIOD * 1000LL;
+
+	pkt = eb_create();
+	if (!pkt) {
+		NET_DBG("Could not create EB");
+		return;
+	}
+
+	memset(&tsch.eb_tx, 0, sizeof(tsch.eb_tx));
+	tsch.eb_tx.pkt = pkt;
+	tsch.eb_tx.frag = pkt->buffer;
+	tsch.eb_tx.eb = true;
+
+	if (!tx_has_cell(&tsch.eb_tx)) {
+		tx_complete(&tsch.eb_tx, -ENETUNREACH);
+		return;
+	}
+
+	sys_slist_append(&tsch.tx_queue, &tsch.eb_tx.node);
+}
+
+static int tsch_transmit(struct tsch_tx *tx, uint64_t asn)
+{
+	struct ieee802154_context *ctx = net_if_l2_data(tsch.iface);
+	bool ack_required;
+	int ret;
+
+	if (tx->eb) {
+		uint8_t *p = tx->frag->data + tsch.eb_asn_offset;
+
+		sys_put_le32((uint32_t)asn, p);
+		p[4] = (uint8_t)(asn >> 32);
+	}
+
+	ack_required = prepare_for_ack(ctx, tx->pkt, tx->frag);
+
+	ret = ieee802154_tx(tsch.iface, IEEE802154_TX_MODE_DIRECT,
+			    tx->pkt, tx->frag);
+	if (ret) {
+		return ret;
+	}
+
+	return wait_for_ack(tsch.iface, ack_required);
+}
+
+static void tsch_tx_done(struct tsch_tx *tx, bool shared, int ret)
+{
+	k_mutex_lock(&tsch_lock, K_FOREVER);
+
+	if (shared) {
+		if (ret) {
+			tsch.be = MIN(tsch.be + 1, MAX_BE);
+			tsch.backoff = sys_rand32_get() & ((1 << tsch.be) - 1);
+		} else {
+			tsch.be = MIN_BE;
+		}
+	}
+
+	tx->attempts++;
+
+	if (ret && tsch.running && tsch.synchronized &&
+	    tx->attempts < CONFIG_NET_L2_IEEE802154_RADIO_TX_RETRIES &&
+	    tx_has_cell(tx)) {
+		sys_slist_prepend(&tsch.tx_queue, &tx->node);
+		k_mutex_unlock(&tsch_lock);
+		return;
+	}
+
+	tx_complete(tx, ret);
+
+	k_mutex_unlock(&tsch_lock);
+}
+
+static void tsch_desync(void)
+{
+	NET_DBG("Lost synchronization");
+
+	tsch.synchronized = false;
+	tx_flush(-ENETDOWN);
+}
+
+static void tsch_scan(void)
+{
+	uint16_t channel;
+
+	k_mutex_lock(&tsch_lock, K_FOREVER);
+	channel = tsch.hopping[tsch.scan_index++ % tsch.hopping_len];
+	k_mutex_unlock(&tsch_lock);
+
+	NET_DBG("Scanning channel %u", channel);
+
+	ieee802154_set_channel(tsch.iface, channel);
+	radio_set(true);
+
+	k_sem_take(&tsch_wake, K_MSEC(SCAN_DWELL));
+}
+
+static void tsch_timeslot(void)
+{
+	struct tsch_cell *cell;
+	struct tsch_tx *tx;
+	int64_t now, wakeup;
+	uint64_t asn, next = 0U;
+	uint16_t channel;
+	bool active, shared;
+	int ret;
+
+	k_mutex_lock(&tsch_lock, K_FOREVER);
+
+	now = tsch_now();
+	asn = current_asn(now);
+
+	if (!tsch.coordinator && DESYNC_TIMEOUT &&
+	    now - tsch.last_sync > DESYNC_TIMEOUT * 1000LL) {
+		tsch_desync();
+		k_mutex_unlock(&tsch_lock);
+		return;
+	}
+
+	eb_schedule(now);
+
+	active = next_active_timeslot(asn, &next);
+	if (active) {
+		wakeup = slot_start(next) + TX_OFFSET - GUARD_TIME;
+	} else {
+		wakeup = INT64_MAX;
+	}
+
+	if (EB_PERIOD && tsch.next_eb < wakeup) {
+		wakeup = tsch.next_eb;
+		active = false;
+	}
+
+	if (!active || next > asn + 1) {
+		radio_set(false);
+	}
+
+	k_mutex_unlock(&tsch_lock);
+
+	if (wakeup == INT64_MAX) {
+		k_sem_take(&tsch_wake, K_FOREVER);
+		return;
+	}
+
+	/* Woken up earlier when the queue or the schedule changed */
+	if (k_sem_take(&tsch_wake, wakeup > now ? K_USEC(wakeup - now) :
+		       K_NO_WAIT) == 0 || !active) {
+		return;
+	}
+
+	k_mutex_lock(&tsch_lock, K_FOREVER);
+
+	if (!tsch.running || !tsch.synchronized) {
+		k_mutex_unlock(&tsch_lock);
+		return;
+	}
+
+	cell = timeslot_cell(next, &tx);
+	if (!cell) {
+		k_mutex_unlock(&tsch_lock);
+		return;
+	}
+
+	if (tx) {
+		sys_slist_find_and_remove(&tsch.tx_queue, &tx->node);
+	}
+
+	channel = cell_channel(next, cell->channel_offset);
+	shared = !!(cell->options & IEEE802154_TSCH_CELL_SHARED);
+
+	k_mutex_unlock(&tsch_lock);
+
+	NET_DBG("ASN %llu channel %u %s", next, channel, tx ? "tx" : "rx");
+
+	ieee802154_set_channel(tsch.iface, channel);
+	radio_set(true);
+
+	if (tx) {
+		sleep_until(slot_start(next) + TX_OFFSET);
+		ret = tsch_transmit(tx, next);
+		tsch_tx_done(tx, shared, ret);
+	}
+
+	sleep_until(slot_start(next + 1));
+}
+
+static void tsch_run(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		bool running, synchronized;
+
+		k_mutex_lock(&tsch_lock, K_FOREVER);
+		running = tsch.running;
+		synchronized = tsch.synchronized;
+		k_mutex_unlock(&tsch_lock);
+
+		if (!running) {
+			radio_set(false);
+			k_sem_take(&tsch_wake, K_FOREVER);
+		} else if (!synchronized) {
+			tsch_scan();
+		} else {
+			tsch_timeslot();
+		}
+	}
+}
+
+struct eb_info {
+	uint8_t *src;
+	uint8_t *slotframes;
+	uint64_t asn;
+	uint16_t slotframes_len;
+	uint16_t pan_id;
+	uint8_t join_metric;
+	bool has_pan_id;
+	bool has_sync;
+};
+
+static void eb_parse_mlme(uint8_t *p, uint16_t len, struct eb_info *eb)
+{
+	uint8_t *end = p + len;
+
+	while (end - p >= IE_DESC_LEN) {
+		uint16_t desc = sys_get_le16(p);
+		uint16_t ie_len;
+		uint8_t sub_id;
+
+		if (desc & BIT(15)) {
+			ie_len = desc & 0x7ff;
+			sub_id = (desc >> 11) & 0xf;
+		} else {
+			ie_len = desc & 0xff;
+			sub_id = (desc >> 8) & 0x7f;
+		}
+
+		p += IE_DESC_LEN;
+		if (end - p < ie_len) {
+			return;
+		}
+
+		if (!(desc & BIT(15)) && sub_id == IE_SUB_TSCH_SYNC &&
+		    ie_len >= 6) {
+			eb->asn = sys_get_le32(p) | ((uint64_t)p[4] << 32);
+			eb->join_metric = p[5];
+			eb->has_sync = true;
+		} else if (!(desc & BIT(15)) &&
+			   sub_id == IE_SUB_TSCH_SLOTFRAME_LINK) {
+			eb->slotframes = p;
+			eb->slotframes_len = ie_len;
+		}
+
+		p += ie_len;
+	}
+}
+
+static bool eb_parse(uint8_t *buf, uint16_t len, struct eb_info *eb)
+{
+	struct ieee802154_fcf_seq *fs = (struct ieee802154_fcf_seq *)buf;
+	uint8_t *end = buf + len;
+	uint8_t *p = buf + IEEE802154_FCF_SEQ_LENGTH;
+
+	if (fs->fc.security_enabled ||
+	    fs->fc.dst_addr_mode != IEEE802154_ADDR_MODE_NONE ||
+	    fs->fc.src_addr_mode != IEEE802154_ADDR_MODE_EXTENDED) {
+		return false;
+	}
+
+	if (fs->fc.seq_num_suppr) {
+		p--;
+	}
+
+	if (!fs->fc.pan_id_comp) {
+		if (end - p < 2) {
+			return false;
+		}
+
+		eb->pan_id = sys_get_le16(p);
+		eb->has_pan_id = true;
+		p += 2;
+	}
+
+	if (end - p < IEEE802154_EXT_ADDR_LENGTH) {
+		return false;
+	}
+
+	eb->src = p;
+	p += IEEE802154_EXT_ADDR_LENGTH;
+
+	/* Header IEs, up to the termination preceding the payload IEs */
+	while (true) {
+		uint16_t desc;
+		uint8_t id;
+
+		if (end - p < IE_DESC_LEN) {
+			return false;
+		}
+
+		desc = sys_get_le16(p);
+		id = (desc >> 7) & 0xff;
+		p += IE_DESC_LEN + (desc & 0x7f);
+
+		if (end < p || id == IE_HEADER_TERMINATION_2) {
+			return false;
+		}
+
+		if (id == IE_HEADER_TERMINATION_1) {
+			break;
+		}
+	}
+
+	/* Payload IEs, a trailing FCS is left over */
+	while (end - p >= IE_DESC_LEN) {
+		uint16_t desc = sys_get_le16(p);
+		uint16_t ie_len = desc & 0x7ff;
+		uint8_t group = (desc >> 11) & 0xf;
+
+		p += IE_DESC_LEN;
+		if (end - p < ie_len || group == IE_GROUP_TERMINATION) {
+			break;
+		}
+
+		if (group == IE_GROUP_MLME) {
+			eb_parse_mlme(p, ie_len, eb);
+		}
+
+		p += ie_len;
+	}
+
+	return eb->has_sync;
+}
+
+/* Add the advertised slotframes which are not in the schedule yet */
+static void eb_install_schedule(struct eb_info *eb)
+{
+	uint8_t *p = eb->slotframes;
+	uint8_t *end = p + eb->slotframes_len;
+	uint8_t count;
+
+	if (!p || end - p < 1) {
+		return;
+	}
+
+	for (count = *p++; count && end - p >= 4; count--) {
+		uint8_t handle = p[0];
+		uint8_t links = p[3];
+		bool added;
+
+		added = slotframe_add(handle, sys_get_le16(p + 1)) == 0;
+		p += 4;
+
+		for (; links && end - p >= 5; links--, p += 5) {
+			if (added) {
+				cell_add(handle, NULL, sys_get_le16(p),
+					 sys_get_le16(p + 2), p[4]);
+			}
+		}
+	}
+}
+
+enum net_verdict ieee802154_tsch_handle_eb(struct net_if *iface,
+					   struct net_pkt *pkt)
+{
+	struct ieee802154_context *ctx = net_if_l2_data(iface);
+	struct ieee802154_fcf_seq *fs;
+	struct eb_info eb = { 0 };
+	int64_t rx_time = tsch_rx_time(pkt);
+
+	if (pkt->buffer->len < IEEE802154_FCF_SEQ_LENGTH) {
+		return NET_CONTINUE;
+	}
+
+	fs = (struct ieee802154_fcf_seq *)net_pkt_data(pkt);
+	if (fs->fc.frame_type != IEEE802154_FRAME_TYPE_BEACON ||
+	    fs->fc.frame_version != IEEE802154_VERSION_802154 ||
+	    !fs->fc.ie_list) {
+		return NET_CONTINUE;
+	}
+
+	if (!eb_parse(net_pkt_data(pkt), pkt->buffer->len, &eb)) {
+		return NET_DROP;
+	}
+
+	k_mutex_lock(&tsch_lock, K_FOREVER);
+
+	if (iface != tsch.iface || !tsch.running || tsch.coordinator) {
+		goto out;
+	}
+
+	if (!tsch.synchronized) {
+		NET_DBG("Joining at ASN %llu", eb.asn);
+
+		memcpy(tsch.time_source, eb.src, IEEE802154_EXT_ADDR_LENGTH);
+		tsch.join_metric = eb.join_metric + 1U;
+		tsch.next_eb = tsch_now();
+		tsch.synchronized = true;
+
+		if (eb.has_pan_id) {
+			ctx->pan_id = eb.pan_id;
+			ieee802154_filter_pan_id(iface, eb.pan_id);
+		}
+
+		eb_install_schedule(&eb);
+
+		k_sem_give(&tsch_wake);
+	} else if (memcmp(eb.src, tsch.time_source,
+			  IEEE802154_EXT_ADDR_LENGTH)) {
+		goto out;
+	}
+
+	tsch.epoch = rx_time - TX_OFFSET - (int64_t)eb.asn * TIMESLOT_LEN;
+	tsch.last_sync = rx_time;
+
+out:
+	k_mutex_unlock(&tsch_lock);
+
+	net_pkt_unref(pkt);
+
+	return NET_OK;
+}
+
+void ieee802154_tsch_handle_frame(struct net_if *iface, struct net_pkt *pkt,
+				  struct ieee802154_mpdu *mpdu)
+{
+	int64_t rx_time = tsch_rx_time(pkt);
+	int64_t offset;
+	uint8_t *src;
+
+	if (mpdu->mhr.fs->fc.src_addr_mode != IEEE802154_ADDR_MODE_EXTENDED) {
+		return;
+	}
+
+	if (mpdu->mhr.fs->fc.pan_id_comp) {
+		src = mpdu->mhr.src_addr->comp.addr.ext_addr;
+	} else {
+		src = mpdu->mhr.src_addr->plain.addr.ext_addr;
+	}
+
+	k_mutex_lock(&tsch_lock, K_FOREVER);
+
+	if (iface != tsch.iface || !tsch.synchronized || tsch.coordinator ||
+	    memcmp(src, tsch.time_source, IEEE802154_EXT_ADDR_LENGTH)) {
+		goto out;
+	}
+
+	/* Frames are expected at the TX offset of the timeslot. One received
+	 * early can be in the previous timeslot, the offset is taken to the
+	 * nearest expected time.
+	 */
+	offset = (rx_time - tsch.epoch - TX_OFFSET) % TIMESLOT_LEN;
+	if (offset > TIMESLOT_LEN / 2) {
+		offset -= TIMESLOT_LEN;
+	} else if (offset <= -TIMESLOT_LEN / 2) {
+		offset += TIMESLOT_LEN;
+	}
+
+	if (offset > -GUARD_TIME && offset < GUARD_TIME) {
+		tsch.epoch += offset;
+		tsch.last_sync = rx_time;
+	}
+
+out:
+	k_mutex_unlock(&tsch_lock);
+}
+
+int ieee802154_tsch_slotframe_add(struct net_if *iface, uint8_t handle,
+				  uint16_t size)
+{
+	int ret;
+
+	k_mutex_lock(&tsch_lock, K_FOREVER);
+
+	ret = tsch_bind(iface);
+	if (!ret) {
+		ret = slotframe_add(handle, size);
+	}
+
+	k_mutex_unlock(&tsch_lock);
+
+	k_sem_give(&tsch_wake);
+
+	return ret;
+}
+
+int ieee802154_tsch_slotframe_remove(struct net_if *iface, uint8_t handle)
+{
+	struct tsch_slotframe *slotframe;
+	int ret = -ENOENT;
+	int i;
+
+	k_mutex_lock(&tsch_lock, K_FOREVER);
+
+	if (iface != tsch.iface) {
+		goto out;
+	}
+
+	slotframe = slotframe_get(handle);
+	if (!slotframe) {
+		goto out;
+	}
+
+	for (i = 0; i < MAX_CELLS; i++) {
+		if (tsch.cells[i].used && tsch.cells[i].slotframe == handle) {
+			tsch.cells[i].used = false;
+		}
+	}
+
+	tsch.slotframe_count--;
+	memmove(slotframe, slotframe + 1,
+		(uint8_t *)&tsch.slotframes[tsch.slotframe_count] -
+		(uint8_t *)slotframe);
+
+	tx_flush_unreachable();
+	ret = 0;
+
+out:
+	k_mutex_unlock(&tsch_lock);
+
+	k_sem_give(&tsch_wake);
+
+	return ret;
+}
+
+int ieee802154_tsch_cell_add(struct net_if *iface, uint8_t handle,
+			     const struct ieee802154_tsch_cell *cell)
+{
+	int ret;
+
+	if (!cell) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&tsch_lock, K_FOREVER);
+
+	ret = tsch_bind(iface);
+	if (!ret) {
+		ret = cell_add(handle, cell->neighbor, cell->timeslot,
+			       cell->channel_offset, cell->options);
+	}
+
+	k_mutex_unlock(&tsch_lock);
+
+	k_sem_give(&tsch_wake);
+
+	return ret;
+}
+
+int ieee802154_tsch_cell_remove(struct net_if *iface, uint8_t handle,
+				uint16_t timeslot, uint16_t channel_offset)
+{
+	int ret = -ENOENT;
+	int i;
+
+	k_mutex_lock(&tsch_lock, K_FOREVER);
+
+	if (iface != tsch.iface) {
+		goto out;
+	}
+
+	for (i = 0; i < MAX_CELLS; i++) {
+		struct tsch_cell *cell = &tsch.cells[i];
+
+		if (cell->used && cell->slotframe == handle &&
+		    cell->timeslot == timeslot &&
+		    cell->channel_offset == channel_offset) {
+			cell->used = false;
+			tx_flush_unreachable();
+			ret = 0;
+			break;
+		}
+	}
+
+out:
+	k_mutex_unlock(&tsch_lock);
+
+	k_sem_give(&tsch_wake);
+
+	return ret;
+}
+
+int ieee802154_tsch_minimal_schedule(struct net_if *iface, uint16_t size)
+{
+	struct ieee802154_tsch_cell cell = {
+		.neighbor = NULL,
+		.timeslot = 0U,
+		.channel_offset = 0U,
+		.options = IEEE802154_TSCH_CELL_TX | IEEE802154_TSCH_CELL_RX |
+			   IEEE802154_TSCH_CELL_SHARED |
+			   IEEE802154_TSCH_CELL_TIMEKEEPING,
+	};
+	int ret;
+
+	ret = ieee802154_tsch_slotframe_add(iface, 0U, size);
+	if (ret) {
+		return ret;
+	}
+
+	ret = ieee802154_tsch_cell_add(iface, 0U, &cell);
+	if (ret) {
+		ieee802154_tsch_slotframe_remove(iface, 0U);
+	}
+
+	return ret;
+}
+
+int ieee802154_tsch_set_hopping_sequence(struct net_if *iface,
+					 const uint16_t *channels,
+					 uint8_t len)
+{
+	int ret;
+
+	if (!channels || !len || len > IEEE802154_TSCH_MAX_HOPPING_LEN) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&tsch_lock, K_FOREVER);
+
+	ret = tsch_bind(iface);
+	if (!ret) {
+		memcpy(tsch.hopping, channels, len * sizeof(uint16_t));
+		tsch.hopping_len = len;
+	}
+
+	k_mutex_unlock(&tsch_lock);
+
+	return ret;
+}
+
+int ieee802154_tsch_start(struct net_if *iface, bool coordinator)
+{
+	int ret;
+
+	k_mutex_lock(&tsch_lock, K_FOREVER);
+
+	ret = tsch_bind(iface);
+	if (ret) {
+		goto out;
+	}
+
+	if (tsch.running) {
+		ret = -EALREADY;
+		goto out;
+	}
+
+	if (!net_if_is_up(iface)) {
+		ret = -ENETDOWN;
+		goto out;
+	}
+
+	tsch.running = true;
+	tsch.coordinator = coordinator;
+	tsch.synchronized = coordinator;
+	tsch.backoff = 0U;
+	tsch.be = MIN_BE;
+	/* The radio was started along with the interface */
+	tsch.radio_on = true;
+
+	if (coordinator) {
+		tsch.epoch = tsch_now();
+		tsch.last_sync = tsch.epoch;
+		tsch.next_eb = tsch.epoch;
+		tsch.join_metric = 0U;
+	}
+
+	if (!tsch_thread_created) {
+		k_thread_create(&tsch_thread, tsch_stack,
+				K_KERNEL_STACK_SIZEOF(tsch_stack),
+				tsch_run, NULL, NULL, NULL,
+				K_PRIO_COOP(CONFIG_NET_L2_IEEE802154_TSCH_THREAD_PRIO),
+				0, K_FOREVER);
+		k_thread_name_set(&tsch_thread, "ieee802154_tsch");
+		k_thread_start(&tsch_thread);
+		tsch_thread_created = true;
+	}
+
+	NET_DBG("Started TSCH on iface %p as %s", iface,
+		coordinator ? "coordinator" : "joining node");
+
+out:
+	k_mutex_unlock(&tsch_lock);
+
+	k_sem_give(&tsch_wake);
+
+	return ret;
+}
+
+int ieee802154_tsch_stop(struct net_if *iface)
+{
+	int ret = 0;
+
+	k_mutex_lock(&tsch_lock, K_FOREVER);
+
+	if (iface != tsch.iface || !tsch.running) {
+		ret = -EALREADY;
+		goto out;
+	}
+
+	tsch.running = false;
+	tsch.synchronized = false;
+	tx_flush(-ENETDOWN);
+
+out:
+	k_mutex_unlock(&tsch_lock);
+
+	k_sem_give(&tsch_wake);
+
+	return ret;
+}
+
+bool ieee802154_tsch_is_synchronized(struct net_if *iface)
+{
+	bool synchronized;
+
+	k_mutex_lock(&tsch_lock, K_FOREVER);
+	synchronized = iface == tsch.iface && tsch.synchronized;
+	k_mutex_unlock(&tsch_lock);
+
+	return synchronized;
+}
+
+uint64_t ieee802154_tsch_asn(struct net_if *iface)
+{
+	uint64_t asn = 0U;
+
+	k_mutex_lock(&tsch_lock, K_FOREVER);
+
+	if (iface == tsch.iface && tsch.synchronized) {
+		asn = current_asn(tsch_now());
+	}
+
+	k_mutex_unlock(&tsch_lock);
+
+	return asn;
+}
+
+static inline int tsch_radio_send(struct net_if *iface,
+				  struct net_pkt *pkt,
+				  struct net_buf *frag)
+{
+	struct ieee802154_mpdu mpdu;
+	struct tsch_tx tx = { 0 };
+
+	NET_DBG("frag %p", frag);
+
+	if (!ieee802154_validate_frame(frag->data, frag->len, &mpdu)) {
+		return -EINVAL;
+	}
+
+	tx.pkt = pkt;
+	tx.frag = frag;
+	k_sem_init(&tx.done, 0, 1);
+
+	if (mpdu.mhr.fs->fc.dst_addr_mode == IEEE802154_ADDR_MODE_EXTENDED) {
+		memcpy(tx.dst, mpdu.mhr.dst_addr->plain.addr.ext_addr,
+		       IEEE802154_EXT_ADDR_LENGTH);
+		tx.unicast = true;
+	}
+
+	k_mutex_lock(&tsch_lock, K_FOREVER);
+
+	if (iface != tsch.iface || !tsch.synchronized) {
+		k_mutex_unlock(&tsch_lock);
+		return -ENETDOWN;
+	}
+
+	if (!tx_has_cell(&tx)) {
+		k_mutex_unlock(&tsch_lock);
+		return -ENETUNREACH;
+	}
+
+	sys_slist_append(&tsch.tx_queue, &tx.node);
+
+	k_mutex_unlock(&tsch_lock);
+
+	k_sem_give(&tsch_wake);
+	k_sem_take(&tx.done, K_FOREVER);
+
+	return tx.result;
+}
+
+static enum net_verdict tsch_radio_handle_ack(struct net_if *iface,
+					      struct net_pkt *pkt)
+{
+	struct ieee802154_context *ctx = net_if_l2_data(iface);
+
+	return handle_ack(ctx, pkt);
+}
+
+/* Declare the public Radio driver function used by the HW drivers */
+FUNC_ALIAS(tsch_radio_send,
+	   ieee802154_radio_send, int);
+
+FUNC_ALIAS(tsch_radio_handle_ack,
+	   ieee802154_radio_handle_ack, enum net_verdict);
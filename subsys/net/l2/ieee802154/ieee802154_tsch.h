@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief IEEE 802.15.4 TSCH private header
+ */
+
+#ifndef __IEEE802154_TSCH_H__
+#define __IEEE802154_TSCH_H__
+
+#include "ieee802154_frame.h"
+
+#ifdef CONFIG_NET_L2_IEEE802154_RADIO_TSCH
+
+/* Enhanced beacons are handled before the frame validation, which does
+ * not know about Information Elements. Returns NET_CONTINUE for other
+ * frames.
+ */
+enum net_verdict ieee802154_tsch_handle_eb(struct net_if *iface,
+					   struct net_pkt *pkt);
+
+/* Keep the node synchronized with the frames of its time source */
+void ieee802154_tsch_handle_frame(struct net_if *iface, struct net_pkt *pkt,
+				  struct ieee802154_mpdu *mpdu);
+
+#else
+
+#define ieee802154_tsch_handle_eb(...) NET_CONTINUE
+#define ieee802154_tsch_handle_frame(...)
+
+#endif /* CONFIG_NET_L2_IEEE802154_RADIO_TSCH */
+
+#endif /* __IEEE802154_TSCH_H__ */
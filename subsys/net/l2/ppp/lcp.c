@@ -60,6 +60,8 @@ static enum net_verdict lcp_handle(struct ppp_context *ctx,
 struct lcp_option_data {
 	bool auth_proto_present;
 	uint16_t auth_proto;
+	bool acfc;
+	bool pfc;
 };
 
 static const enum ppp_protocol_type lcp_supported_auth_protos[] = {
@@ -103,9 +105,36 @@ static int lcp_auth_proto_nack(struct ppp_fsm *fsm, struct net_pkt *ret_pkt,
 	return net_pkt_write_be16(ret_pkt, PPP_PAP);
 }
 
+#if defined(CONFIG_NET_L2_PPP_OPTION_COMPRESSION)
+static int lcp_acfc_parse(struct ppp_fsm *fsm, struct net_pkt *pkt,
+			  void *user_data)
+{
+	struct lcp_option_data *data = user_data;
+
+	data->acfc = true;
+
+	return 0;
+}
+
+static int lcp_pfc_parse(struct ppp_fsm *fsm, struct net_pkt *pkt,
+			 void *user_data)
+{
+	struct lcp_option_data *data = user_data;
+
+	data->pfc = true;
+
+	return 0;
+}
+#endif
+
 static const struct ppp_peer_option_info lcp_peer_options[] = {
 	PPP_PEER_OPTION(LCP_OPTION_AUTH_PROTO, lcp_auth_proto_parse,
 			lcp_auth_proto_nack),
+#if defined(CONFIG_NET_L2_PPP_OPTION_COMPRESSION)
+	/* These options have no value, they are never nacked */
+	PPP_PEER_OPTION(LCP_OPTION_PROTO_COMPRESS, lcp_pfc_parse, NULL),
+	PPP_PEER_OPTION(LCP_OPTION_ADDR_CTRL_COMPRESS, lcp_acfc_parse, NULL),
+#endif
 };
 
 static int lcp_config_info_req(struct ppp_fsm *fsm,
@@ -130,6 +159,8 @@ static int lcp_config_info_req(struct ppp_fsm *fsm,
 	}
 
 	ctx->lcp.peer_options.auth_proto = data.auth_proto;
+	ctx->lcp.peer_options.acfc = data.acfc;
+	ctx->lcp.peer_options.pfc = data.pfc;
 
 	if (data.auth_proto_present) {
 		NET_DBG("Authentication protocol negotiated: %x (%s)",
@@ -172,6 +203,14 @@ static void lcp_down(struct ppp_fsm *fsm)
 	memset(&ctx->lcp.peer_options.auth_proto, 0,
 	       sizeof(ctx->lcp.peer_options.auth_proto));
 
+	/* The frames are sent and received uncompressed until the next
+	 * negotiation.
+	 */
+	ctx->lcp.my_options.acfc = false;
+	ctx->lcp.my_options.pfc = false;
+	ctx->lcp.peer_options.acfc = false;
+	ctx->lcp.peer_options.pfc = false;
+
 	ppp_link_down(ctx);
 
 	ppp_change_phase(ctx, PPP_ESTABLISH);
@@ -184,6 +223,24 @@ static void lcp_up(struct ppp_fsm *fsm)
 
 	/* TODO: Set MRU/MTU of the network interface here */
 
+#if defined(CONFIG_NET_L2_PPP_OPTION_COMPRESSION)
+	/* Our last Configure-Request was acked as is, so the options the
+	 * peer did not reject are in use.
+	 */
+	ctx->lcp.my_options.acfc =
+		!(ppp_my_option_flags(fsm, LCP_OPTION_ADDR_CTRL_COMPRESS) &
+		  PPP_MY_OPTION_REJECTED);
+	ctx->lcp.my_options.pfc =
+		!(ppp_my_option_flags(fsm, LCP_OPTION_PROTO_COMPRESS) &
+		  PPP_MY_OPTION_REJECTED);
+
+	NET_DBG("Compression: ACFC %s/%s, PFC %s/%s (rx/tx)",
+		ctx->lcp.my_options.acfc ? "on" : "off",
+		ctx->lcp.peer_options.acfc ? "on" : "off",
+		ctx->lcp.my_options.pfc ? "on" : "off",
+		ctx->lcp.peer_options.pfc ? "on" : "off");
+#endif
+
 	ppp_link_established(ctx, fsm);
 }
 
@@ -203,9 +260,17 @@ static void lcp_finished(struct ppp_fsm *fsm)
 	ppp_link_terminated(ctx);
 }
 
-#if defined(CONFIG_NET_L2_PPP_OPTION_MRU)
+#if defined(LCP_NUM_MY_OPTIONS)
 
 #define MRU_OPTION_LEN 4
+#define COMPRESSION_OPTION_LEN 2
+
+#define LCP_MY_OPTIONS_LEN \
+	(IS_ENABLED(CONFIG_NET_L2_PPP_OPTION_MRU) * MRU_OPTION_LEN + \
+	 IS_ENABLED(CONFIG_NET_L2_PPP_OPTION_COMPRESSION) * \
+	 2 * COMPRESSION_OPTION_LEN)
+
+#if defined(CONFIG_NET_L2_PPP_OPTION_MRU)
 
 static int lcp_add_mru(struct ppp_context *ctx, struct net_pkt *pkt)
 {
@@ -262,14 +327,41 @@ static int lcp_nak_mru(struct ppp_context *ctx, struct net_pkt *pkt,
 	return 0;
 }
 
+#endif /* CONFIG_NET_L2_PPP_OPTION_MRU */
+
+#if defined(CONFIG_NET_L2_PPP_OPTION_COMPRESSION)
+static int lcp_add_compression(struct ppp_context *ctx, struct net_pkt *pkt)
+{
+	/* Only the length, these options have no value */
+	return net_pkt_write_u8(pkt, COMPRESSION_OPTION_LEN);
+}
+
+static int lcp_nak_compression(struct ppp_context *ctx, struct net_pkt *pkt,
+			       uint8_t oplen)
+{
+	/* There is no value to agree on, the peer rejects the option if it
+	 * does not want it.
+	 */
+	return 0;
+}
+#endif /* CONFIG_NET_L2_PPP_OPTION_COMPRESSION */
+
 static const struct ppp_my_option_info lcp_my_options[] = {
+#if defined(CONFIG_NET_L2_PPP_OPTION_MRU)
 	PPP_MY_OPTION(LCP_OPTION_MRU, lcp_add_mru, lcp_ack_mru, lcp_nak_mru),
+#endif
+#if defined(CONFIG_NET_L2_PPP_OPTION_COMPRESSION)
+	PPP_MY_OPTION(LCP_OPTION_PROTO_COMPRESS, lcp_add_compression, NULL,
+		      lcp_nak_compression),
+	PPP_MY_OPTION(LCP_OPTION_ADDR_CTRL_COMPRESS, lcp_add_compression, NULL,
+		      lcp_nak_compression),
+#endif
 };
 BUILD_ASSERT(ARRAY_SIZE(lcp_my_options) == LCP_NUM_MY_OPTIONS);
 
 static struct net_pkt *lcp_config_info_add(struct ppp_fsm *fsm)
 {
-	return ppp_my_options_add(fsm, MRU_OPTION_LEN);
+	return ppp_my_options_add(fsm, LCP_MY_OPTIONS_LEN);
 }
 
 static int lcp_config_info_nack(struct ppp_fsm *fsm, struct net_pkt *pkt,
@@ -284,13 +376,14 @@ static int lcp_config_info_nack(struct ppp_fsm *fsm, struct net_pkt *pkt,
 		return ret;
 	}
 
-	if (!ctx->lcp.my_options.mru) {
+	if (IS_ENABLED(CONFIG_NET_L2_PPP_OPTION_MRU) &&
+	    !ctx->lcp.my_options.mru) {
 		return -EINVAL;
 	}
 
 	return 0;
 }
-#endif
+#endif /* LCP_NUM_MY_OPTIONS */
 
 static void lcp_init(struct ppp_context *ctx)
 {
@@ -303,8 +396,11 @@ static void lcp_init(struct ppp_context *ctx)
 
 	ppp_fsm_name_set(&ctx->lcp.fsm, ppp_proto2str(PPP_LCP));
 
-#if defined(CONFIG_NET_L2_PPP_OPTION_MRU)
-	ctx->lcp.my_options.mru = PPP_MRU;
+#if defined(LCP_NUM_MY_OPTIONS)
+	if (IS_ENABLED(CONFIG_NET_L2_PPP_OPTION_MRU)) {
+		ctx->lcp.my_options.mru = PPP_MRU;
+	}
+
 	ctx->lcp.fsm.my_options.info = lcp_my_options;
 	ctx->lcp.fsm.my_options.data = ctx->lcp.my_options_data;
 	ctx->lcp.fsm.my_options.count = ARRAY_SIZE(lcp_my_options);
@@ -74,23 +74,47 @@ static enum net_verdict process_ppp_msg(struct net_if *iface,
 	struct ppp_context *ctx = net_if_l2_data(iface);
 	enum net_verdict verdict = NET_DROP;
 	uint16_t protocol;
+	uint8_t proto_len;
+	uint8_t byte;
 	int ret;
 
 	if (!ctx->is_ready_to_serve) {
 		goto quit;
 	}
 
-	ret = net_pkt_read_be16(pkt, &protocol);
+	ret = net_pkt_read_u8(pkt, &byte);
 	if (ret < 0) {
 		goto quit;
 	}
 
+	/* A compressed protocol field is a single odd byte, the first byte
+	 * of an uncompressed one is always even. RFC 1661 ch. 6.5
+	 */
+	if (byte & 0x01) {
+		if (!ctx->lcp.my_options.pfc) {
+			goto quit;
+		}
+
+		protocol = byte;
+		proto_len = sizeof(uint8_t);
+	} else {
+		protocol = byte << 8;
+		proto_len = sizeof(uint16_t);
+
+		ret = net_pkt_read_u8(pkt, &byte);
+		if (ret < 0) {
+			goto quit;
+		}
+
+		protocol |= byte;
+	}
+
 	if ((IS_ENABLED(CONFIG_NET_IPV4) && protocol == PPP_IP) ||
 	    (IS_ENABLED(CONFIG_NET_IPV6) && protocol == PPP_IPV6)) {
 		/* Remove the protocol field so that IP packet processing
 		 * continues properly in net_core.c:process_data()
 		 */
-		(void)net_buf_pull_be16(pkt->buffer);
+		(void)net_buf_pull(pkt->buffer, proto_len);
 		net_pkt_cursor_init(pkt);
 		return NET_CONTINUE;
 	}
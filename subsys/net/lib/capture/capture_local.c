@@ -0,0 +1,940 @@
+/** @file
+ * @brief Local network packet capture
+ *
+ * Captured packets are written as pcapng Enhanced Packet Blocks into a RAM
+ * ring buffer, the oldest blocks being overwritten when it is full. The
+ * buffer is read later as a complete pcapng file, so capturing does not
+ * need a network path to another host and can be left enabled.
+ */
+
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_capture_local, CONFIG_NET_CAPTURE_LOCAL_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/byteorder.h>
+#include <net/net_core.h>
+#include <net/net_ip.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+#include <net/ethernet.h>
+#include <net/capture.h>
+
+#if defined(CONFIG_FILE_SYSTEM)
+#include <fs/fs.h>
+#endif
+
+#define PCAPNG_SHB 0x0A0D0D0A
+#define PCAPNG_IDB 0x00000001
+#define PCAPNG_EPB 0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D
+
+#define LINKTYPE_ETHERNET 1
+#define LINKTYPE_PPP 9
+#define LINKTYPE_RAW 101
+#define LINKTYPE_IEEE802_15_4_NOFCS 230
+
+#define BUF_SIZE ROUND_DOWN(CONFIG_NET_CAPTURE_LOCAL_BUF_SIZE, 4)
+
+/* Headers copied out of the packet for the filter: Ethernet with a VLAN
+ * tag, IPv4 with options or IPv6 with a few extension headers, and the
+ * ports.
+ */
+#define FILTER_HDR_LEN 128
+
+struct pcapng_shb {
+	uint32_t type;
+	uint32_t len;
+	uint32_t magic;
+	uint16_t major;
+	uint16_t minor;
+	int64_t section_len;
+	uint32_t trailer_len;
+} __packed;
+
+struct pcapng_idb {
+	uint32_t type;
+	uint32_t len;
+	uint16_t linktype;
+	uint16_t reserved;
+	uint32_t snaplen;
+	uint32_t trailer_len;
+} __packed;
+
+struct pcapng_epb {
+	uint32_t type;
+	uint32_t len;
+	uint32_t iface_id;
+	uint32_t ts_high;
+	uint32_t ts_low;
+	uint32_t caplen;
+	uint32_t origlen;
+} __packed;
+
+#define EPB_OVERHEAD (sizeof(struct pcapng_epb) + sizeof(uint32_t))
+
+enum filter_op {
+	FILTER_AND,
+	FILTER_OR,
+	FILTER_NOT,
+	FILTER_ETHERTYPE,
+	FILTER_PROTO,
+	FILTER_HOST,
+	FILTER_PORT,
+	FILTER_LESS,
+	FILTER_GREATER,
+};
+
+#define FILTER_SRC BIT(0)
+#define FILTER_DST BIT(1)
+
+struct filter_insn {
+	union {
+		struct in6_addr in6;
+		struct in_addr in;
+	} addr;
+	uint16_t val;
+	uint8_t op;
+	uint8_t dir;
+	sa_family_t family;
+};
+
+/* What the filter looks at in a packet */
+struct filter_pkt {
+	const uint8_t *src;
+	const uint8_t *dst;
+	size_t len;
+	uint16_t ethertype;
+	uint16_t sport;
+	uint16_t dport;
+	uint8_t proto;
+	bool has_proto : 1;
+	bool has_ports : 1;
+};
+
+struct filter_parser {
+	const char *pos;
+	struct filter_insn *prog;
+	int len;
+	int error;
+	char token[INET6_ADDRSTRLEN];
+};
+
+static struct {
+	struct k_mutex lock;
+	struct net_if *iface;
+	struct filter_insn filter[CONFIG_NET_CAPTURE_LOCAL_FILTER_LEN];
+	struct net_capture_local_stats stats;
+	atomic_t dropped;
+	size_t head;
+	size_t tail;
+	size_t used;
+	uint16_t snaplen;
+	uint8_t filter_len;
+	bool started;
+	uint8_t buf[BUF_SIZE] __aligned(4);
+} capture = {
+	.lock = Z_MUTEX_INITIALIZER(capture.lock),
+	.snaplen = CONFIG_NET_CAPTURE_LOCAL_SNAPLEN,
+};
+
+static void filter_advance(struct filter_parser *p)
+{
+	const char *start;
+	size_t len;
+
+	while (*p->pos == ' ' || *p->pos == '\t') {
+		p->pos++;
+	}
+
+	start = p->pos;
+
+	if (*p->pos == '(' || *p->pos == ')') {
+		p->pos++;
+	} else if (*p->pos == '!' && p->pos[1] != '=') {
+		p->pos++;
+	} else if ((*p->pos == '&' && p->pos[1] == '&') ||
+		   (*p->pos == '|' && p->pos[1] == '|')) {
+		p->pos += 2;
+	} else {
+		while (*p->pos && *p->pos != ' ' && *p->pos != '\t' &&
+		       *p->pos != '(' && *p->pos != ')') {
+			p->pos++;
+		}
+	}
+
+	len = p->pos - start;
+	if (len >= sizeof(p->token)) {
+		p->error = -EINVAL;
+		len = 0;
+	}
+
+	memcpy(p->token, start, len);
+	p->token[len] = '\0';
+}
+
+static bool filter_is(struct filter_parser *p, const char *word)
+{
+	return strcmp(p->token, word) == 0;
+}
+
+static struct filter_insn *filter_emit(struct filter_parser *p, uint8_t op)
+{
+	struct filter_insn *insn;
+
+	if (p->len >= CONFIG_NET_CAPTURE_LOCAL_FILTER_LEN) {
+		p->error = -ENOMEM;
+		return NULL;
+	}
+
+	insn = &p->prog[p->len++];
+	memset(insn, 0, sizeof(*insn));
+	insn->op = op;
+
+	return insn;
+}
+
+static int filter_number(struct filter_parser *p, uint16_t *val)
+{
+	unsigned long num;
+	char *end;
+
+	num = strtoul(p->token, &end, 0);
+	if (*p->token == '\0' || *end != '\0' || num > UINT16_MAX) {
+		return -EINVAL;
+	}
+
+	*val = num;
+
+	return 0;
+}
+
+static const struct {
+	const char *name;
+	uint8_t op;
+	uint16_t val;
+} filter_protos[] = {
+	{ "ip", FILTER_ETHERTYPE, NET_ETH_PTYPE_IP },
+	{ "ip6", FILTER_ETHERTYPE, NET_ETH_PTYPE_IPV6 },
+	{ "arp", FILTER_ETHERTYPE, NET_ETH_PTYPE_ARP },
+	{ "tcp", FILTER_PROTO, IPPROTO_TCP },
+	{ "udp", FILTER_PROTO, IPPROTO_UDP },
+	{ "icmp", FILTER_PROTO, IPPROTO_ICMP },
+	{ "icmp6", FILTER_PROTO, IPPROTO_ICMPV6 },
+};
+
+static void filter_primitive(struct filter_parser *p)
+{
+	uint8_t dir = FILTER_SRC | FILTER_DST;
+	struct filter_insn *insn;
+	uint16_t val;
+	int i;
+
+	if (filter_is(p, "src")) {
+		dir = FILTER_SRC;
+		filter_advance(p);
+	} else if (filter_is(p, "dst")) {
+		dir = FILTER_DST;
+		filter_advance(p);
+	}
+
+	if (filter_is(p, "host")) {
+		filter_advance(p);
+
+		insn = filter_emit(p, FILTER_HOST);
+		if (!insn) {
+			return;
+		}
+
+		insn->dir = dir;
+		insn->family = strchr(p->token, ':') ? AF_INET6 : AF_INET;
+
+		if (net_addr_pton(insn->family, p->token, &insn->addr) < 0) {
+			p->error = -EINVAL;
+			return;
+		}
+
+		filter_advance(p);
+		return;
+	}
+
+	if (filter_is(p, "port")) {
+		filter_advance(p);
+
+		insn = filter_emit(p, FILTER_PORT);
+		if (!insn) {
+			return;
+		}
+
+		insn->dir = dir;
+
+		if (filter_number(p, &insn->val) < 0) {
+			p->error = -EINVAL;
+			return;
+		}
+
+		filter_advance(p);
+		return;
+	}
+
+	if (dir != (FILTER_SRC | FILTER_DST)) {
+		/* src and dst qualify a host or a port only */
+		p->error = -EINVAL;
+		return;
+	}
+
+	if (filter_is(p, "less") || filter_is(p, "greater")) {
+		uint8_t op = filter_is(p, "less") ? FILTER_LESS :
+						    FILTER_GREATER;
+
+		filter_advance(p);
+
+		if (filter_number(p, &val) < 0) {
+			p->error = -EINVAL;
+			return;
+		}
+
+		insn = filter_emit(p, op);
+		if (insn) {
+			insn->val = val;
+		}
+
+		filter_advance(p);
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(filter_protos); i++) {
+		if (!filter_is(p, filter_protos[i].name)) {
+			continue;
+		}
+
+		insn = filter_emit(p, filter_protos[i].op);
+		if (insn) {
+			insn->val = filter_protos[i].val;
+		}
+
+		filter_advance(p);
+		return;
+	}
+
+	p->error = -EINVAL;
+}
+
+static void filter_expr(struct filter_parser *p);
+
+static void filter_factor(struct filter_parser *p)
+{
+	if (filter_is(p, "not") || filter_is(p, "!")) {
+		filter_advance(p);
+		filter_factor(p);
+		filter_emit(p, FILTER_NOT);
+		return;
+	}
+
+	if (filter_is(p, "(")) {
+		filter_advance(p);
+		filter_expr(p);
+
+		if (!filter_is(p, ")")) {
+			p->error = -EINVAL;
+			return;
+		}
+
+		filter_advance(p);
+		return;
+	}
+
+	filter_primitive(p);
+}
+
+static void filter_term(struct filter_parser *p)
+{
+	filter_factor(p);
+
+	while (!p->error && (filter_is(p, "and") || filter_is(p, "&&"))) {
+		filter_advance(p);
+		filter_factor(p);
+		filter_emit(p, FILTER_AND);
+	}
+}
+
+static void filter_expr(struct filter_parser *p)
+{
+	filter_term(p);
+
+	while (!p->error && (filter_is(p, "or") || filter_is(p, "||"))) {
+		filter_advance(p);
+		filter_term(p);
+		filter_emit(p, FILTER_OR);
+	}
+}
+
+/* Compile a tcpdump like filter expression into a postfix program. */
+static int filter_compile(const char *filter, struct filter_insn *prog)
+{
+	struct filter_parser p = {
+		.pos = filter ? filter : "",
+		.prog = prog,
+	};
+
+	filter_advance(&p);
+
+	if (p.token[0] == '\0') {
+		return p.error ? p.error : 0;
+	}
+
+	filter_expr(&p);
+
+	if (!p.error && p.token[0] != '\0') {
+		p.error = -EINVAL;
+	}
+
+	return p.error ? p.error : p.len;
+}
+
+static void filter_parse_l4(struct filter_pkt *fp, const uint8_t *hdr,
+			    size_t hdr_len, size_t off)
+{
+	fp->has_proto = true;
+
+	if ((fp->proto == IPPROTO_TCP || fp->proto == IPPROTO_UDP) &&
+	    off + 4 <= hdr_len) {
+		fp->sport = sys_get_be16(hdr + off);
+		fp->dport = sys_get_be16(hdr + off + 2);
+		fp->has_ports = true;
+	}
+}
+
+static void filter_parse_ipv4(struct filter_pkt *fp, const uint8_t *hdr,
+			      size_t hdr_len, size_t off)
+{
+	if (off + sizeof(struct net_ipv4_hdr) > hdr_len) {
+		return;
+	}
+
+	fp->proto = hdr[off + offsetof(struct net_ipv4_hdr, proto)];
+	fp->src = hdr + off + offsetof(struct net_ipv4_hdr, src);
+	fp->dst = hdr + off + offsetof(struct net_ipv4_hdr, dst);
+
+	/* Only the first fragment has the ports */
+	if (sys_get_be16(hdr + off + offsetof(struct net_ipv4_hdr, offset)) &
+	    0x1fff) {
+		fp->has_proto = true;
+		return;
+	}
+
+	filter_parse_l4(fp, hdr, hdr_len, off + (hdr[off] & 0x0f) * 4U);
+}
+
+static void filter_parse_ipv6(struct filter_pkt *fp, const uint8_t *hdr,
+			      size_t hdr_len, size_t off)
+{
+	uint8_t nexthdr;
+
+	if (off + sizeof(struct net_ipv6_hdr) > hdr_len) {
+		return;
+	}
+
+	nexthdr = hdr[off + offsetof(struct net_ipv6_hdr, nexthdr)];
+	fp->src = hdr + off + offsetof(struct net_ipv6_hdr, src);
+	fp->dst = hdr + off + offsetof(struct net_ipv6_hdr, dst);
+	off += sizeof(struct net_ipv6_hdr);
+
+	while (off + 8 <= hdr_len) {
+		if (nexthdr == NET_IPV6_NEXTHDR_HBHO ||
+		    nexthdr == NET_IPV6_NEXTHDR_DESTO ||
+		    nexthdr == 43 /* Routing */) {
+			nexthdr = hdr[off];
+			off += (hdr[off + 1] + 1U) * 8U;
+		} else if (nexthdr == NET_IPV6_NEXTHDR_FRAG) {
+			nexthdr = hdr[off];
+
+			if (sys_get_be16(hdr + off + 2) & 0xfff8) {
+				fp->proto = nexthdr;
+				fp->has_proto = true;
+				return;
+			}
+
+			off += sizeof(struct net_ipv6_frag_hdr);
+		} else {
+			break;
+		}
+	}
+
+	fp->proto = nexthdr;
+	filter_parse_l4(fp, hdr, hdr_len, off);
+}
+
+static void filter_parse(struct filter_pkt *fp, uint16_t linktype,
+			 const uint8_t *hdr, size_t hdr_len)
+{
+	size_t off = 0;
+
+	switch (linktype) {
+	case LINKTYPE_ETHERNET:
+		if (hdr_len < sizeof(struct net_eth_hdr)) {
+			return;
+		}
+
+		fp->ethertype = sys_get_be16(hdr + 12);
+		off = sizeof(struct net_eth_hdr);
+
+		if (fp->ethertype == NET_ETH_PTYPE_VLAN && hdr_len >= off + 4) {
+			fp->ethertype = sys_get_be16(hdr + off + 2);
+			off += 4;
+		}
+
+		break;
+	case LINKTYPE_PPP:
+		if (hdr_len >= 2 && hdr[0] == 0xff && hdr[1] == 0x03) {
+			off = 2;
+		}
+
+		if (hdr_len < off + 2) {
+			return;
+		}
+
+		switch (sys_get_be16(hdr + off)) {
+		case 0x0021:
+			fp->ethertype = NET_ETH_PTYPE_IP;
+			break;
+		case 0x0057:
+			fp->ethertype = NET_ETH_PTYPE_IPV6;
+			break;
+		}
+
+		off += 2;
+		break;
+	case LINKTYPE_RAW:
+		if (hdr_len < 1) {
+			return;
+		}
+
+		if ((hdr[0] & 0xf0) == 0x40) {
+			fp->ethertype = NET_ETH_PTYPE_IP;
+		} else if ((hdr[0] & 0xf0) == 0x60) {
+			fp->ethertype = NET_ETH_PTYPE_IPV6;
+		}
+
+		break;
+	default:
+		return;
+	}
+
+	if (fp->ethertype == NET_ETH_PTYPE_IP) {
+		filter_parse_ipv4(fp, hdr, hdr_len, off);
+	} else if (fp->ethertype == NET_ETH_PTYPE_IPV6) {
+		filter_parse_ipv6(fp, hdr, hdr_len, off);
+	}
+}
+
+static bool filter_host(const struct filter_insn *insn,
+			const struct filter_pkt *fp)
+{
+	size_t len;
+
+	if (!fp->src ||
+	    (insn->family == AF_INET6) !=
+	    (fp->ethertype == NET_ETH_PTYPE_IPV6)) {
+		return false;
+	}
+
+	len = insn->family == AF_INET6 ? sizeof(struct in6_addr) :
+					 sizeof(struct in_addr);
+
+	return ((insn->dir & FILTER_SRC) &&
+		memcmp(fp->src, &insn->addr, len) == 0) ||
+		((insn->dir & FILTER_DST) &&
+		 memcmp(fp->dst, &insn->addr, len) == 0);
+}
+
+static bool filter_run(const struct filter_insn *prog, int len,
+		       const struct filter_pkt *fp)
+{
+	/* The program is checked when compiled, the stack never holds more
+	 * values than there are instructions.
+	 */
+	uint32_t stack = 0U;
+	bool val = false;
+	int i;
+
+	for (i = 0; i < len; i++) {
+		const struct filter_insn *insn = &prog[i];
+
+		switch (insn->op) {
+		case FILTER_AND:
+			val = (stack & 1) && (stack & 2);
+			stack >>= 2;
+			break;
+		case FILTER_OR:
+			val = (stack & 1) || (stack & 2);
+			stack >>= 2;
+			break;
+		case FILTER_NOT:
+			val = !(stack & 1);
+			stack >>= 1;
+			break;
+		case FILTER_ETHERTYPE:
+			val = fp->ethertype == insn->val;
+			break;
+		case FILTER_PROTO:
+			val = fp->has_proto && fp->proto == insn->val;
+			break;
+		case FILTER_HOST:
+			val = filter_host(insn, fp);
+			break;
+		case FILTER_PORT:
+			val = fp->has_ports &&
+				(((insn->dir & FILTER_SRC) &&
+				  fp->sport == insn->val) ||
+				 ((insn->dir & FILTER_DST) &&
+				  fp->dport == insn->val));
+			break;
+		case FILTER_LESS:
+			val = fp->len <= insn->val;
+			break;
+		case FILTER_GREATER:
+			val = fp->len >= insn->val;
+			break;
+		}
+
+		stack = (stack << 1) | val;
+	}
+
+	return stack & 1;
+}
+
+static uint16_t iface_linktype(struct net_if *iface)
+{
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET)) {
+		return LINKTYPE_ETHERNET;
+	}
+#endif
+#if defined(CONFIG_NET_L2_IEEE802154)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(IEEE802154)) {
+		return LINKTYPE_IEEE802_15_4_NOFCS;
+	}
+#endif
+#if defined(CONFIG_NET_L2_PPP)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(PPP)) {
+		return LINKTYPE_PPP;
+	}
+#endif
+
+	return LINKTYPE_RAW;
+}
+
+static void ring_write(const void *data, size_t len)
+{
+	size_t first = MIN(len, BUF_SIZE - capture.head);
+
+	if (data) {
+		memcpy(capture.buf + capture.head, data, first);
+		memcpy(capture.buf, (const uint8_t *)data + first, len - first);
+	} else {
+		memset(capture.buf + capture.head, 0, first);
+		memset(capture.buf, 0, len - first);
+	}
+
+	capture.head = (capture.head + len) % BUF_SIZE;
+	capture.used += len;
+}
+
+/* Overwrite the oldest blocks until there is room for len bytes */
+static void ring_reserve(size_t len)
+{
+	uint32_t block_len;
+	size_t pos;
+
+	while (BUF_SIZE - capture.used < len) {
+		/* Blocks are 4 byte aligned so the length does not wrap */
+		pos = (capture.tail + sizeof(uint32_t)) % BUF_SIZE;
+		memcpy(&block_len, capture.buf + pos, sizeof(block_len));
+
+		capture.tail = (capture.tail + block_len) % BUF_SIZE;
+		capture.used -= block_len;
+		capture.stats.overwritten++;
+	}
+}
+
+static void capture_write(struct net_if *iface, struct net_pkt *pkt,
+			  size_t len)
+{
+	uint32_t caplen = MIN(len, capture.snaplen);
+	uint32_t padded = ROUND_UP(caplen, 4);
+	uint64_t now = k_ticks_to_us_floor64(k_uptime_ticks());
+	struct pcapng_epb epb = {
+		.type = PCAPNG_EPB,
+		.len = EPB_OVERHEAD + padded,
+		.iface_id = net_if_get_by_iface(iface) - 1,
+		.ts_high = now >> 32,
+		.ts_low = (uint32_t)now,
+		.caplen = caplen,
+		.origlen = len,
+	};
+	struct net_buf *buf;
+	size_t copy;
+
+	ring_reserve(epb.len);
+	ring_write(&epb, sizeof(epb));
+
+	/* The data is copied from the network buffers straight into the
+	 * ring.
+	 */
+	for (buf = pkt->buffer, copy = caplen; buf && copy; buf = buf->frags) {
+		size_t n = MIN(copy, buf->len);
+
+		ring_write(buf->data, n);
+		copy -= n;
+	}
+
+	ring_write(NULL, padded - caplen);
+	ring_write(&epb.len, sizeof(epb.len));
+
+	capture.stats.captured++;
+
+	if (caplen < len) {
+		capture.stats.truncated++;
+	}
+}
+
+void net_capture_local_pkt(struct net_if *iface, struct net_pkt *pkt)
+{
+	uint8_t hdr[FILTER_HDR_LEN];
+	size_t len;
+
+	/* Packets sent to a capture tunnel are not captured again */
+	if (!capture.started || net_pkt_is_captured(pkt) ||
+	    (capture.iface && capture.iface != iface)) {
+		return;
+	}
+
+	/* Do not wait if the buffer is being read */
+	if (k_mutex_lock(&capture.lock, K_NO_WAIT)) {
+		atomic_inc(&capture.dropped);
+		return;
+	}
+
+	if (!capture.started) {
+		goto out;
+	}
+
+	len = net_pkt_get_len(pkt);
+
+	if (capture.filter_len) {
+		struct filter_pkt fp = { .len = len };
+		size_t hdr_len;
+
+		hdr_len = net_buf_linearize(hdr, sizeof(hdr), pkt->buffer, 0,
+					    sizeof(hdr));
+		filter_parse(&fp, iface_linktype(iface), hdr, hdr_len);
+
+		if (!filter_run(capture.filter, capture.filter_len, &fp)) {
+			capture.stats.filtered++;
+			goto out;
+		}
+	}
+
+	capture_write(iface, pkt, len);
+
+out:
+	k_mutex_unlock(&capture.lock);
+}
+
+int net_capture_local_start(struct net_if *iface, const char *filter,
+			    uint16_t snaplen)
+{
+	struct filter_insn prog[CONFIG_NET_CAPTURE_LOCAL_FILTER_LEN];
+	int ret;
+
+	ret = filter_compile(filter, prog);
+	if (ret < 0) {
+		NET_DBG("Invalid filter \"%s\" (%d)", log_strdup(filter), ret);
+		return ret;
+	}
+
+	if (snaplen == 0U) {
+		snaplen = CONFIG_NET_CAPTURE_LOCAL_SNAPLEN;
+	}
+
+	k_mutex_lock(&capture.lock, K_FOREVER);
+
+	if (capture.started) {
+		k_mutex_unlock(&capture.lock);
+		return -EALREADY;
+	}
+
+	memcpy(capture.filter, prog, ret * sizeof(prog[0]));
+	capture.filter_len = ret;
+	capture.iface = iface;
+	capture.snaplen = MIN(snaplen, BUF_SIZE - EPB_OVERHEAD - 3);
+	capture.started = true;
+
+	k_mutex_unlock(&capture.lock);
+
+	NET_DBG("Capturing iface %d (%d filter ops, snaplen %u)",
+		iface ? net_if_get_by_iface(iface) : 0, ret, capture.snaplen);
+
+	return 0;
+}
+
+int net_capture_local_stop(void)
+{
+	k_mutex_lock(&capture.lock, K_FOREVER);
+
+	if (!capture.started) {
+		k_mutex_unlock(&capture.lock);
+		return -EALREADY;
+	}
+
+	capture.started = false;
+
+	k_mutex_unlock(&capture.lock);
+
+	return 0;
+}
+
+bool net_capture_local_is_started(void)
+{
+	return capture.started;
+}
+
+void net_capture_local_clear(void)
+{
+	k_mutex_lock(&capture.lock, K_FOREVER);
+
+	capture.head = 0;
+	capture.tail = 0;
+	capture.used = 0;
+
+	memset(&capture.stats, 0, sizeof(capture.stats));
+	atomic_clear(&capture.dropped);
+
+	k_mutex_unlock(&capture.lock);
+}
+
+void net_capture_local_get_stats(struct net_capture_local_stats *stats)
+{
+	k_mutex_lock(&capture.lock, K_FOREVER);
+
+	memcpy(stats, &capture.stats, sizeof(*stats));
+	stats->dropped = atomic_get(&capture.dropped);
+
+	k_mutex_unlock(&capture.lock);
+}
+
+struct read_ctx {
+	net_capture_local_cb_t cb;
+	void *user_data;
+	int ret;
+};
+
+static void idb_cb(struct net_if *iface, void *user_data)
+{
+	struct read_ctx *ctx = user_data;
+	struct pcapng_idb idb = {
+		.type = PCAPNG_IDB,
+		.len = sizeof(idb),
+		.linktype = iface_linktype(iface),
+		.snaplen = capture.snaplen,
+		.trailer_len = sizeof(idb),
+	};
+
+	/* One interface description per network interface, in the order
+	 * of the interface indexes used as interface ids.
+	 */
+	if (ctx->ret >= 0) {
+		ctx->ret = ctx->cb(&idb, sizeof(idb), ctx->user_data);
+	}
+}
+
+int net_capture_local_read(net_capture_local_cb_t cb, void *user_data)
+{
+	struct pcapng_shb shb = {
+		.type = PCAPNG_SHB,
+		.len = sizeof(shb),
+		.magic = PCAPNG_BYTE_ORDER_MAGIC,
+		.major = 1U,
+		.minor = 0U,
+		.section_len = -1,
+		.trailer_len = sizeof(shb),
+	};
+	struct read_ctx ctx = {
+		.cb = cb,
+		.user_data = user_data,
+	};
+	size_t first;
+
+	k_mutex_lock(&capture.lock, K_FOREVER);
+
+	ctx.ret = cb(&shb, sizeof(shb), user_data);
+
+	net_if_foreach(idb_cb, &ctx);
+
+	first = MIN(capture.used, BUF_SIZE - capture.tail);
+
+	if (ctx.ret >= 0 && first) {
+		ctx.ret = cb(capture.buf + capture.tail, first, user_data);
+	}
+
+	if (ctx.ret >= 0 && capture.used > first) {
+		ctx.ret = cb(capture.buf, capture.used - first, user_data);
+	}
+
+	k_mutex_unlock(&capture.lock);
+
+	return ctx.ret < 0 ? ctx.ret : 0;
+}
+
+#if defined(CONFIG_FILE_SYSTEM)
+static int file_write_cb(const void *data, size_t len, void *user_data)
+{
+	ssize_t ret;
+
+	ret = fs_write(user_data, data, len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return ret == len ? 0 : -ENOSPC;
+}
+
+int net_capture_local_save(const char *path)
+{
+	struct fs_file_t file;
+	int ret;
+
+	fs_file_t_init(&file);
+
+	ret = fs_open(&file, path, FS_O_CREATE | FS_O_WRITE);
+	if (ret < 0) {
+		NET_DBG("Cannot open %s (%d)", log_strdup(path), ret);
+		return ret;
+	}
+
+	ret = fs_truncate(&file, 0);
+	if (ret == 0) {
+		ret = net_capture_local_read(file_write_cb, &file);
+	}
+
+	(void)fs_close(&file);
+
+	return ret;
+}
+#else
+int net_capture_local_save(const char *path)
+{
+	ARG_UNUSED(path);
+
+	return -ENOTSUP;
+}
+#endif /* CONFIG_FILE_SYSTEM */
@@ -96,6 +96,73 @@ static inline bool append(struct coap_packet *cpkt, const uint8_t *data, uint16_
 	return true;
 }
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+static inline void option_index_reset(struct coap_packet *cpkt)
+{
+	cpkt->opt_count = 0U;
+}
+
+static void option_index_add(struct coap_packet *cpkt, uint16_t code,
+			     uint16_t offset, uint16_t len)
+{
+	struct coap_option_ref *ref;
+
+	if (cpkt->opt_count >= ARRAY_SIZE(cpkt->opt_index)) {
+		/* Too many options, fall back to parsing the packet */
+		cpkt->opt_count = COAP_OPTION_INDEX_INVALID;
+		return;
+	}
+
+	ref = &cpkt->opt_index[cpkt->opt_count++];
+	ref->code = code;
+	ref->offset = offset;
+	ref->len = len;
+}
+
+static int option_index_find(const struct coap_packet *cpkt, uint16_t code,
+			     struct coap_option *options, uint16_t veclen)
+{
+	const struct coap_option_ref *ref;
+	uint8_t num = 0U;
+	uint8_t i;
+
+	for (i = 0U; i < cpkt->opt_count && num < veclen; i++) {
+		ref = &cpkt->opt_index[i];
+
+		/* options are sorted by their number */
+		if (ref->code > code) {
+			break;
+		}
+
+		if (ref->code != code) {
+			continue;
+		}
+
+		if (ref->len > sizeof(options[num].value)) {
+			NET_ERR("%u is > sizeof(coap_option->value)(%zu)!",
+				ref->len, sizeof(options[num].value));
+			return -EINVAL;
+		}
+
+		options[num].delta = code;
+		options[num].len = ref->len;
+		memcpy(options[num].value, cpkt->data + ref->offset, ref->len);
+		num++;
+	}
+
+	return num;
+}
+#else
+static inline void option_index_reset(struct coap_packet *cpkt)
+{
+}
+
+static inline void option_index_add(struct coap_packet *cpkt, uint16_t code,
+				    uint16_t offset, uint16_t len)
+{
+}
+#endif /* CONFIG_COAP_OPTION_INDEX */
+
 int coap_packet_init(struct coap_packet *cpkt, uint8_t *data, uint16_t max_len,
 		     uint8_t ver, uint8_t type, uint8_t token_len,
 		     const uint8_t *token, uint8_t code, uint16_t id)
@@ -283,6 +350,8 @@ int coap_packet_append_option(struct coap_packet *cpkt, uint16_t code,
 	cpkt->opt_len += r;
 	cpkt->delta += code;
 
+	option_index_add(cpkt, cpkt->delta, cpkt->offset - len, len);
+
 	return 0;
 }
 
@@ -446,7 +515,7 @@ static int decode_delta(uint8_t *data, uint16_t offset, uint16_t *pos, uint16_t
 
 static int parse_option(uint8_t *data, uint16_t offset, uint16_t *pos,
 			uint16_t max_len, uint16_t *opt_delta, uint16_t *opt_len,
-			struct coap_option *option)
+			uint16_t *value_len, struct coap_option *option)
 {
 	uint16_t hdr_len;
 	uint16_t delta;
@@ -517,6 +586,8 @@ static int parse_option(uint8_t *data, uint16_t offset, uint16_t *pos,
 		return -EINVAL;
 	}
 
+	*value_len = len;
+
 	if (option) {
 		/*
 		 * Make sure the option data will fit into the value field of
@@ -551,6 +622,7 @@ static int parse_option(uint8_t *data, uint16_t offset, uint16_t *pos,
 int coap_packet_parse(struct coap_packet *cpkt, uint8_t *data, uint16_t len,
 		      struct coap_option *options, uint8_t opt_num)
 {
+	uint16_t value_len;
 	uint16_t opt_len;
 	uint16_t offset;
 	uint16_t delta;
@@ -576,6 +648,7 @@ int coap_packet_parse(struct coap_packet *cpkt, uint8_t *data, uint16_t len,
 	cpkt->opt_len = 0U;
 	cpkt->hdr_len = 0U;
 	cpkt->delta = 0U;
+	option_index_reset(cpkt);
 
 	/* Token lengths 9-15 are reserved. */
 	tkl = cpkt->data[0] & 0x0f;
@@ -599,13 +672,22 @@ int coap_packet_parse(struct coap_packet *cpkt, uint8_t *data, uint16_t len,
 
 	while (1) {
 		struct coap_option *option;
+		uint16_t prev_opt_len = opt_len;
 
 		option = num < opt_num ? &options[num++] : NULL;
 		ret = parse_option(cpkt->data, offset, &offset, cpkt->max_len,
-				   &delta, &opt_len, option);
+				   &delta, &opt_len, &value_len, option);
 		if (ret < 0) {
 			return ret;
-		} else if (ret == 0) {
+		}
+
+		/* opt_len only grows when an option was found */
+		if (opt_len != prev_opt_len) {
+			option_index_add(cpkt, delta, offset - value_len,
+					 value_len);
+		}
+
+		if (ret == 0) {
 			break;
 		}
 	}
@@ -619,6 +701,7 @@ int coap_packet_parse(struct coap_packet *cpkt, uint8_t *data, uint16_t len,
 int coap_find_options(const struct coap_packet *cpkt, uint16_t code,
 		      struct coap_option *options, uint16_t veclen)
 {
+	uint16_t value_len;
 	uint16_t opt_len;
 	uint16_t offset;
 	uint16_t delta;
@@ -630,6 +713,12 @@ int coap_find_options(const struct coap_packet *cpkt, uint16_t code,
 		return 0;
 	}
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	if (cpkt->opt_count != COAP_OPTION_INDEX_INVALID) {
+		return option_index_find(cpkt, code, options, veclen);
+	}
+#endif
+
 	offset = cpkt->hdr_len;
 	opt_len = 0U;
 	delta = 0U;
@@ -638,7 +727,7 @@ int coap_find_options(const struct coap_packet *cpkt, uint16_t code,
 	while (delta <= code && num < veclen) {
 		r = parse_option(cpkt->data, offset, &offset,
 				 cpkt->max_len, &delta, &opt_len,
-				 &options[num]);
+				 &value_len, &options[num]);
 		if (r < 0) {
 			return -EINVAL;
 		}
@@ -708,6 +797,9 @@ uint8_t coap_header_get_code(const struct coap_packet *cpkt)
 	case COAP_METHOD_POST:
 	case COAP_METHOD_PUT:
 	case COAP_METHOD_DELETE:
+	case COAP_METHOD_FETCH:
+	case COAP_METHOD_PATCH:
+	case COAP_METHOD_IPATCH:
 
 	/* All the defined response codes */
 	case COAP_RESPONSE_CODE_OK:
@@ -875,6 +967,203 @@ int coap_handle_request(struct coap_packet *cpkt,
 	return -ENOENT;
 }
 
+static bool is_wildcard(const struct coap_resource_trie_node *node, char c)
+{
+	return IS_ENABLED(CONFIG_COAP_URI_WILDCARD) &&
+	       node->len == 1U && node->segment[0] == c;
+}
+
+static int trie_add_child(struct coap_resource_trie *trie, int16_t parent,
+			  const char *segment)
+{
+	struct coap_resource_trie_node *node;
+	uint16_t len = strlen(segment);
+	int16_t child;
+
+	for (child = trie->nodes[parent].first_child; child >= 0;
+	     child = trie->nodes[child].next_sibling) {
+		node = &trie->nodes[child];
+		if (node->len == len && !memcmp(node->segment, segment, len)) {
+			return child;
+		}
+	}
+
+	if (trie->node_count >= trie->max_nodes) {
+		return -ENOMEM;
+	}
+
+	child = trie->node_count++;
+	node = &trie->nodes[child];
+	node->segment = segment;
+	node->len = len;
+	node->first_child = -1;
+	node->resource = -1;
+
+	/* Keep the children in insertion order */
+	node->next_sibling = -1;
+	if (trie->nodes[parent].first_child < 0) {
+		trie->nodes[parent].first_child = child;
+	} else {
+		int16_t last = trie->nodes[parent].first_child;
+
+		while (trie->nodes[last].next_sibling >= 0) {
+			last = trie->nodes[last].next_sibling;
+		}
+
+		trie->nodes[last].next_sibling = child;
+	}
+
+	return child;
+}
+
+int coap_resource_trie_init(struct coap_resource_trie *trie,
+			    struct coap_resource *resources,
+			    struct coap_resource_trie_node *nodes,
+			    uint16_t max_nodes)
+{
+	struct coap_resource *resource;
+	int16_t index;
+
+	if (!trie || !resources || !nodes || max_nodes == 0U ||
+	    max_nodes > INT16_MAX) {
+		return -EINVAL;
+	}
+
+	trie->resources = resources;
+	trie->nodes = nodes;
+	trie->max_nodes = max_nodes;
+	trie->node_count = 1U;
+
+	nodes[0].segment = NULL;
+	nodes[0].len = 0U;
+	nodes[0].first_child = -1;
+	nodes[0].next_sibling = -1;
+	nodes[0].resource = -1;
+
+	for (resource = resources, index = 0; resource->path;
+	     resource++, index++) {
+		const char * const *path;
+		int node = 0;
+
+		if (index == INT16_MAX) {
+			return -ENOMEM;
+		}
+
+		for (path = resource->path; *path; path++) {
+			node = trie_add_child(trie, node, *path);
+			if (node < 0) {
+				return node;
+			}
+
+			/* Anything after a multi-level wildcard is ignored */
+			if (is_wildcard(&nodes[node], '#')) {
+				break;
+			}
+		}
+
+		/* The first resource with a given path wins */
+		if (nodes[node].resource < 0) {
+			nodes[node].resource = index;
+		}
+	}
+
+	return 0;
+}
+
+static int16_t trie_lookup(const struct coap_resource_trie *trie,
+			   int16_t parent, const struct coap_option *options,
+			   uint8_t opt_num, uint8_t i)
+{
+	const struct coap_resource_trie_node *node;
+	const struct coap_option *segment;
+	int16_t found = -1;
+	int16_t child;
+
+	while (i < opt_num && options[i].delta != COAP_OPTION_URI_PATH) {
+		i++;
+	}
+
+	if (i == opt_num) {
+		return trie->nodes[parent].resource;
+	}
+
+	segment = &options[i];
+
+	/* Several children may match because of wildcards, keep the
+	 * resource that comes first in the array so the result is the same
+	 * as with coap_handle_request().
+	 */
+	for (child = trie->nodes[parent].first_child; child >= 0;
+	     child = node->next_sibling) {
+		int16_t res;
+
+		node = &trie->nodes[child];
+
+		if (is_wildcard(node, '#')) {
+			res = node->resource;
+		} else if (is_wildcard(node, '+') ||
+			   (node->len == segment->len &&
+			    !memcmp(node->segment, segment->value, node->len))) {
+			res = trie_lookup(trie, child, options, opt_num, i + 1);
+		} else {
+			continue;
+		}
+
+		if (res >= 0 && (found < 0 || res < found)) {
+			found = res;
+		}
+	}
+
+	return found;
+}
+
+struct coap_resource *coap_resource_trie_find(
+	const struct coap_resource_trie *trie,
+	const struct coap_option *options, uint8_t opt_num)
+{
+	int16_t index;
+
+	if (!trie || !trie->nodes) {
+		return NULL;
+	}
+
+	index = trie_lookup(trie, 0, options, opt_num, 0U);
+	if (index < 0) {
+		return NULL;
+	}
+
+	return &trie->resources[index];
+}
+
+int coap_handle_request_trie(struct coap_packet *cpkt,
+			     const struct coap_resource_trie *trie,
+			     struct coap_option *options,
+			     uint8_t opt_num,
+			     struct sockaddr *addr, socklen_t addr_len)
+{
+	struct coap_resource *resource;
+	coap_method_t method;
+	uint8_t code;
+
+	if (!is_request(cpkt)) {
+		return 0;
+	}
+
+	resource = coap_resource_trie_find(trie, options, opt_num);
+	if (!resource) {
+		NET_DBG("%d", __LINE__);
+		return -ENOENT;
+	}
+
+	code = coap_header_get_code(cpkt);
+	method = method_from_code(resource, code);
+	if (!method) {
+		return -EPERM;
+	}
+
+	return method(resource, cpkt, addr, addr_len);
+}
+
 int coap_block_transfer_init(struct coap_block_context *ctx,
 			      enum coap_block_size block_size,
 			      size_t total_size)
@@ -1215,12 +1504,16 @@ struct coap_pending *coap_pending_next_to_expire(
 	return found;
 }
 
-static uint32_t init_ack_timeout(void)
+static uint32_t init_ack_timeout(uint32_t ack_timeout)
 {
 #if defined(CONFIG_COAP_RANDOMIZE_ACK_TIMEOUT)
-	const uint32_t max_ack = CONFIG_COAP_INIT_ACK_TIMEOUT_MS *
-				 COAP_DEFAULT_ACK_RANDOM_FACTOR;
-	const uint32_t min_ack = CONFIG_COAP_INIT_ACK_TIMEOUT_MS;
+	const uint32_t max_ack = ack_timeout *
+		(uint32_t)(COAP_DEFAULT_ACK_RANDOM_FACTOR * 100) / 100U;
+	const uint32_t min_ack = ack_timeout;
+
+	if (max_ack <= min_ack) {
+		return min_ack;
+	}
 
 	/* Randomly generated initial ACK timeout
 	 * ACK_TIMEOUT < INIT_ACK_TIMEOUT < ACK_TIMEOUT * ACK_RANDOM_FACTOR
@@ -1228,15 +1521,147 @@ static uint32_t init_ack_timeout(void)
 	 */
 	return min_ack + (sys_rand32_get() % (max_ack - min_ack));
 #else
-	return CONFIG_COAP_INIT_ACK_TIMEOUT_MS;
+	return ack_timeout;
 #endif /* defined(CONFIG_COAP_RANDOMIZE_ACK_TIMEOUT) */
 }
 
+#if defined(CONFIG_COAP_COCOA)
+/* Constants from draft-ietf-core-cocoa, section 4.2 */
+#define COCOA_RTO_MAX_MS		32000U
+#define COCOA_RTO_SMALL_MS		1000U
+#define COCOA_RTO_LARGE_MS		3000U
+
+void coap_rto_estimator_init(struct coap_rto_estimator *est)
+{
+	memset(est, 0, sizeof(*est));
+
+	est->rto = CONFIG_COAP_INIT_ACK_TIMEOUT_MS;
+	est->updated = k_uptime_get_32();
+}
+
+void coap_pending_set_rto_estimator(struct coap_pending *pending,
+				    struct coap_rto_estimator *est)
+{
+	pending->rto = est;
+}
+
+/* An estimator that was not updated for a while drifts back towards the
+ * default timeout.
+ */
+static uint32_t cocoa_rto(struct coap_rto_estimator *est)
+{
+	uint32_t now = k_uptime_get_32();
+	uint32_t idle = now - est->updated;
+
+	if (est->rto < COCOA_RTO_SMALL_MS && idle > 16U * est->rto) {
+		est->rto *= 2U;
+		est->updated = now;
+	} else if (est->rto > COCOA_RTO_LARGE_MS && idle > 4U * est->rto) {
+		est->rto = COCOA_RTO_SMALL_MS + est->rto / 2U;
+		est->updated = now;
+	}
+
+	return est->rto;
+}
+
+/* Variable backoff factor, in halves */
+static uint8_t cocoa_backoff(uint32_t rto)
+{
+	if (rto < COCOA_RTO_SMALL_MS) {
+		return 6U;
+	} else if (rto > COCOA_RTO_LARGE_MS) {
+		return 3U;
+	}
+
+	return 4U;
+}
+
+static void cocoa_estimate(uint32_t *srtt, uint32_t *rttvar, uint32_t rtt)
+{
+	uint32_t delta;
+
+	if (*srtt == 0U) {
+		*srtt = rtt;
+		*rttvar = rtt / 2U;
+		return;
+	}
+
+	delta = *srtt > rtt ? *srtt - rtt : rtt - *srtt;
+
+	/* alpha = 1/8, beta = 1/4 as in RFC 6298 */
+	*rttvar = (3U * *rttvar + delta) / 4U;
+	*srtt = (7U * *srtt + rtt) / 8U;
+}
+
+void coap_rto_estimator_update(const struct coap_pending *pending)
+{
+	struct coap_rto_estimator *est = pending->rto;
+	uint32_t now = k_uptime_get_32();
+	uint32_t rtt;
+	uint32_t rto;
+
+	if (!est || pending->timeout == 0U) {
+		return;
+	}
+
+	/* The RTT is measured from the first transmission, so that it
+	 * does not matter which transmission was acknowledged.
+	 */
+	rtt = MAX(now - pending->t_first, 1U);
+
+	if (pending->retransmissions == 0U) {
+		cocoa_estimate(&est->strong_srtt, &est->strong_rttvar, rtt);
+		rto = est->strong_srtt + 4U * est->strong_rttvar;
+		est->rto = (rto + est->rto) / 2U;
+	} else if (pending->retransmissions <= 2U) {
+		cocoa_estimate(&est->weak_srtt, &est->weak_rttvar, rtt);
+		rto = est->weak_srtt + est->weak_rttvar;
+		est->rto = (rto + 3U * est->rto) / 4U;
+	} else {
+		return;
+	}
+
+	est->rto = MIN(est->rto, COCOA_RTO_MAX_MS);
+	est->updated = now;
+}
+#endif /* CONFIG_COAP_COCOA */
+
+static uint32_t first_timeout(struct coap_pending *pending)
+{
+#if defined(CONFIG_COAP_COCOA)
+	if (pending->rto) {
+		uint32_t rto = cocoa_rto(pending->rto);
+
+		pending->t_first = k_uptime_get_32();
+		pending->retransmissions = 0U;
+		pending->backoff = cocoa_backoff(rto);
+
+		return init_ack_timeout(rto);
+	}
+#endif
+
+	return init_ack_timeout(CONFIG_COAP_INIT_ACK_TIMEOUT_MS);
+}
+
+static uint32_t next_timeout(struct coap_pending *pending)
+{
+#if defined(CONFIG_COAP_COCOA)
+	if (pending->rto) {
+		pending->retransmissions++;
+
+		return MIN(pending->timeout * pending->backoff / 2U,
+			   COCOA_RTO_MAX_MS);
+	}
+#endif
+
+	return pending->timeout << 1;
+}
+
 bool coap_pending_cycle(struct coap_pending *pending)
 {
 	if (pending->timeout == 0) {
 		/* Initial transmission. */
-		pending->timeout = init_ack_timeout();
+		pending->timeout = first_timeout(pending);
 
 		return true;
 	}
@@ -1246,7 +1671,7 @@ bool coap_pending_cycle(struct coap_pending *pending)
 	}
 
 	pending->t0 += pending->timeout;
-	pending->timeout = pending->timeout << 1;
+	pending->timeout = next_timeout(pending);
 	pending->retries--;
 
 	return true;
@@ -1363,12 +1788,60 @@ int coap_resource_notify(struct coap_resource *resource)
 	resource->age++;
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&resource->observers, o, list) {
+#if defined(CONFIG_COAP_OBSERVE_COALESCE)
+		uint32_t now = k_uptime_get_32();
+
+		if (now - o->last_notify < CONFIG_COAP_OBSERVE_MIN_INTERVAL_MS) {
+			o->deferred = true;
+			continue;
+		}
+
+		o->last_notify = now;
+		o->deferred = false;
+#endif
 		resource->notify(resource, o);
 	}
 
 	return 0;
 }
 
+#if defined(CONFIG_COAP_OBSERVE_COALESCE)
+int32_t coap_resource_notify_deferred(struct coap_resource *resource)
+{
+	int32_t next = SYS_FOREVER_MS;
+	struct coap_observer *o, *tmp;
+
+	if (!resource->notify) {
+		return SYS_FOREVER_MS;
+	}
+
+	/* The notify callback may remove the observer */
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&resource->observers, o, tmp, list) {
+		uint32_t now = k_uptime_get_32();
+		uint32_t elapsed = now - o->last_notify;
+		int32_t remaining;
+
+		if (!o->deferred) {
+			continue;
+		}
+
+		if (elapsed >= CONFIG_COAP_OBSERVE_MIN_INTERVAL_MS) {
+			o->last_notify = now;
+			o->deferred = false;
+			resource->notify(resource, o);
+			continue;
+		}
+
+		remaining = CONFIG_COAP_OBSERVE_MIN_INTERVAL_MS - elapsed;
+		if (next == SYS_FOREVER_MS || remaining < next) {
+			next = remaining;
+		}
+	}
+
+	return next;
+}
+#endif /* CONFIG_COAP_OBSERVE_COALESCE */
+
 bool coap_request_is_observe(const struct coap_packet *request)
 {
 	return coap_get_option_int(request, COAP_OPTION_OBSERVE) == 0;
@@ -1381,6 +1854,13 @@ void coap_observer_init(struct coap_observer *observer,
 	observer->tkl = coap_header_get_token(request, observer->token);
 
 	net_ipaddr_copy(&observer->addr, addr);
+
+#if defined(CONFIG_COAP_OBSERVE_COALESCE)
+	/* The first notification is never deferred */
+	observer->last_notify = k_uptime_get_32() -
+				CONFIG_COAP_OBSERVE_MIN_INTERVAL_MS;
+	observer->deferred = false;
+#endif
 }
 
 bool coap_register_observer(struct coap_resource *resource,
@@ -0,0 +1,197 @@
+/** @file
+ * @brief DNS resolver cache
+ *
+ * Keeps the answers of resolved queries until their TTL expires so that
+ * repeated lookups of the same name do not need a round trip to the DNS
+ * server. Names that do not resolve are cached for a shorter time.
+ */
+
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_dns_resolve, CONFIG_DNS_RESOLVER_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+
+#include <net/dns_resolve.h>
+#include "dns_internal.h"
+
+struct dns_cache_entry {
+	/** Resolved name, empty if the entry is not in use */
+	char query[CONFIG_DNS_RESOLVER_CACHE_NAME_LEN + 1];
+
+	/** Cached addresses */
+	struct dns_addrinfo info[CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES];
+
+	/** When the entry expires (in ms) */
+	int64_t expires;
+
+	/** When the entry was last added or found (in ms) */
+	int64_t last_used;
+
+	/** Query type */
+	enum dns_query_type type;
+
+	/** Number of cached addresses, 0 for a negative entry */
+	uint8_t count;
+};
+
+static struct dns_cache_entry dns_cache[CONFIG_DNS_RESOLVER_CACHE_SIZE];
+static K_MUTEX_DEFINE(dns_cache_lock);
+
+static bool dns_cache_entry_valid(struct dns_cache_entry *entry, int64_t now)
+{
+	if (entry->query[0] == '\0') {
+		return false;
+	}
+
+	if (entry->expires - now <= 0) {
+		entry->query[0] = '\0';
+		return false;
+	}
+
+	return true;
+}
+
+static struct dns_cache_entry *dns_cache_lookup(const char *query,
+						enum dns_query_type type,
+						int64_t now)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(dns_cache); i++) {
+		if (dns_cache_entry_valid(&dns_cache[i], now) &&
+		    dns_cache[i].type == type &&
+		    strncasecmp(dns_cache[i].query, query,
+				sizeof(dns_cache[i].query)) == 0) {
+			return &dns_cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Return a free entry, or the entry that was used the longest time ago */
+static struct dns_cache_entry *dns_cache_get(int64_t now)
+{
+	struct dns_cache_entry *oldest = &dns_cache[0];
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(dns_cache); i++) {
+		if (!dns_cache_entry_valid(&dns_cache[i], now)) {
+			return &dns_cache[i];
+		}
+
+		if (dns_cache[i].last_used < oldest->last_used) {
+			oldest = &dns_cache[i];
+		}
+	}
+
+	return oldest;
+}
+
+int dns_cache_find(const char *query, enum dns_query_type type,
+		   struct dns_addrinfo *info, size_t info_len)
+{
+	struct dns_cache_entry *entry;
+	int64_t now = k_uptime_get();
+	int ret = -ENOENT;
+
+	k_mutex_lock(&dns_cache_lock, K_FOREVER);
+
+	entry = dns_cache_lookup(query, type, now);
+	if (entry) {
+		ret = MIN(entry->count, info_len);
+		memcpy(info, entry->info, ret * sizeof(*info));
+		entry->last_used = now;
+
+		NET_DBG("Cache hit for %s (%d addresses)", log_strdup(query),
+			ret);
+	}
+
+	k_mutex_unlock(&dns_cache_lock);
+
+	return ret;
+}
+
+void dns_cache_add(const char *query, enum dns_query_type type,
+		   const struct dns_addrinfo *info, size_t count,
+		   uint32_t ttl)
+{
+	struct dns_cache_entry *entry;
+	int64_t now = k_uptime_get();
+
+	ttl = MIN(ttl, CONFIG_DNS_RESOLVER_CACHE_MAX_TTL);
+
+	if (ttl == 0U || strlen(query) > CONFIG_DNS_RESOLVER_CACHE_NAME_LEN) {
+		return;
+	}
+
+	k_mutex_lock(&dns_cache_lock, K_FOREVER);
+
+	entry = dns_cache_lookup(query, type, now);
+	if (!entry) {
+		entry = dns_cache_get(now);
+		strcpy(entry->query, query);
+		entry->type = type;
+	}
+
+	entry->count = MIN(count, ARRAY_SIZE(entry->info));
+	if (entry->count) {
+		memcpy(entry->info, info, entry->count * sizeof(*info));
+	}
+
+	entry->expires = now + (int64_t)ttl * MSEC_PER_SEC;
+	entry->last_used = now;
+
+	NET_DBG("Cached %s (%u addresses, ttl %u)", log_strdup(query),
+		entry->count, ttl);
+
+	k_mutex_unlock(&dns_cache_lock);
+}
+
+int dns_resolve_cache_foreach(dns_resolve_cache_cb_t cb, void *user_data)
+{
+	int64_t now = k_uptime_get();
+	int i, found = 0;
+
+	k_mutex_lock(&dns_cache_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(dns_cache); i++) {
+		if (!dns_cache_entry_valid(&dns_cache[i], now)) {
+			continue;
+		}
+
+		cb(dns_cache[i].query, dns_cache[i].type,
+		   dns_cache[i].count ? dns_cache[i].info : NULL,
+		   dns_cache[i].count,
+		   (uint32_t)((dns_cache[i].expires - now) / MSEC_PER_SEC),
+		   user_data);
+		found++;
+	}
+
+	k_mutex_unlock(&dns_cache_lock);
+
+	return found;
+}
+
+void dns_resolve_cache_flush(void)
+{
+	int i;
+
+	k_mutex_lock(&dns_cache_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(dns_cache); i++) {
+		dns_cache[i].query[0] = '\0';
+	}
+
+	k_mutex_unlock(&dns_cache_lock);
+}
@@ -5,6 +5,7 @@
  */
 
 #include <zephyr/types.h>
+#include <errno.h>
 #include <net/buf.h>
 #include <net/dns_resolve.h>
 
@@ -18,3 +19,30 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 		     struct net_buf *dns_cname,
 		     uint16_t *query_hash);
 #endif
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+/* Return the number of cached addresses copied to info, 0 if the name is
+ * known not to resolve, or -ENOENT if there is no valid cache entry.
+ */
+int dns_cache_find(const char *query, enum dns_query_type type,
+		   struct dns_addrinfo *info, size_t info_len);
+
+/* Store the result of a query. A count of 0 adds a negative entry. Nothing
+ * is stored if the ttl is 0.
+ */
+void dns_cache_add(const char *query, enum dns_query_type type,
+		   const struct dns_addrinfo *info, size_t count,
+		   uint32_t ttl);
+#else
+static inline int dns_cache_find(const char *query, enum dns_query_type type,
+				 struct dns_addrinfo *info, size_t info_len)
+{
+	return -ENOENT;
+}
+
+static inline void dns_cache_add(const char *query, enum dns_query_type type,
+				 const struct dns_addrinfo *info, size_t count,
+				 uint32_t ttl)
+{
+}
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
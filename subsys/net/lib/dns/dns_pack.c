@@ -221,9 +221,14 @@ int dns_unpack_response_header(struct dns_msg_t *msg, int src_id)
 	ancount = dns_unpack_header_ancount(dns_header);
 
 	/* For mDNS (when src_id == 0) the query count is 0 so accept
-	 * the packet in that case.
+	 * the packet in that case. A unicast response without answers
+	 * tells that the name has no records of the requested type, which
+	 * is only of use to the cache. An mDNS response without answers
+	 * cannot be matched to a query.
 	 */
-	if ((qdcount < 1 && src_id > 0) || ancount < 1) {
+	if ((qdcount < 1 && src_id > 0) ||
+	    (ancount < 1 &&
+	     (src_id == 0 || !IS_ENABLED(CONFIG_DNS_RESOLVER_CACHE)))) {
 		return -EINVAL;
 	}
 
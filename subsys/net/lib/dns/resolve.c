@@ -18,6 +18,7 @@ LOG_MODULE_REGISTER(net_dns_resolve, CONFIG_DNS_RESOLVER_LOG_LEVEL);
 #include <string.h>
 #include <errno.h>
 #include <stdlib.h>
+#include <strings.h>
 
 #include <sys/crc.h>
 #include <net/net_ip.h>
@@ -416,6 +417,24 @@ static inline void invoke_query_callback(int status,
 	if (pending_query->query != NULL)  {
 		pending_query->cb(status, info, pending_query->user_data);
 	}
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	/* Queries waiting for the same answer get the same results. The
+	 * unit test does not set the ctx.
+	 */
+	if (pending_query->ctx != NULL) {
+		struct dns_pending_query *queries = pending_query->ctx->queries;
+		int i;
+
+		for (i = 0; i < CONFIG_DNS_NUM_CONCUR_QUERIES; i++) {
+			if (queries[i].leader == pending_query &&
+			    queries[i].query != NULL) {
+				queries[i].cb(status, info,
+					      queries[i].user_data);
+			}
+		}
+	}
+#endif
 }
 
 /* Release a query slot reserved by get_cb_slot().
@@ -439,6 +458,32 @@ static void release_query(struct dns_pending_query *pending_query)
 		 */
 		pending_query->query = NULL;
 	}
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	pending_query->leader = NULL;
+	pending_query->has_adopted_id = false;
+
+	if (pending_query->ctx != NULL) {
+		struct dns_pending_query *queries = pending_query->ctx->queries;
+		int i;
+
+		for (i = 0; i < CONFIG_DNS_NUM_CONCUR_QUERIES; i++) {
+			if (queries[i].leader == pending_query) {
+				release_query(&queries[i]);
+			}
+		}
+	}
+#endif
+}
+
+static inline bool query_has_adopted_id(struct dns_pending_query *query,
+					uint16_t dns_id)
+{
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	return query->has_adopted_id && query->adopted_id == dns_id;
+#else
+	return false;
+#endif
 }
 
 /* Must be invoked with context lock held */
@@ -450,7 +495,8 @@ static inline int get_slot_by_id(struct dns_resolve_context *ctx,
 
 	for (i = 0; i < CONFIG_DNS_NUM_CONCUR_QUERIES; i++) {
 		if (check_query_active(&ctx->queries[i], false) &&
-		    ctx->queries[i].id == dns_id &&
+		    (ctx->queries[i].id == dns_id ||
+		     query_has_adopted_id(&ctx->queries[i], dns_id)) &&
 		    (query_hash == 0 ||
 		     ctx->queries[i].query_hash == query_hash)) {
 			return i;
@@ -473,6 +519,11 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 {
 	struct dns_addrinfo info = { 0 };
 	uint32_t ttl; /* RR ttl, so far it is not passed to caller */
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	struct dns_addrinfo cache_info[CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES];
+	uint32_t cache_ttl = UINT32_MAX;
+	int rcode;
+#endif
 	uint8_t *src, *addr;
 	const char *query_name;
 	int address_size;
@@ -515,6 +566,10 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 		goto quit;
 	}
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	rcode = ret;
+#endif
+
 	if (dns_header_qdcount(dns_msg->msg) != 1) {
 		/* For mDNS (when dns_id == 0) the query count is 0 */
 		if (*dns_id > 0) {
@@ -546,6 +601,7 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 	answer_ptr = DNS_QUERY_POS;
 	items = 0;
 	server_idx = 0;
+	dns_msg->response_type = DNS_RESPONSE_INVALID;
 	enum dns_rr_type answer_type = DNS_RR_TYPE_INVALID;
 
 	while (server_idx < dns_header_ancount(dns_msg->msg)) {
@@ -635,6 +691,14 @@ query_known:
 
 			invoke_query_callback(DNS_EAI_INPROGRESS, &info,
 					      &ctx->queries[*query_idx]);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+			if (items < ARRAY_SIZE(cache_info)) {
+				cache_info[items] = info;
+			}
+
+			cache_ttl = MIN(cache_ttl, ttl);
+#endif
 			items++;
 			break;
 
@@ -706,6 +770,25 @@ query_known:
 		ret = DNS_EAI_ALLDONE;
 	}
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	if (ctx->queries[*query_idx].query == NULL) {
+		/* The query is being released, nothing to cache */
+	} else if (items > 0) {
+		dns_cache_add(ctx->queries[*query_idx].query,
+			      ctx->queries[*query_idx].query_type,
+			      cache_info, MIN(items, ARRAY_SIZE(cache_info)),
+			      cache_ttl);
+	} else if (rcode == DNS_HEADER_NOERROR ||
+		   rcode == DNS_HEADER_NAMEERROR) {
+		/* Server failures are not remembered, only the answers
+		 * telling that the name has no such address.
+		 */
+		dns_cache_add(ctx->queries[*query_idx].query,
+			      ctx->queries[*query_idx].query_type,
+			      NULL, 0, CONFIG_DNS_RESOLVER_CACHE_NEGATIVE_TTL);
+	}
+#endif
+
 quit:
 	return ret;
 }
@@ -947,12 +1030,68 @@ static int dns_write(struct dns_resolve_context *ctx,
 	return 0;
 }
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+/* Let the first query waiting for the answer to the leader take over the
+ * request the leader sent. The other waiting queries then wait for the new
+ * leader.
+ *
+ * Must be invoked with context lock held.
+ */
+static bool promote_follower(struct dns_resolve_context *ctx,
+			     struct dns_pending_query *leader)
+{
+	struct dns_pending_query *new_leader = NULL;
+	int i;
+
+	for (i = 0; i < CONFIG_DNS_NUM_CONCUR_QUERIES; i++) {
+		if (ctx->queries[i].leader != leader) {
+			continue;
+		}
+
+		if (new_leader) {
+			ctx->queries[i].leader = new_leader;
+			continue;
+		}
+
+		new_leader = &ctx->queries[i];
+		new_leader->leader = NULL;
+		new_leader->query_hash = leader->query_hash;
+		new_leader->adopted_id = leader->has_adopted_id ?
+			leader->adopted_id : leader->id;
+		new_leader->has_adopted_id = true;
+
+		NET_DBG("Query %u takes over query %u", new_leader->id,
+			new_leader->adopted_id);
+	}
+
+	return new_leader != NULL;
+}
+#endif
+
 /* Must be invoked with context lock held */
 static void dns_resolve_cancel_slot(struct dns_resolve_context *ctx, int slot)
 {
-	invoke_query_callback(DNS_EAI_CANCELED, NULL, &ctx->queries[slot]);
+	struct dns_pending_query *pending_query = &ctx->queries[slot];
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	/* The queries waiting for the same answer are not cancelled, they
+	 * still get the answer or time out on their own.
+	 */
+	if (pending_query->leader == NULL &&
+	    promote_follower(ctx, pending_query)) {
+		if (pending_query->query != NULL) {
+			pending_query->cb(DNS_EAI_CANCELED, NULL,
+					  pending_query->user_data);
+		}
+
+		release_query(pending_query);
+		return;
+	}
+#endif
+
+	invoke_query_callback(DNS_EAI_CANCELED, NULL, pending_query);
 
-	release_query(&ctx->queries[slot]);
+	release_query(pending_query);
 }
 
 /* Must be invoked with context lock held */
@@ -1103,6 +1242,59 @@ static void query_timeout(struct k_work *work)
 	k_mutex_unlock(&pending_query->ctx->lock);
 }
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+/* Pass the cached result to the caller if there is one */
+static bool dns_resolve_from_cache(const char *query,
+				   enum dns_query_type type,
+				   dns_resolve_cb_t cb,
+				   void *user_data)
+{
+	struct dns_addrinfo info[CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES];
+	int count, i;
+
+	count = dns_cache_find(query, type, info, ARRAY_SIZE(info));
+	if (count < 0) {
+		return false;
+	}
+
+	if (count == 0) {
+		cb(DNS_EAI_NODATA, NULL, user_data);
+		return true;
+	}
+
+	for (i = 0; i < count; i++) {
+		cb(DNS_EAI_INPROGRESS, &info[i], user_data);
+	}
+
+	cb(DNS_EAI_ALLDONE, NULL, user_data);
+
+	return true;
+}
+
+/* Find a query that is already resolving the same name and type.
+ *
+ * Must be invoked with context lock held.
+ */
+static struct dns_pending_query *get_leader(struct dns_resolve_context *ctx,
+					    const char *query,
+					    enum dns_query_type type)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_DNS_NUM_CONCUR_QUERIES; i++) {
+		if (ctx->queries[i].cb != NULL &&
+		    ctx->queries[i].query != NULL &&
+		    ctx->queries[i].leader == NULL &&
+		    ctx->queries[i].query_type == type &&
+		    strcasecmp(ctx->queries[i].query, query) == 0) {
+			return &ctx->queries[i];
+		}
+	}
+
+	return NULL;
+}
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
 int dns_resolve_name(struct dns_resolve_context *ctx,
 		     const char *query,
 		     enum dns_query_type type,
@@ -1180,6 +1372,16 @@ int dns_resolve_name(struct dns_resolve_context *ctx,
 	}
 
 try_resolve:
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	if (dns_resolve_from_cache(query, type, cb, user_data)) {
+		if (dns_id) {
+			*dns_id = 0U;
+		}
+
+		return 0;
+	}
+#endif
+
 	k_mutex_lock(&ctx->lock, K_FOREVER);
 
 	if (ctx->state != DNS_RESOLVE_CONTEXT_ACTIVE) {
@@ -1200,9 +1402,38 @@ try_resolve:
 	ctx->queries[i].user_data = user_data;
 	ctx->queries[i].ctx = ctx;
 	ctx->queries[i].query_hash = 0;
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	ctx->queries[i].has_adopted_id = false;
+#endif
 
 	k_work_init_delayable(&ctx->queries[i].timer, query_timeout);
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	ctx->queries[i].leader = get_leader(ctx, query, type);
+	if (ctx->queries[i].leader) {
+		/* The answer to the leader query completes this one too, so
+		 * only the timer is needed. The id is used for cancelling.
+		 */
+		do {
+			ctx->queries[i].id = sys_rand32_get();
+		} while (ctx->queries[i].id == 0U);
+
+		ctx->queries[i].query_hash = ctx->queries[i].leader->query_hash;
+
+		if (dns_id) {
+			*dns_id = ctx->queries[i].id;
+		}
+
+		NET_DBG("Query %u waits for query %u", ctx->queries[i].id,
+			ctx->queries[i].leader->id);
+
+		k_work_reschedule(&ctx->queries[i].timer, tout);
+
+		ret = 0;
+		goto quit;
+	}
+#endif
+
 	dns_data = net_buf_alloc(&dns_msg_pool, ctx->buf_timeout);
 	if (!dns_data) {
 		ret = -ENOMEM;
@@ -1410,6 +1641,11 @@ int dns_resolve_reconfigure(struct dns_resolve_context *ctx,
 		}
 	}
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	/* The new servers might give different answers */
+	dns_resolve_cache_flush();
+#endif
+
 	err = dns_resolve_init_locked(ctx, servers, servers_sa);
 
 unlock:
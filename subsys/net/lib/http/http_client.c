@@ -25,8 +25,10 @@ LOG_MODULE_REGISTER(net_http, CONFIG_NET_HTTP_LOG_LEVEL);
 #include <net/http_client.h>
 
 #include "net_private.h"
+#include "http_internal.h"
 
 #define HTTP_CONTENT_LEN_SIZE 6
+#define HTTP_CHUNK_SIZE_LEN 8
 #define MAX_SEND_BUF_LEN 192
 
 static ssize_t sendall(int sock, const void *buf, size_t len)
@@ -45,7 +47,28 @@ static ssize_t sendall(int sock, const void *buf, size_t len)
 	return 0;
 }
 
-static int http_send_data(int sock, char *send_buf,
+/* Like sendall(), but remember if any of the request was written, so that
+ * the connection pool knows if the request may be sent again.
+ */
+static int http_sendall(struct http_request *req, const void *buf, size_t len)
+{
+	while (len) {
+		ssize_t out_len = send(req->internal.sock, buf, len, 0);
+
+		if (out_len < 0) {
+			return -errno;
+		}
+
+		req->internal.request_sent = true;
+
+		buf = (const char *)buf + out_len;
+		len -= out_len;
+	}
+
+	return 0;
+}
+
+static int http_send_data(struct http_request *req, char *send_buf,
 			  size_t send_buf_max_len, size_t *send_buf_pos,
 			  ...)
 {
@@ -79,7 +102,7 @@ static int http_send_data(int sock, char *send_buf,
 				LOG_HEXDUMP_DBG(send_buf, end_of_send,
 						"Data to send");
 
-				ret = sendall(sock, send_buf, end_of_send);
+				ret = http_sendall(req, send_buf, end_of_send);
 				if (ret < 0) {
 					NET_DBG("Cannot send %d bytes (%d)",
 						end_of_send, ret);
@@ -118,11 +141,12 @@ err:
 	return ret;
 }
 
-static int http_flush_data(int sock, const char *send_buf, size_t send_buf_len)
+static int http_flush_data(struct http_request *req, const char *send_buf,
+			   size_t send_buf_len)
 {
 	LOG_HEXDUMP_DBG(send_buf, send_buf_len, "Data to send");
 
-	return sendall(sock, send_buf, send_buf_len);
+	return http_sendall(req, send_buf, send_buf_len);
 }
 
 static void print_header_field(size_t len, const char *str)
@@ -269,6 +293,21 @@ static int on_body(struct http_parser *parser, const char *at, size_t length)
 		req->internal.response.body_start = (uint8_t *)at;
 	}
 
+	if (req->body_cb) {
+		int ret;
+
+		/* Hand out the parsed data directly, the receive buffer is
+		 * reused right after.
+		 */
+		ret = req->body_cb(&req->internal.response, (const uint8_t *)at,
+				   length, req->internal.user_data);
+
+		req->internal.response.data_len = 0;
+		req->internal.response.body_start = NULL;
+
+		return ret;
+	}
+
 	if (req->internal.response.cb) {
 		if (http_should_keep_alive(parser)) {
 			NET_DBG("Calling callback for partitioned %zd len data",
@@ -353,6 +392,7 @@ static int on_message_complete(struct http_parser *parser)
 		http_method_str(req->method));
 
 	req->internal.response.message_complete = 1;
+	req->internal.response.keep_alive = http_should_keep_alive(parser);
 
 	if (req->internal.response.cb) {
 		req->internal.response.cb(&req->internal.response,
@@ -360,6 +400,11 @@ static int on_message_complete(struct http_parser *parser)
 					  req->internal.user_data);
 	}
 
+	/* Stop parsing here, the data that follows belongs to the next
+	 * response on the connection.
+	 */
+	http_parser_pause(parser, 1);
+
 	return 0;
 }
 
@@ -408,16 +453,29 @@ static void http_client_init_parser(struct http_parser *parser,
 	settings->on_url = on_url;
 }
 
-static int http_wait_data(int sock, struct http_request *req)
+/* Receive and parse one response. On entry, *pending bytes at the start of
+ * the receive buffer were already received. On exit, *pending bytes received
+ * past the end of the response are left at *pending_data.
+ */
+static int http_wait_data(int sock, struct http_request *req,
+			  uint8_t **pending_data, size_t *pending)
 {
 	int total_received = 0;
 	size_t offset = 0;
+	size_t parsed;
 	int received, ret;
 
+	received = *pending;
+	*pending = 0;
+
 	do {
-		received = recv(sock, req->internal.response.recv_buf + offset,
-				req->internal.response.recv_buf_len - offset,
-				0);
+		if (received == 0) {
+			received = recv(sock,
+					req->internal.response.recv_buf + offset,
+					req->internal.response.recv_buf_len -
+					offset, 0);
+		}
+
 		if (received == 0) {
 			/* Connection closed */
 			LOG_DBG("Connection closed");
@@ -428,28 +486,40 @@ static int http_wait_data(int sock, struct http_request *req)
 			LOG_DBG("Connection error (%d)", errno);
 			ret = -errno;
 			break;
-		} else {
-			req->internal.response.data_len += received;
-
-			(void)http_parser_execute(
-				&req->internal.parser,
-				&req->internal.parser_settings,
-				req->internal.response.recv_buf + offset,
-				received);
 		}
 
+		req->internal.response_received = true;
+		req->internal.response.data_len += received;
+
+		parsed = http_parser_execute(
+			&req->internal.parser,
+			&req->internal.parser_settings,
+			req->internal.response.recv_buf + offset,
+			received);
+
 		total_received += received;
 		offset += received;
 
-		if (offset >= req->internal.response.recv_buf_len) {
-			offset = 0;
+		if (HTTP_PARSER_ERRNO(&req->internal.parser) == HPE_CB_body) {
+			LOG_DBG("Response aborted");
+			ret = -ECONNABORTED;
+			break;
 		}
 
 		if (req->internal.response.message_complete) {
-			ret = total_received;
+			*pending = received - parsed;
+			*pending_data = req->internal.response.recv_buf +
+					offset - *pending;
+			req->internal.response.data_len -= *pending;
+			ret = total_received - *pending;
 			break;
 		}
 
+		if (offset >= req->internal.response.recv_buf_len) {
+			offset = 0;
+		}
+
+		received = 0;
 	} while (true);
 
 	return ret;
@@ -461,37 +531,70 @@ static void http_timeout(struct k_work *work)
 		CONTAINER_OF(work, struct http_client_internal_data, work);
 
 	(void)close(data->sock);
+	data->sock = -1;
 }
 
-int http_client_req(int sock, struct http_request *req,
-		    int32_t timeout, void *user_data)
+static int http_send_chunked(int sock, struct http_request *req,
+			     void *user_data)
+{
+	char size_str[HTTP_CHUNK_SIZE_LEN + sizeof(HTTP_CRLF)];
+	struct iovec iov[3];
+	const uint8_t *data;
+	int total_sent = 0;
+	int len, ret;
+
+	while (true) {
+		len = req->payload_chunk_cb(req, &data, user_data);
+		if (len < 0) {
+			return len;
+		}
+
+		if (len == 0) {
+			break;
+		}
+
+		ret = snprintk(size_str, sizeof(size_str), "%x" HTTP_CRLF,
+			       len);
+
+		iov[0].iov_base = size_str;
+		iov[0].iov_len = ret;
+		iov[1].iov_base = (void *)data;
+		iov[1].iov_len = len;
+		iov[2].iov_base = HTTP_CRLF;
+		iov[2].iov_len = sizeof(HTTP_CRLF) - 1;
+
+		ret = http_sendall_iov(sock, iov, ARRAY_SIZE(iov),
+				       SYS_FOREVER_MS);
+		if (ret < 0) {
+			return ret;
+		}
+
+		total_sent += iov[0].iov_len + len + iov[2].iov_len;
+	}
+
+	ret = sendall(sock, "0" HTTP_CRLF HTTP_CRLF,
+		      sizeof("0" HTTP_CRLF HTTP_CRLF) - 1);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return total_sent + sizeof("0" HTTP_CRLF HTTP_CRLF) - 1;
+}
+
+static int http_send_request(int sock, struct http_request *req,
+			     void *user_data)
 {
 	/* Utilize the network usage by sending data in bigger blocks */
 	char send_buf[MAX_SEND_BUF_LEN];
 	const size_t send_buf_max_len = sizeof(send_buf);
 	size_t send_buf_pos = 0;
 	int total_sent = 0;
-	int ret, total_recv, i;
+	int ret, i;
 	const char *method;
 
-	if (sock < 0 || req == NULL || req->response == NULL ||
-	    req->recv_buf == NULL || req->recv_buf_len == 0) {
-		return -EINVAL;
-	}
-
-	memset(&req->internal.response, 0, sizeof(req->internal.response));
-
-	req->internal.response.http_cb = req->http_cb;
-	req->internal.response.cb = req->response;
-	req->internal.response.recv_buf = req->recv_buf;
-	req->internal.response.recv_buf_len = req->recv_buf_len;
-	req->internal.user_data = user_data;
-	req->internal.sock = sock;
-	req->internal.timeout = SYS_TIMEOUT_MS(timeout);
-
 	method = http_method_str(req->method);
 
-	ret = http_send_data(sock, send_buf, send_buf_max_len, &send_buf_pos,
+	ret = http_send_data(req, send_buf, send_buf_max_len, &send_buf_pos,
 			     method, " ", req->url, " ", req->protocol,
 			     HTTP_CRLF, NULL);
 	if (ret < 0) {
@@ -501,7 +604,7 @@ int http_client_req(int sock, struct http_request *req,
 	total_sent += ret;
 
 	if (req->port) {
-		ret = http_send_data(sock, send_buf, send_buf_max_len,
+		ret = http_send_data(req, send_buf, send_buf_max_len,
 				     &send_buf_pos, "Host", ": ", req->host,
 				     ":", req->port, HTTP_CRLF, NULL);
 
@@ -511,7 +614,7 @@ int http_client_req(int sock, struct http_request *req,
 
 		total_sent += ret;
 	} else {
-		ret = http_send_data(sock, send_buf, send_buf_max_len,
+		ret = http_send_data(req, send_buf, send_buf_max_len,
 				     &send_buf_pos, "Host", ": ", req->host,
 				     HTTP_CRLF, NULL);
 
@@ -523,7 +626,7 @@ int http_client_req(int sock, struct http_request *req,
 	}
 
 	if (req->optional_headers_cb) {
-		ret = http_flush_data(sock, send_buf, send_buf_pos);
+		ret = http_flush_data(req, send_buf, send_buf_pos);
 		if (ret < 0) {
 			goto out;
 		}
@@ -540,7 +643,7 @@ int http_client_req(int sock, struct http_request *req,
 	} else {
 		for (i = 0; req->optional_headers && req->optional_headers[i];
 		     i++) {
-			ret = http_send_data(sock, send_buf, send_buf_max_len,
+			ret = http_send_data(req, send_buf, send_buf_max_len,
 					     &send_buf_pos,
 					     req->optional_headers[i], NULL);
 			if (ret < 0) {
@@ -552,7 +655,7 @@ int http_client_req(int sock, struct http_request *req,
 	}
 
 	for (i = 0; req->header_fields && req->header_fields[i]; i++) {
-		ret = http_send_data(sock, send_buf, send_buf_max_len,
+		ret = http_send_data(req, send_buf, send_buf_max_len,
 				     &send_buf_pos, req->header_fields[i],
 				     NULL);
 		if (ret < 0) {
@@ -563,7 +666,7 @@ int http_client_req(int sock, struct http_request *req,
 	}
 
 	if (req->content_type_value) {
-		ret = http_send_data(sock, send_buf, send_buf_max_len,
+		ret = http_send_data(req, send_buf, send_buf_max_len,
 				     &send_buf_pos, "Content-Type", ": ",
 				     req->content_type_value, HTTP_CRLF, NULL);
 		if (ret < 0) {
@@ -573,7 +676,31 @@ int http_client_req(int sock, struct http_request *req,
 		total_sent += ret;
 	}
 
-	if (req->payload || req->payload_cb) {
+	if (req->payload_chunk_cb) {
+		ret = http_send_data(req, send_buf, send_buf_max_len,
+				     &send_buf_pos, "Transfer-Encoding", ": ",
+				     "chunked", HTTP_CRLF, HTTP_CRLF, NULL);
+		if (ret < 0) {
+			goto out;
+		}
+
+		total_sent += ret;
+
+		ret = http_flush_data(req, send_buf, send_buf_pos);
+		if (ret < 0) {
+			goto out;
+		}
+
+		send_buf_pos = 0;
+		total_sent += ret;
+
+		ret = http_send_chunked(sock, req, user_data);
+		if (ret < 0) {
+			goto out;
+		}
+
+		total_sent += ret;
+	} else if (req->payload || req->payload_cb) {
 		if (req->payload_len) {
 			char content_len_str[HTTP_CONTENT_LEN_SIZE];
 
@@ -584,12 +711,12 @@ int http_client_req(int sock, struct http_request *req,
 				goto out;
 			}
 
-			ret = http_send_data(sock, send_buf, send_buf_max_len,
+			ret = http_send_data(req, send_buf, send_buf_max_len,
 					     &send_buf_pos, "Content-Length", ": ",
 					     content_len_str, HTTP_CRLF,
 					     HTTP_CRLF, NULL);
 		} else {
-			ret = http_send_data(sock, send_buf, send_buf_max_len,
+			ret = http_send_data(req, send_buf, send_buf_max_len,
 				     &send_buf_pos, HTTP_CRLF, NULL);
 		}
 
@@ -599,7 +726,7 @@ int http_client_req(int sock, struct http_request *req,
 
 		total_sent += ret;
 
-		ret = http_flush_data(sock, send_buf, send_buf_pos);
+		ret = http_flush_data(req, send_buf, send_buf_pos);
 		if (ret < 0) {
 			goto out;
 		}
@@ -631,7 +758,7 @@ int http_client_req(int sock, struct http_request *req,
 			total_sent += length;
 		}
 	} else {
-		ret = http_send_data(sock, send_buf, send_buf_max_len,
+		ret = http_send_data(req, send_buf, send_buf_max_len,
 				     &send_buf_pos, HTTP_CRLF, NULL);
 		if (ret < 0) {
 			goto out;
@@ -639,7 +766,7 @@ int http_client_req(int sock, struct http_request *req,
 	}
 
 	if (send_buf_pos > 0) {
-		ret = http_flush_data(sock, send_buf, send_buf_pos);
+		ret = http_flush_data(req, send_buf, send_buf_pos);
 		if (ret < 0) {
 			goto out;
 		}
@@ -649,9 +776,43 @@ int http_client_req(int sock, struct http_request *req,
 
 	NET_DBG("Sent %d bytes", total_sent);
 
+	return total_sent;
+
+out:
+	return ret;
+}
+
+static int http_client_prepare(int sock, struct http_request *req,
+			       int32_t timeout, void *user_data)
+{
+	if (sock < 0 || req == NULL || req->response == NULL ||
+	    req->recv_buf == NULL || req->recv_buf_len == 0) {
+		return -EINVAL;
+	}
+
+	memset(&req->internal.response, 0, sizeof(req->internal.response));
+
+	req->internal.response.http_cb = req->http_cb;
+	req->internal.response.cb = req->response;
+	req->internal.response.recv_buf = req->recv_buf;
+	req->internal.response.recv_buf_len = req->recv_buf_len;
+	req->internal.user_data = user_data;
+	req->internal.sock = sock;
+	req->internal.timeout = SYS_TIMEOUT_MS(timeout);
+	req->internal.request_sent = false;
+	req->internal.response_received = false;
+
 	http_client_init_parser(&req->internal.parser,
 				&req->internal.parser_settings);
 
+	return 0;
+}
+
+static int http_client_recv(int sock, struct http_request *req,
+			    uint8_t **pending_data, size_t *pending)
+{
+	int total_recv;
+
 	if (!K_TIMEOUT_EQ(req->internal.timeout, K_FOREVER) &&
 	    !K_TIMEOUT_EQ(req->internal.timeout, K_NO_WAIT)) {
 		k_work_init_delayable(&req->internal.work, http_timeout);
@@ -659,8 +820,7 @@ int http_client_req(int sock, struct http_request *req,
 					req->internal.timeout);
 	}
 
-	/* Request is sent, now wait data to be received */
-	total_recv = http_wait_data(sock, req);
+	total_recv = http_wait_data(sock, req, pending_data, pending);
 	if (total_recv < 0) {
 		NET_DBG("Wait data failure (%d)", total_recv);
 	} else {
@@ -672,8 +832,89 @@ int http_client_req(int sock, struct http_request *req,
 		(void)k_work_cancel_delayable(&req->internal.work);
 	}
 
+	return total_recv;
+}
+
+int http_client_req(int sock, struct http_request *req,
+		    int32_t timeout, void *user_data)
+{
+	uint8_t *pending_data = NULL;
+	size_t pending = 0;
+	int total_sent;
+	int ret;
+
+	ret = http_client_prepare(sock, req, timeout, user_data);
+	if (ret < 0) {
+		return ret;
+	}
+
+	total_sent = http_send_request(sock, req, user_data);
+	if (total_sent < 0) {
+		return total_sent;
+	}
+
+	/* Request is sent, now wait data to be received */
+	(void)http_client_recv(sock, req, &pending_data, &pending);
+
 	return total_sent;
+}
 
-out:
-	return ret;
+int http_client_req_pipeline(int sock, struct http_request **reqs,
+			     size_t count, int32_t timeout, void *user_data)
+{
+	uint8_t *pending_data = NULL;
+	size_t pending = 0;
+	size_t i;
+	int ret;
+
+	if (reqs == NULL || count == 0) {
+		return -EINVAL;
+	}
+
+	for (i = 0; i < count; i++) {
+		ret = http_client_prepare(sock, reqs[i], timeout, user_data);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	/* Send all the requests before waiting for the first response */
+	for (i = 0; i < count; i++) {
+		ret = http_send_request(sock, reqs[i], user_data);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	for (i = 0; i < count; i++) {
+		if (pending > 0) {
+			/* The previous read went past the end of its response,
+			 * start parsing the next one from there.
+			 */
+			if (pending > reqs[i]->recv_buf_len) {
+				return -ENOMEM;
+			}
+
+			memmove(reqs[i]->recv_buf, pending_data, pending);
+		}
+
+		ret = http_client_recv(sock, reqs[i], &pending_data, &pending);
+		if (ret < 0) {
+			return ret;
+		}
+
+		if (!reqs[i]->internal.response.message_complete) {
+			break;
+		}
+
+		if (!reqs[i]->internal.response.keep_alive) {
+			/* The server closes the connection, following
+			 * requests are not answered.
+			 */
+			i++;
+			break;
+		}
+	}
+
+	return i;
 }
@@ -0,0 +1,314 @@
+/** @file
+ * @brief HTTP client connection pool
+ *
+ * Keeps the connections to HTTP servers open between requests.
+ */
+
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_http, CONFIG_NET_HTTP_LOG_LEVEL);
+
+#include <kernel.h>
+#include <string.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include <net/socket.h>
+#include <net/http_client.h>
+
+#define HTTP_POOL_PORT_LEN sizeof("65535")
+#define HTTP_POOL_IDLE_TIMEOUT_MS (CONFIG_HTTP_CLIENT_POOL_IDLE_TIMEOUT * \
+				   MSEC_PER_SEC)
+
+struct http_pool_conn {
+	char host[CONFIG_HTTP_CLIENT_POOL_HOST_LEN];
+	char port[HTTP_POOL_PORT_LEN];
+	http_client_connect_cb_t connect_cb;
+	sec_tag_t sec_tags[CONFIG_HTTP_CLIENT_POOL_SEC_TAG_COUNT];
+	size_t sec_tag_count;
+	bool tls;
+	int64_t last_used;
+	int sock;
+	bool busy;
+};
+
+static struct http_pool_conn pool[CONFIG_HTTP_CLIENT_POOL_SIZE] = {
+	[0 ... (CONFIG_HTTP_CLIENT_POOL_SIZE - 1)] = { .sock = -1 },
+};
+
+static K_MUTEX_DEFINE(pool_lock);
+
+static void conn_close(struct http_pool_conn *conn)
+{
+	if (conn->sock >= 0) {
+		(void)close(conn->sock);
+	}
+
+	conn->sock = -1;
+	conn->busy = false;
+}
+
+static bool conn_matches(struct http_pool_conn *conn, const char *host,
+			 const char *port,
+			 const struct http_client_pool_transport *transport)
+{
+	return strcmp(conn->host, host) == 0 &&
+	       strcmp(conn->port, port ? port : "") == 0 &&
+	       conn->connect_cb == transport->connect_cb &&
+	       conn->tls == transport->tls &&
+	       conn->sec_tag_count == transport->sec_tag_count &&
+	       memcmp(conn->sec_tags, transport->sec_tags,
+		      transport->sec_tag_count * sizeof(sec_tag_t)) == 0;
+}
+
+/* Find an idle connection to the server, closing the expired ones on the
+ * way. If there is none, reserve a free slot for a new connection.
+ */
+static struct http_pool_conn *pool_get(const char *host, const char *port,
+			const struct http_client_pool_transport *transport,
+			bool *reused)
+{
+	struct http_pool_conn *free_conn = NULL;
+	struct http_pool_conn *lru = NULL;
+	int64_t now = k_uptime_get();
+	int i;
+
+	*reused = false;
+
+	if (strlen(host) >= CONFIG_HTTP_CLIENT_POOL_HOST_LEN ||
+	    (port && strlen(port) >= HTTP_POOL_PORT_LEN) ||
+	    transport->sec_tag_count > CONFIG_HTTP_CLIENT_POOL_SEC_TAG_COUNT) {
+		return NULL;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(pool); i++) {
+		struct http_pool_conn *conn = &pool[i];
+
+		if (conn->busy) {
+			continue;
+		}
+
+		if (conn->sock >= 0 &&
+		    now - conn->last_used > HTTP_POOL_IDLE_TIMEOUT_MS) {
+			NET_DBG("Closing idle connection to %s", conn->host);
+			conn_close(conn);
+		}
+
+		if (conn->sock < 0) {
+			if (free_conn == NULL) {
+				free_conn = conn;
+			}
+
+			continue;
+		}
+
+		if (conn_matches(conn, host, port, transport)) {
+			conn->busy = true;
+			*reused = true;
+			return conn;
+		}
+
+		if (lru == NULL || conn->last_used < lru->last_used) {
+			lru = conn;
+		}
+	}
+
+	if (free_conn == NULL && lru != NULL) {
+		NET_DBG("Evicting connection to %s", lru->host);
+		conn_close(lru);
+		free_conn = lru;
+	}
+
+	if (free_conn != NULL) {
+		strcpy(free_conn->host, host);
+		strcpy(free_conn->port, port ? port : "");
+		free_conn->connect_cb = transport->connect_cb;
+		free_conn->tls = transport->tls;
+		free_conn->sec_tag_count = transport->sec_tag_count;
+		memcpy(free_conn->sec_tags, transport->sec_tags,
+		       transport->sec_tag_count * sizeof(sec_tag_t));
+		free_conn->busy = true;
+	}
+
+	return free_conn;
+}
+
+static int pool_connect(struct http_pool_conn *conn, struct http_request *req,
+			const struct http_client_pool_transport *transport,
+			void *user_data)
+{
+	int sock;
+
+	sock = transport->connect_cb(req->host, req->port, user_data);
+	if (sock < 0) {
+		return sock;
+	}
+
+	if (conn != NULL) {
+		k_mutex_lock(&pool_lock, K_FOREVER);
+		conn->sock = sock;
+		k_mutex_unlock(&pool_lock);
+	}
+
+	return sock;
+}
+
+static void pool_put(struct http_pool_conn *conn, struct http_request *req)
+{
+	bool keep = req->internal.response.message_complete &&
+		    req->internal.response.keep_alive &&
+		    req->internal.sock >= 0;
+
+	if (conn == NULL) {
+		if (req->internal.sock >= 0) {
+			(void)close(req->internal.sock);
+		}
+
+		return;
+	}
+
+	k_mutex_lock(&pool_lock, K_FOREVER);
+
+	if (req->internal.sock < 0) {
+		/* Already closed on timeout */
+		conn->sock = -1;
+	}
+
+	if (keep) {
+		conn->last_used = k_uptime_get();
+		conn->busy = false;
+	} else {
+		conn_close(conn);
+	}
+
+	k_mutex_unlock(&pool_lock);
+}
+
+static bool method_is_idempotent(enum http_method method)
+{
+	switch (method) {
+	case HTTP_GET:
+	case HTTP_HEAD:
+	case HTTP_PUT:
+	case HTTP_DELETE:
+	case HTTP_OPTIONS:
+	case HTTP_TRACE:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* A request on a reused connection that the server closed meanwhile may only
+ * be sent again if the server cannot have seen it, or if sending it twice
+ * does no harm. A payload coming from a callback cannot be sent again.
+ */
+static bool pool_can_retry(struct http_request *req, int ret)
+{
+	if (ret < 0 && !req->internal.request_sent) {
+		return true;
+	}
+
+	return method_is_idempotent(req->method) &&
+	       req->payload_cb == NULL && req->payload_chunk_cb == NULL &&
+	       req->optional_headers_cb == NULL &&
+	       !req->internal.response_received;
+}
+
+int http_client_pool_req(struct http_request *req,
+			 const struct http_client_pool_transport *transport,
+			 int32_t timeout, void *user_data)
+{
+	struct http_pool_conn *conn;
+	bool reused;
+	int sock;
+	int ret;
+
+	if (req == NULL || req->host == NULL || transport == NULL ||
+	    transport->connect_cb == NULL ||
+	    (transport->sec_tag_count > 0 && transport->sec_tags == NULL) ||
+	    req->response == NULL || req->recv_buf == NULL ||
+	    req->recv_buf_len == 0) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&pool_lock, K_FOREVER);
+	conn = pool_get(req->host, req->port, transport, &reused);
+	sock = reused ? conn->sock : -1;
+	k_mutex_unlock(&pool_lock);
+
+	if (conn == NULL) {
+		NET_DBG("No pooled connection available for %s", req->host);
+	}
+
+	if (!reused) {
+		/* Connecting may take long, do not hold the lock meanwhile */
+		sock = pool_connect(conn, req, transport, user_data);
+		if (sock < 0) {
+			if (conn != NULL) {
+				k_mutex_lock(&pool_lock, K_FOREVER);
+				conn_close(conn);
+				k_mutex_unlock(&pool_lock);
+			}
+
+			return sock;
+		}
+	}
+
+	ret = http_client_req(sock, req, timeout, user_data);
+
+	if (reused && (ret < 0 ||
+		       (!req->internal.response.message_complete &&
+			req->internal.response.http_status_code == 0)) &&
+	    pool_can_retry(req, ret)) {
+		/* The server closed the connection while it was idle, try
+		 * once more on a new connection.
+		 */
+		NET_DBG("Pooled connection to %s lost, reconnecting",
+			req->host);
+
+		if (req->internal.sock >= 0) {
+			(void)close(req->internal.sock);
+		}
+
+		k_mutex_lock(&pool_lock, K_FOREVER);
+		conn->sock = -1;
+		k_mutex_unlock(&pool_lock);
+
+		sock = pool_connect(conn, req, transport, user_data);
+		if (sock < 0) {
+			k_mutex_lock(&pool_lock, K_FOREVER);
+			conn_close(conn);
+			k_mutex_unlock(&pool_lock);
+
+			return sock;
+		}
+
+		ret = http_client_req(sock, req, timeout, user_data);
+	}
+
+	pool_put(conn, req);
+
+	return ret;
+}
+
+void http_client_pool_close_idle(void)
+{
+	int i;
+
+	k_mutex_lock(&pool_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(pool); i++) {
+		if (!pool[i].busy) {
+			conn_close(&pool[i]);
+		}
+	}
+
+	k_mutex_unlock(&pool_lock);
+}
@@ -0,0 +1,73 @@
+/** @file
+ * @brief Functions shared by the HTTP client and server
+ */
+
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include <errno.h>
+
+#include <net/socket.h>
+
+#include "http_internal.h"
+
+void http_iov_advance(struct msghdr *msg, size_t len)
+{
+	/* Skip what was sent, a vector may have been partially sent */
+	while (msg->msg_iovlen > 0 && len >= msg->msg_iov->iov_len) {
+		len -= msg->msg_iov->iov_len;
+		msg->msg_iov++;
+		msg->msg_iovlen--;
+	}
+
+	if (len > 0) {
+		msg->msg_iov->iov_base = (uint8_t *)msg->msg_iov->iov_base + len;
+		msg->msg_iov->iov_len -= len;
+	}
+}
+
+int http_sendall_iov(int sock, struct iovec *iov, size_t iovcnt,
+		     int32_t timeout)
+{
+	struct pollfd fds = {
+		.fd = sock,
+		.events = POLLOUT,
+	};
+	struct msghdr msg;
+	ssize_t out_len;
+	int ret;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = iov;
+	msg.msg_iovlen = iovcnt;
+
+	while (msg.msg_iovlen > 0) {
+		out_len = sendmsg(sock, &msg, 0);
+		if (out_len < 0) {
+			if (errno != EAGAIN) {
+				return -errno;
+			}
+
+			ret = poll(&fds, 1, timeout);
+			if (ret < 0) {
+				return -errno;
+			}
+
+			if (ret == 0) {
+				return -ETIMEDOUT;
+			}
+
+			continue;
+		}
+
+		http_iov_advance(&msg, out_len);
+	}
+
+	return 0;
+}
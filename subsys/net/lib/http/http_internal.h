@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_SUBSYS_NET_LIB_HTTP_HTTP_INTERNAL_H_
+#define ZEPHYR_SUBSYS_NET_LIB_HTTP_HTTP_INTERNAL_H_
+
+#include <zephyr/types.h>
+#include <net/socket.h>
+
+/**
+ * @brief Skip the data sent from a message.
+ *
+ * @param msg Message whose I/O vector is updated to start after the data
+ *        sent.
+ * @param len Length of the data sent.
+ */
+void http_iov_advance(struct msghdr *msg, size_t len);
+
+/**
+ * @brief Send all the data of an I/O vector.
+ *
+ * When the socket is non-blocking and its send buffer is full, wait for
+ * it to become writable again.
+ *
+ * @param sock Socket to send the data on.
+ * @param iov I/O vector of the data, updated as the data is sent.
+ * @param iovcnt Number of entries in the I/O vector.
+ * @param timeout How long to wait each time the socket is not writable,
+ *        in milliseconds. Value SYS_FOREVER_MS means to wait forever.
+ *
+ * @return 0 if all the data was sent, -ETIMEDOUT if the socket did not
+ * become writable in time, <0 errno otherwise.
+ */
+int http_sendall_iov(int sock, struct iovec *iov, size_t iovcnt,
+		     int32_t timeout);
+
+#endif /* ZEPHYR_SUBSYS_NET_LIB_HTTP_HTTP_INTERNAL_H_ */
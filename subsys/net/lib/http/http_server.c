@@ -0,0 +1,1068 @@
+/** @file
+ * @brief HTTP server
+ *
+ * Event driven HTTP/1.1 server serving static, dynamic and Websocket
+ * resources.
+ */
+
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_http_server, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
+
+#include <kernel.h>
+#include <fcntl.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <stdbool.h>
+
+#include <net/net_ip.h>
+#include <net/socket.h>
+#include <net/http_server.h>
+
+#include "http_internal.h"
+
+#if defined(CONFIG_HTTP_SERVER_WEBSOCKET)
+#include <sys/base64.h>
+#include <mbedtls/sha1.h>
+#endif
+
+#if IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE)
+/* Lowest priority cooperative thread */
+#define THREAD_PRIORITY K_PRIO_COOP(CONFIG_NUM_COOP_PRIORITIES - 1)
+#else
+#define THREAD_PRIORITY K_PRIO_PREEMPT(CONFIG_NUM_PREEMPT_PRIORITIES - 1)
+#endif
+
+#define NUM_THREADS CONFIG_HTTP_SERVER_NUM_THREADS
+#define MAX_CLIENTS CONFIG_HTTP_SERVER_MAX_CLIENTS
+
+/* Clients are spread over the threads, thread n serves every n-th one */
+#define CLIENTS_PER_THREAD ((MAX_CLIENTS + NUM_THREADS - 1) / NUM_THREADS)
+
+#define MAX_LISTEN_SOCKS 2
+#define POLL_PERIOD_MS MSEC_PER_SEC
+/* Sockets report TCP connections as always writable, a client whose
+ * send buffer is full is retried after this period instead.
+ */
+#define SEND_RETRY_MS 10
+#define INACTIVITY_TIMEOUT_MS (CONFIG_HTTP_SERVER_CLIENT_INACTIVITY_TIMEOUT * \
+			       MSEC_PER_SEC)
+
+#define RESPONSE_HEADER_LEN 192
+#define HEADER_NAME_LEN sizeof("Sec-WebSocket-Key")
+#define ACCEPT_ENCODING_LEN 48
+#define UPGRADE_LEN sizeof("websocket")
+
+/* Length of a base64 encoded 16 byte Sec-WebSocket-Key */
+#define WS_KEY_LEN 24
+/* Length of a base64 encoded SHA-1 Sec-WebSocket-Accept */
+#define WS_ACCEPT_LEN 28
+#define WS_SHA1_OUTPUT_LEN 20
+/* From RFC 6455 chapter 4.2.2 */
+#define WS_MAGIC "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+BUILD_ASSERT(MAX_CLIENTS >= NUM_THREADS,
+	     "Each HTTP server thread needs at least one client slot");
+
+enum http_server_header {
+	HEADER_NONE,
+	HEADER_ACCEPT_ENCODING,
+	HEADER_UPGRADE,
+	HEADER_WS_KEY,
+};
+
+struct http_server_client {
+	/** Connection to the client, -1 if the slot is free */
+	int sock;
+
+	/** Uptime of the last data received or sent, for the inactivity
+	 * timeout
+	 */
+	int64_t last_activity;
+
+	struct http_parser parser;
+
+	/** Request being parsed */
+	struct http_server_request req;
+
+	/** Resource requested, NULL if unknown */
+	const struct http_resource *resource;
+
+	/** Status to respond with instead of serving the resource */
+	uint16_t error;
+
+	/** Header whose value is being parsed */
+	enum http_server_header header;
+	size_t header_len;
+
+	char url[CONFIG_HTTP_SERVER_MAX_URL_LEN];
+	size_t url_len;
+
+	char header_name[HEADER_NAME_LEN];
+	char accept_encoding[ACCEPT_ENCODING_LEN];
+	char upgrade[UPGRADE_LEN];
+	char ws_key[WS_KEY_LEN + 1];
+
+	uint8_t in_header_value : 1;
+	uint8_t responded : 1;
+	uint8_t keep_alive : 1;
+	uint8_t handed_over : 1;
+	uint8_t upgrade_pending : 1;
+	uint8_t upgrading : 1;
+	uint8_t tx_blocked : 1;
+
+	/** Response being sent, the body is not copied. Nothing is left to
+	 * send when msg_iovlen is 0.
+	 */
+	struct msghdr tx_msg;
+	struct iovec tx_iov[2];
+	char tx_header[RESPONSE_HEADER_LEN];
+
+	/** Length of the data received and not parsed yet */
+	size_t rx_len;
+
+	uint8_t buf[CONFIG_HTTP_SERVER_CLIENT_BUFFER_SIZE];
+};
+
+static struct http_server_client clients[MAX_CLIENTS];
+static const struct http_server_config *server_config;
+static int listen_socks[MAX_LISTEN_SOCKS];
+static int listen_socks_count;
+static atomic_t running;
+
+static struct k_thread server_threads[NUM_THREADS];
+static K_KERNEL_STACK_ARRAY_DEFINE(server_stacks, NUM_THREADS,
+				   CONFIG_HTTP_SERVER_STACK_SIZE);
+
+static const char *status_reason(uint16_t status)
+{
+	switch (status) {
+	case 101:
+		return "Switching Protocols";
+	case 200:
+		return "OK";
+	case 201:
+		return "Created";
+	case 204:
+		return "No Content";
+	case 400:
+		return "Bad Request";
+	case 404:
+		return "Not Found";
+	case 405:
+		return "Method Not Allowed";
+	case 406:
+		return "Not Acceptable";
+	case 414:
+		return "URI Too Long";
+	case 500:
+		return "Internal Server Error";
+	case 501:
+		return "Not Implemented";
+	case 503:
+		return "Service Unavailable";
+	default:
+		break;
+	}
+
+	return "";
+}
+
+static const char *connection_header(struct http_server_client *client)
+{
+	if (!client->keep_alive) {
+		return "Connection: close" HTTP_CRLF;
+	}
+
+	/* Persistent connections are only the default from HTTP/1.1 on */
+	if (client->parser.http_major == 1 && client->parser.http_minor == 0) {
+		return "Connection: keep-alive" HTTP_CRLF;
+	}
+
+	return "";
+}
+
+/* Sends as much of the pending response as the socket takes */
+static int client_send(struct http_server_client *client)
+{
+	ssize_t out_len;
+
+	client->tx_blocked = 0;
+
+	while (client->tx_msg.msg_iovlen > 0) {
+		out_len = sendmsg(client->sock, &client->tx_msg, 0);
+		if (out_len < 0) {
+			/* The rest is sent from the poll loop */
+			if (errno == EAGAIN || errno == ENOBUFS ||
+			    errno == ENOMEM) {
+				client->tx_blocked = 1;
+				return 0;
+			}
+
+			return -errno;
+		}
+
+		/* A client reading its response is not inactive */
+		client->last_activity = k_uptime_get();
+
+		http_iov_advance(&client->tx_msg, out_len);
+	}
+
+	return 0;
+}
+
+static int response_send(struct http_server_client *client,
+			 size_t header_len, const uint8_t *body, size_t len)
+{
+	int ret;
+
+	client->tx_iov[0].iov_base = client->tx_header;
+	client->tx_iov[0].iov_len = header_len;
+	client->tx_iov[1].iov_base = (void *)body;
+	client->tx_iov[1].iov_len = len;
+
+	memset(&client->tx_msg, 0, sizeof(client->tx_msg));
+	client->tx_msg.msg_iov = client->tx_iov;
+	client->tx_msg.msg_iovlen = len > 0 ? 2 : 1;
+
+	ret = client_send(client);
+	if (ret < 0) {
+		NET_DBG("[%p] Cannot send response (%d)", client, ret);
+		client->tx_msg.msg_iovlen = 0;
+		client->keep_alive = 0;
+	}
+
+	return ret;
+}
+
+static int send_response(struct http_server_client *client, uint16_t status,
+			 const char *content_type,
+			 const char *content_encoding,
+			 const uint8_t *body, size_t len, bool send_body)
+{
+	char content_len[sizeof("Content-Length: 4294967295" HTTP_CRLF)];
+	int header_len;
+
+	client->responded = 1;
+
+	content_len[0] = '\0';
+	if (status >= 200 && status != 204) {
+		snprintk(content_len, sizeof(content_len),
+			 "Content-Length: %zu" HTTP_CRLF, len);
+	} else {
+		send_body = false;
+	}
+
+	header_len = snprintk(client->tx_header, sizeof(client->tx_header),
+			      "HTTP/1.1 %u %s" HTTP_CRLF "%s%s%s%s%s%s%s%s"
+			      HTTP_CRLF,
+			      status, status_reason(status), content_len,
+			      content_type ? "Content-Type: " : "",
+			      content_type ? content_type : "",
+			      content_type ? HTTP_CRLF : "",
+			      content_encoding ? "Content-Encoding: " : "",
+			      content_encoding ? content_encoding : "",
+			      content_encoding ? HTTP_CRLF : "",
+			      connection_header(client));
+	if (header_len < 0 || header_len >= sizeof(client->tx_header)) {
+		client->keep_alive = 0;
+		return -ENOMEM;
+	}
+
+	return response_send(client, header_len, body, send_body ? len : 0);
+}
+
+static int send_error(struct http_server_client *client, uint16_t status)
+{
+	return send_response(client, status, NULL, NULL, NULL, 0, false);
+}
+
+static bool encoding_accepted(const char *accept, const char *encoding)
+{
+	size_t len = strlen(encoding);
+	const char *token = accept;
+
+	while (*token) {
+		token += strspn(token, " ,");
+
+		if ((strncasecmp(token, encoding, len) == 0 ||
+		     *token == '*') &&
+		    strchr(" ,;", token[*token == '*' ? 1 : len]) != NULL) {
+			return true;
+		}
+
+		token += strcspn(token, ",");
+	}
+
+	return false;
+}
+
+static const struct http_resource *resource_find(const char *path)
+{
+	size_t i;
+
+	for (i = 0; i < server_config->num_resources; i++) {
+		if (strcmp(server_config->resources[i].path, path) == 0) {
+			return &server_config->resources[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void serve_static(struct http_server_client *client)
+{
+	const struct http_resource *resource = client->resource;
+
+	/* The content is sent straight from where it is stored */
+	(void)send_response(client, 200, resource->static_data.content_type,
+			    resource->static_data.content_encoding,
+			    resource->static_data.data,
+			    resource->static_data.len,
+			    client->req.method != HTTP_HEAD);
+}
+
+static void serve_dynamic(struct http_server_client *client)
+{
+	int ret;
+
+	ret = client->resource->dynamic_cb(client, &client->req,
+					   HTTP_SERVER_DATA_FINAL, NULL, 0,
+					   client->resource->user_data);
+	if (ret < 0) {
+		NET_DBG("[%p] Resource %s failed (%d)", client,
+			client->req.path, ret);
+	}
+
+	if (!client->responded) {
+		(void)send_error(client, 500);
+	}
+}
+
+#if defined(CONFIG_HTTP_SERVER_WEBSOCKET)
+static void serve_websocket(struct http_server_client *client)
+{
+	char key_accept[WS_KEY_LEN + sizeof(WS_MAGIC)];
+	uint8_t sha1[WS_SHA1_OUTPUT_LEN];
+	char accept[WS_ACCEPT_LEN + 1];
+	int header_len;
+	size_t olen;
+	int ret;
+
+	if (client->req.method != HTTP_GET || !client->parser.upgrade ||
+	    strcasecmp(client->upgrade, "websocket") != 0 ||
+	    strlen(client->ws_key) != WS_KEY_LEN) {
+		client->keep_alive = 0;
+		(void)send_error(client, 400);
+		return;
+	}
+
+	memcpy(key_accept, client->ws_key, WS_KEY_LEN);
+	memcpy(key_accept + WS_KEY_LEN, WS_MAGIC, sizeof(WS_MAGIC) - 1);
+
+	mbedtls_sha1_ret((const unsigned char *)key_accept,
+			 WS_KEY_LEN + sizeof(WS_MAGIC) - 1, sha1);
+
+	ret = base64_encode((uint8_t *)accept, sizeof(accept), &olen, sha1,
+			    sizeof(sha1));
+	if (ret) {
+		client->keep_alive = 0;
+		(void)send_error(client, 500);
+		return;
+	}
+
+	header_len = snprintk(client->tx_header, sizeof(client->tx_header),
+			      "HTTP/1.1 101 %s" HTTP_CRLF
+			      "Upgrade: websocket" HTTP_CRLF
+			      "Connection: Upgrade" HTTP_CRLF
+			      "Sec-WebSocket-Accept: %s" HTTP_CRLF HTTP_CRLF,
+			      status_reason(101), accept);
+
+	client->responded = 1;
+
+	/* Handed over once the response is sent */
+	if (response_send(client, header_len, NULL, 0) == 0) {
+		client->upgrading = 1;
+	}
+}
+
+static void websocket_handover(struct http_server_client *client)
+{
+	int flags;
+	int ret;
+
+	/* The connection now belongs to the application, in blocking mode
+	 * as the Websocket library expects.
+	 */
+	client->handed_over = 1;
+
+	flags = fcntl(client->sock, F_GETFL, 0);
+	fcntl(client->sock, F_SETFL, flags & ~O_NONBLOCK);
+
+	/* The client may have sent Websocket data right after the request */
+	ret = client->resource->websocket_cb(client->sock, &client->req,
+					     client->buf, client->rx_len,
+					     client->resource->user_data);
+	if (ret < 0) {
+		NET_DBG("[%p] Websocket refused (%d)", client, ret);
+		(void)close(client->sock);
+	}
+}
+#else
+static void serve_websocket(struct http_server_client *client)
+{
+	client->keep_alive = 0;
+	(void)send_error(client, 501);
+}
+
+static void websocket_handover(struct http_server_client *client)
+{
+	ARG_UNUSED(client);
+}
+#endif /* CONFIG_HTTP_SERVER_WEBSOCKET */
+
+static char *header_buffer(struct http_server_client *client, size_t *size)
+{
+	switch (client->header) {
+	case HEADER_ACCEPT_ENCODING:
+		*size = sizeof(client->accept_encoding);
+		return client->accept_encoding;
+	case HEADER_UPGRADE:
+		*size = sizeof(client->upgrade);
+		return client->upgrade;
+	case HEADER_WS_KEY:
+		*size = sizeof(client->ws_key);
+		return client->ws_key;
+	default:
+		break;
+	}
+
+	return NULL;
+}
+
+static enum http_server_header header_lookup(const char *name)
+{
+	if (strcasecmp(name, "Accept-Encoding") == 0) {
+		return HEADER_ACCEPT_ENCODING;
+	}
+
+	if (strcasecmp(name, "Upgrade") == 0) {
+		return HEADER_UPGRADE;
+	}
+
+	if (strcasecmp(name, "Sec-WebSocket-Key") == 0) {
+		return HEADER_WS_KEY;
+	}
+
+	return HEADER_NONE;
+}
+
+static int on_message_begin(struct http_parser *parser)
+{
+	struct http_server_client *client =
+		CONTAINER_OF(parser, struct http_server_client, parser);
+
+	memset(&client->req, 0, sizeof(client->req));
+	client->resource = NULL;
+	client->error = 0;
+	client->header = HEADER_NONE;
+	client->header_len = 0;
+	client->url_len = 0;
+	client->url[0] = '\0';
+	client->accept_encoding[0] = '\0';
+	client->upgrade[0] = '\0';
+	client->ws_key[0] = '\0';
+	client->in_header_value = 0;
+	client->responded = 0;
+
+	return 0;
+}
+
+static int on_url(struct http_parser *parser, const char *at, size_t length)
+{
+	struct http_server_client *client =
+		CONTAINER_OF(parser, struct http_server_client, parser);
+
+	if (client->url_len + length >= sizeof(client->url)) {
+		client->error = 414;
+		return 0;
+	}
+
+	memcpy(client->url + client->url_len, at, length);
+	client->url_len += length;
+	client->url[client->url_len] = '\0';
+
+	return 0;
+}
+
+static int on_header_field(struct http_parser *parser, const char *at,
+			   size_t length)
+{
+	struct http_server_client *client =
+		CONTAINER_OF(parser, struct http_server_client, parser);
+
+	if (client->in_header_value) {
+		/* Start of the next header */
+		client->in_header_value = 0;
+		client->header_len = 0;
+	}
+
+	/* A name that does not fit is not one of the headers used */
+	if (client->header_len + length >= sizeof(client->header_name)) {
+		client->header_len = sizeof(client->header_name);
+		return 0;
+	}
+
+	memcpy(client->header_name + client->header_len, at, length);
+	client->header_len += length;
+
+	return 0;
+}
+
+static int on_header_value(struct http_parser *parser, const char *at,
+			   size_t length)
+{
+	struct http_server_client *client =
+		CONTAINER_OF(parser, struct http_server_client, parser);
+	size_t size;
+	char *value;
+
+	if (!client->in_header_value) {
+		client->in_header_value = 1;
+
+		if (client->header_len < sizeof(client->header_name)) {
+			client->header_name[client->header_len] = '\0';
+			client->header = header_lookup(client->header_name);
+		} else {
+			client->header = HEADER_NONE;
+		}
+
+		client->header_len = 0;
+	}
+
+	value = header_buffer(client, &size);
+	if (value == NULL) {
+		return 0;
+	}
+
+	/* Values that do not fit are truncated, which makes them invalid
+	 * for the headers used.
+	 */
+	length = MIN(length, size - 1 - client->header_len);
+	memcpy(value + client->header_len, at, length);
+	client->header_len += length;
+	value[client->header_len] = '\0';
+
+	return 0;
+}
+
+static int on_headers_complete(struct http_parser *parser)
+{
+	struct http_server_client *client =
+		CONTAINER_OF(parser, struct http_server_client, parser);
+	const struct http_resource *resource;
+	char *query;
+
+	client->header = HEADER_NONE;
+	client->req.method = parser->method;
+	client->req.path = client->url;
+
+	query = strchr(client->url, '?');
+	if (query) {
+		*query = '\0';
+		client->req.query = query + 1;
+	}
+
+	if (client->error) {
+		return 0;
+	}
+
+	resource = resource_find(client->req.path);
+	if (resource == NULL) {
+		client->error = 404;
+		return 0;
+	}
+
+	if (resource->type == HTTP_RESOURCE_TYPE_STATIC) {
+		if (parser->method != HTTP_GET && parser->method != HTTP_HEAD) {
+			client->error = 405;
+			return 0;
+		}
+
+		if (resource->static_data.content_encoding &&
+		    !encoding_accepted(client->accept_encoding,
+				       resource->static_data.content_encoding)) {
+			client->error = 406;
+			return 0;
+		}
+	}
+
+	client->resource = resource;
+
+	return 0;
+}
+
+static int on_body(struct http_parser *parser, const char *at, size_t length)
+{
+	struct http_server_client *client =
+		CONTAINER_OF(parser, struct http_server_client, parser);
+	int ret;
+
+	if (client->error || client->resource == NULL ||
+	    client->resource->type != HTTP_RESOURCE_TYPE_DYNAMIC) {
+		return 0;
+	}
+
+	ret = client->resource->dynamic_cb(client, &client->req,
+					   HTTP_SERVER_DATA_MORE,
+					   (const uint8_t *)at, length,
+					   client->resource->user_data);
+	if (ret < 0) {
+		NET_DBG("[%p] Resource %s failed (%d)", client,
+			client->req.path, ret);
+		client->error = 500;
+	}
+
+	return 0;
+}
+
+static int on_message_complete(struct http_parser *parser)
+{
+	struct http_server_client *client =
+		CONTAINER_OF(parser, struct http_server_client, parser);
+
+	client->keep_alive = http_should_keep_alive(parser);
+
+	if (client->error) {
+		(void)send_error(client, client->error);
+	} else {
+		switch (client->resource->type) {
+		case HTTP_RESOURCE_TYPE_STATIC:
+			serve_static(client);
+			break;
+		case HTTP_RESOURCE_TYPE_DYNAMIC:
+			serve_dynamic(client);
+			break;
+		case HTTP_RESOURCE_TYPE_WEBSOCKET:
+			/* Served once the data following the request is
+			 * known.
+			 */
+			client->upgrade_pending = 1;
+			break;
+		}
+	}
+
+	if (!client->keep_alive || client->upgrade_pending ||
+	    client->tx_msg.msg_iovlen > 0) {
+		/* Do not parse any request following this one, at least
+		 * until the response is sent.
+		 */
+		http_parser_pause(parser, 1);
+	}
+
+	return 0;
+}
+
+static const struct http_parser_settings parser_settings = {
+	.on_message_begin = on_message_begin,
+	.on_url = on_url,
+	.on_header_field = on_header_field,
+	.on_header_value = on_header_value,
+	.on_headers_complete = on_headers_complete,
+	.on_body = on_body,
+	.on_message_complete = on_message_complete,
+};
+
+static void client_close(struct http_server_client *client)
+{
+	NET_DBG("[%p] Closing connection", client);
+
+	if (!client->handed_over) {
+		(void)close(client->sock);
+	}
+
+	client->sock = -1;
+}
+
+static void client_parse(struct http_server_client *client)
+{
+	enum http_errno err;
+	size_t parsed;
+
+	parsed = http_parser_execute(&client->parser, &parser_settings,
+				     (const char *)client->buf, client->rx_len);
+
+	err = HTTP_PARSER_ERRNO(&client->parser);
+	if (err == HPE_PAUSED) {
+		/* Kept for when the response is sent. What follows an
+		 * upgrade request is not HTTP anymore.
+		 */
+		client->rx_len -= parsed;
+		memmove(client->buf, client->buf + parsed, client->rx_len);
+	} else {
+		client->rx_len = 0;
+	}
+
+	if (client->upgrade_pending) {
+		client->upgrade_pending = 0;
+		serve_websocket(client);
+	} else if (err != HPE_OK && err != HPE_PAUSED) {
+		NET_DBG("[%p] Invalid request (%s)", client,
+			http_errno_name(err));
+		client->keep_alive = 0;
+		(void)send_error(client, 400);
+	}
+}
+
+/* Carries on with a client once its response is sent */
+static void client_process(struct http_server_client *client)
+{
+	while (client->tx_msg.msg_iovlen == 0) {
+		if (client->upgrading) {
+			websocket_handover(client);
+			client_close(client);
+			return;
+		}
+
+		if (!client->keep_alive) {
+			client_close(client);
+			return;
+		}
+
+		if (client->rx_len == 0) {
+			return;
+		}
+
+		/* Requests received while the response was sent */
+		http_parser_pause(&client->parser, 0);
+		client_parse(client);
+	}
+}
+
+static void client_resume(struct http_server_client *client)
+{
+	int ret;
+
+	ret = client_send(client);
+	if (ret < 0) {
+		NET_DBG("[%p] Cannot send response (%d)", client, ret);
+		client_close(client);
+		return;
+	}
+
+	client_process(client);
+}
+
+static void client_recv(struct http_server_client *client)
+{
+	int len;
+
+	len = recv(client->sock, client->buf, sizeof(client->buf), 0);
+	if (len <= 0) {
+		if (len < 0 && errno == EAGAIN) {
+			return;
+		}
+
+		if (len < 0) {
+			NET_DBG("[%p] Connection error (%d)", client, errno);
+		}
+
+		client_close(client);
+		return;
+	}
+
+	client->last_activity = k_uptime_get();
+	client->rx_len = len;
+
+	client_parse(client);
+	client_process(client);
+}
+
+static void client_accept(int listen_sock, int thread_id)
+{
+	struct http_server_client *client = NULL;
+	int sock, flags;
+	int i;
+
+	sock = accept(listen_sock, NULL, NULL);
+	if (sock < 0) {
+		/* Another thread may have accepted the connection */
+		if (errno != EAGAIN) {
+			NET_DBG("Cannot accept connection (%d)", errno);
+		}
+
+		return;
+	}
+
+	for (i = thread_id; i < MAX_CLIENTS; i += NUM_THREADS) {
+		if (clients[i].sock < 0) {
+			client = &clients[i];
+			break;
+		}
+	}
+
+	if (client == NULL) {
+		(void)close(sock);
+		return;
+	}
+
+	NET_DBG("[%p] New connection (sock %d)", client, sock);
+
+	/* A thread serves many clients, it must not block on any of them.
+	 * What a client does not read yet is sent from the poll loop.
+	 */
+	flags = fcntl(sock, F_GETFL, 0);
+	fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+
+	client->sock = sock;
+	client->handed_over = 0;
+	client->upgrade_pending = 0;
+	client->upgrading = 0;
+	client->keep_alive = 1;
+	client->tx_msg.msg_iovlen = 0;
+	client->rx_len = 0;
+	client->last_activity = k_uptime_get();
+	http_parser_init(&client->parser, HTTP_REQUEST);
+}
+
+static void clients_close_idle(int thread_id)
+{
+	int64_t now = k_uptime_get();
+	int i;
+
+	for (i = thread_id; i < MAX_CLIENTS; i += NUM_THREADS) {
+		if (clients[i].sock >= 0 &&
+		    now - clients[i].last_activity > INACTIVITY_TIMEOUT_MS) {
+			NET_DBG("[%p] Inactive", &clients[i]);
+			client_close(&clients[i]);
+		}
+	}
+}
+
+static void http_server_thread(void *p1, void *p2, void *p3)
+{
+	struct pollfd fds[CLIENTS_PER_THREAD + MAX_LISTEN_SOCKS];
+	struct http_server_client *polled[CLIENTS_PER_THREAD];
+	int thread_id = POINTER_TO_INT(p1);
+	int nclients, nfds;
+	int32_t timeout;
+	bool slot_free;
+	int i, ret;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (atomic_get(&running)) {
+		nclients = 0;
+		slot_free = false;
+		timeout = POLL_PERIOD_MS;
+
+		for (i = thread_id; i < MAX_CLIENTS; i += NUM_THREADS) {
+			if (clients[i].sock < 0) {
+				slot_free = true;
+				continue;
+			}
+
+			/* Nothing is received while a response is sent */
+			fds[nclients].fd = clients[i].sock;
+			if (clients[i].tx_msg.msg_iovlen == 0) {
+				fds[nclients].events = POLLIN;
+			} else if (!clients[i].tx_blocked) {
+				fds[nclients].events = POLLOUT;
+			} else {
+				fds[nclients].events = 0;
+				timeout = SEND_RETRY_MS;
+			}
+
+			polled[nclients] = &clients[i];
+			nclients++;
+		}
+
+		nfds = nclients;
+
+		/* Only accept connections that this thread can serve */
+		for (i = 0; slot_free && i < listen_socks_count; i++) {
+			fds[nfds].fd = listen_socks[i];
+			fds[nfds].events = POLLIN;
+			nfds++;
+		}
+
+		ret = poll(fds, nfds, timeout);
+		if (ret < 0) {
+			NET_ERR("Error in poll (%d)", errno);
+			k_sleep(K_MSEC(POLL_PERIOD_MS));
+			continue;
+		}
+
+		for (i = 0; i < nclients; i++) {
+			if (fds[i].revents & POLLIN) {
+				client_recv(polled[i]);
+			} else if (fds[i].revents &
+				   (POLLERR | POLLHUP | POLLNVAL)) {
+				client_close(polled[i]);
+			} else if ((fds[i].revents & POLLOUT) ||
+				   polled[i]->tx_blocked) {
+				client_resume(polled[i]);
+			}
+		}
+
+		for (i = nclients; ret > 0 && i < nfds; i++) {
+			if (fds[i].revents & POLLIN) {
+				client_accept(fds[i].fd, thread_id);
+			}
+		}
+
+		clients_close_idle(thread_id);
+	}
+}
+
+static int listen_socket(sa_family_t family, uint16_t port)
+{
+	struct sockaddr_storage addr;
+	socklen_t addr_len;
+	int sock, flags, ret;
+
+	memset(&addr, 0, sizeof(addr));
+
+	if (family == AF_INET6) {
+		net_sin6((struct sockaddr *)&addr)->sin6_family = AF_INET6;
+		net_sin6((struct sockaddr *)&addr)->sin6_port = htons(port);
+		addr_len = sizeof(struct sockaddr_in6);
+	} else {
+		net_sin((struct sockaddr *)&addr)->sin_family = AF_INET;
+		net_sin((struct sockaddr *)&addr)->sin_port = htons(port);
+		addr_len = sizeof(struct sockaddr_in);
+	}
+
+	sock = socket(family, SOCK_STREAM, IPPROTO_TCP);
+	if (sock < 0) {
+		return -errno;
+	}
+
+	if (bind(sock, (struct sockaddr *)&addr, addr_len) < 0 ||
+	    listen(sock, MAX_CLIENTS) < 0) {
+		ret = -errno;
+		(void)close(sock);
+		return ret;
+	}
+
+	/* The threads share the listening sockets, only one of them gets
+	 * each new connection.
+	 */
+	flags = fcntl(sock, F_GETFL, 0);
+	fcntl(sock, F_SETFL, flags | O_NONBLOCK);
+
+	return sock;
+}
+
+int http_server_start(const struct http_server_config *config)
+{
+	int i, ret;
+
+	if (config == NULL ||
+	    (config->resources == NULL && config->num_resources > 0)) {
+		return -EINVAL;
+	}
+
+	if (atomic_get(&running)) {
+		return -EALREADY;
+	}
+
+	listen_socks_count = 0;
+
+	if (IS_ENABLED(CONFIG_NET_IPV6)) {
+		ret = listen_socket(AF_INET6, config->port);
+		if (ret < 0) {
+			goto fail;
+		}
+
+		listen_socks[listen_socks_count++] = ret;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4)) {
+		ret = listen_socket(AF_INET, config->port);
+		if (ret < 0) {
+			goto fail;
+		}
+
+		listen_socks[listen_socks_count++] = ret;
+	}
+
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		clients[i].sock = -1;
+	}
+
+	server_config = config;
+	atomic_set(&running, 1);
+
+	for (i = 0; i < NUM_THREADS; i++) {
+		k_thread_create(&server_threads[i], server_stacks[i],
+				K_KERNEL_STACK_SIZEOF(server_stacks[i]),
+				(k_thread_entry_t)http_server_thread,
+				INT_TO_POINTER(i), NULL, NULL,
+				THREAD_PRIORITY, 0, K_NO_WAIT);
+		k_thread_name_set(&server_threads[i], "http_server");
+	}
+
+	NET_DBG("HTTP server listening on port %u", config->port);
+
+	return 0;
+
+fail:
+	NET_ERR("Cannot listen on port %u (%d)", config->port, ret);
+
+	while (listen_socks_count > 0) {
+		(void)close(listen_socks[--listen_socks_count]);
+	}
+
+	return ret;
+}
+
+int http_server_stop(void)
+{
+	int i;
+
+	if (!atomic_cas(&running, 1, 0)) {
+		return -EALREADY;
+	}
+
+	/* The threads notice within a poll period */
+	for (i = 0; i < NUM_THREADS; i++) {
+		(void)k_thread_join(&server_threads[i], K_FOREVER);
+	}
+
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		if (clients[i].sock >= 0) {
+			client_close(&clients[i]);
+		}
+	}
+
+	while (listen_socks_count > 0) {
+		(void)close(listen_socks[--listen_socks_count]);
+	}
+
+	return 0;
+}
+
+int http_server_respond(struct http_server_client *client, uint16_t status,
+			const char *content_type, const uint8_t *body,
+			size_t len)
+{
+	if (client == NULL || (body == NULL && len > 0)) {
+		return -EINVAL;
+	}
+
+	if (client->responded) {
+		return -EALREADY;
+	}
+
+	return send_response(client, status, content_type, NULL, body, len,
+			     client->req.method != HTTP_HEAD);
+}
@@ -46,6 +46,12 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #ifdef CONFIG_LWM2M_RW_JSON_SUPPORT
 #include "lwm2m_rw_json.h"
 #endif
+#ifdef CONFIG_LWM2M_RW_SENML_JSON_SUPPORT
+#include "lwm2m_rw_senml_json.h"
+#endif
+#ifdef CONFIG_LWM2M_RW_SENML_CBOR_SUPPORT
+#include "lwm2m_rw_senml_cbor.h"
+#endif
 #ifdef CONFIG_LWM2M_RD_CLIENT_SUPPORT
 #include "lwm2m_rd_client.h"
 #endif
@@ -70,6 +76,17 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
 #define LWM2M_MAX_PATH_STR_LEN sizeof("65535/65535/65535/65535")
 
+#if defined(CONFIG_LWM2M_VERSION_1_1)
+struct composite_path_list {
+	struct lwm2m_obj_path paths[CONFIG_LWM2M_COMPOSITE_PATH_LIST_SIZE];
+	/* 0 if the list is free */
+	uint8_t count;
+};
+
+static struct composite_path_list
+	composite_path_lists[CONFIG_LWM2M_COMPOSITE_OBSERVER_MAX];
+#endif
+
 struct observe_node {
 	sys_snode_t node;
 	struct lwm2m_obj_path path;
@@ -81,6 +98,10 @@ struct observe_node {
 	uint32_t counter;
 	uint16_t format;
 	uint8_t  tkl;
+#if defined(CONFIG_LWM2M_VERSION_1_1)
+	/* paths of a composite observation, path.level is 0 for these */
+	struct composite_path_list *composite;
+#endif
 };
 
 struct notification_attrs {
@@ -110,6 +131,15 @@ static sys_slist_t engine_obj_list;
 static sys_slist_t engine_obj_inst_list;
 static sys_slist_t engine_service_list;
 
+/* Objects and object instances hashed by their IDs */
+static sys_slist_t engine_obj_hash[CONFIG_LWM2M_ENGINE_LOOKUP_HASH_SIZE];
+static sys_slist_t engine_obj_inst_hash[CONFIG_LWM2M_ENGINE_LOOKUP_HASH_SIZE];
+
+/* Incremented whenever object or resource instances are created or deleted,
+ * resource handles resolved before that are looked up again.
+ */
+static uint32_t engine_generation = 1U;
+
 static K_KERNEL_STACK_DEFINE(engine_thread_stack,
 			      CONFIG_LWM2M_ENGINE_STACK_SIZE);
 static struct k_thread engine_thread_data;
@@ -342,6 +372,44 @@ static void clear_attrs(void *ref)
 	}
 }
 
+static void observe_node_free(struct observe_node *obs)
+{
+#if defined(CONFIG_LWM2M_VERSION_1_1)
+	if (obs->composite) {
+		obs->composite->count = 0U;
+	}
+#endif
+
+	(void)memset(obs, 0, sizeof(*obs));
+}
+
+static bool observe_node_match(struct observe_node *obs, uint16_t obj_id,
+			       uint16_t obj_inst_id, uint16_t res_id)
+{
+#if defined(CONFIG_LWM2M_VERSION_1_1)
+	struct lwm2m_obj_path *path;
+	int i;
+
+	if (obs->path.level == 0U) {
+		for (i = 0; i < obs->composite->count; i++) {
+			path = &obs->composite->paths[i];
+			if (path->obj_id == obj_id &&
+			    (path->level < 2U ||
+			     path->obj_inst_id == obj_inst_id) &&
+			    (path->level < 3U || path->res_id == res_id)) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+#endif
+
+	return obs->path.obj_id == obj_id &&
+	       obs->path.obj_inst_id == obj_inst_id &&
+	       (obs->path.level < 3 || obs->path.res_id == res_id);
+}
+
 int lwm2m_notify_observer(uint16_t obj_id, uint16_t obj_inst_id, uint16_t res_id)
 {
 	struct observe_node *obs;
@@ -351,10 +419,8 @@ int lwm2m_notify_observer(uint16_t obj_id, uint16_t obj_inst_id, uint16_t res_id
 	/* look for observers which match our resource */
 	for (i = 0; i < sock_nfds; ++i) {
 		SYS_SLIST_FOR_EACH_CONTAINER(&sock_ctx[i]->observer, obs, node) {
-			if (obs->path.obj_id == obj_id &&
-			    obs->path.obj_inst_id == obj_inst_id &&
-			    (obs->path.level < 3 ||
-			     obs->path.res_id == res_id)) {
+			if (observe_node_match(obs, obj_id, obj_inst_id,
+					       res_id)) {
 				/* update the event time for this observer */
 				obs->event_timestamp = k_uptime_get();
 
@@ -523,6 +589,107 @@ static int engine_add_observer(struct lwm2m_message *msg,
 	return 0;
 }
 
+#if defined(CONFIG_LWM2M_VERSION_1_1)
+static int engine_add_composite_observer(struct lwm2m_message *msg,
+					 const uint8_t *token, uint8_t tkl,
+					 uint16_t format,
+					 struct lwm2m_obj_path *paths,
+					 int path_count)
+{
+	struct composite_path_list *list;
+	struct observe_node *obs;
+	int i;
+
+	if (!msg || !msg->ctx) {
+		LOG_ERR("valid lwm2m message is required");
+		return -EINVAL;
+	}
+
+	if (!token || (tkl == 0U || tkl > MAX_TOKEN_LEN)) {
+		LOG_ERR("token(%p) and token length(%u) must be valid.",
+			token, tkl);
+		return -EINVAL;
+	}
+
+	if (path_count <= 0 || path_count > ARRAY_SIZE(list->paths)) {
+		return -EINVAL;
+	}
+
+	/* make sure this observer doesn't exist already */
+	SYS_SLIST_FOR_EACH_CONTAINER(&msg->ctx->observer, obs, node) {
+		if (obs->path.level == 0U &&
+		    obs->composite->count == path_count &&
+		    memcmp(obs->composite->paths, paths,
+			   path_count * sizeof(*paths)) == 0) {
+			/* quietly update the token information */
+			memcpy(obs->token, token, tkl);
+			obs->tkl = tkl;
+			obs->format = format;
+
+			LOG_DBG("COMPOSITE OBSERVER DUPLICATE (%d paths)",
+				path_count);
+
+			return 0;
+		}
+	}
+
+	/* find an unused observer index node */
+	for (i = 0; i < CONFIG_LWM2M_ENGINE_MAX_OBSERVER; i++) {
+		if (!observe_node_data[i].tkl) {
+			break;
+		}
+	}
+
+	/* couldn't find an index */
+	if (i == CONFIG_LWM2M_ENGINE_MAX_OBSERVER) {
+		return -ENOMEM;
+	}
+
+	obs = &observe_node_data[i];
+
+	/* find an unused path list */
+	for (i = 0; i < ARRAY_SIZE(composite_path_lists); i++) {
+		if (!composite_path_lists[i].count) {
+			break;
+		}
+	}
+
+	if (i == ARRAY_SIZE(composite_path_lists)) {
+		return -ENOMEM;
+	}
+
+	list = &composite_path_lists[i];
+	memcpy(list->paths, paths, path_count * sizeof(*paths));
+	list->count = path_count;
+
+	/* Attributes are set per path, a composite observation uses the
+	 * defaults of the server object.
+	 */
+	(void)memset(&obs->path, 0, sizeof(obs->path));
+	obs->composite = list;
+	memcpy(obs->token, token, tkl);
+	obs->tkl = tkl;
+	obs->last_timestamp = k_uptime_get();
+	obs->event_timestamp = obs->last_timestamp;
+	obs->min_period_sec = lwm2m_server_get_pmin(msg->ctx->srv_obj_inst);
+	obs->max_period_sec = lwm2m_server_get_pmax(msg->ctx->srv_obj_inst);
+	if (obs->max_period_sec > 0) {
+		obs->max_period_sec = MAX(obs->max_period_sec,
+					  obs->min_period_sec);
+	}
+
+	obs->format = format;
+	obs->counter = OBSERVE_COUNTER_START;
+	sys_slist_append(&msg->ctx->observer, &obs->node);
+
+	LOG_DBG("COMPOSITE OBSERVER ADDED (%d paths) token:'%s' addr:%s",
+		path_count, log_strdup(sprint_token(token, tkl)),
+		log_strdup(lwm2m_sprint_ip_addr(&msg->ctx->remote_addr)));
+
+	return 0;
+}
+#endif /* CONFIG_LWM2M_VERSION_1_1 */
+
 static int engine_remove_observer(struct lwm2m_ctx *ctx, const uint8_t *token, uint8_t tkl)
 {
 	struct observe_node *obs, *found_obj = NULL;
@@ -549,7 +716,7 @@ static int engine_remove_observer(struct lwm2m_ctx *ctx, const uint8_t *token, u
 	}
 
 	sys_slist_remove(&ctx->observer, prev_node, &found_obj->node);
-	(void)memset(found_obj, 0, sizeof(*found_obj));
+	observe_node_free(found_obj);
 
 	LOG_DBG("observer '%s' removed", log_strdup(sprint_token(token, tkl)));
 
@@ -599,7 +766,7 @@ static int engine_remove_observer_by_path(struct lwm2m_obj_path *path)
 	LOG_INF("Removing observer for path %s",
 		lwm2m_path_log_strdup(buf, path));
 	sys_slist_remove(&engine_observer_list, prev_node, &found_obj->node);
-	(void)memset(found_obj, 0, sizeof(*found_obj));
+	observe_node_free(found_obj);
 
 	return 0;
 }
@@ -615,36 +782,58 @@ static void engine_remove_observer_by_id(uint16_t obj_id, int32_t obj_inst_id)
 	for (i = 0; i < sock_nfds; ++i) {
 		SYS_SLIST_FOR_EACH_CONTAINER_SAFE(
 			&sock_ctx[i]->observer, obs, tmp, node) {
-			if (!(obj_id == obs->path.obj_id &&
+			/* composite observers stay, as long as any of their
+			 * paths can be read
+			 */
+			if (obs->path.level == 0U ||
+			    !(obj_id == obs->path.obj_id &&
 			      obj_inst_id == obs->path.obj_inst_id)) {
 				prev_node = &obs->node;
 				continue;
 			}
 
 			sys_slist_remove(&sock_ctx[i]->observer, prev_node, &obs->node);
-			(void)memset(obs, 0, sizeof(*obs));
+			observe_node_free(obs);
 		}
 	}
 }
 
 /* engine object */
 
+static inline sys_slist_t *engine_obj_bucket(uint16_t obj_id)
+{
+	return &engine_obj_hash[obj_id % ARRAY_SIZE(engine_obj_hash)];
+}
+
+static inline sys_slist_t *engine_obj_inst_bucket(uint16_t obj_id,
+						  uint16_t obj_inst_id)
+{
+	return &engine_obj_inst_hash[(obj_id * 31U + obj_inst_id) %
+				     ARRAY_SIZE(engine_obj_inst_hash)];
+}
+
 void lwm2m_register_obj(struct lwm2m_engine_obj *obj)
 {
 	sys_slist_append(&engine_obj_list, &obj->node);
+	sys_slist_append(engine_obj_bucket(obj->obj_id), &obj->hash_node);
+	engine_generation++;
 }
 
 void lwm2m_unregister_obj(struct lwm2m_engine_obj *obj)
 {
 	engine_remove_observer_by_id(obj->obj_id, -1);
 	sys_slist_find_and_remove(&engine_obj_list, &obj->node);
+	sys_slist_find_and_remove(engine_obj_bucket(obj->obj_id),
+				  &obj->hash_node);
+	engine_generation++;
 }
 
 static struct lwm2m_engine_obj *get_engine_obj(int obj_id)
 {
 	struct lwm2m_engine_obj *obj;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_list, obj, node) {
+	SYS_SLIST_FOR_EACH_CONTAINER(engine_obj_bucket(obj_id), obj,
+				     hash_node) {
 		if (obj->obj_id == obj_id) {
 			return obj;
 		}
@@ -669,11 +858,29 @@ lwm2m_get_engine_obj_field(struct lwm2m_engine_obj *obj, int res_id)
 	return NULL;
 }
 
+void lwm2m_engine_set_res_inst_id(struct lwm2m_engine_res_inst *res_inst,
+				  uint16_t res_inst_id)
+{
+	if (res_inst->res_inst_id == res_inst_id) {
+		return;
+	}
+
+	/* Resource handles pointing to the instance have to be resolved
+	 * again.
+	 */
+	res_inst->res_inst_id = res_inst_id;
+	engine_generation++;
+}
+
 /* engine object instance */
 
 static void engine_register_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 {
 	sys_slist_append(&engine_obj_inst_list, &obj_inst->node);
+	sys_slist_append(engine_obj_inst_bucket(obj_inst->obj->obj_id,
+						obj_inst->obj_inst_id),
+			 &obj_inst->hash_node);
+	engine_generation++;
 }
 
 static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
@@ -681,6 +888,11 @@ static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 	engine_remove_observer_by_id(
 			obj_inst->obj->obj_id, obj_inst->obj_inst_id);
 	sys_slist_find_and_remove(&engine_obj_inst_list, &obj_inst->node);
+	sys_slist_find_and_remove(
+			engine_obj_inst_bucket(obj_inst->obj->obj_id,
+					       obj_inst->obj_inst_id),
+			&obj_inst->hash_node);
+	engine_generation++;
 }
 
 static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
@@ -688,8 +900,9 @@ static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
 {
 	struct lwm2m_engine_obj_inst *obj_inst;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_inst_list, obj_inst,
-				     node) {
+	SYS_SLIST_FOR_EACH_CONTAINER(engine_obj_inst_bucket(obj_id,
+							    obj_inst_id),
+				     obj_inst, hash_node) {
 		if (obj_inst->obj->obj_id == obj_id &&
 		    obj_inst->obj_inst_id == obj_inst_id) {
 			return obj_inst;
@@ -1003,6 +1216,10 @@ int lwm2m_init_message(struct lwm2m_message *msg)
 		goto cleanup;
 	}
 
+#if defined(CONFIG_COAP_COCOA)
+	coap_pending_set_rto_estimator(msg->pending, &msg->ctx->rto);
+#endif
+
 	if (msg->reply_cb) {
 		msg->reply = coap_reply_next_unused(
 				msg->ctx->replies,
@@ -1199,6 +1416,18 @@ static int select_writer(struct lwm2m_output_context *out, uint16_t accept)
 		break;
 #endif
 
+#ifdef CONFIG_LWM2M_RW_SENML_JSON_SUPPORT
+	case LWM2M_FORMAT_APP_SENML_JSON:
+		out->writer = &senml_json_writer;
+		break;
+#endif
+
+#ifdef CONFIG_LWM2M_RW_SENML_CBOR_SUPPORT
+	case LWM2M_FORMAT_APP_SENML_CBOR:
+		out->writer = &senml_cbor_writer;
+		break;
+#endif
+
 	default:
 		LOG_WRN("Unknown content type %u", accept);
 		return -ENOMSG;
@@ -1230,6 +1459,18 @@ static int select_reader(struct lwm2m_input_context *in, uint16_t format)
 		break;
 #endif
 
+#ifdef CONFIG_LWM2M_RW_SENML_JSON_SUPPORT
+	case LWM2M_FORMAT_APP_SENML_JSON:
+		in->reader = &senml_json_reader;
+		break;
+#endif
+
+#ifdef CONFIG_LWM2M_RW_SENML_CBOR_SUPPORT
+	case LWM2M_FORMAT_APP_SENML_CBOR:
+		in->reader = &senml_cbor_reader;
+		break;
+#endif
+
 	default:
 		LOG_WRN("Unknown content type %u", format);
 		return -ENOMSG;
@@ -1510,46 +1751,22 @@ int lwm2m_engine_set_res_data(char *pathstr, void *data_ptr, uint16_t data_len,
 	return ret;
 }
 
-static int lwm2m_engine_set(char *pathstr, void *value, uint16_t len)
+static int engine_set_res(const struct lwm2m_obj_path *path,
+			  struct lwm2m_engine_obj_inst *obj_inst,
+			  struct lwm2m_engine_obj_field *obj_field,
+			  struct lwm2m_engine_res *res,
+			  struct lwm2m_engine_res_inst *res_inst,
+			  void *value, uint16_t len)
 {
-	struct lwm2m_obj_path path;
-	struct lwm2m_engine_obj_inst *obj_inst;
-	struct lwm2m_engine_obj_field *obj_field;
-	struct lwm2m_engine_res *res = NULL;
-	struct lwm2m_engine_res_inst *res_inst = NULL;
 	void *data_ptr = NULL;
 	size_t max_data_len = 0;
 	int ret = 0;
 	bool changed = false;
 
-	LOG_DBG("path:%s, value:%p, len:%d", log_strdup(pathstr), value, len);
-
-	/* translate path -> path_obj */
-	ret = string_to_path(pathstr, &path, '/');
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (path.level < 3) {
-		LOG_ERR("path must have at least 3 parts");
-		return -EINVAL;
-	}
-
-	/* look up resource obj */
-	ret = path_to_objs(&path, &obj_inst, &obj_field, &res, &res_inst);
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (!res_inst) {
-		LOG_ERR("res instance %d not found", path.res_inst_id);
-		return -ENOENT;
-	}
-
 	if (LWM2M_HAS_RES_FLAG(res_inst, LWM2M_RES_DATA_FLAG_RO)) {
 		LOG_ERR("res instance data pointer is read-only "
-			"[%u/%u/%u/%u:%u]", path.obj_id, path.obj_inst_id,
-			path.res_id, path.res_inst_id, path.level);
+			"[%u/%u/%u/%u:%u]", path->obj_id, path->obj_inst_id,
+			path->res_id, path->res_inst_id, path->level);
 		return -EACCES;
 	}
 
@@ -1566,8 +1783,8 @@ static int lwm2m_engine_set(char *pathstr, void *value, uint16_t len)
 
 	if (!data_ptr) {
 		LOG_ERR("res instance data pointer is NULL [%u/%u/%u/%u:%u]",
-			path.obj_id, path.obj_inst_id, path.res_id,
-			path.res_inst_id, path.level);
+			path->obj_id, path->obj_inst_id, path->res_id,
+			path->res_inst_id, path->level);
 		return -EINVAL;
 	}
 
@@ -1575,7 +1792,7 @@ static int lwm2m_engine_set(char *pathstr, void *value, uint16_t len)
 	if (len > max_data_len -
 		(obj_field->data_type == LWM2M_RES_TYPE_STRING ? 1 : 0)) {
 		LOG_ERR("length %u is too long for res instance %d data",
-			len, path.res_id);
+			len, path->res_id);
 		return -ENOMEM;
 	}
 
@@ -1676,12 +1893,49 @@ static int lwm2m_engine_set(char *pathstr, void *value, uint16_t len)
 	}
 
 	if (changed) {
-		NOTIFY_OBSERVER_PATH(&path);
+		NOTIFY_OBSERVER_PATH(path);
 	}
 
 	return ret;
 }
 
+static int lwm2m_engine_set(char *pathstr, void *value, uint16_t len)
+{
+	struct lwm2m_obj_path path;
+	struct lwm2m_engine_obj_inst *obj_inst;
+	struct lwm2m_engine_obj_field *obj_field;
+	struct lwm2m_engine_res *res = NULL;
+	struct lwm2m_engine_res_inst *res_inst = NULL;
+	int ret = 0;
+
+	LOG_DBG("path:%s, value:%p, len:%d", log_strdup(pathstr), value, len);
+
+	/* translate path -> path_obj */
+	ret = string_to_path(pathstr, &path, '/');
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (path.level < 3) {
+		LOG_ERR("path must have at least 3 parts");
+		return -EINVAL;
+	}
+
+	/* look up resource obj */
+	ret = path_to_objs(&path, &obj_inst, &obj_field, &res, &res_inst);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (!res_inst) {
+		LOG_ERR("res instance %d not found", path.res_inst_id);
+		return -ENOENT;
+	}
+
+	return engine_set_res(&path, obj_inst, obj_field, res, res_inst,
+			      value, len);
+}
+
 int lwm2m_engine_set_opaque(char *pathstr, char *data_ptr, uint16_t data_len)
 {
 	return lwm2m_engine_set(pathstr, data_ptr, data_len);
@@ -1792,41 +2046,15 @@ int lwm2m_engine_get_res_data(char *pathstr, void **data_ptr, uint16_t *data_len
 	return 0;
 }
 
-static int lwm2m_engine_get(char *pathstr, void *buf, uint16_t buflen)
+static int engine_get_res(struct lwm2m_engine_obj_inst *obj_inst,
+			  struct lwm2m_engine_obj_field *obj_field,
+			  struct lwm2m_engine_res *res,
+			  struct lwm2m_engine_res_inst *res_inst,
+			  void *buf, uint16_t buflen)
 {
-	int ret = 0;
-	struct lwm2m_obj_path path;
-	struct lwm2m_engine_obj_inst *obj_inst;
-	struct lwm2m_engine_obj_field *obj_field;
-	struct lwm2m_engine_res *res = NULL;
-	struct lwm2m_engine_res_inst *res_inst = NULL;
 	void *data_ptr = NULL;
 	size_t data_len = 0;
 
-	LOG_DBG("path:%s, buf:%p, buflen:%d", log_strdup(pathstr), buf, buflen);
-
-	/* translate path -> path_obj */
-	ret = string_to_path(pathstr, &path, '/');
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (path.level < 3) {
-		LOG_ERR("path must have at least 3 parts");
-		return -EINVAL;
-	}
-
-	/* look up resource obj */
-	ret = path_to_objs(&path, &obj_inst, &obj_field, &res, &res_inst);
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (!res_inst) {
-		LOG_ERR("res instance %d not found", path.res_inst_id);
-		return -ENOENT;
-	}
-
 	/* setup initial data elements */
 	data_ptr = res_inst->data_ptr;
 	data_len = res_inst->data_len;
@@ -1922,6 +2150,42 @@ static int lwm2m_engine_get(char *pathstr, void *buf, uint16_t buflen)
 	return 0;
 }
 
+static int lwm2m_engine_get(char *pathstr, void *buf, uint16_t buflen)
+{
+	int ret = 0;
+	struct lwm2m_obj_path path;
+	struct lwm2m_engine_obj_inst *obj_inst;
+	struct lwm2m_engine_obj_field *obj_field;
+	struct lwm2m_engine_res *res = NULL;
+	struct lwm2m_engine_res_inst *res_inst = NULL;
+
+	LOG_DBG("path:%s, buf:%p, buflen:%d", log_strdup(pathstr), buf, buflen);
+
+	/* translate path -> path_obj */
+	ret = string_to_path(pathstr, &path, '/');
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (path.level < 3) {
+		LOG_ERR("path must have at least 3 parts");
+		return -EINVAL;
+	}
+
+	/* look up resource obj */
+	ret = path_to_objs(&path, &obj_inst, &obj_field, &res, &res_inst);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (!res_inst) {
+		LOG_ERR("res instance %d not found", path.res_inst_id);
+		return -ENOENT;
+	}
+
+	return engine_get_res(obj_inst, obj_field, res, res_inst, buf, buflen);
+}
+
 int lwm2m_engine_get_opaque(char *pathstr, void *buf, uint16_t buflen)
 {
 	return lwm2m_engine_get(pathstr, buf, buflen);
@@ -2000,12 +2264,132 @@ int lwm2m_engine_get_objlnk(char *pathstr, struct lwm2m_objlnk *buf)
 	return lwm2m_engine_get(pathstr, buf, sizeof(struct lwm2m_objlnk));
 }
 
-int lwm2m_engine_get_resource(char *pathstr, struct lwm2m_engine_res **res)
+/* resource handles */
+
+static void handle_to_path(const struct lwm2m_res_handle *handle,
+			   struct lwm2m_obj_path *path)
+{
+	path->obj_id = handle->obj_id;
+	path->obj_inst_id = handle->obj_inst_id;
+	path->res_id = handle->res_id;
+	path->res_inst_id = handle->res_inst_id;
+	path->level = handle->level;
+}
+
+static int handle_resolve(struct lwm2m_res_handle *handle)
 {
-	int ret;
 	struct lwm2m_obj_path path;
+	struct lwm2m_engine_res_inst *res_inst = NULL;
+	int ret;
 
-	ret = string_to_path(pathstr, &path, '/');
+	handle_to_path(handle, &path);
+
+	handle->generation = 0U;
+	ret = path_to_objs(&path, &handle->obj_inst, &handle->obj_field,
+			   &handle->res, &res_inst);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (!res_inst) {
+		LOG_ERR("res instance %d not found", path.res_inst_id);
+		return -ENOENT;
+	}
+
+	handle->res_inst = res_inst;
+	handle->generation = engine_generation;
+
+	return 0;
+}
+
+/* Resolve the handle again only if objects or resource instances have been
+ * created or deleted after it was resolved the last time.
+ */
+static inline int handle_check(struct lwm2m_res_handle *handle)
+{
+	if (handle->generation == engine_generation) {
+		return 0;
+	}
+
+	return handle_resolve(handle);
+}
+
+int lwm2m_engine_res_handle_get(char *pathstr,
+				struct lwm2m_res_handle *handle)
+{
+	struct lwm2m_obj_path path;
+	int ret;
+
+	ret = string_to_path(pathstr, &path, '/');
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (path.level < 3) {
+		LOG_ERR("path must have at least 3 parts");
+		return -EINVAL;
+	}
+
+	(void)memset(handle, 0, sizeof(*handle));
+	handle->obj_id = path.obj_id;
+	handle->obj_inst_id = path.obj_inst_id;
+	handle->res_id = path.res_id;
+	handle->res_inst_id = path.res_inst_id;
+	handle->level = path.level;
+
+	return handle_resolve(handle);
+}
+
+int lwm2m_engine_set_by_handle(struct lwm2m_res_handle *handle,
+			       void *value, uint16_t len)
+{
+	struct lwm2m_obj_path path;
+	int ret;
+
+	ret = handle_check(handle);
+	if (ret < 0) {
+		return ret;
+	}
+
+	handle_to_path(handle, &path);
+
+	return engine_set_res(&path, handle->obj_inst, handle->obj_field,
+			      handle->res, handle->res_inst, value, len);
+}
+
+int lwm2m_engine_get_by_handle(struct lwm2m_res_handle *handle,
+			       void *buf, uint16_t buflen)
+{
+	int ret;
+
+	ret = handle_check(handle);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return engine_get_res(handle->obj_inst, handle->obj_field,
+			      handle->res, handle->res_inst, buf, buflen);
+}
+
+int lwm2m_engine_notify_by_handle(struct lwm2m_res_handle *handle)
+{
+	int ret;
+
+	ret = handle_check(handle);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return NOTIFY_OBSERVER(handle->obj_id, handle->obj_inst_id,
+			       handle->res_id);
+}
+
+int lwm2m_engine_get_resource(char *pathstr, struct lwm2m_engine_res **res)
+{
+	int ret;
+	struct lwm2m_obj_path path;
+
+	ret = string_to_path(pathstr, &path, '/');
 	if (ret < 0) {
 		return ret;
 	}
@@ -2129,7 +2513,7 @@ int lwm2m_engine_create_res_inst(char *pathstr)
 		return -ENOMEM;
 	}
 
-	res->res_instances[i].res_inst_id = path.res_inst_id;
+	lwm2m_engine_set_res_inst_id(&res->res_instances[i], path.res_inst_id);
 	return 0;
 }
 
@@ -2162,7 +2546,7 @@ int lwm2m_engine_delete_res_inst(char *pathstr)
 	res_inst->data_ptr = NULL;
 	res_inst->max_data_len = 0U;
 	res_inst->data_len = 0U;
-	res_inst->res_inst_id = RES_INSTANCE_NOT_CREATED;
+	lwm2m_engine_set_res_inst_id(res_inst, RES_INSTANCE_NOT_CREATED);
 
 	return 0;
 }
@@ -3164,6 +3548,16 @@ static int do_read_op(struct lwm2m_message *msg, uint16_t content_format)
 		return do_read_op_json(msg, content_format);
 #endif
 
+#if defined(CONFIG_LWM2M_RW_SENML_JSON_SUPPORT)
+	case LWM2M_FORMAT_APP_SENML_JSON:
+		return do_read_op_senml_json(msg, content_format);
+#endif
+
+#if defined(CONFIG_LWM2M_RW_SENML_CBOR_SUPPORT)
+	case LWM2M_FORMAT_APP_SENML_CBOR:
+		return do_read_op_senml_cbor(msg, content_format);
+#endif
+
 	default:
 		LOG_ERR("Unsupported content-format: %u", content_format);
 		return -ENOMSG;
@@ -3171,45 +3565,66 @@ static int do_read_op(struct lwm2m_message *msg, uint16_t content_format)
 	}
 }
 
-int lwm2m_perform_read_op(struct lwm2m_message *msg, uint16_t content_format)
+#if defined(CONFIG_LWM2M_VERSION_1_1)
+static int do_composite_read_op(struct lwm2m_message *msg,
+				uint16_t content_format,
+				struct lwm2m_obj_path *paths, int path_count)
 {
-	struct lwm2m_engine_obj_inst *obj_inst = NULL;
-	struct lwm2m_engine_res *res = NULL;
-	struct lwm2m_engine_obj_field *obj_field;
-	struct lwm2m_obj_path temp_path;
-	int ret = 0, index;
-	uint8_t num_read = 0U;
+	switch (content_format) {
 
-	if (msg->path.level >= 2U) {
-		obj_inst = get_engine_obj_inst(msg->path.obj_id,
-					       msg->path.obj_inst_id);
-	} else if (msg->path.level == 1U) {
-		/* find first obj_inst with path's obj_id */
-		obj_inst = next_engine_obj_inst(msg->path.obj_id, -1);
-	}
+#if defined(CONFIG_LWM2M_RW_SENML_JSON_SUPPORT)
+	case LWM2M_FORMAT_APP_SENML_JSON:
+		return do_composite_read_op_senml_json(msg, content_format,
+						       paths, path_count);
+#endif
 
-	if (!obj_inst) {
-		return -ENOENT;
-	}
+#if defined(CONFIG_LWM2M_RW_SENML_CBOR_SUPPORT)
+	case LWM2M_FORMAT_APP_SENML_CBOR:
+		return do_composite_read_op_senml_cbor(msg, content_format,
+						       paths, path_count);
+#endif
+
+	default:
+		LOG_ERR("Unsupported composite content-format: %u",
+			content_format);
+		return -ENOMSG;
 
-	/* set output content-format */
-	ret = coap_append_option_int(msg->out.out_cpkt,
-				     COAP_OPTION_CONTENT_FORMAT,
-				     content_format);
-	if (ret < 0) {
-		LOG_ERR("Error setting response content-format: %d", ret);
-		return ret;
 	}
+}
+
+static int get_composite_path_list(struct lwm2m_message *msg,
+				   uint16_t format,
+				   struct lwm2m_obj_path *paths,
+				   int max_paths)
+{
+	switch (format) {
+
+#if defined(CONFIG_LWM2M_RW_SENML_JSON_SUPPORT)
+	case LWM2M_FORMAT_APP_SENML_JSON:
+		return senml_json_get_path_list(msg, paths, max_paths);
+#endif
+
+#if defined(CONFIG_LWM2M_RW_SENML_CBOR_SUPPORT)
+	case LWM2M_FORMAT_APP_SENML_CBOR:
+		return senml_cbor_get_path_list(msg, paths, max_paths);
+#endif
+
+	default:
+		LOG_ERR("Unsupported composite content-format: %u", format);
+		return -ENOMSG;
 
-	ret = coap_packet_append_payload_marker(msg->out.out_cpkt);
-	if (ret < 0) {
-		LOG_ERR("Error appending payload marker: %d", ret);
-		return ret;
 	}
+}
+#endif /* CONFIG_LWM2M_VERSION_1_1 */
 
-	/* store original path values so we can change them during processing */
-	memcpy(&temp_path, &msg->path, sizeof(temp_path));
-	engine_put_begin(&msg->out, &msg->path);
+/* Read the resources of msg->path, starting with obj_inst */
+static int read_path_resources(struct lwm2m_message *msg,
+			       struct lwm2m_engine_obj_inst *obj_inst,
+			       uint8_t *num_read)
+{
+	struct lwm2m_engine_res *res = NULL;
+	struct lwm2m_engine_obj_field *obj_field;
+	int ret = 0, index;
 
 	while (obj_inst) {
 		if (!obj_inst->resources || obj_inst->resource_count == 0U) {
@@ -3260,7 +3675,7 @@ int lwm2m_perform_read_op(struct lwm2m_message *msg, uint16_t content_format)
 						LOG_ERR("READ OP: %d", ret);
 					}
 				} else {
-					num_read += 1U;
+					*num_read += 1U;
 				}
 
 				/* end resource formatting */
@@ -3291,6 +3706,61 @@ move_forward:
 		}
 	}
 
+	return ret;
+}
+
+static int read_op_begin(struct lwm2m_message *msg, uint16_t content_format)
+{
+	int ret;
+
+	/* set output content-format */
+	ret = coap_append_option_int(msg->out.out_cpkt,
+				     COAP_OPTION_CONTENT_FORMAT,
+				     content_format);
+	if (ret < 0) {
+		LOG_ERR("Error setting response content-format: %d", ret);
+		return ret;
+	}
+
+	ret = coap_packet_append_payload_marker(msg->out.out_cpkt);
+	if (ret < 0) {
+		LOG_ERR("Error appending payload marker: %d", ret);
+		return ret;
+	}
+
+	return 0;
+}
+
+int lwm2m_perform_read_op(struct lwm2m_message *msg, uint16_t content_format)
+{
+	struct lwm2m_engine_obj_inst *obj_inst = NULL;
+	struct lwm2m_obj_path temp_path;
+	int ret = 0;
+	uint8_t num_read = 0U;
+
+	if (msg->path.level >= 2U) {
+		obj_inst = get_engine_obj_inst(msg->path.obj_id,
+					       msg->path.obj_inst_id);
+	} else if (msg->path.level == 1U) {
+		/* find first obj_inst with path's obj_id */
+		obj_inst = next_engine_obj_inst(msg->path.obj_id, -1);
+	}
+
+	if (!obj_inst) {
+		return -ENOENT;
+	}
+
+	ret = read_op_begin(msg, content_format);
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* store original path values so we can change them during processing */
+	memcpy(&temp_path, &msg->path, sizeof(temp_path));
+	engine_put_begin(&msg->out, &msg->path);
+
+	ret = read_path_resources(msg, obj_inst, &num_read);
+
 	engine_put_end(&msg->out, &msg->path);
 
 	/* restore original path values */
@@ -3304,6 +3774,55 @@ move_forward:
 	return ret;
 }
 
+int lwm2m_perform_composite_read_op(struct lwm2m_message *msg,
+				    uint16_t content_format,
+				    struct lwm2m_obj_path *paths,
+				    int path_count)
+{
+	struct lwm2m_engine_obj_inst *obj_inst;
+	struct lwm2m_obj_path temp_path;
+	uint8_t num_read = 0U;
+	int ret, i;
+
+	ret = read_op_begin(msg, content_format);
+	if (ret < 0) {
+		return ret;
+	}
+
+	memcpy(&temp_path, &msg->path, sizeof(temp_path));
+	engine_put_begin(&msg->out, &msg->path);
+
+	for (i = 0; i < path_count; i++) {
+		memcpy(&msg->path, &paths[i], sizeof(msg->path));
+
+		if (msg->path.level >= 2U) {
+			obj_inst = get_engine_obj_inst(msg->path.obj_id,
+						       msg->path.obj_inst_id);
+		} else if (msg->path.level == 1U) {
+			obj_inst = next_engine_obj_inst(msg->path.obj_id, -1);
+		} else {
+			obj_inst = NULL;
+		}
+
+		/* paths which do not exist are left out of the response */
+		if (!obj_inst) {
+			continue;
+		}
+
+		ret = read_path_resources(msg, obj_inst, &num_read);
+		if (ret < 0) {
+			LOG_DBG("Composite read of path %d failed: %d", i, ret);
+		}
+	}
+
+	engine_put_end(&msg->out, &msg->path);
+
+	/* restore original path values */
+	memcpy(&msg->path, &temp_path, sizeof(temp_path));
+
+	return num_read > 0U ? 0 : -ENOENT;
+}
+
 int lwm2m_discover_handler(struct lwm2m_message *msg, bool is_bootstrap)
 {
 	struct lwm2m_engine_obj *obj;
@@ -3485,6 +4004,62 @@ int lwm2m_get_or_create_engine_obj(struct lwm2m_message *msg,
 	return ret;
 }
 
+/* Write the value at the reader position to the resource (instance) in
+ * msg->path, creating the object instance if needed.
+ */
+int lwm2m_write_resource_path(struct lwm2m_message *msg)
+{
+	struct lwm2m_engine_obj_field *obj_field;
+	struct lwm2m_engine_obj_inst *obj_inst;
+	struct lwm2m_engine_res *res = NULL;
+	struct lwm2m_engine_res_inst *res_inst = NULL;
+	int ret, index;
+
+	if (msg->path.level < 3U) {
+		return -EINVAL;
+	}
+
+	ret = lwm2m_get_or_create_engine_obj(msg, &obj_inst, NULL);
+	if (ret < 0) {
+		return ret;
+	}
+
+	obj_field = lwm2m_get_engine_obj_field(obj_inst->obj,
+					       msg->path.res_id);
+	if (!obj_field) {
+		return -ENOENT;
+	}
+
+	if (!LWM2M_HAS_PERM(obj_field, LWM2M_PERM_W)) {
+		return -EPERM;
+	}
+
+	for (index = 0; index < obj_inst->resource_count; index++) {
+		if (obj_inst->resources[index].res_id == msg->path.res_id) {
+			res = &obj_inst->resources[index];
+			break;
+		}
+	}
+
+	if (!res) {
+		return -ENOENT;
+	}
+
+	for (index = 0; index < res->res_inst_count; index++) {
+		if (res->res_instances[index].res_inst_id ==
+		    msg->path.res_inst_id) {
+			res_inst = &res->res_instances[index];
+			break;
+		}
+	}
+
+	if (!res_inst) {
+		return -ENOENT;
+	}
+
+	return lwm2m_write_handler(obj_inst, res, res_inst, obj_field, msg);
+}
+
 struct lwm2m_engine_obj *lwm2m_engine_get_obj(
 					const struct lwm2m_obj_path *path)
 {
@@ -3553,6 +4128,16 @@ static int do_write_op(struct lwm2m_message *msg,
 		return do_write_op_json(msg);
 #endif
 
+#ifdef CONFIG_LWM2M_RW_SENML_JSON_SUPPORT
+	case LWM2M_FORMAT_APP_SENML_JSON:
+		return do_write_op_senml_json(msg);
+#endif
+
+#ifdef CONFIG_LWM2M_RW_SENML_CBOR_SUPPORT
+	case LWM2M_FORMAT_APP_SENML_CBOR:
+		return do_write_op_senml_cbor(msg);
+#endif
+
 	default:
 		LOG_ERR("Unsupported format: %u", format);
 		return -ENOMSG;
@@ -3636,6 +4221,53 @@ static int bootstrap_delete(struct lwm2m_message *msg)
 }
 #endif
 
+#if defined(CONFIG_LWM2M_VERSION_1_1)
+/* Read-Composite and Observe-Composite, FETCH with a list of paths */
+static int handle_composite_read(struct lwm2m_message *msg, uint16_t format,
+				 uint16_t accept, int observe)
+{
+	struct lwm2m_obj_path paths[CONFIG_LWM2M_COMPOSITE_PATH_LIST_SIZE];
+	int path_count, r;
+
+	path_count = get_composite_path_list(msg, format, paths,
+					     ARRAY_SIZE(paths));
+	if (path_count == -ENOMEM) {
+		return -EFBIG;
+	} else if (path_count < 0) {
+		return path_count;
+	}
+
+	if (observe == 0) {
+		if (!msg->token) {
+			LOG_ERR("OBSERVE request missing token");
+			return -EINVAL;
+		}
+
+		r = coap_append_option_int(msg->out.out_cpkt,
+					   COAP_OPTION_OBSERVE,
+					   OBSERVE_COUNTER_START);
+		if (r < 0) {
+			LOG_ERR("OBSERVE option error: %d", r);
+			return r;
+		}
+
+		r = engine_add_composite_observer(msg, msg->token, msg->tkl,
+						  accept, paths, path_count);
+		if (r < 0) {
+			LOG_ERR("add composite OBSERVE error: %d", r);
+			return r;
+		}
+	} else if (observe == 1) {
+		r = engine_remove_observer(msg->ctx, msg->token, msg->tkl);
+		if (r < 0) {
+			LOG_ERR("remove observe error: %d", r);
+		}
+	}
+
+	return do_composite_read_op(msg, accept, paths, path_count);
+}
+#endif /* CONFIG_LWM2M_VERSION_1_1 */
+
 static int handle_request(struct coap_packet *request,
 			  struct lwm2m_message *msg)
 {
@@ -3653,6 +4285,7 @@ static int handle_request(struct coap_packet *request,
 	uint16_t payload_len = 0U;
 	bool last_block = false;
 	bool ignore = false;
+	bool composite = false;
 	const uint8_t *payload_start;
 
 	/* set CoAP request / message */
@@ -3691,6 +4324,12 @@ static int handle_request(struct coap_packet *request,
 		 * bootstrap.
 		 */
 		switch (code & COAP_REQUEST_MASK) {
+#if defined(CONFIG_LWM2M_VERSION_1_1)
+		case COAP_METHOD_FETCH:
+			/* Read-Composite and Observe-Composite */
+			composite = true;
+			break;
+#endif
 #if defined(CONFIG_LWM2M_RD_CLIENT_SUPPORT_BOOTSTRAP)
 		case COAP_METHOD_DELETE:
 		case COAP_METHOD_GET:
@@ -3746,6 +4385,9 @@ static int handle_request(struct coap_packet *request,
 	r = coap_find_options(msg->in.in_cpkt, COAP_OPTION_ACCEPT, options, 1);
 	if (r > 0) {
 		accept = coap_option_value_to_int(&options[0]);
+	} else if (composite) {
+		/* respond in the format of the path list */
+		accept = format;
 	} else {
 		LOG_DBG("No accept option given. Assume OMA TLV.");
 		accept = LWM2M_FORMAT_OMA_TLV;
@@ -3756,7 +4398,7 @@ static int handle_request(struct coap_packet *request,
 		goto error;
 	}
 
-	if (!(msg->ctx->bootstrap_mode && msg->path.level == 0)) {
+	if (!(msg->ctx->bootstrap_mode && msg->path.level == 0) && !composite) {
 		/* find registered obj */
 		obj = get_engine_obj(msg->path.obj_id);
 		if (!obj) {
@@ -3787,6 +4429,15 @@ static int handle_request(struct coap_packet *request,
 		msg->code = COAP_RESPONSE_CODE_CONTENT;
 		break;
 
+#if defined(CONFIG_LWM2M_VERSION_1_1)
+	case COAP_METHOD_FETCH:
+		msg->operation = LWM2M_OP_READ;
+		observe = coap_get_option_int(msg->in.in_cpkt,
+					      COAP_OPTION_OBSERVE);
+		msg->code = COAP_RESPONSE_CODE_CONTENT;
+		break;
+#endif
+
 	case COAP_METHOD_POST:
 		if (msg->path.level == 1U) {
 			/* create an object instance */
@@ -3907,6 +4558,14 @@ static int handle_request(struct coap_packet *request,
 		switch (msg->operation) {
 
 		case LWM2M_OP_READ:
+#if defined(CONFIG_LWM2M_VERSION_1_1)
+			if (composite) {
+				r = handle_composite_read(msg, format, accept,
+							  observe);
+				break;
+			}
+#endif
+
 			if (observe == 0) {
 				/* add new observer */
 				if (msg->token) {
@@ -4010,7 +4669,7 @@ error:
 		msg->code = COAP_RESPONSE_CODE_NOT_FOUND;
 	} else if (r == -EPERM) {
 		msg->code = COAP_RESPONSE_CODE_NOT_ALLOWED;
-	} else if (r == -EEXIST) {
+	} else if (r == -EEXIST || r == -EBADMSG) {
 		msg->code = COAP_RESPONSE_CODE_BAD_REQUEST;
 	} else if (r == -EFAULT) {
 		msg->code = COAP_RESPONSE_CODE_INCOMPLETE;
@@ -4069,8 +4728,13 @@ static int lwm2m_response_promote_to_con(struct lwm2m_message *msg)
 	if (ret < 0) {
 		LOG_ERR("Unable to initialize a pending "
 			"retransmission (err:%d).", ret);
+		return ret;
 	}
 
+#if defined(CONFIG_COAP_COCOA)
+	coap_pending_set_rto_estimator(msg->pending, &msg->ctx->rto);
+#endif
+
 	return ret;
 }
 
@@ -4103,6 +4767,13 @@ static void lwm2m_udp_receive(struct lwm2m_ctx *client_ctx,
 			return;
 		}
 
+#if defined(CONFIG_COAP_COCOA)
+		/* Only the first ACK gives a valid RTT sample */
+		if (!msg->acknowledged) {
+			coap_rto_estimator_update(pending);
+		}
+#endif
+
 		msg->acknowledged = true;
 
 		if (msg->reply == NULL) {
@@ -4326,9 +4997,10 @@ static int generate_notify_message(struct lwm2m_ctx *ctx,
 		log_strdup(lwm2m_sprint_ip_addr(&ctx->remote_addr)),
 		k_uptime_get());
 
+	/* composite observations are checked when they are read */
 	obj_inst = get_engine_obj_inst(obs->path.obj_id,
 				       obs->path.obj_inst_id);
-	if (!obj_inst) {
+	if (!obj_inst && obs->path.level > 0U) {
 		LOG_ERR("unable to get engine obj for %u/%u",
 			obs->path.obj_id,
 			obs->path.obj_inst_id);
@@ -4363,7 +5035,17 @@ static int generate_notify_message(struct lwm2m_ctx *ctx,
 	/* set the output writer */
 	select_writer(&msg->out, obs->format);
 
-	ret = do_read_op(msg, obs->format);
+#if defined(CONFIG_LWM2M_VERSION_1_1)
+	if (obs->path.level == 0U) {
+		ret = do_composite_read_op(msg, obs->format,
+					   obs->composite->paths,
+					   obs->composite->count);
+	} else
+#endif
+	{
+		ret = do_read_op(msg, obs->format);
+	}
+
 	if (ret < 0) {
 		LOG_ERR("error in multi-format read (err:%d)", ret);
 		goto cleanup;
@@ -4379,6 +5061,97 @@ cleanup:
 	return ret;
 }
 
+#if defined(CONFIG_LWM2M_VERSION_1_1)
+static int send_message_reply_cb(const struct coap_packet *response,
+				 struct coap_reply *reply,
+				 const struct sockaddr *from)
+{
+	uint8_t code;
+
+	code = coap_header_get_code(response);
+	if (COAP_RESPONSE_CODE_CLASS(code) != 2) {
+		LOG_ERR("Send failed, server responded %d.%d",
+			COAP_RESPONSE_CODE_CLASS(code),
+			COAP_RESPONSE_CODE_DETAIL(code));
+	}
+
+	return 0;
+}
+
+int lwm2m_engine_send(struct lwm2m_ctx *ctx, char const *path_list[],
+		      uint8_t path_list_size, bool confirmation_request)
+{
+	struct lwm2m_obj_path paths[CONFIG_LWM2M_COMPOSITE_PATH_LIST_SIZE];
+	struct lwm2m_message *msg;
+	uint16_t format;
+	int ret, i;
+
+	if (!ctx || path_list_size == 0U) {
+		return -EINVAL;
+	}
+
+	if (path_list_size > ARRAY_SIZE(paths)) {
+		return -E2BIG;
+	}
+
+	for (i = 0; i < path_list_size; i++) {
+		ret = string_to_path((char *)path_list[i], &paths[i], '/');
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	if (IS_ENABLED(CONFIG_LWM2M_RW_SENML_CBOR_SUPPORT)) {
+		format = LWM2M_FORMAT_APP_SENML_CBOR;
+	} else {
+		format = LWM2M_FORMAT_APP_SENML_JSON;
+	}
+
+	msg = lwm2m_get_message(ctx);
+	if (!msg) {
+		LOG_ERR("Unable to get a lwm2m message!");
+		return -ENOMEM;
+	}
+
+	msg->type = confirmation_request ? COAP_TYPE_CON : COAP_TYPE_NON_CON;
+	msg->code = COAP_METHOD_POST;
+	msg->mid = coap_next_id();
+	msg->tkl = LWM2M_MSG_TOKEN_GENERATE_NEW;
+	msg->reply_cb = confirmation_request ? send_message_reply_cb : NULL;
+	msg->out.out_cpkt = &msg->cpkt;
+
+	ret = lwm2m_init_message(msg);
+	if (ret < 0) {
+		goto cleanup;
+	}
+
+	ret = coap_packet_append_option(&msg->cpkt, COAP_OPTION_URI_PATH,
+					"dp", strlen("dp"));
+	if (ret < 0) {
+		goto cleanup;
+	}
+
+	ret = select_writer(&msg->out, format);
+	if (ret < 0) {
+		goto cleanup;
+	}
+
+	ret = do_composite_read_op(msg, format, paths, path_list_size);
+	if (ret < 0) {
+		LOG_ERR("Send data read failed (err:%d)", ret);
+		goto cleanup;
+	}
+
+	lwm2m_send_message_async(msg);
+
+	return 0;
+
+cleanup:
+	lwm2m_reset_message(msg, true);
+	return ret;
+}
+#endif /* CONFIG_LWM2M_VERSION_1_1 */
+
 static int32_t engine_next_service_timeout_ms(uint32_t max_timeout,
 					      const int64_t timestamp)
 {
@@ -4475,7 +5248,7 @@ int lwm2m_engine_context_close(struct lwm2m_ctx *client_ctx)
 	while (!sys_slist_is_empty(&client_ctx->observer)) {
 		obs_node = sys_slist_get_not_empty(&client_ctx->observer);
 		obs = SYS_SLIST_CONTAINER(obs_node, obs, node);
-		(void)memset(obs, 0, sizeof(*obs));
+		observe_node_free(obs);
 	}
 
 	for (i = 0, msg = messages; i < ARRAY_SIZE(messages); i++, msg++) {
@@ -4502,6 +5275,9 @@ void lwm2m_engine_context_init(struct lwm2m_ctx *client_ctx)
 {
 	sys_slist_init(&client_ctx->pending_sends);
 	sys_slist_init(&client_ctx->observer);
+#if defined(CONFIG_COAP_COCOA)
+	coap_rto_estimator_init(&client_ctx->rto);
+#endif
 }
 
 /* LwM2M Socket Integration */
@@ -4543,14 +5319,29 @@ void lwm2m_socket_del(struct lwm2m_ctx *ctx)
 	}
 }
 
+static int64_t observe_min_period_ms(const struct observe_node *obs)
+{
+	int64_t min_period = MSEC_PER_SEC * obs->min_period_sec;
+
+#if defined(CONFIG_COAP_OBSERVE_COALESCE)
+	/* Updates within the CoAP minimum interval are coalesced the same
+	 * way as the ones within pmin: a single notification carrying the
+	 * latest value is sent when the interval has passed.
+	 */
+	min_period = MAX(min_period, CONFIG_COAP_OBSERVE_MIN_INTERVAL_MS);
+#endif
+
+	return min_period;
+}
+
 static bool manual_notify_is_due(const struct observe_node *obs,
 				 const int64_t timestamp)
 {
-	const bool has_min_period = obs->min_period_sec != 0;
+	const int64_t min_period = observe_min_period_ms(obs);
 
 	return obs->event_timestamp > obs->last_timestamp &&
-		(!has_min_period || timestamp > obs->last_timestamp +
-		 MSEC_PER_SEC * obs->min_period_sec);
+		(min_period == 0 ||
+		 timestamp > obs->last_timestamp + min_period);
 }
 
 static bool automatic_notify_is_due(const struct observe_node *obs,
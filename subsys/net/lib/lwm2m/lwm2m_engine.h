@@ -11,7 +11,11 @@
 #include "lwm2m_object.h"
 
 #define LWM2M_PROTOCOL_VERSION_MAJOR 1
+#if defined(CONFIG_LWM2M_VERSION_1_1)
+#define LWM2M_PROTOCOL_VERSION_MINOR 1
+#else
 #define LWM2M_PROTOCOL_VERSION_MINOR 0
+#endif
 
 #define LWM2M_PROTOCOL_VERSION_STRING STRINGIFY(LWM2M_PROTOCOL_VERSION_MAJOR) \
 				      "." \
@@ -23,6 +27,8 @@
 #define LWM2M_FORMAT_APP_OCTET_STREAM	42
 #define LWM2M_FORMAT_APP_EXI		47
 #define LWM2M_FORMAT_APP_JSON		50
+#define LWM2M_FORMAT_APP_SENML_JSON	110
+#define LWM2M_FORMAT_APP_SENML_CBOR	112
 #define LWM2M_FORMAT_OMA_PLAIN_TEXT	1541
 #define LWM2M_FORMAT_OMA_OLD_TLV	1542
 #define LWM2M_FORMAT_OMA_OLD_JSON	1543
@@ -77,6 +83,10 @@ struct lwm2m_engine_obj_inst *lwm2m_engine_get_obj_inst(
 struct lwm2m_engine_res *lwm2m_engine_get_res(
 					const struct lwm2m_obj_path *path);
 
+/* Create or delete (RES_INSTANCE_NOT_CREATED) a resource instance */
+void lwm2m_engine_set_res_inst_id(struct lwm2m_engine_res_inst *res_inst,
+				  uint16_t res_inst_id);
+
 bool lwm2m_engine_shall_report_obj_version(const struct lwm2m_engine_obj *obj);
 
 /* LwM2M context functions */
@@ -97,12 +107,17 @@ int lwm2m_send_empty_ack(struct lwm2m_ctx *client_ctx, uint16_t mid);
 int lwm2m_register_payload_handler(struct lwm2m_message *msg);
 
 int lwm2m_perform_read_op(struct lwm2m_message *msg, uint16_t content_format);
+int lwm2m_perform_composite_read_op(struct lwm2m_message *msg,
+				    uint16_t content_format,
+				    struct lwm2m_obj_path *paths,
+				    int path_count);
 
 int lwm2m_write_handler(struct lwm2m_engine_obj_inst *obj_inst,
 			struct lwm2m_engine_res *res,
 			struct lwm2m_engine_res_inst *res_inst,
 			struct lwm2m_engine_obj_field *obj_field,
 			struct lwm2m_message *msg);
+int lwm2m_write_resource_path(struct lwm2m_message *msg);
 
 int lwm2m_discover_handler(struct lwm2m_message *msg, bool is_bootstrap);
 
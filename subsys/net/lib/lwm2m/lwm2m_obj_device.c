@@ -139,7 +139,8 @@ static int reset_error_list_cb(uint16_t obj_inst_id,
 	/* "delete" error codes */
 	for (i = 0; i < DEVICE_ERROR_CODE_MAX; i++) {
 		error_code_list[i] = 0;
-		error_code_ri[i].res_inst_id = RES_INSTANCE_NOT_CREATED;
+		lwm2m_engine_set_res_inst_id(&error_code_ri[i],
+					     RES_INSTANCE_NOT_CREATED);
 	}
 
 	return 0;
@@ -197,7 +198,7 @@ int lwm2m_device_add_err(uint8_t error_code)
 	}
 
 	error_code_list[i] = error_code;
-	error_code_ri[i].res_inst_id = i;
+	lwm2m_engine_set_res_inst_id(&error_code_ri[i], i);
 	NOTIFY_OBSERVER(LWM2M_OBJECT_DEVICE_ID, 0, DEVICE_ERROR_CODE_ID);
 
 	return 0;
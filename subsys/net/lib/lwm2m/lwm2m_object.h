@@ -184,6 +184,9 @@ struct lwm2m_engine_obj {
 	/* object list */
 	sys_snode_t node;
 
+	/* object lookup hash chain */
+	sys_snode_t hash_node;
+
 	/* object field definitions */
 	struct lwm2m_engine_obj_field *fields;
 
@@ -381,6 +384,9 @@ struct lwm2m_engine_obj_inst {
 	/* instance list */
 	sys_snode_t node;
 
+	/* instance lookup hash chain */
+	sys_snode_t hash_node;
+
 	struct lwm2m_engine_obj *obj;
 	struct lwm2m_engine_res *resources;
 
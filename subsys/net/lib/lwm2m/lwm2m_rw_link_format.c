@@ -27,9 +27,15 @@ LOG_MODULE_REGISTER(net_lwm2m_link_format, CONFIG_LWM2M_LOG_LEVEL);
  * missing.
  */
 
-#if defined(CONFIG_LWM2M_RW_JSON_SUPPORT)
 #define RESOURCE_TYPE		";rt=\"oma.lwm2m\""
 
+#if defined(CONFIG_LWM2M_RW_SENML_CBOR_SUPPORT)
+#define REG_PREFACE		"</>" RESOURCE_TYPE \
+				";ct=" STRINGIFY(LWM2M_FORMAT_APP_SENML_CBOR)
+#elif defined(CONFIG_LWM2M_RW_SENML_JSON_SUPPORT)
+#define REG_PREFACE		"</>" RESOURCE_TYPE \
+				";ct=" STRINGIFY(LWM2M_FORMAT_APP_SENML_JSON)
+#elif defined(CONFIG_LWM2M_RW_JSON_SUPPORT)
 #define REG_PREFACE		"</>" RESOURCE_TYPE \
 				";ct=" STRINGIFY(LWM2M_FORMAT_OMA_JSON)
 #else
@@ -0,0 +1,1194 @@
+/** @file
+ * @brief LwM2M SenML-CBOR content format (RFC 8428, section 6)
+ *
+ * Each resource (instance) is a SenML record with its name relative to the
+ * last base name. A new base name is emitted when the object instance
+ * changes, so the same writer serves single path reads and composite reads
+ * that span several objects.
+ */
+
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_MODULE_NAME net_lwm2m_senml_cbor
+#define LOG_LEVEL CONFIG_LWM2M_LOG_LEVEL
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(LOG_MODULE_NAME);
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/byteorder.h>
+
+#include "lwm2m_object.h"
+#include "lwm2m_rw_senml_cbor.h"
+#include "lwm2m_engine.h"
+#include "lwm2m_util.h"
+
+/* CBOR major types */
+#define CBOR_MT_UINT		0
+#define CBOR_MT_NINT		1
+#define CBOR_MT_BSTR		2
+#define CBOR_MT_TSTR		3
+#define CBOR_MT_ARRAY		4
+#define CBOR_MT_MAP		5
+#define CBOR_MT_TAG		6
+#define CBOR_MT_SIMPLE		7
+
+#define CBOR_AI_INDEFINITE	31
+
+#define CBOR_FALSE		20
+#define CBOR_TRUE		21
+#define CBOR_FLOAT16		25
+#define CBOR_FLOAT32		26
+#define CBOR_FLOAT64		27
+#define CBOR_BREAK		0xff
+
+/* SenML labels */
+#define SENML_LABEL_BN		-2
+#define SENML_LABEL_BT		-3
+#define SENML_LABEL_N		0
+#define SENML_LABEL_V		2
+#define SENML_LABEL_VS		3
+#define SENML_LABEL_VB		4
+#define SENML_LABEL_VD		8
+/* LwM2M object link value, only has a text label */
+#define SENML_LABEL_VLO		"vlo"
+
+/* pseudo labels for "vlo" and for labels that are not used by LwM2M */
+#define SENML_LABEL_OBJLNK	INT8_MIN
+#define SENML_LABEL_UNKNOWN	INT8_MAX
+
+/* nesting limit for skipping unknown values */
+#define CBOR_MAX_DEPTH		4
+
+struct cbor_out_formatter_data {
+	/* object instance of the last base name */
+	uint16_t base_obj_id;
+	uint16_t base_obj_inst_id;
+
+	/* flags */
+	uint8_t writer_flags;
+	bool base_set : 1;
+};
+
+struct cbor_in_formatter_data {
+	/* value of the current record */
+	uint16_t value_offset;
+	uint16_t payload_offset;
+	uint16_t value_len;
+
+	/* base name and name of the current record */
+	char base_name[MAX_RESOURCE_LEN];
+	char name[MAX_RESOURCE_LEN];
+};
+
+/* CBOR encoding */
+
+static int cbor_put_head(struct lwm2m_output_context *out, uint8_t major,
+			 uint64_t value)
+{
+	uint8_t buf[9];
+	uint16_t len;
+
+	if (value < 24) {
+		buf[0] = (major << 5) | value;
+		len = 1U;
+	} else if (value <= UINT8_MAX) {
+		buf[0] = (major << 5) | 24;
+		buf[1] = value;
+		len = 2U;
+	} else if (value <= UINT16_MAX) {
+		buf[0] = (major << 5) | 25;
+		sys_put_be16(value, &buf[1]);
+		len = 3U;
+	} else if (value <= UINT32_MAX) {
+		buf[0] = (major << 5) | 26;
+		sys_put_be32(value, &buf[1]);
+		len = 5U;
+	} else {
+		buf[0] = (major << 5) | 27;
+		sys_put_be64(value, &buf[1]);
+		len = 9U;
+	}
+
+	if (buf_append(CPKT_BUF_WRITE(out->out_cpkt), buf, len) < 0) {
+		return -ENOMEM;
+	}
+
+	return len;
+}
+
+static int cbor_put_int(struct lwm2m_output_context *out, int64_t value)
+{
+	if (value < 0) {
+		return cbor_put_head(out, CBOR_MT_NINT, -(value + 1));
+	}
+
+	return cbor_put_head(out, CBOR_MT_UINT, value);
+}
+
+static int cbor_put_str(struct lwm2m_output_context *out, uint8_t major,
+			const void *data, size_t len)
+{
+	int ret;
+
+	ret = cbor_put_head(out, major, len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (buf_append(CPKT_BUF_WRITE(out->out_cpkt), data, len) < 0) {
+		return -ENOMEM;
+	}
+
+	return ret + len;
+}
+
+static int cbor_put_byte(struct lwm2m_output_context *out, uint8_t value)
+{
+	if (buf_append(CPKT_BUF_WRITE(out->out_cpkt), &value, 1) < 0) {
+		return -ENOMEM;
+	}
+
+	return 1;
+}
+
+/* Start a record map with the name of the path and the value label. The
+ * value has to be written by the caller.
+ */
+static int put_record_start(struct lwm2m_output_context *out,
+			    struct lwm2m_obj_path *path, int8_t label)
+{
+	struct cbor_out_formatter_data *fd;
+	char name[MAX_RESOURCE_LEN];
+	bool put_base;
+	int len, ret, total;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return -EINVAL;
+	}
+
+	put_base = !fd->base_set || fd->base_obj_id != path->obj_id ||
+		   fd->base_obj_inst_id != path->obj_inst_id;
+
+	total = cbor_put_head(out, CBOR_MT_MAP, put_base ? 3 : 2);
+	if (total < 0) {
+		return total;
+	}
+
+	if (put_base) {
+		len = snprintk(name, sizeof(name), "/%u/%u/", path->obj_id,
+			       path->obj_inst_id);
+
+		ret = cbor_put_int(out, SENML_LABEL_BN);
+		if (ret < 0) {
+			return ret;
+		}
+
+		total += ret;
+
+		ret = cbor_put_str(out, CBOR_MT_TSTR, name, len);
+		if (ret < 0) {
+			return ret;
+		}
+
+		total += ret;
+
+		fd->base_obj_id = path->obj_id;
+		fd->base_obj_inst_id = path->obj_inst_id;
+		fd->base_set = true;
+	}
+
+	if (fd->writer_flags & WRITER_RESOURCE_INSTANCE) {
+		len = snprintk(name, sizeof(name), "%u/%u", path->res_id,
+			       path->res_inst_id);
+	} else {
+		len = snprintk(name, sizeof(name), "%u", path->res_id);
+	}
+
+	ret = cbor_put_int(out, SENML_LABEL_N);
+	if (ret < 0) {
+		return ret;
+	}
+
+	total += ret;
+
+	ret = cbor_put_str(out, CBOR_MT_TSTR, name, len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	total += ret;
+
+	if (label == SENML_LABEL_OBJLNK) {
+		ret = cbor_put_str(out, CBOR_MT_TSTR, SENML_LABEL_VLO,
+				   strlen(SENML_LABEL_VLO));
+	} else {
+		ret = cbor_put_int(out, label);
+	}
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	return total + ret;
+}
+
+static size_t put_begin(struct lwm2m_output_context *out,
+			struct lwm2m_obj_path *path)
+{
+	struct cbor_out_formatter_data *fd;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	fd->base_set = false;
+
+	/* The number of records is not known up front */
+	if (cbor_put_byte(out, (CBOR_MT_ARRAY << 5) | CBOR_AI_INDEFINITE) < 0) {
+		return 0;
+	}
+
+	return 1;
+}
+
+static size_t put_end(struct lwm2m_output_context *out,
+		      struct lwm2m_obj_path *path)
+{
+	if (cbor_put_byte(out, CBOR_BREAK) < 0) {
+		return 0;
+	}
+
+	return 1;
+}
+
+static size_t put_begin_ri(struct lwm2m_output_context *out,
+			   struct lwm2m_obj_path *path)
+{
+	struct cbor_out_formatter_data *fd;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	fd->writer_flags |= WRITER_RESOURCE_INSTANCE;
+	return 0;
+}
+
+static size_t put_end_ri(struct lwm2m_output_context *out,
+			 struct lwm2m_obj_path *path)
+{
+	struct cbor_out_formatter_data *fd;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	fd->writer_flags &= ~WRITER_RESOURCE_INSTANCE;
+	return 0;
+}
+
+static size_t put_s64(struct lwm2m_output_context *out,
+		      struct lwm2m_obj_path *path, int64_t value)
+{
+	int len, ret;
+
+	len = put_record_start(out, path, SENML_LABEL_V);
+	if (len < 0) {
+		return 0;
+	}
+
+	ret = cbor_put_int(out, value);
+	if (ret < 0) {
+		return 0;
+	}
+
+	return len + ret;
+}
+
+static size_t put_s32(struct lwm2m_output_context *out,
+		      struct lwm2m_obj_path *path, int32_t value)
+{
+	return put_s64(out, path, (int64_t)value);
+}
+
+static size_t put_s16(struct lwm2m_output_context *out,
+		      struct lwm2m_obj_path *path, int16_t value)
+{
+	return put_s64(out, path, (int64_t)value);
+}
+
+static size_t put_s8(struct lwm2m_output_context *out,
+		     struct lwm2m_obj_path *path, int8_t value)
+{
+	return put_s64(out, path, (int64_t)value);
+}
+
+static size_t put_string(struct lwm2m_output_context *out,
+			 struct lwm2m_obj_path *path,
+			 char *buf, size_t buflen)
+{
+	int len, ret;
+
+	len = put_record_start(out, path, SENML_LABEL_VS);
+	if (len < 0) {
+		return 0;
+	}
+
+	ret = cbor_put_str(out, CBOR_MT_TSTR, buf, buflen);
+	if (ret < 0) {
+		return 0;
+	}
+
+	return len + ret;
+}
+
+static size_t put_opaque(struct lwm2m_output_context *out,
+			 struct lwm2m_obj_path *path,
+			 char *buf, size_t buflen)
+{
+	int len, ret;
+
+	len = put_record_start(out, path, SENML_LABEL_VD);
+	if (len < 0) {
+		return 0;
+	}
+
+	ret = cbor_put_str(out, CBOR_MT_BSTR, buf, buflen);
+	if (ret < 0) {
+		return 0;
+	}
+
+	return len + ret;
+}
+
+/* Floats are sent as IEEE 754 values, converted without FPU arithmetic */
+static size_t put_float32fix(struct lwm2m_output_context *out,
+			     struct lwm2m_obj_path *path,
+			     float32_value_t *value)
+{
+	uint8_t b32[5];
+	int len;
+
+	b32[0] = (CBOR_MT_SIMPLE << 5) | CBOR_FLOAT32;
+	if (lwm2m_f32_to_b32(value, &b32[1], 4) < 0) {
+		return 0;
+	}
+
+	len = put_record_start(out, path, SENML_LABEL_V);
+	if (len < 0) {
+		return 0;
+	}
+
+	if (buf_append(CPKT_BUF_WRITE(out->out_cpkt), b32, sizeof(b32)) < 0) {
+		return 0;
+	}
+
+	return len + sizeof(b32);
+}
+
+static size_t put_float64fix(struct lwm2m_output_context *out,
+			     struct lwm2m_obj_path *path,
+			     float64_value_t *value)
+{
+	uint8_t b64[9];
+	int len;
+
+	b64[0] = (CBOR_MT_SIMPLE << 5) | CBOR_FLOAT64;
+	if (lwm2m_f64_to_b64(value, &b64[1], 8) < 0) {
+		return 0;
+	}
+
+	len = put_record_start(out, path, SENML_LABEL_V);
+	if (len < 0) {
+		return 0;
+	}
+
+	if (buf_append(CPKT_BUF_WRITE(out->out_cpkt), b64, sizeof(b64)) < 0) {
+		return 0;
+	}
+
+	return len + sizeof(b64);
+}
+
+static size_t put_bool(struct lwm2m_output_context *out,
+		       struct lwm2m_obj_path *path,
+		       bool value)
+{
+	int len, ret;
+
+	len = put_record_start(out, path, SENML_LABEL_VB);
+	if (len < 0) {
+		return 0;
+	}
+
+	ret = cbor_put_byte(out, (CBOR_MT_SIMPLE << 5) |
+			    (value ? CBOR_TRUE : CBOR_FALSE));
+	if (ret < 0) {
+		return 0;
+	}
+
+	return len + ret;
+}
+
+static size_t put_objlnk(struct lwm2m_output_context *out,
+			 struct lwm2m_obj_path *path,
+			 struct lwm2m_objlnk *value)
+{
+	char buf[sizeof("65535:65535")];
+	int len, ret;
+
+	len = put_record_start(out, path, SENML_LABEL_OBJLNK);
+	if (len < 0) {
+		return 0;
+	}
+
+	ret = snprintk(buf, sizeof(buf), "%u:%u", value->obj_id,
+		       value->obj_inst);
+	ret = cbor_put_str(out, CBOR_MT_TSTR, buf, ret);
+	if (ret < 0) {
+		return 0;
+	}
+
+	return len + ret;
+}
+
+/* CBOR decoding */
+
+static int cbor_get_head(struct lwm2m_input_context *in, uint8_t *major,
+			 uint8_t *ai, uint64_t *value)
+{
+	uint8_t ib, buf[8];
+	int len;
+
+	if (in->offset >= in->in_cpkt->offset) {
+		return -ENODATA;
+	}
+
+	if (buf_read_u8(&ib, CPKT_BUF_READ(in->in_cpkt), &in->offset) < 0) {
+		return -ENODATA;
+	}
+
+	*major = ib >> 5;
+	*ai = ib & 0x1f;
+
+	if (*ai < 24 || *ai == CBOR_AI_INDEFINITE) {
+		*value = *ai;
+		return 0;
+	}
+
+	if (*ai > 27) {
+		return -EBADMSG;
+	}
+
+	len = 1 << (*ai - 24);
+	if (buf_read(buf, len, CPKT_BUF_READ(in->in_cpkt), &in->offset) < 0) {
+		return -ENODATA;
+	}
+
+	switch (len) {
+	case 1:
+		*value = buf[0];
+		break;
+	case 2:
+		*value = sys_get_be16(buf);
+		break;
+	case 4:
+		*value = sys_get_be32(buf);
+		break;
+	default:
+		*value = sys_get_be64(buf);
+		break;
+	}
+
+	return 0;
+}
+
+static bool cbor_is_break(struct lwm2m_input_context *in)
+{
+	uint8_t c;
+	uint16_t offset = in->offset;
+
+	if (buf_read_u8(&c, CPKT_BUF_READ(in->in_cpkt), &offset) < 0) {
+		return false;
+	}
+
+	if (c == CBOR_BREAK) {
+		in->offset = offset;
+		return true;
+	}
+
+	return false;
+}
+
+/* Skip one complete data item */
+static int cbor_skip(struct lwm2m_input_context *in, int depth)
+{
+	uint8_t major, ai;
+	uint64_t value, i;
+	int ret;
+
+	if (depth > CBOR_MAX_DEPTH) {
+		return -EBADMSG;
+	}
+
+	ret = cbor_get_head(in, &major, &ai, &value);
+	if (ret < 0) {
+		return ret;
+	}
+
+	switch (major) {
+	case CBOR_MT_BSTR:
+	case CBOR_MT_TSTR:
+		if (ai == CBOR_AI_INDEFINITE) {
+			while (!cbor_is_break(in)) {
+				ret = cbor_skip(in, depth + 1);
+				if (ret < 0) {
+					return ret;
+				}
+			}
+
+			return 0;
+		}
+
+		if (buf_skip(value, CPKT_BUF_READ(in->in_cpkt),
+			     &in->offset) < 0) {
+			return -ENODATA;
+		}
+
+		return 0;
+
+	case CBOR_MT_ARRAY:
+	case CBOR_MT_MAP:
+		if (ai == CBOR_AI_INDEFINITE) {
+			while (!cbor_is_break(in)) {
+				ret = cbor_skip(in, depth + 1);
+				if (ret < 0) {
+					return ret;
+				}
+			}
+
+			return 0;
+		}
+
+		if (major == CBOR_MT_MAP) {
+			value *= 2U;
+		}
+
+		for (i = 0; i < value; i++) {
+			ret = cbor_skip(in, depth + 1);
+			if (ret < 0) {
+				return ret;
+			}
+		}
+
+		return 0;
+
+	case CBOR_MT_TAG:
+		return cbor_skip(in, depth + 1);
+
+	default:
+		return 0;
+	}
+}
+
+/* Read a definite length text string into a NULL terminated buffer */
+static int cbor_get_text(struct lwm2m_input_context *in, char *buf,
+			 size_t buflen)
+{
+	uint8_t major, ai;
+	uint64_t len;
+	int ret;
+
+	ret = cbor_get_head(in, &major, &ai, &len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (major != CBOR_MT_TSTR || ai == CBOR_AI_INDEFINITE ||
+	    len >= buflen) {
+		return -EBADMSG;
+	}
+
+	if (buf_read((uint8_t *)buf, len, CPKT_BUF_READ(in->in_cpkt),
+		     &in->offset) < 0) {
+		return -ENODATA;
+	}
+
+	buf[len] = '\0';
+	return 0;
+}
+
+/* Parse the key of a record map entry into a SenML label */
+static int cbor_get_label(struct lwm2m_input_context *in, int8_t *label)
+{
+	char text[sizeof(SENML_LABEL_VLO)];
+	uint16_t offset = in->offset;
+	uint8_t major, ai;
+	uint64_t value;
+	int ret;
+
+	ret = cbor_get_head(in, &major, &ai, &value);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (major == CBOR_MT_UINT || major == CBOR_MT_NINT) {
+		if (value > INT8_MAX) {
+			*label = SENML_LABEL_UNKNOWN;
+		} else if (major == CBOR_MT_NINT) {
+			*label = -1 - (int8_t)value;
+		} else {
+			*label = value;
+		}
+
+		return 0;
+	}
+
+	if (major != CBOR_MT_TSTR) {
+		return -EBADMSG;
+	}
+
+	in->offset = offset;
+	if (cbor_get_text(in, text, sizeof(text)) == 0 &&
+	    strcmp(text, SENML_LABEL_VLO) == 0) {
+		*label = SENML_LABEL_OBJLNK;
+		return 0;
+	}
+
+	/* Skip the rest of an unknown text label */
+	in->offset = offset;
+	*label = SENML_LABEL_UNKNOWN;
+
+	return cbor_skip(in, 0);
+}
+
+/* Parse one record. The value is only located, it is decoded by the
+ * get_* functions once the engine knows the resource type.
+ */
+static int cbor_next_record(struct lwm2m_input_context *in,
+			    struct cbor_in_formatter_data *fd)
+{
+	uint8_t major, ai;
+	uint64_t count, i;
+	int8_t label;
+	int ret;
+
+	fd->name[0] = '\0';
+	fd->value_len = 0U;
+
+	ret = cbor_get_head(in, &major, &ai, &count);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (major != CBOR_MT_MAP) {
+		return -EBADMSG;
+	}
+
+	for (i = 0; ai == CBOR_AI_INDEFINITE || i < count; i++) {
+		if (ai == CBOR_AI_INDEFINITE && cbor_is_break(in)) {
+			break;
+		}
+
+		ret = cbor_get_label(in, &label);
+		if (ret < 0) {
+			return ret;
+		}
+
+		switch (label) {
+		case SENML_LABEL_BN:
+			ret = cbor_get_text(in, fd->base_name,
+					    sizeof(fd->base_name));
+			break;
+
+		case SENML_LABEL_N:
+			ret = cbor_get_text(in, fd->name, sizeof(fd->name));
+			break;
+
+		case SENML_LABEL_V:
+		case SENML_LABEL_VS:
+		case SENML_LABEL_VB:
+		case SENML_LABEL_VD:
+		case SENML_LABEL_OBJLNK:
+			fd->value_offset = in->offset;
+			ret = cbor_skip(in, 0);
+			fd->value_len = in->offset - fd->value_offset;
+			break;
+
+		default:
+			ret = cbor_skip(in, 0);
+			break;
+		}
+
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/* Decode the head of the located value */
+static int get_value_head(struct lwm2m_input_context *in, uint8_t *major,
+			  uint8_t *ai, uint64_t *value)
+{
+	struct cbor_in_formatter_data *fd;
+	uint16_t offset;
+	int ret;
+
+	fd = engine_get_in_user_data(in);
+	if (!fd || fd->value_len == 0U) {
+		return -ENODATA;
+	}
+
+	offset = in->offset;
+	in->offset = fd->value_offset;
+	ret = cbor_get_head(in, major, ai, value);
+
+	/* position of the string payload */
+	fd->payload_offset = in->offset;
+	in->offset = offset;
+
+	return ret;
+}
+
+/* Convert an IEEE 754 half precision value to single precision */
+static void half_to_b32(uint16_t half, uint8_t *b32)
+{
+	uint32_t sign = (half >> 15) & 0x1;
+	int32_t exp = (half >> 10) & 0x1f;
+	uint32_t frac = half & 0x3ff;
+	uint32_t bits;
+
+	if (exp == 0 && frac == 0) {
+		bits = sign << 31;
+	} else if (exp == 0) {
+		/* subnormal, normalize it */
+		exp = 1;
+		while (!(frac & 0x400)) {
+			frac <<= 1;
+			exp--;
+		}
+
+		frac &= 0x3ff;
+		bits = (sign << 31) | ((exp + 112) << 23) | (frac << 13);
+	} else if (exp == 0x1f) {
+		bits = (sign << 31) | (0xffU << 23) | (frac << 13);
+	} else {
+		bits = (sign << 31) | ((exp + 112) << 23) | (frac << 13);
+	}
+
+	sys_put_be32(bits, b32);
+}
+
+/* Read a numeric value as a float64 fixed point value */
+static size_t get_number(struct lwm2m_input_context *in,
+			 float64_value_t *value)
+{
+	struct cbor_in_formatter_data *fd;
+	float32_value_t f32;
+	uint8_t major, ai, buf[8];
+	uint64_t raw;
+
+	if (get_value_head(in, &major, &ai, &raw) < 0) {
+		return 0;
+	}
+
+	fd = engine_get_in_user_data(in);
+	value->val1 = 0;
+	value->val2 = 0;
+
+	switch (major) {
+	case CBOR_MT_UINT:
+		value->val1 = (int64_t)raw;
+		break;
+
+	case CBOR_MT_NINT:
+		value->val1 = -1 - (int64_t)raw;
+		break;
+
+	case CBOR_MT_SIMPLE:
+		/* The float bits are the argument of the head */
+		if (ai == CBOR_FLOAT64) {
+			sys_put_be64(raw, buf);
+			if (lwm2m_b64_to_f64(buf, 8, value) < 0) {
+				return 0;
+			}
+
+			break;
+		}
+
+		if (ai == CBOR_FLOAT16) {
+			half_to_b32(raw, buf);
+		} else if (ai == CBOR_FLOAT32) {
+			sys_put_be32(raw, buf);
+		} else {
+			return 0;
+		}
+
+		if (lwm2m_b32_to_f32(buf, 4, &f32) < 0) {
+			return 0;
+		}
+
+		value->val1 = f32.val1;
+		value->val2 = (int64_t)f32.val2 *
+			      (LWM2M_FLOAT64_DEC_MAX / LWM2M_FLOAT32_DEC_MAX);
+		break;
+
+	default:
+		return 0;
+	}
+
+	return fd->value_len;
+}
+
+static size_t get_s64(struct lwm2m_input_context *in, int64_t *value)
+{
+	float64_value_t f64;
+	size_t len;
+
+	len = get_number(in, &f64);
+	if (len > 0) {
+		*value = f64.val1;
+	}
+
+	return len;
+}
+
+static size_t get_s32(struct lwm2m_input_context *in, int32_t *value)
+{
+	float64_value_t f64;
+	size_t len;
+
+	len = get_number(in, &f64);
+	if (len > 0) {
+		*value = (int32_t)f64.val1;
+	}
+
+	return len;
+}
+
+static size_t get_float32fix(struct lwm2m_input_context *in,
+			     float32_value_t *value)
+{
+	float64_value_t f64;
+	size_t len;
+
+	len = get_number(in, &f64);
+	if (len > 0) {
+		value->val1 = (int32_t)f64.val1;
+		value->val2 = (int32_t)(f64.val2 / (LWM2M_FLOAT64_DEC_MAX /
+						    LWM2M_FLOAT32_DEC_MAX));
+	}
+
+	return len;
+}
+
+static size_t get_float64fix(struct lwm2m_input_context *in,
+			     float64_value_t *value)
+{
+	return get_number(in, value);
+}
+
+static size_t get_bool(struct lwm2m_input_context *in, bool *value)
+{
+	struct cbor_in_formatter_data *fd;
+	uint8_t major, ai;
+	uint64_t raw;
+
+	if (get_value_head(in, &major, &ai, &raw) < 0 ||
+	    major != CBOR_MT_SIMPLE || (ai != CBOR_TRUE && ai != CBOR_FALSE)) {
+		return 0;
+	}
+
+	fd = engine_get_in_user_data(in);
+	*value = ai == CBOR_TRUE;
+
+	return fd->value_len;
+}
+
+static size_t get_string(struct lwm2m_input_context *in,
+			 uint8_t *buf, size_t buflen)
+{
+	struct cbor_in_formatter_data *fd;
+	uint8_t major, ai;
+	uint64_t len;
+	uint16_t offset;
+
+	if (buflen == 0U ||
+	    get_value_head(in, &major, &ai, &len) < 0 ||
+	    (major != CBOR_MT_TSTR && major != CBOR_MT_BSTR) ||
+	    ai == CBOR_AI_INDEFINITE) {
+		return 0;
+	}
+
+	fd = engine_get_in_user_data(in);
+	offset = fd->payload_offset;
+
+	if (len > buflen - 1) {
+		len = buflen - 1;
+	}
+
+	if (buf_read(buf, len, CPKT_BUF_READ(in->in_cpkt), &offset) < 0) {
+		return 0;
+	}
+
+	buf[len] = '\0';
+	return len;
+}
+
+static size_t get_opaque(struct lwm2m_input_context *in,
+			 uint8_t *value, size_t buflen,
+			 struct lwm2m_opaque_context *opaque,
+			 bool *last_block)
+{
+	struct cbor_in_formatter_data *fd;
+	uint8_t major, ai;
+	uint64_t len;
+
+	/* Locate the byte string only on first read */
+	if (opaque->remaining == 0) {
+		if (get_value_head(in, &major, &ai, &len) < 0 ||
+		    (major != CBOR_MT_BSTR && major != CBOR_MT_TSTR) ||
+		    ai == CBOR_AI_INDEFINITE) {
+			return 0;
+		}
+
+		fd = engine_get_in_user_data(in);
+		in->offset = fd->payload_offset;
+		opaque->len = len;
+		opaque->remaining = len;
+	}
+
+	return lwm2m_engine_get_opaque_more(in, value, buflen,
+					    opaque, last_block);
+}
+
+static size_t get_objlnk(struct lwm2m_input_context *in,
+			 struct lwm2m_objlnk *value)
+{
+	char buf[sizeof("65535:65535")];
+	char *end;
+	size_t len;
+
+	len = get_string(in, (uint8_t *)buf, sizeof(buf));
+	if (len == 0) {
+		return 0;
+	}
+
+	value->obj_id = strtoul(buf, &end, 10);
+	if (*end != ':') {
+		return 0;
+	}
+
+	value->obj_inst = strtoul(end + 1, NULL, 10);
+
+	return len;
+}
+
+const struct lwm2m_writer senml_cbor_writer = {
+	.put_begin = put_begin,
+	.put_end = put_end,
+	.put_begin_ri = put_begin_ri,
+	.put_end_ri = put_end_ri,
+	.put_s8 = put_s8,
+	.put_s16 = put_s16,
+	.put_s32 = put_s32,
+	.put_s64 = put_s64,
+	.put_string = put_string,
+	.put_float32fix = put_float32fix,
+	.put_float64fix = put_float64fix,
+	.put_bool = put_bool,
+	.put_opaque = put_opaque,
+	.put_objlnk = put_objlnk,
+};
+
+const struct lwm2m_reader senml_cbor_reader = {
+	.get_s32 = get_s32,
+	.get_s64 = get_s64,
+	.get_string = get_string,
+	.get_float32fix = get_float32fix,
+	.get_float64fix = get_float64fix,
+	.get_bool = get_bool,
+	.get_opaque = get_opaque,
+	.get_objlnk = get_objlnk,
+};
+
+int do_read_op_senml_cbor(struct lwm2m_message *msg, int content_format)
+{
+	struct cbor_out_formatter_data fd;
+	int ret;
+
+	(void)memset(&fd, 0, sizeof(fd));
+	engine_set_out_user_data(&msg->out, &fd);
+	ret = lwm2m_perform_read_op(msg, content_format);
+	engine_clear_out_user_data(&msg->out);
+
+	return ret;
+}
+
+int do_composite_read_op_senml_cbor(struct lwm2m_message *msg,
+				    int content_format,
+				    struct lwm2m_obj_path *paths,
+				    int path_count)
+{
+	struct cbor_out_formatter_data fd;
+	int ret;
+
+	(void)memset(&fd, 0, sizeof(fd));
+	engine_set_out_user_data(&msg->out, &fd);
+	ret = lwm2m_perform_composite_read_op(msg, content_format, paths,
+					      path_count);
+	engine_clear_out_user_data(&msg->out);
+
+	return ret;
+}
+
+/* Go through the records of the payload, calling cb for each of them with
+ * msg->path set to the full name of the record.
+ */
+static int senml_cbor_foreach_record(struct lwm2m_message *msg,
+				     struct cbor_in_formatter_data *fd,
+				     int (*cb)(struct lwm2m_message *msg,
+					       void *user_data),
+				     void *user_data)
+{
+	char full_name[MAX_RESOURCE_LEN * 2];
+	uint8_t major, ai;
+	uint64_t count, i;
+	uint16_t next;
+	int ret;
+
+	ret = cbor_get_head(&msg->in, &major, &ai, &count);
+	if (ret < 0 || major != CBOR_MT_ARRAY) {
+		return -EBADMSG;
+	}
+
+	for (i = 0; ai == CBOR_AI_INDEFINITE || i < count; i++) {
+		if (ai == CBOR_AI_INDEFINITE && cbor_is_break(&msg->in)) {
+			break;
+		}
+
+		ret = cbor_next_record(&msg->in, fd);
+		if (ret < 0) {
+			return -EBADMSG;
+		}
+
+		snprintk(full_name, sizeof(full_name), "%s%s", fd->base_name,
+			 fd->name);
+
+		ret = lwm2m_name_to_path(full_name, strlen(full_name),
+					 &msg->path);
+		if (ret < 0) {
+			LOG_ERR("Invalid record name %s",
+				log_strdup(full_name));
+			return -EBADMSG;
+		}
+
+		/* The value might be read with in->offset */
+		next = msg->in.offset;
+		ret = cb(msg, user_data);
+		msg->in.offset = next;
+
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static int write_record(struct lwm2m_message *msg, void *user_data)
+{
+	struct lwm2m_obj_path *orig_path = user_data;
+	struct cbor_in_formatter_data *fd;
+	int ret;
+
+	fd = engine_get_in_user_data(&msg->in);
+	if (fd->value_len == 0U) {
+		return 0;
+	}
+
+	ret = lwm2m_write_resource_path(msg);
+	if (ret < 0 && orig_path->level >= 3U) {
+		/* return errors on a single write */
+		return ret;
+	}
+
+	return 0;
+}
+
+int do_write_op_senml_cbor(struct lwm2m_message *msg)
+{
+	struct cbor_in_formatter_data fd;
+	struct lwm2m_obj_path orig_path;
+	int ret;
+
+	(void)memset(&fd, 0, sizeof(fd));
+	engine_set_in_user_data(&msg->in, &fd);
+
+	/* store a copy of the original path */
+	memcpy(&orig_path, &msg->path, sizeof(msg->path));
+
+	ret = senml_cbor_foreach_record(msg, &fd, write_record, &orig_path);
+
+	memcpy(&msg->path, &orig_path, sizeof(msg->path));
+	engine_clear_in_user_data(&msg->in);
+
+	return ret;
+}
+
+struct path_list {
+	struct lwm2m_obj_path *paths;
+	int max_paths;
+	int count;
+};
+
+static int add_path(struct lwm2m_message *msg, void *user_data)
+{
+	struct path_list *list = user_data;
+
+	if (list->count >= list->max_paths) {
+		return -ENOMEM;
+	}
+
+	list->paths[list->count++] = msg->path;
+
+	return 0;
+}
+
+int senml_cbor_get_path_list(struct lwm2m_message *msg,
+			     struct lwm2m_obj_path *paths, int max_paths)
+{
+	struct cbor_in_formatter_data fd;
+	struct lwm2m_obj_path orig_path;
+	struct path_list list = {
+		.paths = paths,
+		.max_paths = max_paths,
+	};
+	int ret;
+
+	(void)memset(&fd, 0, sizeof(fd));
+	engine_set_in_user_data(&msg->in, &fd);
+	memcpy(&orig_path, &msg->path, sizeof(msg->path));
+
+	ret = senml_cbor_foreach_record(msg, &fd, add_path, &list);
+
+	memcpy(&msg->path, &orig_path, sizeof(msg->path));
+	engine_clear_in_user_data(&msg->in);
+
+	return ret < 0 ? ret : list.count;
+}
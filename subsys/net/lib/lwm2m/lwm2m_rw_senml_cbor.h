@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef LWM2M_RW_SENML_CBOR_H_
+#define LWM2M_RW_SENML_CBOR_H_
+
+#include "lwm2m_object.h"
+
+extern const struct lwm2m_writer senml_cbor_writer;
+extern const struct lwm2m_reader senml_cbor_reader;
+
+int do_read_op_senml_cbor(struct lwm2m_message *msg, int content_format);
+int do_write_op_senml_cbor(struct lwm2m_message *msg);
+
+int do_composite_read_op_senml_cbor(struct lwm2m_message *msg,
+				    int content_format,
+				    struct lwm2m_obj_path *paths,
+				    int path_count);
+int senml_cbor_get_path_list(struct lwm2m_message *msg,
+			     struct lwm2m_obj_path *paths, int max_paths);
+
+#endif /* LWM2M_RW_SENML_CBOR_H_ */
@@ -0,0 +1,1196 @@
+/** @file
+ * @brief LwM2M SenML-JSON content format (RFC 8428)
+ *
+ * Records are written with names relative to the last base name, which is
+ * only repeated when the object instance changes. Opaque values use base64url
+ * encoding without padding as required by the SenML "vd" field.
+ */
+
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define LOG_MODULE_NAME net_lwm2m_senml_json
+#define LOG_LEVEL CONFIG_LWM2M_LOG_LEVEL
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(LOG_MODULE_NAME);
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/base64.h>
+
+#include "lwm2m_object.h"
+#include "lwm2m_rw_senml_json.h"
+#include "lwm2m_rw_plain_text.h"
+#include "lwm2m_engine.h"
+#include "lwm2m_util.h"
+
+#define SEPARATOR(f)	((f & WRITER_OUTPUT_VALUE) ? "," : "")
+
+#define TOKEN_BUF_LEN	64
+
+/* base64 is encoded and decoded in chunks of this many characters */
+#define BASE64_CHUNK_LEN	64
+
+/* value labels of a record */
+enum senml_value {
+	SENML_VALUE_NONE,
+	SENML_VALUE_NUMBER,
+	SENML_VALUE_STRING,
+	SENML_VALUE_BOOL,
+	SENML_VALUE_DATA,
+	SENML_VALUE_OBJLNK,
+};
+
+struct senml_json_out_formatter_data {
+	/* object instance of the last base name */
+	uint16_t base_obj_id;
+	uint16_t base_obj_inst_id;
+
+	/* flags */
+	uint8_t writer_flags;
+	bool base_set : 1;
+};
+
+struct senml_json_in_formatter_data {
+	/* value of the current record, without quotes */
+	uint16_t value_offset;
+	uint16_t value_len;
+	uint8_t value_type;
+
+	/* base name and name of the current record */
+	char base_name[MAX_RESOURCE_LEN];
+	char name[MAX_RESOURCE_LEN];
+};
+
+/* some temporary buffer space for format conversions */
+static char json_buffer[TOKEN_BUF_LEN];
+
+static int put_char(struct lwm2m_output_context *out, char c)
+{
+	if (buf_append(CPKT_BUF_WRITE(out->out_cpkt), &c, sizeof(c)) < 0) {
+		return -ENOMEM;
+	}
+
+	return 1;
+}
+
+static size_t put_begin(struct lwm2m_output_context *out,
+			struct lwm2m_obj_path *path)
+{
+	struct senml_json_out_formatter_data *fd;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	fd->base_set = false;
+	fd->writer_flags &= ~WRITER_OUTPUT_VALUE;
+
+	return put_char(out, '[');
+}
+
+static size_t put_end(struct lwm2m_output_context *out,
+		      struct lwm2m_obj_path *path)
+{
+	return put_char(out, ']');
+}
+
+static size_t put_begin_ri(struct lwm2m_output_context *out,
+			   struct lwm2m_obj_path *path)
+{
+	struct senml_json_out_formatter_data *fd;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	fd->writer_flags |= WRITER_RESOURCE_INSTANCE;
+	return 0;
+}
+
+static size_t put_end_ri(struct lwm2m_output_context *out,
+			 struct lwm2m_obj_path *path)
+{
+	struct senml_json_out_formatter_data *fd;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	fd->writer_flags &= ~WRITER_RESOURCE_INSTANCE;
+	return 0;
+}
+
+static int put_json_prefix(struct lwm2m_output_context *out,
+			   struct lwm2m_obj_path *path,
+			   const char *label)
+{
+	struct senml_json_out_formatter_data *fd;
+	char *sep;
+	int len, ret;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	sep = SEPARATOR(fd->writer_flags);
+
+	if (!fd->base_set || fd->base_obj_id != path->obj_id ||
+	    fd->base_obj_inst_id != path->obj_inst_id) {
+		len = snprintk(json_buffer, sizeof(json_buffer),
+			       "%s{\"bn\":\"/%u/%u/\",", sep, path->obj_id,
+			       path->obj_inst_id);
+		fd->base_obj_id = path->obj_id;
+		fd->base_obj_inst_id = path->obj_inst_id;
+		fd->base_set = true;
+	} else {
+		len = snprintk(json_buffer, sizeof(json_buffer), "%s{", sep);
+	}
+
+	if (fd->writer_flags & WRITER_RESOURCE_INSTANCE) {
+		ret = snprintk(json_buffer + len, sizeof(json_buffer) - len,
+			       "\"n\":\"%u/%u\",\"%s\":", path->res_id,
+			       path->res_inst_id, label);
+	} else {
+		ret = snprintk(json_buffer + len, sizeof(json_buffer) - len,
+			       "\"n\":\"%u\",\"%s\":", path->res_id, label);
+	}
+
+	if (ret < 0 || ret >= sizeof(json_buffer) - len) {
+		return -ENOMEM;
+	}
+
+	len += ret;
+
+	if (buf_append(CPKT_BUF_WRITE(out->out_cpkt), json_buffer, len) < 0) {
+		return -ENOMEM;
+	}
+
+	return len;
+}
+
+static int put_json_postfix(struct lwm2m_output_context *out)
+{
+	struct senml_json_out_formatter_data *fd;
+
+	fd = engine_get_out_user_data(out);
+	if (!fd) {
+		return 0;
+	}
+
+	if (put_char(out, '}') < 0) {
+		return -ENOMEM;
+	}
+
+	fd->writer_flags |= WRITER_OUTPUT_VALUE;
+	return 1;
+}
+
+/* Write a record with a value already formatted by the plain text writer */
+static size_t put_json_record(struct lwm2m_output_context *out,
+			      struct lwm2m_obj_path *path, const char *label,
+			      const char *fmt, ...)
+{
+	va_list vargs;
+	int len, ret;
+
+	len = put_json_prefix(out, path, label);
+	if (len < 0) {
+		return len;
+	}
+
+	va_start(vargs, fmt);
+	ret = vsnprintk(json_buffer, sizeof(json_buffer), fmt, vargs);
+	va_end(vargs);
+
+	if (ret < 0 || ret >= sizeof(json_buffer)) {
+		return -ENOMEM;
+	}
+
+	if (buf_append(CPKT_BUF_WRITE(out->out_cpkt), json_buffer, ret) < 0) {
+		return -ENOMEM;
+	}
+
+	len += ret;
+
+	ret = put_json_postfix(out);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return len + ret;
+}
+
+static size_t put_s64(struct lwm2m_output_context *out,
+		      struct lwm2m_obj_path *path, int64_t value)
+{
+	return put_json_record(out, path, "v", "%lld", value);
+}
+
+static size_t put_s32(struct lwm2m_output_context *out,
+		      struct lwm2m_obj_path *path, int32_t value)
+{
+	return put_s64(out, path, (int64_t)value);
+}
+
+static size_t put_s16(struct lwm2m_output_context *out,
+		      struct lwm2m_obj_path *path, int16_t value)
+{
+	return put_s64(out, path, (int64_t)value);
+}
+
+static size_t put_s8(struct lwm2m_output_context *out,
+		     struct lwm2m_obj_path *path, int8_t value)
+{
+	return put_s64(out, path, (int64_t)value);
+}
+
+static size_t put_string(struct lwm2m_output_context *out,
+			 struct lwm2m_obj_path *path,
+			 char *buf, size_t buflen)
+{
+	size_t i;
+	int len, res;
+
+	len = put_json_prefix(out, path, "vs");
+	if (len < 0) {
+		return len;
+	}
+
+	if (put_char(out, '"') < 0) {
+		return -ENOMEM;
+	}
+
+	len++;
+
+	for (i = 0; i < buflen; ++i) {
+		/* Escape special characters */
+		if ((uint8_t)buf[i] < 0x20) {
+			res = snprintk(json_buffer, sizeof(json_buffer),
+				       "\\u%04x", buf[i]);
+			if (buf_append(CPKT_BUF_WRITE(out->out_cpkt),
+				       json_buffer, res) < 0) {
+				return -ENOMEM;
+			}
+
+			len += res;
+			continue;
+		} else if (buf[i] == '"' || buf[i] == '\\') {
+			if (put_char(out, '\\') < 0) {
+				return -ENOMEM;
+			}
+
+			len++;
+		}
+
+		if (put_char(out, buf[i]) < 0) {
+			return -ENOMEM;
+		}
+
+		len++;
+	}
+
+	if (put_char(out, '"') < 0) {
+		return -ENOMEM;
+	}
+
+	res = put_json_postfix(out);
+	if (res < 0) {
+		return res;
+	}
+
+	return len + 1 + res;
+}
+
+static size_t put_opaque(struct lwm2m_output_context *out,
+			 struct lwm2m_obj_path *path,
+			 char *buf, size_t buflen)
+{
+	uint8_t encoded[BASE64_CHUNK_LEN + 1];
+	size_t chunk, olen, i;
+	int len, ret;
+
+	len = put_json_prefix(out, path, "vd");
+	if (len < 0) {
+		return len;
+	}
+
+	if (put_char(out, '"') < 0) {
+		return -ENOMEM;
+	}
+
+	len++;
+
+	/* 48 bytes encode to 64 characters without padding */
+	while (buflen > 0) {
+		chunk = MIN(buflen, BASE64_CHUNK_LEN / 4 * 3);
+		if (base64_encode(encoded, sizeof(encoded), &olen,
+				  (uint8_t *)buf, chunk) < 0) {
+			return -EINVAL;
+		}
+
+		/* convert to base64url and strip the padding */
+		while (olen > 0 && encoded[olen - 1] == '=') {
+			olen--;
+		}
+
+		for (i = 0; i < olen; i++) {
+			if (encoded[i] == '+') {
+				encoded[i] = '-';
+			} else if (encoded[i] == '/') {
+				encoded[i] = '_';
+			}
+		}
+
+		if (buf_append(CPKT_BUF_WRITE(out->out_cpkt), encoded,
+			       olen) < 0) {
+			return -ENOMEM;
+		}
+
+		len += olen;
+		buf += chunk;
+		buflen -= chunk;
+	}
+
+	if (put_char(out, '"') < 0) {
+		return -ENOMEM;
+	}
+
+	ret = put_json_postfix(out);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return len + 1 + ret;
+}
+
+static size_t put_float32fix(struct lwm2m_output_context *out,
+			     struct lwm2m_obj_path *path,
+			     float32_value_t *value)
+{
+	int len, ret;
+
+	len = put_json_prefix(out, path, "v");
+	if (len < 0) {
+		return len;
+	}
+
+	ret = plain_text_put_float32fix(out, path, value);
+	if (ret == 0) {
+		return -ENOMEM;
+	}
+
+	len += ret;
+
+	ret = put_json_postfix(out);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return len + ret;
+}
+
+static size_t put_float64fix(struct lwm2m_output_context *out,
+			     struct lwm2m_obj_path *path,
+			     float64_value_t *value)
+{
+	int len, ret;
+
+	len = put_json_prefix(out, path, "v");
+	if (len < 0) {
+		return len;
+	}
+
+	ret = plain_text_put_float64fix(out, path, value);
+	if (ret == 0) {
+		return -ENOMEM;
+	}
+
+	len += ret;
+
+	ret = put_json_postfix(out);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return len + ret;
+}
+
+static size_t put_bool(struct lwm2m_output_context *out,
+		       struct lwm2m_obj_path *path,
+		       bool value)
+{
+	return put_json_record(out, path, "vb", "%s",
+			       value ? "true" : "false");
+}
+
+static size_t put_objlnk(struct lwm2m_output_context *out,
+			 struct lwm2m_obj_path *path,
+			 struct lwm2m_objlnk *value)
+{
+	return put_json_record(out, path, "vlo", "\"%u:%u\"", value->obj_id,
+			       value->obj_inst);
+}
+
+/* JSON parsing */
+
+static int json_peek(struct lwm2m_input_context *in, uint8_t *c)
+{
+	uint16_t offset;
+
+	/* skip whitespace */
+	while (in->offset < in->in_cpkt->offset) {
+		offset = in->offset;
+		if (buf_read_u8(c, CPKT_BUF_READ(in->in_cpkt), &offset) < 0) {
+			return -ENODATA;
+		}
+
+		if (*c != ' ' && *c != '\t' && *c != '\r' && *c != '\n') {
+			return 0;
+		}
+
+		in->offset = offset;
+	}
+
+	return -ENODATA;
+}
+
+static int json_expect(struct lwm2m_input_context *in, uint8_t expected)
+{
+	uint8_t c;
+
+	if (json_peek(in, &c) < 0 || c != expected) {
+		return -EBADMSG;
+	}
+
+	in->offset++;
+	return 0;
+}
+
+/* Locate a string value, in->offset is left after the closing quote */
+static int json_get_string(struct lwm2m_input_context *in,
+			   uint16_t *offset, uint16_t *len)
+{
+	bool escape = false;
+	uint8_t c;
+	int ret;
+
+	ret = json_expect(in, '"');
+	if (ret < 0) {
+		return ret;
+	}
+
+	*offset = in->offset;
+
+	while (buf_read_u8(&c, CPKT_BUF_READ(in->in_cpkt), &in->offset) == 0 &&
+	       in->offset <= in->in_cpkt->offset) {
+		if (escape) {
+			escape = false;
+		} else if (c == '\\') {
+			escape = true;
+		} else if (c == '"') {
+			*len = in->offset - *offset - 1;
+			return 0;
+		}
+	}
+
+	return -EBADMSG;
+}
+
+/* Locate a number or literal value */
+static int json_get_literal(struct lwm2m_input_context *in,
+			    uint16_t *offset, uint16_t *len)
+{
+	uint8_t c;
+
+	*offset = in->offset;
+
+	while (in->offset < in->in_cpkt->offset) {
+		if (buf_read_u8(&c, CPKT_BUF_READ(in->in_cpkt),
+				&in->offset) < 0) {
+			return -EBADMSG;
+		}
+
+		if (c == ',' || c == '}' || c == ' ' || c == '\t' ||
+		    c == '\r' || c == '\n') {
+			in->offset--;
+			break;
+		}
+	}
+
+	*len = in->offset - *offset;
+
+	return *len > 0 ? 0 : -EBADMSG;
+}
+
+static int json_copy_string(struct lwm2m_input_context *in, char *buf,
+			    size_t buflen)
+{
+	uint16_t offset, len;
+	int ret;
+
+	ret = json_get_string(in, &offset, &len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (len >= buflen) {
+		return -EBADMSG;
+	}
+
+	if (buf_read((uint8_t *)buf, len, CPKT_BUF_READ(in->in_cpkt),
+		     &offset) < 0) {
+		return -EBADMSG;
+	}
+
+	buf[len] = '\0';
+	return 0;
+}
+
+/* Parse one record. The value is only located, it is decoded by the
+ * get_* functions once the engine knows the resource type.
+ */
+static int json_next_record(struct lwm2m_input_context *in,
+			    struct senml_json_in_formatter_data *fd)
+{
+	char label[sizeof("vlo")];
+	uint16_t offset, len;
+	uint8_t c;
+	int ret;
+
+	fd->name[0] = '\0';
+	fd->value_type = SENML_VALUE_NONE;
+
+	ret = json_expect(in, '{');
+	if (ret < 0) {
+		return ret;
+	}
+
+	while (true) {
+		if (json_peek(in, &c) < 0) {
+			return -EBADMSG;
+		}
+
+		if (c == '}') {
+			in->offset++;
+			return 0;
+		}
+
+		if (c == ',') {
+			in->offset++;
+			continue;
+		}
+
+		/* unknown labels are longer than the buffer, skip them */
+		ret = json_copy_string(in, label, sizeof(label));
+		if (ret < 0) {
+			label[0] = '\0';
+		}
+
+		ret = json_expect(in, ':');
+		if (ret < 0) {
+			return ret;
+		}
+
+		if (strcmp(label, "bn") == 0) {
+			ret = json_copy_string(in, fd->base_name,
+					       sizeof(fd->base_name));
+			if (ret < 0) {
+				return ret;
+			}
+
+			continue;
+		}
+
+		if (strcmp(label, "n") == 0) {
+			ret = json_copy_string(in, fd->name, sizeof(fd->name));
+			if (ret < 0) {
+				return ret;
+			}
+
+			continue;
+		}
+
+		if (json_peek(in, &c) < 0) {
+			return -EBADMSG;
+		}
+
+		if (c == '"') {
+			ret = json_get_string(in, &offset, &len);
+		} else {
+			ret = json_get_literal(in, &offset, &len);
+		}
+
+		if (ret < 0) {
+			return ret;
+		}
+
+		if (strcmp(label, "v") == 0) {
+			fd->value_type = SENML_VALUE_NUMBER;
+		} else if (strcmp(label, "vs") == 0) {
+			fd->value_type = SENML_VALUE_STRING;
+		} else if (strcmp(label, "vb") == 0) {
+			fd->value_type = SENML_VALUE_BOOL;
+		} else if (strcmp(label, "vd") == 0) {
+			fd->value_type = SENML_VALUE_DATA;
+		} else if (strcmp(label, "vlo") == 0) {
+			fd->value_type = SENML_VALUE_OBJLNK;
+		} else {
+			/* ignore time and other labels */
+			continue;
+		}
+
+		fd->value_offset = offset;
+		fd->value_len = len;
+	}
+}
+
+/* Read a JSON number as a float64 fixed point value */
+static size_t read_number(struct lwm2m_input_context *in,
+			  float64_value_t *value)
+{
+	struct senml_json_in_formatter_data *fd;
+	int64_t frac_div = LWM2M_FLOAT64_DEC_MAX / 10;
+	int exp = 0, exp_sign = 1;
+	bool neg = false, dot = false, in_exp = false;
+	uint8_t *buf;
+	size_t i;
+	char c;
+
+	fd = engine_get_in_user_data(in);
+	if (!fd || fd->value_type == SENML_VALUE_NONE) {
+		return 0;
+	}
+
+	value->val1 = 0;
+	value->val2 = 0;
+	buf = in->in_cpkt->data + fd->value_offset;
+
+	for (i = 0; i < fd->value_len; i++) {
+		c = buf[i];
+		if (c == '-' && i == 0) {
+			neg = true;
+		} else if (c == '.' && !dot && !in_exp) {
+			dot = true;
+		} else if ((c == 'e' || c == 'E') && !in_exp) {
+			in_exp = true;
+		} else if (in_exp && (c == '-' || c == '+')) {
+			exp_sign = c == '-' ? -1 : 1;
+		} else if (c >= '0' && c <= '9') {
+			if (in_exp) {
+				exp = exp * 10 + (c - '0');
+			} else if (dot) {
+				value->val2 += (c - '0') * frac_div;
+				frac_div /= 10;
+			} else {
+				value->val1 = value->val1 * 10 + (c - '0');
+			}
+		} else {
+			return 0;
+		}
+	}
+
+	/* apply the exponent to the fixed point value */
+	for (exp *= exp_sign; exp > 0; exp--) {
+		value->val1 = value->val1 * 10 +
+			      value->val2 / (LWM2M_FLOAT64_DEC_MAX / 10);
+		value->val2 = value->val2 % (LWM2M_FLOAT64_DEC_MAX / 10) * 10;
+	}
+
+	for (; exp < 0; exp++) {
+		value->val2 = value->val2 / 10 + value->val1 % 10 *
+			      (LWM2M_FLOAT64_DEC_MAX / 10);
+		value->val1 /= 10;
+	}
+
+	/* the sign is kept in val2 only when val1 is 0 */
+	if (neg && value->val1 != 0) {
+		value->val1 = -value->val1;
+	} else if (neg) {
+		value->val2 = -value->val2;
+	}
+
+	return fd->value_len;
+}
+
+static size_t get_s64(struct lwm2m_input_context *in, int64_t *value)
+{
+	float64_value_t f64;
+	size_t len;
+
+	len = read_number(in, &f64);
+	if (len > 0) {
+		*value = f64.val1;
+	}
+
+	return len;
+}
+
+static size_t get_s32(struct lwm2m_input_context *in, int32_t *value)
+{
+	float64_value_t f64;
+	size_t len;
+
+	len = read_number(in, &f64);
+	if (len > 0) {
+		*value = (int32_t)f64.val1;
+	}
+
+	return len;
+}
+
+static size_t get_float32fix(struct lwm2m_input_context *in,
+			     float32_value_t *value)
+{
+	float64_value_t f64;
+	size_t len;
+
+	len = read_number(in, &f64);
+	if (len > 0) {
+		value->val1 = (int32_t)f64.val1;
+		value->val2 = (int32_t)(f64.val2 / (LWM2M_FLOAT64_DEC_MAX /
+						    LWM2M_FLOAT32_DEC_MAX));
+	}
+
+	return len;
+}
+
+static size_t get_float64fix(struct lwm2m_input_context *in,
+			     float64_value_t *value)
+{
+	return read_number(in, value);
+}
+
+/* Decode the four hex digits of a \u escape at offset as UTF-8. Surrogate
+ * pairs are not supported.
+ */
+static int json_get_unicode(struct lwm2m_input_context *in, uint16_t *offset,
+			    uint8_t *buf, size_t buflen)
+{
+	char hex[5];
+	char *end;
+	uint32_t code;
+
+	if (buf_read((uint8_t *)hex, 4, CPKT_BUF_READ(in->in_cpkt),
+		     offset) < 0) {
+		return -EBADMSG;
+	}
+
+	hex[4] = '\0';
+	code = strtoul(hex, &end, 16);
+	if (end != &hex[4]) {
+		return -EBADMSG;
+	}
+
+	if (code < 0x80) {
+		if (buflen < 1) {
+			return -ENOMEM;
+		}
+
+		buf[0] = code;
+		return 1;
+	}
+
+	if (code < 0x800) {
+		if (buflen < 2) {
+			return -ENOMEM;
+		}
+
+		buf[0] = 0xc0 | (code >> 6);
+		buf[1] = 0x80 | (code & 0x3f);
+		return 2;
+	}
+
+	if (buflen < 3) {
+		return -ENOMEM;
+	}
+
+	buf[0] = 0xe0 | (code >> 12);
+	buf[1] = 0x80 | ((code >> 6) & 0x3f);
+	buf[2] = 0x80 | (code & 0x3f);
+	return 3;
+}
+
+static size_t get_string(struct lwm2m_input_context *in,
+			 uint8_t *buf, size_t buflen)
+{
+	struct senml_json_in_formatter_data *fd;
+	uint16_t offset;
+	size_t len = 0;
+	uint8_t c;
+	bool escape = false;
+	int i, ret;
+
+	fd = engine_get_in_user_data(in);
+	if (!fd || fd->value_type == SENML_VALUE_NONE || buflen == 0U) {
+		return 0;
+	}
+
+	offset = fd->value_offset;
+
+	for (i = 0; i < fd->value_len && len < buflen - 1; i++) {
+		if (buf_read_u8(&c, CPKT_BUF_READ(in->in_cpkt),
+				&offset) < 0) {
+			return 0;
+		}
+
+		if (!escape && c == '\\') {
+			escape = true;
+			continue;
+		}
+
+		if (escape) {
+			escape = false;
+			if (c == 'n') {
+				c = '\n';
+			} else if (c == 't') {
+				c = '\t';
+			} else if (c == 'r') {
+				c = '\r';
+			} else if (c == 'b') {
+				c = '\b';
+			} else if (c == 'f') {
+				c = '\f';
+			} else if (c == 'u') {
+				ret = json_get_unicode(in, &offset, buf + len,
+						       buflen - 1 - len);
+				if (ret < 0) {
+					return 0;
+				}
+
+				i += 4;
+				len += ret;
+				continue;
+			}
+		}
+
+		buf[len++] = c;
+	}
+
+	buf[len] = '\0';
+	return len;
+}
+
+static size_t get_bool(struct lwm2m_input_context *in, bool *value)
+{
+	struct senml_json_in_formatter_data *fd;
+	char *buf;
+
+	fd = engine_get_in_user_data(in);
+	if (!fd || fd->value_type != SENML_VALUE_BOOL) {
+		return 0;
+	}
+
+	buf = in->in_cpkt->data + fd->value_offset;
+	if (fd->value_len == 4U && strncmp(buf, "true", 4) == 0) {
+		*value = true;
+	} else if (fd->value_len == 5U && strncmp(buf, "false", 5) == 0) {
+		*value = false;
+	} else {
+		return 0;
+	}
+
+	return fd->value_len;
+}
+
+static size_t get_opaque(struct lwm2m_input_context *in,
+			 uint8_t *value, size_t buflen,
+			 struct lwm2m_opaque_context *opaque,
+			 bool *last_block)
+{
+	struct senml_json_in_formatter_data *fd;
+	uint8_t chunk[BASE64_CHUNK_LEN + 4];
+	size_t chars, olen, i;
+	uint16_t end;
+
+	fd = engine_get_in_user_data(in);
+	if (!fd || fd->value_type == SENML_VALUE_NONE) {
+		return 0;
+	}
+
+	end = fd->value_offset + fd->value_len;
+
+	/* Locate the encoded data only on first read */
+	if (opaque->remaining == 0) {
+		in->offset = fd->value_offset;
+		opaque->len = fd->value_len / 4 * 3;
+		if (fd->value_len % 4 > 1) {
+			opaque->len += fd->value_len % 4 - 1;
+		}
+
+		opaque->remaining = opaque->len;
+	}
+
+	chars = MIN(end - in->offset, BASE64_CHUNK_LEN);
+	chars = MIN(chars, buflen / 3 * 4);
+	if (chars == 0U) {
+		*last_block = true;
+		return 0;
+	}
+
+	if (buf_read(chunk, chars, CPKT_BUF_READ(in->in_cpkt),
+		     &in->offset) < 0) {
+		*last_block = true;
+		return 0;
+	}
+
+	/* convert from base64url and restore the padding */
+	for (i = 0; i < chars; i++) {
+		if (chunk[i] == '-') {
+			chunk[i] = '+';
+		} else if (chunk[i] == '_') {
+			chunk[i] = '/';
+		}
+	}
+
+	while (chars % 4) {
+		chunk[chars++] = '=';
+	}
+
+	if (base64_decode(value, buflen, &olen, chunk, chars) < 0) {
+		LOG_ERR("Invalid base64 data");
+		*last_block = true;
+		return 0;
+	}
+
+	opaque->remaining -= MIN(olen, opaque->remaining);
+	if (opaque->remaining == 0U || in->offset >= end) {
+		*last_block = true;
+	}
+
+	return olen;
+}
+
+static size_t get_objlnk(struct lwm2m_input_context *in,
+			 struct lwm2m_objlnk *value)
+{
+	char buf[sizeof("65535:65535")];
+	char *end;
+	size_t len;
+
+	len = get_string(in, (uint8_t *)buf, sizeof(buf));
+	if (len == 0) {
+		return 0;
+	}
+
+	value->obj_id = strtoul(buf, &end, 10);
+	if (*end != ':') {
+		return 0;
+	}
+
+	value->obj_inst = strtoul(end + 1, NULL, 10);
+
+	return len;
+}
+
+const struct lwm2m_writer senml_json_writer = {
+	.put_begin = put_begin,
+	.put_end = put_end,
+	.put_begin_ri = put_begin_ri,
+	.put_end_ri = put_end_ri,
+	.put_s8 = put_s8,
+	.put_s16 = put_s16,
+	.put_s32 = put_s32,
+	.put_s64 = put_s64,
+	.put_string = put_string,
+	.put_float32fix = put_float32fix,
+	.put_float64fix = put_float64fix,
+	.put_bool = put_bool,
+	.put_opaque = put_opaque,
+	.put_objlnk = put_objlnk,
+};
+
+const struct lwm2m_reader senml_json_reader = {
+	.get_s32 = get_s32,
+	.get_s64 = get_s64,
+	.get_string = get_string,
+	.get_float32fix = get_float32fix,
+	.get_float64fix = get_float64fix,
+	.get_bool = get_bool,
+	.get_opaque = get_opaque,
+	.get_objlnk = get_objlnk,
+};
+
+int do_read_op_senml_json(struct lwm2m_message *msg, int content_format)
+{
+	struct senml_json_out_formatter_data fd;
+	int ret;
+
+	(void)memset(&fd, 0, sizeof(fd));
+	engine_set_out_user_data(&msg->out, &fd);
+	ret = lwm2m_perform_read_op(msg, content_format);
+	engine_clear_out_user_data(&msg->out);
+
+	return ret;
+}
+
+int do_composite_read_op_senml_json(struct lwm2m_message *msg,
+				    int content_format,
+				    struct lwm2m_obj_path *paths,
+				    int path_count)
+{
+	struct senml_json_out_formatter_data fd;
+	int ret;
+
+	(void)memset(&fd, 0, sizeof(fd));
+	engine_set_out_user_data(&msg->out, &fd);
+	ret = lwm2m_perform_composite_read_op(msg, content_format, paths,
+					      path_count);
+	engine_clear_out_user_data(&msg->out);
+
+	return ret;
+}
+
+/* Go through the records of the payload, calling cb for each of them with
+ * msg->path set to the full name of the record.
+ */
+static int senml_json_foreach_record(struct lwm2m_message *msg,
+				     struct senml_json_in_formatter_data *fd,
+				     int (*cb)(struct lwm2m_message *msg,
+					       void *user_data),
+				     void *user_data)
+{
+	char full_name[MAX_RESOURCE_LEN * 2];
+	uint16_t next;
+	uint8_t c;
+	int ret;
+
+	if (json_expect(&msg->in, '[') < 0) {
+		return -EBADMSG;
+	}
+
+	while (true) {
+		if (json_peek(&msg->in, &c) < 0) {
+			return -EBADMSG;
+		}
+
+		if (c == ']') {
+			msg->in.offset++;
+			return 0;
+		}
+
+		if (c == ',') {
+			msg->in.offset++;
+			continue;
+		}
+
+		ret = json_next_record(&msg->in, fd);
+		if (ret < 0) {
+			return -EBADMSG;
+		}
+
+		snprintk(full_name, sizeof(full_name), "%s%s", fd->base_name,
+			 fd->name);
+
+		ret = lwm2m_name_to_path(full_name, strlen(full_name),
+					 &msg->path);
+		if (ret < 0) {
+			LOG_ERR("Invalid record name %s",
+				log_strdup(full_name));
+			return -EBADMSG;
+		}
+
+		/* The value might be read with in->offset */
+		next = msg->in.offset;
+		ret = cb(msg, user_data);
+		msg->in.offset = next;
+
+		if (ret < 0) {
+			return ret;
+		}
+	}
+}
+
+static int write_record(struct lwm2m_message *msg, void *user_data)
+{
+	struct lwm2m_obj_path *orig_path = user_data;
+	struct senml_json_in_formatter_data *fd;
+	int ret;
+
+	fd = engine_get_in_user_data(&msg->in);
+	if (fd->value_type == SENML_VALUE_NONE) {
+		return 0;
+	}
+
+	ret = lwm2m_write_resource_path(msg);
+	if (ret < 0 && orig_path->level >= 3U) {
+		/* return errors on a single write */
+		return ret;
+	}
+
+	return 0;
+}
+
+int do_write_op_senml_json(struct lwm2m_message *msg)
+{
+	struct senml_json_in_formatter_data fd;
+	struct lwm2m_obj_path orig_path;
+	int ret;
+
+	(void)memset(&fd, 0, sizeof(fd));
+	engine_set_in_user_data(&msg->in, &fd);
+
+	/* store a copy of the original path */
+	memcpy(&orig_path, &msg->path, sizeof(msg->path));
+
+	ret = senml_json_foreach_record(msg, &fd, write_record, &orig_path);
+
+	memcpy(&msg->path, &orig_path, sizeof(msg->path));
+	engine_clear_in_user_data(&msg->in);
+
+	return ret;
+}
+
+struct path_list {
+	struct lwm2m_obj_path *paths;
+	int max_paths;
+	int count;
+};
+
+static int add_path(struct lwm2m_message *msg, void *user_data)
+{
+	struct path_list *list = user_data;
+
+	if (list->count >= list->max_paths) {
+		return -ENOMEM;
+	}
+
+	list->paths[list->count++] = msg->path;
+
+	return 0;
+}
+
+int senml_json_get_path_list(struct lwm2m_message *msg,
+			     struct lwm2m_obj_path *paths, int max_paths)
+{
+	struct senml_json_in_formatter_data fd;
+	struct lwm2m_obj_path orig_path;
+	struct path_list list = {
+		.paths = paths,
+		.max_paths = max_paths,
+	};
+	int ret;
+
+	(void)memset(&fd, 0, sizeof(fd));
+	engine_set_in_user_data(&msg->in, &fd);
+	memcpy(&orig_path, &msg->path, sizeof(msg->path));
+
+	ret = senml_json_foreach_record(msg, &fd, add_path, &list);
+
+	memcpy(&msg->path, &orig_path, sizeof(msg->path));
+	engine_clear_in_user_data(&msg->in);
+
+	return ret < 0 ? ret : list.count;
+}
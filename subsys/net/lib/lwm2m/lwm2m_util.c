@@ -6,6 +6,7 @@
 
 #include <kernel.h>
 #include <stdlib.h>
+#include "lwm2m_object.h"
 #include "lwm2m_util.h"
 
 #define SHIFT_LEFT(v, o, m) (((v) << (o)) & (m))
@@ -296,3 +297,53 @@ int lwm2m_b64_to_f64(uint8_t *b64, size_t len, float64_value_t *f64)
 
 	return 0;
 }
+
+int lwm2m_name_to_path(const char *name, size_t len,
+		       struct lwm2m_obj_path *path)
+{
+	uint16_t value[4] = { 0 };
+	uint32_t val = 0U;
+	uint8_t level = 0U;
+	bool digit = false;
+	size_t i;
+
+	/* skip the leading slash */
+	if (len > 0 && name[0] == '/') {
+		name++;
+		len--;
+	}
+
+	for (i = 0; i <= len; i++) {
+		if (i == len || name[i] == '/') {
+			/* a trailing slash ends the name */
+			if (!digit && (i == len && level > 0U)) {
+				break;
+			}
+
+			if (!digit || level >= ARRAY_SIZE(value)) {
+				return -EINVAL;
+			}
+
+			value[level++] = val;
+			val = 0U;
+			digit = false;
+		} else if (name[i] >= '0' && name[i] <= '9') {
+			val = val * 10U + (name[i] - '0');
+			if (val > UINT16_MAX) {
+				return -EINVAL;
+			}
+
+			digit = true;
+		} else {
+			return -EINVAL;
+		}
+	}
+
+	path->obj_id = value[0];
+	path->obj_inst_id = value[1];
+	path->res_id = value[2];
+	path->res_inst_id = value[3];
+	path->level = level;
+
+	return 0;
+}
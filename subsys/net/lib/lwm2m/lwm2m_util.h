@@ -9,6 +9,8 @@
 
 #include <net/lwm2m.h>
 
+struct lwm2m_obj_path;
+
 /* convert float struct to binary format */
 int lwm2m_f32_to_b32(float32_value_t *f32, uint8_t *b32, size_t len);
 int lwm2m_f64_to_b64(float64_value_t *f64, uint8_t *b64, size_t len);
@@ -17,4 +19,8 @@ int lwm2m_f64_to_b64(float64_value_t *f64, uint8_t *b64, size_t len);
 int lwm2m_b32_to_f32(uint8_t *b32, size_t len, float32_value_t *f32);
 int lwm2m_b64_to_f64(uint8_t *b64, size_t len, float64_value_t *f64);
 
+/* convert a name of the form "/obj/inst/res/ri" to a path */
+int lwm2m_name_to_path(const char *name, size_t len,
+		       struct lwm2m_obj_path *path);
+
 #endif /* LWM2M_UTIL_H_ */
@@ -236,6 +236,184 @@ static int verify_tx_state(const struct mqtt_client *client)
 	return 0;
 }
 
+/** @brief Check if a message id is reserved for the publish queue. */
+static bool message_id_reserved(uint16_t message_id)
+{
+#if defined(CONFIG_MQTT_PUBLISH_QUEUE)
+	return message_id >= MQTT_PUBLISH_QUEUE_ID_MIN;
+#else
+	return false;
+#endif
+}
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/**
+ * @brief Find the topic alias to use for a topic.
+ *
+ * @param[in] client Client publishing on the topic.
+ * @param[in] topic Topic of the message.
+ * @param[out] established Whether the alias was already written with the
+ *                         topic.
+ *
+ * @return Topic alias, 0 if the topic shall be sent without alias.
+ */
+static uint16_t topic_alias_find(const struct mqtt_client *client,
+				 const struct mqtt_utf8 *topic,
+				 bool *established)
+{
+	const struct mqtt_topic_alias *alias;
+	uint16_t free_alias = 0U;
+	uint16_t max;
+	uint16_t i;
+
+	*established = false;
+
+	max = MIN(client->internal.topic_alias_maximum,
+		  CONFIG_MQTT_TOPIC_ALIAS_MAX);
+
+	for (i = 0U; i < max; i++) {
+		alias = &client->internal.topic_alias[i];
+
+		if (alias->size == 0U) {
+			if (free_alias == 0U) {
+				free_alias = i + 1U;
+			}
+
+			continue;
+		}
+
+		if (alias->size == topic->size &&
+		    memcmp(alias->topic, topic->utf8, topic->size) == 0) {
+			/* A reserved alias is sent with its topic again. */
+			*established = !alias->pending;
+			return i + 1U;
+		}
+	}
+
+	if (topic->size == 0U ||
+	    topic->size > CONFIG_MQTT_TOPIC_ALIAS_TOPIC_LEN) {
+		return 0U;
+	}
+
+	/* Aliases are kept for the whole connection, topics published once
+	 * the table is full are always sent in full.
+	 */
+	return free_alias;
+}
+
+static int publish_encode_client_v5(struct mqtt_client *client,
+				    const struct mqtt_publish_param *param,
+				    struct buf_ctx *buf)
+{
+	struct mqtt_topic_alias *alias;
+	uint16_t topic_alias;
+	bool established;
+	int err_code;
+
+	if (param->message.topic.qos > client->internal.maximum_qos) {
+		return -EINVAL;
+	}
+
+	if (param->message.topic.qos != MQTT_QOS_0_AT_MOST_ONCE &&
+	    mqtt_receive_maximum_reached(client, 0U)) {
+		return -EBUSY;
+	}
+
+	topic_alias = topic_alias_find(client, &param->message.topic.topic,
+				       &established);
+
+	err_code = publish_encode_v5(param, topic_alias, !established, buf);
+	if (err_code < 0) {
+		return err_code;
+	}
+
+	if (client->internal.maximum_packet_size != 0U &&
+	    (buf->end - buf->cur) + param->message.payload.len >
+	    client->internal.maximum_packet_size) {
+		return -EMSGSIZE;
+	}
+
+	/* Reserve the new alias, it is established once written. */
+	if (topic_alias != 0U && !established) {
+		alias = &client->internal.topic_alias[topic_alias - 1U];
+		memcpy(alias->topic, param->message.topic.topic.utf8,
+		       param->message.topic.topic.size);
+		alias->size = param->message.topic.topic.size;
+		alias->pending = true;
+	}
+
+	return 0;
+}
+
+static void publish_sent_v5(struct mqtt_client *client,
+			    const struct mqtt_publish_param *param, int result)
+{
+	struct mqtt_topic_alias *alias;
+	uint16_t topic_alias;
+	bool established;
+
+	topic_alias = topic_alias_find(client, &param->message.topic.topic,
+				       &established);
+	if (topic_alias != 0U && !established) {
+		alias = &client->internal.topic_alias[topic_alias - 1U];
+
+		if (alias->pending) {
+			alias->pending = false;
+
+			/* The broker does not know the alias. */
+			if (result < 0) {
+				alias->size = 0U;
+			}
+		}
+	}
+
+	if (result == 0 &&
+	    param->message.topic.qos != MQTT_QOS_0_AT_MOST_ONCE) {
+		client->internal.inflight++;
+	}
+}
+
+/** @brief Check if a subscription uses shared subscriptions. */
+static bool subscription_is_shared(const struct mqtt_subscription_list *param)
+{
+	const size_t prefix_len = sizeof(MQTT_SHARED_SUBSCRIPTION_PREFIX) - 1;
+	uint16_t i;
+
+	for (i = 0U; i < param->list_count; i++) {
+		if (param->list[i].topic.size >= prefix_len &&
+		    memcmp(param->list[i].topic.utf8,
+			   MQTT_SHARED_SUBSCRIPTION_PREFIX, prefix_len) == 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
+int mqtt_publish_encode(struct mqtt_client *client,
+			const struct mqtt_publish_param *param,
+			struct buf_ctx *buf)
+{
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (mqtt_is_version_5(client)) {
+		return publish_encode_client_v5(client, param, buf);
+	}
+#endif
+
+	return publish_encode(param, buf);
+}
+
+void mqtt_publish_sent(struct mqtt_client *client,
+		       const struct mqtt_publish_param *param, int result)
+{
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (mqtt_is_version_5(client)) {
+		publish_sent_v5(client, param, result);
+	}
+#endif
+}
+
 int mqtt_publish(struct mqtt_client *client,
 		 const struct mqtt_publish_param *param)
 {
@@ -247,6 +425,11 @@ int mqtt_publish(struct mqtt_client *client,
 	NULL_PARAM_CHECK(client);
 	NULL_PARAM_CHECK(param);
 
+	if (param->message.topic.qos != MQTT_QOS_0_AT_MOST_ONCE &&
+	    message_id_reserved(param->message_id)) {
+		return -EINVAL;
+	}
+
 	MQTT_TRC("[CID %p]:[State 0x%02x]: >> Topic size 0x%08x, "
 		 "Data size 0x%08x", client, client->internal.state,
 		 param->message.topic.topic.size,
@@ -261,7 +444,7 @@ int mqtt_publish(struct mqtt_client *client,
 		goto error;
 	}
 
-	err_code = publish_encode(param, &packet);
+	err_code = mqtt_publish_encode(client, param, &packet);
 	if (err_code < 0) {
 		goto error;
 	}
@@ -277,6 +460,7 @@ int mqtt_publish(struct mqtt_client *client,
 	msg.msg_iovlen = ARRAY_SIZE(io_vector);
 
 	err_code = client_write_msg(client, &msg);
+	mqtt_publish_sent(client, param, err_code);
 
 error:
 	MQTT_TRC("[CID %p]:[State 0x%02x]: << result 0x%08x",
@@ -287,6 +471,67 @@ error:
 	return err_code;
 }
 
+#if defined(CONFIG_MQTT_PUBLISH_QUEUE)
+int mqtt_publish_enqueue(struct mqtt_client *client,
+			 const struct mqtt_publish_param *param)
+{
+	int err_code;
+
+	NULL_PARAM_CHECK(client);
+	NULL_PARAM_CHECK(param);
+
+	mqtt_mutex_lock(client);
+
+	err_code = mqtt_queue_add(client, param);
+
+	mqtt_mutex_unlock(client);
+
+	return err_code;
+}
+
+int mqtt_publish_flush(struct mqtt_client *client)
+{
+	int err_code;
+	int packets = 0;
+	struct iovec io_vector[2 * CONFIG_MQTT_PUBLISH_BATCH_SIZE];
+	struct msghdr msg;
+
+	NULL_PARAM_CHECK(client);
+
+	mqtt_mutex_lock(client);
+
+	err_code = verify_tx_state(client);
+	if (err_code < 0) {
+		goto error;
+	}
+
+	err_code = mqtt_queue_prepare(client, io_vector,
+				      ARRAY_SIZE(io_vector), &packets);
+	if (err_code <= 0) {
+		goto error;
+	}
+
+	memset(&msg, 0, sizeof(msg));
+
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = err_code;
+
+	err_code = client_write_msg(client, &msg);
+	mqtt_queue_sent(client, err_code);
+	if (err_code == 0) {
+		err_code = packets;
+	}
+
+error:
+	MQTT_TRC("[CID %p]:[State 0x%02x]: << result 0x%08x",
+		 client, client->internal.state, err_code);
+
+	mqtt_mutex_unlock(client);
+
+	return err_code;
+}
+#endif /* CONFIG_MQTT_PUBLISH_QUEUE */
+
 int mqtt_publish_qos1_ack(struct mqtt_client *client,
 			  const struct mqtt_puback_param *param)
 {
@@ -370,6 +615,10 @@ int mqtt_publish_qos2_release(struct mqtt_client *client,
 	NULL_PARAM_CHECK(client);
 	NULL_PARAM_CHECK(param);
 
+	if (message_id_reserved(param->message_id)) {
+		return -EINVAL;
+	}
+
 	MQTT_TRC("[CID %p]:[State 0x%02x]: >> Message id 0x%04x",
 		 client, client->internal.state, param->message_id);
 
@@ -481,6 +730,10 @@ int mqtt_subscribe(struct mqtt_client *client,
 	NULL_PARAM_CHECK(client);
 	NULL_PARAM_CHECK(param);
 
+	if (message_id_reserved(param->message_id)) {
+		return -EINVAL;
+	}
+
 	MQTT_TRC("[CID %p]:[State 0x%02x]: >> message id 0x%04x "
 		 "topic count 0x%04x", client, client->internal.state,
 		 param->message_id, param->list_count);
@@ -494,7 +747,21 @@ int mqtt_subscribe(struct mqtt_client *client,
 		goto error;
 	}
 
-	err_code = subscribe_encode(param, &packet);
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (mqtt_is_version_5(client)) {
+		if (!client->internal.shared_subscription &&
+		    subscription_is_shared(param)) {
+			err_code = -ENOTSUP;
+			goto error;
+		}
+
+		err_code = subscribe_encode_v5(param, &packet);
+	} else
+#endif
+	{
+		err_code = subscribe_encode(param, &packet);
+	}
+
 	if (err_code < 0) {
 		goto error;
 	}
@@ -519,6 +786,10 @@ int mqtt_unsubscribe(struct mqtt_client *client,
 	NULL_PARAM_CHECK(client);
 	NULL_PARAM_CHECK(param);
 
+	if (message_id_reserved(param->message_id)) {
+		return -EINVAL;
+	}
+
 	mqtt_mutex_lock(client);
 
 	tx_buf_init(client, &packet);
@@ -528,7 +799,15 @@ int mqtt_unsubscribe(struct mqtt_client *client,
 		goto error;
 	}
 
-	err_code = unsubscribe_encode(param, &packet);
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (mqtt_is_version_5(client)) {
+		err_code = unsubscribe_encode_v5(param, &packet);
+	} else
+#endif
+	{
+		err_code = unsubscribe_encode(param, &packet);
+	}
+
 	if (err_code < 0) {
 		goto error;
 	}
@@ -188,6 +188,291 @@ static int packet_length_decode(struct buf_ctx *buf, uint32_t *length)
 	return 0;
 }
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/**
+ * @brief Unpacks unsigned 32 bit value from the buffer from the offset
+ *        requested.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ * @param[out] val Memory where the value is to be unpacked.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -EINVAL if the buffer would be exceeded during the read
+ */
+static int unpack_uint32(struct buf_ctx *buf, uint32_t *val)
+{
+	MQTT_TRC(">> cur:%p, end:%p", buf->cur, buf->end);
+
+	if ((buf->end - buf->cur) < sizeof(uint32_t)) {
+		return -EINVAL;
+	}
+
+	*val = (uint32_t)*(buf->cur++) << 24; /* MSB */
+	*val |= (uint32_t)*(buf->cur++) << 16;
+	*val |= (uint32_t)*(buf->cur++) << 8;
+	*val |= *(buf->cur++); /* LSB */
+
+	MQTT_TRC("<< val:%08x", *val);
+
+	return 0;
+}
+
+/**
+ * @brief Unpacks a variable byte integer from the buffer.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ * @param[out] val Memory where the value is to be unpacked.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -EINVAL if the integer is malformed or the buffer would be exceeded
+ *                 during the read.
+ */
+static int unpack_variable_int(struct buf_ctx *buf, uint32_t *val)
+{
+	int err_code;
+
+	/* Same encoding as the remaining length of the fixed header. */
+	err_code = packet_length_decode(buf, val);
+
+	return (err_code == -EAGAIN) ? -EINVAL : err_code;
+}
+
+/**
+ * @brief Unpacks one MQTT 5.0 property.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ * @param[out] id Property identifier.
+ * @param[out] val Value of integer properties.
+ * @param[out] str Value of string and binary properties. For user
+ *                 properties, the value of the pair.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -EINVAL if the property is malformed or unknown.
+ */
+static int unpack_property(struct buf_ctx *buf, uint8_t *id, uint32_t *val,
+			   struct mqtt_utf8 *str)
+{
+	uint16_t val16;
+	uint8_t val8;
+	int err_code;
+
+	err_code = unpack_uint8(buf, id);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	*val = 0U;
+
+	switch (*id) {
+	case MQTT_PROP_PAYLOAD_FORMAT_INDICATOR:
+	case MQTT_PROP_REQUEST_PROBLEM_INFORMATION:
+	case MQTT_PROP_REQUEST_RESPONSE_INFORMATION:
+	case MQTT_PROP_MAXIMUM_QOS:
+	case MQTT_PROP_RETAIN_AVAILABLE:
+	case MQTT_PROP_WILDCARD_SUBSCRIPTION_AVAILABLE:
+	case MQTT_PROP_SUBSCRIPTION_IDENTIFIER_AVAILABLE:
+	case MQTT_PROP_SHARED_SUBSCRIPTION_AVAILABLE:
+		err_code = unpack_uint8(buf, &val8);
+		*val = val8;
+		break;
+
+	case MQTT_PROP_SERVER_KEEP_ALIVE:
+	case MQTT_PROP_RECEIVE_MAXIMUM:
+	case MQTT_PROP_TOPIC_ALIAS_MAXIMUM:
+	case MQTT_PROP_TOPIC_ALIAS:
+		err_code = unpack_uint16(buf, &val16);
+		*val = val16;
+		break;
+
+	case MQTT_PROP_MESSAGE_EXPIRY_INTERVAL:
+	case MQTT_PROP_SESSION_EXPIRY_INTERVAL:
+	case MQTT_PROP_WILL_DELAY_INTERVAL:
+	case MQTT_PROP_MAXIMUM_PACKET_SIZE:
+		err_code = unpack_uint32(buf, val);
+		break;
+
+	case MQTT_PROP_SUBSCRIPTION_IDENTIFIER:
+		err_code = unpack_variable_int(buf, val);
+		break;
+
+	case MQTT_PROP_USER_PROPERTY:
+		/* Skip the name of the pair. */
+		err_code = unpack_utf8_str(buf, str);
+		if (err_code != 0) {
+			break;
+		}
+
+		__fallthrough;
+
+	/* Binary data is encoded as an UTF-8 string. */
+	case MQTT_PROP_CONTENT_TYPE:
+	case MQTT_PROP_RESPONSE_TOPIC:
+	case MQTT_PROP_CORRELATION_DATA:
+	case MQTT_PROP_ASSIGNED_CLIENT_IDENTIFIER:
+	case MQTT_PROP_AUTHENTICATION_METHOD:
+	case MQTT_PROP_AUTHENTICATION_DATA:
+	case MQTT_PROP_RESPONSE_INFORMATION:
+	case MQTT_PROP_SERVER_REFERENCE:
+	case MQTT_PROP_REASON_STRING:
+		err_code = unpack_utf8_str(buf, str);
+		break;
+
+	default:
+		MQTT_ERR("Unknown property 0x%02x", *id);
+		err_code = -EINVAL;
+		break;
+	}
+
+	return err_code;
+}
+
+/**
+ * @brief Unpacks the length of MQTT 5.0 properties.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ * @param[out] end End of the properties in the buffer.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -EINVAL if the buffer would be exceeded during the read
+ */
+static int unpack_properties_length(struct buf_ctx *buf, uint8_t **end)
+{
+	uint32_t length;
+	int err_code;
+
+	err_code = unpack_variable_int(buf, &length);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	if ((buf->end - buf->cur) < length) {
+		return -EINVAL;
+	}
+
+	*end = buf->cur + length;
+
+	return 0;
+}
+
+/**
+ * @brief Skips MQTT 5.0 properties.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -EINVAL if the buffer would be exceeded during the read
+ */
+static int skip_properties(struct buf_ctx *buf)
+{
+	uint8_t *end;
+	int err_code;
+
+	err_code = unpack_properties_length(buf, &end);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	buf->cur = end;
+
+	return 0;
+}
+
+/**
+ * @brief Decodes the properties of an MQTT 5.0 Connect Ack packet.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ * @param[out] param Connect Ack parameters, the properties not sent by the
+ *                   server are set to their default value.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -EINVAL if the properties are malformed.
+ */
+static int connect_ack_properties_decode(struct buf_ctx *buf,
+					 struct mqtt_connack_param *param)
+{
+	struct buf_ctx props;
+	struct mqtt_utf8 str;
+	uint32_t val;
+	uint8_t id;
+	int err_code;
+
+	param->receive_maximum = MQTT_RECEIVE_MAXIMUM_DEFAULT;
+	param->topic_alias_maximum = 0U;
+	param->maximum_packet_size = 0U;
+	param->assigned_client_id.utf8 = NULL;
+	param->assigned_client_id.size = 0U;
+	param->maximum_qos = MQTT_QOS_2_EXACTLY_ONCE;
+	param->retain_available = 1U;
+	param->shared_subscription_available = 1U;
+
+	/* A CONNACK refusing the connection may have no properties. */
+	if (buf->cur == buf->end) {
+		return 0;
+	}
+
+	err_code = unpack_properties_length(buf, &props.end);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	props.cur = buf->cur;
+	buf->cur = props.end;
+
+	while (props.cur < props.end) {
+		err_code = unpack_property(&props, &id, &val, &str);
+		if (err_code != 0) {
+			return err_code;
+		}
+
+		switch (id) {
+		case MQTT_PROP_RECEIVE_MAXIMUM:
+			if (val == 0U) {
+				return -EINVAL;
+			}
+
+			param->receive_maximum = val;
+			break;
+
+		case MQTT_PROP_TOPIC_ALIAS_MAXIMUM:
+			param->topic_alias_maximum = val;
+			break;
+
+		case MQTT_PROP_MAXIMUM_PACKET_SIZE:
+			param->maximum_packet_size = val;
+			break;
+
+		case MQTT_PROP_ASSIGNED_CLIENT_IDENTIFIER:
+			param->assigned_client_id = str;
+			break;
+
+		case MQTT_PROP_MAXIMUM_QOS:
+			param->maximum_qos = val;
+			break;
+
+		case MQTT_PROP_RETAIN_AVAILABLE:
+			param->retain_available = val ? 1U : 0U;
+			break;
+
+		case MQTT_PROP_SHARED_SUBSCRIPTION_AVAILABLE:
+			param->shared_subscription_available = val ? 1U : 0U;
+			break;
+
+		default:
+			/* Other properties are not used by the client. */
+			break;
+		}
+	}
+
+	return 0;
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 int fixed_header_decode(struct buf_ctx *buf, uint8_t *type_and_flags,
 			uint32_t *length)
 {
@@ -217,7 +502,8 @@ int connect_ack_decode(const struct mqtt_client *client, struct buf_ctx *buf,
 		return err_code;
 	}
 
-	if (client->protocol_version == MQTT_VERSION_3_1_1) {
+	if (client->protocol_version == MQTT_VERSION_3_1_1 ||
+	    mqtt_is_version_5(client)) {
 		param->session_present_flag =
 			flags & MQTT_CONNACK_FLAG_SESSION_PRESENT;
 
@@ -227,6 +513,12 @@ int connect_ack_decode(const struct mqtt_client *client, struct buf_ctx *buf,
 
 	param->return_code = (enum mqtt_conn_return_code)ret_code;
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (mqtt_is_version_5(client)) {
+		return connect_ack_properties_decode(buf, param);
+	}
+#endif
+
 	return 0;
 }
 
@@ -269,6 +561,41 @@ int publish_decode(uint8_t flags, uint32_t var_length, struct buf_ctx *buf,
 	return 0;
 }
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+int publish_decode_v5(uint8_t flags, uint32_t var_length, struct buf_ctx *buf,
+		      struct mqtt_publish_param *param)
+{
+	uint8_t *properties;
+	uint32_t properties_length;
+	int err_code;
+
+	err_code = publish_decode(flags, var_length, buf, param);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	properties = buf->cur;
+
+	err_code = skip_properties(buf);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	properties_length = buf->cur - properties;
+
+	if (param->message.payload.len < properties_length) {
+		MQTT_ERR("Corrupted PUBLISH message, properties length (%u) "
+			 "larger than remaining length (%u)", properties_length,
+			 param->message.payload.len);
+		return -EINVAL;
+	}
+
+	param->message.payload.len -= properties_length;
+
+	return 0;
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 int publish_ack_decode(struct buf_ctx *buf, struct mqtt_puback_param *param)
 {
 	return unpack_uint16(buf, &param->message_id);
@@ -302,6 +629,48 @@ int subscribe_ack_decode(struct buf_ctx *buf, struct mqtt_suback_param *param)
 	return unpack_data(buf->end - buf->cur, buf, &param->return_codes);
 }
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+int subscribe_ack_decode_v5(struct buf_ctx *buf,
+			    struct mqtt_suback_param *param)
+{
+	int err_code;
+
+	err_code = unpack_uint16(buf, &param->message_id);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	err_code = skip_properties(buf);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	/* MQTT 5.0 reason codes keep the values of MQTT 3.1.1 return codes
+	 * for granted QoS, failures are 0x80 and above.
+	 */
+	return unpack_data(buf->end - buf->cur, buf, &param->return_codes);
+}
+
+int publish_receive_decode_v5(struct buf_ctx *buf,
+			      struct mqtt_pubrec_param *param)
+{
+	int err_code;
+
+	err_code = unpack_uint16(buf, &param->message_id);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	/* The reason code is omitted on success. */
+	param->reason_code = 0U;
+	if (buf->cur == buf->end) {
+		return 0;
+	}
+
+	return unpack_uint8(buf, &param->reason_code);
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 int unsubscribe_ack_decode(struct buf_ctx *buf,
 			   struct mqtt_unsuback_param *param)
 {
@@ -82,6 +82,35 @@ static int pack_uint16(uint16_t val, struct buf_ctx *buf)
 	return 0;
 }
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/**
+ * @brief Packs unsigned 32 bit value to the buffer at the offset requested.
+ *
+ * @param[in] val Value to be packed.
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -ENOMEM if there is no place in the buffer to store the value.
+ */
+static int pack_uint32(uint32_t val, struct buf_ctx *buf)
+{
+	if ((buf->end - buf->cur) < sizeof(uint32_t)) {
+		return -ENOMEM;
+	}
+
+	MQTT_TRC(">> val:%08x cur:%p, end:%p", val, buf->cur, buf->end);
+
+	/* Pack value. */
+	*(buf->cur++) = (val >> 24) & 0xFF;
+	*(buf->cur++) = (val >> 16) & 0xFF;
+	*(buf->cur++) = (val >> 8) & 0xFF;
+	*(buf->cur++) = val & 0xFF;
+
+	return 0;
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 /**
  * @brief Packs utf8 string to the buffer at the offset requested.
  *
@@ -162,6 +191,30 @@ static uint8_t packet_length_encode(uint32_t length, struct buf_ctx *buf)
 	return encoded_bytes;
 }
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/**
+ * @brief Packs a variable byte integer, used for the length of MQTT 5.0
+ *        properties.
+ *
+ * @param[in] val Value to be packed.
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -ENOMEM if there is no place in the buffer to store the value.
+ */
+static int pack_variable_int(uint32_t val, struct buf_ctx *buf)
+{
+	if ((buf->end - buf->cur) < packet_length_encode(val, NULL)) {
+		return -ENOMEM;
+	}
+
+	(void)packet_length_encode(val, buf);
+
+	return 0;
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 /**
  * @brief Encodes fixed header for the MQTT message and provides pointer to
  *        start of the header.
@@ -266,6 +319,44 @@ static int mqtt_message_id_only_enc(uint8_t message_type, uint16_t message_id,
 	return mqtt_encode_fixed_header(message_type, start, buf);
 }
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/**
+ * @brief Encodes the properties of an MQTT 5.0 Connect packet.
+ *
+ * A session that is not clean never expires, as with MQTT 3.1.1. Other
+ * properties keep their default value: the client does not limit the
+ * number of messages it receives and does not accept topic aliases.
+ *
+ * @param[in] client Client for which the packet is encoded.
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ *
+ * @retval 0 if the procedure is successful.
+ * @retval -ENOMEM if there is no place in the buffer to store the properties.
+ */
+static int connect_properties_encode(const struct mqtt_client *client,
+				     struct buf_ctx *buf)
+{
+	int err_code;
+
+	if (client->clean_session) {
+		return pack_variable_int(0, buf);
+	}
+
+	err_code = pack_variable_int(sizeof(uint8_t) + sizeof(uint32_t), buf);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	err_code = pack_uint8(MQTT_PROP_SESSION_EXPIRY_INTERVAL, buf);
+	if (err_code != 0) {
+		return err_code;
+	}
+
+	return pack_uint32(MQTT_SESSION_EXPIRY_NEVER, buf);
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 int connect_request_encode(const struct mqtt_client *client,
 			   struct buf_ctx *buf)
 {
@@ -277,7 +368,8 @@ int connect_request_encode(const struct mqtt_client *client,
 	int err_code;
 	uint8_t *start;
 
-	if (client->protocol_version == MQTT_VERSION_3_1_1) {
+	if (client->protocol_version == MQTT_VERSION_3_1_1 ||
+	    mqtt_is_version_5(client)) {
 		mqtt_proto_desc = &mqtt_3_1_1_proto_desc;
 	} else {
 		mqtt_proto_desc = &mqtt_3_1_0_proto_desc;
@@ -317,6 +409,15 @@ int connect_request_encode(const struct mqtt_client *client,
 		return err_code;
 	}
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (mqtt_is_version_5(client)) {
+		err_code = connect_properties_encode(client, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+#endif
+
 	MQTT_HEXDUMP_TRC(client->client_id.utf8, client->client_id.size,
 			 "Encoding Client Id.");
 	err_code = pack_utf8_str(&client->client_id, buf);
@@ -331,6 +432,16 @@ int connect_request_encode(const struct mqtt_client *client,
 		connect_flags |= ((client->will_topic->qos & 0x03) << 3);
 		connect_flags |= client->will_retain << 5;
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+		if (mqtt_is_version_5(client)) {
+			/* No will properties. */
+			err_code = pack_uint8(0, buf);
+			if (err_code != 0) {
+				return err_code;
+			}
+		}
+#endif
+
 		MQTT_HEXDUMP_TRC(client->will_topic->topic.utf8,
 				 client->will_topic->topic.size,
 				 "Encoding Will Topic.");
@@ -388,7 +499,22 @@ int connect_request_encode(const struct mqtt_client *client,
 	return mqtt_encode_fixed_header(message_type, start, buf);
 }
 
-int publish_encode(const struct mqtt_publish_param *param, struct buf_ctx *buf)
+/**
+ * @brief Encodes Publish packet, with or without MQTT 5.0 properties.
+ *
+ * @param[in] param Publish message parameters.
+ * @param[in] topic Topic to send, may be empty with a topic alias.
+ * @param[in] properties Whether to encode MQTT 5.0 properties.
+ * @param[in] topic_alias Topic alias property to send, 0 for none.
+ * @param[inout] buf_ctx Pointer to the buffer context structure,
+ *                       containing buffer for the encoded message.
+ *
+ * @retval 0 or an error code indicating a reason for failure.
+ */
+static int publish_encode_internal(const struct mqtt_publish_param *param,
+				   const struct mqtt_utf8 *topic,
+				   bool properties, uint16_t topic_alias,
+				   struct buf_ctx *buf)
 {
 	const uint8_t message_type = MQTT_MESSAGES_OPTIONS(
 			MQTT_PKT_TYPE_PUBLISH, param->dup_flag,
@@ -405,7 +531,7 @@ int publish_encode(const struct mqtt_publish_param *param, struct buf_ctx *buf)
 	buf->cur += MQTT_FIXED_HEADER_MAX_SIZE;
 	start = buf->cur;
 
-	err_code = pack_utf8_str(&param->message.topic.topic, buf);
+	err_code = pack_utf8_str(topic, buf);
 	if (err_code != 0) {
 		return err_code;
 	}
@@ -417,6 +543,26 @@ int publish_encode(const struct mqtt_publish_param *param, struct buf_ctx *buf)
 		}
 	}
 
+	if (properties) {
+		/* Topic alias is the only property sent, with its value. */
+		err_code = pack_uint8(topic_alias ? 3U : 0U, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+
+		if (topic_alias) {
+			err_code = pack_uint8(MQTT_PROP_TOPIC_ALIAS, buf);
+			if (err_code != 0) {
+				return err_code;
+			}
+
+			err_code = pack_uint16(topic_alias, buf);
+			if (err_code != 0) {
+				return err_code;
+			}
+		}
+	}
+
 	/* Do not copy payload. We move the buffer pointer to ensure that
 	 * message length in fixed header is encoded correctly.
 	 */
@@ -432,6 +578,31 @@ int publish_encode(const struct mqtt_publish_param *param, struct buf_ctx *buf)
 	return 0;
 }
 
+int publish_encode(const struct mqtt_publish_param *param, struct buf_ctx *buf)
+{
+	return publish_encode_internal(param, &param->message.topic.topic,
+				       false, 0U, buf);
+}
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+int publish_encode_v5(const struct mqtt_publish_param *param,
+		      uint16_t topic_alias, bool send_topic,
+		      struct buf_ctx *buf)
+{
+	static const struct mqtt_utf8 empty_topic = MQTT_UTF8_LITERAL("");
+
+	/* An empty topic is only valid with an established topic alias. */
+	if (!send_topic && topic_alias == 0U) {
+		return -EINVAL;
+	}
+
+	return publish_encode_internal(param, send_topic ?
+				       &param->message.topic.topic :
+				       &empty_topic,
+				       true, topic_alias, buf);
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 int publish_ack_encode(const struct mqtt_puback_param *param,
 		       struct buf_ctx *buf)
 {
@@ -480,8 +651,20 @@ int disconnect_encode(struct buf_ctx *buf)
 	return 0;
 }
 
-int subscribe_encode(const struct mqtt_subscription_list *param,
-		     struct buf_ctx *buf)
+/**
+ * @brief Encodes Subscribe packet, with or without MQTT 5.0 properties.
+ *
+ * With MQTT 5.0 the QoS is the only subscription option set.
+ *
+ * @param[in] param Subscribe message parameters.
+ * @param[in] properties Whether to encode MQTT 5.0 properties.
+ * @param[inout] buf_ctx Pointer to the buffer context structure,
+ *                       containing buffer for the encoded message.
+ *
+ * @retval 0 or an error code indicating a reason for failure.
+ */
+static int subscribe_encode_internal(const struct mqtt_subscription_list *param,
+				     bool properties, struct buf_ctx *buf)
 {
 	const uint8_t message_type = MQTT_MESSAGES_OPTIONS(
 			MQTT_PKT_TYPE_SUBSCRIBE, 0, 1, 0);
@@ -502,6 +685,13 @@ int subscribe_encode(const struct mqtt_subscription_list *param,
 		return err_code;
 	}
 
+	if (properties) {
+		err_code = pack_uint8(0, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
 	for (i = 0; i < param->list_count; i++) {
 		err_code = pack_utf8_str(&param->list[i].topic, buf);
 		if (err_code != 0) {
@@ -517,8 +707,25 @@ int subscribe_encode(const struct mqtt_subscription_list *param,
 	return mqtt_encode_fixed_header(message_type, start, buf);
 }
 
-int unsubscribe_encode(const struct mqtt_subscription_list *param,
-		       struct buf_ctx *buf)
+int subscribe_encode(const struct mqtt_subscription_list *param,
+		     struct buf_ctx *buf)
+{
+	return subscribe_encode_internal(param, false, buf);
+}
+
+/**
+ * @brief Encodes Unsubscribe packet, with or without MQTT 5.0 properties.
+ *
+ * @param[in] param Unsubscribe message parameters.
+ * @param[in] properties Whether to encode MQTT 5.0 properties.
+ * @param[inout] buf_ctx Pointer to the buffer context structure,
+ *                       containing buffer for the encoded message.
+ *
+ * @retval 0 or an error code indicating a reason for failure.
+ */
+static int unsubscribe_encode_internal(
+	const struct mqtt_subscription_list *param, bool properties,
+	struct buf_ctx *buf)
 {
 	const uint8_t message_type = MQTT_MESSAGES_OPTIONS(
 		MQTT_PKT_TYPE_UNSUBSCRIBE, 0, MQTT_QOS_1_AT_LEAST_ONCE, 0);
@@ -534,6 +741,13 @@ int unsubscribe_encode(const struct mqtt_subscription_list *param,
 		return err_code;
 	}
 
+	if (properties) {
+		err_code = pack_uint8(0, buf);
+		if (err_code != 0) {
+			return err_code;
+		}
+	}
+
 	for (i = 0; i < param->list_count; i++) {
 		err_code = pack_utf8_str(&param->list[i].topic, buf);
 		if (err_code != 0) {
@@ -544,6 +758,26 @@ int unsubscribe_encode(const struct mqtt_subscription_list *param,
 	return mqtt_encode_fixed_header(message_type, start, buf);
 }
 
+int unsubscribe_encode(const struct mqtt_subscription_list *param,
+		       struct buf_ctx *buf)
+{
+	return unsubscribe_encode_internal(param, false, buf);
+}
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+int subscribe_encode_v5(const struct mqtt_subscription_list *param,
+			struct buf_ctx *buf)
+{
+	return subscribe_encode_internal(param, true, buf);
+}
+
+int unsubscribe_encode_v5(const struct mqtt_subscription_list *param,
+			  struct buf_ctx *buf)
+{
+	return unsubscribe_encode_internal(param, true, buf);
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 int ping_request_encode(struct buf_ctx *buf)
 {
 	if (buf->end - buf->cur < sizeof(ping_packet)) {
@@ -69,6 +69,47 @@ extern "C" {
 
 #define MQTT_CONNACK_FLAG_SESSION_PRESENT 0x01
 
+/**@brief MQTT 5.0 property identifiers. */
+#define MQTT_PROP_PAYLOAD_FORMAT_INDICATOR          0x01
+#define MQTT_PROP_MESSAGE_EXPIRY_INTERVAL           0x02
+#define MQTT_PROP_CONTENT_TYPE                      0x03
+#define MQTT_PROP_RESPONSE_TOPIC                    0x08
+#define MQTT_PROP_CORRELATION_DATA                  0x09
+#define MQTT_PROP_SUBSCRIPTION_IDENTIFIER           0x0B
+#define MQTT_PROP_SESSION_EXPIRY_INTERVAL           0x11
+#define MQTT_PROP_ASSIGNED_CLIENT_IDENTIFIER        0x12
+#define MQTT_PROP_SERVER_KEEP_ALIVE                 0x13
+#define MQTT_PROP_AUTHENTICATION_METHOD             0x15
+#define MQTT_PROP_AUTHENTICATION_DATA               0x16
+#define MQTT_PROP_REQUEST_PROBLEM_INFORMATION       0x17
+#define MQTT_PROP_WILL_DELAY_INTERVAL               0x18
+#define MQTT_PROP_REQUEST_RESPONSE_INFORMATION      0x19
+#define MQTT_PROP_RESPONSE_INFORMATION              0x1A
+#define MQTT_PROP_SERVER_REFERENCE                  0x1C
+#define MQTT_PROP_REASON_STRING                     0x1F
+#define MQTT_PROP_RECEIVE_MAXIMUM                   0x21
+#define MQTT_PROP_TOPIC_ALIAS_MAXIMUM               0x22
+#define MQTT_PROP_TOPIC_ALIAS                       0x23
+#define MQTT_PROP_MAXIMUM_QOS                       0x24
+#define MQTT_PROP_RETAIN_AVAILABLE                  0x25
+#define MQTT_PROP_USER_PROPERTY                     0x26
+#define MQTT_PROP_MAXIMUM_PACKET_SIZE               0x27
+#define MQTT_PROP_WILDCARD_SUBSCRIPTION_AVAILABLE   0x28
+#define MQTT_PROP_SUBSCRIPTION_IDENTIFIER_AVAILABLE 0x29
+#define MQTT_PROP_SHARED_SUBSCRIPTION_AVAILABLE     0x2A
+
+/**@brief Default Receive Maximum, when not sent by the broker. */
+#define MQTT_RECEIVE_MAXIMUM_DEFAULT 65535
+
+/**@brief Session Expiry Interval for a session that never expires. */
+#define MQTT_SESSION_EXPIRY_NEVER 0xFFFFFFFF
+
+/**@brief First MQTT 5.0 reason code reporting a failure. */
+#define MQTT_REASON_CODE_FAILURE 0x80
+
+/**@brief Topic filter prefix of MQTT 5.0 shared subscriptions. */
+#define MQTT_SHARED_SUBSCRIPTION_PREFIX "$share/"
+
 /**@brief Maximum payload size of MQTT packet. */
 #define MQTT_MAX_PAYLOAD_SIZE 0x0FFFFFFF
 
@@ -147,6 +188,47 @@ enum mqtt_state {
 	MQTT_STATE_CONNECTED            = 0x00000004,
 };
 
+/**@brief Check if the client uses MQTT 5.0. */
+static inline bool mqtt_is_version_5(const struct mqtt_client *client)
+{
+	return IS_ENABLED(CONFIG_MQTT_VERSION_5_0) &&
+	       client->protocol_version == MQTT_VERSION_5_0;
+}
+
+/**@brief Check if the client shall wait for acknowledgments before sending
+ *        more QoS 1 and QoS 2 messages, as requested by the MQTT 5.0
+ *        Receive Maximum of the broker.
+ *
+ * @param[in] client MQTT client.
+ * @param[in] pending Number of QoS 1 and QoS 2 messages encoded and not
+ *                    written yet.
+ */
+static inline bool mqtt_receive_maximum_reached(const struct mqtt_client *client,
+						uint16_t pending)
+{
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	return mqtt_is_version_5(client) &&
+	       client->internal.inflight + pending >=
+	       client->internal.receive_maximum;
+#else
+	return false;
+#endif
+}
+
+/**@brief Check if a PUBREC refuses the message with an MQTT 5.0 failure
+ *        reason code, which ends the QoS 2 exchange.
+ */
+static inline bool mqtt_pubrec_failed(const struct mqtt_client *client,
+				      const struct mqtt_pubrec_param *param)
+{
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	return mqtt_is_version_5(client) &&
+	       param->reason_code >= MQTT_REASON_CODE_FAILURE;
+#else
+	return false;
+#endif
+}
+
 /**@brief Notify application about MQTT event.
  *
  * @param[in] client Identifies the client for which event occurred.
@@ -191,6 +273,36 @@ int connect_request_encode(const struct mqtt_client *client,
  */
 int publish_encode(const struct mqtt_publish_param *param, struct buf_ctx *buf);
 
+/**@brief Constructs/encodes Publish packet for the protocol version of the
+ *        client. With MQTT 5.0, a new topic alias is reserved until
+ *        @ref mqtt_publish_sent is called.
+ *
+ * @param[in] client Client for which the packet is encoded.
+ * @param[in] param Publish message parameters.
+ * @param[inout] buf_ctx Pointer to the buffer context structure,
+ *                       containing buffer for the encoded message.
+ *                       As output points to the beginning and end of
+ *                       the frame.
+ *
+ * @return 0 if the procedure is successful, an error code otherwise.
+ */
+int mqtt_publish_encode(struct mqtt_client *client,
+			const struct mqtt_publish_param *param,
+			struct buf_ctx *buf);
+
+/**@brief Update the client once a Publish packet encoded by
+ *        @ref mqtt_publish_encode was written.
+ *
+ * With MQTT 5.0, a new topic alias is established and a QoS 1 or QoS 2
+ * message counts as unacknowledged. A failed write releases the alias.
+ *
+ * @param[in] client Client for which the packet was encoded.
+ * @param[in] param Publish message parameters.
+ * @param[in] result Result of the transport write.
+ */
+void mqtt_publish_sent(struct mqtt_client *client,
+		       const struct mqtt_publish_param *param, int result);
+
 /**@brief Constructs/encodes Publish Ack packet.
  *
  * @param[in] param Publish Ack message parameters.
@@ -280,6 +392,51 @@ int subscribe_encode(const struct mqtt_subscription_list *param,
 int unsubscribe_encode(const struct mqtt_subscription_list *param,
 		       struct buf_ctx *buf);
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/**@brief Constructs/encodes MQTT 5.0 Publish packet.
+ *
+ * @param[in] param Publish message parameters.
+ * @param[in] topic_alias Topic alias to send, 0 for none.
+ * @param[in] send_topic Whether to send the topic, it can only be omitted
+ *                       when an established topic alias is sent.
+ * @param[inout] buf_ctx Pointer to the buffer context structure,
+ *                       containing buffer for the encoded message.
+ *                       As output points to the beginning and end of
+ *                       the frame.
+ *
+ * @return 0 if the procedure is successful, an error code otherwise.
+ */
+int publish_encode_v5(const struct mqtt_publish_param *param,
+		      uint16_t topic_alias, bool send_topic,
+		      struct buf_ctx *buf);
+
+/**@brief Constructs/encodes MQTT 5.0 Subscribe packet.
+ *
+ * @param[in] param Subscribe message parameters.
+ * @param[inout] buf_ctx Pointer to the buffer context structure,
+ *                       containing buffer for the encoded message.
+ *                       As output points to the beginning and end of
+ *                       the frame.
+ *
+ * @return 0 if the procedure is successful, an error code otherwise.
+ */
+int subscribe_encode_v5(const struct mqtt_subscription_list *param,
+			struct buf_ctx *buf);
+
+/**@brief Constructs/encodes MQTT 5.0 Unsubscribe packet.
+ *
+ * @param[in] param Unsubscribe message parameters.
+ * @param[inout] buf_ctx Pointer to the buffer context structure,
+ *                       containing buffer for the encoded message.
+ *                       As output points to the beginning and end of
+ *                       the frame.
+ *
+ * @return 0 if the procedure is successful, an error code otherwise.
+ */
+int unsubscribe_encode_v5(const struct mqtt_subscription_list *param,
+			  struct buf_ctx *buf);
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 /**@brief Constructs/encodes Ping Request packet.
  *
  * @param[inout] buf_ctx Pointer to the buffer context structure,
@@ -393,6 +550,103 @@ int subscribe_ack_decode(struct buf_ctx *buf,
 int unsubscribe_ack_decode(struct buf_ctx *buf,
 			   struct mqtt_unsuback_param *param);
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/**@brief Decode MQTT 5.0 Publish packet. Properties are skipped.
+ *
+ * @param[in] flags Byte containing message type and flags.
+ * @param[in] var_length Length of the variable part of the message.
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ * @param[out] param Pointer to buffer for decoded Publish parameters.
+ *
+ * @return 0 if the procedure is successful, an error code otherwise.
+ */
+int publish_decode_v5(uint8_t flags, uint32_t var_length, struct buf_ctx *buf,
+		      struct mqtt_publish_param *param);
+
+/**@brief Decode MQTT 5.0 Subscribe Ack packet. Properties are skipped.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ * @param[out] param Pointer to buffer for decoded Subscribe parameters.
+ *
+ * @return 0 if the procedure is successful, an error code otherwise.
+ */
+int subscribe_ack_decode_v5(struct buf_ctx *buf,
+			    struct mqtt_suback_param *param);
+
+/**@brief Decode MQTT 5.0 Publish Receive packet. Properties are skipped.
+ *
+ * @param[inout] buf A pointer to the buf_ctx structure containing current
+ *                   buffer position.
+ * @param[out] param Pointer to buffer for decoded Publish Receive parameters.
+ *
+ * @return 0 if the procedure is successful, an error code otherwise.
+ */
+int publish_receive_decode_v5(struct buf_ctx *buf,
+			      struct mqtt_pubrec_param *param);
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
+#if defined(CONFIG_MQTT_PUBLISH_QUEUE)
+/**@brief Add a message to the outgoing publish queue.
+ *
+ * @param[in] client MQTT client owning the queue.
+ * @param[in] param Message to add. Topic and payload are referenced.
+ *
+ * @return Message id assigned to the message, 0 for QoS 0, or an error code.
+ */
+int mqtt_queue_add(struct mqtt_client *client,
+		   const struct mqtt_publish_param *param);
+
+/**@brief Encode the next batch of queued packets into the tx buffer.
+ *
+ * The queue is only updated once the batch is written, see
+ * @ref mqtt_queue_sent.
+ *
+ * @param[in] client MQTT client owning the queue.
+ * @param[out] iov I/O vector to send, headers point into the tx buffer and
+ *                 payloads to the application data.
+ * @param[in] iov_len Number of elements in @p iov.
+ * @param[out] packets Number of packets in the batch.
+ *
+ * @return Number of elements of @p iov used, 0 if nothing is to be sent.
+ */
+int mqtt_queue_prepare(struct mqtt_client *client, struct iovec *iov,
+		       size_t iov_len, int *packets);
+
+/**@brief Update the queue once the batch encoded by @ref mqtt_queue_prepare
+ *        was written.
+ *
+ * QoS 0 messages are released, QoS 1 and QoS 2 messages wait for their
+ * acknowledgment. Nothing changes when the write failed, the messages are
+ * sent again with the next batch. Unacknowledged QoS 1 and QoS 2 messages
+ * are sent again after reconnecting, see @ref mqtt_queue_reconnect.
+ *
+ * @param[in] client MQTT client owning the queue.
+ * @param[in] result Result of the transport write.
+ */
+void mqtt_queue_sent(struct mqtt_client *client, int result);
+
+/**@brief Update the queue on reception of PUBACK, PUBREC or PUBCOMP.
+ *
+ * @param[in] client MQTT client owning the queue.
+ * @param[in] type Type of the received packet.
+ * @param[in] message_id Message id of the received packet.
+ * @param[in] failed Whether a PUBREC refused the message, see
+ *                   @ref mqtt_pubrec_failed.
+ */
+void mqtt_queue_ack(struct mqtt_client *client, uint8_t type,
+		    uint16_t message_id, bool failed);
+
+/**@brief Schedule unacknowledged messages to be sent again after the
+ *        connection was accepted.
+ *
+ * @param[in] client MQTT client owning the queue.
+ * @param[in] session_present Whether the broker kept the session state.
+ */
+void mqtt_queue_reconnect(struct mqtt_client *client, bool session_present);
+#endif /* CONFIG_MQTT_PUBLISH_QUEUE */
+
 #ifdef __cplusplus
 }
 #endif
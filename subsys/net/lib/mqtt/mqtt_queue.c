@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file mqtt_queue.c
+ *
+ * @brief MQTT outgoing publish queue.
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_mqtt_queue, CONFIG_MQTT_LOG_LEVEL);
+
+#include "mqtt_internal.h"
+#include "mqtt_os.h"
+
+static struct mqtt_queue_entry *queue_entry(struct mqtt_publish_queue *queue,
+					    uint8_t index)
+{
+	return &queue->entries[(queue->head + index) %
+			       CONFIG_MQTT_PUBLISH_QUEUE_SIZE];
+}
+
+/** @brief Release the oldest entries once they are no longer used. */
+static void queue_compact(struct mqtt_publish_queue *queue)
+{
+	while (queue->count > 0U &&
+	       queue->entries[queue->head].state == MQTT_QUEUE_FREE) {
+		queue->head = (queue->head + 1U) %
+			      CONFIG_MQTT_PUBLISH_QUEUE_SIZE;
+		queue->count--;
+	}
+}
+
+static struct mqtt_queue_entry *queue_find(struct mqtt_publish_queue *queue,
+					   uint16_t message_id)
+{
+	struct mqtt_queue_entry *entry;
+	uint8_t i;
+
+	for (i = 0U; i < queue->count; i++) {
+		entry = queue_entry(queue, i);
+
+		if (entry->state != MQTT_QUEUE_FREE &&
+		    entry->param.message.topic.qos != MQTT_QOS_0_AT_MOST_ONCE &&
+		    entry->param.message_id == message_id) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static uint16_t next_message_id(struct mqtt_publish_queue *queue)
+{
+	do {
+		queue->message_id++;
+		if (queue->message_id < MQTT_PUBLISH_QUEUE_ID_MIN) {
+			/* Lower ids are left to the application. */
+			queue->message_id = MQTT_PUBLISH_QUEUE_ID_MIN;
+		}
+	} while (queue_find(queue, queue->message_id) != NULL);
+
+	return queue->message_id;
+}
+
+int mqtt_queue_add(struct mqtt_client *client,
+		   const struct mqtt_publish_param *param)
+{
+	struct mqtt_publish_queue *queue = &client->internal.queue;
+	struct mqtt_queue_entry *entry;
+	size_t header_len;
+
+	if (param->message.topic.qos > MQTT_QOS_2_EXACTLY_ONCE) {
+		return -EINVAL;
+	}
+
+	/* The header of every message shall fit the tx buffer on its own. */
+	header_len = MQTT_FIXED_HEADER_MAX_SIZE +
+		     GET_UT8STR_BUFFER_SIZE(&param->message.topic.topic) +
+		     sizeof(uint16_t);
+	if (header_len > client->tx_buf_size) {
+		return -EMSGSIZE;
+	}
+
+	if (queue->count >= CONFIG_MQTT_PUBLISH_QUEUE_SIZE) {
+		return -ENOMEM;
+	}
+
+	entry = queue_entry(queue, queue->count);
+	queue->count++;
+
+	entry->param = *param;
+	entry->param.dup_flag = 0U;
+	entry->param.message_id = 0U;
+	entry->state = MQTT_QUEUE_PENDING;
+	entry->sending = false;
+
+	if (param->message.topic.qos != MQTT_QOS_0_AT_MOST_ONCE) {
+		entry->param.message_id = next_message_id(queue);
+	}
+
+	MQTT_TRC("[CID %p]: Queued message id 0x%04x, %u in queue", client,
+		 entry->param.message_id, queue->count);
+
+	return entry->param.message_id;
+}
+
+static int encode_entry(struct mqtt_client *client,
+			struct mqtt_queue_entry *entry, struct buf_ctx *buf)
+{
+	if (entry->state == MQTT_QUEUE_RELEASE) {
+		struct mqtt_pubrel_param param = {
+			.message_id = entry->param.message_id,
+		};
+
+		return publish_release_encode(&param, buf);
+	}
+
+	return mqtt_publish_encode(client, &entry->param, buf);
+}
+
+int mqtt_queue_prepare(struct mqtt_client *client, struct iovec *iov,
+		       size_t iov_len, int *packets)
+{
+	struct mqtt_publish_queue *queue = &client->internal.queue;
+	struct mqtt_queue_entry *entry;
+	bool publish_blocked = false;
+	/* Including the messages of the batch, in flight once written. */
+	uint8_t inflight = queue->inflight;
+	struct buf_ctx packet;
+	uint8_t *pos = client->tx_buf;
+	uint8_t *end = client->tx_buf + client->tx_buf_size;
+	size_t used = 0U;
+	uint8_t i;
+	int err_code;
+
+	*packets = 0;
+
+	for (i = 0U; i < queue->count && used + 2U <= iov_len; i++) {
+		entry = queue_entry(queue, i);
+
+		if (entry->state == MQTT_QUEUE_PENDING) {
+			/* Keep the order of the messages, a message that can
+			 * not be sent yet blocks all the following ones.
+			 */
+			if (entry->param.message.topic.qos !=
+			    MQTT_QOS_0_AT_MOST_ONCE &&
+			    (inflight >= CONFIG_MQTT_PUBLISH_INFLIGHT_MAX ||
+			     mqtt_receive_maximum_reached(client,
+						inflight - queue->inflight))) {
+				publish_blocked = true;
+			}
+
+			if (publish_blocked) {
+				continue;
+			}
+		} else if (entry->state != MQTT_QUEUE_RELEASE) {
+			continue;
+		}
+
+		packet.cur = pos;
+		packet.end = end;
+
+		err_code = encode_entry(client, entry, &packet);
+		if (err_code < 0 && used > 0U) {
+			/* Most likely the tx buffer is full, send the batch
+			 * and retry this entry later.
+			 */
+			break;
+		} else if (err_code < 0) {
+			/* The message can never be sent, drop it so it does
+			 * not block the queue.
+			 */
+			MQTT_ERR("[CID %p]: Dropping message id 0x%04x: %d",
+				 client, entry->param.message_id, err_code);
+			if (entry->state == MQTT_QUEUE_RELEASE) {
+				queue->inflight--;
+			}
+
+			entry->state = MQTT_QUEUE_FREE;
+			queue_compact(queue);
+			return err_code;
+		}
+
+		pos = packet.end;
+
+		iov[used].iov_base = packet.cur;
+		iov[used].iov_len = packet.end - packet.cur;
+		used++;
+
+		if (entry->state == MQTT_QUEUE_PENDING) {
+			iov[used].iov_base = entry->param.message.payload.data;
+			iov[used].iov_len = entry->param.message.payload.len;
+			used++;
+
+			if (entry->param.message.topic.qos !=
+			    MQTT_QOS_0_AT_MOST_ONCE) {
+				inflight++;
+			}
+		}
+
+		entry->sending = true;
+		(*packets)++;
+	}
+
+	return used;
+}
+
+void mqtt_queue_sent(struct mqtt_client *client, int result)
+{
+	struct mqtt_publish_queue *queue = &client->internal.queue;
+	struct mqtt_queue_entry *entry;
+	uint8_t i;
+
+	for (i = 0U; i < queue->count; i++) {
+		entry = queue_entry(queue, i);
+
+		if (!entry->sending) {
+			continue;
+		}
+
+		entry->sending = false;
+
+		if (entry->state == MQTT_QUEUE_PENDING) {
+			mqtt_publish_sent(client, &entry->param, result);
+		}
+
+		if (result < 0) {
+			continue;
+		}
+
+		if (entry->state == MQTT_QUEUE_RELEASE) {
+			entry->state = MQTT_QUEUE_AWAIT_COMP;
+		} else if (entry->param.message.topic.qos ==
+			   MQTT_QOS_0_AT_MOST_ONCE) {
+			entry->state = MQTT_QUEUE_FREE;
+		} else {
+			entry->state = MQTT_QUEUE_AWAIT_ACK;
+			queue->inflight++;
+		}
+	}
+
+	queue_compact(queue);
+}
+
+void mqtt_queue_ack(struct mqtt_client *client, uint8_t type,
+		    uint16_t message_id, bool failed)
+{
+	struct mqtt_publish_queue *queue = &client->internal.queue;
+	struct mqtt_queue_entry *entry;
+
+	entry = queue_find(queue, message_id);
+	if (entry == NULL) {
+		/* Not a queued message, the application handles it. */
+		return;
+	}
+
+	switch (type) {
+	case MQTT_PKT_TYPE_PUBACK:
+		if (entry->state != MQTT_QUEUE_AWAIT_ACK ||
+		    entry->param.message.topic.qos != MQTT_QOS_1_AT_LEAST_ONCE) {
+			return;
+		}
+
+		entry->state = MQTT_QUEUE_FREE;
+		queue->inflight--;
+		break;
+
+	case MQTT_PKT_TYPE_PUBREC:
+		if (entry->state != MQTT_QUEUE_AWAIT_ACK ||
+		    entry->param.message.topic.qos != MQTT_QOS_2_EXACTLY_ONCE) {
+			return;
+		}
+
+		if (failed) {
+			/* The broker refused the message, nothing to release. */
+			entry->state = MQTT_QUEUE_FREE;
+			queue->inflight--;
+		} else {
+			entry->state = MQTT_QUEUE_RELEASE;
+		}
+		break;
+
+	case MQTT_PKT_TYPE_PUBCOMP:
+		if (entry->state != MQTT_QUEUE_AWAIT_COMP) {
+			return;
+		}
+
+		entry->state = MQTT_QUEUE_FREE;
+		queue->inflight--;
+		break;
+
+	default:
+		return;
+	}
+
+	queue_compact(queue);
+}
+
+void mqtt_queue_reconnect(struct mqtt_client *client, bool session_present)
+{
+	struct mqtt_publish_queue *queue = &client->internal.queue;
+	struct mqtt_queue_entry *entry;
+	uint8_t i;
+
+	for (i = 0U; i < queue->count; i++) {
+		entry = queue_entry(queue, i);
+
+		switch (entry->state) {
+		case MQTT_QUEUE_AWAIT_ACK:
+			entry->state = MQTT_QUEUE_PENDING;
+			/* A new session has no state for the message. */
+			entry->param.dup_flag = session_present ? 1U : 0U;
+			queue->inflight--;
+			break;
+
+		case MQTT_QUEUE_AWAIT_COMP:
+			if (session_present) {
+				entry->state = MQTT_QUEUE_RELEASE;
+			} else {
+				/* The broker dropped the session, the
+				 * message was already delivered.
+				 */
+				entry->state = MQTT_QUEUE_FREE;
+				queue->inflight--;
+			}
+			break;
+
+		case MQTT_QUEUE_RELEASE:
+			if (!session_present) {
+				entry->state = MQTT_QUEUE_FREE;
+				queue->inflight--;
+			}
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	queue_compact(queue);
+}
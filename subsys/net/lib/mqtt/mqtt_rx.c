@@ -16,6 +16,33 @@ LOG_MODULE_REGISTER(net_mqtt_rx, CONFIG_MQTT_LOG_LEVEL);
  * @brief MQTT Received data handling.
  */
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+/** @brief Apply the limits sent by the broker to the new connection. */
+static void connack_apply_v5(struct mqtt_client *client,
+			     const struct mqtt_connack_param *param)
+{
+	client->internal.receive_maximum = param->receive_maximum;
+	client->internal.topic_alias_maximum = param->topic_alias_maximum;
+	client->internal.maximum_packet_size = param->maximum_packet_size;
+	client->internal.maximum_qos = param->maximum_qos;
+	client->internal.shared_subscription =
+		param->shared_subscription_available;
+
+	/* Topic aliases and flow control are per connection. */
+	client->internal.inflight = 0U;
+	memset(client->internal.topic_alias, 0,
+	       sizeof(client->internal.topic_alias));
+}
+
+/** @brief Account a QoS 1 or QoS 2 message acknowledged by the broker. */
+static void inflight_release(struct mqtt_client *client)
+{
+	if (mqtt_is_version_5(client) && client->internal.inflight > 0U) {
+		client->internal.inflight--;
+	}
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 static int mqtt_handle_packet(struct mqtt_client *client,
 			      uint8_t type_and_flags,
 			      uint32_t var_length,
@@ -42,6 +69,16 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 						MQTT_CONNECTION_ACCEPTED) {
 				/* Set state. */
 				MQTT_SET_STATE(client, MQTT_STATE_CONNECTED);
+#if defined(CONFIG_MQTT_VERSION_5_0)
+				if (mqtt_is_version_5(client)) {
+					connack_apply_v5(client,
+							 &evt.param.connack);
+				}
+#endif
+#if defined(CONFIG_MQTT_PUBLISH_QUEUE)
+				mqtt_queue_reconnect(client,
+					evt.param.connack.session_present_flag);
+#endif
 			} else {
 				err_code = -ECONNREFUSED;
 			}
@@ -57,8 +94,16 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		MQTT_TRC("[CID %p]: Received MQTT_PKT_TYPE_PUBLISH", client);
 
 		evt.type = MQTT_EVT_PUBLISH;
-		err_code = publish_decode(type_and_flags, var_length, buf,
-					  &evt.param.publish);
+#if defined(CONFIG_MQTT_VERSION_5_0)
+		if (mqtt_is_version_5(client)) {
+			err_code = publish_decode_v5(type_and_flags, var_length,
+						     buf, &evt.param.publish);
+		} else
+#endif
+		{
+			err_code = publish_decode(type_and_flags, var_length,
+						  buf, &evt.param.publish);
+		}
 		evt.result = err_code;
 
 		client->internal.remaining_payload =
@@ -77,14 +122,47 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		evt.type = MQTT_EVT_PUBACK;
 		err_code = publish_ack_decode(buf, &evt.param.puback);
 		evt.result = err_code;
+#if defined(CONFIG_MQTT_VERSION_5_0)
+		inflight_release(client);
+#endif
+#if defined(CONFIG_MQTT_PUBLISH_QUEUE)
+		if (err_code == 0) {
+			mqtt_queue_ack(client, MQTT_PKT_TYPE_PUBACK,
+				       evt.param.puback.message_id, false);
+		}
+#endif
 		break;
 
 	case MQTT_PKT_TYPE_PUBREC:
 		MQTT_TRC("[CID %p]: Received MQTT_PKT_TYPE_PUBREC!", client);
 
 		evt.type = MQTT_EVT_PUBREC;
-		err_code = publish_receive_decode(buf, &evt.param.pubrec);
+#if defined(CONFIG_MQTT_VERSION_5_0)
+		if (mqtt_is_version_5(client)) {
+			err_code = publish_receive_decode_v5(buf,
+							     &evt.param.pubrec);
+		} else
+#endif
+		{
+			err_code = publish_receive_decode(buf,
+							  &evt.param.pubrec);
+		}
 		evt.result = err_code;
+#if defined(CONFIG_MQTT_VERSION_5_0)
+		/* No PUBCOMP follows a refused message. */
+		if (err_code == 0 &&
+		    mqtt_pubrec_failed(client, &evt.param.pubrec)) {
+			inflight_release(client);
+		}
+#endif
+#if defined(CONFIG_MQTT_PUBLISH_QUEUE)
+		if (err_code == 0) {
+			mqtt_queue_ack(client, MQTT_PKT_TYPE_PUBREC,
+				       evt.param.pubrec.message_id,
+				       mqtt_pubrec_failed(client,
+							  &evt.param.pubrec));
+		}
+#endif
 		break;
 
 	case MQTT_PKT_TYPE_PUBREL:
@@ -101,13 +179,31 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		evt.type = MQTT_EVT_PUBCOMP;
 		err_code = publish_complete_decode(buf, &evt.param.pubcomp);
 		evt.result = err_code;
+#if defined(CONFIG_MQTT_VERSION_5_0)
+		inflight_release(client);
+#endif
+#if defined(CONFIG_MQTT_PUBLISH_QUEUE)
+		if (err_code == 0) {
+			mqtt_queue_ack(client, MQTT_PKT_TYPE_PUBCOMP,
+				       evt.param.pubcomp.message_id, false);
+		}
+#endif
 		break;
 
 	case MQTT_PKT_TYPE_SUBACK:
 		MQTT_TRC("[CID %p]: Received MQTT_PKT_TYPE_SUBACK!", client);
 
 		evt.type = MQTT_EVT_SUBACK;
-		err_code = subscribe_ack_decode(buf, &evt.param.suback);
+#if defined(CONFIG_MQTT_VERSION_5_0)
+		if (mqtt_is_version_5(client)) {
+			err_code = subscribe_ack_decode_v5(buf,
+							   &evt.param.suback);
+		} else
+#endif
+		{
+			err_code = subscribe_ack_decode(buf,
+							&evt.param.suback);
+		}
 		evt.result = err_code;
 		break;
 
@@ -132,6 +228,20 @@ static int mqtt_handle_packet(struct mqtt_client *client,
 		evt.type = MQTT_EVT_PINGRESP;
 		break;
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	case MQTT_PKT_TYPE_DISCONNECT:
+		MQTT_TRC("[CID %p]: Received MQTT_PKT_TYPE_DISCONNECT!", client);
+
+		/* Only MQTT 5.0 brokers may disconnect the client, the
+		 * disconnection is notified once the transport is closed.
+		 */
+		notify_event = false;
+		if (mqtt_is_version_5(client)) {
+			err_code = -ECONNRESET;
+		}
+		break;
+#endif
+
 	default:
 		/* Nothing to notify. */
 		notify_event = false;
@@ -191,6 +301,42 @@ static int mqtt_read_message_chunk(struct mqtt_client *client,
 	return 0;
 }
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+static int mqtt_read_publish_properties(struct mqtt_client *client,
+					struct buf_ctx *buf,
+					uint32_t offset)
+{
+	uint32_t properties_length = 0U;
+	uint8_t length_bytes = 0U;
+	uint8_t byte;
+	int err_code;
+
+	/* Read the variable byte integer of the properties length one byte
+	 * at a time, as the fixed header.
+	 */
+	do {
+		if (length_bytes >= MQTT_MAX_LENGTH_BYTES) {
+			return -EINVAL;
+		}
+
+		err_code = mqtt_read_message_chunk(client, buf,
+						   offset + length_bytes + 1U);
+		if (err_code < 0) {
+			return err_code;
+		}
+
+		byte = buf->cur[offset + length_bytes];
+		properties_length |= (uint32_t)(byte & MQTT_LENGTH_VALUE_MASK)
+				     << (MQTT_LENGTH_SHIFT * length_bytes);
+		length_bytes++;
+	} while ((byte & MQTT_LENGTH_CONTINUATION_BIT) != 0U);
+
+	/* Properties are decoded with the header. */
+	return mqtt_read_message_chunk(client, buf, offset + length_bytes +
+				       properties_length);
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 static int mqtt_read_publish_var_header(struct mqtt_client *client,
 					uint8_t type_and_flags,
 					struct buf_ctx *buf)
@@ -223,6 +369,13 @@ static int mqtt_read_publish_var_header(struct mqtt_client *client,
 		return err_code;
 	}
 
+#if defined(CONFIG_MQTT_VERSION_5_0)
+	if (mqtt_is_version_5(client)) {
+		return mqtt_read_publish_properties(client, buf,
+						    variable_header_length);
+	}
+#endif
+
 	return 0;
 }
 
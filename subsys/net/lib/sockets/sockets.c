@@ -378,6 +378,7 @@ static void zsock_received_cb(struct net_context *ctx,
 	}
 
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
+	net_stats_update_latency(pkt, NET_STATS_LATENCY_RX_TRANSPORT);
 
 	k_fifo_put(&ctx->recv_q, pkt);
 
@@ -934,6 +935,8 @@ error:
 
 void net_socket_update_tc_rx_time(struct net_pkt *pkt, uint32_t end_tick)
 {
+	net_stats_update_latency(pkt, NET_STATS_LATENCY_RX_SOCKET);
+
 	net_pkt_set_rx_stats_tick(pkt, end_tick);
 
 	net_stats_update_tc_rx_time(net_pkt_iface(pkt),
@@ -1081,7 +1084,8 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 		goto fail;
 	}
 
-	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS) &&
+	if ((IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS) ||
+	     IS_ENABLED(CONFIG_NET_PKT_LATENCY_STATS)) &&
 	    !(flags & ZSOCK_MSG_PEEK)) {
 		net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
 	}
@@ -1193,7 +1197,8 @@ static inline ssize_t zsock_recv_stream(struct net_context *ctx,
 					sock_set_eof(ctx);
 				}
 
-				if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS)) {
+				if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS) ||
+				    IS_ENABLED(CONFIG_NET_PKT_LATENCY_STATS)) {
 					net_socket_update_tc_rx_time(
 						pkt, k_cycle_get_32());
 				}
@@ -1283,6 +1288,214 @@ ssize_t z_vrfy_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 #include <syscalls/zsock_recvfrom_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+/* Zero-copy variants are only available for native sockets, as TLS and
+ * offloaded sockets do not keep the payload in network buffers.
+ */
+static struct net_context *get_native_sock_ctx(int sock, struct k_mutex **lock)
+{
+	const struct socket_op_vtable *vtable;
+	void *obj;
+
+	obj = get_sock_vtable(sock, &vtable, lock);
+	if (obj == NULL) {
+		errno = EBADF;
+		return NULL;
+	}
+
+	if (vtable != &sock_fd_op_vtable ||
+	    (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+	     net_if_is_ip_offloaded(net_context_get_iface(obj)))) {
+		errno = EOPNOTSUPP;
+		return NULL;
+	}
+
+	return obj;
+}
+
+/* Detach the unread part of the packet data so that it can be given to the
+ * application. Fragments holding only already parsed headers are released.
+ * With CONFIG_NET_PKT_QUOTA, the detached data stops being accounted when
+ * the packet is freed.
+ */
+static struct net_buf *sock_pkt_detach_payload(struct net_pkt *pkt)
+{
+	struct net_buf *frags;
+
+	while (pkt->buffer && pkt->buffer != pkt->cursor.buf) {
+		pkt->buffer = net_buf_frag_del(NULL, pkt->buffer);
+	}
+
+	frags = pkt->buffer;
+	if (frags) {
+		net_buf_pull(frags, pkt->cursor.pos - frags->data);
+	}
+
+	pkt->buffer = NULL;
+	net_pkt_cursor_init(pkt);
+
+	return frags;
+}
+
+static ssize_t zsock_recv_buf_ctx(struct net_context *ctx,
+				  struct net_buf **frags, int flags,
+				  struct sockaddr *src_addr,
+				  socklen_t *addrlen)
+{
+	enum net_sock_type sock_type = net_context_get_type(ctx);
+	k_timeout_t timeout = K_FOREVER;
+	struct net_pkt *pkt;
+	ssize_t recv_len;
+	int ret;
+
+	if (flags & (ZSOCK_MSG_PEEK | ZSOCK_MSG_WAITALL)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (sock_type == SOCK_STREAM) {
+		if (net_context_get_state(ctx) != NET_CONTEXT_CONNECTED) {
+			errno = ENOTCONN;
+			return -1;
+		}
+
+		if (sock_is_eof(ctx)) {
+			return 0;
+		}
+	} else if (sock_type != SOCK_DGRAM) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else {
+		net_context_get_option(ctx, NET_OPT_RCVTIMEO, &timeout, NULL);
+
+		ret = wait_data(ctx, &timeout);
+		if (ret < 0) {
+			errno = -ret;
+			return -1;
+		}
+	}
+
+	pkt = k_fifo_get(&ctx->recv_q, K_NO_WAIT);
+	if (!pkt) {
+		if (sock_type == SOCK_STREAM && sock_is_eof(ctx)) {
+			return 0;
+		}
+
+		errno = EAGAIN;
+		return -1;
+	}
+
+	if (sock_type == SOCK_STREAM) {
+		if (net_pkt_eof(pkt)) {
+			sock_set_eof(ctx);
+		}
+	} else if (src_addr && addrlen) {
+		ret = sock_get_pkt_src_addr(pkt, net_context_get_ip_proto(ctx),
+					    src_addr, *addrlen);
+		if (ret < 0) {
+			net_pkt_unref(pkt);
+			errno = -ret;
+			return -1;
+		}
+
+		if (src_addr->sa_family == AF_INET) {
+			*addrlen = sizeof(struct sockaddr_in);
+		} else {
+			*addrlen = sizeof(struct sockaddr_in6);
+		}
+	}
+
+	recv_len = net_pkt_remaining_data(pkt);
+	*frags = recv_len ? sock_pkt_detach_payload(pkt) : NULL;
+
+	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS) ||
+	    IS_ENABLED(CONFIG_NET_PKT_LATENCY_STATS)) {
+		net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
+	}
+
+	net_pkt_unref(pkt);
+
+	if (sock_type == SOCK_STREAM) {
+		net_context_update_recv_wnd(ctx, recv_len);
+	}
+
+	return recv_len;
+}
+
+ssize_t zsock_recv_buf(int sock, struct net_buf **frags, int flags,
+		       struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	struct net_context *ctx;
+	struct k_mutex *lock;
+	ssize_t ret;
+
+	if (frags == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	*frags = NULL;
+
+	ctx = get_native_sock_ctx(sock, &lock);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+	ret = zsock_recv_buf_ctx(ctx, frags, flags, src_addr, addrlen);
+	k_mutex_unlock(lock);
+
+	return ret;
+}
+
+ssize_t zsock_send_buf(int sock, struct net_buf *frags, int flags,
+		       const struct sockaddr *dest_addr, socklen_t addrlen)
+{
+	k_timeout_t timeout = K_FOREVER;
+	struct net_context *ctx;
+	struct k_mutex *lock;
+	int status;
+
+	if (frags == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	ctx = get_native_sock_ctx(sock, &lock);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else {
+		net_context_get_option(ctx, NET_OPT_SNDTIMEO, &timeout, NULL);
+	}
+
+	status = net_context_recv(ctx, zsock_received_cb, K_NO_WAIT,
+				  ctx->user_data);
+	if (status == 0) {
+		status = net_context_send_buf(ctx, frags, dest_addr, addrlen,
+					      NULL, timeout, ctx->user_data);
+	}
+
+	k_mutex_unlock(lock);
+
+	if (status < 0) {
+		errno = -status;
+		return -1;
+	}
+
+	return status;
+}
+#endif /* CONFIG_NET_SOCKETS_ZEROCOPY */
+
 /* As this is limited function, we don't follow POSIX signature, with
  * "..." instead of last arg.
  */
@@ -32,8 +32,17 @@ LOG_MODULE_REGISTER(net_sock_tls, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include <mbedtls/ssl_cookie.h>
 #include <mbedtls/error.h>
 #include <mbedtls/debug.h>
+
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS)
+#include <mbedtls/ssl_ticket.h>
+#endif
 #endif /* CONFIG_MBEDTLS */
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE_PERSISTENT)
+#include <stdlib.h>
+#include <settings/settings.h>
+#endif
+
 #include "sockets_internal.h"
 #include "tls_internal.h"
 
@@ -124,6 +133,16 @@ __net_socket struct tls_context {
 		uint32_t dtls_handshake_timeout_min;
 		uint32_t dtls_handshake_timeout_max;
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+		/** DTLS Connection ID usage (TLS_DTLS_CID_*). */
+		int8_t dtls_cid;
+#endif /* CONFIG_NET_SOCKETS_DTLS_CID */
+
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+		/** Information if the client session cache is used. */
+		bool cache_enabled;
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_CACHE */
 	} options;
 
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
@@ -138,8 +157,26 @@ __net_socket struct tls_context {
 
 	/** DTLS peer address length. */
 	socklen_t dtls_peer_addrlen;
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+	/** Connection ID the peer uses in the records it sends. */
+	uint8_t dtls_cid[CONFIG_NET_SOCKETS_DTLS_CID_LEN];
+
+	/** New peer address, used once a record received from it with our
+	 *  Connection ID has been authenticated.
+	 */
+	struct sockaddr dtls_cid_addr;
+
+	/** New peer address length, 0 if there is none. */
+	socklen_t dtls_cid_addrlen;
+#endif /* CONFIG_NET_SOCKETS_DTLS_CID */
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+	/** Information if the last handshake resumed a cached session. */
+	bool session_resumed;
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_CACHE */
+
 #if defined(CONFIG_MBEDTLS)
 	/** mbedTLS context. */
 	mbedtls_ssl_context ssl;
@@ -167,6 +204,47 @@ static struct tls_context tls_contexts[CONFIG_NET_SOCKETS_TLS_MAX_CONTEXTS];
 /* A mutex for protecting TLS context allocation. */
 static struct k_mutex context_lock;
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+/** A TLS session stored by a client. */
+struct tls_session_cache {
+	/** Server the session was negotiated with. */
+	struct sockaddr peer;
+
+	/** Server address length, 0 if the entry is not used. */
+	socklen_t peer_addrlen;
+
+	/** Credentials the session was negotiated with. */
+	struct sec_tag_list sec_tag_list;
+
+	/** Server hostname verified in the handshake, empty if none. */
+	char hostname[CONFIG_NET_SOCKETS_TLS_SESSION_HOSTNAME_LEN + 1];
+
+	/** Length of the serialized session. */
+	uint16_t session_len;
+
+	/** Serialized session (mbedtls_ssl_session_save() format). */
+	uint8_t session[CONFIG_NET_SOCKETS_TLS_SESSION_DATA_LEN];
+};
+
+/* Sessions are replaced in round-robin order, which is the oldest first. */
+static struct tls_session_cache tls_sessions[
+				CONFIG_NET_SOCKETS_TLS_SESSION_CACHE_SIZE];
+static uint8_t tls_session_next;
+
+/* A mutex for protecting the session cache. */
+static K_MUTEX_DEFINE(session_lock);
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_CACHE */
+
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS)
+/* Key material for the session tickets issued by TLS servers. */
+static mbedtls_ssl_ticket_context tls_ticket_ctx;
+
+/* A mutex for protecting the ticket keys, which are shared by all the
+ * server sockets and rotated when the tickets are written.
+ */
+static K_MUTEX_DEFINE(ticket_lock);
+#endif
+
 bool net_socket_is_tls(void *obj)
 {
 	return PART_OF_ARRAY(tls_contexts, (struct tls_context *)obj);
@@ -255,6 +333,44 @@ static int dtls_timing_get_delay(void *data)
 }
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS)
+#if defined(MBEDTLS_GCM_C) && defined(MBEDTLS_AES_C)
+#define TLS_TICKET_CIPHER MBEDTLS_CIPHER_AES_256_GCM
+#elif defined(MBEDTLS_CCM_C) && defined(MBEDTLS_AES_C)
+#define TLS_TICKET_CIPHER MBEDTLS_CIPHER_AES_256_CCM
+#else
+#define TLS_TICKET_CIPHER MBEDTLS_CIPHER_CHACHA20_POLY1305
+#endif
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS */
+
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS)
+static int tls_ticket_write(void *p_ticket, const mbedtls_ssl_session *session,
+			    unsigned char *start, const unsigned char *end,
+			    size_t *tlen, uint32_t *lifetime)
+{
+	int ret;
+
+	k_mutex_lock(&ticket_lock, K_FOREVER);
+	ret = mbedtls_ssl_ticket_write(p_ticket, session, start, end, tlen,
+				       lifetime);
+	k_mutex_unlock(&ticket_lock);
+
+	return ret;
+}
+
+static int tls_ticket_parse(void *p_ticket, mbedtls_ssl_session *session,
+			    unsigned char *buf, size_t len)
+{
+	int ret;
+
+	k_mutex_lock(&ticket_lock, K_FOREVER);
+	ret = mbedtls_ssl_ticket_parse(p_ticket, session, buf, len);
+	k_mutex_unlock(&ticket_lock);
+
+	return ret;
+}
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS */
+
 /* Initialize TLS internals. */
 static int tls_init(const struct device *unused)
 {
@@ -273,6 +389,17 @@ static int tls_init(const struct device *unused)
 	mbedtls_debug_set_threshold(CONFIG_MBEDTLS_DEBUG_LEVEL);
 #endif
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS)
+	mbedtls_ssl_ticket_init(&tls_ticket_ctx);
+
+	if (mbedtls_ssl_ticket_setup(&tls_ticket_ctx, tls_ctr_drbg_random,
+				     NULL, TLS_TICKET_CIPHER,
+				     CONFIG_NET_SOCKETS_TLS_SESSION_TICKET_LIFETIME)
+	    != 0) {
+		NET_ERR("Failed to set up session tickets");
+	}
+#endif
+
 	return 0;
 }
 
@@ -444,28 +571,28 @@ static inline int time_left(uint32_t start, uint32_t timeout)
 	return timeout - elapsed;
 }
 
-#if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
-static bool dtls_is_peer_addr_valid(struct tls_context *context,
-				    const struct sockaddr *peer_addr,
-				    socklen_t addrlen)
+#if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS) || \
+	defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+static bool peer_addr_cmp(const struct sockaddr *peer_addr1,
+			  socklen_t addrlen1,
+			  const struct sockaddr *peer_addr2,
+			  socklen_t addrlen2)
 {
-	if (context->dtls_peer_addrlen != addrlen ||
-	    context->dtls_peer_addr.sa_family != peer_addr->sa_family) {
+	if (addrlen1 != addrlen2 ||
+	    peer_addr1->sa_family != peer_addr2->sa_family) {
 		return false;
 	}
 
-	if (IS_ENABLED(CONFIG_NET_IPV6) && peer_addr->sa_family == AF_INET6) {
-		struct sockaddr_in6 *addr1 = net_sin6(peer_addr);
-		struct sockaddr_in6 *addr2 =
-				net_sin6(&context->dtls_peer_addr);
+	if (IS_ENABLED(CONFIG_NET_IPV6) && peer_addr1->sa_family == AF_INET6) {
+		struct sockaddr_in6 *addr1 = net_sin6(peer_addr1);
+		struct sockaddr_in6 *addr2 = net_sin6(peer_addr2);
 
 		return (addr1->sin6_port == addr2->sin6_port) &&
 			net_ipv6_addr_cmp(&addr1->sin6_addr, &addr2->sin6_addr);
 	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
-		   peer_addr->sa_family == AF_INET) {
-		struct sockaddr_in *addr1 = net_sin(peer_addr);
-		struct sockaddr_in *addr2 =
-				net_sin(&context->dtls_peer_addr);
+		   peer_addr1->sa_family == AF_INET) {
+		struct sockaddr_in *addr1 = net_sin(peer_addr1);
+		struct sockaddr_in *addr2 = net_sin(peer_addr2);
 
 		return (addr1->sin_port == addr2->sin_port) &&
 			net_ipv4_addr_cmp(&addr1->sin_addr, &addr2->sin_addr);
@@ -473,6 +600,333 @@ static bool dtls_is_peer_addr_valid(struct tls_context *context,
 
 	return false;
 }
+#endif
+
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE_PERSISTENT)
+static void tls_session_settings_save(int idx)
+{
+	char path[sizeof("tls/sess/") + 2];
+	int ret;
+
+	snprintk(path, sizeof(path), "tls/sess/%d", idx);
+
+	if (tls_sessions[idx].peer_addrlen == 0) {
+		ret = settings_delete(path);
+	} else {
+		ret = settings_save_one(path, &tls_sessions[idx],
+				offsetof(struct tls_session_cache, session) +
+				tls_sessions[idx].session_len);
+	}
+
+	if (ret < 0) {
+		NET_WARN("Failed to save TLS session %d (%d)", idx, ret);
+	}
+}
+
+static int tls_session_settings_set(const char *name, size_t len,
+				    settings_read_cb read_cb, void *cb_arg)
+{
+	struct tls_session_cache *entry;
+	char *next;
+	ssize_t ret;
+	int idx;
+
+	idx = strtol(name, &next, 10);
+	if (next == name || *next != '\0' || idx < 0 ||
+	    idx >= ARRAY_SIZE(tls_sessions)) {
+		return -ENOENT;
+	}
+
+	if (len < offsetof(struct tls_session_cache, session) ||
+	    len > sizeof(*entry)) {
+		return -EINVAL;
+	}
+
+	entry = &tls_sessions[idx];
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+
+	ret = read_cb(cb_arg, entry, len);
+	if (ret != len || entry->session_len !=
+	    len - offsetof(struct tls_session_cache, session)) {
+		entry->peer_addrlen = 0;
+		ret = -EINVAL;
+	} else {
+		tls_session_next = (idx + 1) % ARRAY_SIZE(tls_sessions);
+		ret = 0;
+	}
+
+	k_mutex_unlock(&session_lock);
+
+	return ret;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(tls_sess, "tls/sess", NULL,
+			       tls_session_settings_set, NULL, NULL);
+#else
+static inline void tls_session_settings_save(int idx)
+{
+	ARG_UNUSED(idx);
+}
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_CACHE_PERSISTENT */
+
+static const char *tls_session_hostname(struct tls_context *context)
+{
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+	if (context->options.is_hostname_set && context->ssl.hostname) {
+		return context->ssl.hostname;
+	}
+#endif
+
+	return "";
+}
+
+static bool sec_tag_list_has(const struct sec_tag_list *list, sec_tag_t tag)
+{
+	int i;
+
+	for (i = 0; i < list->sec_tag_count; i++) {
+		if (list->sec_tags[i] == tag) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Compare the sets of secure tags, the order does not matter. */
+static bool sec_tag_list_cmp(const struct sec_tag_list *list1,
+			     const struct sec_tag_list *list2)
+{
+	int i;
+
+	if (list1->sec_tag_count != list2->sec_tag_count) {
+		return false;
+	}
+
+	for (i = 0; i < list1->sec_tag_count; i++) {
+		if (!sec_tag_list_has(list2, list1->sec_tags[i])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Must be invoked with session lock held. A session is only used again
+ * with the same server address, the same server hostname and the same
+ * credentials, so that it can never authenticate a different server or
+ * client identity than the one it was negotiated for.
+ */
+static struct tls_session_cache *tls_session_find(struct tls_context *context,
+						  const struct sockaddr *addr,
+						  socklen_t addrlen)
+{
+	const char *hostname = tls_session_hostname(context);
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(tls_sessions); i++) {
+		if (tls_sessions[i].peer_addrlen != 0 &&
+		    peer_addr_cmp(&tls_sessions[i].peer,
+				  tls_sessions[i].peer_addrlen,
+				  addr, addrlen) &&
+		    strcmp(tls_sessions[i].hostname, hostname) == 0 &&
+		    sec_tag_list_cmp(&tls_sessions[i].sec_tag_list,
+				     &context->options.sec_tag_list)) {
+			return &tls_sessions[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Try to resume the previous session with the peer in the next handshake.
+ * If the server does not accept it, a full handshake is done.
+ */
+static void tls_session_restore(struct tls_context *context,
+				const struct sockaddr *addr,
+				socklen_t addrlen)
+{
+	struct tls_session_cache *entry;
+	mbedtls_ssl_session session;
+	int ret;
+
+	context->session_resumed = false;
+
+	if (!context->options.cache_enabled) {
+		return;
+	}
+
+	mbedtls_ssl_session_init(&session);
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+
+	entry = tls_session_find(context, addr, addrlen);
+	if (entry) {
+		ret = mbedtls_ssl_session_load(&session, entry->session,
+					       entry->session_len);
+		if (ret == 0) {
+			ret = mbedtls_ssl_set_session(&context->ssl,
+						      &session);
+		}
+
+		if (ret != 0) {
+			NET_DBG("Cannot restore TLS session: -%x", -ret);
+		}
+	}
+
+	k_mutex_unlock(&session_lock);
+
+	mbedtls_ssl_session_free(&session);
+}
+
+/* Must be invoked with session lock held. The server accepted the cached
+ * session if the handshake did not negotiate a new master secret.
+ */
+static bool tls_session_is_resumed(struct tls_session_cache *entry,
+				   const mbedtls_ssl_session *session)
+{
+	mbedtls_ssl_session cached;
+	bool resumed;
+
+	mbedtls_ssl_session_init(&cached);
+
+	resumed = mbedtls_ssl_session_load(&cached, entry->session,
+					   entry->session_len) == 0 &&
+		  memcmp(cached.master, session->master,
+			 sizeof(cached.master)) == 0;
+
+	mbedtls_ssl_session_free(&cached);
+
+	return resumed;
+}
+
+/* Store the session negotiated in a completed handshake. */
+static void tls_session_store(struct tls_context *context,
+			      const struct sockaddr *addr,
+			      socklen_t addrlen)
+{
+	struct tls_session_cache *entry;
+	mbedtls_ssl_session session;
+	size_t len = 0;
+	int ret;
+
+	if (!context->options.cache_enabled ||
+	    addrlen > sizeof(entry->peer) ||
+	    strlen(tls_session_hostname(context)) >=
+						sizeof(entry->hostname)) {
+		return;
+	}
+
+	mbedtls_ssl_session_init(&session);
+
+	ret = mbedtls_ssl_get_session(&context->ssl, &session);
+	if (ret != 0) {
+		goto out;
+	}
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+
+	entry = tls_session_find(context, addr, addrlen);
+	if (entry) {
+		context->session_resumed = tls_session_is_resumed(entry,
+								  &session);
+	} else {
+		entry = &tls_sessions[tls_session_next];
+		tls_session_next = (tls_session_next + 1) %
+						ARRAY_SIZE(tls_sessions);
+	}
+
+	ret = mbedtls_ssl_session_save(&session, entry->session,
+				       sizeof(entry->session), &len);
+	if (ret == 0) {
+		memcpy(&entry->peer, addr, addrlen);
+		entry->peer_addrlen = addrlen;
+		entry->sec_tag_list = context->options.sec_tag_list;
+		strcpy(entry->hostname, tls_session_hostname(context));
+		entry->session_len = len;
+	} else {
+		/* Most likely the session did not fit. */
+		NET_DBG("Cannot store TLS session: -%x (%zu bytes)", -ret,
+			len);
+		entry->peer_addrlen = 0;
+	}
+
+	tls_session_settings_save(entry - tls_sessions);
+
+	k_mutex_unlock(&session_lock);
+
+out:
+	mbedtls_ssl_session_free(&session);
+}
+
+/* Forget the session of a peer, e.g. after a failed handshake. */
+static void tls_session_delete(struct tls_context *context,
+			       const struct sockaddr *addr,
+			       socklen_t addrlen)
+{
+	struct tls_session_cache *entry;
+
+	if (!context->options.cache_enabled) {
+		return;
+	}
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+
+	entry = tls_session_find(context, addr, addrlen);
+	if (entry) {
+		entry->peer_addrlen = 0;
+		tls_session_settings_save(entry - tls_sessions);
+	}
+
+	k_mutex_unlock(&session_lock);
+}
+
+static void tls_session_purge(void)
+{
+	int i;
+
+	k_mutex_lock(&session_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(tls_sessions); i++) {
+		if (tls_sessions[i].peer_addrlen != 0) {
+			tls_sessions[i].peer_addrlen = 0;
+			tls_session_settings_save(i);
+		}
+	}
+
+	k_mutex_unlock(&session_lock);
+}
+#else
+static inline void tls_session_restore(struct tls_context *context,
+				       const struct sockaddr *addr,
+				       socklen_t addrlen)
+{
+}
+
+static inline void tls_session_store(struct tls_context *context,
+				     const struct sockaddr *addr,
+				     socklen_t addrlen)
+{
+}
+
+static inline void tls_session_delete(struct tls_context *context,
+				      const struct sockaddr *addr,
+				      socklen_t addrlen)
+{
+}
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_CACHE */
+
+#if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
+static bool dtls_is_peer_addr_valid(struct tls_context *context,
+				    const struct sockaddr *peer_addr,
+				    socklen_t addrlen)
+{
+	return peer_addr_cmp(&context->dtls_peer_addr,
+			     context->dtls_peer_addrlen,
+			     peer_addr, addrlen);
+}
 
 static void dtls_peer_address_set(struct tls_context *context,
 				  const struct sockaddr *peer_addr,
@@ -494,6 +948,82 @@ static void dtls_peer_address_get(struct tls_context *context,
 	*addrlen = len;
 }
 
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+/* Content type, version, epoch and sequence number precede the CID. */
+#define DTLS_CID_OFFSET 11
+
+/* Check if a datagram received from an unknown address starts with
+ * a record carrying our Connection ID, i.e. the peer might have moved.
+ * The new address is only used after the record has been authenticated,
+ * see dtls_cid_peer_update().
+ */
+static bool dtls_cid_check_new_peer(struct tls_context *context,
+				    const uint8_t *buf, size_t len,
+				    const struct sockaddr *addr,
+				    socklen_t addrlen)
+{
+	if (context->options.dtls_cid != TLS_DTLS_CID_ENABLED ||
+	    !is_handshake_complete(context) ||
+	    addrlen > sizeof(context->dtls_cid_addr) ||
+	    len < DTLS_CID_OFFSET + sizeof(context->dtls_cid) ||
+	    buf[0] != MBEDTLS_SSL_MSG_CID) {
+		return false;
+	}
+
+	if (memcmp(buf + DTLS_CID_OFFSET, context->dtls_cid,
+		   sizeof(context->dtls_cid)) != 0) {
+		return false;
+	}
+
+	memcpy(&context->dtls_cid_addr, addr, addrlen);
+	context->dtls_cid_addrlen = addrlen;
+
+	return true;
+}
+
+static void dtls_cid_peer_update(struct tls_context *context)
+{
+	if (context->dtls_cid_addrlen == 0) {
+		return;
+	}
+
+	NET_DBG("DTLS peer moved to a new address");
+
+	dtls_peer_address_set(context, &context->dtls_cid_addr,
+			      context->dtls_cid_addrlen);
+	context->dtls_cid_addrlen = 0;
+}
+
+static void dtls_cid_peer_clear(struct tls_context *context)
+{
+	context->dtls_cid_addrlen = 0;
+}
+
+static int dtls_cid_setup(struct tls_context *context)
+{
+	size_t len = 0;
+
+	if (context->options.dtls_cid == TLS_DTLS_CID_ENABLED) {
+		len = sizeof(context->dtls_cid);
+		(void)tls_ctr_drbg_random(NULL, context->dtls_cid, len);
+	}
+
+	return mbedtls_ssl_set_cid(&context->ssl, MBEDTLS_SSL_CID_ENABLED,
+				   context->dtls_cid, len);
+}
+#else
+static inline bool dtls_cid_check_new_peer(struct tls_context *context,
+					   const uint8_t *buf, size_t len,
+					   const struct sockaddr *addr,
+					   socklen_t addrlen)
+{
+	return false;
+}
+
+static inline void dtls_cid_peer_update(struct tls_context *context) {}
+static inline void dtls_cid_peer_clear(struct tls_context *context) {}
+#endif /* CONFIG_NET_SOCKETS_DTLS_CID */
+
 static int dtls_tx(void *ctx, const unsigned char *buf, size_t len)
 {
 	struct tls_context *tls_ctx = ctx;
@@ -578,7 +1108,10 @@ static int dtls_rx(void *ctx, unsigned char *buf, size_t len,
 				 */
 				return MBEDTLS_ERR_SSL_PEER_VERIFY_FAILED;
 			}
-		} else if (!dtls_is_peer_addr_valid(tls_ctx, &addr, addrlen)) {
+		} else if (dtls_is_peer_addr_valid(tls_ctx, &addr, addrlen)) {
+			dtls_cid_peer_clear(tls_ctx);
+		} else if (!dtls_cid_check_new_peer(tls_ctx, buf, received,
+						    &addr, addrlen)) {
 			/* Received data from different peer, ignore it. */
 			retry = true;
 
@@ -812,6 +1345,7 @@ static int tls_mbedtls_reset(struct tls_context *context)
 	(void)memset(&context->dtls_peer_addr, 0,
 		     sizeof(context->dtls_peer_addr));
 	context->dtls_peer_addrlen = 0;
+	dtls_cid_peer_clear(context);
 #endif
 
 	return 0;
@@ -925,6 +1459,29 @@ static int tls_mbedtls_init(struct tls_context *context, bool is_server)
 	}
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+	if (type == MBEDTLS_SSL_TRANSPORT_DATAGRAM &&
+	    context->options.dtls_cid != TLS_DTLS_CID_DISABLED) {
+		ret = mbedtls_ssl_conf_cid(
+			&context->config,
+			context->options.dtls_cid == TLS_DTLS_CID_ENABLED ?
+				sizeof(context->dtls_cid) : 0,
+			MBEDTLS_SSL_UNEXPECTED_CID_IGNORE);
+		if (ret != 0) {
+			return -EINVAL;
+		}
+	}
+#endif /* CONFIG_NET_SOCKETS_DTLS_CID */
+
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS)
+	if (role == MBEDTLS_SSL_IS_SERVER) {
+		mbedtls_ssl_conf_session_tickets_cb(&context->config,
+						    tls_ticket_write,
+						    tls_ticket_parse,
+						    &tls_ticket_ctx);
+	}
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS */
+
 #if defined(MBEDTLS_X509_CRT_PARSE_C)
 	/* For TLS clients, set hostname to empty string to enforce it's
 	 * verification - only if hostname option was not set. Otherwise
@@ -971,6 +1528,16 @@ static int tls_mbedtls_init(struct tls_context *context, bool is_server)
 		return -ENOMEM;
 	}
 
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+	if (type == MBEDTLS_SSL_TRANSPORT_DATAGRAM &&
+	    context->options.dtls_cid != TLS_DTLS_CID_DISABLED) {
+		ret = dtls_cid_setup(context);
+		if (ret != 0) {
+			return -EINVAL;
+		}
+	}
+#endif /* CONFIG_NET_SOCKETS_DTLS_CID */
+
 	context->is_initialized = true;
 
 	return 0;
@@ -1290,6 +1857,146 @@ static int tls_opt_dtls_role_set(struct tls_context *context,
 	return 0;
 }
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+static int tls_opt_session_cache_set(struct tls_context *context,
+				     const void *optval, socklen_t optlen)
+{
+	int *val;
+
+	if (!optval) {
+		return -EINVAL;
+	}
+
+	if (optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	val = (int *)optval;
+	if (*val != TLS_SESSION_CACHE_DISABLED &&
+	    *val != TLS_SESSION_CACHE_ENABLED) {
+		return -EINVAL;
+	}
+
+	context->options.cache_enabled = (*val == TLS_SESSION_CACHE_ENABLED);
+
+	return 0;
+}
+
+static int tls_opt_session_cache_get(struct tls_context *context,
+				     void *optval, socklen_t *optlen)
+{
+	if (*optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	*(int *)optval = context->options.cache_enabled ?
+		TLS_SESSION_CACHE_ENABLED : TLS_SESSION_CACHE_DISABLED;
+
+	return 0;
+}
+
+static int tls_opt_session_resumed_get(struct tls_context *context,
+				       void *optval, socklen_t *optlen)
+{
+	if (*optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	*(int *)optval = is_handshake_complete(context) &&
+			 context->session_resumed ? 1 : 0;
+
+	return 0;
+}
+
+static int tls_opt_session_cache_purge_set(struct tls_context *context,
+					   const void *optval,
+					   socklen_t optlen)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(optval);
+	ARG_UNUSED(optlen);
+
+	tls_session_purge();
+
+	return 0;
+}
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_CACHE */
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+static int tls_opt_dtls_cid_set(struct tls_context *context,
+				const void *optval, socklen_t optlen)
+{
+	int *val;
+
+	if (!optval) {
+		return -EINVAL;
+	}
+
+	if (optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	if (context->type != SOCK_DGRAM) {
+		return -EINVAL;
+	}
+
+	/* The extension is negotiated in the handshake. */
+	if (context->is_initialized) {
+		return -EPERM;
+	}
+
+	val = (int *)optval;
+	if (*val != TLS_DTLS_CID_DISABLED &&
+	    *val != TLS_DTLS_CID_SUPPORTED &&
+	    *val != TLS_DTLS_CID_ENABLED) {
+		return -EINVAL;
+	}
+
+	context->options.dtls_cid = *val;
+
+	return 0;
+}
+
+static int tls_opt_dtls_cid_get(struct tls_context *context,
+				void *optval, socklen_t *optlen)
+{
+	if (*optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	*(int *)optval = context->options.dtls_cid;
+
+	return 0;
+}
+
+static int tls_opt_dtls_cid_status_get(struct tls_context *context,
+				       void *optval, socklen_t *optlen)
+{
+	int enabled = MBEDTLS_SSL_CID_DISABLED;
+	int ret;
+
+	if (*optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	if (context->type != SOCK_DGRAM) {
+		return -EINVAL;
+	}
+
+	if (is_handshake_complete(context)) {
+		ret = mbedtls_ssl_get_peer_cid(&context->ssl, &enabled,
+					       NULL, NULL);
+		if (ret != 0) {
+			return -EIO;
+		}
+	}
+
+	*(int *)optval = (enabled == MBEDTLS_SSL_CID_ENABLED) ? 1 : 0;
+
+	return 0;
+}
+#endif /* CONFIG_NET_SOCKETS_DTLS_CID */
+
 static int protocol_check(int family, int type, int *proto)
 {
 	if (family != AF_INET && family != AF_INET6) {
@@ -1410,13 +2117,18 @@ int ztls_connect_ctx(struct tls_context *ctx, const struct sockaddr *addr,
 		/* Do not use any socket flags during the handshake. */
 		ctx->flags = 0;
 
+		tls_session_restore(ctx, addr, addrlen);
+
 		/* TODO For simplicity, TLS handshake blocks the socket
 		 * even for non-blocking socket.
 		 */
 		ret = tls_mbedtls_handshake(ctx, true);
 		if (ret < 0) {
+			tls_session_delete(ctx, addr, addrlen);
 			goto error;
 		}
+
+		tls_session_store(ctx, addr, addrlen);
 	} else {
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 		/* Just store the address. */
@@ -1550,13 +2262,21 @@ static ssize_t sendto_dtls_client(struct tls_context *ctx, const void *buf,
 	}
 
 	if (!is_handshake_complete(ctx)) {
+		tls_session_restore(ctx, &ctx->dtls_peer_addr,
+				    ctx->dtls_peer_addrlen);
+
 		/* TODO For simplicity, TLS handshake blocks the socket even for
 		 * non-blocking socket.
 		 */
 		ret = tls_mbedtls_handshake(ctx, true);
 		if (ret < 0) {
+			tls_session_delete(ctx, &ctx->dtls_peer_addr,
+					   ctx->dtls_peer_addrlen);
 			goto error;
 		}
+
+		tls_session_store(ctx, &ctx->dtls_peer_addr,
+				  ctx->dtls_peer_addrlen);
 	}
 
 	return send_tls(ctx, buf, len, flags);
@@ -1703,6 +2423,8 @@ static ssize_t recvfrom_dtls_common(struct tls_context *ctx, void *buf,
 	if (ret >= 0) {
 		size_t remaining;
 
+		dtls_cid_peer_update(ctx);
+
 		if (src_addr && addrlen) {
 			dtls_peer_address_get(ctx, src_addr, addrlen);
 		}
@@ -2253,6 +2975,26 @@ int ztls_getsockopt_ctx(struct tls_context *ctx, int level, int optname,
 		break;
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+	case TLS_SESSION_CACHE:
+		err = tls_opt_session_cache_get(ctx, optval, optlen);
+		break;
+
+	case TLS_SESSION_RESUMED:
+		err = tls_opt_session_resumed_get(ctx, optval, optlen);
+		break;
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_CACHE */
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+	case TLS_DTLS_CID:
+		err = tls_opt_dtls_cid_get(ctx, optval, optlen);
+		break;
+
+	case TLS_DTLS_CID_STATUS:
+		err = tls_opt_dtls_cid_status_get(ctx, optval, optlen);
+		break;
+#endif /* CONFIG_NET_SOCKETS_DTLS_CID */
+
 	default:
 		/* Unknown or write-only option. */
 		err = -ENOPROTOOPT;
@@ -2314,6 +3056,22 @@ int ztls_setsockopt_ctx(struct tls_context *ctx, int level, int optname,
 		break;
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+	case TLS_SESSION_CACHE:
+		err = tls_opt_session_cache_set(ctx, optval, optlen);
+		break;
+
+	case TLS_SESSION_CACHE_PURGE:
+		err = tls_opt_session_cache_purge_set(ctx, optval, optlen);
+		break;
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_CACHE */
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+	case TLS_DTLS_CID:
+		err = tls_opt_dtls_cid_set(ctx, optval, optlen);
+		break;
+#endif /* CONFIG_NET_SOCKETS_DTLS_CID */
+
 	default:
 		/* Unknown or read-only option. */
 		err = -ENOPROTOOPT;
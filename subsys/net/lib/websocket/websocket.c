@@ -270,6 +270,7 @@ int websocket_connect(int sock, struct websocket_request *wreq,
 	}
 
 	ctx->real_sock = sock;
+	ctx->server = 0;
 	ctx->tmp_buf = wreq->tmp_buf;
 	ctx->tmp_buf_len = wreq->tmp_buf_len;
 	ctx->sec_accept_key = sec_accept_key;
@@ -397,6 +398,61 @@ out:
 	return ret;
 }
 
+int websocket_register(int http_sock, uint8_t *tmp_buf, size_t tmp_buf_len,
+		       const uint8_t *data, size_t len, void *user_data)
+{
+	struct websocket_context *ctx;
+	int fd;
+
+	if (http_sock < 0 || tmp_buf == NULL || tmp_buf_len < MAX_HEADER_LEN ||
+	    (data == NULL && len > 0)) {
+		return -EINVAL;
+	}
+
+	if (len > tmp_buf_len) {
+		return -ENOMEM;
+	}
+
+	ctx = websocket_find(http_sock);
+	if (ctx) {
+		NET_DBG("[%p] Websocket for sock %d already exists!", ctx,
+			http_sock);
+		return -EEXIST;
+	}
+
+	ctx = websocket_get();
+	if (!ctx) {
+		return -ENOENT;
+	}
+
+	ctx->real_sock = http_sock;
+	ctx->tmp_buf = tmp_buf;
+	ctx->tmp_buf_len = tmp_buf_len;
+	ctx->tmp_buf_pos = len;
+	ctx->header_received = 0;
+	ctx->server = 1;
+
+	/* The data is parsed as if it was just received */
+	if (len > 0) {
+		memcpy(tmp_buf, data, len);
+	}
+	ctx->user_data = user_data;
+
+	fd = z_reserve_fd();
+	if (fd < 0) {
+		websocket_context_unref(ctx);
+		return -ENOSPC;
+	}
+
+	ctx->sock = fd;
+	z_finalize_fd(fd, ctx,
+		      (const struct fd_op_vtable *)&websocket_fd_op_vtable);
+
+	NET_DBG("[%p] WS connection from peer accepted (fd %d)", ctx, fd);
+
+	return fd;
+}
+
 int websocket_disconnect(int ws_sock)
 {
 	return close(ws_sock);
@@ -651,6 +707,21 @@ static bool websocket_parse_header(uint8_t *buf, size_t buf_len, bool *masked,
 	return false;
 }
 
+/* Is a whole header already in the temporary buffer */
+static bool websocket_header_buffered(struct websocket_context *ctx)
+{
+	uint32_t mask_value, message_type = 0;
+	uint64_t message_len;
+	size_t header_len;
+	bool masked;
+
+	return ctx->tmp_buf_pos >= MIN_HEADER_LEN &&
+	       websocket_parse_header(ctx->tmp_buf, ctx->tmp_buf_pos, &masked,
+				      &mask_value, &message_len,
+				      &message_type, &header_len) &&
+	       ctx->tmp_buf_pos >= header_len;
+}
+
 int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 		       uint32_t *message_type, uint64_t *remaining, int32_t timeout)
 {
@@ -690,8 +761,11 @@ int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 	}
 #endif /* CONFIG_NET_TEST */
 
-	/* If we have not received the websocket header yet, read it first */
-	if (!ctx->header_received) {
+	/* If we have not received the websocket header yet, read it first,
+	 * unless it is already buffered: handed over by websocket_register()
+	 * or received with the previous message.
+	 */
+	if (!ctx->header_received && !websocket_header_buffered(ctx)) {
 #if defined(CONFIG_NET_TEST)
 		size_t input_len = MIN(ctx->tmp_buf_len - ctx->tmp_buf_pos,
 				       test_data->input_len);
@@ -716,7 +790,9 @@ int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 		}
 
 		ctx->tmp_buf_pos += ret;
+	}
 
+	if (!ctx->header_received) {
 		if (ctx->tmp_buf_pos >= MIN_HEADER_LEN) {
 			bool masked;
 
@@ -871,9 +947,10 @@ static int websocket_send(struct websocket_context *ctx, const uint8_t *buf,
 
 	NET_DBG("[%p] Sending %zd bytes", ctx, buf_len);
 
+	/* Only the client masks the data it sends, RFC 6455 ch 5.1 */
 	ret = websocket_send_msg(ctx->sock, buf, buf_len,
 				 WEBSOCKET_OPCODE_DATA_TEXT,
-				 true, true, timeout);
+				 !ctx->server, true, timeout);
 	if (ret < 0) {
 		errno = -ret;
 		return -1;
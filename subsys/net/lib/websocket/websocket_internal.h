@@ -103,6 +103,9 @@ __net_socket struct websocket_context {
 
 	/** Header received */
 	uint8_t header_received : 1;
+
+	/** Server end of the connection, sent data is not masked */
+	uint8_t server : 1;
 };
 
 /**
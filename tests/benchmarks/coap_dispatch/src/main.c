@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measure the time it takes to dispatch a CoAP request to its resource
+ * with a linear scan and with a dispatch trie, and the time it takes to
+ * look up options in a parsed request.
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <net/coap.h>
+
+#define RESOURCES 64
+#define LOOKUPS 10000
+#define MAX_OPTIONS 8
+/* Root, "sensors", and one "sN" and "value" node per resource */
+#define TRIE_NODES (2 + 2 * RESOURCES)
+
+static char names[RESOURCES][8];
+static const char *paths[RESOURCES][4];
+static struct coap_resource resources[RESOURCES + 1];
+
+static struct coap_resource_trie trie;
+static struct coap_resource_trie_node trie_nodes[TRIE_NODES];
+
+static uint8_t requests[RESOURCES][64];
+static uint16_t request_lens[RESOURCES];
+
+static int handled;
+
+static int resource_get(struct coap_resource *resource,
+			struct coap_packet *request,
+			struct sockaddr *addr, socklen_t addr_len)
+{
+	handled++;
+
+	return 0;
+}
+
+static void test_setup(void)
+{
+	struct coap_packet cpkt;
+	int i, r;
+
+	for (i = 0; i < RESOURCES; i++) {
+		snprintk(names[i], sizeof(names[i]), "s%d", i);
+
+		paths[i][0] = "sensors";
+		paths[i][1] = names[i];
+		paths[i][2] = "value";
+		paths[i][3] = NULL;
+
+		resources[i].get = resource_get;
+		resources[i].path = paths[i];
+
+		r = coap_packet_init(&cpkt, requests[i], sizeof(requests[i]),
+				     1, COAP_TYPE_CON, 0, NULL,
+				     COAP_METHOD_GET, coap_next_id());
+		zassert_equal(r, 0, "Cannot init request %d", i);
+
+		r = coap_packet_append_option(&cpkt, COAP_OPTION_URI_PATH,
+					      "sensors", strlen("sensors"));
+		r |= coap_packet_append_option(&cpkt, COAP_OPTION_URI_PATH,
+					       names[i], strlen(names[i]));
+		r |= coap_packet_append_option(&cpkt, COAP_OPTION_URI_PATH,
+					       "value", strlen("value"));
+		r |= coap_append_option_int(&cpkt, COAP_OPTION_ACCEPT,
+					    COAP_CONTENT_FORMAT_TEXT_PLAIN);
+		zassert_equal(r, 0, "Cannot append options %d", i);
+
+		request_lens[i] = cpkt.offset;
+	}
+
+	r = coap_resource_trie_init(&trie, resources, trie_nodes,
+				    ARRAY_SIZE(trie_nodes));
+	zassert_equal(r, 0, "Cannot build trie (%d)", r);
+
+	TC_PRINT("trie: %d resources, %u nodes\n", RESOURCES,
+		 trie.node_count);
+}
+
+static void dispatch_run(const char *name, bool use_trie)
+{
+	struct coap_option options[MAX_OPTIONS];
+	struct coap_packet cpkt;
+	uint32_t start, cycles = 0U;
+	int i, idx, r;
+
+	handled = 0;
+
+	for (i = 0; i < LOOKUPS; i++) {
+		idx = i % RESOURCES;
+
+		r = coap_packet_parse(&cpkt, requests[idx], request_lens[idx],
+				      options, MAX_OPTIONS);
+		zassert_true(r >= 0, "Cannot parse request %d", idx);
+
+		start = k_cycle_get_32();
+
+		if (use_trie) {
+			r = coap_handle_request_trie(&cpkt, &trie, options,
+						     MAX_OPTIONS, NULL, 0);
+		} else {
+			r = coap_handle_request(&cpkt, resources, options,
+						MAX_OPTIONS, NULL, 0);
+		}
+
+		cycles += k_cycle_get_32() - start;
+
+		zassert_equal(r, 0, "Request %d not handled (%d)", idx, r);
+	}
+
+	zassert_equal(handled, LOOKUPS, "Only %d of %d requests handled",
+		      handled, LOOKUPS);
+
+	TC_PRINT("dispatch (%s): %d resources, %u ns per request\n", name,
+		 RESOURCES, (uint32_t)(k_cyc_to_ns_floor64(cycles) / LOOKUPS));
+}
+
+static void test_dispatch_linear(void)
+{
+	dispatch_run("linear", false);
+}
+
+static void test_dispatch_trie(void)
+{
+	dispatch_run("trie", true);
+}
+
+static void test_dispatch_not_found(void)
+{
+	struct coap_option options[MAX_OPTIONS];
+	struct coap_packet cpkt;
+	uint8_t data[64];
+	int r;
+
+	r = coap_packet_init(&cpkt, data, sizeof(data), 1, COAP_TYPE_CON,
+			     0, NULL, COAP_METHOD_GET, coap_next_id());
+	zassert_equal(r, 0, "Cannot init request");
+
+	r = coap_packet_append_option(&cpkt, COAP_OPTION_URI_PATH,
+				      "sensors", strlen("sensors"));
+	r |= coap_packet_append_option(&cpkt, COAP_OPTION_URI_PATH,
+				       "none", strlen("none"));
+	zassert_equal(r, 0, "Cannot append options");
+
+	r = coap_packet_parse(&cpkt, data, cpkt.offset, options, MAX_OPTIONS);
+	zassert_true(r >= 0, "Cannot parse request");
+
+	r = coap_handle_request(&cpkt, resources, options, MAX_OPTIONS,
+				NULL, 0);
+	zassert_equal(r, -ENOENT, "Linear lookup found a resource");
+
+	r = coap_handle_request_trie(&cpkt, &trie, options, MAX_OPTIONS,
+				     NULL, 0);
+	zassert_equal(r, -ENOENT, "Trie lookup found a resource");
+}
+
+static void test_option_lookup(void)
+{
+	struct coap_option options[MAX_OPTIONS];
+	struct coap_packet cpkt;
+	uint32_t start, cycles = 0U;
+	int i, idx, accept, count, r;
+
+	for (i = 0; i < LOOKUPS; i++) {
+		idx = i % RESOURCES;
+
+		r = coap_packet_parse(&cpkt, requests[idx], request_lens[idx],
+				      NULL, 0);
+		zassert_true(r >= 0, "Cannot parse request %d", idx);
+
+		start = k_cycle_get_32();
+
+		accept = coap_get_option_int(&cpkt, COAP_OPTION_ACCEPT);
+		count = coap_find_options(&cpkt, COAP_OPTION_URI_PATH, options,
+					  MAX_OPTIONS);
+
+		cycles += k_cycle_get_32() - start;
+
+		zassert_equal(accept, COAP_CONTENT_FORMAT_TEXT_PLAIN,
+			      "Wrong accept option in request %d", idx);
+		zassert_equal(count, 3, "Wrong path options in request %d",
+			      idx);
+	}
+
+	TC_PRINT("option lookup: %u ns per request\n",
+		 (uint32_t)(k_cyc_to_ns_floor64(cycles) / LOOKUPS));
+}
+
+void test_main(void)
+{
+	TC_PRINT("option index %s, wildcards %s\n",
+		 IS_ENABLED(CONFIG_COAP_OPTION_INDEX) ? "on" : "off",
+		 IS_ENABLED(CONFIG_COAP_URI_WILDCARD) ? "on" : "off");
+
+	ztest_test_suite(coap_dispatch_perf,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_dispatch_linear),
+			 ztest_unit_test(test_dispatch_trie),
+			 ztest_unit_test(test_dispatch_not_found),
+			 ztest_unit_test(test_option_lookup));
+
+	ztest_run_test_suite(coap_dispatch_perf);
+}
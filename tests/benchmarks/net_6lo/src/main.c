@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measure the time it takes to compress and uncompress the IPHC header of
+ * UDP packets, for the typical address compressions of 6LoWPAN flows.
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <net/net_ip.h>
+#include <net/net_if.h>
+#include <net/net_pkt.h>
+#include <net/udp.h>
+#include <net/dummy.h>
+
+#include "6lo.h"
+#include "icmpv6.h"
+
+#define RUNS 10000
+#define PAYLOAD_LEN 32
+
+static uint8_t src_mac[8] = { 0x00, 0x12, 0x4b, 0x00, 0x00, 0x9e, 0xa3, 0xc2 };
+static uint8_t dst_mac[8] = { 0x00, 0x12, 0x4b, 0x00, 0x00, 0x9e, 0xa3, 0xc3 };
+static uint8_t payload[PAYLOAD_LEN];
+static struct net_if *iface;
+
+static struct net_icmpv6_nd_opt_6co ctx = {
+	.context_len = 0x40,
+	.flag = 0x10,
+	.lifetime = 0xffff,
+	.prefix = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0 } } },
+};
+
+static const struct {
+	const char *name;
+	struct in6_addr src;
+	struct in6_addr dst;
+} flows[] = {
+	/* Addresses derived from the link layer addresses */
+	{ "link-local",
+	  { { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0,
+		0x02, 0x12, 0x4b, 0x00, 0x00, 0x9e, 0xa3, 0xc2 } } },
+	  { { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0,
+		0x02, 0x12, 0x4b, 0x00, 0x00, 0x9e, 0xa3, 0xc3 } } } },
+	{ "multicast",
+	  { { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0,
+		0x02, 0x12, 0x4b, 0x00, 0x00, 0x9e, 0xa3, 0xc2 } } },
+	  { { { 0xff, 0x02, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0x1a } } } },
+	/* Global addresses compressed with a context */
+	{ "context",
+	  { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+		0, 0, 0, 0xff, 0xfe, 0, 0x00, 0x01 } } },
+	  { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+		0, 0, 0, 0xff, 0xfe, 0, 0x00, 0x02 } } } },
+	/* Addresses that are carried inline */
+	{ "global",
+	  { { { 0x20, 0x01, 0x0d, 0xb9, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0x01 } } },
+	  { { { 0x20, 0x01, 0x0d, 0xb9, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0x02 } } } },
+};
+
+static int lo_perf_dev_init(const struct device *dev)
+{
+	return 0;
+}
+
+static void lo_perf_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, src_mac, sizeof(src_mac),
+			     NET_LINK_IEEE802154);
+}
+
+static int lo_perf_send(const struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static struct dummy_api lo_perf_if_api = {
+	.iface_api.init = lo_perf_iface_init,
+	.send = lo_perf_send,
+};
+
+NET_DEVICE_INIT(lo_perf, "lo_perf", lo_perf_dev_init, NULL,
+		NULL, NULL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&lo_perf_if_api, DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2),
+		127);
+
+static struct net_pkt *create_pkt(int flow)
+{
+	struct net_ipv6_hdr ipv6 = {
+		.vtc = 0x60,
+		.len = htons(NET_UDPH_LEN + PAYLOAD_LEN),
+		.nexthdr = IPPROTO_UDP,
+		.hop_limit = 64,
+	};
+	struct net_udp_hdr udp = {
+		.src_port = htons(0xf0b1),
+		.dst_port = htons(0xf0b2),
+		.len = htons(NET_UDPH_LEN + PAYLOAD_LEN),
+	};
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_with_buffer(iface, NET_UDPH_LEN + PAYLOAD_LEN,
+					AF_INET6, IPPROTO_UDP, K_NO_WAIT);
+	zassert_not_null(pkt, "Packet allocation failed");
+
+	net_ipaddr_copy(&ipv6.src, &flows[flow].src);
+	net_ipaddr_copy(&ipv6.dst, &flows[flow].dst);
+
+	zassert_equal(net_pkt_write(pkt, &ipv6, sizeof(ipv6)), 0,
+		      "Cannot write IPv6 header");
+	zassert_equal(net_pkt_write(pkt, &udp, sizeof(udp)), 0,
+		      "Cannot write UDP header");
+	zassert_equal(net_pkt_write(pkt, payload, sizeof(payload)), 0,
+		      "Cannot write payload");
+
+	net_pkt_set_ip_hdr_len(pkt, NET_IPV6H_LEN);
+
+	net_pkt_lladdr_src(pkt)->addr = src_mac;
+	net_pkt_lladdr_src(pkt)->len = sizeof(src_mac);
+	net_pkt_lladdr_dst(pkt)->addr = dst_mac;
+	net_pkt_lladdr_dst(pkt)->len = sizeof(dst_mac);
+
+	net_pkt_cursor_init(pkt);
+
+	return pkt;
+}
+
+static void test_setup(void)
+{
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	zassert_not_null(iface, "No interface");
+
+	net_6lo_set_context(iface, &ctx);
+}
+
+static void test_compress(void)
+{
+	uint32_t start, compress_cycles, uncompress_cycles;
+	uint64_t ns;
+	struct net_pkt *pkt;
+	int i, j;
+
+	for (i = 0; i < ARRAY_SIZE(flows); i++) {
+		compress_cycles = 0U;
+		uncompress_cycles = 0U;
+
+		for (j = 0; j < RUNS; j++) {
+			pkt = create_pkt(i);
+
+			start = k_cycle_get_32();
+			zassert_true(net_6lo_compress(pkt, true) >= 0,
+				     "Compression failed");
+			compress_cycles += k_cycle_get_32() - start;
+
+			start = k_cycle_get_32();
+			zassert_true(net_6lo_uncompress(pkt),
+				     "Uncompression failed");
+			uncompress_cycles += k_cycle_get_32() - start;
+
+			net_pkt_unref(pkt);
+		}
+
+		ns = k_cyc_to_ns_floor64(compress_cycles + uncompress_cycles);
+
+		TC_PRINT("%s: %u ns per compress, %u ns per uncompress, "
+			 "%u packets/s\n", flows[i].name,
+			 (uint32_t)(k_cyc_to_ns_floor64(compress_cycles) / RUNS),
+			 (uint32_t)(k_cyc_to_ns_floor64(uncompress_cycles) /
+				    RUNS),
+			 (uint32_t)(ns ? (uint64_t)RUNS * NSEC_PER_SEC / ns : 0));
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_6lo_perf,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_compress));
+
+	ztest_run_test_suite(net_6lo_perf);
+}
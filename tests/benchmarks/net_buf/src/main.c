@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measure the time it takes to allocate and free the fragments of a packet
+ * one at a time and as a whole chain.
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <net/buf.h>
+
+#define FRAG_SIZE 128
+#define FRAGS 12
+#define RUNS 10000
+
+static const size_t packet_lens[] = { 64, 576, 1280 };
+
+NET_BUF_POOL_FIXED_DEFINE(perf_pool, FRAGS, FRAG_SIZE, NULL);
+
+static struct net_buf *alloc_single(size_t len)
+{
+	struct net_buf *first = NULL;
+	struct net_buf *frag;
+
+	do {
+		frag = net_buf_alloc_fixed(&perf_pool, K_NO_WAIT);
+		zassert_not_null(frag, "Fragment allocation failed");
+
+		if (first) {
+			net_buf_frag_add(first, frag);
+		} else {
+			first = frag;
+		}
+
+		len -= MIN(len, frag->size);
+	} while (len);
+
+	return first;
+}
+
+static struct net_buf *alloc_chain(size_t len)
+{
+	struct net_buf *first;
+
+	first = net_buf_alloc_chain(&perf_pool, len, K_NO_WAIT);
+	zassert_not_null(first, "Chain allocation failed");
+
+	return first;
+}
+
+static void free_single(struct net_buf *first)
+{
+	while (first) {
+		first = net_buf_frag_del(NULL, first);
+	}
+}
+
+static void free_chain(struct net_buf *first)
+{
+	net_buf_unref(first);
+}
+
+static void perf_run(const char *name,
+		     struct net_buf *(*alloc_fn)(size_t len),
+		     void (*free_fn)(struct net_buf *first))
+{
+	uint32_t start, alloc_cycles, free_cycles;
+	struct net_buf *first;
+	size_t len;
+	int i, j;
+
+	for (i = 0; i < ARRAY_SIZE(packet_lens); i++) {
+		len = packet_lens[i];
+		alloc_cycles = 0U;
+		free_cycles = 0U;
+
+		for (j = 0; j < RUNS; j++) {
+			start = k_cycle_get_32();
+			first = alloc_fn(len);
+			alloc_cycles += k_cycle_get_32() - start;
+
+			start = k_cycle_get_32();
+			free_fn(first);
+			free_cycles += k_cycle_get_32() - start;
+		}
+
+		TC_PRINT("%s: %zu bytes, %u ns per alloc, %u ns per free\n",
+			 name, len,
+			 (uint32_t)(k_cyc_to_ns_floor64(alloc_cycles) / RUNS),
+			 (uint32_t)(k_cyc_to_ns_floor64(free_cycles) / RUNS));
+	}
+}
+
+static void test_single(void)
+{
+	perf_run("per fragment", alloc_single, free_single);
+}
+
+static void test_chain(void)
+{
+	perf_run("chain", alloc_chain, free_chain);
+}
+
+void test_main(void)
+{
+	BUILD_ASSERT(FRAGS * FRAG_SIZE >= 1280, "Pool too small");
+
+	ztest_test_suite(net_buf_perf,
+			 ztest_unit_test(test_single),
+			 ztest_unit_test(test_chain));
+
+	ztest_run_test_suite(net_buf_perf);
+}
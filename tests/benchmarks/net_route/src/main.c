@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Measure the time it takes to find a route with different routing table
+ * sizes and lookup algorithms.
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <random/rand32.h>
+
+#include <net/net_ip.h>
+#include <net/net_if.h>
+#include <net/dummy.h>
+
+#include "ipv6.h"
+#include "nbr.h"
+#include "route.h"
+
+#define ROUTES CONFIG_NET_MAX_ROUTES
+#define NEXTHOPS 8
+#define LOOKUPS 10000
+
+static const uint8_t prefix_lens[] = { 48, 56, 64, 96, 128 };
+
+static struct in6_addr nexthops[NEXTHOPS];
+static uint8_t nexthop_ll[NEXTHOPS][6];
+static struct in6_addr dests[ROUTES];
+static struct net_if *iface;
+
+static uint8_t mac_addr[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+
+static int route_perf_dev_init(const struct device *dev)
+{
+	return 0;
+}
+
+static void route_perf_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, mac_addr, sizeof(mac_addr),
+			     NET_LINK_ETHERNET);
+}
+
+static int route_perf_send(const struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static struct dummy_api route_perf_if_api = {
+	.iface_api.init = route_perf_iface_init,
+	.send = route_perf_send,
+};
+
+NET_DEVICE_INIT(route_perf, "route_perf", route_perf_dev_init, NULL,
+		NULL, NULL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&route_perf_if_api, DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2),
+		127);
+
+/* The routes must not overlap, as net_route_add() replaces a route that
+ * already covers the new address.
+ */
+static void route_addr(struct in6_addr *addr, int idx)
+{
+	int i;
+
+	addr->s6_addr16[0] = htons(0x2001);
+	addr->s6_addr16[1] = htons(0x0db8);
+	addr->s6_addr16[2] = htons(idx);
+
+	for (i = 3; i < 8; i++) {
+		addr->s6_addr16[i] = sys_rand32_get();
+	}
+}
+
+static void test_setup(void)
+{
+	struct net_linkaddr lladdr;
+	struct net_nbr *nbr;
+	int i;
+
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	zassert_not_null(iface, "No interface");
+
+	for (i = 0; i < NEXTHOPS; i++) {
+		net_ipv6_addr_create(&nexthops[i], 0xfe80, 0, 0, 0,
+				     0, 0, 0, i + 1);
+
+		memcpy(nexthop_ll[i], mac_addr, sizeof(mac_addr));
+		nexthop_ll[i][5] = 0x10 + i;
+
+		lladdr.addr = nexthop_ll[i];
+		lladdr.len = sizeof(nexthop_ll[i]);
+		lladdr.type = NET_LINK_ETHERNET;
+
+		nbr = net_ipv6_nbr_add(iface, &nexthops[i], &lladdr, false,
+				       NET_IPV6_NBR_STATE_REACHABLE);
+		zassert_not_null(nbr, "Cannot add neighbor %d", i);
+	}
+}
+
+static void test_route_add(void)
+{
+	struct net_route_entry *route;
+	uint32_t start, cycles;
+	int i;
+
+	for (i = 0; i < ROUTES; i++) {
+		route_addr(&dests[i], i);
+	}
+
+	start = k_cycle_get_32();
+
+	for (i = 0; i < ROUTES; i++) {
+		route = net_route_add(iface, &dests[i],
+				      prefix_lens[i % sizeof(prefix_lens)],
+				      &nexthops[i % NEXTHOPS]);
+		zassert_not_null(route, "Route %d add failed", i);
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("route add: %d routes, %u ns per route\n", ROUTES,
+		 (uint32_t)(k_cyc_to_ns_floor64(cycles) / ROUTES));
+}
+
+static void lookup_run(const char *name, bool same_dst)
+{
+	struct net_route_entry *route;
+	struct in6_addr dst;
+	uint32_t start, cycles = 0U;
+	int i, found = 0;
+
+	for (i = 0; i < LOOKUPS; i++) {
+		net_ipaddr_copy(&dst, &dests[same_dst ? 0 : i % ROUTES]);
+
+		start = k_cycle_get_32();
+		route = net_route_lookup(iface, &dst);
+		cycles += k_cycle_get_32() - start;
+
+		if (route) {
+			found++;
+		}
+	}
+
+	zassert_equal(found, LOOKUPS, "Only %d of %d lookups matched",
+		      found, LOOKUPS);
+
+	TC_PRINT("route lookup (%s): %d routes, %u ns per lookup\n", name,
+		 ROUTES, (uint32_t)(k_cyc_to_ns_floor64(cycles) / LOOKUPS));
+}
+
+static void test_route_lookup(void)
+{
+	lookup_run("all destinations", false);
+}
+
+static void test_route_lookup_hot(void)
+{
+	lookup_run("single destination", true);
+}
+
+void test_main(void)
+{
+	TC_PRINT("trie %s, cache size %d\n",
+		 IS_ENABLED(CONFIG_NET_ROUTE_LPM_TRIE) ? "on" : "off",
+		 CONFIG_NET_ROUTE_CACHE_SIZE);
+
+	ztest_test_suite(net_route_perf,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_route_add),
+			 ztest_unit_test(test_route_lookup),
+			 ztest_unit_test(test_route_lookup_hot));
+
+	ztest_run_test_suite(net_route_perf);
+}
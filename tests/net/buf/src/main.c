@@ -66,6 +66,7 @@ static void var_destroy(struct net_buf *buf);
 NET_BUF_POOL_HEAP_DEFINE(bufs_pool, 10, buf_destroy);
 NET_BUF_POOL_FIXED_DEFINE(fixed_pool, 10, 128, fixed_destroy);
 NET_BUF_POOL_VAR_DEFINE(var_pool, 10, 1024, var_destroy);
+NET_BUF_POOL_FIXED_DEFINE(chain_pool, 4, 64, NULL);
 
 static void buf_destroy(struct net_buf *buf)
 {
@@ -434,6 +435,52 @@ static void test_net_buf_fixed_pool(void)
 	zassert_equal(destroy_called, 1, "Incorrect destroy callback count");
 }
 
+static void test_net_buf_alloc_chain(void)
+{
+	struct net_buf *buf, *frag;
+	int count = 0;
+
+	buf = net_buf_alloc_chain(&chain_pool, 200, K_NO_WAIT);
+	zassert_not_null(buf, "Failed to get buffer chain");
+
+	for (frag = buf; frag; frag = frag->frags) {
+		zassert_equal(frag->ref, 1, "Invalid fragment ref");
+		zassert_equal(frag->len, 0, "Invalid fragment length");
+		zassert_equal(net_buf_tailroom(frag), 64,
+			      "Invalid fragment tailroom");
+		count++;
+	}
+
+	zassert_equal(count, 4, "Invalid number of fragments");
+	zassert_is_null(net_buf_alloc_chain(&chain_pool, 1, K_NO_WAIT),
+			"Allocated from an empty pool");
+
+	/* The whole chain is given back at once */
+	net_buf_unref(buf);
+
+	zassert_is_null(net_buf_alloc_chain(&chain_pool, 257, K_NO_WAIT),
+			"Allocated more than the pool size");
+
+	/* A chain which can not be completed is not allocated at all */
+	buf = net_buf_alloc_fixed(&chain_pool, K_NO_WAIT);
+	zassert_not_null(buf, "Failed to get buffer");
+
+	zassert_is_null(net_buf_alloc_chain(&chain_pool, 256, K_MSEC(10)),
+			"Allocated a partial chain");
+
+	frag = net_buf_alloc_chain(&chain_pool, 192, K_NO_WAIT);
+	zassert_not_null(frag, "Partial chain not given back");
+	zassert_equal(net_buf_frags_len(frag), 0, "Invalid chain length");
+
+	net_buf_frag_add(buf, frag);
+	net_buf_unref(buf);
+
+	buf = net_buf_alloc_chain(&chain_pool, 256, K_NO_WAIT);
+	zassert_not_null(buf, "Chain not given back");
+
+	net_buf_unref(buf);
+}
+
 static void test_net_buf_var_pool(void)
 {
 	struct net_buf *buf1, *buf2, *buf3;
@@ -691,6 +738,7 @@ void test_main(void)
 			 ztest_unit_test(test_net_buf_multi_frags),
 			 ztest_unit_test(test_net_buf_clone),
 			 ztest_unit_test(test_net_buf_fixed_pool),
+			 ztest_unit_test(test_net_buf_alloc_chain),
 			 ztest_unit_test(test_net_buf_var_pool),
 			 ztest_unit_test(test_net_buf_byte_order)
 			 );
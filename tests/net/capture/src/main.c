@@ -0,0 +1,513 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_CAPTURE_LOCAL_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <string.h>
+#include <errno.h>
+#include <device.h>
+#include <sys/byteorder.h>
+#include <net/buf.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_ip.h>
+#include <net/dummy.h>
+#include <net/capture.h>
+
+#include <ztest.h>
+
+#define PCAPNG_SHB 0x0A0D0D0A
+#define PCAPNG_IDB 0x00000001
+#define PCAPNG_EPB 0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D
+#define LINKTYPE_RAW 101
+
+#define SHB_LEN 28
+#define IDB_LEN 20
+#define EPB_HDR_LEN 28
+#define EPB_OVERHEAD (EPB_HDR_LEN + 4)
+
+#define BUF_SIZE ROUND_DOWN(CONFIG_NET_CAPTURE_LOCAL_BUF_SIZE, 4)
+
+#define IPV4_HDR_LEN 20
+#define IPV6_HDR_LEN 40
+#define UDP_HDR_LEN 8
+
+/* IPv4 UDP packet with a 12 byte payload, 72 bytes in the buffer */
+#define PKT_LEN (IPV4_HDR_LEN + UDP_HDR_LEN + 12)
+#define PKT_BLOCK_LEN (EPB_OVERHEAD + PKT_LEN)
+
+#define SRC4 "192.0.2.1"
+#define DST4 "192.0.2.2"
+#define SRC6 "2001:db8::1"
+#define DST6 "2001:db8::2"
+
+static struct net_if *iface;
+
+static uint8_t read_buf[SHB_LEN + 4 * IDB_LEN + BUF_SIZE];
+static size_t read_len;
+
+static int dummy_send(const struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static struct dummy_api dummy_if_api = {
+	.send = dummy_send,
+};
+
+NET_DEVICE_INIT(capture_test, "capture_test", NULL, NULL, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &dummy_if_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 1500);
+
+/* Raw IP packet as seen on the dummy interface, the payload is filled
+ * with the source port.
+ */
+static struct net_pkt *pkt_create(sa_family_t family, uint8_t proto,
+				  uint16_t sport, uint16_t dport, size_t len)
+{
+	size_t ip_len = family == AF_INET6 ? IPV6_HDR_LEN : IPV4_HDR_LEN;
+	uint8_t data[256];
+	struct net_pkt *pkt;
+
+	zassert_true(len >= ip_len + UDP_HDR_LEN && len <= sizeof(data),
+		     "invalid packet length %zu", len);
+
+	memset(data, 0, len);
+
+	if (family == AF_INET6) {
+		data[0] = 0x60;
+		sys_put_be16(len - ip_len, data + 4);
+		data[6] = proto;
+		data[7] = 64;
+		net_addr_pton(AF_INET6, SRC6, data + 8);
+		net_addr_pton(AF_INET6, DST6, data + 24);
+	} else {
+		data[0] = 0x45;
+		sys_put_be16(len, data + 2);
+		data[8] = 64;
+		data[9] = proto;
+		net_addr_pton(AF_INET, SRC4, data + 12);
+		net_addr_pton(AF_INET, DST4, data + 16);
+	}
+
+	sys_put_be16(sport, data + ip_len);
+	sys_put_be16(dport, data + ip_len + 2);
+	sys_put_be16(len - ip_len, data + ip_len + 4);
+	memset(data + ip_len + UDP_HDR_LEN, (uint8_t)sport,
+	       len - ip_len - UDP_HDR_LEN);
+
+	pkt = net_pkt_alloc_with_buffer(iface, len, AF_UNSPEC, 0, K_NO_WAIT);
+	zassert_not_null(pkt, "cannot allocate packet");
+	zassert_equal(net_pkt_write(pkt, data, len), 0, "cannot write packet");
+
+	return pkt;
+}
+
+static void pkt_capture(sa_family_t family, uint8_t proto, uint16_t sport,
+			uint16_t dport, size_t len)
+{
+	struct net_pkt *pkt = pkt_create(family, proto, sport, dport, len);
+
+	net_capture_pkt(iface, pkt);
+	net_pkt_unref(pkt);
+}
+
+static void capture_start(const char *filter, uint16_t snaplen)
+{
+	int ret;
+
+	net_capture_local_clear();
+
+	ret = net_capture_local_start(iface, filter, snaplen);
+	zassert_equal(ret, 0, "cannot start capture with \"%s\" (%d)",
+		      filter ? filter : "", ret);
+}
+
+/* Run one packet through a filter and tell whether it was captured */
+static bool filter_match(const char *filter, sa_family_t family,
+			 uint8_t proto, uint16_t sport, uint16_t dport,
+			 size_t len)
+{
+	struct net_capture_local_stats stats;
+
+	capture_start(filter, 0);
+	pkt_capture(family, proto, sport, dport, len);
+	zassert_equal(net_capture_local_stop(), 0, "cannot stop capture");
+
+	net_capture_local_get_stats(&stats);
+
+	zassert_equal(stats.captured + stats.filtered, 1,
+		      "packet not seen by \"%s\"", filter ? filter : "");
+
+	return stats.captured == 1;
+}
+
+#define MATCH4(filter, proto, sport, dport)				\
+	filter_match(filter, AF_INET, proto, sport, dport, PKT_LEN)
+
+#define MATCH6(filter, proto, sport, dport)				\
+	filter_match(filter, AF_INET6, proto, sport, dport,		\
+		     IPV6_HDR_LEN + UDP_HDR_LEN)
+
+static void test_setup(void)
+{
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	zassert_not_null(iface, "no interface");
+}
+
+static void test_filter_invalid(void)
+{
+	static const char * const filters[] = {
+		"foo", "src", "src tcp", "dst udp", "src less 10", "host",
+		"host 192.0.2.x", "host 2001:db8::g", "port", "port http",
+		"port 65536", "less", "greater x", "(tcp", "tcp )", "()",
+		"tcp and", "or udp", "tcp udp", "not", "tcp && || udp",
+		"host 2001:0db8:0000:0000:0000:0000:0000:0000:1",
+	};
+	char filter[128] = "tcp";
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(filters); i++) {
+		zassert_equal(net_capture_local_start(iface, filters[i], 0),
+			      -EINVAL, "\"%s\" accepted", filters[i]);
+	}
+
+	/* One operation more than the program holds */
+	for (i = 0; i < CONFIG_NET_CAPTURE_LOCAL_FILTER_LEN / 2; i++) {
+		strcat(filter, " or tcp");
+	}
+
+	zassert_equal(net_capture_local_start(iface, filter, 0), -ENOMEM,
+		      "too long filter accepted");
+	zassert_false(net_capture_local_is_started(), "capture started");
+
+	/* An empty filter captures everything */
+	zassert_true(MATCH4(NULL, IPPROTO_UDP, 1, 2), "packet filtered");
+	zassert_true(MATCH4("  ", IPPROTO_UDP, 1, 2), "packet filtered");
+
+	capture_start("udp", 0);
+	zassert_equal(net_capture_local_start(iface, "tcp", 0), -EALREADY,
+		      "capture started twice");
+	zassert_equal(net_capture_local_stop(), 0, "cannot stop capture");
+	zassert_equal(net_capture_local_stop(), -EALREADY,
+		      "capture stopped twice");
+}
+
+static void test_filter_proto(void)
+{
+	zassert_true(MATCH4("ip", IPPROTO_UDP, 1, 2), "ip not matched");
+	zassert_false(MATCH4("ip6", IPPROTO_UDP, 1, 2), "ip6 matched");
+	zassert_true(MATCH6("ip6", IPPROTO_UDP, 1, 2), "ip6 not matched");
+	zassert_false(MATCH6("ip", IPPROTO_UDP, 1, 2), "ip matched");
+	zassert_false(MATCH4("arp", IPPROTO_UDP, 1, 2), "arp matched");
+
+	zassert_true(MATCH4("udp", IPPROTO_UDP, 1, 2), "udp not matched");
+	zassert_false(MATCH4("tcp", IPPROTO_UDP, 1, 2), "tcp matched");
+	zassert_true(MATCH6("tcp", IPPROTO_TCP, 1, 2), "tcp not matched");
+	zassert_true(MATCH4("not tcp", IPPROTO_UDP, 1, 2), "not failed");
+	zassert_false(MATCH4("!udp", IPPROTO_UDP, 1, 2), "! failed");
+	zassert_true(MATCH4("not not udp", IPPROTO_UDP, 1, 2),
+		     "double not failed");
+}
+
+static void test_filter_precedence(void)
+{
+	/* and binds tighter than or */
+	zassert_true(MATCH4("udp or tcp and port 80", IPPROTO_UDP, 53, 53),
+		     "and applied to udp");
+	zassert_true(MATCH4("udp or tcp and port 80", IPPROTO_TCP, 80, 1),
+		     "tcp port 80 not matched");
+	zassert_false(MATCH4("udp or tcp and port 80", IPPROTO_TCP, 81, 1),
+		      "and not applied to tcp");
+	zassert_true(MATCH4("tcp and port 80 || udp", IPPROTO_UDP, 53, 53),
+		     "and applied to udp");
+
+	/* Parentheses override it */
+	zassert_false(MATCH4("(udp or tcp) and port 80", IPPROTO_UDP, 53, 53),
+		      "and not applied to udp");
+	zassert_true(MATCH4("(udp || tcp) && port 80", IPPROTO_UDP, 80, 53),
+		     "udp port 80 not matched");
+
+	/* not binds tighter than and */
+	zassert_true(MATCH4("not udp and port 53", IPPROTO_TCP, 53, 1),
+		     "tcp port 53 not matched");
+	zassert_false(MATCH4("not udp and port 53", IPPROTO_UDP, 1, 2),
+		      "not applied to the and");
+	zassert_true(MATCH4("not (udp and port 53)", IPPROTO_UDP, 1, 2),
+		     "not not applied to the and");
+
+	/* Operators are applied left to right */
+	zassert_true(MATCH4("tcp or icmp or udp", IPPROTO_UDP, 1, 2),
+		     "last or not matched");
+	zassert_false(MATCH4("udp and port 1 and port 3", IPPROTO_UDP, 1, 2),
+		      "last and not applied");
+}
+
+static void test_filter_src_dst(void)
+{
+	zassert_true(MATCH4("host " SRC4, IPPROTO_UDP, 1, 2),
+		     "source host not matched");
+	zassert_true(MATCH4("host " DST4, IPPROTO_UDP, 1, 2),
+		     "destination host not matched");
+	zassert_false(MATCH4("host 192.0.2.3", IPPROTO_UDP, 1, 2),
+		      "other host matched");
+	zassert_true(MATCH4("src host " SRC4, IPPROTO_UDP, 1, 2),
+		     "src host not matched");
+	zassert_false(MATCH4("dst host " SRC4, IPPROTO_UDP, 1, 2),
+		      "dst host matched the source");
+	zassert_true(MATCH4("dst host " DST4, IPPROTO_UDP, 1, 2),
+		     "dst host not matched");
+	zassert_false(MATCH4("src host " DST4, IPPROTO_UDP, 1, 2),
+		      "src host matched the destination");
+
+	zassert_true(MATCH6("src host " SRC6, IPPROTO_UDP, 1, 2),
+		     "IPv6 src host not matched");
+	zassert_false(MATCH6("src host " DST6, IPPROTO_UDP, 1, 2),
+		      "IPv6 src host matched the destination");
+	zassert_false(MATCH6("host " SRC4, IPPROTO_UDP, 1, 2),
+		      "IPv4 host matched an IPv6 packet");
+	zassert_false(MATCH4("host " SRC6, IPPROTO_UDP, 1, 2),
+		      "IPv6 host matched an IPv4 packet");
+
+	zassert_true(MATCH4("port 1", IPPROTO_UDP, 1, 2),
+		     "source port not matched");
+	zassert_true(MATCH4("port 2", IPPROTO_UDP, 1, 2),
+		     "destination port not matched");
+	zassert_true(MATCH4("src port 1", IPPROTO_UDP, 1, 2),
+		     "src port not matched");
+	zassert_false(MATCH4("dst port 1", IPPROTO_UDP, 1, 2),
+		      "dst port matched the source");
+	zassert_true(MATCH6("dst port 0x35", IPPROTO_TCP, 1, 53),
+		     "hex dst port not matched");
+	zassert_false(MATCH4("port 1", IPPROTO_ICMP, 1, 2),
+		      "port matched an ICMP packet");
+}
+
+static void test_filter_len(void)
+{
+	zassert_true(MATCH4("less 40", IPPROTO_UDP, 1, 2), "less failed");
+	zassert_false(MATCH4("less 39", IPPROTO_UDP, 1, 2), "less failed");
+	zassert_true(MATCH4("greater 40", IPPROTO_UDP, 1, 2),
+		     "greater failed");
+	zassert_false(MATCH4("greater 41", IPPROTO_UDP, 1, 2),
+		      "greater failed");
+}
+
+static int read_cb(const void *data, size_t len, void *user_data)
+{
+	zassert_true(read_len + len <= sizeof(read_buf), "read too long");
+
+	memcpy(read_buf + read_len, data, len);
+	read_len += len;
+
+	return 0;
+}
+
+static uint32_t get32(size_t off)
+{
+	uint32_t val;
+
+	memcpy(&val, read_buf + off, sizeof(val));
+
+	return val;
+}
+
+static void count_iface_cb(struct net_if *iface, void *user_data)
+{
+	(*(int *)user_data)++;
+}
+
+/* Validate the pcapng file read from the capture, and return the offset
+ * of the first packet block.
+ */
+static size_t check_pcapng_header(void)
+{
+	size_t off = SHB_LEN;
+	int ifaces = 0;
+	int i;
+
+	read_len = 0;
+	zassert_equal(net_capture_local_read(read_cb, NULL), 0,
+		      "cannot read capture");
+
+	zassert_true(read_len >= SHB_LEN, "no section header");
+	zassert_equal(get32(0), PCAPNG_SHB, "invalid section header");
+	zassert_equal(get32(4), SHB_LEN, "invalid section header length");
+	zassert_equal(get32(8), PCAPNG_BYTE_ORDER_MAGIC, "invalid magic");
+	zassert_equal(get32(SHB_LEN - 4), SHB_LEN, "invalid trailing length");
+
+	net_if_foreach(count_iface_cb, &ifaces);
+
+	for (i = 0; i < ifaces; i++, off += IDB_LEN) {
+		zassert_true(off + IDB_LEN <= read_len, "no interface block");
+		zassert_equal(get32(off), PCAPNG_IDB, "invalid interface block");
+		zassert_equal(get32(off + 4), IDB_LEN,
+			      "invalid interface block length");
+		zassert_equal(get32(off + IDB_LEN - 4), IDB_LEN,
+			      "invalid trailing length");
+	}
+
+	i = net_if_get_by_iface(iface) - 1;
+	zassert_equal(get32(SHB_LEN + i * IDB_LEN + 8) & 0xffff, LINKTYPE_RAW,
+		      "invalid link type");
+
+	return off;
+}
+
+/* Check the next packet block and return the offset of the following
+ * one.
+ */
+static size_t check_epb(size_t off, uint16_t sport, size_t caplen,
+			size_t origlen)
+{
+	size_t block_len = EPB_OVERHEAD + ROUND_UP(caplen, 4);
+	size_t ip_len = IPV4_HDR_LEN;
+
+	zassert_true(off + EPB_HDR_LEN <= read_len, "no packet block");
+	zassert_equal(get32(off), PCAPNG_EPB, "invalid packet block");
+	zassert_equal(get32(off + 4), block_len, "invalid block length %u",
+		      get32(off + 4));
+	zassert_true(off + block_len <= read_len, "packet block cut");
+	zassert_equal(get32(off + block_len - 4), block_len,
+		      "invalid trailing length");
+	zassert_equal(get32(off + 8), net_if_get_by_iface(iface) - 1,
+		      "invalid interface id");
+	zassert_equal(get32(off + 20), caplen, "invalid captured length");
+	zassert_equal(get32(off + 24), origlen, "invalid original length");
+
+	off += EPB_HDR_LEN;
+
+	zassert_equal(read_buf[off] & 0xf0, 0x40, "invalid packet data");
+	zassert_equal(sys_get_be16(read_buf + off + ip_len), sport,
+		      "packet %u expected, %u found", sport,
+		      sys_get_be16(read_buf + off + ip_len));
+
+	if (caplen > ip_len + UDP_HDR_LEN) {
+		zassert_equal(read_buf[off + caplen - 1], (uint8_t)sport,
+			      "invalid payload");
+	}
+
+	return off + block_len - EPB_HDR_LEN;
+}
+
+static void test_ring_wrap(void)
+{
+	int fit = BUF_SIZE / PKT_BLOCK_LEN;
+	int count = 3 * fit + 1;
+	struct net_capture_local_stats stats;
+	size_t off;
+	int i;
+
+	capture_start(NULL, 0);
+
+	/* The blocks do not divide the buffer size so they wrap at
+	 * changing places.
+	 */
+	for (i = 0; i < count; i++) {
+		pkt_capture(AF_INET, IPPROTO_UDP, i, 0, PKT_LEN);
+	}
+
+	zassert_equal(net_capture_local_stop(), 0, "cannot stop capture");
+
+	net_capture_local_get_stats(&stats);
+	zassert_equal(stats.captured, count, "invalid captured count %u",
+		      stats.captured);
+	zassert_equal(stats.overwritten, count - fit,
+		      "invalid overwritten count %u", stats.overwritten);
+	zassert_equal(stats.truncated, 0, "packets truncated");
+
+	/* Only the newest packets are left, in order */
+	off = check_pcapng_header();
+
+	for (i = count - fit; i < count; i++) {
+		off = check_epb(off, i, PKT_LEN, PKT_LEN);
+	}
+
+	zassert_equal(off, read_len, "trailing data");
+}
+
+static void test_ring_snaplen(void)
+{
+	struct net_capture_local_stats stats;
+	size_t caplen = IPV4_HDR_LEN + UDP_HDR_LEN + 2;
+	size_t off;
+	int i;
+
+	/* The captured data is padded to keep the blocks aligned */
+	capture_start("udp", caplen);
+
+	for (i = 0; i < 2; i++) {
+		pkt_capture(AF_INET, IPPROTO_UDP, 100 + i, 0, PKT_LEN);
+	}
+
+	zassert_equal(net_capture_local_stop(), 0, "cannot stop capture");
+
+	net_capture_local_get_stats(&stats);
+	zassert_equal(stats.captured, 2, "invalid captured count");
+	zassert_equal(stats.truncated, 2, "packets not truncated");
+	zassert_equal(stats.overwritten, 0, "packets overwritten");
+
+	off = check_pcapng_header();
+	off = check_epb(off, 100, caplen, PKT_LEN);
+	off = check_epb(off, 101, caplen, PKT_LEN);
+
+	zassert_equal(off, read_len, "trailing data");
+}
+
+static void test_ring_full_block(void)
+{
+	struct net_capture_local_stats stats;
+	size_t caplen = BUF_SIZE - EPB_OVERHEAD - 3;
+	size_t off;
+
+	/* The snap length is limited to what fits the buffer, the first
+	 * packet fills the buffer and is overwritten by the second one.
+	 */
+	capture_start(NULL, UINT16_MAX);
+
+	pkt_capture(AF_INET, IPPROTO_UDP, 200, 0, caplen + 8);
+	pkt_capture(AF_INET, IPPROTO_UDP, 201, 0, caplen + 8);
+
+	zassert_equal(net_capture_local_stop(), 0, "cannot stop capture");
+
+	net_capture_local_get_stats(&stats);
+	zassert_equal(stats.captured, 2, "invalid captured count");
+	zassert_equal(stats.truncated, 2, "packets not truncated");
+	zassert_equal(stats.overwritten, 1, "invalid overwritten count");
+
+	off = check_pcapng_header();
+	off = check_epb(off, 201, caplen, caplen + 8);
+
+	zassert_equal(off, read_len, "trailing data");
+
+	/* Clearing empties the buffer and the statistics */
+	net_capture_local_clear();
+	net_capture_local_get_stats(&stats);
+	zassert_equal(stats.captured, 0, "statistics not cleared");
+
+	off = check_pcapng_header();
+	zassert_equal(off, read_len, "buffer not cleared");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_capture_local,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_filter_invalid),
+			 ztest_unit_test(test_filter_proto),
+			 ztest_unit_test(test_filter_precedence),
+			 ztest_unit_test(test_filter_src_dst),
+			 ztest_unit_test(test_filter_len),
+			 ztest_unit_test(test_ring_wrap),
+			 ztest_unit_test(test_ring_snaplen),
+			 ztest_unit_test(test_ring_full_block));
+
+	ztest_run_test_suite(net_capture_local);
+}
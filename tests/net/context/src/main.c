@@ -30,6 +30,8 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_CONTEXT_LOG_LEVEL);
 #include <net/udp.h>
 
 #include "net_private.h"
+#include "ipv4.h"
+#include "udp_internal.h"
 
 #if defined(CONFIG_NET_CONTEXT_LOG_LEVEL_DBG)
 #define DBG(fmt, ...) printk(fmt, ##__VA_ARGS__)
@@ -825,6 +827,147 @@ static void test_net_ctx_recv_v4_timeout_forever(void)
 	recv_cb_timeout_called = false;
 }
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+#define FLOOD_PORT 1970
+#define OTHER_PORT 1971
+
+/* The flooded context holds at most its share of the RX pool */
+#define FLOOD_QUOTA (CONFIG_NET_PKT_RX_COUNT * \
+		     CONFIG_NET_PKT_QUOTA_CONTEXT / 100)
+
+static struct net_pkt *flood_pkts[CONFIG_NET_PKT_RX_COUNT];
+static int flood_count;
+static K_SEM_DEFINE(flood_recv, 0, UINT_MAX);
+static K_SEM_DEFINE(other_recv, 0, UINT_MAX);
+
+static void flood_recv_cb(struct net_context *context,
+			  struct net_pkt *pkt,
+			  union net_ip_header *ip_hdr,
+			  union net_proto_header *proto_hdr,
+			  int status,
+			  void *user_data)
+{
+	/* Nobody reads the flooded context */
+	if (flood_count < ARRAY_SIZE(flood_pkts)) {
+		flood_pkts[flood_count++] = pkt;
+	} else {
+		net_pkt_unref(pkt);
+	}
+
+	k_sem_give(&flood_recv);
+}
+
+static void other_recv_cb(struct net_context *context,
+			  struct net_pkt *pkt,
+			  union net_ip_header *ip_hdr,
+			  union net_proto_header *proto_hdr,
+			  int status,
+			  void *user_data)
+{
+	net_pkt_unref(pkt);
+	k_sem_give(&other_recv);
+}
+
+static struct net_context *quota_ctx_get(uint16_t port,
+					 net_context_recv_cb_t cb)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(port),
+		.sin_addr = { { { 192, 0, 2, 1 } } },
+	};
+	struct net_context *context;
+	int ret;
+
+	ret = net_context_get(AF_INET, SOCK_DGRAM, IPPROTO_UDP, &context);
+	zassert_equal(ret, 0, "Context get failed");
+
+	ret = net_context_bind(context, (struct sockaddr *)&addr,
+			       sizeof(addr));
+	zassert_equal(ret, 0, "Context bind failed");
+
+	ret = net_context_recv(context, cb, K_NO_WAIT, NULL);
+	zassert_equal(ret, 0, "Context recv failed");
+
+	return context;
+}
+
+static void recv_udp_v4(uint16_t port)
+{
+	struct in_addr peer = { { { 192, 0, 2, 2 } } };
+	struct net_if *iface;
+	struct net_pkt *pkt;
+
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface, strlen(test_data), AF_INET,
+					   IPPROTO_UDP, K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate packet");
+
+	zassert_equal(net_ipv4_create(pkt, &peer, &in4addr_my), 0,
+		      "Cannot create IPv4 header");
+	zassert_equal(net_udp_create(pkt, htons(PEER_PORT), htons(port)), 0,
+		      "Cannot create UDP header");
+	zassert_equal(net_pkt_write(pkt, test_data, strlen(test_data)), 0,
+		      "Cannot write data");
+
+	net_pkt_cursor_init(pkt);
+	zassert_equal(net_ipv4_finalize(pkt, IPPROTO_UDP), 0,
+		      "Cannot finalize packet");
+
+	zassert_equal(net_recv_data(iface, pkt), 0, "Cannot receive packet");
+}
+
+static void test_net_ctx_recv_quota(void)
+{
+	struct net_context *flood_ctx, *other_ctx;
+	int i;
+
+	flood_ctx = quota_ctx_get(FLOOD_PORT, flood_recv_cb);
+	other_ctx = quota_ctx_get(OTHER_PORT, other_recv_cb);
+
+	/* Once the pool runs low, the flooded context gets no more than
+	 * its quota, the next packets are dropped.
+	 */
+	for (i = 0; i <= FLOOD_QUOTA; i++) {
+		recv_udp_v4(FLOOD_PORT);
+	}
+
+	for (i = 0; i < FLOOD_QUOTA; i++) {
+		zassert_equal(k_sem_take(&flood_recv, WAIT_TIME), 0,
+			      "Packet %d not received", i);
+	}
+
+	zassert_equal(k_sem_take(&flood_recv, WAIT_TIME), -EAGAIN,
+		      "Packet received over quota");
+	zassert_equal(atomic_get(&flood_ctx->pkt_usage.pkts), FLOOD_QUOTA,
+		      "Context usage not accounted");
+
+	/* The other context still receives */
+	recv_udp_v4(OTHER_PORT);
+
+	zassert_equal(k_sem_take(&other_recv, WAIT_TIME), 0,
+		      "Packet not received by the other context");
+
+	for (i = 0; i < flood_count; i++) {
+		net_pkt_unref(flood_pkts[i]);
+	}
+
+	zassert_equal(atomic_get(&flood_ctx->pkt_usage.pkts), 0,
+		      "Context usage not released");
+	zassert_equal(atomic_get(&other_ctx->pkt_usage.pkts), 0,
+		      "Context usage not released");
+
+	zassert_equal(net_context_put(flood_ctx), 0, "Context put failed");
+	zassert_equal(net_context_put(other_ctx), 0, "Context put failed");
+}
+#else
+static void test_net_ctx_recv_quota(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_NET_PKT_QUOTA */
+
 static void test_net_ctx_put(void)
 {
 	int ret;
@@ -1035,6 +1178,7 @@ void test_main(void)
 			 ztest_unit_test(test_net_ctx_recv_v4_timeout),
 			 ztest_unit_test(test_net_ctx_recv_v6_timeout_forever),
 			 ztest_unit_test(test_net_ctx_recv_v4_timeout_forever),
+			 ztest_unit_test(test_net_ctx_recv_quota),
 			 ztest_unit_test(test_net_ctx_put));
 	ztest_run_test_suite(test_context);
 }
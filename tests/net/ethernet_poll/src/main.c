@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_L2_ETHERNET_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <net/ethernet.h>
+
+#include <ztest.h>
+
+#define WAIT_TIME K_MSEC(500)
+#define MAX_POLLS 8
+
+/* Fake device that has a number of frames pending in its RX ring */
+struct fake_poll_dev {
+	struct net_eth_poll poll;
+
+	/* Frames pending in the device */
+	int pending;
+
+	/* Frames received in each poll */
+	int received[MAX_POLLS];
+	int polls;
+
+	/* RX interrupt state and how many times it was switched */
+	bool irq_enabled;
+	int irq_disabled_count;
+	int irq_enabled_count;
+
+	/* Poll called with RX interrupt enabled */
+	bool irq_error;
+
+	struct k_sem done;
+};
+
+static struct fake_poll_dev fake_dev;
+
+static int fake_poll(struct net_eth_poll *poll, int budget)
+{
+	struct fake_poll_dev *dev = CONTAINER_OF(poll, struct fake_poll_dev,
+						 poll);
+	int count = MIN(dev->pending, budget);
+
+	if (dev->irq_enabled) {
+		dev->irq_error = true;
+	}
+
+	dev->pending -= count;
+
+	if (dev->polls < MAX_POLLS) {
+		dev->received[dev->polls] = count;
+	}
+
+	dev->polls++;
+
+	return count;
+}
+
+static void fake_irq(struct net_eth_poll *poll, bool enable)
+{
+	struct fake_poll_dev *dev = CONTAINER_OF(poll, struct fake_poll_dev,
+						 poll);
+
+	dev->irq_enabled = enable;
+
+	if (enable) {
+		dev->irq_enabled_count++;
+		k_sem_give(&dev->done);
+	} else {
+		dev->irq_disabled_count++;
+	}
+}
+
+static void fake_dev_setup(int pending, int budget)
+{
+	memset(&fake_dev, 0, sizeof(fake_dev));
+
+	k_sem_init(&fake_dev.done, 0, 1);
+	net_eth_poll_init(&fake_dev.poll, fake_poll, fake_irq, budget);
+
+	fake_dev.pending = pending;
+	fake_dev.irq_enabled = true;
+}
+
+/* Simulate the RX interrupt of the device */
+static bool fake_dev_irq(void)
+{
+	zassert_true(fake_dev.irq_enabled, "RX interrupt disabled");
+
+	return net_eth_poll_schedule(&fake_dev.poll);
+}
+
+static void fake_dev_wait(void)
+{
+	zassert_equal(k_sem_take(&fake_dev.done, WAIT_TIME), 0,
+		      "RX interrupt not enabled");
+	zassert_false(fake_dev.irq_error, "polled with RX interrupt enabled");
+}
+
+static void test_poll_under_budget(void)
+{
+	fake_dev_setup(3, 0);
+
+	zassert_equal(fake_dev.poll.budget, CONFIG_NET_L2_ETHERNET_POLL_BUDGET,
+		      "default budget not used");
+
+	zassert_true(fake_dev_irq(), "poll not scheduled");
+	fake_dev_wait();
+
+	zassert_equal(fake_dev.polls, 1, "invalid poll count %d",
+		      fake_dev.polls);
+	zassert_equal(fake_dev.received[0], 3, "frames not received");
+	zassert_equal(fake_dev.poll.polls, 1, "poll not counted");
+	zassert_equal(fake_dev.poll.exhausted, 0, "budget exhausted");
+	zassert_equal(fake_dev.irq_disabled_count, 1, "IRQ not disabled");
+	zassert_equal(fake_dev.irq_enabled_count, 1, "IRQ not enabled");
+}
+
+static void test_poll_budget_resubmit(void)
+{
+	fake_dev_setup(10, 4);
+
+	zassert_true(fake_dev_irq(), "poll not scheduled");
+	fake_dev_wait();
+
+	/* The poll is resubmitted while the budget is used up, and the RX
+	 * interrupt is enabled only when the device runs out of frames.
+	 */
+	zassert_equal(fake_dev.polls, 3, "invalid poll count %d",
+		      fake_dev.polls);
+	zassert_equal(fake_dev.received[0], 4, "budget not honoured");
+	zassert_equal(fake_dev.received[1], 4, "budget not honoured");
+	zassert_equal(fake_dev.received[2], 2, "frames not received");
+	zassert_equal(fake_dev.pending, 0, "frames left in device");
+	zassert_equal(fake_dev.poll.exhausted, 2, "invalid exhausted count");
+	zassert_equal(fake_dev.irq_disabled_count, 1, "IRQ switched");
+	zassert_equal(fake_dev.irq_enabled_count, 1, "IRQ switched");
+}
+
+static void test_poll_budget_exact(void)
+{
+	fake_dev_setup(8, 4);
+
+	zassert_true(fake_dev_irq(), "poll not scheduled");
+	fake_dev_wait();
+
+	/* A full budget does not tell that the device is empty */
+	zassert_equal(fake_dev.polls, 3, "invalid poll count %d",
+		      fake_dev.polls);
+	zassert_equal(fake_dev.received[2], 0, "frames received");
+	zassert_equal(fake_dev.poll.exhausted, 2, "invalid exhausted count");
+}
+
+static void test_poll_schedule_once(void)
+{
+	fake_dev_setup(2, 4);
+
+	/* Lock the scheduler so that the poll cannot run in between */
+	k_sched_lock();
+
+	zassert_true(fake_dev_irq(), "poll not scheduled");
+	zassert_false(net_eth_poll_schedule(&fake_dev.poll),
+		      "poll scheduled twice");
+
+	k_sched_unlock();
+
+	fake_dev_wait();
+
+	zassert_equal(fake_dev.polls, 1, "invalid poll count %d",
+		      fake_dev.polls);
+	zassert_equal(fake_dev.irq_disabled_count, 1, "IRQ not disabled");
+
+	/* A new interrupt schedules the device again */
+	fake_dev.pending = 1;
+
+	zassert_true(fake_dev_irq(), "poll not scheduled");
+	fake_dev_wait();
+
+	zassert_equal(fake_dev.polls, 2, "invalid poll count %d",
+		      fake_dev.polls);
+	zassert_equal(fake_dev.irq_enabled_count, 2, "IRQ not enabled");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_eth_poll,
+			 ztest_unit_test(test_poll_under_budget),
+			 ztest_unit_test(test_poll_budget_resubmit),
+			 ztest_unit_test(test_poll_budget_exact),
+			 ztest_unit_test(test_poll_schedule_once));
+
+	ztest_run_test_suite(net_eth_poll);
+}
@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_GRO_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <string.h>
+#include <errno.h>
+#include <device.h>
+#include <net/buf.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_ip.h>
+#include <net/dummy.h>
+
+#include <ztest.h>
+
+#include "net_private.h"
+#include "connection.h"
+#include "tcp_internal.h"
+#include "gro.h"
+
+#define LOCAL_PORT 4242
+#define REMOTE_PORT 5555
+#define SEG_LEN 16
+#define HDR_LEN (sizeof(struct net_ipv4_hdr) + sizeof(struct tcphdr))
+#define MAX_DELIVERED 8
+
+static struct in_addr local_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr remote_addr = { { { 192, 0, 2, 2 } } };
+
+struct delivered_pkt {
+	uint32_t seq;
+	size_t len;
+	uint8_t flags;
+};
+
+static struct delivered_pkt delivered[MAX_DELIVERED];
+static int delivered_count;
+static uint8_t delivered_data[4 * SEG_LEN];
+
+static struct net_conn_handle *conn_handle;
+static struct net_if *iface;
+
+static int dummy_send(const struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static struct dummy_api dummy_if_api = {
+	.send = dummy_send,
+};
+
+NET_DEVICE_INIT(gro_test, "gro_test", NULL, NULL, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &dummy_if_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 1500);
+
+static enum net_verdict tcp_input(struct net_conn *conn,
+				  struct net_pkt *pkt,
+				  union net_ip_header *ip_hdr,
+				  union net_proto_header *proto_hdr,
+				  void *user_data)
+{
+	struct tcphdr *th = (struct tcphdr *)proto_hdr->tcp;
+	struct delivered_pkt *d;
+
+	zassert_true(delivered_count < MAX_DELIVERED, "too many packets");
+
+	d = &delivered[delivered_count++];
+	d->seq = th_seq(th);
+	d->len = net_pkt_get_len(pkt) - HDR_LEN;
+	d->flags = th_flags(th);
+
+	zassert_equal(ntohs(ip_hdr->ipv4->len), net_pkt_get_len(pkt),
+		      "IP length not updated");
+
+	if (d->len <= sizeof(delivered_data)) {
+		net_pkt_cursor_init(pkt);
+		net_pkt_set_overwrite(pkt, true);
+		net_pkt_skip(pkt, HDR_LEN);
+		net_pkt_read(pkt, delivered_data, d->len);
+	}
+
+	net_pkt_unref(pkt);
+
+	return NET_OK;
+}
+
+struct segment {
+	struct net_pkt *pkt;
+	union net_ip_header ip;
+	union net_proto_header proto;
+};
+
+/* Payload byte i of the stream is the low byte of its sequence number */
+static void segment_create(struct segment *seg, uint32_t seq, uint8_t flags,
+			   size_t len)
+{
+	struct net_ipv4_hdr *ip;
+	struct tcphdr *th;
+	uint8_t *data;
+	size_t i;
+
+	seg->pkt = net_pkt_rx_alloc_with_buffer(iface, HDR_LEN + len, AF_INET,
+						IPPROTO_TCP, K_NO_WAIT);
+	zassert_not_null(seg->pkt, "cannot allocate packet");
+	zassert_true(seg->pkt->buffer->size >= HDR_LEN + len,
+		     "packet does not fit one buffer");
+
+	data = net_buf_add(seg->pkt->buffer, HDR_LEN + len);
+	memset(data, 0, HDR_LEN);
+
+	ip = (struct net_ipv4_hdr *)data;
+	ip->vhl = 0x45;
+	ip->len = htons(HDR_LEN + len);
+	ip->ttl = 64;
+	ip->proto = IPPROTO_TCP;
+	net_ipaddr_copy(&ip->src, &remote_addr);
+	net_ipaddr_copy(&ip->dst, &local_addr);
+
+	th = (struct tcphdr *)(data + sizeof(*ip));
+	th->th_sport = htons(REMOTE_PORT);
+	th->th_dport = htons(LOCAL_PORT);
+	UNALIGNED_PUT(htonl(seq), &th->th_seq);
+	UNALIGNED_PUT(htonl(1), &th->th_ack);
+	th->th_off = sizeof(*th) / 4;
+	th->th_flags = flags;
+	UNALIGNED_PUT(htons(1024), &th->th_win);
+
+	for (i = 0; i < len; i++) {
+		data[HDR_LEN + i] = (uint8_t)(seq + i);
+	}
+
+	net_pkt_set_ip_hdr_len(seg->pkt, sizeof(*ip));
+	net_pkt_cursor_init(seg->pkt);
+
+	seg->ip.ipv4 = ip;
+	seg->proto.tcp = (struct net_tcp_hdr *)th;
+}
+
+/* Feed a segment to GRO like the IPv4 input does */
+static enum net_verdict segment_input(uint32_t seq, uint8_t flags, size_t len)
+{
+	struct segment seg;
+	enum net_verdict verdict;
+
+	segment_create(&seg, seq, flags, len);
+
+	verdict = net_gro_input(seg.pkt, &seg.ip, &seg.proto);
+	if (verdict == NET_CONTINUE) {
+		zassert_equal(net_conn_input(seg.pkt, &seg.ip, IPPROTO_TCP,
+					     &seg.proto),
+			      NET_OK, "packet not delivered");
+	}
+
+	return verdict;
+}
+
+static void check_delivered(int idx, uint32_t seq, size_t len)
+{
+	zassert_true(idx < delivered_count, "packet %d not delivered", idx);
+	zassert_equal(delivered[idx].seq, seq, "packet %d: invalid seq %u",
+		      idx, delivered[idx].seq);
+	zassert_equal(delivered[idx].len, len, "packet %d: invalid length %zu",
+		      idx, delivered[idx].len);
+}
+
+static void check_data(uint32_t seq, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		zassert_equal(delivered_data[i], (uint8_t)(seq + i),
+			      "invalid data at %zu", i);
+	}
+}
+
+static void reset(void)
+{
+	net_gro_flush();
+
+	delivered_count = 0;
+	net_if_flag_set(iface, NET_IF_GRO);
+}
+
+static void test_setup(void)
+{
+	struct sockaddr_in local = {
+		.sin_family = AF_INET,
+		.sin_port = htons(LOCAL_PORT),
+	};
+	int ret;
+
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	zassert_not_null(iface, "no interface");
+
+	net_ipaddr_copy(&local.sin_addr, &local_addr);
+	zassert_not_null(net_if_ipv4_addr_add(iface, &local_addr,
+					      NET_ADDR_MANUAL, 0),
+			 "cannot add address");
+
+	ret = net_conn_register(IPPROTO_TCP, AF_INET, NULL,
+				(struct sockaddr *)&local, REMOTE_PORT,
+				LOCAL_PORT, NULL, tcp_input, NULL,
+				&conn_handle);
+	zassert_equal(ret, 0, "cannot register connection (%d)", ret);
+}
+
+static void test_merge(void)
+{
+	reset();
+
+	zassert_equal(segment_input(1000, ACK, SEG_LEN), NET_OK, "not held");
+	zassert_equal(segment_input(1016, ACK, SEG_LEN), NET_OK, "not merged");
+	zassert_equal(segment_input(1032, ACK, SEG_LEN), NET_OK, "not merged");
+	zassert_equal(delivered_count, 0, "segments not held");
+
+	/* End of the receive batch */
+	net_gro_flush();
+
+	zassert_equal(delivered_count, 1, "segments not coalesced");
+	check_delivered(0, 1000, 3 * SEG_LEN);
+	check_data(1000, 3 * SEG_LEN);
+}
+
+static void test_merge_push(void)
+{
+	reset();
+
+	zassert_equal(segment_input(2000, ACK, SEG_LEN), NET_OK, "not held");
+	zassert_equal(segment_input(2016, ACK | PSH, SEG_LEN), NET_OK,
+		      "not merged");
+
+	/* PSH passes the data up at once */
+	zassert_equal(delivered_count, 1, "pushed data held");
+	check_delivered(0, 2000, 2 * SEG_LEN);
+	zassert_true(delivered[0].flags & PSH, "PSH flag lost");
+}
+
+static void test_merge_max_segments(void)
+{
+	int i;
+
+	reset();
+
+	for (i = 0; i < CONFIG_NET_GRO_MAX_SEGMENTS; i++) {
+		zassert_equal(segment_input(3000 + i * SEG_LEN, ACK, SEG_LEN),
+			      NET_OK, "segment %d not merged", i);
+	}
+
+	zassert_equal(delivered_count, 1, "full packet held");
+	check_delivered(0, 3000, CONFIG_NET_GRO_MAX_SEGMENTS * SEG_LEN);
+}
+
+static void test_reorder(void)
+{
+	reset();
+
+	zassert_equal(segment_input(4000, ACK, SEG_LEN), NET_OK, "not held");
+
+	/* A gap in the sequence, the held data must go up first */
+	zassert_equal(segment_input(4032, ACK, SEG_LEN), NET_CONTINUE,
+		      "out of order segment merged");
+	check_delivered(0, 4000, SEG_LEN);
+	check_delivered(1, 4032, SEG_LEN);
+
+	/* A segment that is not pure data is never held nor merged, and
+	 * does not overtake the held data.
+	 */
+	zassert_equal(segment_input(4048, ACK, SEG_LEN), NET_OK, "not held");
+	zassert_equal(segment_input(4064, ACK | FIN, 0), NET_CONTINUE,
+		      "FIN merged");
+	check_delivered(2, 4048, SEG_LEN);
+	check_delivered(3, 4064, 0);
+	zassert_equal(delivered_count, 4, "invalid number of packets");
+}
+
+static void flush_thread(void *p1, void *p2, void *p3)
+{
+	net_gro_flush();
+}
+
+static K_THREAD_STACK_DEFINE(flush_stack, 1024);
+static struct k_thread flush_thread_data;
+
+static void test_flush_owner(void)
+{
+	reset();
+
+	zassert_equal(segment_input(5000, ACK, SEG_LEN), NET_OK, "not held");
+
+	/* Another RX thread must not pass up the flows of this thread */
+	k_thread_create(&flush_thread_data, flush_stack,
+			K_THREAD_STACK_SIZEOF(flush_stack), flush_thread,
+			NULL, NULL, NULL, K_PRIO_COOP(1), 0, K_NO_WAIT);
+	k_thread_join(&flush_thread_data, K_FOREVER);
+
+	zassert_equal(delivered_count, 0, "flow flushed by another thread");
+
+	net_gro_flush();
+
+	check_delivered(0, 5000, SEG_LEN);
+}
+
+static void test_iface_disabled(void)
+{
+	reset();
+
+	net_if_flag_clear(iface, NET_IF_GRO);
+
+	zassert_equal(segment_input(6000, ACK, SEG_LEN), NET_CONTINUE,
+		      "segment held on interface without GRO");
+	check_delivered(0, 6000, SEG_LEN);
+
+	net_if_flag_set(iface, NET_IF_GRO);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_gro,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_merge),
+			 ztest_unit_test(test_merge_push),
+			 ztest_unit_test(test_merge_max_segments),
+			 ztest_unit_test(test_reorder),
+			 ztest_unit_test(test_flush_owner),
+			 ztest_unit_test(test_iface_disabled));
+
+	ztest_run_test_suite(net_gro);
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_ieee802154_fake_driver, LOG_LEVEL_DBG);
+
+#include <zephyr.h>
+
+#include <net/net_core.h>
+#include "net_private.h"
+
+#include <net/net_pkt.h>
+
+/** FAKE ieee802.15.4 driver **/
+#include <net/ieee802154_radio.h>
+
+/* The neighbor wakes up for this window of every check interval, and
+ * only acknowledges the frames sent in it.
+ */
+#define WAKEUP_START	50000
+#define WAKEUP_END	52000
+
+/* Time on air of a frame, in microseconds */
+#define AIRTIME		1000
+
+static enum ieee802154_hw_caps fake_get_capabilities(const struct device *dev)
+{
+	return IEEE802154_HW_FCS | IEEE802154_HW_TX_RX_ACK |
+		IEEE802154_HW_2_4_GHZ;
+}
+
+static int fake_cca(const struct device *dev)
+{
+	return 0;
+}
+
+static int fake_set_channel(const struct device *dev, uint16_t channel)
+{
+	return 0;
+}
+
+static int fake_set_txpower(const struct device *dev, int16_t dbm)
+{
+	return 0;
+}
+
+static int fake_tx(const struct device *dev,
+		   enum ieee802154_tx_mode mode,
+		   struct net_pkt *pkt,
+		   struct net_buf *frag)
+{
+	uint32_t phase = k_ticks_to_us_floor64(k_uptime_ticks()) %
+		(CONFIG_NET_L2_IEEE802154_LPL_CHECK_INTERVAL * 1000U);
+
+	k_busy_wait(AIRTIME);
+
+	/* Acknowledgment request */
+	if (!(frag->data[0] & BIT(5))) {
+		return 0;
+	}
+
+	return phase >= WAKEUP_START && phase < WAKEUP_END ? 0 : -EIO;
+}
+
+static int fake_start(const struct device *dev)
+{
+	return 0;
+}
+
+static int fake_stop(const struct device *dev)
+{
+	return 0;
+}
+
+static void fake_iface_init(struct net_if *iface)
+{
+	struct ieee802154_context *ctx = net_if_l2_data(iface);
+	static uint8_t mac[8] = { 0x00, 0x12, 0x4b, 0x00,
+				  0x00, 0x9e, 0xa3, 0xc2 };
+
+	net_if_set_link_addr(iface, mac, 8, NET_LINK_IEEE802154);
+
+	ctx->pan_id = 0xabcd;
+	ctx->channel = 26U;
+	ctx->sequence = 62U;
+
+	NET_INFO("FAKE ieee802154 iface initialized\n");
+}
+
+static int fake_init(const struct device *dev)
+{
+	fake_stop(dev);
+
+	return 0;
+}
+
+static struct ieee802154_radio_api fake_radio_api = {
+	.iface_api.init	= fake_iface_init,
+
+	.get_capabilities	= fake_get_capabilities,
+	.cca			= fake_cca,
+	.set_channel		= fake_set_channel,
+	.set_txpower		= fake_set_txpower,
+	.start			= fake_start,
+	.stop			= fake_stop,
+	.tx			= fake_tx,
+};
+
+NET_DEVICE_INIT(fake, "fake_ieee802154",
+		fake_init, NULL, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&fake_radio_api, IEEE802154_L2,
+		NET_L2_GET_CTX_TYPE(IEEE802154_L2), 125);
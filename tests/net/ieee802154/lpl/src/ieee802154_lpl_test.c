@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_ieee802154_lpl_test, LOG_LEVEL_DBG);
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <net/net_core.h>
+#include "net_private.h"
+
+#include <net/net_pkt.h>
+#include <net/ieee802154_lpl.h>
+
+#include <ieee802154_frame.h>
+#include <ieee802154_radio_utils.h>
+
+#define CHECK_INTERVAL (CONFIG_NET_L2_IEEE802154_LPL_CHECK_INTERVAL * 1000U)
+#define PHASE_GUARD CONFIG_NET_L2_IEEE802154_LPL_PHASE_GUARD
+#define AIRTIME 1000
+
+static uint8_t broadcast_frame[] = {
+	0x41, 0xd8, 0x10, 0xcd, 0xab, 0xff, 0xff, 0xc2, 0xa3, 0x9e, 0x00,
+	0x00, 0x4b, 0x12, 0x00, 'l', 'p', 'l'
+};
+
+static uint8_t unicast_frame[] = {
+	0x61, 0xdc, 0x11, 0xcd, 0xab, 0x26, 0x11, 0x32, 0x00, 0x00, 0x4b,
+	0x12, 0x00, 0xc2, 0xa3, 0x9e, 0x00, 0x00, 0x4b, 0x12, 0x00, 'l',
+	'p', 'l'
+};
+
+static uint8_t received_frame[] = {
+	0x61, 0xdc, 0x16, 0xcd, 0xab, 0xc2, 0xa3, 0x9e, 0x00, 0x00, 0x4b,
+	0x12, 0x00, 0x26, 0x18, 0x32, 0x00, 0x00, 0x4b, 0x12, 0x00, 0x7b,
+	0x00, 0x3a, 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x20, 0x01, 0x0d, 0xb8,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x02, 0x87, 0x00, 0x8b, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+static struct net_if *iface;
+
+static void get_stats(struct ieee802154_lpl_stats *stats)
+{
+	zassert_equal(ieee802154_lpl_get_stats(iface, stats), 0,
+		      "Could not get stats");
+}
+
+static int send_frame(uint8_t *frame, size_t len)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = net_pkt_alloc_with_buffer(iface, len, AF_UNSPEC, 0, K_FOREVER);
+	zassert_not_null(pkt, "Could not allocate packet");
+	zassert_equal(net_pkt_write(pkt, frame, len), 0,
+		      "Could not write frame");
+
+	ret = ieee802154_radio_send(iface, pkt, pkt->buffer);
+
+	net_pkt_unref(pkt);
+
+	return ret;
+}
+
+static void receive_frame(void)
+{
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface, sizeof(received_frame),
+					   AF_UNSPEC, 0, K_FOREVER);
+	zassert_not_null(pkt, "Could not allocate packet");
+	zassert_equal(net_pkt_write(pkt, received_frame,
+				    sizeof(received_frame)), 0,
+		      "Could not write frame");
+
+	zassert_not_equal(net_recv_data(iface, pkt), NET_DROP,
+			  "Frame dropped");
+}
+
+static void test_init(void)
+{
+	const struct device *dev;
+	struct ieee802154_lpl_stats stats;
+
+	dev = device_get_binding("fake_ieee802154");
+	zassert_not_null(dev, "Could not get fake device");
+
+	iface = net_if_lookup_by_dev(dev);
+	zassert_not_null(iface, "Could not get fake iface");
+
+	zassert_equal(ieee802154_lpl_get_stats(NULL, &stats), -EINVAL,
+		      "Got stats of no interface");
+}
+
+static void test_checks(void)
+{
+	struct ieee802154_lpl_stats stats;
+
+	k_sleep(K_USEC(3 * CHECK_INTERVAL));
+
+	get_stats(&stats);
+
+	zassert_true(stats.rx_checks >= 2U, "Channel not checked");
+	zassert_equal(stats.rx_wakeups, 0U, "Woke up on a clear channel");
+	zassert_true(stats.rx_on_time <= stats.rx_checks *
+		     (CONFIG_NET_L2_IEEE802154_LPL_CCA_COUNT *
+		      CONFIG_NET_L2_IEEE802154_LPL_CCA_SPACING + AIRTIME),
+		     "Radio on for too long");
+}
+
+static void test_broadcast(void)
+{
+	struct ieee802154_lpl_stats before, after;
+
+	get_stats(&before);
+
+	zassert_equal(send_frame(broadcast_frame, sizeof(broadcast_frame)), 0,
+		      "Could not send broadcast frame");
+
+	get_stats(&after);
+
+	zassert_equal(after.tx_delivered, before.tx_delivered + 1U,
+		      "Frame not delivered");
+	zassert_true(after.tx_on_time - before.tx_on_time >= CHECK_INTERVAL,
+		     "Frame not strobed during a whole interval");
+	zassert_true(after.tx_strobes - before.tx_strobes >=
+		     CHECK_INTERVAL / AIRTIME / 2U, "Frame not strobed");
+}
+
+static void test_unicast_phase_lock(void)
+{
+	struct ieee802154_lpl_stats before, after;
+
+	get_stats(&before);
+
+	zassert_equal(send_frame(unicast_frame, sizeof(unicast_frame)), 0,
+		      "Could not send unicast frame");
+
+	get_stats(&after);
+
+	zassert_equal(after.tx_phase_locked, before.tx_phase_locked,
+		      "Phase known before the first frame");
+	zassert_true(after.tx_on_time - before.tx_on_time <=
+		     CHECK_INTERVAL + PHASE_GUARD + AIRTIME,
+		     "Frame strobed for too long");
+
+	/* The second frame is sent at the learnt phase */
+	before = after;
+	unicast_frame[2]++;
+
+	zassert_equal(send_frame(unicast_frame, sizeof(unicast_frame)), 0,
+		      "Could not send unicast frame");
+
+	get_stats(&after);
+
+	zassert_equal(after.tx_phase_locked, before.tx_phase_locked + 1U,
+		      "Phase not learnt");
+	zassert_equal(after.tx_delivered, before.tx_delivered + 1U,
+		      "Frame not delivered");
+	zassert_true(after.tx_on_time - before.tx_on_time <=
+		     2 * PHASE_GUARD + AIRTIME,
+		     "Frame strobed for too long");
+}
+
+static void test_duplicate(void)
+{
+	struct ieee802154_lpl_stats before, after;
+
+	get_stats(&before);
+
+	receive_frame();
+	receive_frame();
+
+	k_sleep(K_MSEC(10));
+
+	get_stats(&after);
+
+	zassert_equal(after.rx_frames, before.rx_frames + 1U,
+		      "Repeated frame not dropped");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(ieee802154_lpl,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_checks),
+			 ztest_unit_test(test_broadcast),
+			 ztest_unit_test(test_unicast_phase_lock),
+			 ztest_unit_test(test_duplicate)
+		);
+
+	ztest_run_test_suite(ieee802154_lpl);
+}
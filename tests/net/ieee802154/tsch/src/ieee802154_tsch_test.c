@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_ieee802154_tsch_test, LOG_LEVEL_DBG);
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <net/net_core.h>
+#include "net_private.h"
+
+#include <net/net_pkt.h>
+#include <net/ieee802154_tsch.h>
+
+#include <sys/byteorder.h>
+
+#include <ieee802154_frame.h>
+#include <ieee802154_radio_utils.h>
+
+#define SLOTFRAME_SIZE 3
+
+/* Default hopping sequence */
+static const uint16_t hopping[] = {
+	16, 17, 23, 18, 26, 15, 25, 22, 19, 11, 12, 13, 24, 14, 20, 21
+};
+
+/* Enhanced beacon of the minimal schedule, from the frame control up to
+ * the Sync IE and after the ASN.
+ */
+static const uint8_t eb_fcf[] = { 0x00, 0xe2 };
+static const uint8_t eb_hdr[] = {
+	0xcd, 0xab, 0xc2, 0xa3, 0x9e, 0x00, 0x00, 0x4b, 0x12, 0x00,
+	0x00, 0x3f, 0x1a, 0x88, 0x06, 0x1a
+};
+static const uint8_t eb_payload[] = {
+	0x00, 0x01, 0x1c, 0x00, 0x01, 0xc8, 0x00, 0x0a, 0x1b, 0x01,
+	0x00, 0x03, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x0f
+};
+
+#define EB_ASN_OFFSET (IEEE802154_FCF_SEQ_LENGTH + sizeof(eb_hdr))
+#define EB_LEN (EB_ASN_OFFSET + 5 + sizeof(eb_payload))
+
+static uint8_t data_frame[] = {
+	0x41, 0xd8, 0x10, 0xcd, 0xab, 0xff, 0xff, 0xc2, 0xa3, 0x9e, 0x00,
+	0x00, 0x4b, 0x12, 0x00, 't', 's', 'c', 'h'
+};
+
+int capture_type = -1;
+uint8_t capture_frame[IEEE802154_MTU];
+uint8_t capture_len;
+uint16_t capture_channel;
+uint64_t capture_asn;
+K_SEM_DEFINE(driver_lock, 0, UINT_MAX);
+
+static struct net_if *iface;
+
+static void capture(int frame_type)
+{
+	k_sem_reset(&driver_lock);
+	capture_type = frame_type;
+}
+
+static void check_capture(void)
+{
+	zassert_equal(k_sem_take(&driver_lock, K_SECONDS(2)), 0,
+		      "No frame sent");
+	zassert_equal(capture_asn % SLOTFRAME_SIZE, 0,
+		      "Frame sent out of the cell");
+	zassert_equal(capture_channel,
+		      hopping[capture_asn % ARRAY_SIZE(hopping)],
+		      "Frame sent on the wrong channel");
+}
+
+static uint64_t eb_asn(uint8_t *eb)
+{
+	return sys_get_le32(eb + EB_ASN_OFFSET) |
+	       ((uint64_t)eb[EB_ASN_OFFSET + 4] << 32);
+}
+
+static void test_init(void)
+{
+	const struct device *dev;
+
+	dev = device_get_binding("fake_ieee802154");
+	zassert_not_null(dev, "Could not get fake device");
+
+	iface = net_if_lookup_by_dev(dev);
+	zassert_not_null(iface, "Could not get fake iface");
+}
+
+static void test_schedule(void)
+{
+	struct ieee802154_tsch_cell cell = {
+		.timeslot = 1U,
+		.options = IEEE802154_TSCH_CELL_RX,
+	};
+	int i;
+
+	zassert_equal(ieee802154_tsch_cell_add(iface, 1U, &cell), -ENOENT,
+		      "Cell added to a missing slotframe");
+
+	zassert_equal(ieee802154_tsch_slotframe_add(iface, 1U, 2U), 0,
+		      "Could not add slotframe");
+	zassert_equal(ieee802154_tsch_slotframe_add(iface, 1U, 2U), -EEXIST,
+		      "Slotframe added twice");
+
+	for (i = 1; i < CONFIG_NET_L2_IEEE802154_TSCH_MAX_SLOTFRAMES; i++) {
+		zassert_equal(ieee802154_tsch_slotframe_add(iface, 1U + i, 2U),
+			      0, "Could not add slotframe");
+	}
+
+	zassert_equal(ieee802154_tsch_slotframe_add(iface, 0U, 2U), -ENOMEM,
+		      "Too many slotframes");
+
+	zassert_equal(ieee802154_tsch_cell_add(iface, 1U, &cell), 0,
+		      "Could not add cell");
+	zassert_equal(ieee802154_tsch_cell_add(iface, 1U, &cell), -EEXIST,
+		      "Cell added twice");
+
+	cell.timeslot = 2U;
+	zassert_equal(ieee802154_tsch_cell_add(iface, 1U, &cell), -EINVAL,
+		      "Cell added out of the slotframe");
+
+	zassert_equal(ieee802154_tsch_cell_remove(iface, 1U, 1U, 0U), 0,
+		      "Could not remove cell");
+	zassert_equal(ieee802154_tsch_cell_remove(iface, 1U, 1U, 0U), -ENOENT,
+		      "Cell removed twice");
+
+	for (i = 0; i < CONFIG_NET_L2_IEEE802154_TSCH_MAX_SLOTFRAMES; i++) {
+		zassert_equal(ieee802154_tsch_slotframe_remove(iface, 1U + i),
+			      0, "Could not remove slotframe");
+	}
+
+	zassert_equal(ieee802154_tsch_slotframe_remove(iface, 1U), -ENOENT,
+		      "Slotframe removed twice");
+
+	zassert_equal(ieee802154_tsch_minimal_schedule(iface, SLOTFRAME_SIZE),
+		      0, "Could not add the minimal schedule");
+}
+
+static void test_coordinator_eb(void)
+{
+	capture(IEEE802154_FRAME_TYPE_BEACON);
+
+	zassert_equal(ieee802154_tsch_start(iface, true), 0,
+		      "Could not start TSCH");
+	zassert_equal(ieee802154_tsch_start(iface, true), -EALREADY,
+		      "TSCH started twice");
+	zassert_true(ieee802154_tsch_is_synchronized(iface),
+		     "Coordinator not synchronized");
+
+	check_capture();
+
+	zassert_equal(capture_len, EB_LEN, "Wrong EB length");
+	zassert_mem_equal(capture_frame, eb_fcf, sizeof(eb_fcf),
+			  "Wrong EB frame control");
+	zassert_mem_equal(capture_frame + IEEE802154_FCF_SEQ_LENGTH, eb_hdr,
+			  sizeof(eb_hdr), "Wrong EB header");
+	zassert_mem_equal(capture_frame + EB_ASN_OFFSET + 5, eb_payload,
+			  sizeof(eb_payload), "Wrong EB payload");
+	zassert_equal(eb_asn(capture_frame), capture_asn,
+		      "Wrong ASN in the EB");
+}
+
+static void test_data_tx(void)
+{
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_with_buffer(iface, sizeof(data_frame), AF_UNSPEC,
+					0, K_FOREVER);
+	zassert_not_null(pkt, "Could not allocate packet");
+	zassert_equal(net_pkt_write(pkt, data_frame, sizeof(data_frame)), 0,
+		      "Could not write frame");
+
+	capture(IEEE802154_FRAME_TYPE_DATA);
+
+	zassert_equal(ieee802154_radio_send(iface, pkt, pkt->buffer), 0,
+		      "Could not send frame");
+
+	check_capture();
+
+	zassert_mem_equal(capture_frame, data_frame, sizeof(data_frame),
+			  "Wrong frame sent");
+
+	net_pkt_unref(pkt);
+}
+
+/* The EB is timestamped as received that long ago by the radio */
+#define EB_RX_AGE_US 100000U
+#define EB_RX_AGE_SLOTS \
+	(EB_RX_AGE_US / CONFIG_NET_L2_IEEE802154_TSCH_TIMESLOT_LENGTH)
+
+static void test_join(void)
+{
+	static const uint8_t src[] = { 0x01, 0x02, 0x03, 0x04,
+				       0x05, 0x06, 0x07, 0x08 };
+	uint64_t min_asn = 1000U;
+	struct net_pkt *pkt;
+	uint64_t asn;
+	int i;
+
+	zassert_equal(ieee802154_tsch_stop(iface), 0, "Could not stop TSCH");
+	zassert_equal(ieee802154_tsch_start(iface, false), 0,
+		      "Could not start TSCH");
+	zassert_false(ieee802154_tsch_is_synchronized(iface),
+		      "Synchronized without an EB");
+
+	/* EB of another coordinator, at ASN 1000 */
+	memcpy(capture_frame + 5, src, sizeof(src));
+	sys_put_le32(1000U, capture_frame + EB_ASN_OFFSET);
+	capture_frame[EB_ASN_OFFSET + 4] = 0U;
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface, EB_LEN, AF_UNSPEC, 0,
+					   K_FOREVER);
+	zassert_not_null(pkt, "Could not allocate packet");
+	zassert_equal(net_pkt_write(pkt, capture_frame, EB_LEN), 0,
+		      "Could not write EB");
+
+#if defined(CONFIG_NET_PKT_TIMESTAMP)
+	uint64_t rx_time = k_ticks_to_us_floor64(k_uptime_ticks());
+	struct net_ptp_time timestamp;
+
+	zassert_true(rx_time > EB_RX_AGE_US, "Uptime too short");
+	rx_time -= EB_RX_AGE_US;
+
+	timestamp.second = rx_time / USEC_PER_SEC;
+	timestamp.nanosecond = (rx_time % USEC_PER_SEC) * NSEC_PER_USEC;
+	net_pkt_set_timestamp(pkt, &timestamp);
+
+	/* The timeslots since the reception are accounted */
+	min_asn += EB_RX_AGE_SLOTS;
+#endif
+
+	zassert_not_equal(net_recv_data(iface, pkt), NET_DROP, "EB dropped");
+
+	for (i = 0; i < 100 && !ieee802154_tsch_is_synchronized(iface); i++) {
+		k_sleep(K_MSEC(10));
+	}
+
+	zassert_true(ieee802154_tsch_is_synchronized(iface),
+		     "Not synchronized by the EB");
+
+	asn = ieee802154_tsch_asn(iface);
+	zassert_true(asn >= min_asn && asn < min_asn + 200U, "Wrong ASN %u",
+		     (uint32_t)asn);
+}
+
+static void test_stop(void)
+{
+	struct net_pkt *pkt;
+
+	zassert_equal(ieee802154_tsch_stop(iface), 0, "Could not stop TSCH");
+	zassert_equal(ieee802154_tsch_stop(iface), -EALREADY,
+		      "TSCH stopped twice");
+	zassert_false(ieee802154_tsch_is_synchronized(iface),
+		      "Synchronized once stopped");
+
+	pkt = net_pkt_alloc_with_buffer(iface, sizeof(data_frame), AF_UNSPEC,
+					0, K_FOREVER);
+	zassert_not_null(pkt, "Could not allocate packet");
+	zassert_equal(net_pkt_write(pkt, data_frame, sizeof(data_frame)), 0,
+		      "Could not write frame");
+
+	zassert_equal(ieee802154_radio_send(iface, pkt, pkt->buffer),
+		      -ENETDOWN, "Frame sent once stopped");
+
+	net_pkt_unref(pkt);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(ieee802154_tsch,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_schedule),
+			 ztest_unit_test(test_coordinator_eb),
+			 ztest_unit_test(test_data_tx),
+			 ztest_unit_test(test_join),
+			 ztest_unit_test(test_stop)
+		);
+
+	ztest_run_test_suite(ieee802154_tsch);
+}
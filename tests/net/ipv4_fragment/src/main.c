@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_IPV4_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <string.h>
+#include <errno.h>
+#include <device.h>
+#include <sys/byteorder.h>
+#include <net/buf.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_ip.h>
+#include <net/dummy.h>
+
+#include <ztest.h>
+
+#include "net_private.h"
+#include "connection.h"
+#include "ipv4.h"
+
+#define LOCAL_PORT 4242
+#define REMOTE_PORT 5555
+#define HDR_LEN sizeof(struct net_ipv4_hdr)
+#define UDP_HDR_LEN 8
+
+/* UDP datagram sent in three fragments of FRAG_LEN bytes */
+#define FRAG_LEN 32
+#define DATAGRAM_LEN (3 * FRAG_LEN)
+
+#define WAIT_TIME K_SECONDS(1)
+#define ALLOC_TIMEOUT K_MSEC(100)
+
+static struct in_addr local_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr remote_addr = { { { 192, 0, 2, 2 } } };
+
+/* IP payload of the datagram: the UDP header, then byte i is i */
+static uint8_t datagram[DATAGRAM_LEN];
+
+static size_t delivered_len;
+static bool delivered_ok;
+static K_SEM_DEFINE(delivered, 0, 1);
+
+static struct net_conn_handle *conn_handle;
+static struct net_if *iface;
+
+static int dummy_send(const struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static struct dummy_api dummy_if_api = {
+	.send = dummy_send,
+};
+
+NET_DEVICE_INIT(ipv4_frag_test, "ipv4_frag_test", NULL, NULL, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &dummy_if_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 1500);
+
+static enum net_verdict udp_input(struct net_conn *conn,
+				  struct net_pkt *pkt,
+				  union net_ip_header *ip_hdr,
+				  union net_proto_header *proto_hdr,
+				  void *user_data)
+{
+	uint8_t data[DATAGRAM_LEN];
+
+	delivered_len = net_pkt_get_len(pkt) - HDR_LEN;
+	delivered_ok = ntohs(ip_hdr->ipv4->len) == net_pkt_get_len(pkt) &&
+		       sys_get_be16(ip_hdr->ipv4->offset) == 0U &&
+		       delivered_len == DATAGRAM_LEN;
+
+	if (delivered_ok) {
+		net_pkt_cursor_init(pkt);
+		net_pkt_set_overwrite(pkt, true);
+		net_pkt_skip(pkt, HDR_LEN);
+
+		delivered_ok = net_pkt_read(pkt, data, sizeof(data)) == 0 &&
+			       memcmp(data, datagram, sizeof(data)) == 0;
+	}
+
+	net_pkt_unref(pkt);
+	k_sem_give(&delivered);
+
+	return NET_OK;
+}
+
+/* Hand a fragment holding len bytes of the datagram at offset to the
+ * reassembly, like the IPv4 input does.
+ */
+static enum net_verdict recv_fragment(uint16_t id, uint16_t offset, bool more,
+				      uint16_t len)
+{
+	struct net_ipv4_hdr ipv4_hdr = { 0 };
+	enum net_verdict verdict;
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = net_pkt_alloc_with_buffer(iface, HDR_LEN + len, AF_UNSPEC, 0,
+					ALLOC_TIMEOUT);
+	zassert_not_null(pkt, "packet");
+
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, HDR_LEN);
+
+	ipv4_hdr.vhl = 0x45;
+	ipv4_hdr.len = htons(HDR_LEN + len);
+	sys_put_be16(id, ipv4_hdr.id);
+	sys_put_be16((offset / 8U) | (more ? NET_IPV4_MF << 13 : 0),
+		     ipv4_hdr.offset);
+	ipv4_hdr.ttl = 64;
+	ipv4_hdr.proto = IPPROTO_UDP;
+	net_ipaddr_copy(&ipv4_hdr.src, &remote_addr);
+	net_ipaddr_copy(&ipv4_hdr.dst, &local_addr);
+
+	ret = net_pkt_write(pkt, &ipv4_hdr, sizeof(ipv4_hdr));
+	zassert_true(ret == 0, "IPv4 header append failed");
+
+	if (offset + len <= sizeof(datagram)) {
+		ret = net_pkt_write(pkt, datagram + offset, len);
+	} else {
+		ret = net_pkt_memset(pkt, 0, len);
+	}
+
+	zassert_true(ret == 0, "IPv4 fragment payload append failed");
+
+	net_pkt_cursor_init(pkt);
+
+	verdict = net_ipv4_handle_fragment_hdr(pkt, (struct net_ipv4_hdr *)
+					       pkt->buffer->data);
+	if (verdict == NET_DROP) {
+		net_pkt_unref(pkt);
+	}
+
+	return verdict;
+}
+
+static void reass_count_cb(struct net_reassembly *reass, void *user_data)
+{
+	int *count = user_data;
+
+	(*count)++;
+}
+
+static int pending_reassemblies(void)
+{
+	int count = 0;
+
+	net_ipv4_frag_foreach(reass_count_cb, &count);
+
+	return count;
+}
+
+static void check_delivered(void)
+{
+	zassert_equal(k_sem_take(&delivered, WAIT_TIME), 0,
+		      "Reassembled packet not received");
+	zassert_equal(delivered_len, DATAGRAM_LEN, "Invalid length %zu",
+		      delivered_len);
+	zassert_true(delivered_ok, "Invalid reassembled packet");
+}
+
+static void check_not_delivered(void)
+{
+	zassert_equal(k_sem_take(&delivered, K_MSEC(100)), -EAGAIN,
+		      "Packet received");
+}
+
+static void test_setup(void)
+{
+	struct sockaddr_in local = {
+		.sin_family = AF_INET,
+		.sin_port = htons(LOCAL_PORT),
+	};
+	int ret;
+	int i;
+
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	zassert_not_null(iface, "no interface");
+
+	zassert_not_null(net_if_ipv4_addr_add(iface, &local_addr,
+					      NET_ADDR_MANUAL, 0),
+			 "cannot add address");
+
+	net_ipaddr_copy(&local.sin_addr, &local_addr);
+
+	ret = net_conn_register(IPPROTO_UDP, AF_INET, NULL,
+				(struct sockaddr *)&local, REMOTE_PORT,
+				LOCAL_PORT, NULL, udp_input, NULL,
+				&conn_handle);
+	zassert_equal(ret, 0, "cannot register connection (%d)", ret);
+
+	for (i = UDP_HDR_LEN; i < sizeof(datagram); i++) {
+		datagram[i] = i;
+	}
+
+	sys_put_be16(REMOTE_PORT, datagram);
+	sys_put_be16(LOCAL_PORT, datagram + 2);
+	sys_put_be16(DATAGRAM_LEN, datagram + 4);
+}
+
+static void test_recv_ipv4_fragment(void)
+{
+	zassert_equal(pending_reassemblies(), 0, "Pending reassembly");
+
+	zassert_equal(recv_fragment(0x100, 0, true, FRAG_LEN), NET_OK,
+		      "First fragment not taken");
+	zassert_equal(recv_fragment(0x100, FRAG_LEN, true, FRAG_LEN), NET_OK,
+		      "Middle fragment not taken");
+	zassert_equal(pending_reassemblies(), 1, "Reassembly not pending");
+	check_not_delivered();
+
+	zassert_equal(recv_fragment(0x100, 2 * FRAG_LEN, false, FRAG_LEN),
+		      NET_OK, "Last fragment not taken");
+	zassert_equal(pending_reassemblies(), 0, "Reassembly not complete");
+
+	check_delivered();
+}
+
+static void test_recv_ipv4_fragment_out_of_order(void)
+{
+	zassert_equal(recv_fragment(0x200, 2 * FRAG_LEN, false, FRAG_LEN),
+		      NET_OK, "Last fragment not taken");
+	zassert_equal(recv_fragment(0x200, 0, true, FRAG_LEN), NET_OK,
+		      "First fragment not taken");
+	zassert_equal(recv_fragment(0x200, 2 * FRAG_LEN, false, FRAG_LEN),
+		      NET_DROP, "Duplicate fragment taken");
+	zassert_equal(pending_reassemblies(), 1, "Reassembly not pending");
+	check_not_delivered();
+
+	zassert_equal(recv_fragment(0x200, FRAG_LEN, true, FRAG_LEN), NET_OK,
+		      "Middle fragment not taken");
+	zassert_equal(pending_reassemblies(), 0, "Reassembly not complete");
+
+	check_delivered();
+}
+
+static void test_recv_ipv4_fragment_overlap(void)
+{
+	zassert_equal(recv_fragment(0x300, 0, true, FRAG_LEN), NET_OK,
+		      "First fragment not taken");
+	zassert_equal(recv_fragment(0x300, FRAG_LEN / 2, true, FRAG_LEN),
+		      NET_DROP, "Overlapping fragment taken");
+	zassert_equal(pending_reassemblies(), 0,
+		      "Reassembly not discarded on overlap");
+
+	/* The rest of the discarded datagram starts a new reassembly */
+	zassert_equal(recv_fragment(0x300, FRAG_LEN, true, FRAG_LEN), NET_OK,
+		      "Middle fragment not taken");
+	zassert_equal(recv_fragment(0x300, 2 * FRAG_LEN, false, FRAG_LEN),
+		      NET_OK, "Last fragment not taken");
+	zassert_equal(pending_reassemblies(), 1, "Reassembly not pending");
+	check_not_delivered();
+
+	/* Leave it to the timeout test */
+}
+
+static void test_recv_ipv4_fragment_invalid(void)
+{
+	/* Not a multiple of 8 bytes while more fragments follow */
+	zassert_equal(recv_fragment(0x400, 0, true, FRAG_LEN - 1), NET_DROP,
+		      "Unaligned fragment taken");
+
+	/* The reassembled packet would not fit the IPv4 total length, even
+	 * if the payload alone does: 20 + 65512 + 16 > 65535.
+	 */
+	zassert_equal(recv_fragment(0x400, 65512, false, 16), NET_DROP,
+		      "Too long fragment taken");
+
+	/* 20 + 65504 + 8 fits */
+	zassert_equal(recv_fragment(0x400, 65504, false, 8), NET_OK,
+		      "Fragment at the end of the packet not taken");
+
+	zassert_equal(pending_reassemblies(), 2, "Invalid pending reassemblies");
+}
+
+static void test_recv_ipv4_fragment_timeout(void)
+{
+	/* Let the pending reassemblies time out */
+	k_sleep(K_SECONDS(CONFIG_NET_IPV4_FRAGMENT_TIMEOUT + 1));
+
+	zassert_equal(pending_reassemblies(), 0, "Reassembly not timed out");
+	check_not_delivered();
+
+	/* The late fragment starts over, it does not complete anything */
+	zassert_equal(recv_fragment(0x300, 0, true, FRAG_LEN), NET_OK,
+		      "First fragment not taken");
+	zassert_equal(pending_reassemblies(), 1, "Reassembly not pending");
+	check_not_delivered();
+
+	k_sleep(K_SECONDS(CONFIG_NET_IPV4_FRAGMENT_TIMEOUT + 1));
+
+	zassert_equal(pending_reassemblies(), 0, "Reassembly not timed out");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_ipv4_fragment,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_recv_ipv4_fragment),
+			 ztest_unit_test(test_recv_ipv4_fragment_out_of_order),
+			 ztest_unit_test(test_recv_ipv4_fragment_overlap),
+			 ztest_unit_test(test_recv_ipv4_fragment_invalid),
+			 ztest_unit_test(test_recv_ipv4_fragment_timeout));
+
+	ztest_run_test_suite(net_ipv4_fragment);
+}
@@ -2043,6 +2043,134 @@ static void test_recv_ipv6_fragment(void)
 	zassert_true(ret == NET_OK, "IPv6 frag2 reassembly failed");
 }
 
+static enum net_verdict recv_fragment(uint32_t id, uint16_t offset, bool more,
+				      uint16_t len)
+{
+	struct net_ipv6_frag_hdr frag_hdr;
+	struct net_ipv6_hdr ipv6_hdr;
+	enum net_verdict verdict;
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = net_pkt_alloc_with_buffer(iface1, sizeof(struct net_ipv6_hdr) +
+					NET_IPV6_FRAGH_LEN + len,
+					AF_UNSPEC, 0, ALLOC_TIMEOUT);
+	zassert_not_null(pkt, "packet");
+
+	net_pkt_set_family(pkt, AF_INET6);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(struct net_ipv6_hdr));
+	net_pkt_cursor_init(pkt);
+
+	memcpy(&ipv6_hdr, ipv6_reass_frag2, sizeof(struct net_ipv6_hdr));
+	ipv6_hdr.len = htons(NET_IPV6_FRAGH_LEN + len);
+
+	frag_hdr.nexthdr = IPPROTO_ICMPV6;
+	frag_hdr.reserved = 0U;
+	frag_hdr.offset = htons(offset | more);
+	frag_hdr.id = htonl(id);
+
+	ret = net_pkt_write(pkt, &ipv6_hdr, sizeof(ipv6_hdr));
+	zassert_true(ret == 0, "IPv6 header append failed");
+
+	ret = net_pkt_write(pkt, &frag_hdr, sizeof(frag_hdr));
+	zassert_true(ret == 0, "IPv6 fragment header append failed");
+
+	ret = net_pkt_memset(pkt, offset, len);
+	zassert_true(ret == 0, "IPv6 fragment payload append failed");
+
+	net_pkt_set_ipv6_hdr_prev(pkt, offsetof(struct net_ipv6_hdr, nexthdr));
+	net_pkt_set_ipv6_fragment_start(pkt, sizeof(struct net_ipv6_hdr));
+	net_pkt_set_overwrite(pkt, true);
+
+	/* The cursor is just after the nexthdr field of the fragment header */
+	net_pkt_cursor_init(pkt);
+	net_pkt_skip(pkt, sizeof(struct net_ipv6_hdr) + 1);
+
+	verdict = net_ipv6_handle_fragment_hdr(pkt, &ipv6_hdr,
+					       NET_IPV6_NEXTHDR_FRAG);
+	if (verdict == NET_DROP) {
+		net_pkt_unref(pkt);
+	}
+
+	return verdict;
+}
+
+static void reass_count_cb(struct net_reassembly *reass, void *user_data)
+{
+	int *count = user_data;
+
+	(*count)++;
+}
+
+static int pending_reassemblies(void)
+{
+	int count = 0;
+
+	net_ipv6_frag_foreach(reass_count_cb, &count);
+
+	return count;
+}
+
+static void test_recv_ipv6_fragment_out_of_order(void)
+{
+	zassert_equal(pending_reassemblies(), 0, "Pending reassembly");
+
+	zassert_equal(recv_fragment(0x100, 64, false, 16), NET_OK,
+		      "Last fragment not taken");
+	zassert_equal(recv_fragment(0x100, 0, true, 32), NET_OK,
+		      "First fragment not taken");
+	zassert_equal(recv_fragment(0x100, 64, false, 16), NET_DROP,
+		      "Duplicate fragment taken");
+	zassert_equal(pending_reassemblies(), 1, "Reassembly not pending");
+
+	zassert_equal(recv_fragment(0x100, 32, true, 32), NET_OK,
+		      "Middle fragment not taken");
+	zassert_equal(pending_reassemblies(), 0, "Reassembly not complete");
+}
+
+static void test_recv_ipv6_fragment_overlap(void)
+{
+	zassert_equal(recv_fragment(0x200, 0, true, 32), NET_OK,
+		      "First fragment not taken");
+	zassert_equal(recv_fragment(0x200, 16, true, 32), NET_DROP,
+		      "Overlapping fragment taken");
+	zassert_equal(pending_reassemblies(), 0,
+		      "Reassembly not discarded on overlap");
+}
+
+static void test_recv_ipv6_fragment_concurrent(void)
+{
+	uint32_t id;
+
+	for (id = 0x300; id < 0x300 + CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT;
+	     id++) {
+		zassert_equal(recv_fragment(id, 0, true, 32), NET_OK,
+			      "First fragment not taken");
+	}
+
+	zassert_equal(pending_reassemblies(),
+		      CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT,
+		      "Reassemblies not pending");
+
+	/* One more datagram makes room for itself */
+	zassert_equal(recv_fragment(id, 32, false, 8), NET_OK,
+		      "Last fragment not taken");
+	zassert_equal(pending_reassemblies(),
+		      CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT,
+		      "Too many reassemblies pending");
+
+	zassert_equal(recv_fragment(id, 0, true, 32), NET_OK,
+		      "First fragment not taken");
+	zassert_equal(pending_reassemblies(),
+		      CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT - 1,
+		      "Reassembly not complete");
+
+	/* Let the remaining reassemblies time out */
+	k_sleep(K_SECONDS(CONFIG_NET_IPV6_FRAGMENT_TIMEOUT + 1));
+
+	zassert_equal(pending_reassemblies(), 0, "Reassembly not timed out");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(net_ipv6_fragment_test,
@@ -2059,7 +2187,10 @@ void test_main(void)
 			 ztest_unit_test(test_send_ipv6_fragment),
 			 ztest_unit_test(test_send_ipv6_fragment_large_hbho),
 			 ztest_unit_test(test_send_ipv6_fragment_without_hbho),
-			 ztest_unit_test(test_recv_ipv6_fragment)
+			 ztest_unit_test(test_recv_ipv6_fragment),
+			 ztest_unit_test(test_recv_ipv6_fragment_out_of_order),
+			 ztest_unit_test(test_recv_ipv6_fragment_overlap),
+			 ztest_unit_test(test_recv_ipv6_fragment_concurrent)
 			 );
 
 	ztest_run_test_suite(net_ipv6_fragment_test);
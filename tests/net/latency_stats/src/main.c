@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_STATISTICS_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <errno.h>
+#include <device.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_mgmt.h>
+#include <net/dummy.h>
+
+#include <ztest.h>
+
+#include "net_stats.h"
+
+#define BUCKETS CONFIG_NET_PKT_LATENCY_STATS_BUCKETS
+
+static struct net_stats_latency before[NET_STATS_LATENCY_STAGE_COUNT];
+static struct net_stats_latency after[NET_STATS_LATENCY_STAGE_COUNT];
+
+static struct net_if *iface;
+static uint32_t bucket_cycles;
+
+static int dummy_send(const struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static struct dummy_api dummy_if_api = {
+	.send = dummy_send,
+};
+
+NET_DEVICE_INIT(latency_test, "latency_test", NULL, NULL, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &dummy_if_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 1500);
+
+static void latency_get(struct net_if *stats_iface,
+			struct net_stats_latency *latency)
+{
+	int ret;
+
+	ret = net_mgmt(NET_REQUEST_STATS_GET_LATENCY, stats_iface, latency,
+		       sizeof(before));
+	zassert_equal(ret, 0, "cannot get latency statistics (%d)", ret);
+}
+
+/* Record a packet that spent diff cycles in the stage and return the
+ * bucket that was updated.
+ */
+static int latency_update(enum net_stats_latency_stage stage, uint32_t diff)
+{
+	struct net_pkt *pkt;
+	int i, bucket = -1;
+
+	pkt = net_pkt_alloc_on_iface(iface, K_NO_WAIT);
+	zassert_not_null(pkt, "cannot allocate packet");
+
+	latency_get(NULL, before);
+
+	net_pkt_set_latency_tick(pkt, k_cycle_get_32() - diff);
+	net_stats_update_latency(pkt, stage);
+
+	latency_get(NULL, after);
+
+	net_pkt_unref(pkt);
+
+	for (i = 0; i < BUCKETS; i++) {
+		if (after[stage].bucket[i] == before[stage].bucket[i]) {
+			continue;
+		}
+
+		zassert_equal(after[stage].bucket[i],
+			      before[stage].bucket[i] + 1,
+			      "bucket %d updated more than once", i);
+		zassert_equal(bucket, -1, "several buckets updated");
+		bucket = i;
+	}
+
+	zassert_true(after[stage].sum - before[stage].sum >= diff,
+		     "latency not added to sum");
+	zassert_true(after[stage].max >= diff, "max latency not updated");
+
+	return bucket;
+}
+
+static void test_setup(void)
+{
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	zassert_not_null(iface, "no interface");
+
+	bucket_cycles = k_us_to_cyc_ceil32(
+				CONFIG_NET_PKT_LATENCY_STATS_BUCKET_USEC);
+	zassert_true(bucket_cycles > 1, "cycle counter too slow");
+}
+
+static void test_latency_bucket(void)
+{
+	enum net_stats_latency_stage stage = NET_STATS_LATENCY_RX_IP;
+	int bucket;
+
+	/* Each latency is in the middle of its bucket so that the few
+	 * cycles of the test itself do not move it to the next one.
+	 */
+	bucket = latency_update(stage, 0);
+	zassert_equal(bucket, 0, "no latency in bucket %d", bucket);
+
+	bucket = latency_update(stage, bucket_cycles / 2);
+	zassert_equal(bucket, 0, "short latency in bucket %d", bucket);
+
+	bucket = latency_update(stage, bucket_cycles + bucket_cycles / 2);
+	zassert_equal(bucket, 1, "1.5 bucket latency in bucket %d", bucket);
+
+	bucket = latency_update(stage, 3 * bucket_cycles);
+	zassert_equal(bucket, 2, "3 bucket latency in bucket %d", bucket);
+
+	/* Latencies that do not fit go to the last bucket */
+	bucket = latency_update(stage, 100 * bucket_cycles);
+	zassert_equal(bucket, BUCKETS - 1, "long latency in bucket %d",
+		      bucket);
+}
+
+static void test_latency_stages(void)
+{
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_on_iface(iface, K_NO_WAIT);
+	zassert_not_null(pkt, "cannot allocate packet");
+
+	latency_get(NULL, before);
+
+	/* A stage ends where the next one starts */
+	net_pkt_set_latency_tick(pkt, k_cycle_get_32() - 4 * bucket_cycles);
+	net_stats_update_latency(pkt, NET_STATS_LATENCY_TX_IP);
+	net_stats_update_latency(pkt, NET_STATS_LATENCY_TX_QUEUE);
+
+	latency_get(NULL, after);
+
+	net_pkt_unref(pkt);
+
+	zassert_true(after[NET_STATS_LATENCY_TX_IP].bucket[BUCKETS - 1] >
+		     before[NET_STATS_LATENCY_TX_IP].bucket[BUCKETS - 1],
+		     "first stage not in last bucket");
+	zassert_true(after[NET_STATS_LATENCY_TX_QUEUE].bucket[0] >
+		     before[NET_STATS_LATENCY_TX_QUEUE].bucket[0],
+		     "second stage not in first bucket");
+}
+
+static void test_latency_clone(void)
+{
+	struct net_pkt *pkt, *clone;
+
+	pkt = net_pkt_alloc_with_buffer(iface, 16, AF_UNSPEC, 0, K_NO_WAIT);
+	zassert_not_null(pkt, "cannot allocate packet");
+
+	net_pkt_set_latency_tick(pkt, 12345);
+
+	clone = net_pkt_clone(pkt, K_NO_WAIT);
+	zassert_not_null(clone, "cannot clone packet");
+	zassert_equal(net_pkt_latency_tick(clone), 12345,
+		      "latency tick not cloned");
+
+	net_pkt_unref(clone);
+	net_pkt_unref(pkt);
+}
+
+static void test_latency_get(void)
+{
+	int ret;
+
+	ret = net_mgmt(NET_REQUEST_STATS_GET_LATENCY, NULL, before,
+		       sizeof(before[0]));
+	zassert_equal(ret, -EINVAL, "short buffer accepted (%d)", ret);
+
+#if defined(CONFIG_NET_STATISTICS_PER_INTERFACE)
+	/* The interface statistics hold the same packets as the global
+	 * ones as there is only one interface.
+	 */
+	latency_get(NULL, before);
+	latency_get(iface, after);
+
+	zassert_mem_equal(before, after, sizeof(before),
+			  "interface statistics differ");
+#endif
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_latency_stats,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_latency_bucket),
+			 ztest_unit_test(test_latency_stages),
+			 ztest_unit_test(test_latency_clone),
+			 ztest_unit_test(test_latency_get));
+
+	ztest_run_test_suite(net_latency_stats);
+}
@@ -947,6 +947,147 @@ static void test_observer_client(void)
 	zassert_not_null(reply, "Couldn't find a matching waiting reply");
 }
 
+#if defined(CONFIG_COAP_COCOA)
+static void test_cocoa_rto(void)
+{
+	struct coap_rto_estimator est;
+	struct coap_pending *pending;
+	struct coap_packet cpkt;
+	uint8_t *data = data_buf[0];
+	uint32_t rto, timeout;
+	int i, r;
+
+	coap_rto_estimator_init(&est);
+	zassert_equal(est.rto, CONFIG_COAP_INIT_ACK_TIMEOUT_MS,
+		      "Wrong initial RTO");
+
+	r = coap_packet_init(&cpkt, data, COAP_BUF_SIZE, COAP_VERSION_1,
+			     COAP_TYPE_CON, 0, NULL, COAP_METHOD_GET,
+			     coap_next_id());
+	zassert_equal(r, 0, "Could not initialize packet");
+
+	pending = coap_pending_next_unused(pendings, NUM_PENDINGS);
+	zassert_not_null(pending, "No free pending");
+
+	/* Acknowledged without retransmission, the strong estimator pulls
+	 * the RTO down towards the measured RTT.
+	 */
+	for (i = 0; i < 4; i++) {
+		rto = est.rto;
+
+		r = coap_pending_init(pending, &cpkt,
+				      (struct sockaddr *)&dummy_addr,
+				      COAP_DEFAULT_MAX_RETRANSMIT);
+		zassert_equal(r, 0, "Could not initialize pending");
+
+		coap_pending_set_rto_estimator(pending, &est);
+		zassert_true(coap_pending_cycle(pending),
+			     "Pending expired too early");
+		zassert_true(pending->timeout >= rto &&
+			     pending->timeout <= rto + rto / 2U,
+			     "Initial timeout %u out of range for RTO %u",
+			     pending->timeout, rto);
+
+		coap_rto_estimator_update(pending);
+		zassert_true(est.rto < rto, "RTO did not decrease");
+	}
+
+	/* Small RTOs back off by a factor of 3 */
+	zassert_true(est.rto < 1000U, "RTO %u should be below 1s", est.rto);
+
+	r = coap_pending_init(pending, &cpkt, (struct sockaddr *)&dummy_addr,
+			      COAP_DEFAULT_MAX_RETRANSMIT);
+	zassert_equal(r, 0, "Could not initialize pending");
+
+	coap_pending_set_rto_estimator(pending, &est);
+	zassert_true(coap_pending_cycle(pending), "Pending expired too early");
+
+	for (i = 0; i < 3; i++) {
+		timeout = pending->timeout;
+		zassert_true(coap_pending_cycle(pending),
+			     "Pending expired too early");
+		zassert_equal(pending->timeout, timeout * 3U,
+			      "Wrong backoff");
+	}
+
+	/* More than two retransmissions give no RTT sample */
+	rto = est.rto;
+	coap_rto_estimator_update(pending);
+	zassert_equal(est.rto, rto, "RTO should not change");
+
+	coap_pending_clear(pending);
+}
+#else
+static void test_cocoa_rto(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_COAP_COCOA */
+
+#if defined(CONFIG_COAP_OBSERVE_COALESCE)
+static int coalesce_notified;
+
+static void coalesce_notify_callback(struct coap_resource *resource,
+				     struct coap_observer *observer)
+{
+	coalesce_notified++;
+}
+
+static void test_observer_coalesce(void)
+{
+	static const char * const path[] = { "c", NULL };
+	struct coap_resource resource = {
+		.path = path,
+		.notify = coalesce_notify_callback,
+	};
+	struct coap_observer *observer;
+	struct coap_packet req;
+	uint8_t *data = data_buf[0];
+	int32_t next;
+	int r;
+
+	r = coap_packet_init(&req, data, COAP_BUF_SIZE, COAP_VERSION_1,
+			     COAP_TYPE_CON, 0, NULL, COAP_METHOD_GET,
+			     coap_next_id());
+	zassert_equal(r, 0, "Could not initialize packet");
+
+	observer = coap_observer_next_unused(observers, NUM_OBSERVERS);
+	zassert_not_null(observer, "There should be an available observer");
+
+	coap_observer_init(observer, &req, (struct sockaddr *)&dummy_addr);
+	coap_register_observer(&resource, observer);
+
+	/* The first notification is sent immediately */
+	coalesce_notified = 0;
+	r = coap_resource_notify(&resource);
+	zassert_equal(r, 0, "Could not notify resource");
+	zassert_equal(coalesce_notified, 1, "Observer not notified");
+
+	/* Further updates within the interval are coalesced */
+	coap_resource_notify(&resource);
+	coap_resource_notify(&resource);
+	zassert_equal(coalesce_notified, 1, "Notification not deferred");
+
+	next = coap_resource_notify_deferred(&resource);
+	zassert_true(next > 0 && next <= CONFIG_COAP_OBSERVE_MIN_INTERVAL_MS,
+		     "Wrong time until the deferred notification (%d)", next);
+
+	k_sleep(K_MSEC(next + 1));
+
+	next = coap_resource_notify_deferred(&resource);
+	zassert_equal(coalesce_notified, 2, "Deferred notification not sent");
+	zassert_equal(next, SYS_FOREVER_MS, "No notification should remain");
+
+	coap_remove_observer(&resource, observer);
+	memset(observer, 0, sizeof(*observer));
+}
+#else
+static void test_observer_coalesce(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_COAP_OBSERVE_COALESCE */
+
 void test_main(void)
 {
 	ztest_test_suite(coap_tests,
@@ -967,7 +1108,9 @@ void test_main(void)
 			 ztest_unit_test(test_block2_size),
 			 ztest_unit_test(test_retransmit_second_round),
 			 ztest_unit_test(test_observer_server),
-			 ztest_unit_test(test_observer_client));
+			 ztest_unit_test(test_observer_client),
+			 ztest_unit_test(test_cocoa_rto),
+			 ztest_unit_test(test_observer_coalesce));
 
 	ztest_run_test_suite(coap_tests);
 }
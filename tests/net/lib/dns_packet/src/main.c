@@ -1236,6 +1236,253 @@ static void test_dns_flags_len(void)
 		      "DNS message length check failed (%d)", ret);
 }
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+static void dns_cache_count_cb(const char *query, enum dns_query_type type,
+			       const struct dns_addrinfo *info, size_t count,
+			       uint32_t ttl, void *user_data)
+{
+	int *entries = user_data;
+
+	zassert_true(ttl <= 60, "Invalid ttl %u", ttl);
+
+	(*entries)++;
+}
+
+static void test_dns_cache(void)
+{
+	struct dns_addrinfo info = { 0 };
+	struct dns_addrinfo found[2];
+	int entries = 0;
+	int ret;
+
+	dns_resolve_cache_flush();
+
+	info.ai_family = AF_INET;
+	info.ai_addr.sa_family = AF_INET;
+	info.ai_addrlen = sizeof(struct sockaddr_in);
+	net_sin(&info.ai_addr)->sin_addr.s4_addr[0] = 192;
+	net_sin(&info.ai_addr)->sin_addr.s4_addr[1] = 0;
+	net_sin(&info.ai_addr)->sin_addr.s4_addr[2] = 2;
+	net_sin(&info.ai_addr)->sin_addr.s4_addr[3] = 1;
+
+	dns_cache_add("www.zephyrproject.org", DNS_QUERY_TYPE_A, &info, 1, 60);
+	dns_cache_add("nx.zephyrproject.org", DNS_QUERY_TYPE_A, NULL, 0, 30);
+	dns_cache_add("ttl0.zephyrproject.org", DNS_QUERY_TYPE_A, &info, 1, 0);
+
+	ret = dns_cache_find("WWW.zephyrproject.org", DNS_QUERY_TYPE_A,
+			     found, ARRAY_SIZE(found));
+	zassert_equal(ret, 1, "Cached address not found (%d)", ret);
+	zassert_mem_equal(&found[0], &info, sizeof(info),
+			  "Invalid cached address");
+
+	ret = dns_cache_find("www.zephyrproject.org", DNS_QUERY_TYPE_AAAA,
+			     found, ARRAY_SIZE(found));
+	zassert_equal(ret, -ENOENT, "Found address of wrong type (%d)", ret);
+
+	ret = dns_cache_find("nx.zephyrproject.org", DNS_QUERY_TYPE_A,
+			     found, ARRAY_SIZE(found));
+	zassert_equal(ret, 0, "Negative entry not found (%d)", ret);
+
+	ret = dns_cache_find("ttl0.zephyrproject.org", DNS_QUERY_TYPE_A,
+			     found, ARRAY_SIZE(found));
+	zassert_equal(ret, -ENOENT, "Entry with zero ttl cached (%d)", ret);
+
+	ret = dns_resolve_cache_foreach(dns_cache_count_cb, &entries);
+	zassert_equal(ret, 2, "Invalid number of cache entries (%d)", ret);
+	zassert_equal(entries, 2, "Invalid number of callbacks (%d)", entries);
+
+	dns_resolve_cache_flush();
+
+	ret = dns_resolve_cache_foreach(dns_cache_count_cb, &entries);
+	zassert_equal(ret, 0, "Cache not flushed (%d)", ret);
+}
+
+struct coalesce_result {
+	int addresses;
+	int status;
+};
+
+static void coalesce_cb(enum dns_resolve_status status,
+			struct dns_addrinfo *info,
+			void *user_data)
+{
+	struct coalesce_result *result = user_data;
+
+	if (status == DNS_EAI_INPROGRESS) {
+		result->addresses++;
+	} else {
+		result->status = status;
+	}
+}
+
+/* Labels + query type of www.zephyrproject.org, used for the query hash */
+static const uint8_t coalesce_query[] = {
+	0x03, 0x77, 0x77, 0x77, 0x0d, 0x7a, 0x65, 0x70,
+	0x68, 0x79, 0x72, 0x70, 0x72, 0x6f, 0x6a, 0x65,
+	0x63, 0x74, 0x03, 0x6f, 0x72, 0x67, 0x00,
+	0x00, 0x01
+};
+
+static struct dns_resolve_context coalesce_ctx;
+
+static void test_dns_coalesce_cancel(void)
+{
+	struct coalesce_result results[3];
+	struct dns_msg_t dns_msg = { 0 };
+	uint8_t msg[sizeof(resp_valid_response_ipv4_6)];
+	uint16_t ids[3];
+	uint16_t dns_id = 0;
+	uint16_t query_hash = 0;
+	int query_idx = -1;
+	int ret, i;
+
+	dns_resolve_cache_flush();
+
+	/* A context without servers, the first query sends nothing */
+	memset(&coalesce_ctx, 0, sizeof(coalesce_ctx));
+	memset(results, 0, sizeof(results));
+	k_mutex_init(&coalesce_ctx.lock);
+	coalesce_ctx.state = DNS_RESOLVE_CONTEXT_ACTIVE;
+
+	for (i = 0; i < ARRAY_SIZE(ids); i++) {
+		ret = dns_resolve_name(&coalesce_ctx, DNAME1, DNS_QUERY_TYPE_A,
+				       &ids[i], coalesce_cb, &results[i],
+				       10000);
+		zassert_equal(ret, 0, "Query %d failed (%d)", i, ret);
+	}
+
+	zassert_is_null(coalesce_ctx.queries[0].leader, "First query waits");
+	zassert_equal_ptr(coalesce_ctx.queries[1].leader,
+			  &coalesce_ctx.queries[0], "Query 1 not coalesced");
+	zassert_equal_ptr(coalesce_ctx.queries[2].leader,
+			  &coalesce_ctx.queries[0], "Query 2 not coalesced");
+
+	/* Cancelling the query that was sent cancels only that query, the
+	 * next one takes over the request.
+	 */
+	ret = dns_resolve_cancel(&coalesce_ctx, ids[0]);
+	zassert_equal(ret, 0, "Cannot cancel query (%d)", ret);
+
+	zassert_equal(results[0].status, DNS_EAI_CANCELED,
+		      "Query 0 not cancelled (%d)", results[0].status);
+	zassert_equal(results[1].status, 0, "Query 1 cancelled");
+	zassert_equal(results[2].status, 0, "Query 2 cancelled");
+	zassert_is_null(coalesce_ctx.queries[1].leader, "Query 1 not promoted");
+	zassert_equal_ptr(coalesce_ctx.queries[2].leader,
+			  &coalesce_ctx.queries[1], "Query 2 not re-pointed");
+
+	/* The answer to the request of the cancelled query completes the
+	 * waiting queries. The hash is set when sending the request.
+	 */
+	coalesce_ctx.queries[1].query_hash = crc16_ansi(coalesce_query,
+							 sizeof(coalesce_query));
+
+	memcpy(msg, resp_valid_response_ipv4_6, sizeof(msg));
+	UNALIGNED_PUT(htons(ids[0]), (uint16_t *)msg);
+
+	dns_msg.msg = msg;
+	dns_msg.msg_size = sizeof(msg);
+
+	ret = dns_validate_msg(&coalesce_ctx, &dns_msg, &dns_id, &query_idx,
+			       NULL, &query_hash);
+	zassert_equal(ret, DNS_EAI_ALLDONE, "Answer not accepted (%d)", ret);
+	zassert_equal(query_idx, 1, "Answer matched to query %d", query_idx);
+	zassert_equal(results[0].addresses, 0, "Cancelled query answered");
+	zassert_equal(results[1].addresses, 1, "Query 1 not answered");
+	zassert_equal(results[2].addresses, 1, "Query 2 not answered");
+
+	ret = dns_resolve_cancel(&coalesce_ctx, ids[1]);
+	zassert_equal(ret, 0, "Cannot cancel query (%d)", ret);
+	zassert_equal(results[1].status, DNS_EAI_CANCELED,
+		      "Query 1 not cancelled (%d)", results[1].status);
+	zassert_equal(results[2].status, 0, "Query 2 cancelled");
+
+	ret = dns_resolve_cancel(&coalesce_ctx, ids[2]);
+	zassert_equal(ret, 0, "Cannot cancel query (%d)", ret);
+	zassert_equal(results[2].status, DNS_EAI_CANCELED,
+		      "Query 2 not cancelled (%d)", results[2].status);
+
+	dns_resolve_cache_flush();
+}
+
+#else
+static void test_dns_cache(void)
+{
+	ztest_test_skip();
+}
+
+static void test_dns_coalesce_cancel(void)
+{
+	ztest_test_skip();
+}
+#endif
+
+/* NOERROR response to www.zephyrproject.org without any answers */
+static uint8_t resp_nodata[] = {
+	/* DNS msg header (12 bytes) */
+	0xb0, 0x41, 0x81, 0x80, 0x00, 0x01, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00,
+
+	/* Query string (www.zephyrproject.org) */
+	0x03, 0x77, 0x77, 0x77, 0x0d, 0x7a, 0x65, 0x70,
+	0x68, 0x79, 0x72, 0x70, 0x72, 0x6f, 0x6a, 0x65,
+	0x63, 0x74, 0x03, 0x6f, 0x72, 0x67, 0x00,
+
+	/* Query type */
+	0x00, 0x01,
+
+	/* Query class */
+	0x00, 0x01,
+};
+
+/* Labels + query type of the query, used for the query hash */
+static const uint8_t nodata_query[] = {
+	0x03, 0x77, 0x77, 0x77, 0x0d, 0x7a, 0x65, 0x70,
+	0x68, 0x79, 0x72, 0x70, 0x72, 0x6f, 0x6a, 0x65,
+	0x63, 0x74, 0x03, 0x6f, 0x72, 0x67, 0x00,
+	0x00, 0x01
+};
+
+static void test_dns_nodata_response(void)
+{
+	struct dns_addrinfo found[1];
+	struct dns_msg_t dns_msg = { 0 };
+	uint16_t dns_id = 0;
+	uint16_t query_hash = 0;
+	int query_idx = -1;
+	int ret;
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	dns_resolve_cache_flush();
+#endif
+
+	dns_msg.msg = resp_nodata;
+	dns_msg.msg_size = sizeof(resp_nodata);
+
+	setup_dns_context(&dns_ctx, 0, dns_unpack_header_id(resp_nodata),
+			  nodata_query, sizeof(nodata_query),
+			  DNS_QUERY_TYPE_A);
+	dns_ctx.queries[0].query = DNAME1;
+
+	ret = dns_validate_msg(&dns_ctx, &dns_msg, &dns_id, &query_idx,
+			       NULL, &query_hash);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	zassert_equal(ret, DNS_EAI_NODATA, "Empty answer not reported (%d)",
+		      ret);
+
+	ret = dns_cache_find(DNAME1, DNS_QUERY_TYPE_A, found,
+			     ARRAY_SIZE(found));
+	zassert_equal(ret, 0, "Empty answer not cached (%d)", ret);
+
+	dns_resolve_cache_flush();
+#else
+	/* Without the cache, an empty answer is still an invalid one */
+	ARG_UNUSED(found);
+	zassert_equal(ret, DNS_EAI_FAIL, "Empty answer accepted (%d)", ret);
+#endif
+}
+
 void test_main(void)
 {
 	ztest_test_suite(dns_tests,
@@ -1247,7 +1494,10 @@ void test_main(void)
 			 ztest_unit_test(test_dns_id_len),
 			 ztest_unit_test(test_dns_flags_len),
 			 ztest_unit_test(test_dns_malformed_responses),
-			 ztest_unit_test(test_dns_valid_responses)
+			 ztest_unit_test(test_dns_valid_responses),
+			 ztest_unit_test(test_dns_cache),
+			 ztest_unit_test(test_dns_coalesce_cancel),
+			 ztest_unit_test(test_dns_nodata_response)
 		);
 
 	ztest_run_test_suite(dns_tests);
@@ -0,0 +1,560 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_HTTP_LOG_LEVEL);
+
+#include <ztest.h>
+#include <stdlib.h>
+#include <net/socket.h>
+#include <net/http_client.h>
+
+#define SERVER_ADDR "192.0.2.1"
+#define SERVER_PORT 8080
+#define SERVER_PORT_STR "8080"
+
+#define TIMEOUT_MS 2000
+#define SERVER_STACK_SIZE 2048
+
+#define OK_RESPONSE "HTTP/1.1 200 OK\r\n" \
+		    "Content-Length: 2\r\n" \
+		    "\r\n" \
+		    "ok"
+
+#define HEADERS_END "\r\n\r\n"
+
+/* The server side of the tests, one step at a time: wait for a number of
+ * header (or chunked body) terminators, then send the response and close
+ * the connection if asked to.
+ */
+struct server_step {
+	const char *response;
+	int terminators;
+	bool close;
+};
+
+static struct server_step step;
+static K_SEM_DEFINE(step_sem, 0, 1);
+static K_SEM_DEFINE(done_sem, 0, 1);
+
+static int listen_sock = -1;
+static int conn_sock = -1;
+static char req_buf[512];
+static size_t req_len;
+
+static K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+
+static int connect_count;
+static int payload_count;
+static int response_count;
+static uint16_t status_codes[3];
+static char body[32];
+static size_t body_len;
+
+static int count_terminators(void)
+{
+	const char *pos = req_buf;
+	int count = 0;
+
+	while ((pos = strstr(pos, HEADERS_END)) != NULL) {
+		pos += sizeof(HEADERS_END) - 1;
+		count++;
+	}
+
+	return count;
+}
+
+static void server_recv(void)
+{
+	struct pollfd fds[2];
+	int ret;
+
+	req_len = 0;
+	req_buf[0] = '\0';
+
+	while (count_terminators() < step.terminators) {
+		fds[0].fd = listen_sock;
+		fds[0].events = POLLIN;
+		fds[1].fd = conn_sock;
+		fds[1].events = POLLIN;
+
+		ret = poll(fds, conn_sock < 0 ? 1 : 2, TIMEOUT_MS);
+		if (ret <= 0) {
+			return;
+		}
+
+		if (fds[0].revents & POLLIN) {
+			/* The client opened a new connection */
+			if (conn_sock >= 0) {
+				(void)close(conn_sock);
+			}
+
+			conn_sock = accept(listen_sock, NULL, NULL);
+			continue;
+		}
+
+		ret = recv(conn_sock, req_buf + req_len,
+			   sizeof(req_buf) - 1 - req_len, 0);
+		if (ret <= 0) {
+			(void)close(conn_sock);
+			conn_sock = -1;
+			continue;
+		}
+
+		req_len += ret;
+		req_buf[req_len] = '\0';
+	}
+}
+
+static void server_fn(void *p1, void *p2, void *p3)
+{
+	while (true) {
+		k_sem_take(&step_sem, K_FOREVER);
+
+		server_recv();
+
+		if (step.response && conn_sock >= 0) {
+			(void)send(conn_sock, step.response,
+				   strlen(step.response), 0);
+		}
+
+		if (step.close && conn_sock >= 0) {
+			(void)close(conn_sock);
+			conn_sock = -1;
+		}
+
+		k_sem_give(&done_sem);
+	}
+}
+
+static void server_expect(int terminators, const char *response, bool close)
+{
+	step.terminators = terminators;
+	step.response = response;
+	step.close = close;
+
+	k_sem_give(&step_sem);
+}
+
+static void server_wait(void)
+{
+	zassert_equal(k_sem_take(&done_sem, K_MSEC(2 * TIMEOUT_MS)), 0,
+		      "server step not done");
+}
+
+static int connect_cb(const char *host, const char *port, void *user_data)
+{
+	struct sockaddr_in addr;
+	int sock;
+
+	connect_count++;
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(sock >= 0, "socket open failed");
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(atoi(port));
+	zassert_equal(inet_pton(AF_INET, host, &addr.sin_addr), 1,
+		      "inet_pton failed");
+
+	if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		(void)close(sock);
+		return -errno;
+	}
+
+	return sock;
+}
+
+static int other_connect_cb(const char *host, const char *port,
+			    void *user_data)
+{
+	return connect_cb(host, port, user_data);
+}
+
+static int connect_server(void)
+{
+	return connect_cb(SERVER_ADDR, SERVER_PORT_STR, NULL);
+}
+
+static void response_cb(struct http_response *rsp,
+			enum http_final_call final_data, void *user_data)
+{
+	if (final_data != HTTP_DATA_FINAL) {
+		return;
+	}
+
+	if (response_count < ARRAY_SIZE(status_codes)) {
+		status_codes[response_count] = rsp->http_status_code;
+	}
+
+	response_count++;
+}
+
+static int payload_cb(int sock, struct http_request *req, void *user_data)
+{
+	payload_count++;
+
+	return send(sock, "hi", 2, 0);
+}
+
+static const char *chunks[] = { "hello", " world" };
+
+static int payload_chunk_cb(struct http_request *req, const uint8_t **data,
+			    void *user_data)
+{
+	const char *chunk;
+
+	if (payload_count >= ARRAY_SIZE(chunks)) {
+		return 0;
+	}
+
+	chunk = chunks[payload_count++];
+	*data = (const uint8_t *)chunk;
+
+	return strlen(chunk);
+}
+
+static int body_cb(struct http_response *rsp, const uint8_t *data,
+		   size_t len, void *user_data)
+{
+	bool abort = POINTER_TO_INT(user_data);
+
+	zassert_true(body_len + len <= sizeof(body), "body too long");
+
+	memcpy(body + body_len, data, len);
+	body_len += len;
+
+	return abort ? -1 : 0;
+}
+
+static uint8_t recv_bufs[3][128];
+
+static void prepare_req(struct http_request *req, int idx,
+			enum http_method method, const char *url)
+{
+	memset(req, 0, sizeof(*req));
+
+	req->method = method;
+	req->url = url;
+	req->host = SERVER_ADDR;
+	req->port = SERVER_PORT_STR;
+	req->protocol = "HTTP/1.1";
+	req->response = response_cb;
+	req->recv_buf = recv_bufs[idx];
+	req->recv_buf_len = sizeof(recv_bufs[idx]);
+}
+
+static void reset_counters(void)
+{
+	connect_count = 0;
+	payload_count = 0;
+	response_count = 0;
+	body_len = 0;
+	memset(status_codes, 0, sizeof(status_codes));
+}
+
+static const struct http_client_pool_transport plain = {
+	.connect_cb = connect_cb,
+};
+
+static const sec_tag_t sec_tags[] = { 1 };
+
+static const struct http_client_pool_transport tls_like = {
+	.connect_cb = connect_cb,
+	.sec_tags = sec_tags,
+	.sec_tag_count = ARRAY_SIZE(sec_tags),
+	.tls = true,
+};
+
+static const struct http_client_pool_transport other = {
+	.connect_cb = other_connect_cb,
+};
+
+static void test_server_start(void)
+{
+	struct sockaddr_in addr;
+	int ret;
+
+	listen_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(listen_sock >= 0, "socket open failed");
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(SERVER_PORT);
+	ret = inet_pton(AF_INET, SERVER_ADDR, &addr.sin_addr);
+	zassert_equal(ret, 1, "inet_pton failed");
+
+	ret = bind(listen_sock, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(ret, 0, "bind failed (%d)", errno);
+	ret = listen(listen_sock, 2);
+	zassert_equal(ret, 0, "listen failed (%d)", errno);
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack), server_fn,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+}
+
+static void test_pool_reuse(void)
+{
+	struct http_request req;
+	int ret;
+
+	reset_counters();
+	http_client_pool_close_idle();
+
+	prepare_req(&req, 0, HTTP_GET, "/");
+	server_expect(1, OK_RESPONSE, false);
+	ret = http_client_pool_req(&req, &plain, TIMEOUT_MS, NULL);
+	zassert_true(ret > 0, "request failed (%d)", ret);
+	server_wait();
+
+	prepare_req(&req, 0, HTTP_GET, "/again");
+	server_expect(1, OK_RESPONSE, false);
+	ret = http_client_pool_req(&req, &plain, TIMEOUT_MS, NULL);
+	zassert_true(ret > 0, "request failed (%d)", ret);
+	server_wait();
+
+	zassert_equal(connect_count, 1, "connection not reused");
+	zassert_equal(response_count, 2, "missing response");
+	zassert_equal(status_codes[1], 200, "invalid status");
+	zassert_not_null(strstr(req_buf, "GET /again HTTP/1.1"),
+			 "invalid request %s", req_buf);
+}
+
+static void test_pool_transport(void)
+{
+	struct http_request req;
+	int ret;
+
+	reset_counters();
+	http_client_pool_close_idle();
+
+	prepare_req(&req, 0, HTTP_GET, "/");
+	server_expect(1, OK_RESPONSE, false);
+	ret = http_client_pool_req(&req, &plain, TIMEOUT_MS, NULL);
+	zassert_true(ret > 0, "request failed (%d)", ret);
+	server_wait();
+
+	/* Same host and port, but other credentials */
+	server_expect(1, OK_RESPONSE, false);
+	ret = http_client_pool_req(&req, &tls_like, TIMEOUT_MS, NULL);
+	zassert_true(ret > 0, "request failed (%d)", ret);
+	server_wait();
+
+	zassert_equal(connect_count, 2,
+		      "connection reused with other credentials");
+
+	/* Same host and port, but another connect callback. The pool is
+	 * full, so the least recently used connection is evicted.
+	 */
+	server_expect(1, OK_RESPONSE, false);
+	ret = http_client_pool_req(&req, &other, TIMEOUT_MS, NULL);
+	zassert_true(ret > 0, "request failed (%d)", ret);
+	server_wait();
+
+	zassert_equal(connect_count, 3,
+		      "connection reused with another transport");
+	zassert_equal(response_count, 3, "missing response");
+}
+
+static void test_pool_retry_idempotent(void)
+{
+	struct http_request req;
+	int ret;
+
+	reset_counters();
+	http_client_pool_close_idle();
+
+	/* The server closes the connection after the response without
+	 * telling the client, which keeps it in the pool.
+	 */
+	prepare_req(&req, 0, HTTP_GET, "/");
+	server_expect(1, OK_RESPONSE, true);
+	ret = http_client_pool_req(&req, &plain, TIMEOUT_MS, NULL);
+	zassert_true(ret > 0, "request failed (%d)", ret);
+	server_wait();
+
+	k_msleep(100);
+
+	prepare_req(&req, 0, HTTP_GET, "/retry");
+	server_expect(1, OK_RESPONSE, false);
+	ret = http_client_pool_req(&req, &plain, TIMEOUT_MS, NULL);
+	zassert_true(ret > 0, "request failed (%d)", ret);
+	server_wait();
+
+	zassert_equal(connect_count, 2, "request not sent again");
+	zassert_equal(response_count, 2, "missing response");
+	zassert_equal(status_codes[1], 200, "invalid status");
+}
+
+static void test_pool_no_retry(void)
+{
+	struct http_request req;
+	int ret;
+
+	reset_counters();
+	http_client_pool_close_idle();
+
+	prepare_req(&req, 0, HTTP_GET, "/");
+	server_expect(1, OK_RESPONSE, true);
+	ret = http_client_pool_req(&req, &plain, TIMEOUT_MS, NULL);
+	zassert_true(ret > 0, "request failed (%d)", ret);
+	server_wait();
+
+	k_msleep(100);
+
+	/* A POST may have been processed by the server, it must not be
+	 * sent again and its payload callback must be called only once.
+	 */
+	prepare_req(&req, 0, HTTP_POST, "/post");
+	req.payload_cb = payload_cb;
+	req.payload_len = 2;
+	ret = http_client_pool_req(&req, &plain, TIMEOUT_MS, NULL);
+
+	zassert_equal(connect_count, 1, "non-idempotent request sent again");
+	zassert_equal(payload_count, 1, "payload callback called again");
+	zassert_equal(response_count, 1, "unexpected response");
+	zassert_false(req.internal.response.message_complete,
+		      "unexpected response");
+}
+
+static void test_pipelining(void)
+{
+	struct http_request reqs[3];
+	struct http_request *req_list[3];
+	int sock, ret, i;
+
+	reset_counters();
+
+	for (i = 0; i < ARRAY_SIZE(reqs); i++) {
+		prepare_req(&reqs[i], i, HTTP_GET, "/");
+		req_list[i] = &reqs[i];
+	}
+
+	reqs[1].url = "/missing";
+
+	sock = connect_server();
+	zassert_true(sock >= 0, "connect failed (%d)", sock);
+
+	/* All the responses are sent at once, so the data of the following
+	 * responses is received with the first one.
+	 */
+	server_expect(3, OK_RESPONSE
+			 "HTTP/1.1 404 Not Found\r\n"
+			 "Content-Length: 0\r\n\r\n"
+			 OK_RESPONSE, false);
+
+	ret = http_client_req_pipeline(sock, req_list, ARRAY_SIZE(req_list),
+				       TIMEOUT_MS, NULL);
+	server_wait();
+
+	zassert_equal(ret, 3, "invalid number of responses (%d)", ret);
+	zassert_equal(response_count, 3, "missing response");
+	zassert_equal(status_codes[0], 200, "invalid status");
+	zassert_equal(status_codes[1], 404, "invalid status");
+	zassert_equal(status_codes[2], 200, "invalid status");
+	zassert_not_null(strstr(req_buf, "GET /missing HTTP/1.1"),
+			 "invalid request %s", req_buf);
+
+	(void)close(sock);
+}
+
+static void test_chunked_payload(void)
+{
+	struct http_request req;
+	int sock, ret;
+
+	reset_counters();
+
+	prepare_req(&req, 0, HTTP_POST, "/upload");
+	req.payload_chunk_cb = payload_chunk_cb;
+
+	sock = connect_server();
+	zassert_true(sock >= 0, "connect failed (%d)", sock);
+
+	/* Headers and the last chunk */
+	server_expect(2, OK_RESPONSE, false);
+
+	ret = http_client_req(sock, &req, TIMEOUT_MS, NULL);
+	server_wait();
+
+	zassert_true(ret > 0, "request failed (%d)", ret);
+	zassert_equal(payload_count, 2, "invalid number of chunks");
+	zassert_not_null(strstr(req_buf, "Transfer-Encoding: chunked\r\n"),
+			 "not chunked %s", req_buf);
+	zassert_not_null(strstr(req_buf, "\r\n\r\n5\r\nhello\r\n"
+					 "6\r\n world\r\n0\r\n\r\n"),
+			 "invalid chunks %s", req_buf);
+	zassert_equal(status_codes[0], 200, "invalid status");
+
+	(void)close(sock);
+}
+
+static void body_request(bool abort)
+{
+	struct http_request req;
+	int sock, ret;
+
+	reset_counters();
+
+	prepare_req(&req, 0, HTTP_GET, "/body");
+	req.body_cb = body_cb;
+
+	sock = connect_server();
+	zassert_true(sock >= 0, "connect failed (%d)", sock);
+
+	server_expect(1, "HTTP/1.1 200 OK\r\n"
+			 "Transfer-Encoding: chunked\r\n\r\n"
+			 "5\r\nhello\r\n6\r\n world\r\n0\r\n\r\n", false);
+
+	ret = http_client_req(sock, &req, TIMEOUT_MS, INT_TO_POINTER(abort));
+	server_wait();
+
+	zassert_true(ret > 0, "request failed (%d)", ret);
+
+	if (abort) {
+		zassert_equal(body_len, 5, "body not aborted");
+		zassert_false(req.internal.response.message_complete,
+			      "response not aborted");
+	} else {
+		zassert_equal(body_len, 11, "invalid body length");
+		zassert_mem_equal(body, "hello world", body_len,
+				  "invalid body");
+		zassert_true(req.internal.response.message_complete,
+			     "response not complete");
+	}
+
+	(void)close(sock);
+}
+
+static void test_body_cb(void)
+{
+	body_request(false);
+}
+
+static void test_body_cb_abort(void)
+{
+	body_request(true);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(http_client,
+			 ztest_unit_test(test_server_start),
+			 ztest_unit_test(test_pool_reuse),
+			 ztest_unit_test(test_pool_transport),
+			 ztest_unit_test(test_pool_retry_idempotent),
+			 ztest_unit_test(test_pool_no_retry),
+			 ztest_unit_test(test_pipelining),
+			 ztest_unit_test(test_chunked_payload),
+			 ztest_unit_test(test_body_cb),
+			 ztest_unit_test(test_body_cb_abort));
+
+	ztest_run_test_suite(http_client);
+}
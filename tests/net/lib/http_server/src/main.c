@@ -0,0 +1,460 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
+
+#include <ztest.h>
+#include <fcntl.h>
+#include <net/socket.h>
+#include <net/http_server.h>
+
+#define SERVER_ADDR "192.0.2.1"
+#define SERVER_PORT 8080
+
+#define INDEX_RESPONSE "HTTP/1.1 200 OK\r\n" \
+		       "Content-Length: 15\r\n" \
+		       "Content-Type: text/html\r\n" \
+		       "\r\n" \
+		       "<html>hi</html>"
+
+static const uint8_t index_html[] = "<html>hi</html>";
+static const uint8_t index_html_gz[] = {
+	0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+/* Larger than the TCP window, sent over several writes */
+#define LARGE_LEN 1500
+#define LARGE_RESPONSE "HTTP/1.1 200 OK\r\n" \
+		       "Content-Length: 1500\r\n" \
+		       "\r\n"
+
+static uint8_t large_body[LARGE_LEN];
+
+static uint8_t echo_buf[32];
+static size_t echo_len;
+
+static int echo_cb(struct http_server_client *client,
+		   const struct http_server_request *req,
+		   enum http_server_data_status status,
+		   const uint8_t *data, size_t len, void *user_data)
+{
+	if (status == HTTP_SERVER_DATA_MORE) {
+		if (echo_len + len > sizeof(echo_buf)) {
+			return -ENOMEM;
+		}
+
+		memcpy(echo_buf + echo_len, data, len);
+		echo_len += len;
+		return 0;
+	}
+
+	len = echo_len;
+	echo_len = 0;
+
+	return http_server_respond(client, 200, "text/plain", echo_buf, len);
+}
+
+#if defined(CONFIG_HTTP_SERVER_WEBSOCKET)
+/* Handshake example of RFC 6455, section 1.3 */
+#define WS_REQUEST "GET /ws HTTP/1.1\r\n" \
+		   "Upgrade: websocket\r\n" \
+		   "Connection: Upgrade\r\n" \
+		   "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n" \
+		   "Sec-WebSocket-Version: 13\r\n" \
+		   "\r\n"
+
+#define WS_RESPONSE "HTTP/1.1 101 Switching Protocols\r\n" \
+		    "Upgrade: websocket\r\n" \
+		    "Connection: Upgrade\r\n" \
+		    "Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n" \
+		    "\r\n"
+
+/* Masked text frame "hi" sent by the client along with the request */
+static const uint8_t ws_client_frame[] = {
+	0x81, 0x82, 0x01, 0x02, 0x03, 0x04, 'h' ^ 0x01, 'i' ^ 0x02,
+};
+
+/* Unmasked text frame "ok" sent back by the server */
+#define WS_SERVER_FRAME "\x81\x02" "ok"
+
+static uint8_t ws_data[sizeof(ws_client_frame)];
+static size_t ws_data_len;
+static bool ws_blocking;
+static K_SEM_DEFINE(ws_done, 0, 1);
+
+/* The Websocket library is not usable over real sockets with
+ * CONFIG_NET_TEST, the frames are exchanged as is.
+ */
+static int ws_cb(int sock, const struct http_server_request *req,
+		 const uint8_t *data, size_t len, void *user_data)
+{
+	ws_blocking = !(fcntl(sock, F_GETFL, 0) & O_NONBLOCK);
+	ws_data_len = MIN(len, sizeof(ws_data));
+	memcpy(ws_data, data, ws_data_len);
+
+	(void)send(sock, WS_SERVER_FRAME, sizeof(WS_SERVER_FRAME) - 1, 0);
+	(void)close(sock);
+
+	k_sem_give(&ws_done);
+
+	return 0;
+}
+#endif /* CONFIG_HTTP_SERVER_WEBSOCKET */
+
+static const struct http_resource resources[] = {
+	{
+		.path = "/",
+		.type = HTTP_RESOURCE_TYPE_STATIC,
+		.static_data = {
+			.data = index_html,
+			.len = sizeof(index_html) - 1,
+			.content_type = "text/html",
+		},
+	},
+	{
+		.path = "/index.html",
+		.type = HTTP_RESOURCE_TYPE_STATIC,
+		.static_data = {
+			.data = index_html_gz,
+			.len = sizeof(index_html_gz),
+			.content_type = "text/html",
+			.content_encoding = "gzip",
+		},
+	},
+	{
+		.path = "/large",
+		.type = HTTP_RESOURCE_TYPE_STATIC,
+		.static_data = {
+			.data = large_body,
+			.len = sizeof(large_body),
+		},
+	},
+	{
+		.path = "/echo",
+		.type = HTTP_RESOURCE_TYPE_DYNAMIC,
+		.dynamic_cb = echo_cb,
+	},
+#if defined(CONFIG_HTTP_SERVER_WEBSOCKET)
+	{
+		.path = "/ws",
+		.type = HTTP_RESOURCE_TYPE_WEBSOCKET,
+		.websocket_cb = ws_cb,
+	},
+#endif
+};
+
+static const struct http_server_config config = {
+	.port = SERVER_PORT,
+	.resources = resources,
+	.num_resources = ARRAY_SIZE(resources),
+};
+
+static int connect_server(void)
+{
+	struct sockaddr_in addr;
+	int sock;
+	int ret;
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(sock >= 0, "socket open failed");
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(SERVER_PORT);
+	ret = inet_pton(AF_INET, SERVER_ADDR, &addr.sin_addr);
+	zassert_equal(ret, 1, "inet_pton failed");
+
+	ret = connect(sock, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(ret, 0, "connect failed (%d)", errno);
+
+	return sock;
+}
+
+static void send_str(int sock, const char *str)
+{
+	ssize_t ret;
+
+	ret = send(sock, str, strlen(str), 0);
+	zassert_equal(ret, strlen(str), "send failed (%d)", errno);
+}
+
+static void expect_response(int sock, const char *expected)
+{
+	static char buf[256];
+	size_t len = strlen(expected);
+	size_t received = 0;
+	ssize_t ret;
+
+	zassert_true(len < sizeof(buf), "expected response too long");
+
+	while (received < len) {
+		ret = recv(sock, buf + received, len - received, 0);
+		zassert_true(ret > 0, "recv failed (%d)", errno);
+		received += ret;
+	}
+
+	buf[received] = '\0';
+	zassert_mem_equal(buf, expected, len, "unexpected response %s", buf);
+}
+
+static void test_static_resource(void)
+{
+	int sock = connect_server();
+
+	send_str(sock, "GET / HTTP/1.1\r\nHost: " SERVER_ADDR "\r\n\r\n");
+	expect_response(sock, INDEX_RESPONSE);
+
+	/* The connection is kept open */
+	send_str(sock, "GET /?lang=en HTTP/1.1\r\n\r\n");
+	expect_response(sock, INDEX_RESPONSE);
+
+	(void)close(sock);
+}
+
+static void test_content_encoding(void)
+{
+	int sock = connect_server();
+
+	send_str(sock, "GET /index.html HTTP/1.1\r\n"
+		       "Accept-Encoding: deflate, gzip\r\n\r\n");
+	expect_response(sock, "HTTP/1.1 200 OK\r\n"
+			      "Content-Length: 8\r\n"
+			      "Content-Type: text/html\r\n"
+			      "Content-Encoding: gzip\r\n"
+			      "\r\n");
+	expect_response(sock, "\x1f\x8b\x08");
+
+	(void)close(sock);
+
+	sock = connect_server();
+
+	send_str(sock, "GET /index.html HTTP/1.1\r\n\r\n");
+	expect_response(sock, "HTTP/1.1 406 Not Acceptable\r\n"
+			      "Content-Length: 0\r\n\r\n");
+
+	(void)close(sock);
+}
+
+static void test_pipelined_requests(void)
+{
+	int sock = connect_server();
+
+	send_str(sock, "HEAD / HTTP/1.1\r\n\r\n"
+		       "GET /missing HTTP/1.1\r\n\r\n"
+		       "DELETE / HTTP/1.1\r\n\r\n");
+	expect_response(sock, "HTTP/1.1 200 OK\r\n"
+			      "Content-Length: 15\r\n"
+			      "Content-Type: text/html\r\n\r\n"
+			      "HTTP/1.1 404 Not Found\r\n"
+			      "Content-Length: 0\r\n\r\n"
+			      "HTTP/1.1 405 Method Not Allowed\r\n"
+			      "Content-Length: 0\r\n\r\n");
+
+	(void)close(sock);
+}
+
+static void expect_large_body(int sock)
+{
+	static uint8_t buf[64];
+	size_t received = 0;
+	ssize_t ret;
+
+	while (received < sizeof(large_body)) {
+		ret = recv(sock, buf,
+			   MIN(sizeof(buf), sizeof(large_body) - received), 0);
+		zassert_true(ret > 0, "recv failed (%d)", errno);
+		zassert_mem_equal(buf, large_body + received, ret,
+				  "unexpected body at %zu", received);
+		received += ret;
+	}
+}
+
+static void test_large_resource(void)
+{
+	int slow = connect_server();
+	int sock;
+	size_t i;
+
+	for (i = 0; i < sizeof(large_body); i++) {
+		large_body[i] = i;
+	}
+
+	/* The request following the large one is answered once the large
+	 * response is sent.
+	 */
+	send_str(slow, "GET /large HTTP/1.1\r\n\r\n"
+		       "GET / HTTP/1.1\r\n\r\n");
+
+	/* Other clients are served while the first one does not read */
+	sock = connect_server();
+
+	send_str(sock, "GET / HTTP/1.1\r\n\r\n");
+	expect_response(sock, INDEX_RESPONSE);
+
+	(void)close(sock);
+
+	expect_response(slow, LARGE_RESPONSE);
+	expect_large_body(slow);
+	expect_response(slow, INDEX_RESPONSE);
+
+	(void)close(slow);
+}
+
+static void test_dynamic_resource(void)
+{
+	int sock = connect_server();
+
+	send_str(sock, "POST /echo HTTP/1.1\r\nContent-Length: 11\r\n\r\n"
+		       "hello");
+	send_str(sock, " world");
+	expect_response(sock, "HTTP/1.1 200 OK\r\n"
+			      "Content-Length: 11\r\n"
+			      "Content-Type: text/plain\r\n"
+			      "\r\n"
+			      "hello world");
+
+	(void)close(sock);
+}
+
+static void test_connection_close(void)
+{
+	int sock = connect_server();
+	char c;
+
+	send_str(sock, "GET / HTTP/1.0\r\n\r\n");
+	expect_response(sock, "HTTP/1.1 200 OK\r\n"
+			      "Content-Length: 15\r\n"
+			      "Content-Type: text/html\r\n"
+			      "Connection: close\r\n"
+			      "\r\n"
+			      "<html>hi</html>");
+
+	zassert_equal(recv(sock, &c, 1, 0), 0, "connection not closed");
+
+	(void)close(sock);
+}
+
+static void test_bad_request(void)
+{
+	int sock = connect_server();
+	char c;
+
+	send_str(sock, "NOT HTTP\r\n\r\n");
+	expect_response(sock, "HTTP/1.1 400 Bad Request\r\n"
+			      "Content-Length: 0\r\n"
+			      "Connection: close\r\n\r\n");
+
+	zassert_equal(recv(sock, &c, 1, 0), 0, "connection not closed");
+
+	(void)close(sock);
+}
+
+#if defined(CONFIG_HTTP_SERVER_WEBSOCKET)
+static void test_websocket_upgrade(void)
+{
+	uint8_t buf[sizeof(WS_REQUEST) - 1 + sizeof(ws_client_frame)];
+	int sock = connect_server();
+	ssize_t ret;
+	char c;
+
+	/* The first frame follows the request in the same segment */
+	memcpy(buf, WS_REQUEST, sizeof(WS_REQUEST) - 1);
+	memcpy(buf + sizeof(WS_REQUEST) - 1, ws_client_frame,
+	       sizeof(ws_client_frame));
+
+	ret = send(sock, buf, sizeof(buf), 0);
+	zassert_equal(ret, sizeof(buf), "send failed (%d)", errno);
+
+	expect_response(sock, WS_RESPONSE);
+	expect_response(sock, WS_SERVER_FRAME);
+
+	zassert_equal(k_sem_take(&ws_done, K_SECONDS(1)), 0,
+		      "Websocket callback not called");
+	zassert_true(ws_blocking, "Websocket handed over in non-blocking mode");
+	zassert_equal(ws_data_len, sizeof(ws_client_frame),
+		      "Invalid leftover length %zu", ws_data_len);
+	zassert_mem_equal(ws_data, ws_client_frame, sizeof(ws_client_frame),
+			  "Invalid leftover data");
+
+	zassert_equal(recv(sock, &c, 1, 0), 0, "connection not closed");
+
+	(void)close(sock);
+}
+
+static void test_websocket_bad_upgrade(void)
+{
+	int sock = connect_server();
+	char c;
+
+	send_str(sock, "GET /ws HTTP/1.1\r\n"
+		       "Upgrade: websocket\r\n"
+		       "Connection: Upgrade\r\n"
+		       "Sec-WebSocket-Key: short\r\n\r\n");
+	expect_response(sock, "HTTP/1.1 400 Bad Request\r\n"
+			      "Content-Length: 0\r\n"
+			      "Connection: close\r\n\r\n");
+
+	zassert_equal(recv(sock, &c, 1, 0), 0, "connection not closed");
+
+	(void)close(sock);
+
+	sock = connect_server();
+
+	/* Not an upgrade request */
+	send_str(sock, "GET /ws HTTP/1.1\r\n\r\n");
+	expect_response(sock, "HTTP/1.1 400 Bad Request\r\n"
+			      "Content-Length: 0\r\n"
+			      "Connection: close\r\n\r\n");
+
+	(void)close(sock);
+
+	zassert_equal(k_sem_take(&ws_done, K_NO_WAIT), -EBUSY,
+		      "Websocket callback called");
+}
+#else
+static void test_websocket_upgrade(void)
+{
+	ztest_test_skip();
+}
+
+static void test_websocket_bad_upgrade(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_HTTP_SERVER_WEBSOCKET */
+
+static void test_server_start(void)
+{
+	zassert_equal(http_server_start(&config), 0, "cannot start server");
+	zassert_equal(http_server_start(&config), -EALREADY,
+		      "server started twice");
+}
+
+static void test_server_stop(void)
+{
+	zassert_equal(http_server_stop(), 0, "cannot stop server");
+	zassert_equal(http_server_stop(), -EALREADY, "server stopped twice");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(http_server,
+			 ztest_unit_test(test_server_start),
+			 ztest_unit_test(test_static_resource),
+			 ztest_unit_test(test_content_encoding),
+			 ztest_unit_test(test_pipelined_requests),
+			 ztest_unit_test(test_large_resource),
+			 ztest_unit_test(test_dynamic_resource),
+			 ztest_unit_test(test_connection_close),
+			 ztest_unit_test(test_bad_request),
+			 ztest_unit_test(test_websocket_upgrade),
+			 ztest_unit_test(test_websocket_bad_upgrade),
+			 ztest_unit_test(test_server_stop));
+
+	ztest_run_test_suite(http_server);
+}
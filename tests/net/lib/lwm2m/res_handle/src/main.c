@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_LWM2M_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <errno.h>
+
+#include <net/lwm2m.h>
+
+#include <ztest.h>
+
+#include "lwm2m_object.h"
+#include "lwm2m_engine.h"
+
+#define BATTERY_LEVEL_PATH "3/0/9"
+#define ERROR_CODE_PATH "3/0/11"
+
+static uint8_t battery_level;
+
+static void test_handle_invalid_path(void)
+{
+	struct lwm2m_res_handle handle;
+
+	zassert_equal(lwm2m_engine_res_handle_get("3/0", &handle), -EINVAL,
+		      "object instance path accepted");
+	zassert_equal(lwm2m_engine_res_handle_get("3/0/999", &handle),
+		      -ENOENT, "unknown resource resolved");
+	zassert_equal(lwm2m_engine_res_handle_get("3/1/9", &handle),
+		      -ENOENT, "unknown object instance resolved");
+}
+
+static void test_handle_set_get(void)
+{
+	struct lwm2m_res_handle handle;
+	uint8_t value;
+	int ret;
+
+	ret = lwm2m_engine_set_res_data(BATTERY_LEVEL_PATH, &battery_level,
+					sizeof(battery_level), 0);
+	zassert_equal(ret, 0, "cannot set resource data (%d)", ret);
+
+	ret = lwm2m_engine_res_handle_get(BATTERY_LEVEL_PATH, &handle);
+	zassert_equal(ret, 0, "cannot resolve handle (%d)", ret);
+
+	/* Values set through the handle are seen through the path */
+	value = 42;
+	ret = lwm2m_engine_set_by_handle(&handle, &value, sizeof(value));
+	zassert_equal(ret, 0, "cannot set by handle (%d)", ret);
+	zassert_equal(battery_level, 42, "value not set");
+
+	ret = lwm2m_engine_get_u8(BATTERY_LEVEL_PATH, &value);
+	zassert_equal(ret, 0, "cannot get by path (%d)", ret);
+	zassert_equal(value, 42, "invalid value %u", value);
+
+	/* And the other way round */
+	ret = lwm2m_engine_set_u8(BATTERY_LEVEL_PATH, 17);
+	zassert_equal(ret, 0, "cannot set by path (%d)", ret);
+
+	value = 0;
+	ret = lwm2m_engine_get_by_handle(&handle, &value, sizeof(value));
+	zassert_equal(ret, 0, "cannot get by handle (%d)", ret);
+	zassert_equal(value, 17, "invalid value %u", value);
+
+	/* Nobody observes the resource */
+	ret = lwm2m_engine_notify_by_handle(&handle);
+	zassert_equal(ret, 0, "invalid number of observers (%d)", ret);
+}
+
+static void test_handle_res_inst(void)
+{
+	struct lwm2m_res_handle handle;
+	struct lwm2m_res_handle first;
+	uint32_t generation;
+	uint8_t value;
+	int ret;
+
+	/* No error codes yet */
+	ret = lwm2m_engine_res_handle_get(ERROR_CODE_PATH "/0", &first);
+	zassert_equal(ret, -ENOENT, "missing instance resolved (%d)", ret);
+
+	ret = lwm2m_device_add_err(LWM2M_DEVICE_ERROR_LOW_POWER);
+	zassert_equal(ret, 0, "cannot add error code (%d)", ret);
+
+	ret = lwm2m_engine_res_handle_get(ERROR_CODE_PATH "/0", &first);
+	zassert_equal(ret, 0, "cannot resolve handle (%d)", ret);
+
+	ret = lwm2m_engine_get_by_handle(&first, &value, sizeof(value));
+	zassert_equal(ret, 0, "cannot get by handle (%d)", ret);
+	zassert_equal(value, LWM2M_DEVICE_ERROR_LOW_POWER,
+		      "invalid error code %u", value);
+
+	/* Adding an error code creates a resource instance, so the handles
+	 * are resolved again on their next use.
+	 */
+	generation = first.generation;
+
+	ret = lwm2m_device_add_err(LWM2M_DEVICE_ERROR_GPS_FAILURE);
+	zassert_equal(ret, 0, "cannot add error code (%d)", ret);
+
+	ret = lwm2m_engine_res_handle_get(ERROR_CODE_PATH "/1", &handle);
+	zassert_equal(ret, 0, "cannot resolve handle (%d)", ret);
+	zassert_not_equal(handle.generation, generation,
+			  "instance created without a new generation");
+
+	ret = lwm2m_engine_get_by_handle(&first, &value, sizeof(value));
+	zassert_equal(ret, 0, "cannot get by handle (%d)", ret);
+	zassert_equal(first.generation, handle.generation,
+		      "handle not resolved again");
+
+	/* A handle to a deleted instance is not used any more */
+	ret = lwm2m_engine_delete_res_inst(ERROR_CODE_PATH "/1");
+	zassert_equal(ret, 0, "cannot delete instance (%d)", ret);
+
+	ret = lwm2m_engine_get_by_handle(&handle, &value, sizeof(value));
+	zassert_equal(ret, -ENOENT, "deleted instance used (%d)", ret);
+
+	ret = lwm2m_engine_get_by_handle(&first, &value, sizeof(value));
+	zassert_equal(ret, 0, "cannot get by handle (%d)", ret);
+	zassert_equal(value, LWM2M_DEVICE_ERROR_LOW_POWER,
+		      "invalid error code %u", value);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(lwm2m_res_handle,
+			 ztest_unit_test(test_handle_invalid_path),
+			 ztest_unit_test(test_handle_set_get),
+			 ztest_unit_test(test_handle_res_inst));
+
+	ztest_run_test_suite(lwm2m_res_handle);
+}
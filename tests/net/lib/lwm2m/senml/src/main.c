@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2021, Commonwealth Scientific and Industrial Research
+ * Organisation (CSIRO) ABN 41 687 119 230.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_LWM2M_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <string.h>
+#include <errno.h>
+
+#include <net/coap.h>
+#include <net/lwm2m.h>
+
+#include <ztest.h>
+
+#include "lwm2m_object.h"
+#include "lwm2m_engine.h"
+#include "lwm2m_rw_senml_json.h"
+#include "lwm2m_rw_senml_cbor.h"
+#include "lwm2m_util.h"
+
+#define UTC_OFFSET_PATH "3/0/14"
+#define TIMEZONE_PATH "3/0/15"
+#define BATTERY_LEVEL_PATH "3/0/9"
+
+/* Characters that have to be escaped in SenML JSON strings */
+#define TIMEZONE "Test/\"Zone\"\\\t"
+#define UTC_OFFSET "+02:00"
+
+static struct lwm2m_ctx test_ctx;
+static struct lwm2m_message test_msg;
+static struct coap_packet test_cpkt;
+static uint8_t test_buf[512];
+
+static char utc_offset[16];
+static char timezone[32];
+static uint8_t battery_level;
+
+static struct lwm2m_obj_path test_paths[3];
+
+static void message_init(const struct lwm2m_writer *writer,
+			 const struct lwm2m_reader *reader)
+{
+	int ret;
+
+	(void)memset(&test_msg, 0, sizeof(test_msg));
+
+	ret = coap_packet_init(&test_cpkt, test_buf, sizeof(test_buf),
+			       COAP_VERSION_1, COAP_TYPE_ACK, 0, NULL,
+			       COAP_RESPONSE_CODE_CONTENT, 1);
+	zassert_equal(ret, 0, "cannot init packet (%d)", ret);
+
+	test_msg.ctx = &test_ctx;
+	test_msg.out.writer = writer;
+	test_msg.out.out_cpkt = &test_cpkt;
+	test_msg.in.reader = reader;
+	test_msg.in.in_cpkt = &test_cpkt;
+}
+
+/* Place a payload in the packet to be parsed by the reader */
+static void message_set_payload(const uint8_t *payload, size_t len)
+{
+	int ret;
+
+	if (len > 0) {
+		ret = coap_packet_append_payload_marker(&test_cpkt);
+		zassert_equal(ret, 0, "cannot add payload marker (%d)", ret);
+
+		ret = coap_packet_append_payload(&test_cpkt, payload, len);
+		zassert_equal(ret, 0, "cannot add payload (%d)", ret);
+	}
+
+	test_msg.in.offset = test_cpkt.offset - len;
+}
+
+/* Continue with the payload written to the packet */
+static void message_rewind(void)
+{
+	const uint8_t *payload;
+	uint16_t len;
+
+	payload = coap_packet_get_payload(&test_cpkt, &len);
+	zassert_not_null(payload, "no payload written");
+
+	test_msg.in.offset = payload - test_cpkt.data;
+}
+
+static void set_values(const char *tz, const char *offset, uint8_t level)
+{
+	zassert_equal(lwm2m_engine_set_string(TIMEZONE_PATH, (char *)tz), 0,
+		      "cannot set timezone");
+	zassert_equal(lwm2m_engine_set_string(UTC_OFFSET_PATH,
+					      (char *)offset), 0,
+		      "cannot set UTC offset");
+	zassert_equal(lwm2m_engine_set_u8(BATTERY_LEVEL_PATH, level), 0,
+		      "cannot set battery level");
+}
+
+static void check_values(const char *tz, const char *offset, uint8_t level)
+{
+	zassert_true(strcmp(timezone, tz) == 0, "invalid timezone '%s'",
+		     timezone);
+	zassert_true(strcmp(utc_offset, offset) == 0,
+		     "invalid UTC offset '%s'", utc_offset);
+	zassert_equal(battery_level, level, "invalid battery level %u",
+		      battery_level);
+}
+
+static void test_setup(void)
+{
+	int ret;
+
+	ret = lwm2m_engine_set_res_data(UTC_OFFSET_PATH, utc_offset,
+					sizeof(utc_offset), 0);
+	zassert_equal(ret, 0, "cannot set UTC offset buffer (%d)", ret);
+
+	ret = lwm2m_engine_set_res_data(TIMEZONE_PATH, timezone,
+					sizeof(timezone), 0);
+	zassert_equal(ret, 0, "cannot set timezone buffer (%d)", ret);
+
+	ret = lwm2m_engine_set_res_data(BATTERY_LEVEL_PATH, &battery_level,
+					sizeof(battery_level), 0);
+	zassert_equal(ret, 0, "cannot set battery level buffer (%d)", ret);
+
+	zassert_equal(lwm2m_name_to_path(TIMEZONE_PATH,
+					 strlen(TIMEZONE_PATH),
+					 &test_paths[0]), 0, "invalid path");
+	zassert_equal(lwm2m_name_to_path(UTC_OFFSET_PATH,
+					 strlen(UTC_OFFSET_PATH),
+					 &test_paths[1]), 0, "invalid path");
+	zassert_equal(lwm2m_name_to_path(BATTERY_LEVEL_PATH,
+					 strlen(BATTERY_LEVEL_PATH),
+					 &test_paths[2]), 0, "invalid path");
+}
+
+/* Read the resources, clear them and write back what was read. The
+ * battery level is read-only so a composite write leaves it as it is.
+ */
+static void round_trip(int format, const struct lwm2m_writer *writer,
+		       const struct lwm2m_reader *reader)
+{
+	struct lwm2m_obj_path paths[ARRAY_SIZE(test_paths)];
+	int ret;
+
+	set_values(TIMEZONE, UTC_OFFSET, 42);
+
+	message_init(writer, reader);
+
+	if (format == LWM2M_FORMAT_APP_SENML_JSON) {
+		ret = do_composite_read_op_senml_json(&test_msg, format,
+						      test_paths,
+						      ARRAY_SIZE(test_paths));
+	} else {
+		ret = do_composite_read_op_senml_cbor(&test_msg, format,
+						      test_paths,
+						      ARRAY_SIZE(test_paths));
+	}
+
+	zassert_equal(ret, 0, "composite read failed (%d)", ret);
+
+	/* The names of the records decode to the requested paths */
+	message_rewind();
+
+	if (format == LWM2M_FORMAT_APP_SENML_JSON) {
+		ret = senml_json_get_path_list(&test_msg, paths,
+					       ARRAY_SIZE(paths));
+	} else {
+		ret = senml_cbor_get_path_list(&test_msg, paths,
+					       ARRAY_SIZE(paths));
+	}
+
+	zassert_equal(ret, ARRAY_SIZE(test_paths), "invalid path count %d",
+		      ret);
+	zassert_mem_equal(paths, test_paths, sizeof(paths),
+			  "paths do not match");
+
+	set_values("", "", 7);
+
+	message_rewind();
+	test_msg.path.level = 0U;
+
+	if (format == LWM2M_FORMAT_APP_SENML_JSON) {
+		ret = do_write_op_senml_json(&test_msg);
+	} else {
+		ret = do_write_op_senml_cbor(&test_msg);
+	}
+
+	zassert_equal(ret, 0, "write failed (%d)", ret);
+
+	check_values(TIMEZONE, UTC_OFFSET, 7);
+}
+
+static void test_senml_json_round_trip(void)
+{
+	round_trip(LWM2M_FORMAT_APP_SENML_JSON, &senml_json_writer,
+		   &senml_json_reader);
+}
+
+static void test_senml_cbor_round_trip(void)
+{
+	round_trip(LWM2M_FORMAT_APP_SENML_CBOR, &senml_cbor_writer,
+		   &senml_cbor_reader);
+}
+
+static void test_senml_json_single_write(void)
+{
+	static const char payload[] =
+		"[{\"bn\":\"/3/0/\",\"n\":\"14\",\"vs\":\"-05:00\"},"
+		" {\"n\":\"15\",\"vs\":\"America\\/New_York\"}]";
+	int ret;
+
+	set_values("", "", 0);
+
+	message_init(&senml_json_writer, &senml_json_reader);
+	message_set_payload(payload, strlen(payload));
+	test_msg.path.level = 0U;
+
+	ret = do_write_op_senml_json(&test_msg);
+	zassert_equal(ret, 0, "write failed (%d)", ret);
+
+	check_values("America/New_York", "-05:00", 0);
+}
+
+static int json_parse(const char *payload)
+{
+	struct lwm2m_obj_path paths[ARRAY_SIZE(test_paths)];
+
+	message_init(&senml_json_writer, &senml_json_reader);
+	message_set_payload(payload, strlen(payload));
+
+	return senml_json_get_path_list(&test_msg, paths, ARRAY_SIZE(paths));
+}
+
+static void test_senml_json_malformed(void)
+{
+	static const char * const malformed[] = {
+		/* empty payload */
+		"",
+		/* not an array */
+		"{\"n\":\"/3/0/14\",\"vs\":\"a\"}",
+		/* unterminated array */
+		"[{\"n\":\"/3/0/14\",\"vs\":\"a\"}",
+		/* unterminated record */
+		"[{\"n\":\"/3/0/14\",\"vs\":\"a\"]",
+		/* unterminated string */
+		"[{\"n\":\"/3/0/14\",\"vs\":\"a}]",
+		/* invalid name */
+		"[{\"n\":\"/3/x/14\",\"vs\":\"a\"}]",
+		/* base name too long */
+		"[{\"bn\":\"/3/0/0000000000000000000000000000000000000000/\","
+		"\"n\":\"14\",\"vs\":\"a\"}]",
+	};
+	int i, ret;
+
+	for (i = 0; i < ARRAY_SIZE(malformed); i++) {
+		ret = json_parse(malformed[i]);
+		zassert_equal(ret, -EBADMSG, "payload %d accepted (%d)", i,
+			      ret);
+	}
+
+	/* more paths than the caller has room for */
+	ret = json_parse("[{\"n\":\"/3/0/1\"},{\"n\":\"/3/0/2\"},"
+			 "{\"n\":\"/3/0/3\"},{\"n\":\"/3/0/4\"}]");
+	zassert_equal(ret, -ENOMEM, "path list overflow (%d)", ret);
+}
+
+static int cbor_parse(const uint8_t *payload, size_t len)
+{
+	struct lwm2m_obj_path paths[ARRAY_SIZE(test_paths)];
+
+	message_init(&senml_cbor_writer, &senml_cbor_reader);
+	message_set_payload(payload, len);
+
+	return senml_cbor_get_path_list(&test_msg, paths, ARRAY_SIZE(paths));
+}
+
+static void test_senml_cbor_malformed(void)
+{
+	/* array of one record, which is missing */
+	static const uint8_t truncated_array[] = { 0x81 };
+	/* indefinite array without break */
+	static const uint8_t no_break[] = {
+		0x9f, 0xa1, 0x00, 0x67, '/', '3', '/', '0', '/', '1', '4',
+	};
+	/* map instead of an array */
+	static const uint8_t not_array[] = {
+		0xa1, 0x00, 0x67, '/', '3', '/', '0', '/', '1', '4',
+	};
+	/* record is not a map */
+	static const uint8_t not_map[] = { 0x81, 0x01 };
+	/* text string longer than the payload */
+	static const uint8_t truncated_string[] = {
+		0x81, 0xa2, 0x00, 0x67, '/', '3', '/', '0', '/', '1', '4',
+		0x03, 0x65, 'a',
+	};
+	/* name is not a text string */
+	static const uint8_t name_not_text[] = { 0x81, 0xa1, 0x00, 0x0e };
+	/* invalid name */
+	static const uint8_t invalid_name[] = {
+		0x81, 0xa1, 0x00, 0x67, '/', '3', '/', 'x', '/', '1', '4',
+	};
+	static const struct {
+		const uint8_t *data;
+		size_t len;
+	} malformed[] = {
+		{ truncated_array, sizeof(truncated_array) },
+		{ no_break, sizeof(no_break) },
+		{ not_array, sizeof(not_array) },
+		{ not_map, sizeof(not_map) },
+		{ truncated_string, sizeof(truncated_string) },
+		{ name_not_text, sizeof(name_not_text) },
+		{ invalid_name, sizeof(invalid_name) },
+	};
+	int i, ret;
+
+	ret = cbor_parse(NULL, 0);
+	zassert_equal(ret, -EBADMSG, "empty payload accepted (%d)", ret);
+
+	for (i = 0; i < ARRAY_SIZE(malformed); i++) {
+		ret = cbor_parse(malformed[i].data, malformed[i].len);
+		zassert_equal(ret, -EBADMSG, "payload %d accepted (%d)", i,
+			      ret);
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(lwm2m_senml,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_senml_json_round_trip),
+			 ztest_unit_test(test_senml_cbor_round_trip),
+			 ztest_unit_test(test_senml_json_single_write),
+			 ztest_unit_test(test_senml_json_malformed),
+			 ztest_unit_test(test_senml_cbor_malformed));
+
+	ztest_run_test_suite(lwm2m_senml);
+}
@@ -1158,9 +1158,300 @@ void test_mqtt_packet(void)
 	mqtt_abort(&client);
 }
 
+#if defined(CONFIG_MQTT_PUBLISH_QUEUE)
+static void test_mqtt_publish_queue(void)
+{
+	struct mqtt_publish_param param = msg_publish1;
+	struct iovec iov[2 * CONFIG_MQTT_PUBLISH_BATCH_SIZE];
+	struct mqtt_publish_queue *queue;
+	struct mqtt_queue_entry *entry;
+	uint8_t *header;
+	int ids[3];
+	int packets;
+	int i, rc;
+
+	mqtt_client_init(&client);
+	client.tx_buf = tx_buffer;
+	client.tx_buf_size = sizeof(tx_buffer);
+
+	/* Three QoS 1 messages followed by a QoS 0 one */
+	param.message.topic.qos = MQTT_QOS_1_AT_LEAST_ONCE;
+	for (i = 0; i < ARRAY_SIZE(ids); i++) {
+		ids[i] = mqtt_queue_add(&client, &param);
+		zassert_true(ids[i] > 0, "Cannot queue message %d", i);
+	}
+
+	zassert_not_equal(ids[0], ids[1], "Message ids shall differ");
+	zassert_true(ids[0] >= MQTT_PUBLISH_QUEUE_ID_MIN,
+		     "Message id not in the reserved range");
+
+	/* The application cannot use the ids of the queue */
+	param.message_id = ids[0];
+	rc = mqtt_publish(&client, &param);
+	zassert_equal(rc, -EINVAL, "Reserved message id accepted");
+
+	param.message.topic.qos = MQTT_QOS_0_AT_MOST_ONCE;
+	rc = mqtt_queue_add(&client, &param);
+	zassert_equal(rc, 0, "QoS 0 message shall have no id");
+
+	/* Only the in-flight window is sent, the rest keeps its order */
+	rc = mqtt_queue_prepare(&client, iov, ARRAY_SIZE(iov), &packets);
+	zassert_equal(packets, MIN(3, CONFIG_MQTT_PUBLISH_INFLIGHT_MAX),
+		      "Wrong number of packets in batch");
+	zassert_equal(rc, 2 * packets, "Wrong I/O vector length");
+
+	header = iov[0].iov_base;
+	zassert_equal(header[0], 0x32, "Wrong publish header");
+	zassert_equal_ptr(iov[1].iov_base, param.message.payload.data,
+			  "Payload shall not be copied");
+
+	/* A batch that was not written is sent again */
+	mqtt_queue_sent(&client, -EIO);
+	zassert_equal(client.internal.queue.inflight, 0,
+		      "Messages in flight before being written");
+
+	rc = mqtt_queue_prepare(&client, iov, ARRAY_SIZE(iov), &packets);
+	zassert_equal(packets, MIN(3, CONFIG_MQTT_PUBLISH_INFLIGHT_MAX),
+		      "Batch not sent again");
+	mqtt_queue_sent(&client, 0);
+
+	/* Nothing more can be sent until a message is acknowledged */
+	if (packets < 3) {
+		rc = mqtt_queue_prepare(&client, iov, ARRAY_SIZE(iov),
+					&packets);
+		zassert_equal(rc, 0, "Window shall be full");
+
+		mqtt_queue_ack(&client, MQTT_PKT_TYPE_PUBACK, ids[0], false);
+
+		rc = mqtt_queue_prepare(&client, iov, ARRAY_SIZE(iov),
+					&packets);
+		zassert_true(packets > 0, "Acknowledged message frees window");
+
+		/* The QoS 0 message is only released once written */
+		queue = &client.internal.queue;
+		entry = &queue->entries[(queue->head + queue->count - 1) %
+					CONFIG_MQTT_PUBLISH_QUEUE_SIZE];
+		zassert_equal(entry->state, MQTT_QUEUE_PENDING,
+			      "Message released before being written");
+
+		mqtt_queue_sent(&client, 0);
+		zassert_equal(entry->state, MQTT_QUEUE_FREE,
+			      "Message not released");
+	}
+
+	/* Unacknowledged messages are sent again as duplicates */
+	mqtt_queue_reconnect(&client, true);
+
+	rc = mqtt_queue_prepare(&client, iov, ARRAY_SIZE(iov), &packets);
+	zassert_true(packets > 0, "Messages not sent again");
+	mqtt_queue_sent(&client, 0);
+
+	header = iov[0].iov_base;
+	zassert_equal(header[0], 0x3a, "Duplicate flag not set");
+
+	for (i = 0; i < ARRAY_SIZE(ids); i++) {
+		mqtt_queue_ack(&client, MQTT_PKT_TYPE_PUBACK, ids[i], false);
+	}
+
+	rc = mqtt_queue_prepare(&client, iov, ARRAY_SIZE(iov), &packets);
+	mqtt_queue_sent(&client, 0);
+	zassert_equal(client.internal.queue.inflight, 0,
+		      "Messages still in flight");
+	zassert_equal(client.internal.queue.count, 0, "Queue not empty");
+}
+#else
+static void test_mqtt_publish_queue(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_MQTT_PUBLISH_QUEUE */
+
+#if defined(CONFIG_MQTT_VERSION_5_0)
+static void test_mqtt_v5(void)
+{
+	static ZTEST_DMEM uint8_t connect_v5[] = {
+		0x10, 0x13, 0x00, 0x04, 0x4d, 0x51, 0x54, 0x54, 0x05, 0x02,
+		0x00, 0x3c, 0x00, 0x00, 0x06, 0x7a, 0x65, 0x70, 0x68, 0x79,
+		0x72
+	};
+	/* Receive Maximum 2, Topic Alias Maximum 4, no shared
+	 * subscriptions and a user property.
+	 */
+	static ZTEST_DMEM uint8_t connack_v5[] = {
+		0x20, 0x12, 0x01, 0x00, 0x0f, 0x21, 0x00, 0x02, 0x22, 0x00,
+		0x04, 0x2a, 0x00, 0x26, 0x00, 0x01, 0x61, 0x00, 0x01, 0x62
+	};
+	/* Topic sent along with the new alias 1 */
+	static ZTEST_DMEM uint8_t publish_alias_new[] = {
+		0x33, 0x11, 0x00, 0x07, 0x73, 0x65, 0x6e, 0x73, 0x6f, 0x72,
+		0x73, 0x00, 0x01, 0x03, 0x23, 0x00, 0x01
+	};
+	/* Empty topic, alias 1 only */
+	static ZTEST_DMEM uint8_t publish_alias_used[] = {
+		0x33, 0x0a, 0x00, 0x00, 0x00, 0x02, 0x03, 0x23, 0x00, 0x01
+	};
+	/* QoS 0 message with a Payload Format Indicator property */
+	static ZTEST_DMEM uint8_t publish_props[] = {
+		0x30, 0x0e, 0x00, 0x07, 0x73, 0x65, 0x6e, 0x73, 0x6f, 0x72,
+		0x73, 0x02, 0x01, 0x01, 0x4f, 0x4b
+	};
+	static ZTEST_DMEM uint8_t subscribe_v5[] = {
+		0x82, 0x0d, 0x00, 0x01, 0x00, 0x00, 0x07, 0x73, 0x65, 0x6e,
+		0x73, 0x6f, 0x72, 0x73, 0x01
+	};
+	static ZTEST_DMEM uint8_t suback_v5[] = {
+		0x90, 0x05, 0x00, 0x01, 0x00, 0x01, 0x80
+	};
+	/* Message 2 refused with reason code Not authorized */
+	static ZTEST_DMEM uint8_t pubrec_v5[] = {
+		0x50, 0x03, 0x00, 0x02, 0x87
+	};
+	/* Message 3 accepted, the reason code is omitted */
+	static ZTEST_DMEM uint8_t pubrec_ok_v5[] = {
+		0x50, 0x02, 0x00, 0x03
+	};
+	struct mqtt_publish_param param = msg_publish3;
+	struct mqtt_connack_param connack;
+	struct mqtt_suback_param suback;
+	struct mqtt_pubrec_param pubrec;
+	uint8_t type_and_flags;
+	uint32_t length;
+	struct buf_ctx buf;
+	int rc;
+
+	mqtt_client_init(&client);
+	client.protocol_version = MQTT_VERSION_5_0;
+	client.clean_session = 1;
+	client.client_id = CLIENTID;
+	client.tx_buf = tx_buffer;
+	client.tx_buf_size = sizeof(tx_buffer);
+
+	buf.cur = client.tx_buf;
+	buf.end = client.tx_buf + client.tx_buf_size;
+	rc = connect_request_encode(&client, &buf);
+	zassert_equal(rc, 0, "connect_request_encode failed");
+	zassert_false(eval_buffers(&buf, connect_v5, sizeof(connect_v5)),
+		      "Wrong CONNECT");
+
+	buf.cur = connack_v5;
+	buf.end = connack_v5 + sizeof(connack_v5);
+	rc = fixed_header_decode(&buf, &type_and_flags, &length);
+	zassert_equal(rc, 0, "fixed_header_decode failed");
+	rc = connect_ack_decode(&client, &buf, &connack);
+	zassert_equal(rc, 0, "connect_ack_decode failed");
+	zassert_equal(connack.session_present_flag, 1, "Wrong session flag");
+	zassert_equal(connack.return_code, 0, "Wrong reason code");
+	zassert_equal(connack.receive_maximum, 2, "Wrong Receive Maximum");
+	zassert_equal(connack.topic_alias_maximum, 4,
+		      "Wrong Topic Alias Maximum");
+	zassert_equal(connack.maximum_qos, MQTT_QOS_2_EXACTLY_ONCE,
+		      "Wrong default Maximum QoS");
+	zassert_equal(connack.shared_subscription_available, 0,
+		      "Wrong Shared Subscription Available");
+
+	/* Limits applied once the connection is accepted */
+	client.internal.receive_maximum = connack.receive_maximum;
+	client.internal.topic_alias_maximum = connack.topic_alias_maximum;
+	client.internal.maximum_qos = connack.maximum_qos;
+
+	buf.cur = client.tx_buf;
+	buf.end = client.tx_buf + client.tx_buf_size;
+	rc = mqtt_publish_encode(&client, &param, &buf);
+	zassert_equal(rc, 0, "mqtt_publish_encode failed");
+	zassert_false(eval_buffers(&buf, publish_alias_new,
+				   sizeof(publish_alias_new)),
+		      "Alias not established");
+
+	/* The broker does not know an alias that was not written */
+	mqtt_publish_sent(&client, &param, -EIO);
+	zassert_equal(client.internal.inflight, 0,
+		      "Message not written is in flight");
+
+	buf.cur = client.tx_buf;
+	buf.end = client.tx_buf + client.tx_buf_size;
+	rc = mqtt_publish_encode(&client, &param, &buf);
+	zassert_equal(rc, 0, "mqtt_publish_encode failed");
+	zassert_false(eval_buffers(&buf, publish_alias_new,
+				   sizeof(publish_alias_new)),
+		      "Alias used before being written");
+	mqtt_publish_sent(&client, &param, 0);
+
+	param.message_id = 2U;
+	buf.cur = client.tx_buf;
+	buf.end = client.tx_buf + client.tx_buf_size;
+	rc = mqtt_publish_encode(&client, &param, &buf);
+	zassert_equal(rc, 0, "mqtt_publish_encode failed");
+	zassert_false(eval_buffers(&buf, publish_alias_used,
+				   sizeof(publish_alias_used)),
+		      "Alias not used");
+	mqtt_publish_sent(&client, &param, 0);
+
+	/* Receive Maximum reached until a message is acknowledged */
+	param.message_id = 3U;
+	buf.cur = client.tx_buf;
+	buf.end = client.tx_buf + client.tx_buf_size;
+	rc = mqtt_publish_encode(&client, &param, &buf);
+	zassert_equal(rc, -EBUSY, "Receive Maximum not respected");
+
+	buf.cur = pubrec_v5;
+	buf.end = pubrec_v5 + sizeof(pubrec_v5);
+	rc = fixed_header_decode(&buf, &type_and_flags, &length);
+	zassert_equal(rc, 0, "fixed_header_decode failed");
+	rc = publish_receive_decode_v5(&buf, &pubrec);
+	zassert_equal(rc, 0, "publish_receive_decode_v5 failed");
+	zassert_equal(pubrec.message_id, 2, "Wrong message id");
+	zassert_equal(pubrec.reason_code, 0x87, "Wrong reason code");
+	zassert_true(mqtt_pubrec_failed(&client, &pubrec),
+		     "Refused message not detected");
+
+	buf.cur = pubrec_ok_v5;
+	buf.end = pubrec_ok_v5 + sizeof(pubrec_ok_v5);
+	rc = fixed_header_decode(&buf, &type_and_flags, &length);
+	zassert_equal(rc, 0, "fixed_header_decode failed");
+	rc = publish_receive_decode_v5(&buf, &pubrec);
+	zassert_equal(rc, 0, "publish_receive_decode_v5 failed");
+	zassert_false(mqtt_pubrec_failed(&client, &pubrec),
+		      "Accepted message refused");
+
+	buf.cur = publish_props;
+	buf.end = publish_props + sizeof(publish_props);
+	rc = fixed_header_decode(&buf, &type_and_flags, &length);
+	zassert_equal(rc, 0, "fixed_header_decode failed");
+	rc = publish_decode_v5(type_and_flags, length, &buf, &param);
+	zassert_equal(rc, 0, "publish_decode_v5 failed");
+	zassert_equal(param.message.topic.topic.size, 7, "Wrong topic");
+	zassert_equal(param.message.payload.len, 2, "Wrong payload length");
+
+	buf.cur = client.tx_buf;
+	buf.end = client.tx_buf + client.tx_buf_size;
+	rc = subscribe_encode_v5(&msg_subscribe2, &buf);
+	zassert_equal(rc, 0, "subscribe_encode_v5 failed");
+	zassert_false(eval_buffers(&buf, subscribe_v5, sizeof(subscribe_v5)),
+		      "Wrong SUBSCRIBE");
+
+	buf.cur = suback_v5;
+	buf.end = suback_v5 + sizeof(suback_v5);
+	rc = fixed_header_decode(&buf, &type_and_flags, &length);
+	zassert_equal(rc, 0, "fixed_header_decode failed");
+	rc = subscribe_ack_decode_v5(&buf, &suback);
+	zassert_equal(rc, 0, "subscribe_ack_decode_v5 failed");
+	zassert_equal(suback.message_id, 1, "Wrong message id");
+	zassert_equal(suback.return_codes.len, 2, "Wrong reason codes");
+	zassert_equal(suback.return_codes.data[1], MQTT_SUBACK_FAILURE,
+		      "Wrong reason code");
+}
+#else
+static void test_mqtt_v5(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_MQTT_VERSION_5_0 */
+
 void test_main(void)
 {
 	ztest_test_suite(test_mqtt_packet_fn,
-		ztest_user_unit_test(test_mqtt_packet));
+		ztest_user_unit_test(test_mqtt_packet),
+		ztest_user_unit_test(test_mqtt_publish_queue),
+		ztest_user_unit_test(test_mqtt_v5));
 	ztest_run_test_suite(test_mqtt_packet_fn);
 }
@@ -974,6 +974,74 @@ static void test_net_pkt_get_contiguous_len(void)
 	net_pkt_unref(pkt);
 }
 
+#if defined(CONFIG_NET_PKT_QUOTA)
+static void iface_count_cb(struct net_if *iface, void *user_data)
+{
+	int *count = user_data;
+
+	(*count)++;
+}
+
+static void test_net_pkt_quota(void)
+{
+	struct net_pkt *pkts[CONFIG_NET_PKT_TX_COUNT];
+	int share = CONFIG_NET_PKT_QUOTA_IFACE;
+	struct net_pkt *pkt;
+	int count = 0;
+	int quota;
+	int i;
+
+	/* Without a configured share, the interfaces share the pool */
+	if (!share) {
+		net_if_foreach(iface_count_cb, &count);
+		share = 100 / count;
+	}
+
+	quota = CONFIG_NET_PKT_TX_COUNT * share / 100;
+
+	/* The interface can use the pool up to its quota */
+	for (i = 0; i < quota; i++) {
+		pkts[i] = net_pkt_alloc_with_buffer(eth_if, 100, AF_UNSPEC, 0,
+						    K_NO_WAIT);
+		zassert_not_null(pkts[i], "Pkt %d not allocated", i);
+	}
+
+	zassert_equal(atomic_get(&eth_if->tx_pkt_usage.pkts), quota,
+		      "Interface usage not accounted");
+	zassert_equal(atomic_get(&net_pkt_usage_get(false)->bufs), quota,
+		      "Pool usage not accounted");
+
+	if (quota < CONFIG_NET_PKT_TX_COUNT) {
+		pkt = net_pkt_alloc_with_buffer(eth_if, 100, AF_UNSPEC, 0,
+						K_NO_WAIT);
+		zassert_is_null(pkt, "Pkt allocated over quota");
+
+		/* Others can still use the pool */
+		pkt = net_pkt_alloc_with_buffer(NULL, 100, AF_UNSPEC, 0,
+						K_NO_WAIT);
+		zassert_not_null(pkt, "Pkt not allocated");
+
+		net_pkt_unref(pkt);
+	}
+
+	for (i = 0; i < quota; i++) {
+		net_pkt_unref(pkts[i]);
+	}
+
+	zassert_equal(atomic_get(&eth_if->tx_pkt_usage.pkts), 0,
+		      "Interface usage not released");
+	zassert_equal(atomic_get(&eth_if->tx_pkt_usage.bufs), 0,
+		      "Interface usage not released");
+	zassert_equal(atomic_get(&net_pkt_usage_get(false)->pkts), 0,
+		      "Pool usage not released");
+}
+#else
+static void test_net_pkt_quota(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_NET_PKT_QUOTA */
+
 void test_main(void)
 {
 	eth_if = net_if_get_default();
@@ -989,7 +1057,8 @@ void test_main(void)
 			 ztest_unit_test(test_net_pkt_clone),
 			 ztest_unit_test(test_net_pkt_headroom),
 			 ztest_unit_test(test_net_pkt_headroom_copy),
-			 ztest_unit_test(test_net_pkt_get_contiguous_len)
+			 ztest_unit_test(test_net_pkt_get_contiguous_len),
+			 ztest_unit_test(test_net_pkt_quota)
 		);
 
 	ztest_run_test_suite(net_pkt_tests);
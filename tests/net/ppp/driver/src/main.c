@@ -26,6 +26,7 @@ LOG_MODULE_REGISTER(net_test, NET_LOG_LEVEL);
 #include <net/buf.h>
 #include <net/net_ip.h>
 #include <net/net_if.h>
+#include <net/ppp.h>
 
 #define NET_LOG_ENABLED 1
 #include "net_private.h"
@@ -168,6 +169,14 @@ static uint8_t ppp_expect_data8[] = {
 	0x5b, 0x2c, 0x1d, 0x25,
 };
 
+/* Frame without Address and Control fields and with a one byte
+ * protocol, the wire format is built by the test.
+ */
+static uint8_t ppp_expect_data9[] = {
+	0x21, 0x45, 0x00, 0x00, 0x1c, 0x7e, 0x01, 0x00,
+	0x00, 0x40, 0x11, 0x7d, 0x13, 0xc0, 0x00, 0x02,
+};
+
 static uint8_t *receiving, *expecting;
 
 static enum net_verdict ppp_l2_recv(struct net_if *iface, struct net_pkt *pkt)
@@ -537,6 +546,76 @@ static void test_send_ppp_8(void)
 	}
 }
 
+static int hdlc_escape(const uint8_t *data, size_t len, uint8_t *out)
+{
+	int pos = 0;
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		if (data[i] == 0x7e || data[i] == 0x7d || data[i] < 0x20) {
+			out[pos++] = 0x7d;
+			out[pos++] = data[i] ^ 0x20;
+		} else {
+			out[pos++] = data[i];
+		}
+	}
+
+	return pos;
+}
+
+static int hdlc_encode(const uint8_t *data, size_t len, uint8_t *frame)
+{
+	uint16_t fcs = crc16_ccitt(0xffff, data, len) ^ 0xffff;
+	uint8_t fcs_bytes[] = { fcs & 0xff, fcs >> 8 };
+	int pos = 0;
+
+	frame[pos++] = 0x7e;
+	pos += hdlc_escape(data, len, &frame[pos]);
+	pos += hdlc_escape(fcs_bytes, sizeof(fcs_bytes), &frame[pos]);
+	frame[pos++] = 0x7e;
+
+	return pos;
+}
+
+static void test_recv_ppp_compressed(void)
+{
+	struct ppp_context *ctx = net_if_l2_data(iface);
+	uint8_t frame[2 * (sizeof(ppp_expect_data9) + 2) + 2];
+	int len;
+	bool ret;
+
+	/* As if the Address-and-Control-Field-Compression and
+	 * Protocol-Field-Compression options were acked by the peer.
+	 */
+	ctx->lcp.my_options.acfc = true;
+	ctx->lcp.my_options.pfc = true;
+
+	len = hdlc_encode(ppp_expect_data9, sizeof(ppp_expect_data9), frame);
+
+	k_sem_reset(&wait_data);
+
+	ret = send_iface(iface, frame, len, ppp_expect_data9,
+			 sizeof(ppp_expect_data9));
+
+	zassert_true(ret, "iface");
+
+	if (k_sem_take(&wait_data, WAIT_TIME_LONG)) {
+		zassert_true(false, "Timeout, packet not received");
+	}
+
+	zassert_false(test_failed, "Compressed frame not decoded");
+
+	/* Without ACFC the frame must start with the Address field */
+	ctx->lcp.my_options.acfc = false;
+	ctx->lcp.my_options.pfc = false;
+
+	(void)send_iface(iface, frame, len, ppp_expect_data9,
+			 sizeof(ppp_expect_data9));
+
+	zassert_not_equal(k_sem_take(&wait_data, K_MSEC(WAIT_TIME)), 0,
+			  "Compressed frame accepted");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(net_ppp_test,
@@ -551,7 +630,8 @@ void test_main(void)
 			 ztest_unit_test(test_send_ppp_5),
 			 ztest_unit_test(test_send_ppp_6),
 			 ztest_unit_test(test_send_ppp_7),
-			 ztest_unit_test(test_send_ppp_8)
+			 ztest_unit_test(test_send_ppp_8),
+			 ztest_unit_test(test_recv_ppp_compressed)
 		);
 
 	ztest_run_test_suite(net_ppp_test);
@@ -473,6 +473,37 @@ static void test_route_del_many(void)
 	}
 }
 
+static void test_route_lpm(void)
+{
+	struct in6_addr prefix = generic_addr;
+	struct net_route_entry *net, *host, *found;
+
+	net = net_route_add(my_iface, &prefix, 64, &peer_addr);
+	zassert_not_null(net, "Prefix route add failed");
+
+	host = net_route_add(my_iface, &dest_addresses[0], 128, &peer_addr);
+	zassert_not_null(host, "Host route add failed");
+
+	found = net_route_lookup(my_iface, &dest_addresses[0]);
+	zassert_equal_ptr(found, host, "Longest prefix not selected");
+
+	found = net_route_lookup(my_iface, &dest_addresses[1]);
+	zassert_equal_ptr(found, net, "Prefix route not selected");
+
+	found = net_route_lookup(peer_iface, &dest_addresses[0]);
+	zassert_is_null(found, "Route found for wrong interface");
+
+	zassert_false(net_route_del(host), "Host route del failed");
+
+	found = net_route_lookup(my_iface, &dest_addresses[0]);
+	zassert_equal_ptr(found, net, "Prefix route not selected after del");
+
+	zassert_false(net_route_del(net), "Prefix route del failed");
+
+	found = net_route_lookup(my_iface, &dest_addresses[0]);
+	zassert_is_null(found, "Route found after del");
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -492,6 +523,7 @@ void test_main(void)
 			ztest_unit_test(test_route_del_nexthop_again),
 			ztest_unit_test(test_populate_nbr_cache),
 			ztest_unit_test(test_route_add_many),
-			ztest_unit_test(test_route_del_many));
+			ztest_unit_test(test_route_del_many),
+			ztest_unit_test(test_route_lpm));
 	ztest_run_test_suite(test_route);
 }
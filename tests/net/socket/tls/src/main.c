@@ -20,6 +20,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #define SERVER_PORT 4242
 
 #define PSK_TAG 1
+#define PSK_TAG_OTHER 2
 
 #define MAX_CONNS 5
 
@@ -468,6 +469,215 @@ void test_v6_msg_trunc(void)
 		       (struct sockaddr *)&server_addr, sizeof(server_addr));
 }
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+/* Returns 1 if the client resumed the cached session, 0 otherwise. */
+static int session_cache_connect(int s_sock, struct sockaddr_in *s_saddr,
+				 sec_tag_t sec_tag)
+{
+	int optval = TLS_SESSION_CACHE_ENABLED;
+	socklen_t optlen = sizeof(optval);
+	struct sockaddr_in c_saddr;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	uint8_t rx_buf[sizeof(TEST_STR_SMALL) - 1];
+	int c_sock, new_sock, ret, resumed;
+	sec_tag_t sec_tag_list[] = {
+		sec_tag
+	};
+
+	prepare_sock_tls_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &c_sock, &c_saddr, IPPROTO_TLS_1_2);
+
+	ret = setsockopt(c_sock, SOL_TLS, TLS_SEC_TAG_LIST, sec_tag_list,
+			 sizeof(sec_tag_list));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	ret = setsockopt(c_sock, SOL_TLS, TLS_SESSION_CACHE, &optval,
+			 sizeof(optval));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	optval = TLS_SESSION_CACHE_DISABLED;
+	ret = getsockopt(c_sock, SOL_TLS, TLS_SESSION_CACHE, &optval, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(optval, TLS_SESSION_CACHE_ENABLED,
+		      "Session cache not enabled");
+
+	spawn_client_connect_thread(c_sock, (struct sockaddr *)s_saddr);
+
+	test_accept(s_sock, &new_sock, &addr, &addrlen);
+
+	k_thread_join(&client_connect_thread, K_FOREVER);
+
+	test_send(c_sock, TEST_STR_SMALL, sizeof(rx_buf), 0);
+
+	ret = recv(new_sock, rx_buf, sizeof(rx_buf), MSG_WAITALL);
+	zassert_equal(ret, sizeof(rx_buf), "Invalid length received");
+	zassert_mem_equal(rx_buf, TEST_STR_SMALL, sizeof(rx_buf),
+			  "Invalid data received");
+
+	optlen = sizeof(resumed);
+	ret = getsockopt(c_sock, SOL_TLS, TLS_SESSION_RESUMED, &resumed,
+			 &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+
+	test_close(new_sock);
+	test_close(c_sock);
+
+	return resumed;
+}
+
+void test_session_cache(void)
+{
+	struct sockaddr_in s_saddr;
+	int s_sock, c_sock, ret;
+	struct sockaddr_in c_saddr;
+
+	prepare_sock_tls_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &c_sock, &c_saddr, IPPROTO_TLS_1_2);
+	prepare_sock_tls_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &s_sock, &s_saddr, IPPROTO_TLS_1_2);
+
+	test_config_psk(s_sock, c_sock);
+
+	/* Same key under another tag, the server accepts both tags. */
+	(void)tls_credential_delete(PSK_TAG_OTHER, TLS_CREDENTIAL_PSK);
+	(void)tls_credential_delete(PSK_TAG_OTHER, TLS_CREDENTIAL_PSK_ID);
+
+	zassert_equal(tls_credential_add(PSK_TAG_OTHER, TLS_CREDENTIAL_PSK,
+					 psk, sizeof(psk)),
+		      0, "Failed to register PSK");
+	zassert_equal(tls_credential_add(PSK_TAG_OTHER, TLS_CREDENTIAL_PSK_ID,
+					 psk_id, strlen(psk_id)),
+		      0, "Failed to register PSK ID");
+
+	ret = setsockopt(c_sock, SOL_TLS, TLS_SESSION_CACHE_PURGE, NULL, 0);
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+	test_close(c_sock);
+
+	test_bind(s_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_listen(s_sock);
+
+	/* The first connection stores the session, the second one resumes
+	 * it with the session ticket issued by the server.
+	 */
+	zassert_equal(session_cache_connect(s_sock, &s_saddr, PSK_TAG), 0,
+		      "Session resumed with an empty cache");
+	zassert_equal(session_cache_connect(s_sock, &s_saddr, PSK_TAG), 1,
+		      "Cached session not resumed");
+
+	/* A session must not be used with other credentials, even if the
+	 * server would accept it.
+	 */
+	zassert_equal(session_cache_connect(s_sock, &s_saddr, PSK_TAG_OTHER),
+		      0, "Session resumed with other credentials");
+	zassert_equal(session_cache_connect(s_sock, &s_saddr, PSK_TAG_OTHER),
+		      1, "Cached session not resumed");
+
+	test_close(s_sock);
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+#else
+void test_session_cache(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_CACHE */
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+static void test_dtls_cid_status(int sock, int expected)
+{
+	socklen_t optlen = sizeof(int);
+	int status = -1;
+	int ret;
+
+	ret = getsockopt(sock, SOL_TLS, TLS_DTLS_CID_STATUS, &status, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(status, expected, "Invalid Connection ID status");
+}
+
+static void dtls_cid_exchange(int c_cid, int s_cid, int expected)
+{
+	int client_sock, server_sock, rv;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	uint8_t rx_buf[sizeof(TEST_STR_SMALL) - 1];
+	int role = TLS_DTLS_ROLE_SERVER;
+	struct test_msg_trunc_data test_data = {
+		.data = TEST_STR_SMALL,
+		.datalen = sizeof(TEST_STR_SMALL) - 1
+	};
+
+	prepare_sock_dtls_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			     &client_sock, &client_addr, IPPROTO_DTLS_1_2);
+	prepare_sock_dtls_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			     &server_sock, &server_addr, IPPROTO_DTLS_1_2);
+
+	test_config_psk(server_sock, client_sock);
+
+	rv = setsockopt(server_sock, SOL_TLS, TLS_DTLS_ROLE, &role,
+			sizeof(role));
+	zassert_equal(rv, 0, "failed to set DTLS server role");
+
+	rv = setsockopt(client_sock, SOL_TLS, TLS_DTLS_CID, &c_cid,
+			sizeof(c_cid));
+	zassert_equal(rv, 0, "failed to set client Connection ID (%d)", errno);
+	rv = setsockopt(server_sock, SOL_TLS, TLS_DTLS_CID, &s_cid,
+			sizeof(s_cid));
+	zassert_equal(rv, 0, "failed to set server Connection ID (%d)", errno);
+
+	test_bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	test_bind(client_sock, (struct sockaddr *)&client_addr,
+		  sizeof(client_addr));
+
+	rv = connect(client_sock, (struct sockaddr *)&server_addr,
+		     sizeof(server_addr));
+	zassert_equal(rv, 0, "connect failed");
+
+	/* The handshake is done by the first send and recv. */
+	test_data.sock = client_sock;
+	k_work_init_delayable(&test_data.tx_work,
+			      test_msg_trunc_tx_work_handler);
+	k_work_reschedule(&test_data.tx_work, K_MSEC(10));
+
+	rv = recv(server_sock, rx_buf, sizeof(rx_buf), 0);
+	zassert_equal(rv, sizeof(rx_buf), "Invalid length received");
+	zassert_mem_equal(rx_buf, TEST_STR_SMALL, sizeof(rx_buf),
+			  "Invalid data received");
+
+	test_dtls_cid_status(client_sock, expected);
+	test_dtls_cid_status(server_sock, expected);
+
+	/* Records with the Connection ID are accepted in both directions. */
+	test_send(server_sock, TEST_STR_SMALL, sizeof(rx_buf), 0);
+
+	rv = recv(client_sock, rx_buf, sizeof(rx_buf), 0);
+	zassert_equal(rv, sizeof(rx_buf), "Invalid length received");
+	zassert_mem_equal(rx_buf, TEST_STR_SMALL, sizeof(rx_buf),
+			  "Invalid data received");
+
+	test_close(client_sock);
+	test_close(server_sock);
+}
+
+void test_dtls_cid(void)
+{
+	/* Both ends ask for a Connection ID. */
+	dtls_cid_exchange(TLS_DTLS_CID_ENABLED, TLS_DTLS_CID_ENABLED, 1);
+
+	/* The client only uses the Connection ID of the server. */
+	dtls_cid_exchange(TLS_DTLS_CID_SUPPORTED, TLS_DTLS_CID_ENABLED, 1);
+
+	/* The server does not support the extension. */
+	dtls_cid_exchange(TLS_DTLS_CID_ENABLED, TLS_DTLS_CID_DISABLED, 0);
+}
+#else
+void test_dtls_cid(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_NET_SOCKETS_DTLS_CID */
+
 void test_main(void)
 {
 	if (IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE)) {
@@ -484,7 +694,9 @@ void test_main(void)
 		ztest_unit_test(test_v4_msg_waitall),
 		ztest_unit_test(test_v6_msg_waitall),
 		ztest_unit_test(test_v4_msg_trunc),
-		ztest_unit_test(test_v6_msg_trunc)
+		ztest_unit_test(test_v6_msg_trunc),
+		ztest_unit_test(test_session_cache),
+		ztest_unit_test(test_dtls_cid)
 		);
 
 	ztest_run_test_suite(socket_tls);
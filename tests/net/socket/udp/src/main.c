@@ -14,6 +14,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 
 #include <net/socket.h>
 #include <net/ethernet.h>
+#include <net/buf.h>
 
 #include "ipv6.h"
 #include "../../socket_helpers.h"
@@ -1212,6 +1213,78 @@ void test_v6_msg_trunc(void)
 		       (struct sockaddr *)&server_addr, sizeof(server_addr));
 }
 
+NET_BUF_POOL_DEFINE(zc_pool, 4, 128, 0, NULL);
+
+void test_v4_zerocopy(void)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	struct net_buf *frags, *frag;
+	size_t len, copied;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	/* Spread the payload over several fragments */
+	frags = NULL;
+	copied = 0;
+	while (copied < STRLEN(TEST_STR2)) {
+		frag = net_buf_alloc(&zc_pool, K_NO_WAIT);
+		zassert_not_null(frag, "cannot allocate fragment");
+
+		len = MIN(net_buf_tailroom(frag), STRLEN(TEST_STR2) - copied);
+		net_buf_add_mem(frag, TEST_STR2 + copied, len);
+		copied += len;
+
+		if (frags) {
+			net_buf_frag_add(frags, frag);
+		} else {
+			frags = frag;
+		}
+	}
+
+	rv = zsock_send_buf(client_sock, frags, 0,
+			    (struct sockaddr *)&server_addr,
+			    sizeof(server_addr));
+	zassert_equal(rv, STRLEN(TEST_STR2), "zsock_send_buf failed");
+
+	frags = NULL;
+	rv = zsock_recv_buf(server_sock, &frags, 0, &addr, &addrlen);
+	zassert_equal(rv, STRLEN(TEST_STR2), "zsock_recv_buf failed");
+	zassert_not_null(frags, "no fragments received");
+	zassert_equal(net_buf_frags_len(frags), STRLEN(TEST_STR2),
+		      "wrong fragment length");
+	zassert_equal(addrlen, sizeof(struct sockaddr_in), "wrong addrlen");
+
+	clear_buf(rx_buf);
+	len = net_buf_linearize(rx_buf, sizeof(rx_buf), frags, 0,
+				net_buf_frags_len(frags));
+	zassert_mem_equal(rx_buf, BUF_AND_SIZE(TEST_STR2), "wrong data");
+
+	net_buf_unref(frags);
+
+	rv = zsock_recv_buf(server_sock, &frags, ZSOCK_MSG_DONTWAIT,
+			    NULL, NULL);
+	zassert_equal(rv, -1, "consecutive recv should've failed");
+	zassert_equal(errno, EAGAIN, "incorrect errno value");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
 void test_main(void)
 {
 	k_thread_system_pool_assign(k_current_get());
@@ -1242,7 +1315,8 @@ void test_main(void)
 			 ztest_unit_test(test_v6_sendmsg_with_txtime),
 			 ztest_user_unit_test(test_v6_sendmsg_with_txtime),
 			 ztest_unit_test(test_v4_msg_trunc),
-			 ztest_unit_test(test_v6_msg_trunc)
+			 ztest_unit_test(test_v6_msg_trunc),
+			 ztest_unit_test(test_v4_zerocopy)
 		);
 
 	ztest_run_test_suite(socket_udp);
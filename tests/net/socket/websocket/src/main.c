@@ -12,6 +12,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_WEBSOCKET_LOG_LEVEL);
 #include <net/net_ip.h>
 #include <net/socket.h>
 #include <net/websocket.h>
+#include <sys/fdtable.h>
 
 #include "websocket_internal.h"
 
@@ -269,6 +270,54 @@ static void test_recv_two_msg(void)
 	test_recv_2(sizeof(frame1) + FRAME1_HDR_SIZE / 2);
 }
 
+static void recv_registered(size_t registered_len)
+{
+	struct websocket_context *ctx;
+	uint32_t msg_type = -1;
+	uint64_t remaining = -1;
+	int sock, ws_sock;
+	int ret;
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(sock >= 0, "socket open failed");
+
+	/* The server already read the first bytes of the frame */
+	ws_sock = websocket_register(sock, temp_recv_buf,
+				     sizeof(temp_recv_buf), frame1,
+				     registered_len, NULL);
+	zassert_true(ws_sock >= 0, "cannot register websocket (%d)", ws_sock);
+
+	ctx = z_get_fd_obj(ws_sock, NULL, 0);
+	zassert_not_null(ctx, "no websocket context");
+
+	memcpy(feed_buf, &frame1, sizeof(frame1));
+
+	ret = test_recv_buf(&feed_buf[registered_len],
+			    sizeof(frame1) - registered_len, ctx, &msg_type,
+			    &remaining, recv_buf, sizeof(recv_buf));
+	zassert_equal(ret, sizeof(frame1_msg) - 1,
+		      "Invalid amount of data read (%d)", ret);
+	zassert_mem_equal(recv_buf, frame1_msg, sizeof(frame1_msg) - 1,
+			  "Invalid message, should be '%s' was '%s'",
+			  frame1_msg, recv_buf);
+	zassert_equal(remaining, 0, "Msg not empty");
+
+	(void)close(ws_sock);
+}
+
+static void test_recv_registered_data(void)
+{
+	/* Part of the header, the rest is received */
+	recv_registered(FRAME1_HDR_SIZE / 2);
+
+	/* The whole frame, nothing is received */
+	recv_registered(sizeof(frame1));
+
+	zassert_equal(websocket_register(0, temp_recv_buf, MAX_RECV_BUF_LEN,
+					 feed_buf, MAX_RECV_BUF_LEN + 1, NULL),
+		      -ENOMEM, "too much data registered");
+}
+
 int verify_sent_and_received_msg(struct msghdr *msg, bool split_msg)
 {
 	static struct websocket_context ctx;
@@ -389,6 +438,7 @@ void test_main(void)
 			 ztest_unit_test(test_recv_12_byte),
 			 ztest_unit_test(test_recv_whole_msg),
 			 ztest_unit_test(test_recv_two_msg),
+			 ztest_unit_test(test_recv_registered_data),
 			 ztest_unit_test(test_send_and_recv_lorem_ipsum),
 			 ztest_unit_test(test_recv_two_large_split_msg)
 		);
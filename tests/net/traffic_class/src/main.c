@@ -93,6 +93,11 @@ static bool start_receiving;
 static bool recv_cb_called;
 static struct k_sem wait_data;
 
+/* Received packets are collected here and passed up in one batch */
+static bool collect_recv_batch;
+static struct net_pkt *recv_batch[MAX_PRIORITIES + 1];
+static int recv_batch_count;
+
 #define WAIT_TIME K_SECONDS(1)
 
 struct eth_context {
@@ -184,6 +189,15 @@ static int eth_tx(const struct device *dev, struct net_pkt *pkt)
 		udp_hdr->src_port = udp_hdr->dst_port;
 		udp_hdr->dst_port = port;
 
+		if (collect_recv_batch) {
+			zassert_true(recv_batch_count < MAX_PRIORITIES,
+				     "Too many packets in batch");
+
+			recv_batch[recv_batch_count++] =
+				net_pkt_clone(pkt, K_NO_WAIT);
+			return 0;
+		}
+
 		if (net_recv_data(net_pkt_iface(pkt),
 				  net_pkt_clone(pkt, K_NO_WAIT)) < 0) {
 			test_failed = true;
@@ -968,6 +982,57 @@ static void test_traffic_class_recv_data_mix_all_2(void)
 	zassert_false(test_failed, "Traffic class verification failed.");
 }
 
+static void test_traffic_class_recv_data_batch(void)
+{
+	/* Pass up one packet of each priority at once and verify that the
+	 * higher traffic classes are still received first.
+	 */
+	int total_packets = 0;
+	int i, ret;
+
+	(void)memset(recv_priorities, 0, sizeof(recv_priorities));
+
+	recv_batch_count = 0;
+	collect_recv_batch = true;
+
+	for (i = 0; i < MAX_PRIORITIES; i++) {
+		traffic_class_recv_priority(i, 1, false);
+		total_packets += 1;
+	}
+
+	for (i = 0; i < 100 && recv_batch_count < total_packets; i++) {
+		k_sleep(K_MSEC(1));
+	}
+
+	collect_recv_batch = false;
+
+	zassert_equal(recv_batch_count, total_packets,
+		      "Packets not sent (%d)", recv_batch_count);
+	zassert_not_null(recv_batch[0], "Cannot clone packet");
+
+	/* A missing packet in the batch is skipped */
+	recv_batch[recv_batch_count] = NULL;
+
+	k_sem_init(&wait_data, 0, UINT_MAX);
+
+	/* Queue the whole batch before any of the RX threads can run */
+	k_sched_lock();
+	ret = net_recv_data_batch(net_pkt_iface(recv_batch[0]), recv_batch,
+				  recv_batch_count + 1);
+	k_sched_unlock();
+
+	zassert_equal(ret, total_packets, "Batch not passed up (%d)", ret);
+
+	for (i = 0; i < total_packets; i++) {
+		if (k_sem_take(&wait_data, WAIT_TIME)) {
+			DBG("Timeout while waiting ok status\n");
+			zassert_false(true, "Timeout");
+		}
+	}
+
+	zassert_false(test_failed, "Traffic class verification failed.");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(net_traffic_class_test,
@@ -1006,6 +1071,7 @@ void test_main(void)
 			 ztest_unit_test(test_traffic_class_recv_data_mix),
 			 ztest_unit_test(test_traffic_class_recv_data_mix_all_1),
 			 ztest_unit_test(test_traffic_class_recv_data_mix_all_2),
+			 ztest_unit_test(test_traffic_class_recv_data_batch),
 			 ztest_unit_test(test_traffic_class_cleanup_rx)
 			 );
 